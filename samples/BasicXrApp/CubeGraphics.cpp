@@ -188,10 +188,8 @@ namespace {
         void RenderView(const XrRect2Di& imageRect,
                         const float renderTargetClearColor[4],
                         const std::vector<xr::math::ViewProjection>& viewProjections,
-                        DXGI_FORMAT colorSwapchainFormat,
-                        ID3D11Texture2D* colorTexture,
-                        DXGI_FORMAT depthSwapchainFormat,
-                        ID3D11Texture2D* depthTexture,
+                        ID3D11RenderTargetView* renderTargetView,
+                        ID3D11DepthStencilView* depthStencilView,
                         const std::vector<const sample::Cube*>& cubes) override {
             const uint32_t viewInstanceCount = (uint32_t)viewProjections.size();
             CHECK_MSG(viewInstanceCount <= CubeShader::MaxViewInstance,
@@ -201,26 +199,16 @@ namespace {
                 (float)imageRect.offset.x, (float)imageRect.offset.y, (float)imageRect.extent.width, (float)imageRect.extent.height);
             m_deviceContext->RSSetViewports(1, &viewport);
 
-            // Create RenderTargetView with the original swapchain format (swapchain image is typeless).
-            winrt::com_ptr<ID3D11RenderTargetView> renderTargetView;
-            const CD3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc(D3D11_RTV_DIMENSION_TEXTURE2DARRAY, colorSwapchainFormat);
-            CHECK_HRCMD(m_device->CreateRenderTargetView(colorTexture, &renderTargetViewDesc, renderTargetView.put()));
-
-            // Create a DepthStencilView with the original swapchain format (swapchain image is typeless)
-            winrt::com_ptr<ID3D11DepthStencilView> depthStencilView;
-            CD3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc(D3D11_DSV_DIMENSION_TEXTURE2DARRAY, depthSwapchainFormat);
-            CHECK_HRCMD(m_device->CreateDepthStencilView(depthTexture, &depthStencilViewDesc, depthStencilView.put()));
-
             const bool reversedZ = viewProjections[0].NearFar.Near > viewProjections[0].NearFar.Far;
             const float depthClearValue = reversedZ ? 0.f : 1.f;
 
             // Clear swapchain and depth buffer. NOTE: This will clear the entire render target view, not just the specified view.
-            m_deviceContext->ClearRenderTargetView(renderTargetView.get(), renderTargetClearColor);
-            m_deviceContext->ClearDepthStencilView(depthStencilView.get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, depthClearValue, 0);
+            m_deviceContext->ClearRenderTargetView(renderTargetView, renderTargetClearColor);
+            m_deviceContext->ClearDepthStencilView(depthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, depthClearValue, 0);
             m_deviceContext->OMSetDepthStencilState(reversedZ ? m_reversedZDepthNoStencilTest.get() : nullptr, 0);
 
-            ID3D11RenderTargetView* renderTargets[] = {renderTargetView.get()};
-            m_deviceContext->OMSetRenderTargets((UINT)std::size(renderTargets), renderTargets, depthStencilView.get());
+            ID3D11RenderTargetView* renderTargets[] = {renderTargetView};
+            m_deviceContext->OMSetRenderTargets((UINT)std::size(renderTargets), renderTargets, depthStencilView);
 
             ID3D11Buffer* const constantBuffers[] = {m_modelCBuffer.get(), m_viewProjectionCBuffer.get()};
             m_deviceContext->VSSetConstantBuffers(0, (UINT)std::size(constantBuffers), constantBuffers);
@@ -434,6 +434,23 @@ namespace {
                                                    &chainLength,
                                                    reinterpret_cast<XrSwapchainImageBaseHeader*>(swapchain.Images.data())));
 
+            // Create the views into each image once here rather than every frame, using the original swapchain format
+            // because the swapchain images are typeless.
+            winrt::com_ptr<ID3D11Device> device;
+            swapchain.Images[0].texture->GetDevice(device.put());
+            for (const XrSwapchainImageD3D11KHR& image : swapchain.Images) {
+                if (usageFlags & XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT) {
+                    const CD3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc(D3D11_RTV_DIMENSION_TEXTURE2DARRAY, format);
+                    winrt::com_ptr<ID3D11RenderTargetView>& renderTargetView = swapchain.RenderTargetViews.emplace_back();
+                    CHECK_HRCMD(device->CreateRenderTargetView(image.texture, &renderTargetViewDesc, renderTargetView.put()));
+                }
+                if (usageFlags & XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+                    const CD3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc(D3D11_DSV_DIMENSION_TEXTURE2DARRAY, format);
+                    winrt::com_ptr<ID3D11DepthStencilView>& depthStencilView = swapchain.DepthStencilViews.emplace_back();
+                    CHECK_HRCMD(device->CreateDepthStencilView(image.texture, &depthStencilViewDesc, depthStencilView.put()));
+                }
+            }
+
             return swapchain;
         }
 
@@ -820,10 +837,8 @@ namespace {
             m_graphicsPlugin->RenderView(imageRect,
                                          renderTargetClearColor,
                                          viewProjections,
-                                         colorSwapchain.Format,
-                                         colorSwapchain.Images[colorSwapchainImageIndex].texture,
-                                         depthSwapchain.Format,
-                                         depthSwapchain.Images[depthSwapchainImageIndex].texture,
+                                         colorSwapchain.RenderTargetViews[colorSwapchainImageIndex].get(),
+                                         depthSwapchain.DepthStencilViews[depthSwapchainImageIndex].get(),
                                          visibleCubes);
 
             XrSwapchainImageReleaseInfo releaseInfo{XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
@@ -905,6 +920,8 @@ namespace {
             uint32_t Height{0};
             uint32_t ArraySize{0};
             std::vector<XrSwapchainImageD3D11KHR> Images;
+            std::vector<winrt::com_ptr<ID3D11RenderTargetView>> RenderTargetViews; // One per image, covering all array slices
+            std::vector<winrt::com_ptr<ID3D11DepthStencilView>> DepthStencilViews; // One per image, covering all array slices
         };
 
         struct RenderResources {
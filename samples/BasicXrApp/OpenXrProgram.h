@@ -40,14 +40,12 @@ namespace sample {
         virtual const std::vector<DXGI_FORMAT>& SupportedColorFormats() const = 0;
         virtual const std::vector<DXGI_FORMAT>& SupportedDepthFormats() const = 0;
 
-        // Render to swapchain images using stereo image array
+        // Render to swapchain images using stereo image array, through views that cover all slices of the array.
         virtual void RenderView(const XrRect2Di& imageRect,
                                 const float renderTargetClearColor[4],
                                 const std::vector<xr::math::ViewProjection>& viewProjections,
-                                DXGI_FORMAT colorSwapchainFormat,
-                                ID3D11Texture2D* colorTexture,
-                                DXGI_FORMAT depthSwapchainFormat,
-                                ID3D11Texture2D* depthTexture,
+                                ID3D11RenderTargetView* renderTargetView,
+                                ID3D11DepthStencilView* depthStencilView,
                                 const std::vector<const sample::Cube*>& cubes) = 0;
     };
 
@@ -29,7 +29,8 @@ namespace {
     //
     struct HandTrackingScene : public engine::Scene {
         HandTrackingScene(engine::Context& context)
-            : Scene(context) {
+            : Scene(context)
+            , m_handTracking(context.Hands.Subscribe()) {
             m_jointMaterial = Pbr::Material::CreateFlat(m_context.PbrResources, Pbr::RGBA::White, 0.85f, 0.01f);
             m_meshMaterial = Pbr::Material::CreateFlat(m_context.PbrResources, Pbr::RGBA::White, 1, 0);
 
@@ -54,14 +55,7 @@ namespace {
             const std::tuple<XrHandEXT, HandData&> hands[] = {{XrHandEXT::XR_HAND_LEFT_EXT, m_leftHandData},
                                                               {XrHandEXT::XR_HAND_RIGHT_EXT, m_rightHandData}};
             for (const auto& [hand, handData] : hands) {
-                XrHandTrackerCreateInfoEXT createInfo{XR_TYPE_HAND_TRACKER_CREATE_INFO_EXT};
-                createInfo.hand = hand;
-                createInfo.handJointSet = XR_HAND_JOINT_SET_DEFAULT_EXT;
-                CHECK_XRCMD(m_context.Extensions.xrCreateHandTrackerEXT(
-                    m_context.Session.Handle,
-                    &createInfo,
-                    handData.TrackerHandle.Put(m_context.Extensions.xrDestroyHandTrackerEXT)));
-
+                handData.Hand = hand;
                 createJointObjects(handData);
 
                 // Initialize buffers to receive hand mesh indices and vertices
@@ -74,22 +68,40 @@ namespace {
                 handData.meshState.vertexBuffer.vertexCapacityInput = handMeshSystemProperties.maxHandMeshVertexCount;
                 handData.meshState.vertexBuffer.vertices = handData.VertexBuffer.get();
 
+                // The hand mesh is streamed into a primitive sized for the largest mesh the system can return, through staging vertices
+                // whose constant attributes are initialized once here.
+                Pbr::Vertex stagingVertex{};
+                stagingVertex.Color0 = {1, 1, 1, 1};
+                stagingVertex.ModelTransformIndex = Pbr::RootNodeIndex;
+                handData.StagingVertices.assign(handMeshSystemProperties.maxHandMeshVertexCount, stagingVertex);
+
+                auto meshModel = std::make_shared<Pbr::Model>();
+                meshModel->AddPrimitive(Pbr::Primitive(m_context.PbrResources,
+                                                       handMeshSystemProperties.maxHandMeshVertexCount,
+                                                       handMeshSystemProperties.maxHandMeshIndexCount,
+                                                       m_meshMaterial));
+                handData.MeshObject = AddObject(std::make_shared<engine::PbrModelObject>(std::move(meshModel)));
+                handData.MeshObject->SetVisible(false);
+
                 XrHandMeshSpaceCreateInfoMSFT meshSpaceCreateInfo{XR_TYPE_HAND_MESH_SPACE_CREATE_INFO_MSFT};
                 meshSpaceCreateInfo.poseInHandMeshSpace = xr::math::Pose::Identity();
                 meshSpaceCreateInfo.handPoseType = XR_HAND_POSE_TYPE_TRACKED_MSFT;
                 CHECK_XRCMD(m_context.Extensions.xrCreateHandMeshSpaceMSFT(
-                    handData.TrackerHandle.Get(), &meshSpaceCreateInfo, handData.MeshSpace.Put()));
+                    m_context.Hands.TrackerHandle(hand), &meshSpaceCreateInfo, handData.MeshSpace.Put()));
+                handData.MeshInScene = m_context.Spaces.Register(handData.MeshSpace.Get(), m_context.SceneSpace);
 
                 meshSpaceCreateInfo.handPoseType = XR_HAND_POSE_TYPE_REFERENCE_OPEN_PALM_MSFT;
                 CHECK_XRCMD(m_context.Extensions.xrCreateHandMeshSpaceMSFT(
-                    handData.TrackerHandle.Get(), &meshSpaceCreateInfo, handData.ReferenceMeshSpace.Put()));
+                    m_context.Hands.TrackerHandle(hand), &meshSpaceCreateInfo, handData.ReferenceMeshSpace.Put()));
             }
 
             // Set a clap detector that will toggle the display mode.
             m_clapDetector = std::make_unique<StateChangeDetector>(
                 [this](XrTime time) {
-                    const XrHandJointLocationEXT& leftPalmLocation = m_leftHandData.JointLocations[XR_HAND_JOINT_PALM_EXT];
-                    const XrHandJointLocationEXT& rightPalmLocation = m_rightHandData.JointLocations[XR_HAND_JOINT_PALM_EXT];
+                    const XrHandJointLocationEXT& leftPalmLocation =
+                        m_context.Hands.Latest(XR_HAND_LEFT_EXT).Locations[XR_HAND_JOINT_PALM_EXT];
+                    const XrHandJointLocationEXT& rightPalmLocation =
+                        m_context.Hands.Latest(XR_HAND_RIGHT_EXT).Locations[XR_HAND_JOINT_PALM_EXT];
 
                     if (xr::math::Pose::IsPoseValid(leftPalmLocation) && xr::math::Pose::IsPoseValid(rightPalmLocation)) {
                         const XMVECTOR leftPalmPosition = xr::math::LoadXrVector3(leftPalmLocation.pose.position);
@@ -105,21 +117,11 @@ namespace {
 
         void OnUpdate(const engine::FrameTime& frameTime) override {
             for (HandData& handData : {std::ref(m_leftHandData), std::ref(m_rightHandData)}) {
-                XrHandJointsLocateInfoEXT locateInfo{XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT};
-                locateInfo.baseSpace = m_context.SceneSpace;
-                locateInfo.time = frameTime.PredictedDisplayTime;
-
-                XrHandJointLocationsEXT handJointLocations{XR_TYPE_HAND_JOINT_LOCATIONS_EXT};
-                handJointLocations.jointCount = (uint32_t)handData.JointLocations.size();
-                handJointLocations.jointLocations = handData.JointLocations.data();
-                CHECK_XRCMD(
-                    m_context.Extensions.xrLocateHandJointsEXT(handData.TrackerHandle.Get(), &locateInfo, &handJointLocations));
-
                 bool jointsVisible = m_mode == HandDisplayMode::Joints;
                 bool meshVisible = m_mode == HandDisplayMode::Mesh;
 
                 if (jointsVisible) {
-                    jointsVisible = UpdateJoints(handData, m_context.SceneSpace, frameTime.PredictedDisplayTime);
+                    jointsVisible = UpdateJoints(handData, m_context.Hands.Latest(handData.Hand));
                 }
 
                 if (meshVisible) {
@@ -127,9 +129,7 @@ namespace {
                 }
 
                 handData.JointModel->SetVisible(jointsVisible);
-                if (handData.MeshObject != nullptr) { // Pbr mesh object creation is deferred.
-                    handData.MeshObject->SetVisible(meshVisible);
-                }
+                handData.MeshObject->SetVisible(meshVisible);
             }
 
             // Detect hand clap to toggle hand display mode.
@@ -137,48 +137,39 @@ namespace {
         }
 
         struct HandData {
-            xr::HandTrackerHandle TrackerHandle;
+            XrHandEXT Hand{};
 
             // Data to display hand joints tracking
             std::shared_ptr<engine::PbrModelObject> JointModel;
             std::array<Pbr::NodeIndex_t, XR_HAND_JOINT_COUNT_EXT> PbrNodeIndices{};
-            std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT> JointLocations{};
 
             // Data to display hand mesh tracking
             xr::SpaceHandle MeshSpace;
+            engine::SpaceLocator::Registration MeshInScene; // Includes the mesh space in the batched locate of each frame.
             xr::SpaceHandle ReferenceMeshSpace;
-            std::vector<XMFLOAT4> VertexColors;
+            std::vector<Pbr::Vertex> StagingVertices;
             std::shared_ptr<engine::PbrModelObject> MeshObject;
 
             // Data to process open-palm reference hand.
             XrHandMeshMSFT meshState{XR_TYPE_HAND_MESH_MSFT};
             std::unique_ptr<uint32_t[]> IndexBuffer{};
             std::unique_ptr<XrHandMeshVertexMSFT[]> VertexBuffer{};
+            std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT> ReferenceJointLocations{};
 
             HandData() = default;
             HandData(HandData&&) = delete;
             HandData(const HandData&) = delete;
         };
 
-        bool UpdateJoints(HandData& handData, XrSpace referenceSpace, XrTime time) {
+        bool UpdateJoints(HandData& handData, const engine::HandJointsSnapshot& joints) {
             bool jointsVisible = false;
 
-            XrHandJointsLocateInfoEXT locateInfo{XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT};
-            locateInfo.baseSpace = m_context.SceneSpace;
-            locateInfo.time = time;
-
-            XrHandJointLocationsEXT locations{XR_TYPE_HAND_JOINT_LOCATIONS_EXT};
-            locations.jointCount = (uint32_t)handData.JointLocations.size();
-            locations.jointLocations = handData.JointLocations.data();
-
-            CHECK_XRCMD(m_context.Extensions.xrLocateHandJointsEXT(handData.TrackerHandle.Get(), &locateInfo, &locations));
-
             for (uint32_t k = 0; k < XR_HAND_JOINT_COUNT_EXT; k++) {
-                if (xr::math::Pose::IsPoseValid(handData.JointLocations[k])) {
+                if (xr::math::Pose::IsPoseValid(joints.Locations[k])) {
                     Pbr::Node& jointNode = handData.JointModel->GetModel()->GetNode(handData.PbrNodeIndices[k]);
 
-                    const float radius = handData.JointLocations[k].radius;
-                    jointNode.SetTransform(XMMatrixScaling(radius, radius, radius) * xr::math::LoadXrPose(handData.JointLocations[k].pose));
+                    const float radius = joints.Locations[k].radius;
+                    jointNode.SetTransform(XMMatrixScaling(radius, radius, radius) * xr::math::LoadXrPose(joints.Locations[k].pose));
 
                     jointsVisible = true;
                 }
@@ -191,49 +182,35 @@ namespace {
             XrHandMeshUpdateInfoMSFT meshUpdateInfo{XR_TYPE_HAND_MESH_UPDATE_INFO_MSFT};
             meshUpdateInfo.time = time;
             meshUpdateInfo.handPoseType = XR_HAND_POSE_TYPE_TRACKED_MSFT;
-            CHECK_XRCMD(m_context.Extensions.xrUpdateHandMeshMSFT(handData.TrackerHandle.Get(), &meshUpdateInfo, &handData.meshState));
+            const XrHandTrackerEXT handTracker = m_context.Hands.TrackerHandle(handData.Hand);
+            CHECK_XRCMD(m_context.Extensions.xrUpdateHandMeshMSFT(handTracker, &meshUpdateInfo, &handData.meshState));
 
             if (!handData.meshState.isActive) {
                 return false;
             }
 
-            bool indicesChanged = handData.meshState.indexBufferChanged;
-            bool verticesChanged = handData.meshState.vertexBufferChanged;
+            const bool indicesChanged = handData.meshState.indexBufferChanged;
+            const bool verticesChanged = handData.meshState.vertexBufferChanged;
+            const XrHandMeshIndexBufferMSFT& indexBuffer = handData.meshState.indexBuffer;
+            const XrHandMeshVertexBufferMSFT& vertexBuffer = handData.meshState.vertexBuffer;
+            Pbr::Primitive& meshPrimitive = handData.MeshObject->GetModel()->GetPrimitive(0);
 
             if (indicesChanged) {
                 // Index buffer is changed, recalculate vertices color based on neutral hand pose.
                 ComputeHandMeshColor(handData, time);
+                meshPrimitive.UpdateIndices(m_context.DeviceContext.get(), indexBuffer.indices, indexBuffer.indexCountOutput);
             }
 
-            if (verticesChanged) {
-                Pbr::PrimitiveBuilder meshBuilder = CreateHandMeshPrimitiveBuilder(handData.meshState.indexBuffer.indices,
-                                                                                   handData.meshState.indexBuffer.indexCountOutput,
-                                                                                   handData.meshState.vertexBuffer.vertices,
-                                                                                   handData.meshState.vertexBuffer.vertexCountOutput,
-                                                                                   handData.VertexColors);
-
-                if (!handData.MeshObject) {
-                    // The hand mesh scene object doesn't exist yet and must be created.
-                    Pbr::Primitive surfacePrimitive(m_context.PbrResources, meshBuilder, m_meshMaterial, false /* updatableBuffers */);
-
-                    auto surfaceModel = std::make_shared<Pbr::Model>();
-                    surfaceModel->AddPrimitive(std::move(surfacePrimitive));
-
-                    handData.MeshObject = AddObject(std::make_shared<engine::PbrModelObject>(surfaceModel));
-                } else {
-                    // Update vertices and indices of the existing hand mesh scene object's primitive.
-                    handData.MeshObject->GetModel()->GetPrimitive(0).UpdateBuffers(
-                        m_context.Device.get(), m_context.DeviceContext.get(), meshBuilder);
-                }
+            if (indicesChanged || verticesChanged) {
+                Pbr::Vertex* const stagingVertices = handData.StagingVertices.data();
+                UpdateStagingVertices(vertexBuffer.vertices, vertexBuffer.vertexCountOutput, stagingVertices);
+                meshPrimitive.UpdateVertices(m_context.DeviceContext.get(), stagingVertices, vertexBuffer.vertexCountOutput);
             }
 
-            if (handData.MeshObject) {
-                XrSpaceLocation meshLocation{XR_TYPE_SPACE_LOCATION};
-                CHECK_XRCMD(xrLocateSpace(handData.MeshSpace.Get(), referenceSpace, time, &meshLocation));
-                if (xr::math::Pose::IsPoseValid(meshLocation)) {
-                    handData.MeshObject->Pose() = meshLocation.pose;
-                    return true;
-                }
+            const XrSpaceLocation meshLocation = m_context.Spaces.Locate(handData.MeshSpace.Get(), referenceSpace, time);
+            if (xr::math::Pose::IsPoseValid(meshLocation)) {
+                handData.MeshObject->Pose() = meshLocation.pose;
+                return true;
             }
 
             return false;
@@ -251,20 +228,20 @@ namespace {
             locateInfo.baseSpace = handData.ReferenceMeshSpace.Get();
             locateInfo.time = time;
 
+            // The reference pose goes to its own buffer so the tracked joints shared through Context::Hands stay intact.
             XrHandJointLocationsEXT locations{XR_TYPE_HAND_JOINT_LOCATIONS_EXT};
-            locations.jointCount = (uint32_t)handData.JointLocations.size();
-            locations.jointLocations = handData.JointLocations.data();
+            locations.jointCount = (uint32_t)handData.ReferenceJointLocations.size();
+            locations.jointLocations = handData.ReferenceJointLocations.data();
 
-            CHECK_XRCMD(m_context.Extensions.xrLocateHandJointsEXT(handData.TrackerHandle.Get(), &locateInfo, &locations));
+            CHECK_XRCMD(m_context.Extensions.xrLocateHandJointsEXT(m_context.Hands.TrackerHandle(handData.Hand), &locateInfo, &locations));
             assert(locations.isActive);
 
-            const XrVector3f& vZero = handData.JointLocations[XR_HAND_JOINT_MIDDLE_TIP_EXT].pose.position;
-            const XrVector3f& vOne = handData.JointLocations[XR_HAND_JOINT_WRIST_EXT].pose.position;
-            const XrVector3f& hZero = handData.JointLocations[XR_HAND_JOINT_LITTLE_TIP_EXT].pose.position;
-            const XrVector3f& hOne = handData.JointLocations[XR_HAND_JOINT_THUMB_TIP_EXT].pose.position;
+            const XrVector3f& vZero = handData.ReferenceJointLocations[XR_HAND_JOINT_MIDDLE_TIP_EXT].pose.position;
+            const XrVector3f& vOne = handData.ReferenceJointLocations[XR_HAND_JOINT_WRIST_EXT].pose.position;
+            const XrVector3f& hZero = handData.ReferenceJointLocations[XR_HAND_JOINT_LITTLE_TIP_EXT].pose.position;
+            const XrVector3f& hOne = handData.ReferenceJointLocations[XR_HAND_JOINT_THUMB_TIP_EXT].pose.position;
 
             const XrHandMeshVertexBufferMSFT& vertexBuffer = handData.meshState.vertexBuffer;
-            handData.VertexColors.resize(vertexBuffer.vertexCountOutput);
 
             // Calculate the normalized length of a vertex to a line segment defined by two point [zero, one].
             auto weight = [](const XrVector3f& v, const XrVector3f& zero, const XrVector3f& one) -> float {
@@ -281,38 +258,27 @@ namespace {
                 const float v = weight(vertexPosition, vZero, vOne);
                 const float h = weight(vertexPosition, hZero, hOne);
                 // Pick a simple psuedo color map to visualize figers in colors.
-                handData.VertexColors[i] = {v, (1 - h), h, 1};
+                handData.StagingVertices[i].Color0 = {v, (1 - h), h, 1};
             }
         }
 
-        Pbr::PrimitiveBuilder CreateHandMeshPrimitiveBuilder(uint32_t* indices,
-                                                             uint32_t indexCount,
-                                                             XrHandMeshVertexMSFT* vertices,
-                                                             uint32_t vertexCount,
-                                                             const std::vector<XMFLOAT4>& vertexColors) {
-            Pbr::PrimitiveBuilder builder;
-            builder.Vertices.resize(vertexCount);
-
-            builder.Indices = std::vector<uint32_t>(indices, indices + indexCount);
-
-            for (uint32_t i = 0; i < vertexCount; i++, vertices++) {
-                Pbr::Vertex& vertex = builder.Vertices[i];
-
-                vertex.Position = xr::math::cast(vertices->position);
-                vertex.Normal = xr::math::cast(vertices->normal);
-                vertex.Color0 = vertexColors[i];
-
-                bool xDominant = std::abs(vertex.Normal.x) > std::abs(vertex.Normal.y);
-                XMVECTOR basis = xDominant ? g_XMIdentityR1 : g_XMIdentityR0;
-                XMVECTOR normal = XMLoadFloat3(&vertex.Normal);
-                XMVECTOR tangent = XMVector3Cross(normal, basis);
-                XMStoreFloat4(&vertex.Tangent, tangent);
-
-                XMStoreFloat2(&vertex.TexCoord0, g_XMZero);
-                vertex.ModelTransformIndex = Pbr::RootNodeIndex; // Index into the node transforms
+        // Writes the tracked positions and normals into the staging vertices, together with a tangent derived from the normal.
+        // The colors and the other attributes are left as they are, they only change with the topology.
+        static void UpdateStagingVertices(const XrHandMeshVertexMSFT* vertices, uint32_t vertexCount, Pbr::Vertex* stagingVertices) {
+            for (uint32_t i = 0; i < vertexCount; i++) {
+                const XMVECTOR position = xr::math::LoadXrVector3(vertices[i].position);
+                const XMVECTOR normal = xr::math::LoadXrVector3(vertices[i].normal);
+
+                // Cross the normal with the Y axis if it is closer to the X axis and with the X axis otherwise, selected without branching.
+                const XMVECTOR absNormal = XMVectorAbs(normal);
+                const XMVECTOR xDominant = XMVectorGreater(XMVectorSplatX(absNormal), XMVectorSplatY(absNormal));
+                const XMVECTOR basis = XMVectorSelect(g_XMIdentityR0, g_XMIdentityR1, xDominant);
+
+                Pbr::Vertex& vertex = stagingVertices[i];
+                XMStoreFloat3(&vertex.Position, position);
+                XMStoreFloat3(&vertex.Normal, normal);
+                XMStoreFloat4(&vertex.Tangent, XMVector3Cross(normal, basis));
             }
-
-            return builder;
         }
 
         // Detects two spaces collide to each other
@@ -344,6 +310,8 @@ namespace {
 
         std::shared_ptr<Pbr::Material> m_meshMaterial, m_jointMaterial;
 
+        // Declared before the hand data so the hand mesh spaces are destroyed before the trackers they were created from.
+        engine::HandTracking::Subscription m_handTracking;
         HandData m_leftHandData;
         HandData m_rightHandData;
         std::unique_ptr<StateChangeDetector> m_clapDetector;
@@ -351,7 +319,7 @@ namespace {
 } // namespace
 
 std::unique_ptr<engine::Scene> TryCreateHandTrackingScene(engine::Context& context) {
-    if (!context.Extensions.SupportsHandJointTracking || !context.System.HandTrackingProperties.supportsHandTracking) {
+    if (!context.Hands.IsSupported()) {
         return nullptr;
     }
 
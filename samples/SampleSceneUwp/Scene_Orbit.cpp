@@ -56,7 +56,7 @@ namespace {
             }
 
             //mobj = AddObject(engine::CreateSphere(m_context.PbrResources, 0.5f, 20, Pbr::FromSRGB(Colors::OrangeRed)));
-            mobj = AddObject(std::make_shared<SimpleObjRenderer>(std::move(false)));
+            mobj = AddObject(std::make_shared<SimpleObjRenderer>());
             mobj->SetVisible(false); // invisible until tracking is valid and placement succeeded.
 
             //m_earth = AddObject(engine::CreateSphere(m_context.PbrResources, 0.1f, 20, Pbr::FromSRGB(Colors::SeaGreen)));
@@ -69,10 +69,7 @@ namespace {
         }
 
         void OnUpdate(const engine::FrameTime& frameTime) override {
-            XrActionStateBoolean state{XR_TYPE_ACTION_STATE_BOOLEAN};
-            XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
-            getInfo.action = m_selectAction;
-            CHECK_XRCMD(xrGetActionStateBoolean(m_context.Session.Handle, &getInfo, &state));
+            const XrActionStateBoolean& state = ActionContext().ActionStates().Boolean(m_selectAction);
             const bool isSelectPressed = state.isActive && state.changedSinceLastSync && state.currentState;
             const bool firstUpdate = !mobj->IsVisible();
 
@@ -1,34 +1,19 @@
 #ifndef SIMPLE_OBJ_RENDERER_H
 #define SIMPLE_OBJ_RENDERER_H
 #include <pch.h>
+#include <pbr/PbrDevice.h>
 #include <XrSceneLib/Scene.h>
 #include <XrSceneLib/Context.h>
+
+// Renders a cube with the OpenGL ES renderer of the Pbr library, through ANGLE, using the device interface both of its
+// renderers implement.
 class SimpleObjRenderer : public engine::Object {
 public:
-    SimpleObjRenderer(bool holographic);
-    ~SimpleObjRenderer();
+    SimpleObjRenderer();
     void Render(engine::Context& context) const override;
-    //void UpdateWindowSize(GLsizei width, GLsizei height);
 
 private:
-    GLuint mProgram;
-    GLsizei mWindowWidth;
-    GLsizei mWindowHeight;
-
-    GLint mPositionAttribLocation;
-    GLint mColorAttribLocation;
-
-    GLint mModelUniformLocation;
-    GLint mViewUniformLocation;
-    GLint mProjUniformLocation;
-    GLint mRtvIndexAttribLocation;
-
-    GLuint mVertexPositionBuffer;
-    GLuint mVertexColorBuffer;
-    GLuint mIndexBuffer;
-    GLuint mRenderTargetArrayIndices;
-
-    int mDrawCount;
-    bool mIsHolographic;
+    std::unique_ptr<Pbr::Device> mDevice;
+    std::shared_ptr<Pbr::DeviceModel> mModel;
 };
 #endif // !SIMPLE_OBJ_RENDERER_H
@@ -16,10 +16,14 @@
 #include "pch.h"
 #include <XrSceneLib/XrApp.h>
 
+// Feeds the allocation profiler with the allocations of this executable.
+#include <SampleShared/AllocationProfilerHooks.h>
+
 std::unique_ptr<engine::Scene> TryCreateTitleScene(engine::Context& context);
-std::unique_ptr<engine::Scene> TryCreateControllerModelScene(engine::Context& context);
+std::unique_ptr<engine::Scene> TryCreateControllerModelScene(engine::Context& context, bool materialAtlas);
+std::unique_ptr<engine::Scene> TryCreateEnvironmentScene(engine::Context& context);
 
-int APIENTRY wWinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPWSTR, _In_ int) {
+int APIENTRY wWinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPWSTR commandLine, _In_ int) {
     try {
         CHECK_HRCMD(::CoInitializeEx(nullptr, COINIT_MULTITHREADED));
         auto on_exit = MakeScopeGuard([] { ::CoUninitialize(); });
@@ -27,9 +31,40 @@ int APIENTRY wWinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPWSTR, _In_ int)
         engine::XrAppConfiguration appConfig({"SampleSceneWin32", 1});
         appConfig.RequestedExtensions.push_back(XR_MSFT_CONTROLLER_MODEL_EXTENSION_NAME);
 
+        // The allocations of the frame loop and the statistics of the asset cache and the projection layers are traced every 900
+        // frames. With -strictSteadyState, any allocation in the frame loop after the first 300 frames fails the app instead, which is
+        // how the frame loop is kept free of heap allocations.
+        appConfig.AllocationTraceIntervalFrames = 900;
+        appConfig.AssetCacheTraceIntervalFrames = 900;
+        appConfig.RenderStatisticsTraceIntervalFrames = 900;
+        if (std::wstring_view(commandLine).find(L"-strictSteadyState") != std::wstring_view::npos) {
+            appConfig.StrictSteadyStateWarmupFrames = 300;
+        }
+
+        // With -compressTextures, glTF textures are block compressed on load and kept in the temporary folder for the next run.
+        if (std::wstring_view(commandLine).find(L"-compressTextures") != std::wstring_view::npos) {
+            appConfig.TextureCompression = Pbr::TextureCompression::HighQuality;
+            appConfig.TextureCacheFolder = std::filesystem::temp_directory_path() / "PbrTextureCache";
+        }
+
+        // With -materialAtlas, the controller models are drawn with material atlases once loaded.
+        const bool materialAtlas = std::wstring_view(commandLine).find(L"-materialAtlas") != std::wstring_view::npos;
+
+        // With -singlePassStereo, both eyes are drawn in one pass of instanced draws. Compare the render passes and CPU submission
+        // time per frame of the traced render statistics with a run without it.
+        const bool singlePassStereo = std::wstring_view(commandLine).find(L"-singlePassStereo") != std::wstring_view::npos;
+
         auto app = engine::CreateXrApp(appConfig);
+
+        // The views are located again right before rendering, and the head-locked title moves along with them.
+        app->ProjectionLayers().ForEachLayerWithLock([singlePassStereo](engine::ProjectionLayer& layer) {
+            layer.Config().LateLatchViews = true;
+            layer.Config().SinglePassStereo = singlePassStereo;
+        });
+
         app->AddScene(TryCreateTitleScene(app->Context()));
-        app->AddScene(TryCreateControllerModelScene(app->Context()));
+        app->AddScene(TryCreateControllerModelScene(app->Context(), materialAtlas));
+        app->AddScene(TryCreateEnvironmentScene(app->Context()));
         app->Run();
     } catch (const std::exception& ex) {
         sample::Trace("Unhandled Exception: {}", ex.what());
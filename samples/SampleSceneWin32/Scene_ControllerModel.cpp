@@ -20,7 +20,7 @@
 
 namespace {
     struct ControllerModelScene : public engine::Scene {
-        ControllerModelScene(engine::Context& context)
+        ControllerModelScene(engine::Context& context, bool materialAtlas)
             : Scene(context)
             , m_leftController(context.LeftHand)
             , m_rightController(context.RightHand) {
@@ -63,7 +63,7 @@ namespace {
                 CHECK_XRCMD(xrCreateActionSpace(m_context.Session.Handle, &actionSpaceCreateInfo, controller.GripSpace.Put()));
 
                 // Controller objects are created with empty model.  It will be loaded when available.
-                controller.Object = AddObject(CreateControllerObject(m_context, controller.UserPath));
+                controller.Object = AddObject(CreateControllerObject(m_context, controller.UserPath, materialAtlas));
             }
         }
 
@@ -97,6 +97,6 @@ namespace {
 
 } // namespace
 
-std::unique_ptr<engine::Scene> TryCreateControllerModelScene(engine::Context& context) {
-    return context.Extensions.SupportsControllerModel ? std::make_unique<ControllerModelScene>(context) : nullptr;
+std::unique_ptr<engine::Scene> TryCreateControllerModelScene(engine::Context& context, bool materialAtlas) {
+    return context.Extensions.SupportsControllerModel ? std::make_unique<ControllerModelScene>(context, materialAtlas) : nullptr;
 }
@@ -0,0 +1,141 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include "pch.h"
+#include <algorithm>
+#include <filesystem>
+#include <pbr/PbrCommon.h>
+#include <pbr/PbrEnvironment.h>
+#include <SampleShared/AllocationProfiler.h>
+#include <SampleShared/FileUtility.h>
+#include <XrSceneLib/Scene.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+    //
+    // This sample switches the image-based lighting of the scene between the Radiance HDR environments in the
+    // "Environments" folder next to the app, each time the menu button is pressed. Images named *.cube.hdr hold the six
+    // faces of a cube stacked vertically, the others are equirectangular. Each environment is prefiltered on worker threads
+    // the first time it is shown, and switching back to it only uploads the textures again.
+    //
+    struct EnvironmentScene : public engine::Scene {
+        EnvironmentScene(engine::Context& context, std::vector<std::filesystem::path> environmentFiles)
+            : Scene(context)
+            , m_environments(environmentFiles.size()) {
+            for (size_t i = 0; i < environmentFiles.size(); i++) {
+                m_environments[i].File = std::move(environmentFiles[i]);
+            }
+
+            xr::ActionSet& actionSet = ActionContext().CreateActionSet("environment_scene_actions", "Environment Scene Actions");
+            m_switchAction = actionSet.CreateAction("switch_environment", "Switch Environment", XR_ACTION_TYPE_BOOLEAN_INPUT, {});
+
+            ActionContext().SuggestInteractionProfileBindings("/interaction_profiles/khr/simple_controller",
+                                                              {
+                                                                  {m_switchAction, "/user/hand/right/input/menu/click"},
+                                                                  {m_switchAction, "/user/hand/left/input/menu/click"},
+                                                              });
+
+            ActionContext().SuggestInteractionProfileBindings("/interaction_profiles/microsoft/motion_controller",
+                                                              {
+                                                                  {m_switchAction, "/user/hand/right/input/menu/click"},
+                                                                  {m_switchAction, "/user/hand/left/input/menu/click"},
+                                                              });
+        }
+
+        void OnUpdate(const engine::FrameTime& frameTime [[maybe_unused]]) override {
+            const XrActionStateBoolean& state = ActionContext().ActionStates().Boolean(m_switchAction);
+            if (state.isActive && state.changedSinceLastSync && state.currentState) {
+                m_currentIndex = (m_currentIndex + 1) % m_environments.size();
+                SwitchEnvironment(m_environments[m_currentIndex]);
+            }
+
+            if (m_pendingBatch && m_pendingBatch->IsComplete()) {
+                if (const std::exception_ptr error = m_pendingBatch->Error()) {
+                    sample::allocation::AllowAllocationsScope allowAllocations; // Formatting the trace may allocate.
+                    try {
+                        std::rethrow_exception(error);
+                    } catch (const std::exception& ex) {
+                        sample::Trace("Failed to switch to environment {}: {}", m_environments[m_currentIndex].File.string(), ex.what());
+                    }
+                }
+                m_pendingBatch = nullptr;
+            }
+        }
+
+    private:
+        struct Environment {
+            std::filesystem::path File;
+            Pbr::EnvironmentCache::EnvironmentResult Result;
+        };
+
+        void SwitchEnvironment(Environment& environment) {
+            // Switching is rare and expected to allocate: the filtering job, the batch and its upload.
+            sample::allocation::AllowAllocationsScope allowAllocations;
+
+            if (!environment.Result.valid()) {
+                // The file is read on the worker filtering it, and the cache keeps the filtered result for switching back.
+                const bool isCube = environment.File.stem().extension() == ".cube";
+                environment.Result = m_cache.Prefilter(environment.File.string(),
+                                                       [file = environment.File] { return sample::ReadFileBytes(file); },
+                                                       isCube ? Pbr::EnvironmentLayout::Cube : Pbr::EnvironmentLayout::Equirectangular);
+            }
+
+            // A switch still waiting for its filtering is replaced by the newer one.
+            if (m_pendingBatch) {
+                m_pendingBatch->Cancel();
+            }
+            m_pendingBatch = m_context.UploadQueue.CreateBatch(Pbr::UploadPriority::High);
+
+            // The textures are created and bound on the render thread, once the filtering finished.
+            Pbr::Upload upload;
+            upload.Stage = Pbr::UploadStage::Textures;
+            upload.IsReady = [result = environment.Result] { return result.wait_for(0s) == std::future_status::ready; };
+            upload.Run = [&context = m_context, result = environment.Result] {
+                const std::shared_ptr<const Pbr::PrefilteredEnvironment> filtered = result.get();
+                const winrt::com_ptr<ID3D11ShaderResourceView> specular =
+                    Pbr::Texture::CreateCubeTexture(context.Device.get(), filtered->Specular);
+                const winrt::com_ptr<ID3D11ShaderResourceView> diffuse =
+                    Pbr::Texture::CreateCubeTexture(context.Device.get(), filtered->Diffuse);
+                context.PbrResources.SetEnvironmentMap(specular.get(), diffuse.get());
+            };
+            m_context.UploadQueue.Enqueue(m_pendingBatch, std::move(upload));
+        }
+
+        XrAction m_switchAction{XR_NULL_HANDLE};
+        Pbr::EnvironmentCache m_cache;
+        std::vector<Environment> m_environments;
+        size_t m_currentIndex{static_cast<size_t>(-1)};
+        std::shared_ptr<Pbr::UploadBatch> m_pendingBatch;
+    };
+} // namespace
+
+std::unique_ptr<engine::Scene> TryCreateEnvironmentScene(engine::Context& context) {
+    const std::filesystem::path folder = sample::GetPathInAppFolder("Environments");
+    std::error_code error;
+    if (!std::filesystem::is_directory(folder, error)) {
+        return nullptr;
+    }
+
+    std::vector<std::filesystem::path> environmentFiles;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(folder, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".hdr") {
+            environmentFiles.push_back(entry.path());
+        }
+    }
+    std::sort(environmentFiles.begin(), environmentFiles.end());
+
+    return environmentFiles.empty() ? nullptr : std::make_unique<EnvironmentScene>(context, std::move(environmentFiles));
+}
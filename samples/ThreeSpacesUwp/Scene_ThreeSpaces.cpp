@@ -98,20 +98,16 @@ namespace {
         }
 
         void OnUpdate(const engine::FrameTime& frameTime) override {
-            XrActionStateBoolean selectState{XR_TYPE_ACTION_STATE_BOOLEAN};
-            XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
-            getInfo.action = m_selectAction;
-
-            getInfo.subactionPath = m_context.RightHand;
-            CHECK_XRCMD(xrGetActionStateBoolean(m_context.Session.Handle, &getInfo, &selectState));
-            if (selectState.isActive && selectState.changedSinceLastSync && selectState.currentState) {
-                PlaceThreeSpaces(m_rightAimSpace.Get(), selectState.lastChangeTime);
+            const xr::ActionStateSnapshot& actionStates = ActionContext().ActionStates();
+
+            const XrActionStateBoolean& rightSelectState = actionStates.Boolean(m_selectAction, m_context.RightHand);
+            if (rightSelectState.isActive && rightSelectState.changedSinceLastSync && rightSelectState.currentState) {
+                PlaceThreeSpaces(m_rightAimSpace.Get(), rightSelectState.lastChangeTime);
             }
 
-            getInfo.subactionPath = m_context.LeftHand;
-            CHECK_XRCMD(xrGetActionStateBoolean(m_context.Session.Handle, &getInfo, &selectState));
-            if (selectState.isActive && selectState.changedSinceLastSync && selectState.currentState) {
-                PlaceThreeSpaces(m_leftAimSpace.Get(), selectState.lastChangeTime);
+            const XrActionStateBoolean& leftSelectState = actionStates.Boolean(m_selectAction, m_context.LeftHand);
+            if (leftSelectState.isActive && leftSelectState.changedSinceLastSync && leftSelectState.currentState) {
+                PlaceThreeSpaces(m_leftAimSpace.Get(), leftSelectState.lastChangeTime);
             }
 
             for (auto& hologram : m_holograms) {
@@ -132,8 +128,7 @@ namespace {
                 return; // no visual to update.
             }
 
-            XrSpaceLocation spaceLocation{XR_TYPE_SPACE_LOCATION};
-            CHECK_XRCMD(xrLocateSpace(hologram.Space, m_context.SceneSpace, time, &spaceLocation));
+            const XrSpaceLocation spaceLocation = m_context.Spaces.Location(hologram.SpaceInScene, time);
 
             if (Pose::IsPoseValid(spaceLocation)) {
                 hologram.Object->SetVisible(true);
@@ -156,14 +151,14 @@ namespace {
                     return; // If extension is not supported, skip creating a hologram
                 }
 
-                XrSpaceLocation spaceLocation{XR_TYPE_SPACE_LOCATION};
-                CHECK_XRCMD(xrLocateSpace(space, baseSpace, time, &spaceLocation));
+                const XrSpaceLocation spaceLocation = m_context.Spaces.Locate(space, baseSpace, time);
 
                 // Only create a new hologram if the space is tracked
                 if (xr::math::Pose::IsPoseTracked(spaceLocation)) {
                     Hologram hologram;
                     hologram.Object = AddObject(engine::CreateCube(m_context.PbrResources, sideLength, color));
                     hologram.Space = baseSpace;
+                    hologram.SpaceInScene = m_context.Spaces.Register(baseSpace, m_context.SceneSpace);
                     hologram.Pose = Pose::Multiply(Pose::Translation(offset), spaceLocation.pose);
                     m_holograms.emplace_back(std::move(hologram));
                 }
@@ -180,8 +175,7 @@ namespace {
             }
 
             AnchorSpace anchorSpace;
-            XrSpaceLocation spaceLocation{XR_TYPE_SPACE_LOCATION};
-            CHECK_XRCMD(xrLocateSpace(space, m_context.SceneSpace, time, &spaceLocation));
+            const XrSpaceLocation spaceLocation = m_context.Spaces.Locate(space, m_context.SceneSpace, time);
 
             if (Pose::IsPoseValid(spaceLocation)) {
                 XrSpatialAnchorCreateInfoMSFT createInfo{XR_TYPE_SPATIAL_ANCHOR_CREATE_INFO_MSFT};
@@ -231,9 +225,9 @@ namespace {
 
             std::shared_ptr<engine::Object> Object;
             XrSpace Space = XR_NULL_HANDLE;
+            engine::SpaceLocator::Registration SpaceInScene;
             std::optional<XrPosef> Pose = {};
         };
-        std::vector<Hologram> m_holograms;
 
         xr::SpaceHandle m_unboundedSpace;
         xr::SpaceHandle m_localSpace;
@@ -243,6 +237,9 @@ namespace {
             xr::SpaceHandle Space;
         };
         std::vector<AnchorSpace> m_anchorSpaces;
+
+        // Declared after the spaces so the holograms release their space registrations before the spaces are destroyed.
+        std::vector<Hologram> m_holograms;
     };
 } // namespace
 
@@ -0,0 +1,278 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+// This file doesn't use the precompiled header, so that it also builds on its own for the tests on other platforms.
+#include "AllocationProfiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include "Trace.h"
+#else
+#include <cstdio>
+#define FMT_HEADER_ONLY
+#include <fmt/format.h>
+#endif
+
+namespace {
+    constexpr uint32_t MaxScopes = 64;
+    constexpr uint32_t UnscopedIndex = 0;
+
+    struct Counters {
+        std::atomic<uint64_t> AllocationCount{0};
+        std::atomic<uint64_t> AllocatedBytes{0};
+        std::atomic<uint64_t> FreeCount{0};
+
+        sample::allocation::Stats Load() const {
+            return {AllocationCount.load(std::memory_order_relaxed),
+                    AllocatedBytes.load(std::memory_order_relaxed),
+                    FreeCount.load(std::memory_order_relaxed)};
+        }
+
+        sample::allocation::Stats Exchange() {
+            return {AllocationCount.exchange(0, std::memory_order_relaxed),
+                    AllocatedBytes.exchange(0, std::memory_order_relaxed),
+                    FreeCount.exchange(0, std::memory_order_relaxed)};
+        }
+    };
+
+    struct ScopeSlot {
+        const char* Name{nullptr}; // Written once before the slot is published through ProfilerState::ScopeCount.
+        Counters Frame;
+        Counters Total;
+        sample::allocation::Stats LastFrame; // Guarded by ProfilerState::Mutex
+    };
+
+    struct ProfilerState {
+        std::mutex Mutex;
+        std::array<ScopeSlot, MaxScopes> Scopes;
+        std::atomic<uint32_t> ScopeCount{1};
+
+        std::atomic<bool> Installed{false};
+        std::atomic<uint64_t> FrameIndex{0};
+
+        std::atomic<bool> StrictSteadyState{false};
+        std::atomic<uint64_t> StrictFirstFrame{0};
+        std::atomic<sample::allocation::ViolationHandler> StrictHandler{nullptr};
+        std::atomic<uint64_t> StrictViolationCount{0};
+    };
+
+    // The hooks can run before static initialization and after static destruction, so the state is constructed on first use
+    // and deliberately never destroyed.
+    ProfilerState& State() {
+        alignas(ProfilerState) static std::byte storage[sizeof(ProfilerState)];
+        static ProfilerState* state = new (storage) ProfilerState();
+        return *state;
+    }
+
+    // Only trivially initialized thread locals are used, because they are accessed from operator new.
+    thread_local uint32_t t_currentScope = UnscopedIndex;
+    thread_local uint32_t t_allowAllocationsDepth = 0;
+    thread_local bool t_insideHook = false;
+
+    uint32_t FindOrAddScope(const char* name) noexcept {
+        ProfilerState& state = State();
+        const auto findScope = [&state, name](uint32_t count) -> uint32_t {
+            for (uint32_t i = UnscopedIndex + 1; i < count; i++) {
+                const char* slotName = state.Scopes[i].Name;
+                if (slotName == name || std::strcmp(slotName, name) == 0) {
+                    return i;
+                }
+            }
+            return UnscopedIndex;
+        };
+
+        if (const uint32_t index = findScope(state.ScopeCount.load(std::memory_order_acquire)); index != UnscopedIndex) {
+            return index;
+        }
+
+        std::lock_guard lock(state.Mutex);
+        const uint32_t count = state.ScopeCount.load(std::memory_order_relaxed);
+        if (const uint32_t index = findScope(count); index != UnscopedIndex) {
+            return index;
+        }
+        if (count == MaxScopes) {
+            return UnscopedIndex; // Out of slots, attribute to the unscoped entry rather than failing.
+        }
+        state.Scopes[count].Name = name;
+        state.ScopeCount.store(count + 1, std::memory_order_release);
+        return count;
+    }
+
+    template <typename... Args>
+    void TraceLine(const char* format, const Args&... args) {
+#ifdef _WIN32
+        sample::Trace(format, args...);
+#else
+        std::fprintf(stderr, "%s\n", fmt::format(format, args...).c_str());
+#endif
+    }
+
+    void ReportViolation(ProfilerState& state, uint32_t scopeIndex, size_t bytes) noexcept {
+        state.StrictViolationCount.fetch_add(1, std::memory_order_relaxed);
+
+        const char* scopeName = state.Scopes[scopeIndex].Name;
+        if (const sample::allocation::ViolationHandler handler = state.StrictHandler.load(std::memory_order_acquire)) {
+            handler(scopeName, bytes);
+            return;
+        }
+
+        try {
+            TraceLine("Steady-state allocation of {} bytes in scope \"{}\" on frame {}",
+                      bytes,
+                      scopeName,
+                      state.FrameIndex.load(std::memory_order_relaxed));
+        } catch (...) {
+            // Reporting is best effort, the process is stopped regardless.
+        }
+#ifdef _WIN32
+        if (::IsDebuggerPresent()) {
+            __debugbreak();
+            return;
+        }
+#endif
+        std::abort();
+    }
+} // namespace
+
+namespace sample::allocation {
+    Scope::Scope(const char* name) noexcept
+        : m_previousScope(t_currentScope) {
+        const bool wasInsideHook = std::exchange(t_insideHook, true); // Don't attribute the bookkeeping itself.
+        t_currentScope = FindOrAddScope(name);
+        t_insideHook = wasInsideHook;
+    }
+
+    Scope::~Scope() {
+        t_currentScope = m_previousScope;
+    }
+
+    AllowAllocationsScope::AllowAllocationsScope() noexcept {
+        t_allowAllocationsDepth++;
+    }
+
+    AllowAllocationsScope::~AllowAllocationsScope() {
+        t_allowAllocationsDepth--;
+    }
+
+    bool IsInstalled() noexcept {
+        return State().Installed.load(std::memory_order_relaxed);
+    }
+
+    void BeginFrame() noexcept {
+        ProfilerState& state = State();
+        std::lock_guard lock(state.Mutex);
+        const uint32_t count = state.ScopeCount.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < count; i++) {
+            state.Scopes[i].LastFrame = state.Scopes[i].Frame.Exchange();
+        }
+        state.FrameIndex.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t FrameIndex() noexcept {
+        return State().FrameIndex.load(std::memory_order_relaxed);
+    }
+
+    void EnableStrictSteadyState(uint32_t warmupFrames, ViolationHandler handler) noexcept {
+        ProfilerState& state = State();
+        state.StrictHandler.store(handler, std::memory_order_release);
+        state.StrictFirstFrame.store(state.FrameIndex.load(std::memory_order_relaxed) + warmupFrames + 1, std::memory_order_relaxed);
+        state.StrictSteadyState.store(true, std::memory_order_release);
+    }
+
+    void DisableStrictSteadyState() noexcept {
+        State().StrictSteadyState.store(false, std::memory_order_release);
+    }
+
+    uint64_t StrictViolationCount() noexcept {
+        return State().StrictViolationCount.load(std::memory_order_relaxed);
+    }
+
+    size_t GetScopeStats(ScopeStats* stats, size_t capacity) noexcept {
+        ProfilerState& state = State();
+        std::lock_guard lock(state.Mutex);
+        const size_t count = std::min<size_t>(capacity, state.ScopeCount.load(std::memory_order_relaxed));
+        for (size_t i = 0; i < count; i++) {
+            const ScopeSlot& slot = state.Scopes[i];
+            stats[i] = ScopeStats{i == UnscopedIndex ? "(unscoped)" : slot.Name, slot.LastFrame, slot.Total.Load()};
+        }
+        return count;
+    }
+
+    void TraceLastFrame() {
+        AllowAllocationsScope allowAllocations; // Formatting the trace may allocate.
+
+        std::array<ScopeStats, MaxScopes> stats;
+        const size_t count = GetScopeStats(stats.data(), stats.size());
+        for (size_t i = 0; i < count; i++) {
+            const Stats& lastFrame = stats[i].LastFrame;
+            if (lastFrame.AllocationCount > 0 || lastFrame.FreeCount > 0) {
+                TraceLine("Frame {} allocations in \"{}\": {} allocations ({} bytes), {} frees",
+                          FrameIndex(),
+                          stats[i].Name,
+                          lastFrame.AllocationCount,
+                          lastFrame.AllocatedBytes,
+                          lastFrame.FreeCount);
+            }
+        }
+    }
+
+    namespace detail {
+        void MarkInstalled() noexcept {
+            State().Installed.store(true, std::memory_order_relaxed);
+        }
+
+        void OnAllocate(size_t bytes) noexcept {
+            if (t_insideHook) {
+                return;
+            }
+            t_insideHook = true;
+
+            ProfilerState& state = State();
+            const uint32_t scopeIndex = t_currentScope;
+            ScopeSlot& slot = state.Scopes[scopeIndex];
+            slot.Frame.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+            slot.Frame.AllocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+            slot.Total.AllocationCount.fetch_add(1, std::memory_order_relaxed);
+            slot.Total.AllocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+            if (scopeIndex != UnscopedIndex && t_allowAllocationsDepth == 0 && state.StrictSteadyState.load(std::memory_order_acquire) &&
+                state.FrameIndex.load(std::memory_order_relaxed) >= state.StrictFirstFrame.load(std::memory_order_relaxed)) {
+                ReportViolation(state, scopeIndex, bytes);
+            }
+
+            t_insideHook = false;
+        }
+
+        void OnFree() noexcept {
+            if (t_insideHook) {
+                return;
+            }
+            ScopeSlot& slot = State().Scopes[t_currentScope];
+            slot.Frame.FreeCount.fetch_add(1, std::memory_order_relaxed);
+            slot.Total.FreeCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    } // namespace detail
+} // namespace sample::allocation
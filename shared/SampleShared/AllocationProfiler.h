@@ -0,0 +1,98 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Heap allocation profiler for finding allocations in the frame loop.
+//
+// Allocations are only observed when the global operator new/delete hooks are linked into the executable,
+// which is done by including <SampleShared/AllocationProfilerHooks.h> in exactly one .cpp file of the app.
+// Without the hooks, scopes and frames can still be declared, but all counters stay at zero.
+//
+// Each thread attributes its allocations to its innermost active Scope. Counters are kept for the last completed
+// frame and for the whole run. In strict steady-state mode, any allocation made inside a scope after the warm-up
+// frames is reported as a violation, so that new per-frame allocations are caught as soon as they are introduced.
+namespace sample::allocation {
+    struct Stats {
+        uint64_t AllocationCount{0};
+        uint64_t AllocatedBytes{0};
+        uint64_t FreeCount{0};
+    };
+
+    struct ScopeStats {
+        const char* Name{nullptr};
+        Stats LastFrame;
+        Stats Total;
+    };
+
+    // Attributes the allocations of the current thread to the named scope until the Scope is destroyed.
+    // Scopes nest, and the name must be a string with static storage duration, typically a literal.
+    class Scope {
+    public:
+        explicit Scope(const char* name) noexcept;
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        uint32_t m_previousScope;
+    };
+
+    // Allocations on the current thread are not reported as strict steady-state violations while this is alive.
+    // Use it around work that is expected to allocate occasionally, such as kicking off an asset load.
+    class AllowAllocationsScope {
+    public:
+        AllowAllocationsScope() noexcept;
+        ~AllowAllocationsScope();
+
+        AllowAllocationsScope(const AllowAllocationsScope&) = delete;
+        AllowAllocationsScope& operator=(const AllowAllocationsScope&) = delete;
+    };
+
+    using ViolationHandler = void (*)(const char* scopeName, size_t bytes);
+
+    // Returns true if the allocation hooks are linked into the executable.
+    bool IsInstalled() noexcept;
+
+    // Closes the statistics of the previous frame. Call once per frame from the thread that drives the frame loop.
+    void BeginFrame() noexcept;
+    uint64_t FrameIndex() noexcept;
+
+    // Reports every allocation made inside a scope once warmupFrames frames have begun.
+    // The handler is called on the allocating thread, and allocations it makes are not recorded.
+    // If no handler is given, a violation is written to the debug output and fails the app with std::abort, in release builds
+    // too, so that a run that allocates in steady state can't go unnoticed. Under a debugger, it breaks into it instead.
+    void EnableStrictSteadyState(uint32_t warmupFrames, ViolationHandler handler = nullptr) noexcept;
+    void DisableStrictSteadyState() noexcept;
+    uint64_t StrictViolationCount() noexcept;
+
+    // Copies the statistics of up to capacity scopes into stats and returns the number of scopes copied.
+    // The first entry collects the allocations made outside of any scope.
+    size_t GetScopeStats(ScopeStats* stats, size_t capacity) noexcept;
+
+    // Writes the allocations of the last completed frame to the debug output, one line per scope that allocated.
+    void TraceLastFrame();
+
+    namespace detail {
+        // Called by the hooks in AllocationProfilerHooks.h.
+        void MarkInstalled() noexcept;
+        void OnAllocate(size_t bytes) noexcept;
+        void OnFree() noexcept;
+    } // namespace detail
+} // namespace sample::allocation
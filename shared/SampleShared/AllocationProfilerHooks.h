@@ -0,0 +1,153 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+// Replaces the global operator new and delete of the executable to feed the allocation profiler.
+// Include this header in exactly one .cpp file of the app, for example next to its main function.
+// Only allocations made by code of the same module go through these operators; DLLs such as the OpenXR runtime are not observed.
+
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#include "AllocationProfiler.h"
+
+namespace sample::allocation::detail {
+    inline void* AlignedAllocate(size_t size, size_t alignment) {
+#ifdef _WIN32
+        return _aligned_malloc(size, alignment);
+#else
+        return std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+    }
+
+    inline void AlignedFree(void* ptr) {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+    inline void* HookedAllocate(size_t size, std::align_val_t alignment, bool throwOnFailure) {
+        for (;;) {
+            void* const ptr = alignment <= std::align_val_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__}
+                                  ? std::malloc(size == 0 ? 1 : size)
+                                  : AlignedAllocate(size == 0 ? 1 : size, static_cast<size_t>(alignment));
+            if (ptr != nullptr) {
+                OnAllocate(size);
+                return ptr;
+            }
+
+            const std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) {
+                if (throwOnFailure) {
+                    throw std::bad_alloc();
+                }
+                return nullptr;
+            }
+            handler();
+        }
+    }
+
+    inline void HookedFree(void* ptr, std::align_val_t alignment) noexcept {
+        if (ptr == nullptr) {
+            return;
+        }
+        OnFree();
+        if (alignment <= std::align_val_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__}) {
+            std::free(ptr);
+        } else {
+            AlignedFree(ptr);
+        }
+    }
+
+    inline void* HookedAllocateNoThrow(size_t size, std::align_val_t alignment) noexcept {
+        try {
+            return HookedAllocate(size, alignment, false);
+        } catch (...) {
+            return nullptr; // The new handler may throw
+        }
+    }
+
+    inline const bool HooksInstalled = (MarkInstalled(), true);
+
+    constexpr std::align_val_t DefaultAlignment{__STDCPP_DEFAULT_NEW_ALIGNMENT__};
+} // namespace sample::allocation::detail
+
+void* operator new(size_t size) {
+    return sample::allocation::detail::HookedAllocate(size, sample::allocation::detail::DefaultAlignment, true);
+}
+void* operator new[](size_t size) {
+    return sample::allocation::detail::HookedAllocate(size, sample::allocation::detail::DefaultAlignment, true);
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return sample::allocation::detail::HookedAllocateNoThrow(size, sample::allocation::detail::DefaultAlignment);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return sample::allocation::detail::HookedAllocateNoThrow(size, sample::allocation::detail::DefaultAlignment);
+}
+void* operator new(size_t size, std::align_val_t alignment) {
+    return sample::allocation::detail::HookedAllocate(size, alignment, true);
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return sample::allocation::detail::HookedAllocate(size, alignment, true);
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return sample::allocation::detail::HookedAllocateNoThrow(size, alignment);
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return sample::allocation::detail::HookedAllocateNoThrow(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {
+    sample::allocation::detail::HookedFree(ptr, sample::allocation::detail::DefaultAlignment);
+}
+void operator delete[](void* ptr) noexcept {
+    sample::allocation::detail::HookedFree(ptr, sample::allocation::detail::DefaultAlignment);
+}
+void operator delete(void* ptr, size_t) noexcept {
+    sample::allocation::detail::HookedFree(ptr, sample::allocation::detail::DefaultAlignment);
+}
+void operator delete[](void* ptr, size_t) noexcept {
+    sample::allocation::detail::HookedFree(ptr, sample::allocation::detail::DefaultAlignment);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    sample::allocation::detail::HookedFree(ptr, sample::allocation::detail::DefaultAlignment);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    sample::allocation::detail::HookedFree(ptr, sample::allocation::detail::DefaultAlignment);
+}
+void operator delete(void* ptr, std::align_val_t alignment) noexcept {
+    sample::allocation::detail::HookedFree(ptr, alignment);
+}
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept {
+    sample::allocation::detail::HookedFree(ptr, alignment);
+}
+void operator delete(void* ptr, size_t, std::align_val_t alignment) noexcept {
+    sample::allocation::detail::HookedFree(ptr, alignment);
+}
+void operator delete[](void* ptr, size_t, std::align_val_t alignment) noexcept {
+    sample::allocation::detail::HookedFree(ptr, alignment);
+}
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    sample::allocation::detail::HookedFree(ptr, alignment);
+}
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    sample::allocation::detail::HookedFree(ptr, alignment);
+}
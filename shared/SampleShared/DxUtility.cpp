@@ -102,6 +102,7 @@ namespace sample::dx {
         swapchain.Format = format;
         swapchain.Width = width;
         swapchain.Height = height;
+        swapchain.ArraySize = arrayLength;
 
         XrSwapchainCreateInfo swapchainCreateInfo{XR_TYPE_SWAPCHAIN_CREATE_INFO};
         swapchainCreateInfo.arraySize = arrayLength;
@@ -132,6 +133,48 @@ namespace sample::dx {
                                                &chainLength,
                                                reinterpret_cast<XrSwapchainImageBaseHeader*>(swapchain.Images.data())));
 
+        // The images live as long as the swapchain, so the views into them are created once here instead of for each frame.
+        // They use the swapchain format because the runtime may allocate the images with a typeless format.
+        const bool isColor = (usageFlags & XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT) != 0;
+        const bool isDepth = (usageFlags & XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) != 0;
+        if (isColor || isDepth) {
+            winrt::com_ptr<ID3D11Device> device;
+            swapchain.Images[0].texture->GetDevice(device.put());
+
+            const bool multisampled = sampleCount > 1;
+            const auto createViews = [&](ID3D11Texture2D* texture, uint32_t firstArraySlice, uint32_t arraySize, bool wholeArray) {
+                if (isColor) {
+                    const CD3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc(
+                        multisampled ? D3D11_RTV_DIMENSION_TEXTURE2DMSARRAY : D3D11_RTV_DIMENSION_TEXTURE2DARRAY,
+                        format,
+                        0 /* mipSlice */,
+                        firstArraySlice,
+                        arraySize);
+                    auto& views = wholeArray ? swapchain.ArrayRenderTargetViews : swapchain.RenderTargetViews;
+                    CHECK_HRCMD(device->CreateRenderTargetView(texture, &renderTargetViewDesc, views.emplace_back().put()));
+                }
+                if (isDepth) {
+                    const CD3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc(
+                        multisampled ? D3D11_DSV_DIMENSION_TEXTURE2DMSARRAY : D3D11_DSV_DIMENSION_TEXTURE2DARRAY,
+                        format,
+                        0 /* mipSlice */,
+                        firstArraySlice,
+                        arraySize);
+                    auto& views = wholeArray ? swapchain.ArrayDepthStencilViews : swapchain.DepthStencilViews;
+                    CHECK_HRCMD(device->CreateDepthStencilView(texture, &depthStencilViewDesc, views.emplace_back().put()));
+                }
+            };
+
+            for (const XrSwapchainImageD3D11KHR& image : swapchain.Images) {
+                for (uint32_t arraySlice = 0; arraySlice < arrayLength; arraySlice++) {
+                    createViews(image.texture, arraySlice, 1, false /* wholeArray */);
+                }
+                if (arrayLength > 1) {
+                    createViews(image.texture, 0, arrayLength, true /* wholeArray */);
+                }
+            }
+        }
+
         return swapchain;
     }
 
@@ -171,4 +214,58 @@ namespace sample::dx {
         return {d3d11Binding, device, deviceContext};
     }
 
+    GpuTimer::GpuTimer(ID3D11Device* device, uint32_t latency)
+        : m_querySets(latency) {
+        for (QuerySet& querySet : m_querySets) {
+            const CD3D11_QUERY_DESC disjointDesc(D3D11_QUERY_TIMESTAMP_DISJOINT);
+            const CD3D11_QUERY_DESC timestampDesc(D3D11_QUERY_TIMESTAMP);
+            CHECK_HRCMD(device->CreateQuery(&disjointDesc, querySet.Disjoint.put()));
+            CHECK_HRCMD(device->CreateQuery(&timestampDesc, querySet.Begin.put()));
+            CHECK_HRCMD(device->CreateQuery(&timestampDesc, querySet.End.put()));
+        }
+    }
+
+    void GpuTimer::Begin(ID3D11DeviceContext* context) {
+        QuerySet& querySet = m_querySets[m_nextIndex];
+        if (querySet.Pending) {
+            // The GPU is more than latency spans behind. Drop the oldest measurement rather than waiting for it.
+            querySet.Pending = false;
+            m_oldestIndex = (m_oldestIndex + 1) % m_querySets.size();
+        }
+
+        context->Begin(querySet.Disjoint.get());
+        context->End(querySet.Begin.get());
+    }
+
+    void GpuTimer::End(ID3D11DeviceContext* context) {
+        QuerySet& querySet = m_querySets[m_nextIndex];
+        context->End(querySet.End.get());
+        context->End(querySet.Disjoint.get());
+        querySet.Pending = true;
+        m_nextIndex = (m_nextIndex + 1) % m_querySets.size();
+    }
+
+    std::optional<XrDuration> GpuTimer::Read(ID3D11DeviceContext* context) {
+        std::optional<XrDuration> latest;
+        while (m_querySets[m_oldestIndex].Pending) {
+            QuerySet& querySet = m_querySets[m_oldestIndex];
+
+            D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+            UINT64 begin, end;
+            constexpr UINT flags = D3D11_ASYNC_GETDATA_DONOTFLUSH;
+            if (context->GetData(querySet.Disjoint.get(), &disjoint, sizeof(disjoint), flags) != S_OK ||
+                context->GetData(querySet.Begin.get(), &begin, sizeof(begin), flags) != S_OK ||
+                context->GetData(querySet.End.get(), &end, sizeof(end), flags) != S_OK) {
+                break; // Not finished yet, and the later spans can't have finished before it.
+            }
+
+            querySet.Pending = false;
+            m_oldestIndex = (m_oldestIndex + 1) % m_querySets.size();
+            if (!disjoint.Disjoint && disjoint.Frequency > 0 && end >= begin) {
+                latest = static_cast<XrDuration>((end - begin) * 1'000'000'000.0 / disjoint.Frequency);
+            }
+        }
+        return latest;
+    }
+
 } // namespace sample::dx
@@ -39,7 +39,34 @@ namespace sample::dx {
         DXGI_FORMAT Format{DXGI_FORMAT_UNKNOWN};
         int32_t Width{0};
         int32_t Height{0};
+        uint32_t ArraySize{0};
         std::vector<XrSwapchainImageD3D11KHR> Images;
+
+        // Views into each array slice of each image, created with the swapchain according to its usage flags,
+        // so that rendering doesn't create views every frame. They are released together with the swapchain.
+        std::vector<winrt::com_ptr<ID3D11RenderTargetView>> RenderTargetViews;
+        std::vector<winrt::com_ptr<ID3D11DepthStencilView>> DepthStencilViews;
+
+        // Views into all array slices of each image at once, for rendering every slice in a single pass.
+        // Only created for swapchains with more than one array slice.
+        std::vector<winrt::com_ptr<ID3D11RenderTargetView>> ArrayRenderTargetViews;
+        std::vector<winrt::com_ptr<ID3D11DepthStencilView>> ArrayDepthStencilViews;
+
+        ID3D11RenderTargetView* RenderTargetView(uint32_t imageIndex, uint32_t arraySlice) const {
+            return RenderTargetViews.at(imageIndex * ArraySize + arraySlice).get();
+        }
+
+        ID3D11DepthStencilView* DepthStencilView(uint32_t imageIndex, uint32_t arraySlice) const {
+            return DepthStencilViews.at(imageIndex * ArraySize + arraySlice).get();
+        }
+
+        ID3D11RenderTargetView* ArrayRenderTargetView(uint32_t imageIndex) const {
+            return ArrayRenderTargetViews.at(imageIndex).get();
+        }
+
+        ID3D11DepthStencilView* ArrayDepthStencilView(uint32_t imageIndex) const {
+            return ArrayDepthStencilViews.at(imageIndex).get();
+        }
     };
 
     SwapchainD3D11 CreateSwapchainD3D11(XrSession session,
@@ -51,4 +78,29 @@ namespace sample::dx {
                                         XrSwapchainCreateFlags createFlags,
                                         XrSwapchainUsageFlags usageFlags,
                                         std::optional<XrViewConfigurationType> viewConfigurationForSwapchain = std::nullopt);
+
+    // Measures how long the GPU takes to execute the commands between Begin and End with timestamp queries.
+    // The queries of the last few spans are in flight at once and are read back without flushing, so the CPU never waits for the GPU.
+    class GpuTimer {
+    public:
+        explicit GpuTimer(ID3D11Device* device, uint32_t latency = 4);
+
+        void Begin(ID3D11DeviceContext* context);
+        void End(ID3D11DeviceContext* context);
+
+        // Collects the spans the GPU has finished and returns the duration of the most recent one, if any finished since the last call.
+        std::optional<XrDuration> Read(ID3D11DeviceContext* context);
+
+    private:
+        struct QuerySet {
+            winrt::com_ptr<ID3D11Query> Disjoint;
+            winrt::com_ptr<ID3D11Query> Begin;
+            winrt::com_ptr<ID3D11Query> End;
+            bool Pending{false};
+        };
+
+        std::vector<QuerySet> m_querySets;
+        uint32_t m_nextIndex{0};   // The set used by the next Begin
+        uint32_t m_oldestIndex{0}; // The oldest pending set
+    };
 } // namespace sample::dx
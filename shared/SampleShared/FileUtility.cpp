@@ -92,6 +92,55 @@ namespace sample {
         return "";
     }
 
+    DdsTextureStore::DdsTextureStore(std::filesystem::path folder)
+        : m_folder(std::move(folder)) {
+    }
+
+    winrt::com_ptr<ID3D11ShaderResourceView> DdsTextureStore::Load(_In_ ID3D11Device* device, const std::string& key) {
+        const std::filesystem::path path = m_folder / (key + ".dds");
+        std::error_code error;
+        if (!std::filesystem::exists(path, error)) {
+            return nullptr;
+        }
+
+        winrt::com_ptr<ID3D11ShaderResourceView> textureView;
+        if (FAILED(DirectX::CreateDDSTextureFromFile(device, path.c_str(), nullptr, textureView.put()))) {
+            // A damaged file is removed, so the texture is transcoded and stored again.
+            sample::Trace("Removing unreadable texture "{}"", path.string());
+            std::filesystem::remove(path, error);
+            return nullptr;
+        }
+
+        return textureView;
+    }
+
+    void DdsTextureStore::Store(const std::string& key, const std::vector<uint8_t>& ddsFile) {
+        // Write to a temporary file first, so a concurrent load never sees a partially written texture.
+        const std::filesystem::path path = m_folder / (key + ".dds");
+        const std::filesystem::path tempPath = m_folder / fmt::format("{}.{}.tmp", key, ::GetCurrentThreadId());
+        try {
+            std::filesystem::create_directories(m_folder);
+            {
+                std::ofstream file;
+                file.exceptions(std::ios::failbit | std::ios::badbit);
+                file.open(tempPath, std::ios::binary | std::ios::trunc);
+                file.write(reinterpret_cast<const char*>(ddsFile.data()), ddsFile.size());
+            }
+            std::filesystem::rename(tempPath, path);
+        } catch (const std::exception& ex) {
+            // The store is only a cache, the texture is transcoded again on the next load.
+            sample::Trace("Failed to store texture "{}": {}", path.string(), ex.what());
+            std::error_code error;
+            std::filesystem::remove(tempPath, error);
+        }
+    }
+
+    std::vector<uint8_t> DdsTextureStore::Read(const std::string& key) {
+        const std::filesystem::path path = m_folder / (key + ".dds");
+        std::error_code error;
+        return std::filesystem::exists(path, error) ? ReadFileBytes(path) : std::vector<uint8_t>();
+    }
+
     Pbr::Resources InitializePbrResources(ID3D11Device* device, bool environmentIBL) {
         Pbr::Resources pbrResources(device);
 
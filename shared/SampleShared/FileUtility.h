@@ -15,6 +15,7 @@
 //*********************************************************
 #pragma once
 #include <filesystem>
+#include <pbr/PbrBlockCompression.h>
 
 namespace Pbr {
     struct Model;
@@ -32,5 +33,18 @@ namespace sample {
     std::filesystem::path FindFileInAppFolder(const std::filesystem::path& filename,
                                               const std::vector<std::filesystem::path>& searchFolders = {""});
 
+    // Keeps block compressed textures as DDS files in a folder, so that glTF images are only transcoded on their first load.
+    class DdsTextureStore : public Pbr::TextureStore {
+    public:
+        explicit DdsTextureStore(std::filesystem::path folder);
+
+        winrt::com_ptr<ID3D11ShaderResourceView> Load(_In_ ID3D11Device* device, const std::string& key) override;
+        void Store(const std::string& key, const std::vector<uint8_t>& ddsFile) override;
+        std::vector<uint8_t> Read(const std::string& key) override;
+
+    private:
+        const std::filesystem::path m_folder;
+    };
+
     Pbr::Resources InitializePbrResources(ID3D11Device* device, bool environmentIBL = true);
 } // namespace sample
@@ -0,0 +1,172 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sample {
+    // A linear allocator for short-lived allocations that are all released together, such as the containers built during a frame.
+    // Allocations are carved out of a single block by bumping an offset, and Reset rewinds the offset for the next frame.
+    // If a frame needs more memory than the block holds, overflow blocks are allocated for the rest of the frame and Reset replaces
+    // them with a single larger block, so a frame loop stops touching the heap once the arena has grown to its working set.
+    // A FrameArena is not thread-safe, each thread that builds per-frame data should use its own arena.
+    class FrameArena {
+    public:
+        explicit FrameArena(size_t initialCapacity = 16 * 1024)
+            : m_block(AllocateBlock(initialCapacity)) {
+        }
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+            m_frameBytes += size;
+            if (void* ptr = AllocateFrom(m_block, size, alignment)) {
+                return ptr;
+            }
+            if (!m_overflowBlocks.empty()) {
+                if (void* ptr = AllocateFrom(m_overflowBlocks.back(), size, alignment)) {
+                    return ptr;
+                }
+            }
+
+            // Over-allocate by the alignment so any alignment can be satisfied from the start of the block.
+            m_overflowBlocks.push_back(AllocateBlock(std::max(size + alignment, m_block.Size)));
+            return AllocateFrom(m_overflowBlocks.back(), size, alignment);
+        }
+
+        // Memory is reclaimed by Reset. Only the most recent allocation is given back immediately, such as a temporary buffer
+        // released before anything else was allocated. A growing vector allocates its new buffer before freeing the old one, so
+        // the old buffer stays used until Reset: reserve the containers built from an arena up front when the size is known.
+        void Deallocate(void* ptr, size_t size) noexcept {
+            Block& block = m_overflowBlocks.empty() ? m_block : m_overflowBlocks.back();
+            std::byte* const bytes = static_cast<std::byte*>(ptr);
+            if (bytes + size == block.Data.get() + block.Offset) {
+                block.Offset -= size;
+                m_frameBytes -= size;
+            }
+        }
+
+        // Creates an object in the arena. Its destructor is never called, so only trivially destructible types are allowed.
+        template <typename T, typename... Args>
+        T* New(Args&&... args) {
+            static_assert(std::is_trivially_destructible_v<T>, "FrameArena does not run destructors.");
+            return new (Allocate(sizeof(T), alignof(T))) T{std::forward<Args>(args)...};
+        }
+
+        // Releases all allocations. Objects allocated from the arena must not be used after this call.
+        void Reset() {
+            if (!m_overflowBlocks.empty()) {
+                const size_t requiredSize = m_frameBytes + m_frameBytes / 2;
+                m_overflowBlocks.clear();
+                m_block = AllocateBlock(std::max(m_block.Size * 2, requiredSize));
+                m_growthCount++;
+            }
+            m_block.Offset = 0;
+            m_frameBytes = 0;
+        }
+
+        size_t Capacity() const {
+            return m_block.Size;
+        }
+
+        // The number of times Reset had to replace the block with a larger one. Stays constant in a steady state frame loop.
+        uint32_t GrowthCount() const {
+            return m_growthCount;
+        }
+
+    private:
+        struct Block {
+            std::unique_ptr<std::byte[]> Data;
+            size_t Size{0};
+            size_t Offset{0};
+        };
+
+        static Block AllocateBlock(size_t size) {
+            return Block{std::make_unique<std::byte[]>(size), size, 0};
+        }
+
+        static void* AllocateFrom(Block& block, size_t size, size_t alignment) {
+            const uintptr_t base = reinterpret_cast<uintptr_t>(block.Data.get());
+            const uintptr_t aligned = (base + block.Offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+            const size_t offset = static_cast<size_t>(aligned - base);
+            if (offset > block.Size || size > block.Size - offset) {
+                return nullptr;
+            }
+            block.Offset = offset + size;
+            return block.Data.get() + offset;
+        }
+
+        Block m_block;
+        std::vector<Block> m_overflowBlocks;
+        size_t m_frameBytes{0};
+        uint32_t m_growthCount{0};
+    };
+
+    // Standard allocator that allocates from a FrameArena, for use with standard containers.
+    // The arena must outlive the containers, and the containers must not be used after the arena is reset.
+    template <typename T>
+    class FrameArenaAllocator {
+    public:
+        using value_type = T;
+
+        FrameArenaAllocator(FrameArena& arena) noexcept
+            : m_arena(&arena) {
+        }
+
+        template <typename U>
+        FrameArenaAllocator(const FrameArenaAllocator<U>& other) noexcept
+            : m_arena(other.m_arena) {
+        }
+
+        T* allocate(size_t count) {
+            if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+                throw std::bad_array_new_length();
+            }
+            return static_cast<T*>(m_arena->Allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* ptr, size_t count) noexcept {
+            m_arena->Deallocate(ptr, count * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const FrameArenaAllocator<U>& other) const noexcept {
+            return m_arena == other.m_arena;
+        }
+
+        template <typename U>
+        bool operator!=(const FrameArenaAllocator<U>& other) const noexcept {
+            return m_arena != other.m_arena;
+        }
+
+    private:
+        template <typename U>
+        friend class FrameArenaAllocator;
+
+        FrameArena* m_arena;
+    };
+
+    template <typename T>
+    using FrameVector = std::vector<T, FrameArenaAllocator<T>>;
+} // namespace sample
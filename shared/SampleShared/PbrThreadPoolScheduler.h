@@ -0,0 +1,56 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+#include <exception>
+#include <system_error>
+#include <pbr/PbrTaskScheduler.h>
+#include "ThreadPool.h"
+
+namespace sample {
+    // Runs the image decodes, environment filtering and mip chain bands of the Pbr library on a ThreadPool, instead of starting
+    // threads for every job and every level. Install it with Pbr::SetTaskScheduler.
+    class PbrThreadPoolScheduler final : public Pbr::TaskScheduler {
+    public:
+        explicit PbrThreadPoolScheduler(size_t threadCount)
+            : m_pool(threadCount) {
+        }
+
+        void Run(std::function<void()> task) override {
+            if (!m_pool.Submit([task = std::move(task)] { task(); })) {
+                throw std::system_error(std::make_error_code(std::errc::operation_canceled));
+            }
+        }
+
+        // The calling thread runs tasks of the pool while it waits, so bands started from a pool task can't starve the pool.
+        void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& body) override {
+            m_pool.ParallelFor(0, count, [&body](size_t index) { body(static_cast<uint32_t>(index)); }, 1);
+        }
+
+        uint32_t ThreadCount() const override {
+            return static_cast<uint32_t>(m_pool.ThreadCount());
+        }
+
+        // The jobs of the Pbr library report their own failures, so an exception reaching the pool is a bug the app should fail
+        // on. See ThreadPool::TakeUnhandledException.
+        std::exception_ptr TakeUnhandledException() {
+            return m_pool.TakeUnhandledException();
+        }
+
+    private:
+        ThreadPool m_pool;
+    };
+} // namespace sample
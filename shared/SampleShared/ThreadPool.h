@@ -17,45 +17,232 @@
 
 #include <thread>
 #include <condition_variable>
+#include <cstddef>
+#include <exception>
 #include <mutex>
 #include <vector>
-#include <deque>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <new>
+#include <optional>
+#include <system_error>
+#include <type_traits>
+#include <utility>
 
 namespace sample {
+    // A work-stealing thread pool.
+    // Every worker thread owns a lock-free deque. Tasks spawned on a worker thread are pushed to and popped from the bottom of
+    // its own deque, while idle workers steal from the top of the other workers' deques. Tasks submitted from threads outside
+    // of the pool go through a shared injection queue. Idle workers spin for a short while before parking, and so do threads
+    // waiting for a Future or a TaskGroup once there is no task left for them to help with.
+    // Task nodes are recycled, so Submit, SubmitBatch and TaskGroup::Run do not allocate once the pool has warmed up or after
+    // ReserveTasks, as long as the task's captures fit in UniqueFunction::InlineSize.
     class ThreadPool final {
         // Move-only alternative to using std::function<void()>
+        // Functions whose captures fit in InlineSize bytes are stored inline, so wrapping a typical task lambda does not allocate.
         class UniqueFunction {
-            struct TypelessFunction {
-                virtual void Call() = 0;
-                virtual ~TypelessFunction() {
+        public:
+            static constexpr size_t InlineSize = 64;
+
+            UniqueFunction() noexcept = default;
+
+            template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, UniqueFunction>>>
+            explicit UniqueFunction(F&& f) {
+                using Function = std::decay_t<F>;
+                if constexpr (IsStoredInline<Function>) {
+                    new (&m_storage) Function(std::move(f));
+                    m_operations = &InlineOperations<Function>;
+                } else {
+                    *reinterpret_cast<Function**>(&m_storage) = new Function(std::move(f));
+                    m_operations = &HeapOperations<Function>;
+                }
+            }
+
+            ~UniqueFunction() {
+                Reset();
+            }
+
+            UniqueFunction(const UniqueFunction&) = delete;
+            UniqueFunction& operator=(const UniqueFunction&) = delete;
+
+            UniqueFunction(UniqueFunction&& other) noexcept {
+                MoveFrom(other);
+            }
+
+            UniqueFunction& operator=(UniqueFunction&& other) noexcept {
+                if (this != &other) {
+                    Reset();
+                    MoveFrom(other);
+                }
+                return *this;
+            }
+
+            void operator()() {
+                m_operations->Call(&m_storage);
+            }
+
+            explicit operator bool() const noexcept {
+                return m_operations != nullptr;
+            }
+
+            // Destroys the stored function and its captures.
+            void Reset() noexcept {
+                if (m_operations != nullptr) {
+                    m_operations->Destroy(&m_storage);
+                    m_operations = nullptr;
                 }
+            }
+
+        private:
+            struct Operations {
+                void (*Call)(void* storage);
+                void (*Move)(void* destination, void* source) noexcept; // Move constructs into destination and destroys source.
+                void (*Destroy)(void* storage) noexcept;
             };
-            std::unique_ptr<TypelessFunction> m_impl;
-            template <typename F>
-            struct TypedFunction : TypelessFunction {
-                F m_func;
-                TypedFunction(F&& func)
-                    : m_func(std::move(func)) {
+
+            using Storage = std::aligned_storage_t<InlineSize, alignof(std::max_align_t)>;
+
+            template <typename Function>
+            static constexpr bool IsStoredInline = sizeof(Function) <= InlineSize && alignof(Function) <= alignof(Storage) &&
+                                                   std::is_nothrow_move_constructible_v<Function>;
+
+            template <typename Function>
+            static constexpr Operations InlineOperations{
+                [](void* storage) { (*static_cast<Function*>(storage))(); },
+                [](void* destination, void* source) noexcept {
+                    new (destination) Function(std::move(*static_cast<Function*>(source)));
+                    static_cast<Function*>(source)->~Function();
+                },
+                [](void* storage) noexcept { static_cast<Function*>(storage)->~Function(); }};
+
+            template <typename Function>
+            static constexpr Operations HeapOperations{
+                [](void* storage) { (**static_cast<Function**>(storage))(); },
+                [](void* destination, void* source) noexcept { *static_cast<Function**>(destination) = *static_cast<Function**>(source); },
+                [](void* storage) noexcept { delete *static_cast<Function**>(storage); }};
+
+            void MoveFrom(UniqueFunction& other) noexcept {
+                m_operations = std::exchange(other.m_operations, nullptr);
+                if (m_operations != nullptr) {
+                    m_operations->Move(&m_storage, &other.m_storage);
+                }
+            }
+
+            Storage m_storage;
+            const Operations* m_operations{nullptr};
+        };
+
+        // Task nodes are pooled by the SharedState and recycled after execution, see SharedState::AcquireLocalTask.
+        struct Task {
+            UniqueFunction Func;
+            Task* Next{nullptr}; // Links the node into the injection queue or a free list.
+        };
+
+        // Chase-Lev work-stealing deque, using the memory orderings from "Correct and Efficient Work-Stealing for Weak Memory Models".
+        // Only the owning worker thread may call Push and Pop. Any thread may call Steal.
+        class WorkStealingDeque {
+            struct Ring {
+                explicit Ring(int64_t capacity)
+                    : Capacity(capacity)
+                    , Items(new std::atomic<Task*>[static_cast<size_t>(capacity)]) {
+                }
+                Task* Get(int64_t index) const {
+                    return Items[static_cast<size_t>(index & (Capacity - 1))].load(std::memory_order_relaxed);
                 }
-                void Call() override {
-                    m_func();
+                void Put(int64_t index, Task* task) {
+                    Items[static_cast<size_t>(index & (Capacity - 1))].store(task, std::memory_order_relaxed);
                 }
+
+                const int64_t Capacity; // Must be power-of-two
+                std::unique_ptr<std::atomic<Task*>[]> Items;
             };
 
         public:
-            template <typename F>
-            explicit UniqueFunction(F&& f)
-                : m_impl(new TypedFunction<F>(std::move(f))) {
+            explicit WorkStealingDeque(int64_t initialCapacity = 256) {
+                m_rings.push_back(std::make_unique<Ring>(initialCapacity));
+                m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
             }
-            UniqueFunction() = delete;
-            UniqueFunction(const UniqueFunction&) = delete;
-            UniqueFunction& operator=(const UniqueFunction&) = delete;
-            UniqueFunction(UniqueFunction&& other) noexcept = default;
-            UniqueFunction& operator=(UniqueFunction&& other) noexcept = default;
 
-            void operator()() {
-                m_impl->Call();
+            WorkStealingDeque(const WorkStealingDeque&) = delete;
+            WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+            bool Empty() const {
+                return m_top.load(std::memory_order_acquire) >= m_bottom.load(std::memory_order_acquire);
+            }
+
+            void Push(Task* task) {
+                const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+                const int64_t top = m_top.load(std::memory_order_acquire);
+                Ring* ring = m_ring.load(std::memory_order_relaxed);
+                if (bottom - top > ring->Capacity - 1) {
+                    ring = Grow(ring, top, bottom);
+                }
+                ring->Put(bottom, task);
+                m_bottom.store(bottom + 1, std::memory_order_release);
             }
+
+            Task* Pop() {
+                const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+                Ring* ring = m_ring.load(std::memory_order_relaxed);
+                m_bottom.store(bottom, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t top = m_top.load(std::memory_order_relaxed);
+
+                if (top > bottom) {
+                    // The deque was already empty.
+                    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                Task* task = ring->Get(bottom);
+                if (top == bottom) {
+                    // This is the last item, race against the thieves for it.
+                    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                        task = nullptr;
+                    }
+                    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                }
+                return task;
+            }
+
+            Task* Steal() {
+                int64_t top = m_top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+                if (top >= bottom) {
+                    return nullptr;
+                }
+
+                Ring* ring = m_ring.load(std::memory_order_acquire);
+                Task* task = ring->Get(top);
+                if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    return nullptr; // Lost the race against the owner or another thief.
+                }
+                return task;
+            }
+
+        private:
+            Ring* Grow(Ring* ring, int64_t top, int64_t bottom) {
+                auto newRing = std::make_unique<Ring>(ring->Capacity * 2);
+                for (int64_t i = top; i < bottom; i++) {
+                    newRing->Put(i, ring->Get(i));
+                }
+                // Thieves may still be reading from the old ring, so it is retired instead of deleted until the deque is destroyed.
+                m_rings.push_back(std::move(newRing));
+                m_ring.store(m_rings.back().get(), std::memory_order_release);
+                return m_rings.back().get();
+            }
+
+#pragma warning(push)
+#pragma warning(disable : 4324) // Structure was padded due to alignment specifier
+            alignas(64) std::atomic<int64_t> m_top{0};
+            alignas(64) std::atomic<int64_t> m_bottom{0};
+            alignas(64) std::atomic<Ring*> m_ring{nullptr};
+#pragma warning(pop)
+            std::vector<std::unique_ptr<Ring>> m_rings;
         };
 
         // The state shared between all of the threads in the thread pool.
@@ -63,56 +250,97 @@ namespace sample {
         struct SharedState : std::enable_shared_from_this<SharedState> {
             explicit SharedState(size_t threadCount) {
                 m_threads.reserve(threadCount);
+                m_workers.reserve(threadCount);
+                for (size_t i = 0; i < threadCount; ++i) {
+                    m_workers.push_back(std::make_unique<Worker>());
+                }
             }
 
-            template<typename F>
-            _Requires_lock_not_held_(m_mutex) bool SubmitUnique(F&& f) {
-                {
-                    std::lock_guard guard(m_mutex);
-                    if (!m_allowSubmit) {
+            size_t WorkerCount() const {
+                return m_workers.size();
+            }
+
+            // Schedules a task submitted through the public interface. Returns false once the pool stopped accepting tasks.
+            template <typename F>
+            _Requires_lock_not_held_(m_injectionMutex) bool SubmitUnique(F&& f) {
+                UniqueFunction func(std::move(f));
+                if (IsCurrentThreadWorker()) {
+                    if (!m_allowSubmit.load(std::memory_order_acquire)) {
+                        return false;
+                    }
+                    PushLocal(AcquireLocalTask(std::move(func)));
+                } else {
+                    std::lock_guard guard(m_injectionMutex);
+                    if (!m_allowSubmit.load(std::memory_order_relaxed)) {
                         return false;
                     }
-                    m_tasks.emplace_back(std::move(f));
+                    PushInjected(AcquireSharedTask(std::move(func)));
                 }
-                m_cond.notify_one();
+                NotifyWorkAvailable(1);
                 return true;
             }
 
-            _Requires_lock_not_held_(m_mutex) void AddThread() {
-                std::lock_guard guard(m_mutex);
-                m_threads.emplace_back([this]() {
+            // Schedules all functions in [first, last), moving them out of the range.
+            // External threads take the injection lock once for the whole batch, and sleeping workers are woken once.
+            template <typename Iterator>
+            _Requires_lock_not_held_(m_injectionMutex) bool SubmitBatch(Iterator first, Iterator last) {
+                size_t count = 0;
+                if (IsCurrentThreadWorker()) {
+                    if (!m_allowSubmit.load(std::memory_order_acquire)) {
+                        return false;
+                    }
+                    for (; first != last; ++first, ++count) {
+                        PushLocal(AcquireLocalTask(UniqueFunction(std::move(*first))));
+                    }
+                } else {
+                    std::lock_guard guard(m_injectionMutex);
+                    if (!m_allowSubmit.load(std::memory_order_relaxed)) {
+                        return false;
+                    }
+                    for (; first != last; ++first, ++count) {
+                        PushInjected(AcquireSharedTask(UniqueFunction(std::move(*first))));
+                    }
+                }
+                NotifyWorkAvailable(count);
+                return true;
+            }
+
+            // Schedules a task created by the pool itself (task groups, continuations and parallel loops).
+            // These tasks are part of work that is already in flight, so they are accepted even after DisallowSubmit.
+            _Requires_lock_not_held_(m_injectionMutex) void Spawn(UniqueFunction func) {
+                if (IsCurrentThreadWorker()) {
+                    PushLocal(AcquireLocalTask(std::move(func)));
+                } else {
+                    std::lock_guard guard(m_injectionMutex);
+                    PushInjected(AcquireSharedTask(std::move(func)));
+                }
+                NotifyWorkAvailable(1);
+            }
+
+            _Requires_lock_not_held_(m_injectionMutex) void AddThread() {
+                std::lock_guard guard(m_injectionMutex);
+                const size_t workerIndex = m_threads.size();
+                m_threads.emplace_back([this, workerIndex]() {
                     if (auto keepAlive = shared_from_this()) {
-                        for (;;) {
-                            std::unique_lock lk(m_mutex);
-                            m_cond.wait(lk, [this]() { return m_stopped || !m_tasks.empty(); });
-                            // Don't stop until the queue is empty
-                            if (!m_tasks.empty()) {
-                                auto task = std::move(m_tasks.front());
-                                m_tasks.pop_front();
-                                lk.unlock();
-                                task();
-                            } else if (m_stopped) {
-                                break;
-                            }
-                        }
+                        WorkerLoop(workerIndex);
                     }
                 });
             }
 
-            _Requires_lock_not_held_(m_mutex) void DisallowSubmit() {
-                std::lock_guard guard(m_mutex);
-                m_allowSubmit = false;
+            _Requires_lock_not_held_(m_injectionMutex) void DisallowSubmit() {
+                std::lock_guard guard(m_injectionMutex);
+                m_allowSubmit.store(false, std::memory_order_release);
             }
 
-            _Requires_lock_not_held_(m_mutex) void JoinAllThreads() {
+            _Requires_lock_not_held_(m_injectionMutex) _Requires_lock_not_held_(m_parkMutex) void JoinAllThreads() {
                 {
-                    std::lock_guard guard(m_mutex);
-                    m_stopped = true;
+                    std::lock_guard guard(m_parkMutex);
+                    m_stopped.store(true, std::memory_order_release);
                 }
-                m_cond.notify_all();
+                m_parkCondition.notify_all();
 
                 for (;;) {
-                    std::unique_lock lk(m_mutex);
+                    std::unique_lock lk(m_injectionMutex);
                     if (m_threads.empty()) {
                         break;
                     }
@@ -127,16 +355,623 @@ namespace sample {
                 }
             }
 
+            // Keeps executing pool tasks on the calling thread while the predicate returns true.
+            // Waiting this way instead of blocking prevents deadlocks when a task waits for other tasks. When there is nothing to
+            // help with, the thread parks until more work arrives or NotifyWaiters is called, so the predicate must only change
+            // from true to false before a call to NotifyWaiters.
+            template <typename Predicate>
+            void HelpWhile(Predicate&& predicate) {
+                uint32_t idleRounds = 0;
+                while (predicate()) {
+                    if (Task* task = FindWork()) {
+                        Execute(task);
+                        idleRounds = 0;
+                    } else if (idleRounds < SpinRounds + YieldRounds) {
+                        SpinWait(idleRounds++);
+                    } else {
+                        ParkWaiter(predicate);
+                        idleRounds = 0;
+                    }
+                }
+            }
+
+            // Wakes the threads parked in HelpWhile, so that they evaluate their predicate again.
+            _Requires_lock_not_held_(m_parkMutex) void NotifyWaiters() {
+                // Pairs with the fence in ParkWaiter: either the waiter sees its predicate change, or this sees the waiter.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_waitingCount.load(std::memory_order_relaxed) > 0) {
+                    {
+                        std::lock_guard guard(m_parkMutex);
+                        m_parkEpoch.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    m_waitCondition.notify_all();
+                }
+            }
+
+            // Allocates enough task nodes that up to taskCount queued or running tasks never need more. Nodes held in the
+            // workers' free lists are accounted for, so this holds however the nodes end up spread between the threads.
+            _Requires_lock_not_held_(m_injectionMutex) void ReserveTasks(size_t taskCount) {
+                const size_t requiredCount = taskCount + m_workers.size() * MaxLocalFreeTasks + FreeTaskBatchSize;
+                std::lock_guard guard(m_injectionMutex);
+                m_taskBlocks.reserve((requiredCount + TaskBlockSize - 1) / TaskBlockSize);
+                while (m_taskBlocks.size() * TaskBlockSize < requiredCount) {
+                    AddTaskBlock();
+                }
+            }
+
+            // Returns the first exception thrown by a task given to SubmitUnique or SubmitBatch, and clears it.
+            _Requires_lock_not_held_(m_exceptionMutex) std::exception_ptr TakeUnhandledException() {
+                std::lock_guard guard(m_exceptionMutex);
+                return std::exchange(m_unhandledException, nullptr);
+            }
+
         private:
+            struct Worker {
+                WorkStealingDeque Deque;
+                // Recycled task nodes, only accessed by the owning worker thread.
+                Task* FreeTasks{nullptr};
+                size_t FreeTaskCount{0};
+            };
+
+            struct WorkerContext {
+                const SharedState* State{nullptr};
+                size_t Index{0};
+                uint32_t RandomState{0};
+            };
+
+            static WorkerContext& CurrentWorker() {
+                static thread_local WorkerContext context;
+                return context;
+            }
+
+            bool IsCurrentThreadWorker() const {
+                return CurrentWorker().State == this;
+            }
+
+            static uint32_t NextRandom(WorkerContext& context) {
+                // xorshift32
+                uint32_t x = context.RandomState != 0 ? context.RandomState
+                                                      : static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1;
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                context.RandomState = x;
+                return x;
+            }
+
+            // Task nodes are allocated in blocks and are only freed with the SharedState. Workers keep a private free list and
+            // exchange batches of nodes with the shared free list, so in steady state neither submitting nor executing a task
+            // allocates memory, and the injection lock is taken once per batch by the workers.
+            Task* AcquireLocalTask(UniqueFunction func) {
+                Worker& worker = *m_workers[CurrentWorker().Index];
+                if (worker.FreeTasks == nullptr) {
+                    std::lock_guard guard(m_injectionMutex);
+                    for (size_t i = 0; i < FreeTaskBatchSize; i++) {
+                        Task* task = PopSharedFreeTask();
+                        task->Next = std::exchange(worker.FreeTasks, task);
+                    }
+                    worker.FreeTaskCount += FreeTaskBatchSize;
+                }
+
+                Task* task = std::exchange(worker.FreeTasks, worker.FreeTasks->Next);
+                worker.FreeTaskCount--;
+                task->Next = nullptr;
+                task->Func = std::move(func);
+                return task;
+            }
+
+            _Requires_lock_held_(m_injectionMutex) Task* AcquireSharedTask(UniqueFunction func) {
+                Task* task = PopSharedFreeTask();
+                task->Func = std::move(func);
+                return task;
+            }
+
+            _Requires_lock_held_(m_injectionMutex) void AddTaskBlock() {
+                auto block = std::make_unique<Task[]>(TaskBlockSize);
+                for (size_t i = 0; i < TaskBlockSize; i++) {
+                    block[i].Next = std::exchange(m_freeTasks, &block[i]);
+                }
+                m_taskBlocks.push_back(std::move(block));
+            }
+
+            _Requires_lock_held_(m_injectionMutex) Task* PopSharedFreeTask() {
+                if (m_freeTasks == nullptr) {
+                    AddTaskBlock();
+                }
+                Task* task = std::exchange(m_freeTasks, m_freeTasks->Next);
+                task->Next = nullptr;
+                return task;
+            }
+
+            _Requires_lock_not_held_(m_injectionMutex) void ReleaseTask(Task* task) {
+                task->Func.Reset(); // Release the captures now rather than when the node is reused.
+
+                WorkerContext& context = CurrentWorker();
+                if (context.State != this) {
+                    std::lock_guard guard(m_injectionMutex);
+                    task->Next = std::exchange(m_freeTasks, task);
+                    return;
+                }
+
+                Worker& worker = *m_workers[context.Index];
+                task->Next = std::exchange(worker.FreeTasks, task);
+                if (++worker.FreeTaskCount > MaxLocalFreeTasks) {
+                    // Workers that mostly execute tasks submitted by other threads hand the surplus back.
+                    std::lock_guard guard(m_injectionMutex);
+                    for (size_t i = 0; i < FreeTaskBatchSize; i++) {
+                        Task* surplus = std::exchange(worker.FreeTasks, worker.FreeTasks->Next);
+                        surplus->Next = std::exchange(m_freeTasks, surplus);
+                    }
+                    worker.FreeTaskCount -= FreeTaskBatchSize;
+                }
+            }
+
+            void PushLocal(Task* task) {
+                m_workers[CurrentWorker().Index]->Deque.Push(task);
+            }
+
+            _Requires_lock_held_(m_injectionMutex) void PushInjected(Task* task) {
+                if (m_injectedTail != nullptr) {
+                    m_injectedTail->Next = task;
+                } else {
+                    m_injectedHead = task;
+                }
+                m_injectedTail = task;
+                m_injectedCount.fetch_add(1, std::memory_order_release);
+            }
+
+            _Requires_lock_not_held_(m_injectionMutex) Task* PopInjected() {
+                if (m_injectedCount.load(std::memory_order_acquire) == 0) {
+                    return nullptr;
+                }
+                std::lock_guard guard(m_injectionMutex);
+                if (m_injectedHead == nullptr) {
+                    return nullptr;
+                }
+                Task* task = std::exchange(m_injectedHead, m_injectedHead->Next);
+                if (m_injectedHead == nullptr) {
+                    m_injectedTail = nullptr;
+                }
+                task->Next = nullptr;
+                m_injectedCount.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+
+            Task* FindWork() {
+                WorkerContext& context = CurrentWorker();
+                const bool isWorker = context.State == this;
+                if (isWorker) {
+                    if (Task* task = m_workers[context.Index]->Deque.Pop()) {
+                        return task;
+                    }
+                }
+
+                if (Task* task = PopInjected()) {
+                    return task;
+                }
+
+                const size_t workerCount = m_workers.size();
+                const size_t firstVictim = NextRandom(context) % workerCount;
+                for (size_t i = 0; i < workerCount; i++) {
+                    const size_t victim = (firstVictim + i) % workerCount;
+                    if (isWorker && victim == context.Index) {
+                        continue;
+                    }
+                    if (Task* task = m_workers[victim]->Deque.Steal()) {
+                        return task;
+                    }
+                }
+                return nullptr;
+            }
+
+            // Tasks spawned by task groups and futures store their own exceptions. The exception of a submitted task is kept for
+            // TakeUnhandledException, since the thread running it may be a worker or a thread helping while it waits for
+            // unrelated work, and neither should see it.
+            _Requires_lock_not_held_(m_exceptionMutex) void Execute(Task* task) {
+                try {
+                    task->Func();
+                } catch (...) {
+                    std::lock_guard guard(m_exceptionMutex);
+                    if (!m_unhandledException) {
+                        m_unhandledException = std::current_exception();
+                    }
+                }
+                ReleaseTask(task);
+            }
+
+            static void CpuPause() {
+#if defined(_WIN32)
+                YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+                __builtin_ia32_pause();
+#endif
+            }
+
+            static void SpinWait(uint32_t idleRounds) {
+                if (idleRounds < SpinRounds) {
+                    for (uint32_t i = 0; i < (1u << std::min<uint32_t>(idleRounds, 6)); i++) {
+                        CpuPause();
+                    }
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+
+            _Requires_lock_not_held_(m_parkMutex) void NotifyWorkAvailable(size_t taskCount) {
+                // Pairs with the fences in Park and ParkWaiter: either the parking thread sees the new task, or this sees it.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (taskCount == 0) {
+                    return;
+                }
+                const bool workersSleeping = m_sleepingCount.load(std::memory_order_relaxed) > 0;
+                const bool waitersParked = m_waitingCount.load(std::memory_order_relaxed) > 0;
+                if (workersSleeping || waitersParked) {
+                    {
+                        std::lock_guard guard(m_parkMutex);
+                        m_parkEpoch.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    if (workersSleeping) {
+                        if (taskCount == 1) {
+                            m_parkCondition.notify_one();
+                        } else {
+                            m_parkCondition.notify_all();
+                        }
+                    }
+                    if (waitersParked) {
+                        m_waitCondition.notify_all();
+                    }
+                }
+            }
+
+            _Requires_lock_not_held_(m_parkMutex) void Park() {
+                std::unique_lock lk(m_parkMutex);
+                const uint64_t epoch = m_parkEpoch.load(std::memory_order_relaxed);
+                m_sleepingCount.fetch_add(1, std::memory_order_relaxed);
+                lk.unlock();
+
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!m_stopped.load(std::memory_order_acquire) && !HasVisibleWork()) {
+                    lk.lock();
+                    m_parkCondition.wait(lk, [&] {
+                        return m_stopped.load(std::memory_order_relaxed) || m_parkEpoch.load(std::memory_order_relaxed) != epoch;
+                    });
+                    lk.unlock();
+                }
+                m_sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            template <typename Predicate>
+            _Requires_lock_not_held_(m_parkMutex) void ParkWaiter(Predicate& predicate) {
+                std::unique_lock lk(m_parkMutex);
+                const uint64_t epoch = m_parkEpoch.load(std::memory_order_relaxed);
+                m_waitingCount.fetch_add(1, std::memory_order_relaxed);
+                lk.unlock();
+
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (predicate() && !HasVisibleWork()) {
+                    lk.lock();
+                    m_waitCondition.wait(lk, [&] { return m_parkEpoch.load(std::memory_order_relaxed) != epoch; });
+                    lk.unlock();
+                }
+                m_waitingCount.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            bool HasVisibleWork() const {
+                if (m_injectedCount.load(std::memory_order_acquire) > 0) {
+                    return true;
+                }
+                for (const auto& worker : m_workers) {
+                    if (!worker->Deque.Empty()) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void WorkerLoop(size_t workerIndex) {
+                WorkerContext& context = CurrentWorker();
+                context.State = this;
+                context.Index = workerIndex;
+
+                uint32_t idleRounds = 0;
+                for (;;) {
+                    if (Task* task = FindWork()) {
+                        Execute(task);
+                        idleRounds = 0;
+                    } else if (m_stopped.load(std::memory_order_acquire)) {
+                        break; // Don't stop until the queues are empty
+                    } else if (idleRounds < SpinRounds + YieldRounds) {
+                        SpinWait(idleRounds++);
+                    } else {
+                        Park();
+                        idleRounds = 0;
+                    }
+                }
+
+                context = {};
+            }
+
+            static constexpr uint32_t SpinRounds = 16;  // Rounds of busy spinning with exponential backoff.
+            static constexpr uint32_t YieldRounds = 16; // Rounds of yielding the time slice before parking the thread.
+
+            static constexpr size_t TaskBlockSize = 64;      // Task nodes allocated at once when the free lists are empty.
+            static constexpr size_t FreeTaskBatchSize = 32;  // Task nodes moved between a worker and the shared free list at once.
+            static constexpr size_t MaxLocalFreeTasks = 128; // Task nodes a worker keeps before returning a batch.
+
             std::vector<std::thread> m_threads;
-            std::deque<UniqueFunction> m_tasks;
-            std::condition_variable m_cond;
+            std::vector<std::unique_ptr<Worker>> m_workers;
+
+            // Guards the injection queue, the shared free list and the task blocks.
+            std::mutex m_injectionMutex;
+            Task* m_injectedHead{nullptr};
+            Task* m_injectedTail{nullptr};
+            std::atomic<size_t> m_injectedCount{0};
+            std::atomic<bool> m_allowSubmit{true};
+            Task* m_freeTasks{nullptr};
+            std::vector<std::unique_ptr<Task[]>> m_taskBlocks;
+
+            std::mutex m_parkMutex;
+            std::condition_variable m_parkCondition;
+            std::atomic<uint64_t> m_parkEpoch{0};
+            std::atomic<uint32_t> m_sleepingCount{0};
+            std::atomic<bool> m_stopped{false};
+
+            // Threads parked in HelpWhile, waiting on m_waitCondition with m_parkMutex.
+            std::condition_variable m_waitCondition;
+            std::atomic<uint32_t> m_waitingCount{0};
+
+            std::mutex m_exceptionMutex;
+            std::exception_ptr m_unhandledException;
+        };
+
+        template <typename T>
+        struct FutureState : std::enable_shared_from_this<FutureState<T>> {
+            struct Empty {};
+            using Value = std::conditional_t<std::is_void_v<T>, Empty, T>;
+
+            explicit FutureState(std::shared_ptr<SharedState> pool)
+                : Pool(std::move(pool)) {
+            }
+
+            // Invokes the function and stores its result or exception.
+            template <typename F, typename... Args>
+            void Run(F& func, Args&&... args) noexcept {
+                try {
+                    if constexpr (std::is_void_v<T>) {
+                        func(std::forward<Args>(args)...);
+                        SetValue(Empty{});
+                    } else {
+                        SetValue(func(std::forward<Args>(args)...));
+                    }
+                } catch (...) {
+                    SetException(std::current_exception());
+                }
+            }
+
+            _Requires_lock_not_held_(m_mutex) void SetValue(Value value) {
+                std::unique_lock lk(m_mutex);
+                m_value.emplace(std::move(value));
+                Complete(std::move(lk));
+            }
+
+            _Requires_lock_not_held_(m_mutex) void SetException(std::exception_ptr exception) {
+                std::unique_lock lk(m_mutex);
+                m_exception = std::move(exception);
+                Complete(std::move(lk));
+            }
+
+            // The continuation is invoked on the thread that completes the future, or immediately if it is already completed.
+            _Requires_lock_not_held_(m_mutex) void SetContinuation(UniqueFunction continuation) {
+                {
+                    std::lock_guard guard(m_mutex);
+                    if (!m_ready.load(std::memory_order_relaxed)) {
+                        m_continuation.emplace(std::move(continuation));
+                        return;
+                    }
+                }
+                continuation();
+            }
+
+            bool IsReady() const {
+                return m_ready.load(std::memory_order_acquire);
+            }
+
+            void Wait() {
+                Pool->HelpWhile([this] { return !IsReady(); });
+            }
+
+            // Must only be called once the future is ready.
+            _Requires_lock_not_held_(m_mutex) Value TakeValue() {
+                std::lock_guard guard(m_mutex);
+                if (m_exception) {
+                    std::rethrow_exception(m_exception);
+                }
+                return std::move(m_value.value());
+            }
+
+            _Requires_lock_not_held_(m_mutex) std::exception_ptr Exception() {
+                std::lock_guard guard(m_mutex);
+                return m_exception;
+            }
+
+            const std::shared_ptr<SharedState> Pool;
+
+        private:
+            void Complete(std::unique_lock<std::mutex> lk) {
+                m_ready.store(true, std::memory_order_release);
+                std::optional<UniqueFunction> continuation = std::move(m_continuation);
+                m_continuation.reset();
+                lk.unlock();
+                Pool->NotifyWaiters();
+                if (continuation) {
+                    (*continuation)();
+                }
+            }
+
             std::mutex m_mutex;
-            bool m_allowSubmit{true};
-            bool m_stopped{false};
+            std::atomic<bool> m_ready{false};
+            std::optional<Value> m_value;
+            std::exception_ptr m_exception;
+            std::optional<UniqueFunction> m_continuation;
+        };
+
+        // The result type of a continuation function taking the value of a Future<T>.
+        template <typename T, typename F>
+        struct ContinuationResult {
+            using type = std::invoke_result_t<F&, T&&>;
+        };
+        template <typename F>
+        struct ContinuationResult<void, F> {
+            using type = std::invoke_result_t<F&>;
         };
 
     public:
+        // The result of a task started with ThreadPool::Async.
+        // Waiting for a future executes other pool tasks on the waiting thread instead of blocking it.
+        template <typename T>
+        class Future {
+        public:
+            Future() noexcept = default;
+            Future(Future&&) noexcept = default;
+            Future& operator=(Future&&) noexcept = default;
+            Future(const Future&) = delete;
+            Future& operator=(const Future&) = delete;
+
+            // Returns false for a default constructed future, or after Get or Then was called.
+            bool Valid() const noexcept {
+                return m_state != nullptr;
+            }
+
+            bool IsReady() const {
+                return ThrowIfInvalid()->IsReady();
+            }
+
+            void Wait() const {
+                ThrowIfInvalid()->Wait();
+            }
+
+            // Waits for the task and returns its result, or rethrows the exception it threw. Invalidates the future.
+            T Get() {
+                ThrowIfInvalid();
+                const std::shared_ptr<FutureState<T>> state = std::move(m_state);
+                state->Wait();
+                if constexpr (std::is_void_v<T>) {
+                    state->TakeValue();
+                } else {
+                    return state->TakeValue();
+                }
+            }
+
+            // Schedules func to run on the pool with the result of this future once it's ready. Invalidates this future.
+            // If this future completes with an exception, func is skipped and the exception propagates to the returned future.
+            template <typename F>
+            auto Then(F func) {
+                using R = typename ContinuationResult<T, F>::type;
+                const std::shared_ptr<FutureState<T>> antecedent = std::move(ThrowIfInvalid());
+                auto next = std::make_shared<FutureState<R>>(antecedent->Pool);
+
+                // The continuation is stored in the antecedent, so it only holds a raw pointer to avoid a reference cycle.
+                FutureState<T>* antecedentPtr = antecedent.get();
+                antecedent->SetContinuation(UniqueFunction([antecedentPtr, next, func = std::move(func)]() mutable {
+                    auto antecedent = antecedentPtr->shared_from_this();
+                    antecedent->Pool->Spawn(UniqueFunction([antecedent, next, func = std::move(func)]() mutable {
+                        if (std::exception_ptr exception = antecedent->Exception()) {
+                            next->SetException(std::move(exception));
+                        } else if constexpr (std::is_void_v<T>) {
+                            next->Run(func);
+                        } else {
+                            next->Run(func, antecedent->TakeValue());
+                        }
+                    }));
+                }));
+
+                return Future<R>(std::move(next));
+            }
+
+        private:
+            friend class ThreadPool;
+            template <typename>
+            friend class Future;
+
+            explicit Future(std::shared_ptr<FutureState<T>> state) noexcept
+                : m_state(std::move(state)) {
+            }
+
+            std::shared_ptr<FutureState<T>>& ThrowIfInvalid() {
+                if (m_state == nullptr) {
+                    throw std::future_error(std::future_errc::no_state);
+                }
+                return m_state;
+            }
+            const std::shared_ptr<FutureState<T>>& ThrowIfInvalid() const {
+                if (m_state == nullptr) {
+                    throw std::future_error(std::future_errc::no_state);
+                }
+                return m_state;
+            }
+
+            std::shared_ptr<FutureState<T>> m_state;
+        };
+
+        // Runs a set of tasks on the pool and waits for all of them to complete.
+        // The first exception thrown by any of the tasks is rethrown from Wait.
+        class TaskGroup {
+        public:
+            explicit TaskGroup(ThreadPool& pool)
+                : m_pool(pool.ThrowIfNoState()) {
+            }
+
+            // The destructor waits for all tasks in the group and discards their exceptions.
+            ~TaskGroup() {
+                m_pool->HelpWhile([this] { return m_pendingCount.load(std::memory_order_acquire) != 0; });
+            }
+
+            TaskGroup(const TaskGroup&) = delete;
+            TaskGroup& operator=(const TaskGroup&) = delete;
+
+            template <typename F>
+            void Run(F func) {
+                m_pendingCount.fetch_add(1, std::memory_order_relaxed);
+                m_pool->Spawn(UniqueFunction([this, func = std::move(func)]() mutable {
+                    try {
+                        // Destroy the function before signaling completion, since its captures may reference the waiting thread.
+                        F localFunc = std::move(func);
+                        localFunc();
+                    } catch (...) {
+                        std::lock_guard guard(m_exceptionMutex);
+                        if (!m_exception) {
+                            m_exception = std::current_exception();
+                        }
+                    }
+                    // The waiting thread may destroy the group as soon as the count drops to zero, so don't use this afterwards.
+                    SharedState* const pool = m_pool.get();
+                    if (m_pendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        pool->NotifyWaiters();
+                    }
+                }));
+            }
+
+            // Waits for all tasks of the group, executing pool tasks on the calling thread in the meanwhile.
+            void Wait() {
+                m_pool->HelpWhile([this] { return m_pendingCount.load(std::memory_order_acquire) != 0; });
+
+                std::exception_ptr exception;
+                {
+                    std::lock_guard guard(m_exceptionMutex);
+                    exception = std::exchange(m_exception, nullptr);
+                }
+                if (exception) {
+                    std::rethrow_exception(exception);
+                }
+            }
+
+        private:
+            const std::shared_ptr<SharedState> m_pool;
+            std::atomic<size_t> m_pendingCount{0};
+            std::mutex m_exceptionMutex;
+            std::exception_ptr m_exception;
+        };
+
         // A default constructed ThreadPool does not have a shared state.
         // Most methods will throw an exception if called with a default constructed ThreadPool.
         ThreadPool() noexcept = default;
@@ -151,11 +986,15 @@ namespace sample {
             }
         }
 
-        // The destructor will wait for all tasks to complete.
+        // The destructor will wait for all tasks to complete. An exception of a submitted task that nobody took with
+        // TakeUnhandledException or StopAndWait terminates the process then, as it would have on the worker.
         ~ThreadPool() {
             if (m_state) {
                 m_state->DisallowSubmit();
                 m_state->JoinAllThreads();
+                if (m_state->TakeUnhandledException()) {
+                    std::terminate();
+                }
             }
         }
 
@@ -164,23 +1003,106 @@ namespace sample {
         ThreadPool(const ThreadPool&) = delete;
         ThreadPool& operator=(const ThreadPool&) = delete;
 
+        // Schedules func on the pool. Returns false if the pool stopped accepting tasks.
+        // An exception thrown by func is kept for TakeUnhandledException.
         template <typename F>
         bool Submit(F func) {
-            if (m_state == nullptr) {
-                throw std::system_error(std::make_error_code(std::errc::operation_not_permitted));
-            }
-            return m_state->SubmitUnique(std::move(func));
+            return ThrowIfNoState()->SubmitUnique(std::move(func));
         }
         bool Submit(std::function<void()>) = delete;
         bool Submit(std::nullptr_t) = delete;
 
-        // Stops the thread pool from accepting more tasks and then waits for all queued tasks to complete.
-        void StopAndWait() {
-            if (m_state == nullptr) {
-                throw std::system_error(std::make_error_code(std::errc::operation_not_permitted));
+        // Submits all functions in [first, last), moving them out of the range. Returns false if the pool stopped accepting tasks.
+        // Cheaper than submitting the functions one at a time from outside of the pool, since the queue is locked only once.
+        template <typename Iterator>
+        bool SubmitBatch(Iterator first, Iterator last) {
+            return ThrowIfNoState()->SubmitBatch(first, last);
+        }
+
+        // Runs func on the pool and returns a future for its result.
+        // Throws std::system_error if the pool no longer accepts tasks.
+        template <typename F>
+        Future<std::invoke_result_t<F&>> Async(F func) {
+            using R = std::invoke_result_t<F&>;
+            auto state = std::make_shared<FutureState<R>>(ThrowIfNoState());
+            if (!m_state->SubmitUnique([state, func = std::move(func)]() mutable { state->Run(func); })) {
+                throw std::system_error(std::make_error_code(std::errc::operation_canceled));
             }
+            return Future<R>(std::move(state));
+        }
+
+        // Invokes body(i) for each i in [begin, end) on the pool and waits for completion. The calling thread participates.
+        // The range is split recursively until a chunk has at most grainSize iterations, and idle workers steal the larger halves.
+        // A grainSize of 0 picks a chunk size that gives each worker a few chunks.
+        template <typename F>
+        void ParallelFor(size_t begin, size_t end, F&& body, size_t grainSize = 0) {
+            if (begin >= end) {
+                return;
+            }
+            grainSize = grainSize == 0 ? DefaultGrainSize(end - begin) : grainSize;
+            TaskGroup group(*this);
+            ParallelForRange(group, begin, end, grainSize, body);
+            group.Wait();
+        }
+
+        // Computes reduce(...reduce(reduce(identity, map(begin)), map(begin + 1))..., map(end - 1)) in parallel.
+        // Iterations are reduced within chunks of grainSize on the pool, and the chunk results are then reduced in order,
+        // so the result is deterministic as long as reduce is associative.
+        template <typename T, typename Map, typename Reduce>
+        T ParallelReduce(size_t begin, size_t end, T identity, Map&& map, Reduce&& reduce, size_t grainSize = 0) {
+            if (begin >= end) {
+                return identity;
+            }
+            grainSize = grainSize == 0 ? DefaultGrainSize(end - begin) : grainSize;
+            const size_t chunkCount = (end - begin + grainSize - 1) / grainSize;
+            std::vector<T> partials(chunkCount, identity);
+            ParallelFor(
+                0,
+                chunkCount,
+                [&](size_t chunk) {
+                    const size_t chunkBegin = begin + chunk * grainSize;
+                    const size_t chunkEnd = std::min(end, chunkBegin + grainSize);
+                    T value = std::move(partials[chunk]);
+                    for (size_t i = chunkBegin; i < chunkEnd; i++) {
+                        value = reduce(std::move(value), map(i));
+                    }
+                    partials[chunk] = std::move(value);
+                },
+                1);
+
+            T result = std::move(partials[0]);
+            for (size_t chunk = 1; chunk < chunkCount; chunk++) {
+                result = reduce(std::move(result), std::move(partials[chunk]));
+            }
+            return result;
+        }
+
+        // Stops the thread pool from accepting more tasks and then waits for all queued tasks to complete. Rethrows the
+        // exception of a submitted task that nobody took with TakeUnhandledException.
+        void StopAndWait() {
+            ThrowIfNoState();
             m_state->DisallowSubmit();
             m_state->JoinAllThreads();
+            if (std::exception_ptr exception = m_state->TakeUnhandledException()) {
+                std::rethrow_exception(exception);
+            }
+        }
+
+        size_t ThreadCount() const {
+            return ThrowIfNoState()->WorkerCount();
+        }
+
+        // Allocates task nodes up front, so that having up to taskCount tasks queued or running at once never allocates them.
+        // Without it, the pool grows its nodes as needed and reaches the same steady state after a while.
+        void ReserveTasks(size_t taskCount) {
+            ThrowIfNoState()->ReserveTasks(taskCount);
+        }
+
+        // Returns the first exception thrown by a task given to Submit or SubmitBatch since the last call, or null if none threw.
+        // Such exceptions are caught by the pool, so they never escape a worker or a thread waiting for a Future or a TaskGroup.
+        // Owners poll it, since an exception left here is rethrown by StopAndWait or terminates the process in the destructor.
+        std::exception_ptr TakeUnhandledException() {
+            return ThrowIfNoState()->TakeUnhandledException();
         }
 
         // Returns true if the ThreadPool has an associated shared state.
@@ -190,6 +1112,30 @@ namespace sample {
         }
 
     private:
+        const std::shared_ptr<SharedState>& ThrowIfNoState() const {
+            if (m_state == nullptr) {
+                throw std::system_error(std::make_error_code(std::errc::operation_not_permitted));
+            }
+            return m_state;
+        }
+
+        size_t DefaultGrainSize(size_t count) const {
+            return std::max<size_t>(1, count / (ThreadCount() * 8));
+        }
+
+        template <typename F>
+        static void ParallelForRange(TaskGroup& group, size_t begin, size_t end, size_t grainSize, F& body) {
+            // Hand off the upper half until the remaining range is small enough, then run it on this thread.
+            while (end - begin > grainSize) {
+                const size_t middle = begin + (end - begin) / 2;
+                group.Run([&group, middle, end, grainSize, &body]() { ParallelForRange(group, middle, end, grainSize, body); });
+                end = middle;
+            }
+            for (size_t i = begin; i < end; i++) {
+                body(i);
+            }
+        }
+
         std::shared_ptr<SharedState> m_state;
     };
 } // namespace sample
@@ -15,6 +15,8 @@
 //*********************************************************
 #pragma once
 
+#include <SampleShared/FrameArena.h>
+
 namespace engine {
     struct QuadLayerObject;
     class ProjectionLayer;
@@ -23,22 +25,27 @@ namespace engine {
     void AppendQuadLayer(CompositionLayers& layers, QuadLayerObject* quad);
     void AppendProjectionLayer(CompositionLayers& layers, ProjectionLayer* layer, XrViewConfigurationType type);
 
+    // The layer structures are allocated from the frame arena, so they keep a stable address until the arena is reset after xrEndFrame.
     class CompositionLayers {
     public:
+        explicit CompositionLayers(sample::FrameArena& frameArena)
+            : m_frameArena(frameArena)
+            , m_compositionLayers(frameArena) {
+        }
 
         XrCompositionLayerQuad& AddQuadLayer() {
-            XrCompositionLayerQuad& quadLayer = m_quadLayers.emplace_back();
+            XrCompositionLayerQuad& quadLayer = *m_frameArena.New<XrCompositionLayerQuad>();
             quadLayer.type = XR_TYPE_COMPOSITION_LAYER_QUAD;
             m_compositionLayers.push_back(reinterpret_cast<const XrCompositionLayerBaseHeader*>(&quadLayer));
-            return m_quadLayers.back();
+            return quadLayer;
         }
 
         XrCompositionLayerProjection& AddProjectionLayer(XrCompositionLayerFlags layerFlags) {
-            XrCompositionLayerProjection& projectionLayer = m_projectionLayers.emplace_back();
+            XrCompositionLayerProjection& projectionLayer = *m_frameArena.New<XrCompositionLayerProjection>();
             projectionLayer.type = XR_TYPE_COMPOSITION_LAYER_PROJECTION;
             projectionLayer.layerFlags = layerFlags;
             m_compositionLayers.push_back(reinterpret_cast<const XrCompositionLayerBaseHeader*>(&projectionLayer));
-            return m_projectionLayers.back();
+            return projectionLayer;
         }
 
         uint32_t LayerCount() const {
@@ -50,9 +57,8 @@ namespace engine {
         }
 
     private:
-        std::list<XrCompositionLayerQuad> m_quadLayers;
-        std::list<XrCompositionLayerProjection> m_projectionLayers;
-        std::vector<XrCompositionLayerBaseHeader const*> m_compositionLayers;
+        sample::FrameArena& m_frameArena;
+        sample::FrameVector<XrCompositionLayerBaseHeader const*> m_compositionLayers;
     };
 } // namespace engine
 
@@ -16,11 +16,16 @@
 #pragma once
 
 #include <pbr/PbrResources.h>
+#include <pbr/PbrUploadQueue.h>
+#include <pbr/PbrTextureResidency.h>
 #include <XrUtility/XrString.h>
 #include <XrUtility/XrInstanceContext.h>
 #include <XrUtility/XrExtensionContext.h>
 #include <XrUtility/XrSystemContext.h>
 #include <XrUtility/XrSessionContext.h>
+#include <XrUtility/XrMath.h>
+#include "SpaceLocator.h"
+#include "HandTracking.h"
 
 namespace engine {
 
@@ -39,6 +44,7 @@ namespace engine {
             , System(std::move(system))
             , Session(std::move(session))
             , SceneSpace(sceneSpace)
+            , Hands(Extensions, System, Session.Handle, SceneSpace)
             , PbrResources(std::move(pbrResources))
             , Device(std::move(device))
             , DeviceContext(std::move(deviceContext))
@@ -53,12 +59,26 @@ namespace engine {
 
         const XrSpace SceneSpace;
 
+        // Locates the spaces of all objects once per frame, see SpaceLocator.
+        SpaceLocator Spaces;
+
+        // Locates both hands once per frame for all scenes that subscribe, see HandTracking.
+        HandTracking Hands;
+
         const winrt::com_ptr<ID3D11DeviceContext> DeviceContext;
         const winrt::com_ptr<ID3D11Device> Device;
         Pbr::Resources PbrResources;
 
+        // Creates the GPU resources of models loading in the background, within XrAppConfiguration::UploadBudget each frame.
+        // The statistics of the most recent frame are the upload cost of that frame.
+        Pbr::UploadQueue UploadQueue;
+
         std::atomic<XrSessionState> SessionState;
 
+        // How far the view being rendered moved since the update thread posed head-locked objects, when the view poses are
+        // late-latched. Identity otherwise. Only used on the render thread, see ProjectionLayerConfig::LateLatchViews.
+        XrPosef HeadLockedCorrection{xr::math::Pose::Identity()};
+
         const XrPath RightHand;
         const XrPath LeftHand;
     };
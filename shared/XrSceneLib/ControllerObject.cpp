@@ -16,6 +16,7 @@
 
 #include "pch.h"
 #include <Pbr/GltfLoader.h>
+#include <SampleShared/AllocationProfiler.h>
 #include <SampleShared/Trace.h>
 #include "PbrModelObject.h"
 #include "ControllerObject.h"
@@ -29,6 +30,7 @@ namespace {
     struct ControllerModel {
         XrControllerModelKeyMSFT Key = 0;
         std::shared_ptr<Pbr::Model> PbrModel;
+        std::shared_ptr<Pbr::UploadBatch> UploadBatch;
         std::vector<Pbr::NodeIndex_t> NodeIndices;
         std::vector<XrControllerModelNodePropertiesMSFT> NodeProperties;
         std::vector<XrControllerModelNodeStateMSFT> NodeStates;
@@ -44,7 +46,11 @@ namespace {
         auto modelBuffer = std::make_unique<byte[]>(bufferSize);
         CHECK_XRCMD(context.Extensions.xrLoadControllerModelMSFT(
             context.Session.Handle, modelKey, bufferSize, &bufferSize, modelBuffer.get()));
-        model->PbrModel = Gltf::FromGltfBinary(context.PbrResources, modelBuffer.get(), bufferSize);
+
+        // The model shows as soon as its geometry is uploaded, ahead of other models loading.
+        model->UploadBatch = context.UploadQueue.CreateBatch(Pbr::UploadPriority::High);
+        model->PbrModel =
+            Gltf::FromGltfBinary(context.PbrResources, modelBuffer.get(), bufferSize, context.UploadQueue, model->UploadBatch);
 
         // Read the controller model properties with two call idiom
         XrControllerModelPropertiesMSFT properties{XR_TYPE_CONTROLLER_MODEL_PROPERTIES_MSFT};
@@ -94,20 +100,22 @@ namespace {
     }
 
     struct ControllerObject : engine::PbrModelObject {
-        ControllerObject(engine::Context& context, XrPath controllerUserPath);
+        ControllerObject(engine::Context& context, XrPath controllerUserPath, bool materialAtlas);
         ~ControllerObject();
 
         void Update(engine::Context& context, const engine::FrameTime& frameTime) override;
 
     private:
         const XrPath m_controllerUserPath;
+        const bool m_materialAtlas;
 
         std::unique_ptr<ControllerModel> m_model;
         std::future<std::unique_ptr<ControllerModel>> m_modelLoadingTask;
     };
 
-    ControllerObject::ControllerObject(engine::Context& context, XrPath controllerUserPath)
-        : m_controllerUserPath(controllerUserPath) {
+    ControllerObject::ControllerObject(engine::Context& context, XrPath controllerUserPath, bool materialAtlas)
+        : m_controllerUserPath(controllerUserPath)
+        , m_materialAtlas(materialAtlas) {
     }
 
     ControllerObject::~ControllerObject() {
@@ -115,6 +123,10 @@ namespace {
         if (m_modelLoadingTask.valid()) {
             m_modelLoadingTask.wait();
         }
+
+        if (m_model) {
+            m_model->UploadBatch->Cancel();
+        }
     }
 
     void ControllerObject::Update(engine::Context& context, const engine::FrameTime& frameTime) {
@@ -127,6 +139,7 @@ namespace {
         if (modelKeyValid && (m_model == nullptr || m_model->Key != controllerModelKeyState.modelKey)) {
             // Avoid two background tasks running together. The new one will start in future update after the old one is finished.
             if (!m_modelLoadingTask.valid()) {
+                sample::allocation::AllowAllocationsScope allowAllocations; // Starting the load is expected to allocate.
                 m_modelLoadingTask =
                     std::async(std::launch::async, [&, modelKey = controllerModelKeyState.modelKey]() {
                         return LoadControllerModel(context, modelKey);
@@ -136,13 +149,21 @@ namespace {
 
         // If controller model loading task is completed, get the result model and apply it to rendering.
         if (m_modelLoadingTask.valid() && m_modelLoadingTask.wait_for(0s) == std::future_status::ready) {
+            sample::allocation::AllowAllocationsScope allowAllocations; // Replacing the model releases the previous one.
             try {
-                m_model = m_modelLoadingTask.get(); // future.valid() is reset to false after get()
+                std::unique_ptr<ControllerModel> model = m_modelLoadingTask.get(); // future.valid() is reset to false after get()
+                if (m_model) {
+                    m_model->UploadBatch->Cancel();
+                }
+                m_model = std::move(model);
             } catch (...) {
                 sample::Trace("Unexpected failure loading controller model");
             }
             if (m_model) {
                 SetModel(m_model->PbrModel);
+                if (m_materialAtlas) {
+                    UseMaterialAtlas(m_model->UploadBatch);
+                }
             }
         }
 
@@ -154,8 +175,8 @@ namespace {
 } // namespace
 
 namespace engine {
-    std::shared_ptr<engine::Object> CreateControllerObject(Context& context, XrPath controllerUserPath) {
-        return std::make_shared<ControllerObject>(context, controllerUserPath);
+    std::shared_ptr<engine::Object> CreateControllerObject(Context& context, XrPath controllerUserPath, bool materialAtlas) {
+        return std::make_shared<ControllerObject>(context, controllerUserPath, materialAtlas);
     }
 
 } // namespace engine
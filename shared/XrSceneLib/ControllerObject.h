@@ -18,5 +18,6 @@
 #include "Object.h"
 
 namespace engine {
-    std::shared_ptr<engine::Object> CreateControllerObject(Context& context, XrPath controllerUserPath);
+    // With materialAtlas, the controller models are drawn with material atlases once loaded, see PbrModelObject::UseMaterialAtlas.
+    std::shared_ptr<engine::Object> CreateControllerObject(Context& context, XrPath controllerUserPath, bool materialAtlas = false);
 }
@@ -0,0 +1,167 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include "pch.h"
+#include "HandTracking.h"
+
+engine::HandTracking::Subscription::Subscription(Subscription&& other) noexcept
+    : m_handTracking(std::exchange(other.m_handTracking, nullptr)) {
+}
+
+engine::HandTracking::Subscription& engine::HandTracking::Subscription::operator=(Subscription&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        m_handTracking = std::exchange(other.m_handTracking, nullptr);
+    }
+    return *this;
+}
+
+engine::HandTracking::Subscription::~Subscription() {
+    Reset();
+}
+
+void engine::HandTracking::Subscription::Reset() {
+    if (m_handTracking != nullptr) {
+        std::exchange(m_handTracking, nullptr)->Unsubscribe();
+    }
+}
+
+engine::HandTracking::HandTracking(const xr::ExtensionContext& extensions,
+                                   const xr::SystemContext& system,
+                                   XrSession session,
+                                   XrSpace baseSpace)
+    : m_extensions(extensions)
+    , m_system(system)
+    , m_session(session)
+    , m_baseSpace(baseSpace) {
+}
+
+bool engine::HandTracking::IsSupported() const {
+    return m_extensions.SupportsHandJointTracking && m_system.HandTrackingProperties.supportsHandTracking;
+}
+
+engine::HandTracking::Subscription engine::HandTracking::Subscribe() {
+    if (!IsSupported()) {
+        throw std::logic_error("Hand tracking is not supported");
+    }
+
+    if (m_subscriptionCount == 0) {
+        for (const XrHandEXT hand : {XR_HAND_LEFT_EXT, XR_HAND_RIGHT_EXT}) {
+            XrHandTrackerCreateInfoEXT createInfo{XR_TYPE_HAND_TRACKER_CREATE_INFO_EXT};
+            createInfo.hand = hand;
+            createInfo.handJointSet = XR_HAND_JOINT_SET_DEFAULT_EXT;
+            CHECK_XRCMD(
+                m_extensions.xrCreateHandTrackerEXT(m_session, &createInfo, Hand(hand).Tracker.Put(m_extensions.xrDestroyHandTrackerEXT)));
+        }
+    }
+
+    m_subscriptionCount++;
+    return Subscription(this);
+}
+
+void engine::HandTracking::Unsubscribe() {
+    assert(m_subscriptionCount > 0);
+    if (--m_subscriptionCount == 0) {
+        for (HandState& hand : m_hands) {
+            hand.Tracker.Reset();
+            hand.History = {}; // Don't hand out stale joints to the next subscriber.
+        }
+    }
+}
+
+void engine::HandTracking::Update(XrTime time) {
+    if (m_subscriptionCount == 0) {
+        return;
+    }
+
+    m_version++;
+    for (const XrHandEXT handType : {XR_HAND_LEFT_EXT, XR_HAND_RIGHT_EXT}) {
+        HandState& hand = Hand(handType);
+        hand.LatestIndex = (hand.LatestIndex + 1) % HistorySize;
+        HandJointsSnapshot& snapshot = hand.History[hand.LatestIndex];
+
+        XrHandJointsLocateInfoEXT locateInfo{XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT};
+        locateInfo.baseSpace = m_baseSpace;
+        locateInfo.time = time;
+
+        XrHandJointLocationsEXT locations{XR_TYPE_HAND_JOINT_LOCATIONS_EXT};
+        locations.jointCount = static_cast<uint32_t>(snapshot.Locations.size());
+        locations.jointLocations = snapshot.Locations.data();
+        CHECK_XRCMD(m_extensions.xrLocateHandJointsEXT(hand.Tracker.Get(), &locateInfo, &locations));
+        m_runtimeCallCount++;
+
+        snapshot.Version = m_version;
+        snapshot.Time = time;
+        snapshot.IsActive = locations.isActive;
+    }
+}
+
+XrHandTrackerEXT engine::HandTracking::TrackerHandle(XrHandEXT hand) const {
+    assert(m_subscriptionCount > 0);
+    return Hand(hand).Tracker.Get();
+}
+
+const engine::HandJointsSnapshot& engine::HandTracking::Latest(XrHandEXT hand) const {
+    const HandState& state = Hand(hand);
+    return state.History[state.LatestIndex];
+}
+
+const engine::HandJointsSnapshot* engine::HandTracking::History(XrHandEXT hand, uint32_t age) const {
+    if (age >= HistorySize) {
+        return nullptr;
+    }
+
+    const HandState& state = Hand(hand);
+    const HandJointsSnapshot& snapshot = state.History[(state.LatestIndex + HistorySize - age) % HistorySize];
+    return snapshot.Version != 0 ? &snapshot : nullptr;
+}
+
+std::optional<XrVector3f> engine::HandTracking::JointLinearVelocity(XrHandEXT hand, XrHandJointEXT joint) const {
+    const HandJointsSnapshot* newer = nullptr;
+    for (uint32_t age = 0; age < HistorySize; age++) {
+        const HandJointsSnapshot* snapshot = History(hand, age);
+        if (snapshot == nullptr) {
+            break;
+        }
+        if (!snapshot->IsActive || !xr::math::Pose::IsPoseValid(snapshot->Locations[joint])) {
+            continue;
+        }
+        if (newer == nullptr) {
+            newer = snapshot;
+            continue;
+        }
+
+        const XrDuration duration = newer->Time - snapshot->Time;
+        if (duration <= 0) {
+            continue;
+        }
+
+        const float seconds = duration * 1e-9f;
+        const XrVector3f& from = snapshot->Locations[joint].pose.position;
+        const XrVector3f& to = newer->Locations[joint].pose.position;
+        return XrVector3f{(to.x - from.x) / seconds, (to.y - from.y) / seconds, (to.z - from.z) / seconds};
+    }
+    return std::nullopt;
+}
+
+engine::HandTracking::HandState& engine::HandTracking::Hand(XrHandEXT hand) {
+    assert(hand == XR_HAND_LEFT_EXT || hand == XR_HAND_RIGHT_EXT);
+    return m_hands[hand == XR_HAND_LEFT_EXT ? 0 : 1];
+}
+
+const engine::HandTracking::HandState& engine::HandTracking::Hand(XrHandEXT hand) const {
+    assert(hand == XR_HAND_LEFT_EXT || hand == XR_HAND_RIGHT_EXT);
+    return m_hands[hand == XR_HAND_LEFT_EXT ? 0 : 1];
+}
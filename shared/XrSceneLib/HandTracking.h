@@ -0,0 +1,118 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+#include <XrUtility/XrExtensionContext.h>
+#include <XrUtility/XrSystemContext.h>
+
+namespace engine {
+
+    // The joint locations of one hand at one display time.
+    struct HandJointsSnapshot {
+        uint64_t Version{0}; // Increases with every located frame, zero if the hand was never located.
+        XrTime Time{0};
+        bool IsActive{false};
+        std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT> Locations{};
+    };
+
+    // Hand joint tracking shared by all scenes.
+    //
+    // The service owns one hand tracker per hand while at least one subscription is alive, and XrApp calls Update once per frame
+    // to locate both hands in the scene space. Every consumer then reads the same snapshot, so the runtime is called once per hand
+    // and frame no matter how many scenes use hand tracking. The last HistorySize snapshots are kept to derive joint velocities.
+    // The service is used from the update thread, the same as Scene::OnUpdate.
+    class HandTracking {
+    public:
+        static constexpr uint32_t HistorySize = 4;
+
+        // Keeps the hand trackers alive until it is destroyed or reset.
+        class Subscription {
+        public:
+            Subscription() = default;
+            Subscription(Subscription&& other) noexcept;
+            Subscription& operator=(Subscription&& other) noexcept;
+            ~Subscription();
+
+            Subscription(const Subscription&) = delete;
+            Subscription& operator=(const Subscription&) = delete;
+
+            void Reset();
+
+            explicit operator bool() const {
+                return m_handTracking != nullptr;
+            }
+
+        private:
+            friend class HandTracking;
+            explicit Subscription(HandTracking* handTracking)
+                : m_handTracking(handTracking) {
+            }
+
+            HandTracking* m_handTracking{nullptr};
+        };
+
+        HandTracking(const xr::ExtensionContext& extensions, const xr::SystemContext& system, XrSession session, XrSpace baseSpace);
+
+        HandTracking(const HandTracking&) = delete;
+        HandTracking& operator=(const HandTracking&) = delete;
+
+        bool IsSupported() const;
+
+        // Creates the hand trackers on the first subscription. Throws if hand tracking is not supported.
+        Subscription Subscribe();
+
+        // Locates both hands for the given time if there is any subscription.
+        void Update(XrTime time);
+
+        // The tracker of the hand, valid while a subscription is alive. Use it for hand tracking functions beyond joint locations,
+        // such as creating hand mesh spaces. Objects created from it must be destroyed before the subscription is released.
+        XrHandTrackerEXT TrackerHandle(XrHandEXT hand) const;
+
+        // The most recent snapshot of the hand.
+        const HandJointsSnapshot& Latest(XrHandEXT hand) const;
+
+        // The snapshot located age frames before the latest one, or nullptr if it is not in the history.
+        const HandJointsSnapshot* History(XrHandEXT hand, uint32_t age) const;
+
+        // The linear velocity of a joint in the base space, derived from the last two active snapshots where the joint position was valid.
+        std::optional<XrVector3f> JointLinearVelocity(XrHandEXT hand, XrHandJointEXT joint) const;
+
+        uint64_t RuntimeCallCount() const {
+            return m_runtimeCallCount;
+        }
+
+    private:
+        struct HandState {
+            xr::HandTrackerHandle Tracker;
+            std::array<HandJointsSnapshot, HistorySize> History;
+            uint32_t LatestIndex{0};
+        };
+
+        void Unsubscribe();
+        HandState& Hand(XrHandEXT hand);
+        const HandState& Hand(XrHandEXT hand) const;
+
+        const xr::ExtensionContext& m_extensions;
+        const xr::SystemContext& m_system;
+        const XrSession m_session;
+        const XrSpace m_baseSpace;
+
+        std::array<HandState, 2> m_hands;
+        uint32_t m_subscriptionCount{0};
+        uint64_t m_version{0};
+        uint64_t m_runtimeCallCount{0};
+    };
+} // namespace engine
@@ -57,3 +57,7 @@ DirectX::XMMATRIX Object::LocalTransform() const {
 DirectX::XMMATRIX Object::WorldTransform() const {
     return m_parent ? XMMatrixMultiply(LocalTransform(), m_parent->WorldTransform()) : LocalTransform();
 }
+
+DirectX::XMMATRIX Object::RenderTransform(const Context& context) const {
+    return IsHeadLocked() ? XMMatrixMultiply(WorldTransform(), xr::math::LoadXrPose(context.HeadLockedCorrection)) : WorldTransform();
+}
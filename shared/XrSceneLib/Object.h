@@ -41,8 +41,20 @@ namespace engine {
             return State == ObjectState::Initialized && m_isVisible && (m_parent ? m_parent->IsVisible() : true);
         }
 
+        // Head-locked objects are posed relative to the head by the update thread. They are rendered with the late-latch correction
+        // of the view, so they stay fixed in view when the view poses are late-latched. Children of head-locked objects are head-locked.
+        void SetHeadLocked(bool headLocked) {
+            m_isHeadLocked = headLocked;
+        }
+        bool IsHeadLocked() const {
+            return m_isHeadLocked || (m_parent ? m_parent->IsHeadLocked() : false);
+        }
+
         void SetOnlyVisibleForViewIndex(uint32_t viewIndex);
         bool IsVisibleForViewIndex(uint32_t viewIndex) const;
+        uint32_t VisibleViewMask() const {
+            return m_visibleViewIndexMask.m_mask;
+        }
 
         const XrPosef& Pose() const {
             return m_pose;
@@ -63,11 +75,15 @@ namespace engine {
         DirectX::XMMATRIX LocalTransform() const;
         DirectX::XMMATRIX WorldTransform() const;
 
+        // The world transform for rendering the current view, which includes Context::HeadLockedCorrection for head-locked objects.
+        DirectX::XMMATRIX RenderTransform(const Context& context) const;
+
         virtual void Update(engine::Context& context, const FrameTime& frameTime);
         virtual void Render(Context& context) const;
 
     private:
         bool m_isVisible{true};
+        bool m_isHeadLocked{false};
 
         XrPosef m_pose = xr::math::Pose::Identity();
         XrVector3f m_scale = {1, 1, 1};
@@ -16,6 +16,7 @@
 #include "pch.h"
 #include <pbr/PbrModel.h>
 #include <pbr/GltfLoader.h>
+#include <SampleShared/AllocationProfiler.h>
 #include <SampleShared/FileUtility.h>
 #include "PbrModelObject.h"
 
@@ -30,6 +31,7 @@ PbrModelObject::PbrModelObject(std::shared_ptr<Pbr::Model> pbrModel, Pbr::Shadin
 
 void PbrModelObject::SetModel(std::shared_ptr<Pbr::Model> model) {
     m_pbrModel = std::move(model);
+    m_materialAtlasBatch = nullptr;
 }
 
 std::shared_ptr<Pbr::Model> PbrModelObject::GetModel() const {
@@ -41,11 +43,24 @@ void PbrModelObject::Render(engine::Context& context) const {
         return;
     }
 
+    if (m_materialAtlasBatch && m_materialAtlasBatch->IsComplete()) {
+        if (!m_materialAtlasBatch->IsCancelled()) {
+            sample::allocation::AllowAllocationsScope allowAllocations; // Building the atlas is expected to allocate, once.
+            m_pbrModel->BuildMaterialAtlas(context.PbrResources, context.DeviceContext.get());
+        }
+        m_materialAtlasBatch = nullptr;
+    }
+
     context.PbrResources.SetShadingMode(m_shadingMode);
     context.PbrResources.SetFillMode(m_fillMode);
-    context.PbrResources.SetModelToWorld(WorldTransform(), context.DeviceContext.get());
+    const DirectX::XMMATRIX modelToWorld = RenderTransform(context);
+    context.PbrResources.SetModelToWorld(modelToWorld, context.DeviceContext.get());
     context.PbrResources.Bind(context.DeviceContext.get());
     m_pbrModel->Render(context.PbrResources, context.DeviceContext.get());
+
+    if (const std::shared_ptr<Pbr::TextureResidency> residency = context.PbrResources.GetTextureResidency()) {
+        residency->ReportModel(*m_pbrModel, modelToWorld);
+    }
 }
 
 void PbrModelObject::SetShadingMode(const Pbr::ShadingMode& shadingMode) {
@@ -56,20 +71,29 @@ void PbrModelObject::SetFillMode(const Pbr::FillMode& fillMode) {
     m_fillMode = fillMode;
 }
 
+void PbrModelObject::UseMaterialAtlas(std::shared_ptr<Pbr::UploadBatch> uploadBatch) {
+    m_materialAtlasBatch = std::move(uploadBatch);
+}
+
 void PbrModelObject::SetBaseColorFactor(const Pbr::RGBAColor color) {
     for (uint32_t k = 0; k < GetModel()->GetPrimitiveCount(); k++) {
-        auto& material = GetModel()->GetPrimitive(k).GetMaterial();
-        material->Parameters().BaseColorFactor = color;
+        Pbr::Material& material = GetModel()->GetPrimitive(k).GetMaterialForEdit();
+        material.Parameters().BaseColorFactor = color;
     }
 }
 
 using engine::PbrModelLoadOperation;
 
-/* static */ PbrModelLoadOperation PbrModelLoadOperation::LoadGltfBinaryAsync(Pbr::Resources& pbrResources, std::wstring filename) {
-    return PbrModelLoadOperation(std::async(std::launch::async, [&pbrResources, filename = std::move(filename)]() {
+/* static */ PbrModelLoadOperation PbrModelLoadOperation::LoadGltfBinaryAsync(Pbr::Resources& pbrResources,
+                                                                             Pbr::UploadQueue& uploadQueue,
+                                                                             std::wstring filename,
+                                                                             Pbr::UploadPriority priority) {
+    std::shared_ptr<Pbr::UploadBatch> uploadBatch = uploadQueue.CreateBatch(priority);
+    auto loadModelTask = std::async(std::launch::async, [&pbrResources, &uploadQueue, uploadBatch, filename = std::move(filename)]() {
         const std::vector<uint8_t> glbData = sample::ReadFileBytes(sample::FindFileInAppFolder(filename.c_str()));
-        return Gltf::FromGltfBinary(pbrResources, glbData);
-    }));
+        return Gltf::FromGltfBinary(pbrResources, glbData.data(), static_cast<uint32_t>(glbData.size()), uploadQueue, uploadBatch);
+    });
+    return PbrModelLoadOperation(std::move(loadModelTask), std::move(uploadBatch));
 }
 
 std::shared_ptr<Pbr::Model> PbrModelLoadOperation::TakeModelWhenReady() {
@@ -80,6 +104,17 @@ std::shared_ptr<Pbr::Model> PbrModelLoadOperation::TakeModelWhenReady() {
     return nullptr;
 }
 
+bool PbrModelLoadOperation::IsFullyLoaded() const {
+    // The uploads are all enqueued by the time the load task is done.
+    return m_uploadBatch && !m_loadModelTask.valid() && m_uploadBatch->IsComplete() && !m_uploadBatch->IsCancelled();
+}
+
+void PbrModelLoadOperation::Cancel() {
+    if (m_uploadBatch) {
+        m_uploadBatch->Cancel();
+    }
+}
+
 PbrModelLoadOperation::~PbrModelLoadOperation() {
     // Caller ensures reference to Pbr::Resources stays alive only until this object is destroyed, so delay destruction if it is
     // still in use.
@@ -88,8 +123,10 @@ PbrModelLoadOperation::~PbrModelLoadOperation() {
     }
 }
 
-PbrModelLoadOperation::PbrModelLoadOperation(std::future<std::shared_ptr<Pbr::Model>> loadModelTask)
-    : m_loadModelTask(std::move(loadModelTask)) {
+PbrModelLoadOperation::PbrModelLoadOperation(std::future<std::shared_ptr<Pbr::Model>> loadModelTask,
+                                             std::shared_ptr<Pbr::UploadBatch> uploadBatch)
+    : m_loadModelTask(std::move(loadModelTask))
+    , m_uploadBatch(std::move(uploadBatch)) {
 }
 
 std::shared_ptr<PbrModelObject> engine::CreateCube(const Pbr::Resources& pbrResources,
@@ -18,6 +18,7 @@
 #include <future>
 #include <pbr/PbrModel.h>
 #include <pbr/PbrMaterial.h>
+#include <pbr/PbrUploadQueue.h>
 #include "Scene.h"
 #include "Context.h"
 
@@ -36,32 +37,49 @@ namespace engine {
         void SetFillMode(const Pbr::FillMode& fillMode);
         void SetBaseColorFactor(Pbr::RGBAColor color);
 
+        // Draws the model with a material atlas, see Pbr::Model::BuildMaterialAtlas. The atlas is built on the render thread
+        // once uploadBatch, which creates the primitives and textures of the model, is complete. Off by default.
+        void UseMaterialAtlas(std::shared_ptr<Pbr::UploadBatch> uploadBatch);
+
         void Render(Context& context) const override;
 
     private:
         std::shared_ptr<Pbr::Model> m_pbrModel;
         Pbr::ShadingMode m_shadingMode;
         Pbr::FillMode m_fillMode;
+        mutable std::shared_ptr<Pbr::UploadBatch> m_materialAtlasBatch; // Until the atlas is built
     };
 
-    // Helper for loading GLB files in the background. 
+    // Helper for loading GLB files in the background. The file is read on a worker thread, then the primitives and
+    // textures of the model are created by the upload queue, the primitives first.
     struct PbrModelLoadOperation {
         PbrModelLoadOperation() = default;
         PbrModelLoadOperation(PbrModelLoadOperation&&) = default;
         PbrModelLoadOperation& operator=(PbrModelLoadOperation&&) = default;
 
-        static PbrModelLoadOperation LoadGltfBinaryAsync(Pbr::Resources& pbrResources, std::wstring filename);
+        static PbrModelLoadOperation LoadGltfBinaryAsync(Pbr::Resources& pbrResources,
+                                                         Pbr::UploadQueue& uploadQueue,
+                                                         std::wstring filename,
+                                                         Pbr::UploadPriority priority = Pbr::UploadPriority::Normal);
 
-        // Take the model (can only be done once) once it has been loaded.
+        // Take the model (can only be done once) once the file has been read. Its primitives and textures keep appearing
+        // as the upload queue creates them.
         std::shared_ptr<Pbr::Model> TakeModelWhenReady();
 
+        // Whether every primitive and texture of the model was created.
+        bool IsFullyLoaded() const;
+
+        // Stops creating the primitives and textures of the model, when it is no longer needed.
+        void Cancel();
+
         // Dtor ensures outstanding operation is complete before returning.
         ~PbrModelLoadOperation();
 
     private:
-        explicit PbrModelLoadOperation(std::future<std::shared_ptr<Pbr::Model>> loadModelTask);
+        PbrModelLoadOperation(std::future<std::shared_ptr<Pbr::Model>> loadModelTask, std::shared_ptr<Pbr::UploadBatch> uploadBatch);
 
         std::future<std::shared_ptr<Pbr::Model>> m_loadModelTask;
+        std::shared_ptr<Pbr::UploadBatch> m_uploadBatch;
     };
 
     std::shared_ptr<PbrModelObject> CreateCube(const Pbr::Resources& pbrResources,
@@ -42,6 +42,9 @@ engine::ProjectionLayer::ProjectionLayer(const xr::SessionContext& sessionContex
 
         if (type == XR_VIEW_CONFIGURATION_TYPE_SECONDARY_MONO_FIRST_PERSON_OBSERVER_MSFT) {
             m_viewConfigComponents[type].PendingConfig.LayerFlags = XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT;
+
+            // Mixed reality capture records at a fraction of the display rate, so half the frames are enough for the observer.
+            m_viewConfigComponents[type].PendingConfig.RenderInterval = 2;
         }
     }
 }
@@ -105,26 +108,33 @@ void engine::ProjectionLayer::PrepareRendering(const Context& context,
 
     viewConfigComponent.Viewports.resize(viewConfigViews.size());
 
+    // The viewport may cover only part of each swapchain image, such as when the render resolution is scaled down dynamically.
+    // The image rects submitted to the compositor match the viewport, so it scales up the rendered pixels only.
+    const int32_t viewportWidth = std::clamp(static_cast<int32_t>(swapchainImageWidth * layerCurrentConfig.ViewportSizeScale.width),
+                                             1,
+                                             static_cast<int32_t>(swapchainImageWidth) - layerCurrentConfig.ViewportOffset.x);
+    const int32_t viewportHeight = std::clamp(static_cast<int32_t>(swapchainImageHeight * layerCurrentConfig.ViewportSizeScale.height),
+                                              1,
+                                              static_cast<int32_t>(swapchainImageHeight) - layerCurrentConfig.ViewportOffset.y);
+
     for (uint32_t viewIndex = 0; viewIndex < (uint32_t)viewConfigViews.size(); viewIndex++) {
-        viewConfigComponent.Viewports[viewIndex] = CD3D11_VIEWPORT(
-            layerCurrentConfig.DoubleWideMode ? static_cast<float>(swapchainImageWidth * viewIndex + layerCurrentConfig.ViewportOffset.x)
-                                              : static_cast<float>(layerCurrentConfig.ViewportOffset.x),
-            static_cast<float>(layerCurrentConfig.ViewportOffset.y),
-            static_cast<float>(swapchainImageWidth * layerCurrentConfig.ViewportSizeScale.width),
-            static_cast<float>(swapchainImageHeight * layerCurrentConfig.ViewportSizeScale.height));
-
-        const int32_t doubleWideOffsetX = static_cast<int32_t>(swapchainImageWidth * viewIndex);
-        viewConfigComponent.LayerDepthImageRect[viewIndex] =
-            viewConfigComponent.LayerColorImageRect[viewIndex] = {layerCurrentConfig.DoubleWideMode ? doubleWideOffsetX : 0,
-                                                                  0,
-                                                                  static_cast<int32_t>(std::ceil(swapchainImageWidth)),
-                                                                  static_cast<int32_t>(std::ceil(swapchainImageHeight))};
+        const int32_t doubleWideOffsetX = layerCurrentConfig.DoubleWideMode ? static_cast<int32_t>(swapchainImageWidth * viewIndex) : 0;
+        const XrRect2Di imageRect = {{doubleWideOffsetX + layerCurrentConfig.ViewportOffset.x, layerCurrentConfig.ViewportOffset.y},
+                                     {viewportWidth, viewportHeight}};
+
+        viewConfigComponent.Viewports[viewIndex] = CD3D11_VIEWPORT(static_cast<float>(imageRect.offset.x),
+                                                                   static_cast<float>(imageRect.offset.y),
+                                                                   static_cast<float>(imageRect.extent.width),
+                                                                   static_cast<float>(imageRect.extent.height));
+        viewConfigComponent.LayerDepthImageRect[viewIndex] = viewConfigComponent.LayerColorImageRect[viewIndex] = imageRect;
     }
 
     if (!shouldResetSwapchain) {
         return;
     }
 
+    viewConfigComponent.LastRenderedFrameIndex.reset(); // Nothing to submit again from the new swapchains.
+
     const uint32_t wideScale = layerCurrentConfig.DoubleWideMode ? 2 : 1;
     const uint32_t arrayLength = layerCurrentConfig.DoubleWideMode ? 1 : (uint32_t)viewConfigViews.size();
 
@@ -167,6 +177,7 @@ void engine::ProjectionLayer::PrepareRendering(const Context& context,
 
     viewConfigComponent.ProjectionViews.resize(viewConfigViews.size());
     viewConfigComponent.DepthInfo.resize(viewConfigViews.size());
+    viewConfigComponent.LatchedViews.resize(viewConfigViews.size(), {XR_TYPE_VIEW});
 }
 
 bool engine::ProjectionLayer::Render(Context& context,
@@ -200,8 +211,32 @@ bool engine::ProjectionLayer::Render(Context& context,
         submitProjectionLayer = false;
     } else {
         const uint32_t viewCount = (uint32_t)views.size();
+        const bool reversedZ = (currentConfig.NearFar.Near > currentConfig.NearFar.Far);
+
+        // Single pass rendering draws every view into its own slice of the texture arrays with instanced draws.
+        const bool singlePass = currentConfig.SinglePassStereo && !currentConfig.DoubleWideMode && viewCount > 1 &&
+                                viewCount <= Pbr::Resources::MaxViewCount && context.PbrResources.SupportsSinglePassViews();
+        std::array<DirectX::XMMATRIX, Pbr::Resources::MaxViewCount> worldToViewMatrices;
+        std::array<DirectX::XMMATRIX, Pbr::Resources::MaxViewCount> projectionMatrices;
+        D3D11_VIEWPORT singlePassViewport{};
+        XrPosef singlePassHeadLockedCorrection = xr::math::Pose::Identity();
+
+        viewConfigComponent.LatchedViewCount = 0;
+        if (currentConfig.LateLatchViews) {
+            LocateLatchedViews(context, frameTime.PredictedDisplayTime, layerSpace, viewConfig);
+        }
+
+        // The submission is timed after the views are located, so that only the cost of recording the views is measured.
+        const engine::FrameTime::clock::time_point submitStart = engine::FrameTime::clock::now();
+        engine::RenderStatistics& renderStatistics = viewConfigComponent.RenderStatistics;
+        renderStatistics.FrameCount++;
+
         for (uint32_t viewIndex = 0; viewIndex < viewCount; viewIndex++) {
-            const XrView& projection = views[viewIndex];
+            XrView projection = views[viewIndex];
+            context.HeadLockedCorrection = xr::math::Pose::Identity();
+            if (viewIndex < viewConfigComponent.LatchedViewCount) {
+                ApplyLatchedView(context, viewConfig, viewIndex, projection);
+            }
 
             const XrFovf fov = projection.fov;
             const XrPosef viewPose = projection.pose;
@@ -237,44 +272,45 @@ bool engine::ProjectionLayer::Render(Context& context,
                 projectionViews[viewIndex].next = nullptr;
             }
 
+            // The streamed textures of the models rendered from here on choose their levels by this view too.
+            if (const std::shared_ptr<Pbr::TextureResidency> residency = context.PbrResources.GetTextureResidency()) {
+                Pbr::ResidencyView residencyView;
+                residencyView.Position = xr::math::cast(viewPose.position);
+                residencyView.Orientation = xr::math::cast(viewPose.orientation);
+                residencyView.AngleLeft = fov.angleLeft;
+                residencyView.AngleRight = fov.angleRight;
+                residencyView.AngleUp = fov.angleUp;
+                residencyView.AngleDown = fov.angleDown;
+                residencyView.Width = static_cast<uint32_t>(viewport.Width);
+                residencyView.Height = static_cast<uint32_t>(viewport.Height);
+                residency->AddView(residencyView);
+            }
+
+            if (singlePass) {
+                // The views are rigidly attached to the head, so late latching corrects all of them by the same pose.
+                if (viewIndex == 0) {
+                    singlePassViewport = viewport;
+                    singlePassHeadLockedCorrection = context.HeadLockedCorrection;
+                }
+                worldToViewMatrices[viewIndex] = xr::math::LoadInvertedXrPose(projectionViews[viewIndex].pose);
+                projectionMatrices[viewIndex] = xr::math::ComposeProjectionMatrix(fov, currentConfig.NearFar);
+                continue;
+            }
+
             // Render for this view pose.
             {
                 // Set the Viewport.
                 context.DeviceContext->RSSetViewports(1, &viewport);
 
-                const uint32_t firstArraySliceForColor = projectionViews[viewIndex].subImage.imageArrayIndex;
-
-                // Create a render target view into the appropriate slice of the color texture from this swapchain image.
-                // This is a lightweight operation which can be done for each viewport projection.
-                winrt::com_ptr<ID3D11RenderTargetView> renderTargetView;
-                const CD3D11_RENDER_TARGET_VIEW_DESC renderTargetViewDesc(
-                    currentConfig.SwapchainSampleCount > 1 ? D3D11_RTV_DIMENSION_TEXTURE2DMSARRAY : D3D11_RTV_DIMENSION_TEXTURE2DARRAY,
-                    currentConfig.ColorSwapchainFormat,
-                    0 /* mipSlice */,
-                    firstArraySliceForColor,
-                    1 /* arraySize */);
-                CHECK_HRCMD(context.Device->CreateRenderTargetView(
-                    colorSwapchain.Images[colorSwapchainImageIndex].texture, &renderTargetViewDesc, renderTargetView.put()));
-
-                const uint32_t firstArraySliceForDepth = depthImageArrayIndex;
-
-                // Create a depth stencil view into the slice of the depth stencil texture array for this swapchain image.
-                // This is a lightweight operation which can be done for each viewport projection.
-                winrt::com_ptr<ID3D11DepthStencilView> depthStencilView;
-                CD3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc(
-                    currentConfig.SwapchainSampleCount > 1 ? D3D11_DSV_DIMENSION_TEXTURE2DMSARRAY : D3D11_DSV_DIMENSION_TEXTURE2DARRAY,
-                    currentConfig.DepthSwapchainFormat,
-                    0 /* mipSlice */,
-                    firstArraySliceForDepth,
-                    1 /* arraySize */);
-                CHECK_HRCMD(context.Device->CreateDepthStencilView(
-                    depthSwapchain.Images[depthSwapchainImageIndex].texture, &depthStencilViewDesc, depthStencilView.put()));
-
-                const bool reversedZ = (currentConfig.NearFar.Near > currentConfig.NearFar.Far);
+                // The views into the swapchain images were created together with the swapchains.
+                ID3D11RenderTargetView* const renderTargetView =
+                    colorSwapchain.RenderTargetView(colorSwapchainImageIndex, colorImageArrayIndex);
+                ID3D11DepthStencilView* const depthStencilView =
+                    depthSwapchain.DepthStencilView(depthSwapchainImageIndex, depthImageArrayIndex);
 
                 // Clear and render to the render target.
-                ID3D11RenderTargetView* const renderTargets[] = {renderTargetView.get()};
-                context.DeviceContext->OMSetRenderTargets(1, renderTargets, depthStencilView.get());
+                ID3D11RenderTargetView* const renderTargets[] = {renderTargetView};
+                context.DeviceContext->OMSetRenderTargets(1, renderTargets, depthStencilView);
 
                 // In double wide mode, the first projection clears the whole RTV and DSV.
                 if ((viewIndex == 0) || !currentConfig.DoubleWideMode) {
@@ -283,7 +319,7 @@ bool engine::ProjectionLayer::Render(Context& context,
 
                     const float clearDepthValue = reversedZ ? 0.f : 1.f;
                     context.DeviceContext->ClearDepthStencilView(
-                        depthStencilView.get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, clearDepthValue, 0);
+                        depthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, clearDepthValue, 0);
                 }
 
                 const DirectX::XMMATRIX projectionMatrix = xr::math::ComposeProjectionMatrix(fov, currentConfig.NearFar);
@@ -303,6 +339,7 @@ bool engine::ProjectionLayer::Render(Context& context,
                 context.PbrResources.SetDepthFuncReversed(reversedZ);
 
                 // Render all active scenes.
+                renderStatistics.PassCount++;
                 for (const std::unique_ptr<Scene>& scene : activeScenes) {
                     if (scene->IsActive() && !std::empty(scene->GetObjects())) {
                         submitProjectionLayer = true;
@@ -311,8 +348,45 @@ bool engine::ProjectionLayer::Render(Context& context,
                 }
             }
         }
+
+        // Render all views at once, each instance of a draw goes to the view and array slice of its instance index.
+        if (singlePass) {
+            context.HeadLockedCorrection = singlePassHeadLockedCorrection;
+            context.DeviceContext->RSSetViewports(1, &singlePassViewport);
+
+            ID3D11RenderTargetView* const renderTargets[] = {colorSwapchain.ArrayRenderTargetView(colorSwapchainImageIndex)};
+            ID3D11DepthStencilView* const depthStencilView = depthSwapchain.ArrayDepthStencilView(depthSwapchainImageIndex);
+            context.DeviceContext->OMSetRenderTargets(1, renderTargets, depthStencilView);
+
+            context.DeviceContext->ClearRenderTargetView(renderTargets[0], reinterpret_cast<const float*>(&Config().ClearColor));
+            const float clearDepthValue = reversedZ ? 0.f : 1.f;
+            context.DeviceContext->ClearDepthStencilView(depthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, clearDepthValue, 0);
+
+            if (reversedZ) {
+                context.DeviceContext->OMSetDepthStencilState(m_reversedZDepthNoStencilTest.get(), 0);
+            } else {
+                context.DeviceContext->OMSetDepthStencilState(nullptr, 0);
+            }
+
+            context.PbrResources.SetViewProjections(worldToViewMatrices.data(), projectionMatrices.data(), viewCount);
+            context.PbrResources.Bind(context.DeviceContext.get());
+            context.PbrResources.SetDepthFuncReversed(reversedZ);
+
+            renderStatistics.PassCount++;
+            renderStatistics.SinglePassFrameCount++;
+            for (const std::unique_ptr<Scene>& scene : activeScenes) {
+                if (scene->IsActive() && !std::empty(scene->GetObjects())) {
+                    submitProjectionLayer = true;
+                    scene->RenderViews(frameTime, viewCount);
+                }
+            }
+        }
+
+        renderStatistics.TotalSubmitTime += engine::FrameTime::clock::now() - submitStart;
     }
 
+    context.HeadLockedCorrection = xr::math::Pose::Identity();
+
     // Now that the scene is done writing to the swapchain, it must be released in order to be made available for
     // xrEndFrame.
     const XrSwapchainImageReleaseInfo releaseInfo{XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO};
@@ -321,9 +395,71 @@ bool engine::ProjectionLayer::Render(Context& context,
 
     context.PbrResources.UpdateAnimationTime(frameTime.TotalElapsed);
 
+    viewConfigComponent.LastRenderedFrameIndex = frameTime.FrameIndex;
+    viewConfigComponent.LastRenderHasContent = submitProjectionLayer;
+
     return submitProjectionLayer;
 }
 
+bool engine::ProjectionLayer::IsRenderDue(const engine::FrameTime& frameTime, XrViewConfigurationType viewConfig) const {
+    const ViewConfigComponent& viewConfigComponent = m_viewConfigComponents.at(viewConfig);
+    if (!viewConfigComponent.LastRenderedFrameIndex.has_value()) {
+        return true;
+    }
+
+    const uint32_t renderInterval = std::max(viewConfigComponent.CurrentConfig.RenderInterval, 1u);
+    return frameTime.FrameIndex - viewConfigComponent.LastRenderedFrameIndex.value() >= renderInterval;
+}
+
+bool engine::ProjectionLayer::CanResubmit(XrViewConfigurationType viewConfig) const {
+    const ViewConfigComponent& viewConfigComponent = m_viewConfigComponents.at(viewConfig);
+    return viewConfigComponent.LastRenderedFrameIndex.has_value() && viewConfigComponent.LastRenderHasContent;
+}
+
+void engine::ProjectionLayer::LocateLatchedViews(Context& context,
+                                                 XrTime displayTime,
+                                                 XrSpace layerSpace,
+                                                 XrViewConfigurationType viewConfig) {
+    ViewConfigComponent& viewConfigComponent = m_viewConfigComponents.at(viewConfig);
+    std::vector<XrView>& latchedViews = viewConfigComponent.LatchedViews;
+
+    // The runtime refines its prediction for the display time as it gets closer, so locating the views again right before
+    // drawing gives a more accurate pose than the one located when the frame started. One locate serves every view of the layer.
+    XrViewLocateInfo viewLocateInfo{XR_TYPE_VIEW_LOCATE_INFO};
+    viewLocateInfo.viewConfigurationType = viewConfig;
+    viewLocateInfo.displayTime = displayTime;
+    viewLocateInfo.space = layerSpace;
+
+    XrViewState viewState{XR_TYPE_VIEW_STATE};
+    uint32_t viewCount = 0;
+    CHECK_XRCMD(xrLocateViews(
+        context.Session.Handle, &viewLocateInfo, &viewState, (uint32_t)latchedViews.size(), &viewCount, latchedViews.data()));
+
+    // Without a valid pose, the views located when the frame started are kept.
+    viewConfigComponent.LatchedViewCount = xr::math::Pose::IsPoseValid(viewState) ? viewCount : 0;
+}
+
+void engine::ProjectionLayer::ApplyLatchedView(Context& context, XrViewConfigurationType viewConfig, uint32_t viewIndex, XrView& view) {
+    ViewConfigComponent& viewConfigComponent = m_viewConfigComponents.at(viewConfig);
+    const XrView& latchedView = viewConfigComponent.LatchedViews[viewIndex];
+
+    // Head-locked objects were posed against the earlier view pose, so they are moved by the same correction.
+    const XrPosef correction = xr::math::Pose::Multiply(xr::math::Pose::Invert(view.pose), latchedView.pose);
+    context.HeadLockedCorrection = correction;
+
+    const float translation = xr::math::Length(latchedView.pose.position - view.pose.position);
+    const float rotation = 2 * std::acos(std::min(1.0f, std::abs(correction.orientation.w)));
+    engine::LateLatchStatistics& statistics = viewConfigComponent.LateLatchStatistics;
+    statistics.ViewCount++;
+    statistics.TotalTranslation += translation;
+    statistics.TotalRotation += rotation;
+    statistics.MaxTranslation = std::max(statistics.MaxTranslation, translation);
+    statistics.MaxRotation = std::max(statistics.MaxRotation, rotation);
+
+    view.pose = latchedView.pose;
+    view.fov = latchedView.fov;
+}
+
 void engine::AppendProjectionLayer(CompositionLayers& layers, ProjectionLayer* layer, XrViewConfigurationType viewConfig) {
     XrCompositionLayerProjection& projectionLayer = layers.AddProjectionLayer(layer->Config(viewConfig).LayerFlags);
     projectionLayer.space = layer->LayerSpace(viewConfig);
@@ -40,6 +40,58 @@ namespace engine {
         bool ContentProtected = false;
         bool ForceReset = false;
         DirectX::XMFLOAT4 ClearColor = {0, 0, 0, 0}; // Transparent
+
+        // Locate the views again once the swapchain images are ready, right before the layer is rendered, so the view poses use
+        // the latest head tracking prediction for the display time instead of the one made when the frame started. The views
+        // are located once per layer and frame. Head-locked objects, see Object::SetHeadLocked, move along with the views.
+        bool LateLatchViews = false;
+
+        // Render only every RenderInterval frames. In the frames between, the images rendered last are submitted again with the
+        // view poses they were rendered for, and the compositor reprojects them. Only used for secondary view configurations.
+        uint32_t RenderInterval = 1;
+
+        // Render after the frame is submitted and submit the images with the next frame, which takes the rendering off the path
+        // to xrEndFrame at the cost of one frame of latency. Only used for secondary view configurations.
+        bool RenderAfterSubmission = false;
+
+        // Render all views in one pass of instanced draws into the slices of the swapchain texture arrays, which halves the draw
+        // calls for stereo. Falls back to rendering each view separately in double wide mode or when the device cannot select the
+        // render target array index from the vertex shader.
+        bool SinglePassStereo = false;
+    };
+
+    // How far late latching moved the view poses, accumulated over all rendered views since the last reset.
+    struct LateLatchStatistics {
+        uint64_t ViewCount{0};
+        double TotalTranslation{0}; // Meters
+        double TotalRotation{0};    // Radians
+        float MaxTranslation{0};
+        float MaxRotation{0};
+
+        double MeanTranslation() const {
+            return ViewCount > 0 ? TotalTranslation / ViewCount : 0;
+        }
+
+        double MeanRotation() const {
+            return ViewCount > 0 ? TotalRotation / ViewCount : 0;
+        }
+    };
+
+    // How many passes over the scenes recorded the draw calls of a layer and the CPU time they took, accumulated over all rendered
+    // frames since the last reset. Rendering each view separately takes one pass per view, single pass stereo takes one pass.
+    struct RenderStatistics {
+        uint64_t FrameCount{0};
+        uint64_t SinglePassFrameCount{0}; // Frames rendered in one pass, see ProjectionLayerConfig::SinglePassStereo.
+        uint64_t PassCount{0};
+        std::chrono::duration<double> TotalSubmitTime{0}; // From binding the first view to the last draw call of the scenes.
+
+        double MeanPassCount() const {
+            return FrameCount > 0 ? static_cast<double>(PassCount) / FrameCount : 0;
+        }
+
+        double MeanSubmitMilliseconds() const {
+            return FrameCount > 0 ? TotalSubmitTime.count() * 1000 / FrameCount : 0;
+        }
     };
 
     struct Scene;
@@ -67,6 +119,33 @@ namespace engine {
             return m_viewConfigComponents.at(viewConfig.value_or(m_defaultViewConfigurationType)).LayerSpace;
         }
 
+        const engine::LateLatchStatistics& LateLatchStatistics(std::optional<XrViewConfigurationType> viewConfig = std::nullopt) const {
+            return m_viewConfigComponents.at(viewConfig.value_or(m_defaultViewConfigurationType)).LateLatchStatistics;
+        }
+
+        void ResetLateLatchStatistics(std::optional<XrViewConfigurationType> viewConfig = std::nullopt) {
+            m_viewConfigComponents.at(viewConfig.value_or(m_defaultViewConfigurationType)).LateLatchStatistics = {};
+        }
+
+        const engine::RenderStatistics& RenderStatistics(std::optional<XrViewConfigurationType> viewConfig = std::nullopt) const {
+            return m_viewConfigComponents.at(viewConfig.value_or(m_defaultViewConfigurationType)).RenderStatistics;
+        }
+
+        void ResetRenderStatistics(std::optional<XrViewConfigurationType> viewConfig = std::nullopt) {
+            m_viewConfigComponents.at(viewConfig.value_or(m_defaultViewConfigurationType)).RenderStatistics = {};
+        }
+
+        bool RendersAfterSubmission(XrViewConfigurationType viewConfig) const {
+            return m_viewConfigComponents.at(viewConfig).CurrentConfig.RenderAfterSubmission;
+        }
+
+        // Whether the view configuration should be rendered in this frame according to its RenderInterval,
+        // rather than submitting the images rendered in an earlier frame again.
+        bool IsRenderDue(const engine::FrameTime& frameTime, XrViewConfigurationType viewConfig) const;
+
+        // Whether the images rendered in an earlier frame are still in the swapchains and have content to submit.
+        bool CanResubmit(XrViewConfigurationType viewConfig) const;
+
         void PrepareRendering(const Context& context,
                               XrViewConfigurationType viewConfigType,
                               const std::vector<XrViewConfigurationView>& viewConfigViews);
@@ -87,6 +166,13 @@ namespace engine {
             std::vector<XrCompositionLayerProjectionView> ProjectionViews; // Pre-allocated and reused for each frame.
             std::vector<XrCompositionLayerDepthInfoKHR> DepthInfo;         // Pre-allocated and reused for each frame.
             std::vector<D3D11_VIEWPORT> Viewports;
+            std::vector<XrView> LatchedViews;                               // Pre-allocated and reused for each frame.
+            uint32_t LatchedViewCount{0};                                   // Views located by the last late latch, 0 if invalid.
+            engine::LateLatchStatistics LateLatchStatistics;
+            engine::RenderStatistics RenderStatistics;
+
+            std::optional<uint64_t> LastRenderedFrameIndex; // Reset when the swapchains are recreated.
+            bool LastRenderHasContent{false};
 
             XrRect2Di LayerColorImageRect[xr::StereoView::Count];
             XrRect2Di LayerDepthImageRect[xr::StereoView::Count];
@@ -94,6 +180,9 @@ namespace engine {
             sample::dx::SwapchainD3D11 ColorSwapchain;
             sample::dx::SwapchainD3D11 DepthSwapchain;
         };
+        void LocateLatchedViews(Context& context, XrTime displayTime, XrSpace layerSpace, XrViewConfigurationType viewConfig);
+        void ApplyLatchedView(Context& context, XrViewConfigurationType viewConfig, uint32_t viewIndex, XrView& view);
+
         std::unordered_map<XrViewConfigurationType, ViewConfigComponent> m_viewConfigComponents;
         XrViewConfigurationType m_defaultViewConfigurationType;
 
@@ -0,0 +1,79 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+// No precompiled header, so the controller also builds in the portable unit tests.
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "ResolutionController.h"
+
+engine::ResolutionController::ResolutionController(const ResolutionControllerSettings& settings)
+    : m_settings(settings)
+    , m_scale(settings.MaxScale) {
+    assert(settings.MinScale > 0 && settings.MinScale <= settings.MaxScale);
+    assert(settings.IncreaseThreshold < settings.TargetUtilization && settings.TargetUtilization < settings.DecreaseThreshold);
+    m_lastReport.Scale = m_scale;
+}
+
+float engine::ResolutionController::Update(XrDuration frameDuration, XrDuration displayPeriod) {
+    m_lastReport.FrameIndex++;
+    m_lastReport.FrameDuration = frameDuration;
+    m_lastReport.DisplayPeriod = displayPeriod;
+    if (displayPeriod <= 0 || frameDuration <= 0) {
+        return m_scale; // Nothing to measure against, such as while the session isn't focused.
+    }
+
+    const float utilization = static_cast<float>(frameDuration) / static_cast<float>(displayPeriod);
+    m_utilization = m_hasUtilization ? m_utilization + m_settings.Smoothing * (utilization - m_utilization) : utilization;
+    m_hasUtilization = true;
+
+    // The scale that would bring the utilization to the target if the cost of a frame follows its pixel count.
+    const float targetScale = m_scale * std::sqrt(m_settings.TargetUtilization / m_utilization);
+
+    if (m_utilization > m_settings.DecreaseThreshold) {
+        m_framesBelowIncreaseThreshold = 0;
+        SetScale(targetScale);
+    } else if (m_utilization < m_settings.IncreaseThreshold) {
+        if (++m_framesBelowIncreaseThreshold >= m_settings.IncreaseDelayFrames) {
+            m_framesBelowIncreaseThreshold = 0;
+            SetScale(std::min(targetScale, m_scale + m_settings.MaxIncreaseStep));
+        }
+    } else {
+        m_framesBelowIncreaseThreshold = 0;
+    }
+
+    m_lastReport.Scale = m_scale;
+    m_lastReport.Utilization = m_utilization;
+    return m_scale;
+}
+
+void engine::ResolutionController::Reset() {
+    m_scale = m_settings.MaxScale;
+    m_utilization = 0;
+    m_hasUtilization = false;
+    m_framesBelowIncreaseThreshold = 0;
+    m_lastReport = {};
+    m_lastReport.Scale = m_scale;
+}
+
+void engine::ResolutionController::SetScale(float scale) {
+    scale = std::clamp(scale, m_settings.MinScale, m_settings.MaxScale);
+    if (scale != m_scale) {
+        // Predict the utilization at the new scale, so frames rendered at the old scale don't trigger another adjustment.
+        const float ratio = scale / m_scale;
+        m_utilization *= ratio * ratio;
+        m_scale = scale;
+    }
+}
@@ -0,0 +1,84 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include <openxr/openxr.h>
+
+namespace engine {
+
+    struct ResolutionControllerSettings {
+        float MinScale{0.5f};
+        float MaxScale{1.0f};
+
+        // The fraction of the display period a frame should take. Every adjustment aims the scale at this utilization.
+        float TargetUtilization{0.8f};
+
+        // The scale is lowered as soon as the smoothed utilization rises above DecreaseThreshold, and raised only after it stayed
+        // below IncreaseThreshold for IncreaseDelayFrames frames in a row. The gap between the two keeps the scale from oscillating.
+        float DecreaseThreshold{0.9f};
+        float IncreaseThreshold{0.7f};
+        uint32_t IncreaseDelayFrames{30};
+
+        // The largest increase of the scale per adjustment, so the scale approaches the limit of the GPU gradually.
+        float MaxIncreaseStep{0.05f};
+
+        // The weight of the newest frame in the smoothed utilization.
+        float Smoothing{0.2f};
+    };
+
+    // The scale chosen after a frame, and the measurements it was chosen from.
+    struct ResolutionReport {
+        uint64_t FrameIndex{0};
+        float Scale{1};
+        float Utilization{0};         // Smoothed frame duration over the display period
+        XrDuration FrameDuration{0};  // The slowest stage of the frame, as passed to ResolutionController::Update
+        XrDuration DisplayPeriod{0};
+    };
+
+    // Chooses the render resolution scale from measured frame durations.
+    //
+    // The scale applies to both dimensions of the viewport, so the pixel count and roughly the GPU cost of a frame grow with its square.
+    // When the scale changes, the smoothed utilization is rescaled by the same estimate, so the next frames are not judged against
+    // measurements taken at the previous scale. The controller holds no graphics state, so it can be driven by synthetic traces.
+    class ResolutionController {
+    public:
+        explicit ResolutionController(const ResolutionControllerSettings& settings = {});
+
+        // Feeds the duration of one frame, the slowest of its CPU and GPU stages, and returns the scale for the next frame.
+        float Update(XrDuration frameDuration, XrDuration displayPeriod);
+
+        float Scale() const {
+            return m_scale;
+        }
+
+        const ResolutionReport& LastReport() const {
+            return m_lastReport;
+        }
+
+        void Reset();
+
+    private:
+        void SetScale(float scale);
+
+        ResolutionControllerSettings m_settings;
+        float m_scale;
+        float m_utilization{0};
+        bool m_hasUtilization{false};
+        uint32_t m_framesBelowIncreaseThreshold{0};
+        ResolutionReport m_lastReport;
+    };
+} // namespace engine
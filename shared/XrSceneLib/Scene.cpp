@@ -29,12 +29,15 @@ namespace {
         }
     }
 
+    // Returns whether any object was removed.
     template <typename T>
-    void RemoveDestroyedObjects(std::vector<std::shared_ptr<T>>* objects) {
+    bool RemoveDestroyedObjects(std::vector<std::shared_ptr<T>>* objects) {
         auto newEnd = std::remove_if(
             objects->begin(), objects->end(), [](auto&& object) { return object->State == engine::ObjectState::RemovePending; });
 
+        const bool removed = newEnd != objects->end();
         objects->erase(newEnd, objects->end());
+        return removed;
     }
 
     template <typename T>
@@ -52,6 +55,18 @@ namespace {
             }
         }
     }
+
+    template <typename T>
+    void RenderObjectsForViews(std::vector<std::shared_ptr<T>> const& objects, engine::Context& context, uint32_t viewMask) {
+        for (const auto& object : objects) {
+            const uint32_t objectViewMask = object->VisibleViewMask() & viewMask;
+            if (objectViewMask != 0) {
+                context.PbrResources.SetViewMask(objectViewMask);
+                object->Render(context);
+            }
+        }
+        context.PbrResources.SetViewMask(viewMask);
+    }
 } // namespace
 
 engine::Scene::Scene(engine::Context& context)
@@ -67,7 +82,10 @@ void engine::Scene::Update(const engine::FrameTime& frameTime) {
     AddPendingObjects(&m_objects, std::move(uninitializedObjects));
     AddPendingObjects(&m_quadLayerObjects, std::move(uninitializedQuadLayerObjects));
 
-    RemoveDestroyedObjects(&m_objects);
+    if (RemoveDestroyedObjects(&m_objects)) {
+        // The models of the removed objects may have held the last references to cached materials and textures.
+        m_context.PbrResources.GetAssetCache().Trim();
+    }
     RemoveDestroyedObjects(&m_quadLayerObjects);
 
     UpdateObjects(m_objects, m_context, frameTime);
@@ -82,3 +100,11 @@ void engine::Scene::Render(const FrameTime& frameTime, uint32_t viewIndex) {
 
     OnRender(frameTime);
 }
+
+void engine::Scene::RenderViews(const FrameTime& frameTime, uint32_t viewCount) {
+    const uint32_t viewMask = (1u << viewCount) - 1;
+    RenderObjectsForViews(m_objects, m_context, viewMask);
+    RenderObjectsForViews(m_quadLayerObjects, m_context, viewMask);
+
+    OnRender(frameTime);
+}
@@ -36,6 +36,10 @@ namespace engine {
         void Update(const FrameTime& frameTime);
         void Render(const FrameTime& frameTime, uint32_t viewIndex);
 
+        // Renders all views in a single pass after Pbr::Resources::SetViewProjections, drawing each object once for the views
+        // it is visible in. OnRender is called once for all views.
+        void RenderViews(const FrameTime& frameTime, uint32_t viewCount);
+
         // Active is true when the scene participates update and render loop.
         bool IsActive() const {
             return m_isActive;
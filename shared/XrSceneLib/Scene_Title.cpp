@@ -15,7 +15,7 @@
 //*********************************************************
 #include "pch.h"
 #include "PbrModelObject.h"
-#include "TextTexture.h"
+#include "TextRenderer.h"
 #include "Scene.h"
 
 using namespace DirectX;
@@ -42,41 +42,42 @@ namespace {
             const auto& material = Pbr::Material::CreateFlat(m_context.PbrResources, Pbr::FromSRGB(Colors::DarkGray));
             m_background = AddObject(engine::CreateQuad(m_context.PbrResources, {titleWidth, titleHeight}, material));
             m_background->SetVisible(false);
+            m_background->SetHeadLocked(true); // Posed from the view every frame, so it follows late-latched views too.
 
-            engine::TextTextureInfo textInfo{256, 128}; // pixels
-            textInfo.Foreground = Pbr::RGBA::White;
-            textInfo.Background = Pbr::FromSRGB(Colors::DarkSlateBlue);
-            textInfo.Margin = 5; // pixels
-            textInfo.TextAlignment = DWRITE_TEXT_ALIGNMENT_LEADING;
-            textInfo.ParagraphAlignment = DWRITE_PARAGRAPH_ALIGNMENT_NEAR;
+            // Both text blocks are labels of one renderer, drawn with one draw call from a shared glyph atlas.
+            auto atlas = std::make_shared<engine::TextAtlas>(m_context, 512, 256);
+            const engine::FontId titleFont = atlas->AddFont(L"Segoe UI", 16.0f);
+            const engine::FontId subtitleFont = atlas->AddFont(L"Segoe UI", 10.0f);
+            m_text = AddObject(std::make_shared<engine::TextRenderer>(std::move(atlas)));
+            m_text->SetParent(m_background);
 
-            auto placeTextBlock = [&](TextBlock& block, float top, float blockHeight) {
-                textInfo.Height = (uint32_t)std::floor(blockHeight * textInfo.Width / titleWidth); // Keep texture aspect ratio
-                auto textTexture = std::make_unique<engine::TextTexture>(m_context, textInfo);
-                textTexture->Draw(block.Text.c_str());
-                const auto& material = textTexture->CreatePbrMaterial(m_context.PbrResources);
-                block.Object = AddObject(engine::CreateQuad(m_context.PbrResources, {titleWidth, blockHeight}, material));
-                block.Object->Pose() = Pose::Translation({0, (titleHeight / 2) - top - (blockHeight / 2), margin});
-                block.Object->SetParent(m_background);
+            constexpr float pixelsPerMeter = 256 / titleWidth;
+            auto placeTextBlock = [&](std::wstring_view text, engine::FontId font, float top, float blockHeight) {
+                engine::TextLabelInfo textInfo({titleWidth, blockHeight}, pixelsPerMeter, font);
+                textInfo.Foreground = Pbr::RGBA::White;
+                textInfo.Background = Pbr::FromSRGB(Colors::DarkSlateBlue);
+                textInfo.Margin = 5; // pixels
+                textInfo.HorizontalAlignment = engine::TextAlignment::Leading;
+                textInfo.VerticalAlignment = engine::ParagraphAlignment::Near;
+
+                std::shared_ptr<engine::TextLabel> label = m_text->CreateLabel(textInfo, text);
+                label->SetPose(Pose::Translation({0, (titleHeight / 2) - top - (blockHeight / 2), margin}));
+                return label;
             };
 
-            m_title.Text =
-                fmt::format(L"{}, v{}", xr::utf8_to_wide(m_context.Instance.AppInfo.Name), m_context.Instance.AppInfo.Version)
-                    .c_str();
-            textInfo.FontSize = 16.0f;
-            placeTextBlock(m_title, margin, titleHeight / 2 - margin * 2);
+            const std::wstring title =
+                fmt::format(L"{}, v{}", xr::utf8_to_wide(m_context.Instance.AppInfo.Name), m_context.Instance.AppInfo.Version);
+            m_title = placeTextBlock(title, titleFont, margin, titleHeight / 2 - margin * 2);
 
-            m_subtitle.Text = fmt::format(L"OpenXR API version: {}.{}.{}\n{}, v{}.{}.{}",
-                                          XR_VERSION_MAJOR(XR_CURRENT_API_VERSION),
-                                          XR_VERSION_MINOR(XR_CURRENT_API_VERSION),
-                                          XR_VERSION_PATCH(XR_CURRENT_API_VERSION),
-                                          xr::utf8_to_wide(m_context.Instance.Properties.runtimeName),
-                                          XR_VERSION_MAJOR(m_context.Instance.Properties.runtimeVersion),
-                                          XR_VERSION_MINOR(m_context.Instance.Properties.runtimeVersion),
-                                          XR_VERSION_PATCH(m_context.Instance.Properties.runtimeVersion))
-                                  .c_str();
-            textInfo.FontSize = 10.0f;
-            placeTextBlock(m_subtitle, titleHeight / 2, titleHeight / 2 - margin);
+            const std::wstring subtitle = fmt::format(L"OpenXR API version: {}.{}.{}\n{}, v{}.{}.{}",
+                                                      XR_VERSION_MAJOR(XR_CURRENT_API_VERSION),
+                                                      XR_VERSION_MINOR(XR_CURRENT_API_VERSION),
+                                                      XR_VERSION_PATCH(XR_CURRENT_API_VERSION),
+                                                      xr::utf8_to_wide(m_context.Instance.Properties.runtimeName),
+                                                      XR_VERSION_MAJOR(m_context.Instance.Properties.runtimeVersion),
+                                                      XR_VERSION_MINOR(m_context.Instance.Properties.runtimeVersion),
+                                                      XR_VERSION_PATCH(m_context.Instance.Properties.runtimeVersion));
+            m_subtitle = placeTextBlock(subtitle, subtitleFont, titleHeight / 2, titleHeight / 2 - margin);
         }
 
         void OnUpdate(const engine::FrameTime& frameTime) override {
@@ -100,15 +101,11 @@ namespace {
         }
 
     private:
-        struct TextBlock {
-            std::wstring Text;
-            std::shared_ptr<engine::PbrModelObject> Object;
-        };
-
         xr::SpaceHandle m_viewSpace;
         std::shared_ptr<engine::PbrModelObject> m_background;
-        TextBlock m_title;
-        TextBlock m_subtitle;
+        std::shared_ptr<engine::TextRenderer> m_text;
+        std::shared_ptr<engine::TextLabel> m_title;
+        std::shared_ptr<engine::TextLabel> m_subtitle;
         XrPosef m_targetPose;
     };
 } // namespace
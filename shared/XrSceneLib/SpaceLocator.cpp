@@ -0,0 +1,176 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include "pch.h"
+#include "SpaceLocator.h"
+
+engine::SpaceLocator::Registration::Registration(Registration&& other) noexcept
+    : m_locator(std::exchange(other.m_locator, nullptr))
+    , m_index(other.m_index) {
+}
+
+engine::SpaceLocator::Registration& engine::SpaceLocator::Registration::operator=(Registration&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        m_locator = std::exchange(other.m_locator, nullptr);
+        m_index = other.m_index;
+    }
+    return *this;
+}
+
+engine::SpaceLocator::Registration::~Registration() {
+    Reset();
+}
+
+void engine::SpaceLocator::Registration::Reset() {
+    if (m_locator != nullptr) {
+        std::exchange(m_locator, nullptr)->Unregister(m_index);
+    }
+}
+
+engine::SpaceLocator::Registration engine::SpaceLocator::Register(XrSpace space, XrSpace baseSpace) {
+    assert(space != XR_NULL_HANDLE && baseSpace != XR_NULL_HANDLE);
+
+    std::scoped_lock lock(m_mutex);
+    const auto [it, inserted] = m_pairIndices.try_emplace(SpacePair{space, baseSpace}, 0);
+    if (!inserted) {
+        m_referenceCounts[it->second]++;
+        return Registration(this, it->second);
+    }
+
+    uint32_t index;
+    if (!m_freeIndices.empty()) {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+        m_spaces[index] = space;
+        m_baseSpaces[index] = baseSpace;
+        m_referenceCounts[index] = 1;
+    } else {
+        index = static_cast<uint32_t>(m_spaces.size());
+        m_spaces.push_back(space);
+        m_baseSpaces.push_back(baseSpace);
+        m_referenceCounts.push_back(1);
+    }
+    it->second = index;
+
+    // A reused index may still hold the locations of the pair that was registered before.
+    for (TimeSlot& slot : m_timeSlots) {
+        if (index < slot.Located.size()) {
+            slot.Located[index] = false;
+        }
+    }
+
+    return Registration(this, index);
+}
+
+void engine::SpaceLocator::Unregister(uint32_t index) {
+    std::scoped_lock lock(m_mutex);
+    assert(m_referenceCounts[index] > 0);
+    if (--m_referenceCounts[index] == 0) {
+        m_pairIndices.erase(SpacePair{m_spaces[index], m_baseSpaces[index]});
+        m_spaces[index] = XR_NULL_HANDLE;
+        m_baseSpaces[index] = XR_NULL_HANDLE;
+        m_freeIndices.push_back(index);
+    }
+}
+
+void engine::SpaceLocator::LocateAll(XrTime time) {
+    std::scoped_lock lock(m_mutex);
+    TimeSlot& slot = AcquireSlot(time);
+    for (uint32_t index = 0; index < m_spaces.size(); index++) {
+        if (m_referenceCounts[index] > 0) {
+            LocateRegistered(slot, index);
+        }
+    }
+}
+
+XrSpaceLocation engine::SpaceLocator::Location(const Registration& registration, XrTime time) {
+    assert(registration.m_locator == this);
+
+    std::scoped_lock lock(m_mutex);
+    return LocateRegistered(AcquireSlot(time), registration.m_index);
+}
+
+XrSpaceLocation engine::SpaceLocator::Locate(XrSpace space, XrSpace baseSpace, XrTime time) {
+    std::scoped_lock lock(m_mutex);
+    TimeSlot& slot = AcquireSlot(time);
+
+    const SpacePair pair{space, baseSpace};
+    if (const auto it = m_pairIndices.find(pair); it != m_pairIndices.end()) {
+        return LocateRegistered(slot, it->second);
+    }
+
+    for (const UnregisteredLocation& unregistered : slot.UnregisteredLocations) {
+        if (unregistered.Pair == pair) {
+            return unregistered.Location;
+        }
+    }
+
+    return slot.UnregisteredLocations.emplace_back(UnregisteredLocation{pair, LocateWithRuntime(space, baseSpace, time)}).Location;
+}
+
+uint32_t engine::SpaceLocator::RegisteredCount() const {
+    std::scoped_lock lock(m_mutex);
+    return static_cast<uint32_t>(m_pairIndices.size());
+}
+
+uint64_t engine::SpaceLocator::RuntimeCallCount() const {
+    std::scoped_lock lock(m_mutex);
+    return m_runtimeCallCount;
+}
+
+engine::SpaceLocator::TimeSlot& engine::SpaceLocator::AcquireSlot(XrTime time) {
+    TimeSlot* leastRecentlyUsed = &m_timeSlots[0];
+    for (TimeSlot& slot : m_timeSlots) {
+        if (slot.LastUse != 0 && slot.Time == time) {
+            slot.LastUse = ++m_useCounter;
+            return slot;
+        }
+        if (slot.LastUse < leastRecentlyUsed->LastUse) {
+            leastRecentlyUsed = &slot;
+        }
+    }
+
+    // Reuse the storage of the least recently used time. The vectors keep their capacity, so a steady frame loop doesn't allocate.
+    TimeSlot& slot = *leastRecentlyUsed;
+    slot.Time = time;
+    slot.LastUse = ++m_useCounter;
+    slot.Located.assign(m_spaces.size(), false);
+    slot.Locations.resize(m_spaces.size());
+    slot.UnregisteredLocations.clear();
+    return slot;
+}
+
+const XrSpaceLocation& engine::SpaceLocator::LocateRegistered(TimeSlot& slot, uint32_t index) {
+    if (slot.Located.size() < m_spaces.size()) {
+        // Pairs were registered after the slot was acquired.
+        slot.Located.resize(m_spaces.size(), false);
+        slot.Locations.resize(m_spaces.size());
+    }
+
+    if (!slot.Located[index]) {
+        slot.Locations[index] = LocateWithRuntime(m_spaces[index], m_baseSpaces[index], slot.Time);
+        slot.Located[index] = true;
+    }
+    return slot.Locations[index];
+}
+
+XrSpaceLocation engine::SpaceLocator::LocateWithRuntime(XrSpace space, XrSpace baseSpace, XrTime time) {
+    // There is no batched locate function in the OpenXR version this engine builds against, so the batch is one call per unique pair.
+    XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
+    CHECK_XRCMD(xrLocateSpace(space, baseSpace, time, &location));
+    m_runtimeCallCount++;
+    return location;
+}
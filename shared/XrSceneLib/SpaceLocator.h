@@ -0,0 +1,136 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+namespace engine {
+
+    // Locates spaces on behalf of the objects and scenes of the engine.
+    //
+    // Objects register the (space, base space) pairs they need every frame, and LocateAll resolves all registered pairs for a display
+    // time in a single pass, so the runtime is called once per unique pair no matter how many objects share it.
+    // Results are memoized per (space, base space, time). Reading a pair that was already located for the same time, registered or not,
+    // does not call the runtime again. The locations of the last few display times are kept, so the render thread can read the frame
+    // it is rendering while the update thread locates the next one.
+    // All methods are thread-safe.
+    class SpaceLocator {
+    public:
+        // Keeps a pair registered until it is destroyed or reset.
+        class Registration {
+        public:
+            Registration() = default;
+            Registration(Registration&& other) noexcept;
+            Registration& operator=(Registration&& other) noexcept;
+            ~Registration();
+
+            Registration(const Registration&) = delete;
+            Registration& operator=(const Registration&) = delete;
+
+            void Reset();
+
+            explicit operator bool() const {
+                return m_locator != nullptr;
+            }
+
+        private:
+            friend class SpaceLocator;
+            Registration(SpaceLocator* locator, uint32_t index)
+                : m_locator(locator)
+                , m_index(index) {
+            }
+
+            SpaceLocator* m_locator{nullptr};
+            uint32_t m_index{0};
+        };
+
+        SpaceLocator() = default;
+        SpaceLocator(const SpaceLocator&) = delete;
+        SpaceLocator& operator=(const SpaceLocator&) = delete;
+
+        // Registers the pair to be located by LocateAll. Registering a pair that is already registered shares its entry.
+        // The registration must be released before either space is destroyed.
+        Registration Register(XrSpace space, XrSpace baseSpace);
+
+        // Locates all registered pairs for the given time. XrApp calls this once per frame with the predicted display time.
+        void LocateAll(XrTime time);
+
+        // Returns the location of a registered pair, locating it first if LocateAll didn't cover the time.
+        XrSpaceLocation Location(const Registration& registration, XrTime time);
+
+        // Returns the location of any pair, memoized for the time like the registered pairs.
+        XrSpaceLocation Locate(XrSpace space, XrSpace baseSpace, XrTime time);
+
+        uint32_t RegisteredCount() const;
+
+        // The number of xrLocateSpace calls made so far, for comparing against the number of locations read.
+        uint64_t RuntimeCallCount() const;
+
+    private:
+        struct SpacePair {
+            XrSpace Space;
+            XrSpace BaseSpace;
+
+            bool operator==(const SpacePair& other) const {
+                return Space == other.Space && BaseSpace == other.BaseSpace;
+            }
+        };
+
+        struct PairHash {
+            size_t operator()(const SpacePair& pair) const {
+                const size_t spaceHash = std::hash<XrSpace>{}(pair.Space);
+                return spaceHash ^ (std::hash<XrSpace>{}(pair.BaseSpace) + 0x9e3779b9 + (spaceHash << 6) + (spaceHash >> 2));
+            }
+        };
+
+        struct UnregisteredLocation {
+            SpacePair Pair;
+            XrSpaceLocation Location;
+        };
+
+        // The locations of all registered pairs for one display time, indexed like the registered pairs.
+        struct TimeSlot {
+            XrTime Time{0};
+            uint64_t LastUse{0};
+            std::vector<XrSpaceLocation> Locations;
+            std::vector<bool> Located;
+            std::vector<UnregisteredLocation> UnregisteredLocations;
+        };
+
+        void Unregister(uint32_t index);
+        TimeSlot& AcquireSlot(XrTime time);
+        const XrSpaceLocation& LocateRegistered(TimeSlot& slot, uint32_t index);
+        XrSpaceLocation LocateWithRuntime(XrSpace space, XrSpace baseSpace, XrTime time);
+
+        // Enough for the frame being updated, the frame being rendered and one occasional query for another time,
+        // such as the time an input was pressed.
+        static constexpr size_t TimeSlotCount = 3;
+
+        mutable std::mutex m_mutex;
+
+        // The registered pairs, stored as parallel arrays so LocateAll walks them contiguously.
+        std::vector<XrSpace> m_spaces;
+        std::vector<XrSpace> m_baseSpaces;
+        std::vector<uint32_t> m_referenceCounts;
+        std::vector<uint32_t> m_freeIndices;
+        std::unordered_map<SpacePair, uint32_t, PairHash> m_pairIndices;
+
+        std::array<TimeSlot, TimeSlotCount> m_timeSlots;
+        uint64_t m_useCounter{0};
+        uint64_t m_runtimeCallCount{0};
+    };
+} // namespace engine
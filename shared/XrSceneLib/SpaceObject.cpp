@@ -23,8 +23,12 @@ engine::SpaceObject::SpaceObject(xr::SpaceHandle space, bool hideWhenPoseInvalid
 }
 
 void engine::SpaceObject::Update(engine::Context& context, const engine::FrameTime& frameTime) {
-    XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
-    CHECK_XRCMD(xrLocateSpace(m_space.Get(), context.SceneSpace, frameTime.PredictedDisplayTime, &location));
+    if (!m_spaceInScene) {
+        // Registered on the first update, so it is included in the batched locate of the following frames.
+        m_spaceInScene = context.Spaces.Register(m_space.Get(), context.SceneSpace);
+    }
+
+    const XrSpaceLocation location = context.Spaces.Location(m_spaceInScene, frameTime.PredictedDisplayTime);
     const bool poseValid = xr::math::Pose::IsPoseValid(location);
     if (poseValid) {
         Pose() = location.pose;
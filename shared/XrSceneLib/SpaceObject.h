@@ -27,6 +27,7 @@ namespace engine {
 
     private:
         xr::SpaceHandle m_space;
+        SpaceLocator::Registration m_spaceInScene; // Declared after m_space to be released before the space is destroyed.
         const bool m_hideWhenPoseInvalid;
     };
 } // namespace engine
@@ -0,0 +1,266 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+// No precompiled header, so the layout also builds in the portable unit tests.
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include "TextLayout.h"
+
+namespace {
+    // The side of the block of full coverage reserved for backgrounds. Only its inner pixels are sampled, so that filtering
+    // at the edges of a background doesn't reach the padding.
+    constexpr uint32_t SolidBlockSize = 4;
+
+    constexpr size_t NoBreak = static_cast<size_t>(-1);
+
+    bool IsHighSurrogate(char32_t c) {
+        return c >= 0xD800 && c <= 0xDBFF;
+    }
+
+    bool IsLowSurrogate(char32_t c) {
+        return c >= 0xDC00 && c <= 0xDFFF;
+    }
+
+    // Decodes the code point at the position, which is UTF-16 where wchar_t has 16 bits, and advances the position past it.
+    char32_t NextCodePoint(std::wstring_view text, size_t& position) {
+        const char32_t c = static_cast<char32_t>(text[position++]);
+        if (IsHighSurrogate(c) && position < text.size() && IsLowSurrogate(static_cast<char32_t>(text[position]))) {
+            const char32_t low = static_cast<char32_t>(text[position++]);
+            return 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+        }
+        return c;
+    }
+
+    void OffsetQuads(std::vector<engine::GlyphQuad>& quads, size_t first, size_t last, float x, float y) {
+        for (size_t i = first; i < last; i++) {
+            quads[i].Left += x;
+            quads[i].Right += x;
+            quads[i].Top += y;
+            quads[i].Bottom += y;
+        }
+    }
+} // namespace
+
+engine::GlyphAtlas::GlyphAtlas(uint32_t width, uint32_t height, uint32_t padding)
+    : m_width(width)
+    , m_height(height)
+    , m_padding(padding)
+    , m_pixels(static_cast<size_t>(width) * height) {
+    Clear();
+}
+
+engine::FontId engine::GlyphAtlas::AddFont(std::shared_ptr<GlyphRasterizer> rasterizer) {
+    m_fontMetrics.push_back(rasterizer->Metrics());
+    m_fonts.push_back(std::move(rasterizer));
+    return static_cast<FontId>(m_fonts.size() - 1);
+}
+
+const engine::FontMetrics& engine::GlyphAtlas::Metrics(FontId font) const {
+    return m_fontMetrics.at(font);
+}
+
+const engine::AtlasGlyph* engine::GlyphAtlas::FindOrAddGlyph(FontId font, char32_t codePoint) {
+    const auto key = std::make_pair(font, codePoint);
+    const auto it = m_glyphs.find(key);
+    if (it != m_glyphs.end()) {
+        return &it->second;
+    }
+
+    AtlasGlyph glyph;
+    m_coverage.clear();
+    if (!m_fonts.at(font)->Rasterize(codePoint, glyph.Metrics, m_coverage)) {
+        glyph.Metrics = {};
+    }
+
+    if (glyph.Metrics.Width > 0 && glyph.Metrics.Height > 0) {
+        if (!Allocate(glyph.Metrics.Width, glyph.Metrics.Height, glyph.Rect)) {
+            return nullptr;
+        }
+
+        for (uint32_t row = 0; row < glyph.Metrics.Height; row++) {
+            memcpy(&m_pixels[static_cast<size_t>(glyph.Rect.Top + row) * m_width + glyph.Rect.Left],
+                   &m_coverage[static_cast<size_t>(row) * glyph.Metrics.Width],
+                   glyph.Metrics.Width);
+        }
+        MarkDirty(glyph.Rect);
+    }
+
+    return &m_glyphs.emplace(key, glyph).first->second;
+}
+
+void engine::GlyphAtlas::Clear() {
+    m_glyphs.clear();
+    m_shelves.clear();
+    m_shelvesBottom = 0;
+    m_generation++;
+
+    std::fill(m_pixels.begin(), m_pixels.end(), uint8_t{0});
+    MarkDirty({0, 0, m_width, m_height});
+
+    AtlasRect solidBlock;
+    [[maybe_unused]] const bool allocated = Allocate(SolidBlockSize, SolidBlockSize, solidBlock);
+    assert(allocated);
+    for (uint32_t row = solidBlock.Top; row < solidBlock.Bottom; row++) {
+        std::fill_n(&m_pixels[static_cast<size_t>(row) * m_width + solidBlock.Left], SolidBlockSize, uint8_t{255});
+    }
+    m_solidRect = {solidBlock.Left + 1, solidBlock.Top + 1, solidBlock.Right - 1, solidBlock.Bottom - 1};
+}
+
+std::optional<engine::AtlasRect> engine::GlyphAtlas::TakeDirtyRect() {
+    return std::exchange(m_dirtyRect, std::nullopt);
+}
+
+bool engine::GlyphAtlas::Allocate(uint32_t width, uint32_t height, AtlasRect& rect) {
+    const uint32_t paddedWidth = width + 2 * m_padding;
+    const uint32_t paddedHeight = height + 2 * m_padding;
+    if (paddedWidth > m_width) {
+        return false;
+    }
+
+    // The row wasting the least height, unless it's more than twice as high as the glyph and a new row still fits.
+    Shelf* shelf = nullptr;
+    for (Shelf& candidate : m_shelves) {
+        if (candidate.Height >= paddedHeight && candidate.Used + paddedWidth <= m_width &&
+            (shelf == nullptr || candidate.Height < shelf->Height)) {
+            shelf = &candidate;
+        }
+    }
+
+    const bool newShelfFits = m_shelvesBottom + paddedHeight <= m_height;
+    if (newShelfFits && (shelf == nullptr || shelf->Height > 2 * paddedHeight)) {
+        shelf = &m_shelves.emplace_back(Shelf{m_shelvesBottom, paddedHeight, 0});
+        m_shelvesBottom += paddedHeight;
+    }
+    if (shelf == nullptr) {
+        return false;
+    }
+
+    rect.Left = shelf->Used + m_padding;
+    rect.Top = shelf->Top + m_padding;
+    rect.Right = rect.Left + width;
+    rect.Bottom = rect.Top + height;
+    shelf->Used += paddedWidth;
+    return true;
+}
+
+void engine::GlyphAtlas::MarkDirty(const AtlasRect& rect) {
+    if (!m_dirtyRect) {
+        m_dirtyRect = rect;
+        return;
+    }
+
+    m_dirtyRect->Left = std::min(m_dirtyRect->Left, rect.Left);
+    m_dirtyRect->Top = std::min(m_dirtyRect->Top, rect.Top);
+    m_dirtyRect->Right = std::max(m_dirtyRect->Right, rect.Right);
+    m_dirtyRect->Bottom = std::max(m_dirtyRect->Bottom, rect.Bottom);
+}
+
+bool engine::LayoutText(
+    std::wstring_view text, FontId font, const TextLayoutOptions& options, GlyphAtlas& atlas, std::vector<GlyphQuad>& quads) {
+    quads.clear();
+
+    const FontMetrics& metrics = atlas.Metrics(font);
+    const float lineHeight = metrics.LineHeight();
+
+    bool complete = true;
+    float penX = 0;
+    float baseline = metrics.Ascent;
+    uint32_t lineCount = 1;
+
+    // The line being laid out: its first quad, and its width up to the last glyph with an advance, without trailing spaces.
+    size_t lineFirstQuad = 0;
+    float lineWidth = 0;
+
+    // The last place the line can be wrapped at: after a run of spaces, where the next word starts.
+    size_t breakQuad = NoBreak;
+    float breakX = 0;
+    float breakLineWidth = 0;
+
+    const auto finishLine = [&](size_t lastQuad, float width) {
+        float offset = 0;
+        if (options.Width > 0 && options.HorizontalAlignment == TextAlignment::Center) {
+            offset = (options.Width - width) / 2;
+        } else if (options.Width > 0 && options.HorizontalAlignment == TextAlignment::Trailing) {
+            offset = options.Width - width;
+        }
+        OffsetQuads(quads, lineFirstQuad, lastQuad, offset, 0);
+    };
+
+    for (size_t position = 0; position < text.size();) {
+        const char32_t codePoint = NextCodePoint(text, position);
+        if (codePoint == U'\r') {
+            continue;
+        }
+        if (codePoint == U'\n') {
+            finishLine(quads.size(), lineWidth);
+            lineFirstQuad = quads.size();
+            lineWidth = penX = 0;
+            baseline += lineHeight;
+            lineCount++;
+            breakQuad = NoBreak;
+            continue;
+        }
+
+        const AtlasGlyph* glyph = atlas.FindOrAddGlyph(font, codePoint);
+        if (glyph == nullptr) {
+            complete = false;
+            continue;
+        }
+
+        if (codePoint == U' ' || codePoint == U'\t') {
+            penX += glyph->Metrics.Advance;
+            breakQuad = quads.size();
+            breakX = penX;
+            breakLineWidth = lineWidth;
+            continue;
+        }
+
+        // Wrap the word being laid out to the next line, unless the line has no other word.
+        if (options.Width > 0 && penX + glyph->Metrics.Advance > options.Width && breakQuad != NoBreak && breakLineWidth > 0) {
+            finishLine(breakQuad, breakLineWidth);
+            OffsetQuads(quads, breakQuad, quads.size(), -breakX, lineHeight);
+            lineFirstQuad = breakQuad;
+            penX -= breakX;
+            lineWidth = penX;
+            baseline += lineHeight;
+            lineCount++;
+            breakQuad = NoBreak;
+        }
+
+        if (!glyph->Rect.IsEmpty()) {
+            GlyphQuad& quad = quads.emplace_back();
+            quad.Left = penX + glyph->Metrics.OffsetX;
+            quad.Top = baseline + glyph->Metrics.OffsetY;
+            quad.Right = quad.Left + glyph->Metrics.Width;
+            quad.Bottom = quad.Top + glyph->Metrics.Height;
+            quad.Rect = glyph->Rect;
+        }
+        penX += glyph->Metrics.Advance;
+        lineWidth = penX;
+    }
+    finishLine(quads.size(), lineWidth);
+
+    const float textHeight = lineCount * lineHeight;
+    float offset = 0;
+    if (options.Height > 0 && options.VerticalAlignment == ParagraphAlignment::Center) {
+        offset = (options.Height - textHeight) / 2;
+    } else if (options.Height > 0 && options.VerticalAlignment == ParagraphAlignment::Far) {
+        offset = options.Height - textHeight;
+    }
+    OffsetQuads(quads, 0, quads.size(), 0, offset);
+
+    return complete;
+}
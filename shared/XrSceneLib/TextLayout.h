@@ -0,0 +1,174 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace engine {
+    using FontId = uint32_t;
+
+    // The metrics of a glyph, in pixels. The bitmap of the glyph is placed at the offset from the pen position on the baseline,
+    // with y pointing down.
+    struct GlyphMetrics {
+        float Advance{0};
+        int32_t OffsetX{0};
+        int32_t OffsetY{0};
+        uint32_t Width{0};
+        uint32_t Height{0};
+    };
+
+    // The vertical metrics of a font, in pixels.
+    struct FontMetrics {
+        float Ascent{0};  // Above the baseline
+        float Descent{0}; // Below the baseline
+        float LineGap{0};
+
+        float LineHeight() const {
+            return Ascent + Descent + LineGap;
+        }
+    };
+
+    // Rasterizes the glyphs of a font at one size on the CPU, into coverage bitmaps of one byte per pixel.
+    class GlyphRasterizer {
+    public:
+        virtual ~GlyphRasterizer() = default;
+
+        virtual FontMetrics Metrics() const = 0;
+
+        // Rasterizes the glyph of the code point into Width * Height bytes of coverage, row by row. Returns false if the font
+        // has no glyph for it.
+        virtual bool Rasterize(char32_t codePoint, GlyphMetrics& metrics, std::vector<uint8_t>& coverage) = 0;
+    };
+
+    // A rectangle of pixels in the atlas, from Left and Top inclusive to Right and Bottom exclusive.
+    struct AtlasRect {
+        uint32_t Left{0};
+        uint32_t Top{0};
+        uint32_t Right{0};
+        uint32_t Bottom{0};
+
+        bool IsEmpty() const {
+            return Right <= Left || Bottom <= Top;
+        }
+    };
+
+    struct AtlasGlyph {
+        GlyphMetrics Metrics;
+        AtlasRect Rect; // Empty for glyphs without pixels, such as spaces
+    };
+
+    // The glyphs of any number of fonts, rasterized the first time they are used and packed into rows of one coverage image.
+    // The changed region of the image is tracked, so that only new glyphs are uploaded to its GPU copy. The atlas holds no
+    // graphics state, so it can be filled by synthetic rasterizers.
+    class GlyphAtlas {
+    public:
+        // The glyphs are separated by padding pixels without coverage, so that filtering doesn't blend neighbouring glyphs.
+        GlyphAtlas(uint32_t width, uint32_t height, uint32_t padding = 1);
+
+        FontId AddFont(std::shared_ptr<GlyphRasterizer> rasterizer);
+        const FontMetrics& Metrics(FontId font) const;
+
+        // Returns the glyph of the code point, rasterizing it into the atlas the first time. Code points the font has no glyph
+        // for have neither pixels nor advance. Returns null if the atlas is full.
+        const AtlasGlyph* FindOrAddGlyph(FontId font, char32_t codePoint);
+
+        // Removes every glyph, when the atlas is full. The text laid out before must be laid out again, which the changed
+        // generation tells.
+        void Clear();
+        uint32_t Generation() const {
+            return m_generation;
+        }
+
+        // Pixels with full coverage, to draw solid backgrounds with the same image as the glyphs.
+        const AtlasRect& SolidRect() const {
+            return m_solidRect;
+        }
+
+        uint32_t Width() const {
+            return m_width;
+        }
+        uint32_t Height() const {
+            return m_height;
+        }
+        const std::vector<uint8_t>& Pixels() const {
+            return m_pixels;
+        }
+
+        // Returns the region changed since the last call, if any, and forgets it.
+        std::optional<AtlasRect> TakeDirtyRect();
+
+    private:
+        struct Shelf {
+            uint32_t Top{0};
+            uint32_t Height{0};
+            uint32_t Used{0};
+        };
+
+        // Reserves the pixels of a glyph and the padding around it.
+        bool Allocate(uint32_t width, uint32_t height, AtlasRect& rect);
+        void MarkDirty(const AtlasRect& rect);
+
+        const uint32_t m_width;
+        const uint32_t m_height;
+        const uint32_t m_padding;
+        std::vector<uint8_t> m_pixels;
+        std::vector<Shelf> m_shelves;
+        uint32_t m_shelvesBottom{0};
+        std::optional<AtlasRect> m_dirtyRect;
+        AtlasRect m_solidRect;
+        uint32_t m_generation{0};
+
+        std::vector<std::shared_ptr<GlyphRasterizer>> m_fonts;
+        std::vector<FontMetrics> m_fontMetrics;
+        std::map<std::pair<FontId, char32_t>, AtlasGlyph> m_glyphs;
+
+        // Reused by every rasterization to avoid allocations.
+        std::vector<uint8_t> m_coverage;
+    };
+
+    enum class TextAlignment { Leading, Center, Trailing };
+    enum class ParagraphAlignment { Near, Center, Far };
+
+    struct TextLayoutOptions {
+        // The box the text is laid out in, in pixels. Lines wider than the box are wrapped at spaces. A width or height of 0
+        // leaves the box unbounded in that direction, and the text aligned to its leading edge or top.
+        float Width{0};
+        float Height{0};
+        TextAlignment HorizontalAlignment{TextAlignment::Leading};
+        ParagraphAlignment VerticalAlignment{ParagraphAlignment::Near};
+    };
+
+    // A glyph placed by the layout: its bounds in pixels from the top left of the box, with y pointing down, and its pixels in
+    // the atlas.
+    struct GlyphQuad {
+        float Left{0};
+        float Top{0};
+        float Right{0};
+        float Bottom{0};
+        AtlasRect Rect;
+    };
+
+    // Lays out the text, where '\n' starts a new line, into the quads of its glyphs, adding the glyphs to the atlas. Glyphs
+    // without pixels get no quad. Returns false if the atlas is full, in which case glyphs are missing from the quads.
+    bool LayoutText(
+        std::wstring_view text, FontId font, const TextLayoutOptions& options, GlyphAtlas& atlas, std::vector<GlyphQuad>& quads);
+} // namespace engine
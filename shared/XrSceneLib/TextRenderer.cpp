@@ -0,0 +1,348 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include "pch.h"
+#include <algorithm>
+#include <pbr/PbrMaterial.h>
+#include "TextRenderer.h"
+
+namespace {
+    constexpr DXGI_FORMAT AtlasFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+    // The quad capacity of the first primitive, which doubles whenever the labels need more.
+    constexpr uint32_t MinQuadCapacity = 256;
+
+    // Rasterizes the glyphs of a font with a DirectWrite glyph run analysis, which renders them with grayscale antialiasing
+    // on the CPU.
+    class DWriteGlyphRasterizer : public engine::GlyphRasterizer {
+    public:
+        DWriteGlyphRasterizer(IDWriteFactory2* dwriteFactory, const wchar_t* fontName, float fontSize, DWRITE_FONT_WEIGHT fontWeight)
+            : m_fontSize(fontSize) {
+            m_dwriteFactory.copy_from(dwriteFactory);
+
+            winrt::com_ptr<IDWriteFontCollection> fontCollection;
+            CHECK_HRCMD(m_dwriteFactory->GetSystemFontCollection(fontCollection.put(), FALSE));
+
+            UINT32 familyIndex = 0;
+            BOOL familyExists = FALSE;
+            CHECK_HRCMD(fontCollection->FindFamilyName(fontName, &familyIndex, &familyExists));
+            CHECK_MSG(familyExists, "The font family is not installed");
+
+            winrt::com_ptr<IDWriteFontFamily> fontFamily;
+            CHECK_HRCMD(fontCollection->GetFontFamily(familyIndex, fontFamily.put()));
+            winrt::com_ptr<IDWriteFont> font;
+            CHECK_HRCMD(fontFamily->GetFirstMatchingFont(fontWeight, DWRITE_FONT_STRETCH_NORMAL, DWRITE_FONT_STYLE_NORMAL, font.put()));
+            CHECK_HRCMD(font->CreateFontFace(m_fontFace.put()));
+
+            m_fontFace->GetMetrics(&m_fontMetrics);
+            m_designUnitScale = m_fontSize / m_fontMetrics.designUnitsPerEm;
+        }
+
+        engine::FontMetrics Metrics() const override {
+            engine::FontMetrics metrics;
+            metrics.Ascent = m_fontMetrics.ascent * m_designUnitScale;
+            metrics.Descent = m_fontMetrics.descent * m_designUnitScale;
+            metrics.LineGap = m_fontMetrics.lineGap * m_designUnitScale;
+            return metrics;
+        }
+
+        bool Rasterize(char32_t codePoint, engine::GlyphMetrics& metrics, std::vector<uint8_t>& coverage) override {
+            const UINT32 codePoints[] = {static_cast<UINT32>(codePoint)};
+            UINT16 glyphIndex = 0;
+            CHECK_HRCMD(m_fontFace->GetGlyphIndices(codePoints, 1, &glyphIndex));
+            if (glyphIndex == 0) {
+                return false;
+            }
+
+            DWRITE_GLYPH_METRICS glyphMetrics{};
+            CHECK_HRCMD(m_fontFace->GetDesignGlyphMetrics(&glyphIndex, 1, &glyphMetrics, FALSE));
+            metrics.Advance = glyphMetrics.advanceWidth * m_designUnitScale;
+
+            DWRITE_GLYPH_RUN glyphRun{};
+            glyphRun.fontFace = m_fontFace.get();
+            glyphRun.fontEmSize = m_fontSize;
+            glyphRun.glyphCount = 1;
+            glyphRun.glyphIndices = &glyphIndex;
+
+            winrt::com_ptr<IDWriteGlyphRunAnalysis> analysis;
+            CHECK_HRCMD(m_dwriteFactory->CreateGlyphRunAnalysis(&glyphRun,
+                                                                nullptr,
+                                                                DWRITE_RENDERING_MODE_NATURAL_SYMMETRIC,
+                                                                DWRITE_MEASURING_MODE_NATURAL,
+                                                                DWRITE_GRID_FIT_MODE_DEFAULT,
+                                                                DWRITE_TEXT_ANTIALIAS_MODE_GRAYSCALE,
+                                                                0,
+                                                                0,
+                                                                analysis.put()));
+
+            // With grayscale antialiasing, the aliased texture holds one byte of coverage per pixel. Its bounds are relative
+            // to the pen position on the baseline.
+            RECT bounds{};
+            CHECK_HRCMD(analysis->GetAlphaTextureBounds(DWRITE_TEXTURE_ALIASED_1x1, &bounds));
+            if (bounds.right <= bounds.left || bounds.bottom <= bounds.top) {
+                return true; // A glyph without pixels, such as a space.
+            }
+
+            metrics.OffsetX = bounds.left;
+            metrics.OffsetY = bounds.top;
+            metrics.Width = static_cast<uint32_t>(bounds.right - bounds.left);
+            metrics.Height = static_cast<uint32_t>(bounds.bottom - bounds.top);
+            coverage.resize(static_cast<size_t>(metrics.Width) * metrics.Height);
+            CHECK_HRCMD(
+                analysis->CreateAlphaTexture(DWRITE_TEXTURE_ALIASED_1x1, &bounds, coverage.data(), static_cast<UINT32>(coverage.size())));
+            return true;
+        }
+
+    private:
+        winrt::com_ptr<IDWriteFactory2> m_dwriteFactory;
+        winrt::com_ptr<IDWriteFontFace> m_fontFace;
+        DWRITE_FONT_METRICS m_fontMetrics{};
+        const float m_fontSize;
+        float m_designUnitScale{1};
+    };
+} // namespace
+
+engine::TextAtlas::TextAtlas(Context& context, uint32_t width, uint32_t height)
+    : m_glyphs(width, height) {
+    CHECK_HRCMD(DWriteCreateFactory(
+        DWRITE_FACTORY_TYPE_SHARED, winrt::guid_of<IDWriteFactory2>(), reinterpret_cast<IUnknown**>(m_dwriteFactory.put_void())));
+
+    ID3D11Device* const device = context.Device.get();
+    const CD3D11_TEXTURE2D_DESC textureDesc(AtlasFormat, width, height, 1, 1, D3D11_BIND_SHADER_RESOURCE);
+    CHECK_HRCMD(device->CreateTexture2D(&textureDesc, nullptr, m_texture.put()));
+
+    winrt::com_ptr<ID3D11ShaderResourceView> textureView;
+    CHECK_HRCMD(device->CreateShaderResourceView(m_texture.get(), nullptr, textureView.put()));
+
+    // The texture is white, with the coverage of the glyphs in alpha, so that the vertex colors color the text.
+    m_material = Pbr::Material::CreateFlat(context.PbrResources, Pbr::RGBA::White);
+    m_material->SetTexture(Pbr::ShaderSlots::BaseColor, textureView.get(), Pbr::Texture::CreateSampler(device).get());
+    m_material->SetAlphaBlended(true);
+}
+
+engine::FontId engine::TextAtlas::AddFont(const wchar_t* fontName, float fontSize, DWRITE_FONT_WEIGHT fontWeight) {
+    return m_glyphs.AddFont(std::make_shared<DWriteGlyphRasterizer>(m_dwriteFactory.get(), fontName, fontSize, fontWeight));
+}
+
+void engine::TextAtlas::Upload(_In_ ID3D11DeviceContext* context) {
+    const std::optional<AtlasRect> dirtyRect = m_glyphs.TakeDirtyRect();
+    if (!dirtyRect) {
+        return;
+    }
+
+    const uint32_t width = dirtyRect->Right - dirtyRect->Left;
+    const uint32_t height = dirtyRect->Bottom - dirtyRect->Top;
+    m_uploadPixels.resize(static_cast<size_t>(width) * height);
+    for (uint32_t row = 0; row < height; row++) {
+        const uint8_t* coverage = &m_glyphs.Pixels()[static_cast<size_t>(dirtyRect->Top + row) * m_glyphs.Width() + dirtyRect->Left];
+        uint32_t* pixels = &m_uploadPixels[static_cast<size_t>(row) * width];
+        for (uint32_t column = 0; column < width; column++) {
+            pixels[column] = 0x00FFFFFF | (static_cast<uint32_t>(coverage[column]) << 24);
+        }
+    }
+
+    const D3D11_BOX box{dirtyRect->Left, dirtyRect->Top, 0, dirtyRect->Right, dirtyRect->Bottom, 1};
+    context->UpdateSubresource(m_texture.get(), 0, &box, m_uploadPixels.data(), width * sizeof(uint32_t), 0);
+}
+
+engine::TextLabel::TextLabel(const TextLabelInfo& info, Pbr::NodeIndex_t node)
+    : m_info(info)
+    , m_node(node) {
+}
+
+void engine::TextLabel::SetText(std::wstring_view text) {
+    if (m_text != text) {
+        m_text.assign(text);
+        m_textChanged = true;
+    }
+}
+
+void engine::TextLabel::SetPose(const XrPosef& pose) {
+    m_pose = pose;
+    m_poseChanged = true;
+}
+
+void engine::TextLabel::SetVisible(bool visible) {
+    if (m_visible != visible) {
+        m_visible = visible;
+        m_visibilityChanged = true;
+    }
+}
+
+engine::TextRenderer::TextRenderer(std::shared_ptr<TextAtlas> atlas)
+    : PbrModelObject(std::make_shared<Pbr::Model>())
+    , m_atlas(std::move(atlas))
+    , m_model(GetModel()) {
+}
+
+std::shared_ptr<engine::TextLabel> engine::TextRenderer::CreateLabel(const TextLabelInfo& info, std::wstring_view text) {
+    Pbr::NodeIndex_t node;
+    if (!m_freeNodes.empty()) {
+        node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    } else {
+        node = m_model->AddNode(DirectX::XMMatrixIdentity(), Pbr::RootNodeIndex);
+    }
+
+    std::shared_ptr<TextLabel> label(new TextLabel(info, node));
+    label->SetText(text);
+    m_labels.push_back(LabelEntry{label, node});
+    return label;
+}
+
+void engine::TextRenderer::Render(Context& context) const {
+    if (!IsVisible()) {
+        return;
+    }
+
+    UpdateLabels(context);
+    PbrModelObject::Render(context);
+}
+
+void engine::TextRenderer::UpdateLabels(Context& context) const {
+    bool quadsChanged = false;
+    for (size_t i = 0; i < m_labels.size();) {
+        if (m_labels[i].Label.expired()) {
+            m_freeNodes.push_back(m_labels[i].Node);
+            m_labels[i] = m_labels.back();
+            m_labels.pop_back();
+            quadsChanged = true;
+        } else {
+            i++;
+        }
+    }
+
+    // Labels are laid out again when their text changes, or when the atlas was cleared since their layout. When the atlas is
+    // full of glyphs no longer shown, it's cleared once, so that only the glyphs of the current labels are added back.
+    GlyphAtlas& glyphs = m_atlas->Glyphs();
+    for (uint32_t attempt = 0; attempt < 2; attempt++) {
+        bool atlasFull = false;
+        for (const LabelEntry& entry : m_labels) {
+            TextLabel& label = *entry.Label.lock();
+            if (label.m_poseChanged) {
+                m_model->GetNode(label.m_node).SetTransform(xr::math::LoadXrPose(label.m_pose));
+                label.m_poseChanged = false;
+            }
+            if (label.m_visibilityChanged) {
+                label.m_visibilityChanged = false;
+                quadsChanged = true;
+            }
+            if (label.m_textChanged || label.m_atlasGeneration != glyphs.Generation()) {
+                atlasFull |= !BuildVertices(label);
+                label.m_textChanged = false;
+                label.m_atlasGeneration = glyphs.Generation();
+                quadsChanged = true;
+            }
+        }
+
+        if (!atlasFull || attempt > 0) {
+            break;
+        }
+        glyphs.Clear();
+    }
+
+    if (quadsChanged) {
+        m_vertices.clear();
+        for (const LabelEntry& entry : m_labels) {
+            const TextLabel& label = *entry.Label.lock();
+            if (label.m_visible) {
+                m_vertices.insert(m_vertices.end(), label.m_vertices.begin(), label.m_vertices.end());
+            }
+        }
+        UploadQuads(context, static_cast<uint32_t>(m_vertices.size() / 4));
+    }
+
+    m_atlas->Upload(context.DeviceContext.get());
+}
+
+bool engine::TextRenderer::BuildVertices(TextLabel& label) const {
+    const TextLabelInfo& info = label.m_info;
+    const GlyphAtlas& glyphs = m_atlas->Glyphs();
+
+    const float boxWidth = info.Size.x * info.PixelsPerMeter;
+    const float boxHeight = info.Size.y * info.PixelsPerMeter;
+    TextLayoutOptions options;
+    options.Width = std::max(boxWidth - info.Margin * 2, 0.0f);
+    options.Height = std::max(boxHeight - info.Margin * 2, 0.0f);
+    options.HorizontalAlignment = info.HorizontalAlignment;
+    options.VerticalAlignment = info.VerticalAlignment;
+    const bool complete = LayoutText(label.m_text, info.Font, options, m_atlas->Glyphs(), m_quads);
+
+    // The quads are centered on the label, with y pointing up, in the winding order of engine::CreateQuad.
+    const float metersPerPixel = 1 / info.PixelsPerMeter;
+    const float uScale = 1.0f / glyphs.Width();
+    const float vScale = 1.0f / glyphs.Height();
+    Pbr::Vertex vertex;
+    vertex.Normal = {0, 0, 1};
+    vertex.Tangent = {1, 0, 0, 0};
+    vertex.ModelTransformIndex = label.m_node;
+    const auto addQuad = [&](float left, float top, float right, float bottom, const AtlasRect& rect, const Pbr::RGBAColor& color) {
+        const float x0 = left * metersPerPixel - info.Size.x / 2;
+        const float x1 = right * metersPerPixel - info.Size.x / 2;
+        const float y0 = info.Size.y / 2 - bottom * metersPerPixel;
+        const float y1 = info.Size.y / 2 - top * metersPerPixel;
+        const float u0 = rect.Left * uScale;
+        const float u1 = rect.Right * uScale;
+        const float v0 = rect.Bottom * vScale;
+        const float v1 = rect.Top * vScale;
+
+        vertex.Color0 = color;
+        vertex.Position = {x0, y0, 0};
+        vertex.TexCoord0 = {u0, v0};
+        label.m_vertices.push_back(vertex); // LB
+        vertex.Position = {x0, y1, 0};
+        vertex.TexCoord0 = {u0, v1};
+        label.m_vertices.push_back(vertex); // LT
+        vertex.Position = {x1, y1, 0};
+        vertex.TexCoord0 = {u1, v1};
+        label.m_vertices.push_back(vertex); // RT
+        vertex.Position = {x1, y0, 0};
+        vertex.TexCoord0 = {u1, v0};
+        label.m_vertices.push_back(vertex); // RB
+    };
+
+    // The background comes first, since the glyphs are blended over it.
+    label.m_vertices.clear();
+    if (info.Background.w > 0) {
+        addQuad(0, 0, boxWidth, boxHeight, glyphs.SolidRect(), info.Background);
+    }
+    for (const GlyphQuad& quad : m_quads) {
+        const float margin = info.Margin;
+        addQuad(quad.Left + margin, quad.Top + margin, quad.Right + margin, quad.Bottom + margin, quad.Rect, info.Foreground);
+    }
+    return complete;
+}
+
+void engine::TextRenderer::UploadQuads(Context& context, uint32_t quadCount) const {
+    if (quadCount > m_quadCapacity) {
+        m_quadCapacity = std::max({quadCount, m_quadCapacity * 2, MinQuadCapacity});
+
+        // Every quad has the same two triangles, so the indices only change with the capacity.
+        m_indices.clear();
+        for (uint32_t quad = 0; quad < m_quadCapacity; quad++) {
+            const uint32_t first = quad * 4;
+            m_indices.insert(m_indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+        }
+
+        m_model->Clear();
+        m_model->AddPrimitive(Pbr::Primitive(context.PbrResources, m_quadCapacity * 4, m_quadCapacity * 6, m_atlas->Material()));
+    }
+
+    if (m_model->GetPrimitiveCount() > 0) {
+        Pbr::Primitive& primitive = m_model->GetPrimitive(0);
+        primitive.UpdateVertices(context.DeviceContext.get(), m_vertices.data(), quadCount * 4);
+        primitive.UpdateIndices(context.DeviceContext.get(), m_indices.data(), quadCount * 6);
+    }
+}
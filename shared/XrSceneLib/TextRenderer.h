@@ -0,0 +1,151 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+#include <dwrite_2.h>
+
+#include <pbr/PbrMaterial.h>
+#include "PbrModelObject.h"
+#include "TextLayout.h"
+#include "Context.h"
+
+namespace engine {
+    // The glyphs of the text drawn by any number of TextRenderers, rasterized by DirectWrite on the CPU into a glyph atlas, and
+    // uploaded to a texture they share. Only the glyphs added since the last upload are sent to the GPU.
+    class TextAtlas {
+    public:
+        explicit TextAtlas(Context& context, uint32_t width = 1024, uint32_t height = 1024);
+
+        // Adds a font of the family, rasterized at the size in pixels.
+        FontId AddFont(const wchar_t* fontName, float fontSize, DWRITE_FONT_WEIGHT fontWeight = DWRITE_FONT_WEIGHT_NORMAL);
+
+        GlyphAtlas& Glyphs() {
+            return m_glyphs;
+        }
+
+        // The material drawing text, whose base color texture is the atlas.
+        const std::shared_ptr<Pbr::Material>& Material() const {
+            return m_material;
+        }
+
+        // Uploads the glyphs added since the last upload.
+        void Upload(_In_ ID3D11DeviceContext* context);
+
+    private:
+        GlyphAtlas m_glyphs;
+        winrt::com_ptr<IDWriteFactory2> m_dwriteFactory;
+        winrt::com_ptr<ID3D11Texture2D> m_texture;
+        std::shared_ptr<Pbr::Material> m_material;
+
+        // Reused by every upload to avoid allocations.
+        std::vector<uint32_t> m_uploadPixels;
+    };
+
+    struct TextLabelInfo {
+        TextLabelInfo(DirectX::XMFLOAT2 size, float pixelsPerMeter, FontId font)
+            : Size(size)
+            , PixelsPerMeter(pixelsPerMeter)
+            , Font(font) {
+        }
+
+        DirectX::XMFLOAT2 Size;  // In meters
+        float PixelsPerMeter;    // The scale of the font pixels
+        FontId Font;
+        float Margin = 0;        // In pixels
+        Pbr::RGBAColor Foreground = Pbr::RGBA::White;
+        Pbr::RGBAColor Background = Pbr::RGBA::Transparent;
+        TextAlignment HorizontalAlignment = TextAlignment::Center;
+        ParagraphAlignment VerticalAlignment = ParagraphAlignment::Center;
+    };
+
+    class TextRenderer;
+
+    // A block of text drawn by a TextRenderer, on a rectangle centered on its pose and facing +z like engine::CreateQuad. Its
+    // vertices are built again only when its text changes. The renderer stops drawing a label once it's released.
+    class TextLabel {
+    public:
+        // Does nothing if the text is unchanged, so that a label can be set every frame.
+        void SetText(std::wstring_view text);
+        const std::wstring& Text() const {
+            return m_text;
+        }
+
+        // The pose of the label relative to its renderer.
+        void SetPose(const XrPosef& pose);
+        const XrPosef& Pose() const {
+            return m_pose;
+        }
+
+        void SetVisible(bool visible);
+        bool IsVisible() const {
+            return m_visible;
+        }
+
+    private:
+        friend class TextRenderer;
+        TextLabel(const TextLabelInfo& info, Pbr::NodeIndex_t node);
+
+        const TextLabelInfo m_info;
+        const Pbr::NodeIndex_t m_node;
+        std::wstring m_text;
+        XrPosef m_pose = xr::math::Pose::Identity();
+        bool m_visible{true};
+
+        // Consumed by the renderer when it next renders.
+        bool m_textChanged{true};
+        bool m_poseChanged{true};
+        bool m_visibilityChanged{false};
+
+        // Built by the renderer from the layout of the text, with the generation of the atlas the layout refers to.
+        std::vector<Pbr::Vertex> m_vertices;
+        uint32_t m_atlasGeneration{0};
+    };
+
+    // Draws many text labels with one draw call: the quads of their glyphs and backgrounds share a streaming primitive, in
+    // which each label moves with a node of the model. Moving a label only changes its node, and changing its text lays out
+    // only that label before the quads are uploaded again.
+    class TextRenderer : public PbrModelObject {
+    public:
+        explicit TextRenderer(std::shared_ptr<TextAtlas> atlas);
+
+        std::shared_ptr<TextLabel> CreateLabel(const TextLabelInfo& info, std::wstring_view text = {});
+
+        void Render(Context& context) const override;
+
+    private:
+        // Applies the changes of the labels, and uploads the glyphs and quads they need.
+        void UpdateLabels(Context& context) const;
+        // Returns false if the atlas is full, in which case glyphs are missing from the label.
+        bool BuildVertices(TextLabel& label) const;
+        void UploadQuads(Context& context, uint32_t quadCount) const;
+
+        struct LabelEntry {
+            std::weak_ptr<TextLabel> Label;
+            Pbr::NodeIndex_t Node;
+        };
+
+        const std::shared_ptr<TextAtlas> m_atlas;
+        const std::shared_ptr<Pbr::Model> m_model;
+        mutable std::vector<LabelEntry> m_labels;
+        mutable std::vector<Pbr::NodeIndex_t> m_freeNodes;
+        mutable uint32_t m_quadCapacity{0};
+
+        // Reused by every update to avoid allocations.
+        mutable std::vector<GlyphQuad> m_quads;
+        mutable std::vector<Pbr::Vertex> m_vertices;
+        mutable std::vector<uint32_t> m_indices;
+    };
+} // namespace engine
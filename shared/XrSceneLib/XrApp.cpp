@@ -19,8 +19,11 @@
 #include <XrUtility/XrToString.h>
 #include <XrUtility/XrViewConfiguration.h>
 
+#include <SampleShared/AllocationProfiler.h>
 #include <SampleShared/FileUtility.h>
 #include <SampleShared/DxUtility.h>
+#include <SampleShared/FrameArena.h>
+#include <SampleShared/PbrThreadPoolScheduler.h>
 #include <SampleShared/Trace.h>
 
 #include "XrApp.h"
@@ -110,6 +113,11 @@ namespace {
             return m_projectionLayers;
         }
 
+        engine::ResolutionReport ResolutionReport() const override {
+            std::scoped_lock lock(m_resolutionReportMutex);
+            return m_resolutionReport;
+        }
+
     private:
 
         const engine::XrAppConfiguration m_appConfiguration;
@@ -117,6 +125,7 @@ namespace {
         std::unique_ptr<engine::Context> m_context;
         xr::SpaceHandle m_viewSpace;
         xr::SpaceHandle m_sceneSpace;
+        engine::SpaceLocator::Registration m_viewInScene;
 
         engine::ProjectionLayers m_projectionLayers;
         std::unordered_map<XrViewConfigurationType, xr::ViewConfigurationState> m_viewConfigStates;
@@ -126,6 +135,7 @@ namespace {
 
         std::mutex m_sceneMutex;
         std::vector<std::unique_ptr<engine::Scene>> m_scenes;
+        xr::ActionSynchronizer m_actionSynchronizer;
 
         std::atomic<bool> m_sessionRunning{false};
         std::atomic<bool> m_abortFrameLoop{false};
@@ -139,6 +149,23 @@ namespace {
         bool m_frameReadyToRender{false};
         engine::FrameTime m_currentFrameTime;
 
+        // Per-frame containers are allocated from these arenas, which are reset at the start of every frame.
+        // UpdateFrame and RenderFrame can run concurrently on different threads, so each has its own arena.
+        sample::FrameArena m_updateFrameArena;
+        sample::FrameArena m_renderFrameArena;
+
+        // Polled every frame, so that an exception escaping a job of the Pbr library fails the app instead of being dropped.
+        std::shared_ptr<sample::PbrThreadPoolScheduler> m_pbrScheduler;
+
+        // Dynamic resolution, only used when XrAppConfiguration::DynamicResolution is set.
+        // The update duration is measured on the app thread and consumed by the render thread, which owns the rest.
+        std::optional<engine::ResolutionController> m_resolutionController;
+        std::optional<sample::dx::GpuTimer> m_gpuTimer;
+        XrDuration m_lastGpuFrameDuration{0};
+        std::atomic<XrDuration> m_updateFrameDuration{0};
+        mutable std::mutex m_resolutionReportMutex;
+        engine::ResolutionReport m_resolutionReport;
+
     private:
         bool ProcessEvents();
         void StartRenderThreadIfNotRunning();
@@ -147,8 +174,15 @@ namespace {
         void RenderFrame();
         void NotifyFrameRenderThread();
         void RenderViewConfiguration(const std::scoped_lock<std::mutex>& proofOfSceneLock,
+                                     const engine::FrameTime& frameTime,
                                      XrViewConfigurationType viewConfigurationType,
                                      engine::CompositionLayers& layers);
+        void RenderViewConfigurationsAfterSubmission(const engine::FrameTime& frameTime);
+        void RenderViewConfigurationAfterSubmission(const engine::FrameTime& frameTime, XrViewConfigurationType viewConfigType);
+        bool LocateViews(const engine::FrameTime& frameTime, XrViewConfigurationType viewConfigurationType);
+        void UpdateResolution(const engine::FrameTime& frameTime, XrDuration renderFrameDuration);
+        void TraceAssetCache() const;
+        void TraceRenderStatistics();
         void SetSecondaryViewConfigurationActive(xr::ViewConfigurationState& secondaryViewConfigState, bool active);
 
         void FinalizeActionBindings();
@@ -245,7 +279,24 @@ namespace {
             extensions.SupportsUnboundedSpace ? XR_REFERENCE_SPACE_TYPE_UNBOUNDED_MSFT : XR_REFERENCE_SPACE_TYPE_LOCAL;
         CHECK_XRCMD(xrCreateReferenceSpace(session.Handle, &spaceCreateInfo, m_sceneSpace.Put()));
 
+        // Installed before the Pbr resources are created, so the environment maps are already filtered on the pool.
+        const uint32_t hardwareThreadCount = std::thread::hardware_concurrency();
+        const uint32_t workerThreadCount = m_appConfiguration.PbrWorkerThreadCount > 0 ? m_appConfiguration.PbrWorkerThreadCount
+                                                                                       : std::max(hardwareThreadCount, 3u) - 2;
+        m_pbrScheduler = std::make_shared<sample::PbrThreadPoolScheduler>(workerThreadCount);
+        Pbr::SetTaskScheduler(m_pbrScheduler);
+
         Pbr::Resources pbrResources = sample::InitializePbrResources(device.get());
+        if (m_appConfiguration.TextureCompression.has_value()) {
+            std::shared_ptr<Pbr::TextureStore> textureStore;
+            if (m_appConfiguration.TextureCacheFolder.has_value()) {
+                textureStore = std::make_shared<sample::DdsTextureStore>(m_appConfiguration.TextureCacheFolder.value());
+            }
+            pbrResources.SetTextureCompression(m_appConfiguration.TextureCompression.value(), std::move(textureStore));
+        }
+        if (m_appConfiguration.AssetCacheTextureCapacity.has_value()) {
+            pbrResources.GetAssetCache().SetTextureCapacity(m_appConfiguration.AssetCacheTextureCapacity.value());
+        }
 
         m_context = std::make_unique<engine::Context>(std::move(instance),
                                                       std::move(extensions),
@@ -256,7 +307,24 @@ namespace {
                                                       device,
                                                       deviceContext);
 
+        m_viewInScene = m_context->Spaces.Register(m_viewSpace.Get(), m_sceneSpace.Get());
+
+        if (m_appConfiguration.TextureResidency.has_value()) {
+            m_context->PbrResources.SetTextureResidency(
+                std::make_shared<Pbr::TextureResidency>(m_appConfiguration.TextureResidency.value()));
+        }
+
         m_projectionLayers.Resize(1, Context(), true /*forceReset*/);
+
+        if (m_appConfiguration.DynamicResolution.has_value()) {
+            m_resolutionController.emplace(m_appConfiguration.DynamicResolution.value());
+            m_gpuTimer.emplace(Context().Device.get());
+            m_resolutionReport = m_resolutionController->LastReport();
+        }
+
+        if (m_appConfiguration.StrictSteadyStateWarmupFrames.has_value()) {
+            sample::allocation::EnableStrictSteadyState(m_appConfiguration.StrictSteadyStateWarmupFrames.value());
+        }
     }
 
     ImplementXrApp::~ImplementXrApp() {
@@ -266,6 +334,9 @@ namespace {
             std::scoped_lock lock(m_sceneMutex);
             m_scenes.clear();
         }
+
+        // Work still queued on the pool finishes when the last reference to the scheduler goes away.
+        Pbr::SetTaskScheduler(nullptr);
     }
 
     void ImplementXrApp::AddScene(std::unique_ptr<engine::Scene> scene) {
@@ -336,13 +407,14 @@ namespace {
     }
 
     void ImplementXrApp::SyncActions(const std::scoped_lock<std::mutex>& proofOfSceneLock) {
-        std::vector<const xr::ActionContext*> actionContexts;
+        sample::FrameVector<const xr::ActionContext*> actionContexts(m_updateFrameArena);
+        actionContexts.reserve(m_scenes.size());
         for (const auto& scene : m_scenes) {
             if (scene->IsActive()) {
                 actionContexts.push_back(&scene->ActionContext());
             }
         }
-        xr::SyncActions(Context().Session.Handle, actionContexts);
+        m_actionSynchronizer.SyncActions(Context().Session.Handle, actionContexts);
     }
 
     void ImplementXrApp::StartRenderThreadIfNotRunning() {
@@ -463,14 +535,35 @@ namespace {
     }
 
     void ImplementXrApp::UpdateFrame() {
+        sample::allocation::BeginFrame();
+        if (m_appConfiguration.AllocationTraceIntervalFrames.has_value() &&
+            sample::allocation::FrameIndex() % std::max(1u, m_appConfiguration.AllocationTraceIntervalFrames.value()) == 0) {
+            sample::allocation::TraceLastFrame();
+        }
+        if (m_appConfiguration.AssetCacheTraceIntervalFrames.has_value() &&
+            sample::allocation::FrameIndex() % std::max(1u, m_appConfiguration.AssetCacheTraceIntervalFrames.value()) == 0) {
+            TraceAssetCache();
+        }
+        if (m_appConfiguration.RenderStatisticsTraceIntervalFrames.has_value() &&
+            sample::allocation::FrameIndex() % std::max(1u, m_appConfiguration.RenderStatisticsTraceIntervalFrames.value()) == 0) {
+            TraceRenderStatistics();
+        }
+        sample::allocation::Scope allocationScope("XrApp::UpdateFrame");
+
+        if (const std::exception_ptr exception = m_pbrScheduler->TakeUnhandledException()) {
+            std::rethrow_exception(exception);
+        }
+
+        m_updateFrameArena.Reset();
+
         XrFrameState frameState{XR_TYPE_FRAME_STATE};
 
         // secondaryViewConfigFrameState needs to have the same lifetime as frameState
         XrSecondaryViewConfigurationFrameStateMSFT secondaryViewConfigFrameState{XR_TYPE_SECONDARY_VIEW_CONFIGURATION_FRAME_STATE_MSFT};
 
         const size_t enabledSecondaryViewConfigCount = Context().Session.EnabledSecondaryViewConfigurationTypes.size();
-        std::vector<XrSecondaryViewConfigurationStateMSFT> secondaryViewConfigStates(enabledSecondaryViewConfigCount,
-                                                                                     {XR_TYPE_SECONDARY_VIEW_CONFIGURATION_STATE_MSFT});
+        sample::FrameVector<XrSecondaryViewConfigurationStateMSFT> secondaryViewConfigStates(
+            enabledSecondaryViewConfigCount, {XR_TYPE_SECONDARY_VIEW_CONFIGURATION_STATE_MSFT}, m_updateFrameArena);
 
         if (Context().Extensions.SupportsSecondaryViewConfiguration && enabledSecondaryViewConfigCount > 0) {
             secondaryViewConfigFrameState.viewConfigurationCount = (uint32_t)secondaryViewConfigStates.size();
@@ -481,9 +574,12 @@ namespace {
         XrFrameWaitInfo waitFrameInfo{XR_TYPE_FRAME_WAIT_INFO};
         CHECK_XRCMD(xrWaitFrame(Context().Session.Handle, &waitFrameInfo, &frameState));
 
+        // The time blocked in xrWaitFrame is throttling, not work, so the update duration starts after it.
+        const engine::FrameTime::clock::time_point updateStart = engine::FrameTime::clock::now();
+
         if (Context().Extensions.SupportsSecondaryViewConfiguration) {
             std::scoped_lock lock(m_secondaryViewConfigActiveMutex);
-            m_secondaryViewConfigurationsState = std::move(secondaryViewConfigStates);
+            m_secondaryViewConfigurationsState.assign(secondaryViewConfigStates.begin(), secondaryViewConfigStates.end());
         }
 
         {
@@ -493,12 +589,20 @@ namespace {
 
             m_currentFrameTime.Update(frameState);
 
+            // Locate the spaces of all objects and the hands in one pass before the scenes read them.
+            Context().Spaces.LocateAll(m_currentFrameTime.PredictedDisplayTime);
+            Context().Hands.Update(m_currentFrameTime.PredictedDisplayTime);
+
+            sample::allocation::Scope sceneAllocationScope("Scene::Update");
             for (auto& scene : m_scenes) {
                 if (scene->IsActive()) {
                     scene->Update(m_currentFrameTime);
                 }
             }
         }
+
+        m_updateFrameDuration =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(engine::FrameTime::clock::now() - updateStart).count();
     }
 
     void ImplementXrApp::SetSecondaryViewConfigurationActive(xr::ViewConfigurationState& secondaryViewConfigState, bool active) {
@@ -525,9 +629,14 @@ namespace {
         // m_currentFrameTime will be updated for the next frame.
         const engine::FrameTime renderFrameTime = m_currentFrameTime;
 
+        sample::allocation::Scope allocationScope("XrApp::RenderFrame");
+        m_renderFrameArena.Reset();
+
         XrFrameBeginInfo beginFrameDescription{XR_TYPE_FRAME_BEGIN_INFO};
         CHECK_XRCMD(xrBeginFrame(Context().Session.Handle, &beginFrameDescription));
 
+        const engine::FrameTime::clock::time_point renderStart = engine::FrameTime::clock::now();
+
         if (Context().Extensions.SupportsSecondaryViewConfiguration) {
             std::scoped_lock lock(m_secondaryViewConfigActiveMutex);
             for (auto& state : m_secondaryViewConfigurationsState) {
@@ -550,7 +659,8 @@ namespace {
         // Secondary view config frame info need to have same lifetime as XrFrameEndInfo;
         XrSecondaryViewConfigurationFrameEndInfoMSFT frameEndSecondaryViewConfigInfo{
             XR_TYPE_SECONDARY_VIEW_CONFIGURATION_FRAME_END_INFO_MSFT};
-        std::vector<XrSecondaryViewConfigurationLayerInfoMSFT> activeSecondaryViewConfigLayerInfos;
+        sample::FrameVector<XrSecondaryViewConfigurationLayerInfoMSFT> activeSecondaryViewConfigLayerInfos(m_renderFrameArena);
+        activeSecondaryViewConfigLayerInfos.reserve(Context().Session.EnabledSecondaryViewConfigurationTypes.size());
 
         // Chain secondary view configuration layers data to endFrameInfo
         if (Context().Extensions.SupportsSecondaryViewConfiguration &&
@@ -574,14 +684,29 @@ namespace {
         }
 
         // Prepare array of layer data for each active view configurations.
-        std::vector<engine::CompositionLayers> layersForAllViewConfigs(1 + activeSecondaryViewConfigLayerInfos.size());
+        sample::FrameVector<engine::CompositionLayers> layersForAllViewConfigs(m_renderFrameArena);
+        layersForAllViewConfigs.reserve(1 + activeSecondaryViewConfigLayerInfos.size());
+        for (size_t i = 0; i < 1 + activeSecondaryViewConfigLayerInfos.size(); i++) {
+            layersForAllViewConfigs.emplace_back(m_renderFrameArena);
+        }
 
         if (renderFrameTime.ShouldRender) {
             std::scoped_lock sceneLock(m_sceneMutex);
 
+            // Uploads run under the scene lock, so the models they complete are not being updated meanwhile. Creating materials,
+            // primitives and textures allocates, whenever an asset arrives. Processing a queue with nothing ready doesn't.
+            {
+                sample::allocation::AllowAllocationsScope allowAllocations;
+                Context().UploadQueue.Process(m_appConfiguration.UploadBudget);
+            }
+
+            if (m_gpuTimer) {
+                m_gpuTimer->Begin(Context().DeviceContext.get());
+            }
+
             // Render for the primary view configuration.
             engine::CompositionLayers& primaryViewConfigLayers = layersForAllViewConfigs[0];
-            RenderViewConfiguration(sceneLock, PrimaryViewConfigurationType, primaryViewConfigLayers);
+            RenderViewConfiguration(sceneLock, renderFrameTime, PrimaryViewConfigurationType, primaryViewConfigLayers);
             endFrameInfo.layerCount = primaryViewConfigLayers.LayerCount();
             endFrameInfo.layers = primaryViewConfigLayers.LayerData();
 
@@ -590,26 +715,82 @@ namespace {
                 for (size_t i = 0; i < activeSecondaryViewConfigLayerInfos.size(); i++) {
                     XrSecondaryViewConfigurationLayerInfoMSFT& secondaryViewConfigLayerInfo = activeSecondaryViewConfigLayerInfos.at(i);
                     engine::CompositionLayers& secondaryViewConfigLayers = layersForAllViewConfigs.at(i + 1);
-                    RenderViewConfiguration(sceneLock, secondaryViewConfigLayerInfo.viewConfigurationType, secondaryViewConfigLayers);
+                    RenderViewConfiguration(
+                        sceneLock, renderFrameTime, secondaryViewConfigLayerInfo.viewConfigurationType, secondaryViewConfigLayers);
                     secondaryViewConfigLayerInfo.layerCount = secondaryViewConfigLayers.LayerCount();
                     secondaryViewConfigLayerInfo.layers = secondaryViewConfigLayers.LayerData();
                 }
             }
+
+            if (m_gpuTimer) {
+                m_gpuTimer->End(Context().DeviceContext.get());
+            }
+
+            // The levels of the streamed textures are planned from the views and models of all view configurations rendered.
+            if (const std::shared_ptr<Pbr::TextureResidency> residency = Context().PbrResources.GetTextureResidency()) {
+                residency->Update(Context().UploadQueue);
+            }
         }
 
+        const XrDuration renderFrameDuration =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(engine::FrameTime::clock::now() - renderStart).count();
+
         CHECK_XRCMD(xrEndFrame(Context().Session.Handle, &endFrameInfo));
+
+        if (m_resolutionController && renderFrameTime.ShouldRender) {
+            UpdateResolution(renderFrameTime, renderFrameDuration);
+        }
+
+        if (renderFrameTime.ShouldRender && activeSecondaryViewConfigLayerInfos.size() > 0) {
+            RenderViewConfigurationsAfterSubmission(renderFrameTime);
+        }
     }
 
-    void ImplementXrApp::RenderViewConfiguration(const std::scoped_lock<std::mutex>& proofOfSceneLock,
-                                                 XrViewConfigurationType viewConfigurationType,
-                                                 engine::CompositionLayers& layers) {
+    void ImplementXrApp::RenderViewConfigurationsAfterSubmission(const engine::FrameTime& frameTime) {
+        sample::allocation::Scope allocationScope("XrApp::RenderViewConfigurationsAfterSubmission");
+
+        for (const auto& [viewConfigType, state] : m_viewConfigStates) {
+            if (!xr::IsPrimaryViewConfigurationType(viewConfigType) && state.Active) {
+                RenderViewConfigurationAfterSubmission(frameTime, viewConfigType);
+            }
+        }
+    }
+
+    void ImplementXrApp::RenderViewConfigurationAfterSubmission(const engine::FrameTime& frameTime,
+                                                                XrViewConfigurationType viewConfigType) {
+        const auto isRenderDueAfterSubmission = [&frameTime, viewConfigType](engine::ProjectionLayer& layer) {
+            return layer.RendersAfterSubmission(viewConfigType) && layer.IsRenderDue(frameTime, viewConfigType);
+        };
+
+        bool anyRenderDue = false;
+        m_projectionLayers.ForEachLayerWithLock(
+            [&](engine::ProjectionLayer& layer) { anyRenderDue = anyRenderDue || isRenderDueAfterSubmission(layer); });
+        if (!anyRenderDue) {
+            return;
+        }
+
+        // The images are submitted with the next frame, whose view poses the compositor reprojects them to.
+        std::scoped_lock sceneLock(m_sceneMutex);
+        if (!LocateViews(frameTime, viewConfigType)) {
+            return;
+        }
+
+        const std::vector<XrView>& views = m_viewConfigStates.at(viewConfigType).Views;
+        m_projectionLayers.ForEachLayerWithLock([&](engine::ProjectionLayer& layer) {
+            if (isRenderDueAfterSubmission(layer)) {
+                layer.Render(Context(), frameTime, Context().SceneSpace, views, m_scenes, viewConfigType);
+            }
+        });
+    }
+
+    bool ImplementXrApp::LocateViews(const engine::FrameTime& frameTime, XrViewConfigurationType viewConfigurationType) {
         // Locate the views in VIEW space to get the per-view offset from the VIEW "camera"
         XrViewState viewState{XR_TYPE_VIEW_STATE};
         std::vector<XrView>& views = m_viewConfigStates.at(viewConfigurationType).Views;
         {
             XrViewLocateInfo viewLocateInfo{XR_TYPE_VIEW_LOCATE_INFO};
             viewLocateInfo.viewConfigurationType = viewConfigurationType;
-            viewLocateInfo.displayTime = m_currentFrameTime.PredictedDisplayTime;
+            viewLocateInfo.displayTime = frameTime.PredictedDisplayTime;
             viewLocateInfo.space = m_viewSpace.Get();
 
             uint32_t viewCount = 0;
@@ -617,22 +798,97 @@ namespace {
                 xrLocateViews(Context().Session.Handle, &viewLocateInfo, &viewState, (uint32_t)views.size(), &viewCount, views.data()));
             assert(viewCount == views.size());
             if (!xr::math::Pose::IsPoseValid(viewState)) {
-                return;
+                return false;
             }
         }
 
         // Locate the VIEW space in the scene space to get the "camera" pose and combine the per-view offsets with the camera pose.
-        XrSpaceLocation viewLocation{XR_TYPE_SPACE_LOCATION};
-        CHECK_XRCMD(xrLocateSpace(m_viewSpace.Get(), m_sceneSpace.Get(), m_currentFrameTime.PredictedDisplayTime, &viewLocation));
+        // The update thread already located it for this display time.
+        const XrSpaceLocation viewLocation = Context().Spaces.Location(m_viewInScene, frameTime.PredictedDisplayTime);
         if (!xr::math::Pose::IsPoseValid(viewLocation)) {
-            return;
+            return false;
         }
 
         for (XrView& view : views) {
             view.pose = xr::math::Pose::Multiply(view.pose, viewLocation.pose);
         }
+        return true;
+    }
 
-        std::vector<std::shared_ptr<engine::QuadLayerObject>> underlays, overlays;
+    void ImplementXrApp::UpdateResolution(const engine::FrameTime& frameTime, XrDuration renderFrameDuration) {
+        // The GPU result arrives a few frames late; until a newer span finishes, the previous one stands in for this frame.
+        if (const std::optional<XrDuration> gpuFrameDuration = m_gpuTimer->Read(Context().DeviceContext.get())) {
+            m_lastGpuFrameDuration = gpuFrameDuration.value();
+        }
+
+        // The update and render stages of consecutive frames overlap unless they run on the same thread.
+        const XrDuration updateFrameDuration = m_updateFrameDuration;
+        const XrDuration cpuFrameDuration = m_appConfiguration.RenderSynchronously ? updateFrameDuration + renderFrameDuration
+                                                                                   : std::max(updateFrameDuration, renderFrameDuration);
+
+        const float previousScale = m_resolutionController->Scale();
+        const float scale =
+            m_resolutionController->Update(std::max(cpuFrameDuration, m_lastGpuFrameDuration), frameTime.PredictedDisplayPeriod);
+        {
+            std::scoped_lock lock(m_resolutionReportMutex);
+            m_resolutionReport = m_resolutionController->LastReport();
+        }
+
+        // Applied every frame so that layers created since the last change pick up the scale too.
+        m_projectionLayers.ForEachLayerWithLock(
+            [scale](engine::ProjectionLayer& layer) { layer.Config(PrimaryViewConfigurationType).ViewportSizeScale = {scale, scale}; });
+        if (scale != previousScale) {
+            sample::Trace("Render resolution scale changed from {:.3f} to {:.3f}", previousScale, scale);
+        }
+    }
+
+    void ImplementXrApp::TraceAssetCache() const {
+        sample::allocation::AllowAllocationsScope allowAllocations; // Formatting the trace may allocate.
+        constexpr double Megabyte = 1024 * 1024;
+        const Pbr::AssetCacheStatistics statistics = m_context->PbrResources.GetAssetCache().Statistics();
+        sample::Trace("Asset cache: {} textures ({:.1f} MB, {:.1f} MB unused), {} materials. Texture hits {}, misses {}, {:.1f} MB "
+                      "saved. Material hits {}, misses {}. {} evictions",
+                      statistics.TextureCount,
+                      statistics.TextureBytes / Megabyte,
+                      statistics.UnusedTextureBytes / Megabyte,
+                      statistics.MaterialCount,
+                      statistics.TextureHits,
+                      statistics.TextureMisses,
+                      statistics.BytesSaved / Megabyte,
+                      statistics.MaterialHits,
+                      statistics.MaterialMisses,
+                      statistics.Evictions);
+    }
+
+    void ImplementXrApp::TraceRenderStatistics() {
+        sample::allocation::AllowAllocationsScope allowAllocations; // Formatting the trace may allocate.
+        m_projectionLayers.ForEachLayerWithLock([](engine::ProjectionLayer& layer) {
+            const engine::RenderStatistics& statistics = layer.RenderStatistics();
+            if (statistics.FrameCount > 0) {
+                sample::Trace("Projection layer: {} frames ({} single pass), {:.2f} render passes and {:.3f} ms of CPU submission per "
+                              "frame",
+                              statistics.FrameCount,
+                              statistics.SinglePassFrameCount,
+                              statistics.MeanPassCount(),
+                              statistics.MeanSubmitMilliseconds());
+            }
+            layer.ResetRenderStatistics();
+        });
+    }
+
+    void ImplementXrApp::RenderViewConfiguration(const std::scoped_lock<std::mutex>& proofOfSceneLock,
+                                                 const engine::FrameTime& frameTime,
+                                                 XrViewConfigurationType viewConfigurationType,
+                                                 engine::CompositionLayers& layers) {
+        sample::allocation::Scope allocationScope("XrApp::RenderViewConfiguration");
+
+        if (!LocateViews(frameTime, viewConfigurationType)) {
+            return;
+        }
+        const std::vector<XrView>& views = m_viewConfigStates.at(viewConfigurationType).Views;
+
+        // The scene lock keeps the quad layer objects alive, so raw pointers avoid the reference count traffic of copying shared_ptrs.
+        sample::FrameVector<engine::QuadLayerObject*> underlays(m_renderFrameArena), overlays(m_renderFrameArena);
         {
             // Collect all quad layers in active scenes
             for (const std::unique_ptr<engine::Scene>& scene : m_scenes) {
@@ -644,26 +900,33 @@ namespace {
                         continue;
                     }
                     if (quad->LayerGroup == engine::LayerGrouping::Underlay) {
-                        underlays.push_back(quad);
+                        underlays.push_back(quad.get());
                     } else if (quad->LayerGroup == engine::LayerGrouping::Overlay) {
-                        overlays.push_back(quad);
+                        overlays.push_back(quad.get());
                     }
                 }
             }
         }
 
-        for (const std::shared_ptr<engine::QuadLayerObject>& quad : underlays) {
-            AppendQuadLayer(layers, quad.get());
+        for (engine::QuadLayerObject* quad : underlays) {
+            AppendQuadLayer(layers, quad);
         }
 
-        m_projectionLayers.ForEachLayerWithLock([this, &layers, &views, viewConfigurationType](engine::ProjectionLayer& projectionLayer) {
+        m_projectionLayers.ForEachLayerWithLock([this, &frameTime, &layers, &views, viewConfigurationType](
+                                                    engine::ProjectionLayer& projectionLayer) {
             bool opaqueClearColor = (layers.LayerCount() == 0); // Only the first projection layer need opaque background
             opaqueClearColor &= (Context().Session.PrimaryViewConfigurationBlendMode == XR_ENVIRONMENT_BLEND_MODE_OPAQUE);
             DirectX::XMStoreFloat4(&projectionLayer.Config().ClearColor,
                                    opaqueClearColor ? DirectX::XMColorSRGBToRGB(DirectX::Colors::CornflowerBlue)
                                                     : DirectX::Colors::Transparent);
+
+            // Secondary view configurations may skip frames or render after submission, submitting the last images instead.
+            const bool renderNow = xr::IsPrimaryViewConfigurationType(viewConfigurationType) ||
+                                   (!projectionLayer.RendersAfterSubmission(viewConfigurationType) &&
+                                    projectionLayer.IsRenderDue(frameTime, viewConfigurationType));
             const bool shouldSubmitProjectionLayer =
-                projectionLayer.Render(Context(), m_currentFrameTime, Context().SceneSpace, views, m_scenes, viewConfigurationType);
+                renderNow ? projectionLayer.Render(Context(), frameTime, Context().SceneSpace, views, m_scenes, viewConfigurationType)
+                          : projectionLayer.CanResubmit(viewConfigurationType);
 
             // Create the multi projection layer
             if (shouldSubmitProjectionLayer) {
@@ -671,8 +934,8 @@ namespace {
             }
         });
 
-        for (const std::shared_ptr<engine::QuadLayerObject>& quad : overlays) {
-            AppendQuadLayer(layers, quad.get());
+        for (engine::QuadLayerObject* quad : overlays) {
+            AppendQuadLayer(layers, quad);
         }
     }
 
@@ -15,9 +15,11 @@
 //*********************************************************
 #pragma once
 
+#include <filesystem>
 #include "Scene.h"
 #include "Context.h"
 #include "ProjectionLayer.h"
+#include "ResolutionController.h"
 
 namespace engine {
     class XrApp {
@@ -35,6 +37,8 @@ namespace engine {
 
         virtual ProjectionLayers& ProjectionLayers() = 0;
 
+        // The render resolution scale chosen after the most recent frame, when XrAppConfiguration::DynamicResolution is set.
+        virtual engine::ResolutionReport ResolutionReport() const = 0;
     };
 
     struct XrAppConfiguration {
@@ -47,6 +51,52 @@ namespace engine {
         bool SingleThreadedD3D11Device{false};
         bool RenderSynchronously{false};
         std::optional<XrHolographicWindowAttachmentMSFT> HolographicWindowAttachment{std::nullopt};
+
+        // When set, the ViewportSizeScale of the primary view configuration of every projection layer is adjusted each frame
+        // so the slowest of the update, render and GPU stages fits in the display period. The swapchains keep the size given by
+        // SwapchainSizeScale, so they are never recreated, and the compositor scales the rendered part of the images up.
+        std::optional<engine::ResolutionControllerSettings> DynamicResolution{std::nullopt};
+
+        // The GPU uploads run each rendered frame from Context::UploadQueue, before rendering the scenes.
+        Pbr::UploadBudget UploadBudget;
+
+        // The number of threads of the pool that decodes images, filters environment maps and computes mip chains, see
+        // Pbr::SetTaskScheduler. 0 leaves two hardware threads to the update and render threads.
+        uint32_t PbrWorkerThreadCount{0};
+
+        // When set, the textures of glTF models are block compressed as they load, see Pbr::Resources::SetTextureCompression.
+        // Off by default: the first load of a model takes longer, and the textures lose some quality.
+        std::optional<Pbr::TextureCompression> TextureCompression{std::nullopt};
+
+        // When set along with TextureCompression, the transcoded textures are kept as DDS files in this folder, so that later
+        // runs load them instead of transcoding again, see sample::DdsTextureStore. Nothing is written to disk otherwise.
+        std::optional<std::filesystem::path> TextureCacheFolder{std::nullopt};
+
+        // When set, the GPU memory of the textures no model uses that Context::PbrResources keeps to share with later loads,
+        // see Pbr::AssetCache::SetTextureCapacity.
+        std::optional<size_t> AssetCacheTextureCapacity{std::nullopt};
+
+        // When set, the statistics of the asset cache of Context::PbrResources are written to the debug output every this many
+        // frames.
+        std::optional<uint32_t> AssetCacheTraceIntervalFrames{std::nullopt};
+
+        // When set, the render passes and CPU submission time per frame of the projection layers are written to the debug output
+        // every this many frames, see engine::RenderStatistics.
+        std::optional<uint32_t> RenderStatisticsTraceIntervalFrames{std::nullopt};
+
+        // When set, the mip levels of the textures of glTF models loaded with Context::PbrResources are streamed within a
+        // memory budget by the size the textures are seen at, see Pbr::TextureResidency.
+        std::optional<Pbr::ResidencyOptions> TextureResidency{std::nullopt};
+
+        // When set, any heap allocation made in the frame loop after this many frames fails the app, see
+        // sample::allocation::EnableStrictSteadyState. Allocations that are expected, such as starting to load an asset, must be
+        // made in a sample::allocation::AllowAllocationsScope.
+        // This only has an effect if the app links in the allocation hooks, see SampleShared/AllocationProfiler.h.
+        std::optional<uint32_t> StrictSteadyStateWarmupFrames{std::nullopt};
+
+        // When set, the allocations of the frame loop are written to the debug output every this many frames, by scope.
+        // This only has an effect if the app links in the allocation hooks.
+        std::optional<uint32_t> AllocationTraceIntervalFrames{std::nullopt};
     };
 
     std::unique_ptr<XrApp> CreateXrApp(XrAppConfiguration appConfiguration);
@@ -15,6 +15,7 @@
 //*********************************************************
 #pragma once
 
+#include <atomic>
 #include <set>
 #include <list>
 #include <unordered_map>
@@ -32,6 +33,7 @@ namespace xr {
             strcpy_s(actionSetCreateInfo.localizedActionSetName, localizedName);
             actionSetCreateInfo.priority = priority;
             CHECK_XRCMD(xrCreateActionSet(m_instance, &actionSetCreateInfo, m_actionSet.Put()));
+            BumpGeneration();
         }
 
         XrAction CreateAction(const char* actionName,
@@ -54,16 +56,20 @@ namespace xr {
             xr::ActionHandle action;
             CHECK_XRCMD(xrCreateAction(m_actionSet.Get(), &actionCreateInfo, action.Put()));
 
-            m_actions.push_back(std::move(action));
+            m_actions.push_back(Action{std::move(action), actionType, std::move(subActionXrPaths)});
+            BumpGeneration();
 
-            return m_actions.back().Get();
+            return m_actions.back().Handle.Get();
         }
 
         bool Active() const {
             return m_active;
         }
         void SetActive(bool active) {
-            m_active = active;
+            if (m_active != active) {
+                m_active = active;
+                BumpGeneration();
+            }
         }
 
         XrActionSet Handle() const {
@@ -74,14 +80,163 @@ namespace xr {
             return m_declaredSubactionPaths;
         }
 
+        // A counter that changes whenever any action set or action is created, or any action set is activated or deactivated.
+        // Lets per-frame code cache data derived from the action sets and rebuild it only when the counter changes.
+        static uint64_t Generation() {
+            return GenerationCounter().load(std::memory_order_acquire);
+        }
+
     private:
+        friend class ActionStateSnapshot;
+
+        struct Action {
+            xr::ActionHandle Handle;
+            XrActionType Type;
+            std::vector<XrPath> SubactionPaths;
+        };
+
+        static std::atomic<uint64_t>& GenerationCounter() {
+            static std::atomic<uint64_t> generation{0};
+            return generation;
+        }
+
+        static void BumpGeneration() {
+            GenerationCounter().fetch_add(1, std::memory_order_release);
+        }
+
         const XrInstance m_instance;
         xr::ActionSetHandle m_actionSet;
-        std::vector<xr::ActionHandle> m_actions;
+        std::vector<Action> m_actions;
         bool m_active{true};
         std::set<XrPath> m_declaredSubactionPaths;
     };
 
+    //
+    // The states of the input actions of an ActionContext, queried once per frame right after xrSyncActions.
+    // Every action is queried for the XR_NULL_PATH subaction path and for each subaction path it was created with.
+    // Reading a state from the snapshot doesn't call into the runtime, so any number of scenes and objects can poll the same
+    // actions during the frame update. Actions of inactive action sets read as inactive, and so do the actions the snapshot has no
+    // state for: actions created after the last update, actions of another context, and lookups with a subaction path or an
+    // action type the action wasn't created with.
+    //
+    class ActionStateSnapshot {
+    public:
+        const XrActionStateBoolean& Boolean(XrAction action, XrPath subactionPath = XR_NULL_PATH) const {
+            return Find(action, subactionPath, XR_ACTION_TYPE_BOOLEAN_INPUT).Boolean;
+        }
+
+        const XrActionStateFloat& Float(XrAction action, XrPath subactionPath = XR_NULL_PATH) const {
+            return Find(action, subactionPath, XR_ACTION_TYPE_FLOAT_INPUT).Float;
+        }
+
+        const XrActionStateVector2f& Vector2f(XrAction action, XrPath subactionPath = XR_NULL_PATH) const {
+            return Find(action, subactionPath, XR_ACTION_TYPE_VECTOR2F_INPUT).Vector2f;
+        }
+
+        const XrActionStatePose& Pose(XrAction action, XrPath subactionPath = XR_NULL_PATH) const {
+            return Find(action, subactionPath, XR_ACTION_TYPE_POSE_INPUT).Pose;
+        }
+
+        template <typename ActionSetRange>
+        void Update(XrSession session, const ActionSetRange& actionSets) {
+            const uint64_t generation = ActionSet::Generation();
+            if (generation != m_generation) {
+                Rebuild(actionSets);
+                m_generation = generation;
+            }
+
+            for (Entry& entry : m_entries) {
+                if (!entry.Set->Active()) {
+                    entry.ResetStates();
+                    continue;
+                }
+
+                XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
+                getInfo.action = entry.Action;
+                getInfo.subactionPath = entry.SubactionPath;
+                switch (entry.Type) {
+                case XR_ACTION_TYPE_BOOLEAN_INPUT:
+                    CHECK_XRCMD(xrGetActionStateBoolean(session, &getInfo, &entry.Boolean));
+                    break;
+                case XR_ACTION_TYPE_FLOAT_INPUT:
+                    CHECK_XRCMD(xrGetActionStateFloat(session, &getInfo, &entry.Float));
+                    break;
+                case XR_ACTION_TYPE_VECTOR2F_INPUT:
+                    CHECK_XRCMD(xrGetActionStateVector2f(session, &getInfo, &entry.Vector2f));
+                    break;
+                case XR_ACTION_TYPE_POSE_INPUT:
+                    CHECK_XRCMD(xrGetActionStatePose(session, &getInfo, &entry.Pose));
+                    break;
+                }
+            }
+        }
+
+    private:
+        struct Entry {
+            const ActionSet* Set;
+            XrAction Action;
+            XrPath SubactionPath;
+            XrActionType Type;
+            XrActionStateBoolean Boolean{XR_TYPE_ACTION_STATE_BOOLEAN};
+            XrActionStateFloat Float{XR_TYPE_ACTION_STATE_FLOAT};
+            XrActionStateVector2f Vector2f{XR_TYPE_ACTION_STATE_VECTOR2F};
+            XrActionStatePose Pose{XR_TYPE_ACTION_STATE_POSE};
+
+            void ResetStates() {
+                Boolean = {XR_TYPE_ACTION_STATE_BOOLEAN};
+                Float = {XR_TYPE_ACTION_STATE_FLOAT};
+                Vector2f = {XR_TYPE_ACTION_STATE_VECTOR2F};
+                Pose = {XR_TYPE_ACTION_STATE_POSE};
+            }
+        };
+
+        struct EntryKeyHash {
+            size_t operator()(const std::pair<XrAction, XrPath>& key) const {
+                return std::hash<XrAction>{}(key.first) ^ (std::hash<XrPath>{}(key.second) * 31);
+            }
+        };
+
+        template <typename ActionSetRange>
+        void Rebuild(const ActionSetRange& actionSets) {
+            m_entries.clear();
+            m_entryIndices.clear();
+            for (const ActionSet& actionSet : actionSets) {
+                for (const ActionSet::Action& action : actionSet.m_actions) {
+                    if (action.Type == XR_ACTION_TYPE_VIBRATION_OUTPUT) {
+                        continue; // Output actions have no state.
+                    }
+                    AddEntry(actionSet, action, XR_NULL_PATH);
+                    for (XrPath subactionPath : action.SubactionPaths) {
+                        AddEntry(actionSet, action, subactionPath);
+                    }
+                }
+            }
+        }
+
+        void AddEntry(const ActionSet& actionSet, const ActionSet::Action& action, XrPath subactionPath) {
+            m_entryIndices.emplace(std::make_pair(action.Handle.Get(), subactionPath), m_entries.size());
+            m_entries.push_back(Entry{&actionSet, action.Handle.Get(), subactionPath, action.Type});
+        }
+
+        const Entry& Find(XrAction action, XrPath subactionPath, XrActionType type) const {
+            const auto it = m_entryIndices.find({action, subactionPath});
+            if (it == m_entryIndices.end() || m_entries[it->second].Type != type) {
+                return InactiveEntry();
+            }
+            return m_entries[it->second];
+        }
+
+        // Its states are zero initialized, so all of them have isActive set to XR_FALSE.
+        static const Entry& InactiveEntry() {
+            static const Entry entry{nullptr, XR_NULL_HANDLE, XR_NULL_PATH, XR_ACTION_TYPE_BOOLEAN_INPUT};
+            return entry;
+        }
+
+        uint64_t m_generation{~0ull};
+        std::vector<Entry> m_entries;
+        std::unordered_map<std::pair<XrAction, XrPath>, size_t, EntryKeyHash> m_entryIndices;
+    };
+
     //
     // OpenXR requires one xrSuggestInteractionProfileBindings call for each interaction profile
     // and one xrAttachSessionActionSets for each session.
@@ -106,15 +261,26 @@ namespace xr {
             }
         }
 
+        // The action states of this context as of the last SyncActions call that included it.
+        const ActionStateSnapshot& ActionStates() const {
+            return m_actionStates;
+        }
+
     private:
         XrInstance m_instance;
         std::list<ActionSet> m_actionSets;
         std::unordered_map<XrPath, std::vector<std::pair<XrAction, std::string>>> m_actionBindings;
 
+        // Refreshed by SyncActions, which only has const access to the contexts.
+        mutable ActionStateSnapshot m_actionStates;
+
         friend void AttachActionsToSession(XrInstance instance,
                                            XrSession session,
                                            const std::vector<const xr::ActionContext*>& actionContexts);
-        friend void SyncActions(XrSession session, const std::vector<const xr::ActionContext*>& actionContexts);
+        template <typename ActionContextRange, typename ActiveActionSetVector>
+        friend void AppendActiveActionSets(const ActionContextRange& actionContexts, ActiveActionSetVector& activeActionSets);
+        template <typename ActionContextRange>
+        friend void UpdateActionStates(XrSession session, const ActionContextRange& actionContexts);
     };
 
     inline void AttachActionsToSession(XrInstance instance,
@@ -154,9 +320,8 @@ namespace xr {
         }
     }
 
-    inline void SyncActions(XrSession session, const std::vector<const xr::ActionContext*>& actionContexts) {
-        std::vector<XrActiveActionSet> activeActionSets;
-
+    template <typename ActionContextRange, typename ActiveActionSetVector>
+    void AppendActiveActionSets(const ActionContextRange& actionContexts, ActiveActionSetVector& activeActionSets) {
         for (const xr::ActionContext* actionContext : actionContexts) {
             for (const xr::ActionSet& actionSet : actionContext->m_actionSets) {
                 if (!actionSet.Active()) {
@@ -171,7 +336,17 @@ namespace xr {
                 }
             }
         }
+    }
 
+    template <typename ActionContextRange>
+    void UpdateActionStates(XrSession session, const ActionContextRange& actionContexts) {
+        for (const xr::ActionContext* actionContext : actionContexts) {
+            actionContext->m_actionStates.Update(session, actionContext->m_actionSets);
+        }
+    }
+
+    template <typename ActiveActionSetVector>
+    void SyncActiveActionSets(XrSession session, const ActiveActionSetVector& activeActionSets) {
         if (!activeActionSets.empty()) {
             XrActionsSyncInfo syncInfo{XR_TYPE_ACTIONS_SYNC_INFO};
             syncInfo.countActiveActionSets = static_cast<uint32_t>(std::size(activeActionSets));
@@ -180,4 +355,40 @@ namespace xr {
         }
     }
 
+    inline void SyncActions(XrSession session, const std::vector<const xr::ActionContext*>& actionContexts) {
+        std::vector<XrActiveActionSet> activeActionSets;
+        AppendActiveActionSets(actionContexts, activeActionSets);
+        SyncActiveActionSets(session, activeActionSets);
+        UpdateActionStates(session, actionContexts);
+    }
+
+    //
+    // Syncs the actions of a changing group of action contexts every frame.
+    // The XrActiveActionSet array is cached, and only rebuilt when the list of contexts changes
+    // or when an action set is created, activated or deactivated.
+    // After syncing, the action state snapshot of each context is refreshed.
+    //
+    class ActionSynchronizer {
+    public:
+        template <typename ActionContextRange>
+        void SyncActions(XrSession session, const ActionContextRange& actionContexts) {
+            const uint64_t generation = ActionSet::Generation();
+            if (generation != m_generation ||
+                !std::equal(std::begin(actionContexts), std::end(actionContexts), m_actionContexts.begin(), m_actionContexts.end())) {
+                m_actionContexts.assign(std::begin(actionContexts), std::end(actionContexts));
+                m_activeActionSets.clear();
+                AppendActiveActionSets(m_actionContexts, m_activeActionSets);
+                m_generation = generation;
+            }
+
+            SyncActiveActionSets(session, m_activeActionSets);
+            UpdateActionStates(session, m_actionContexts);
+        }
+
+    private:
+        uint64_t m_generation{~0ull};
+        std::vector<const xr::ActionContext*> m_actionContexts;
+        std::vector<XrActiveActionSet> m_activeActionSets;
+    };
+
 } // namespace xr
@@ -44,6 +44,26 @@ namespace xr::math {
 
         template <typename Quaternion, typename Vector3>
         constexpr XrPosef MakePose(const Quaternion& orientation, const Vector3& position);
+
+        // Array versions of the functions above, processing four poses per SIMD operation. The result may be the same array as an input.
+        void Multiply(const XrPosef* a, const XrPosef* b, XrPosef* result, size_t count); // result[i] = a[i] * b[i]
+        void Multiply(const XrPosef* a, const XrPosef& b, XrPosef* result, size_t count); // result[i] = a[i] * b
+        void Invert(const XrPosef* poses, XrPosef* result, size_t count);
+        void Slerp(const XrPosef* a, const XrPosef* b, float alpha, XrPosef* result, size_t count);
+        void TransformPoints(const XrPosef& pose, const XrVector3f* points, XrVector3f* result, size_t count);
+        void ToMatrices(const XrPosef* poses, DirectX::XMFLOAT4X4* result, size_t count); // Same matrices as LoadXrPose
+    } // namespace Pose
+
+    // Four poses stored as one register per component, so that each SIMD operation processes all four.
+    struct PoseSoA {
+        DirectX::XMVECTOR OrientationX, OrientationY, OrientationZ, OrientationW;
+        DirectX::XMVECTOR PositionX, PositionY, PositionZ;
+    };
+
+    namespace Pose {
+        PoseSoA XM_CALLCONV Multiply(const PoseSoA& a, const PoseSoA& b);
+        PoseSoA XM_CALLCONV Invert(const PoseSoA& poses);
+        PoseSoA XM_CALLCONV Slerp(const PoseSoA& a, const PoseSoA& b, float alpha);
     } // namespace Pose
 
     namespace Quaternion {
@@ -62,7 +82,7 @@ namespace xr::math {
     struct ViewProjection {
         XrPosef Pose;
         XrFovf Fov;
-        NearFar NearFar;
+        math::NearFar NearFar; // Qualified, since the member hides the type name.
     };
 
     // Type conversion between math types
@@ -76,6 +96,7 @@ namespace xr::math {
     DirectX::XMVECTOR XM_CALLCONV LoadXrQuaternion(const XrQuaternionf& quaternion);
     DirectX::XMMATRIX XM_CALLCONV LoadXrPose(const XrPosef& rigidTransform);
     DirectX::XMMATRIX XM_CALLCONV LoadInvertedXrPose(const XrPosef& rigidTransform);
+    PoseSoA XM_CALLCONV LoadXrPoses(const XrPosef* poses); // Loads four poses
     DirectX::XMVECTOR XM_CALLCONV LoadXrExtent(const XrExtent2Df& extend);
 
     // Convert DX types to XR
@@ -84,6 +105,7 @@ namespace xr::math {
     void XM_CALLCONV StoreXrVector4(XrVector4f* outVec, DirectX::FXMVECTOR inVec);
     void XM_CALLCONV StoreXrQuaternion(XrQuaternionf* outQuat, DirectX::FXMVECTOR inQuat);
     bool XM_CALLCONV StoreXrPose(XrPosef* out, DirectX::FXMMATRIX matrix);
+    void XM_CALLCONV StoreXrPoses(XrPosef* out, const PoseSoA& poses); // Stores four poses
     void XM_CALLCONV StoreXrExtent(XrExtent2Df* extend, DirectX::FXMVECTOR inVec);
 
     // Projection matrix math
@@ -450,6 +472,267 @@ namespace xr::math {
 
     } // namespace Quaternion
 
+    // Four consecutive poses are 28 floats, so they are moved as seven vectors and rearranged in registers.
+    static_assert(sizeof(XrPosef) == 7 * sizeof(float));
+
+    inline PoseSoA XM_CALLCONV LoadXrPoses(const XrPosef* poses) {
+        using namespace DirectX;
+        const XMFLOAT4* source = reinterpret_cast<const XMFLOAT4*>(poses);
+        const XMVECTOR v0 = XMLoadFloat4(source + 0); // q0x q0y q0z q0w
+        const XMVECTOR v1 = XMLoadFloat4(source + 1); // p0x p0y p0z q1x
+        const XMVECTOR v2 = XMLoadFloat4(source + 2); // q1y q1z q1w p1x
+        const XMVECTOR v3 = XMLoadFloat4(source + 3); // p1y p1z q2x q2y
+        const XMVECTOR v4 = XMLoadFloat4(source + 4); // q2z q2w p2x p2y
+        const XMVECTOR v5 = XMLoadFloat4(source + 5); // p2z q3x q3y q3z
+        const XMVECTOR v6 = XMLoadFloat4(source + 6); // q3w p3x p3y p3z
+
+        const XMMATRIX orientations = XMMatrixTranspose(
+            XMMATRIX(v0, XMVectorPermute<3, 4, 5, 6>(v1, v2), XMVectorPermute<2, 3, 4, 5>(v3, v4), XMVectorPermute<1, 2, 3, 4>(v5, v6)));
+        const XMMATRIX positions = XMMatrixTranspose(
+            XMMATRIX(v1, XMVectorPermute<3, 4, 5, 5>(v2, v3), XMVectorPermute<2, 3, 4, 4>(v4, v5), XMVectorSwizzle<1, 2, 3, 3>(v6)));
+        return {orientations.r[0], orientations.r[1], orientations.r[2], orientations.r[3], positions.r[0], positions.r[1], positions.r[2]};
+    }
+
+    inline void XM_CALLCONV StoreXrPoses(XrPosef* out, const PoseSoA& poses) {
+        using namespace DirectX;
+        const XMMATRIX q = XMMatrixTranspose(XMMATRIX(poses.OrientationX, poses.OrientationY, poses.OrientationZ, poses.OrientationW));
+        const XMMATRIX p = XMMatrixTranspose(XMMATRIX(poses.PositionX, poses.PositionY, poses.PositionZ, g_XMZero));
+
+        XMFLOAT4* destination = reinterpret_cast<XMFLOAT4*>(out);
+        XMStoreFloat4(destination + 0, q.r[0]);
+        XMStoreFloat4(destination + 1, XMVectorPermute<0, 1, 2, 4>(p.r[0], q.r[1]));
+        XMStoreFloat4(destination + 2, XMVectorPermute<1, 2, 3, 4>(q.r[1], p.r[1]));
+        XMStoreFloat4(destination + 3, XMVectorPermute<1, 2, 4, 5>(p.r[1], q.r[2]));
+        XMStoreFloat4(destination + 4, XMVectorPermute<2, 3, 4, 5>(q.r[2], p.r[2]));
+        XMStoreFloat4(destination + 5, XMVectorPermute<2, 4, 5, 6>(p.r[2], q.r[3]));
+        XMStoreFloat4(destination + 6, XMVectorPermute<3, 4, 5, 6>(q.r[3], p.r[3]));
+    }
+
+    namespace detail {
+        // The quaternion product that rotates by q1 and then by q2, matching XMQuaternionMultiply(q1, q2), for four quaternions.
+        inline void XM_CALLCONV QuaternionMultiplySoA(const PoseSoA& q1, const PoseSoA& q2, PoseSoA* result) {
+            using namespace DirectX;
+            const XMVECTOR ax = q1.OrientationX, ay = q1.OrientationY, az = q1.OrientationZ, aw = q1.OrientationW;
+            const XMVECTOR bx = q2.OrientationX, by = q2.OrientationY, bz = q2.OrientationZ, bw = q2.OrientationW;
+            // x = bw ax + bx aw + by az - bz ay, and so on for y and z. w = bw aw - bx ax - by ay - bz az.
+            XMVECTOR x = XMVectorMultiply(bw, ax);
+            x = XMVectorMultiplyAdd(bx, aw, x);
+            x = XMVectorMultiplyAdd(by, az, x);
+            result->OrientationX = XMVectorNegativeMultiplySubtract(bz, ay, x);
+            XMVECTOR y = XMVectorMultiply(bw, ay);
+            y = XMVectorMultiplyAdd(by, aw, y);
+            y = XMVectorMultiplyAdd(bz, ax, y);
+            result->OrientationY = XMVectorNegativeMultiplySubtract(bx, az, y);
+            XMVECTOR z = XMVectorMultiply(bw, az);
+            z = XMVectorMultiplyAdd(bz, aw, z);
+            z = XMVectorMultiplyAdd(bx, ay, z);
+            result->OrientationZ = XMVectorNegativeMultiplySubtract(by, ax, z);
+            XMVECTOR w = XMVectorMultiply(bw, aw);
+            w = XMVectorNegativeMultiplySubtract(bx, ax, w);
+            w = XMVectorNegativeMultiplySubtract(by, ay, w);
+            result->OrientationW = XMVectorNegativeMultiplySubtract(bz, az, w);
+        }
+
+        // Rotates four vectors by the orientations of four poses, matching XMVector3Rotate. With u the vector part of the quaternion,
+        // t = 2 (u x v) and v' = v + w t + u x t.
+        inline void XM_CALLCONV RotateSoA(const PoseSoA& q,
+                                          DirectX::FXMVECTOR vx,
+                                          DirectX::FXMVECTOR vy,
+                                          DirectX::FXMVECTOR vz,
+                                          DirectX::XMVECTOR* rx,
+                                          DirectX::XMVECTOR* ry,
+                                          DirectX::XMVECTOR* rz) {
+            using namespace DirectX;
+            const XMVECTOR ux = q.OrientationX, uy = q.OrientationY, uz = q.OrientationZ, w = q.OrientationW;
+            const XMVECTOR tx = XMVectorScale(XMVectorNegativeMultiplySubtract(uz, vy, XMVectorMultiply(uy, vz)), 2);
+            const XMVECTOR ty = XMVectorScale(XMVectorNegativeMultiplySubtract(ux, vz, XMVectorMultiply(uz, vx)), 2);
+            const XMVECTOR tz = XMVectorScale(XMVectorNegativeMultiplySubtract(uy, vx, XMVectorMultiply(ux, vy)), 2);
+            *rx = XMVectorAdd(XMVectorMultiplyAdd(w, tx, vx), XMVectorNegativeMultiplySubtract(uz, ty, XMVectorMultiply(uy, tz)));
+            *ry = XMVectorAdd(XMVectorMultiplyAdd(w, ty, vy), XMVectorNegativeMultiplySubtract(ux, tz, XMVectorMultiply(uz, tx)));
+            *rz = XMVectorAdd(XMVectorMultiplyAdd(w, tz, vz), XMVectorNegativeMultiplySubtract(uy, tx, XMVectorMultiply(ux, ty)));
+        }
+
+        inline PoseSoA XM_CALLCONV ReplicatePose(const XrPosef& pose) {
+            using namespace DirectX;
+            return {XMVectorReplicate(pose.orientation.x),
+                    XMVectorReplicate(pose.orientation.y),
+                    XMVectorReplicate(pose.orientation.z),
+                    XMVectorReplicate(pose.orientation.w),
+                    XMVectorReplicate(pose.position.x),
+                    XMVectorReplicate(pose.position.y),
+                    XMVectorReplicate(pose.position.z)};
+        }
+    } // namespace detail
+
+    namespace Pose {
+        inline PoseSoA XM_CALLCONV Multiply(const PoseSoA& a, const PoseSoA& b) {
+            // Same as the single pose version: Qc = Qa * Qb and Pc = XMVector3Rotate(Pa, Qb) + Pb
+            PoseSoA c;
+            detail::QuaternionMultiplySoA(a, b, &c);
+            detail::RotateSoA(b, a.PositionX, a.PositionY, a.PositionZ, &c.PositionX, &c.PositionY, &c.PositionZ);
+            c.PositionX = DirectX::XMVectorAdd(c.PositionX, b.PositionX);
+            c.PositionY = DirectX::XMVectorAdd(c.PositionY, b.PositionY);
+            c.PositionZ = DirectX::XMVectorAdd(c.PositionZ, b.PositionZ);
+            return c;
+        }
+
+        inline PoseSoA XM_CALLCONV Invert(const PoseSoA& poses) {
+            using namespace DirectX;
+            PoseSoA result;
+            result.OrientationX = XMVectorNegate(poses.OrientationX);
+            result.OrientationY = XMVectorNegate(poses.OrientationY);
+            result.OrientationZ = XMVectorNegate(poses.OrientationZ);
+            result.OrientationW = poses.OrientationW;
+            detail::RotateSoA(result,
+                              XMVectorNegate(poses.PositionX),
+                              XMVectorNegate(poses.PositionY),
+                              XMVectorNegate(poses.PositionZ),
+                              &result.PositionX,
+                              &result.PositionY,
+                              &result.PositionZ);
+            return result;
+        }
+
+        inline PoseSoA XM_CALLCONV Slerp(const PoseSoA& a, const PoseSoA& b, float alpha) {
+            // Same weights as XMQuaternionSlerp, computed for four quaternions at once.
+            using namespace DirectX;
+            const XMVECTOR t = XMVectorReplicate(alpha);
+            XMVECTOR cosOmega = XMVectorMultiply(a.OrientationW, b.OrientationW);
+            cosOmega = XMVectorMultiplyAdd(a.OrientationZ, b.OrientationZ, cosOmega);
+            cosOmega = XMVectorMultiplyAdd(a.OrientationY, b.OrientationY, cosOmega);
+            cosOmega = XMVectorMultiplyAdd(a.OrientationX, b.OrientationX, cosOmega);
+            const XMVECTOR sign = XMVectorSelect(g_XMOne, g_XMNegativeOne, XMVectorLess(cosOmega, g_XMZero));
+            cosOmega = XMVectorAbs(cosOmega);
+
+            const XMVECTOR sinOmega = XMVectorSqrt(XMVectorNegativeMultiplySubtract(cosOmega, cosOmega, g_XMOne));
+            const XMVECTOR omega = XMVectorATan2(sinOmega, cosOmega);
+            const XMVECTOR inverseSinOmega = XMVectorReciprocal(sinOmega);
+            XMVECTOR weightA = XMVectorMultiply(XMVectorSin(XMVectorMultiply(XMVectorSubtract(g_XMOne, t), omega)), inverseSinOmega);
+            XMVECTOR weightB = XMVectorMultiply(XMVectorSin(XMVectorMultiply(t, omega)), inverseSinOmega);
+
+            // Nearly parallel quaternions fall back to a linear interpolation, like XMQuaternionSlerp.
+            const XMVECTOR nearlyParallel = XMVectorGreater(cosOmega, XMVectorReplicate(1.0f - 0.00001f));
+            weightA = XMVectorSelect(weightA, XMVectorSubtract(g_XMOne, t), nearlyParallel);
+            weightB = XMVectorMultiply(XMVectorSelect(weightB, t, nearlyParallel), sign);
+
+            PoseSoA result;
+            result.OrientationX = XMVectorMultiplyAdd(a.OrientationX, weightA, XMVectorMultiply(b.OrientationX, weightB));
+            result.OrientationY = XMVectorMultiplyAdd(a.OrientationY, weightA, XMVectorMultiply(b.OrientationY, weightB));
+            result.OrientationZ = XMVectorMultiplyAdd(a.OrientationZ, weightA, XMVectorMultiply(b.OrientationZ, weightB));
+            result.OrientationW = XMVectorMultiplyAdd(a.OrientationW, weightA, XMVectorMultiply(b.OrientationW, weightB));
+            result.PositionX = XMVectorLerpV(a.PositionX, b.PositionX, t);
+            result.PositionY = XMVectorLerpV(a.PositionY, b.PositionY, t);
+            result.PositionZ = XMVectorLerpV(a.PositionZ, b.PositionZ, t);
+            return result;
+        }
+
+        inline void Multiply(const XrPosef* a, const XrPosef* b, XrPosef* result, size_t count) {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                StoreXrPoses(result + i, Multiply(LoadXrPoses(a + i), LoadXrPoses(b + i)));
+            }
+            for (; i < count; i++) {
+                result[i] = Multiply(a[i], b[i]);
+            }
+        }
+
+        inline void Multiply(const XrPosef* a, const XrPosef& b, XrPosef* result, size_t count) {
+            const PoseSoA replicated = detail::ReplicatePose(b);
+            const XrPosef single = b; // b may be an element of result
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                StoreXrPoses(result + i, Multiply(LoadXrPoses(a + i), replicated));
+            }
+            for (; i < count; i++) {
+                result[i] = Multiply(a[i], single);
+            }
+        }
+
+        inline void Invert(const XrPosef* poses, XrPosef* result, size_t count) {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                StoreXrPoses(result + i, Invert(LoadXrPoses(poses + i)));
+            }
+            for (; i < count; i++) {
+                result[i] = Invert(poses[i]);
+            }
+        }
+
+        inline void Slerp(const XrPosef* a, const XrPosef* b, float alpha, XrPosef* result, size_t count) {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                StoreXrPoses(result + i, Slerp(LoadXrPoses(a + i), LoadXrPoses(b + i), alpha));
+            }
+            for (; i < count; i++) {
+                result[i] = Slerp(a[i], b[i], alpha);
+            }
+        }
+
+        inline void TransformPoints(const XrPosef& pose, const XrVector3f* points, XrVector3f* result, size_t count) {
+            using namespace DirectX;
+            const PoseSoA replicated = detail::ReplicatePose(pose);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const XMMATRIX p = XMMatrixTranspose(XMMATRIX(LoadXrVector3(points[i]),
+                                                              LoadXrVector3(points[i + 1]),
+                                                              LoadXrVector3(points[i + 2]),
+                                                              LoadXrVector3(points[i + 3])));
+                XMMATRIX r;
+                detail::RotateSoA(replicated, p.r[0], p.r[1], p.r[2], &r.r[0], &r.r[1], &r.r[2]);
+                r.r[0] = XMVectorAdd(r.r[0], replicated.PositionX);
+                r.r[1] = XMVectorAdd(r.r[1], replicated.PositionY);
+                r.r[2] = XMVectorAdd(r.r[2], replicated.PositionZ);
+                r.r[3] = g_XMZero;
+                r = XMMatrixTranspose(r);
+                for (size_t k = 0; k < 4; k++) {
+                    StoreXrVector3(&result[i + k], r.r[k]);
+                }
+            }
+
+            const XMVECTOR orientation = LoadXrQuaternion(pose.orientation);
+            const XMVECTOR position = LoadXrVector3(pose.position);
+            for (; i < count; i++) {
+                StoreXrVector3(&result[i], XMVectorAdd(XMVector3Rotate(LoadXrVector3(points[i]), orientation), position));
+            }
+        }
+
+        inline void ToMatrices(const XrPosef* poses, DirectX::XMFLOAT4X4* result, size_t count) {
+            using namespace DirectX;
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const PoseSoA p = LoadXrPoses(poses + i);
+
+                // The rows of XMMatrixRotationQuaternion, one register per element.
+                const XMVECTOR x2 = XMVectorAdd(p.OrientationX, p.OrientationX);
+                const XMVECTOR y2 = XMVectorAdd(p.OrientationY, p.OrientationY);
+                const XMVECTOR z2 = XMVectorAdd(p.OrientationZ, p.OrientationZ);
+                const XMVECTOR xx = XMVectorMultiply(p.OrientationX, x2);
+                const XMVECTOR yy = XMVectorMultiply(p.OrientationY, y2);
+                const XMVECTOR zz = XMVectorMultiply(p.OrientationZ, z2);
+                const XMVECTOR xy = XMVectorMultiply(p.OrientationX, y2);
+                const XMVECTOR xz = XMVectorMultiply(p.OrientationX, z2);
+                const XMVECTOR yz = XMVectorMultiply(p.OrientationY, z2);
+                const XMVECTOR wx = XMVectorMultiply(p.OrientationW, x2);
+                const XMVECTOR wy = XMVectorMultiply(p.OrientationW, y2);
+                const XMVECTOR wz = XMVectorMultiply(p.OrientationW, z2);
+
+                const XMMATRIX row0 = XMMatrixTranspose(
+                    XMMATRIX(XMVectorSubtract(g_XMOne, XMVectorAdd(yy, zz)), XMVectorAdd(xy, wz), XMVectorSubtract(xz, wy), g_XMZero));
+                const XMMATRIX row1 = XMMatrixTranspose(
+                    XMMATRIX(XMVectorSubtract(xy, wz), XMVectorSubtract(g_XMOne, XMVectorAdd(xx, zz)), XMVectorAdd(yz, wx), g_XMZero));
+                const XMMATRIX row2 = XMMatrixTranspose(
+                    XMMATRIX(XMVectorAdd(xz, wy), XMVectorSubtract(yz, wx), XMVectorSubtract(g_XMOne, XMVectorAdd(xx, yy)), g_XMZero));
+                const XMMATRIX row3 = XMMatrixTranspose(XMMATRIX(p.PositionX, p.PositionY, p.PositionZ, g_XMOne));
+                for (size_t k = 0; k < 4; k++) {
+                    XMStoreFloat4x4(&result[i + k], XMMATRIX(row0.r[k], row1.r[k], row2.r[k], row3.r[k]));
+                }
+            }
+            for (; i < count; i++) {
+                XMStoreFloat4x4(&result[i], LoadXrPose(poses[i]));
+            }
+        }
+    } // namespace Pose
+
     inline XrPosef operator*(const XrPosef& a, const XrPosef& b) {
         return Pose::Multiply(a, b);
     }
@@ -0,0 +1,554 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <vector>
+#include "XrMath.h"
+
+// Prediction and filtering of tracked poses.
+//
+// Poses returned by xrLocateSpace and xrLocateHandJointsEXT carry the jitter of the tracking system, and they are only predicted to the
+// time they were located for. These helpers make the trade-off between latency and jitter explicit:
+//  - Pose::Extrapolate and PosePredictor predict a pose to another time with a constant velocity or constant acceleration model.
+//  - OneEuroFilter smooths strongly while a pose is nearly still and follows closely when it moves fast.
+//  - DoubleExponentialFilter smooths with a fixed factor and extrapolates along the smoothed trend.
+//  - JointsOneEuroFilter runs the One-Euro filter over a whole joint set, such as both hands, four joints per SIMD register.
+namespace xr::math {
+    enum class ExtrapolationModel { ConstantVelocity, ConstantAcceleration };
+
+    struct OneEuroParameters {
+        float MinCutoff;        // Cutoff frequency in Hz while still. Lower values remove more jitter but add lag at low speed.
+        float Beta;             // How quickly the cutoff frequency rises with speed. Higher values reduce lag during fast motion.
+        float DerivativeCutoff; // Cutoff frequency in Hz of the speed estimate that drives the adaptive cutoff.
+    };
+
+    // Defaults tuned for positions in meters and orientations in radians of tracked hands and controllers.
+    constexpr OneEuroParameters DefaultPositionOneEuroParameters{1.0f, 5.0f, 1.0f};
+    constexpr OneEuroParameters DefaultOrientationOneEuroParameters{1.0f, 0.5f, 1.0f};
+
+    float ToSeconds(XrDuration duration);
+
+    namespace Pose {
+        // Integrates the velocities, given in the base space of the pose, over the given time. Negative times extrapolate backwards.
+        XrPosef Extrapolate(const XrPosef& pose, const XrVector3f& linearVelocity, const XrVector3f& angularVelocity, float seconds);
+        XrPosef Extrapolate(const XrPosef& pose,
+                            const XrVector3f& linearVelocity,
+                            const XrVector3f& angularVelocity,
+                            const XrVector3f& linearAcceleration,
+                            const XrVector3f& angularAcceleration,
+                            float seconds);
+
+        // Extrapolates with the velocities of an XrSpaceVelocity chained to xrLocateSpace. Velocities not flagged valid are ignored.
+        XrPosef Extrapolate(const XrPosef& pose, const XrSpaceVelocity& velocity, XrDuration duration);
+    } // namespace Pose
+
+    // Predicts a tracked pose to any time from its most recent samples.
+    // The velocity reported by the runtime is used when it is valid, otherwise it is estimated from the previous sample.
+    // The acceleration for the constant acceleration model is always estimated from consecutive velocities.
+    class PosePredictor {
+    public:
+        void AddSample(XrTime time, const XrPosef& pose, const XrSpaceVelocity* velocity = nullptr);
+        std::optional<XrPosef> Predict(XrTime time, ExtrapolationModel model = ExtrapolationModel::ConstantVelocity) const;
+        void Reset();
+
+    private:
+        struct Sample {
+            XrTime Time;
+            XrPosef Pose;
+            XrVector3f LinearVelocity;
+            XrVector3f AngularVelocity;
+        };
+
+        std::optional<Sample> m_lastSample;
+        XrVector3f m_linearAcceleration{};
+        XrVector3f m_angularAcceleration{};
+    };
+
+    // One-Euro filter of a pose: an exponential smoothing whose cutoff frequency rises with the speed of the motion.
+    class OneEuroFilter {
+    public:
+        explicit OneEuroFilter(const OneEuroParameters& positionParameters = DefaultPositionOneEuroParameters,
+                               const OneEuroParameters& orientationParameters = DefaultOrientationOneEuroParameters);
+
+        // Returns the filtered pose. The first sample, and any sample that doesn't move forward in time, is returned unchanged.
+        XrPosef Filter(XrTime time, const XrPosef& pose);
+        void Reset();
+
+    private:
+        OneEuroParameters m_positionParameters;
+        OneEuroParameters m_orientationParameters;
+        XrTime m_lastTime{0};
+        XrPosef m_filteredPose{};
+        float m_positionSpeed{0};
+        float m_orientationSpeed{0};
+    };
+
+    // Brown's double exponential smoothing of a pose, which removes jitter with a fixed factor and predicts by following the trend of the
+    // smoothed signal. Cheaper to predict with than a Kalman filter and without the lag of a single exponential smoothing.
+    class DoubleExponentialFilter {
+    public:
+        // Smoothing in (0, 1): higher values follow the input more closely.
+        explicit DoubleExponentialFilter(float smoothing = 0.5f);
+
+        // Returns the smoothed pose at the time of the sample, with the lag of the smoothing corrected by the trend.
+        XrPosef Filter(XrTime time, const XrPosef& pose);
+
+        // Extrapolates the smoothed trend to the given time, measured in the average interval between samples.
+        std::optional<XrPosef> Predict(XrTime time) const;
+        void Reset();
+
+    private:
+        XrPosef Forecast(float samplesAhead) const;
+
+        float m_smoothing;
+        XrTime m_lastTime{0};
+        XrDuration m_sampleInterval{0};
+        XrPosef m_single{}; // Smoothed input
+        XrPosef m_double{}; // Smoothed m_single
+    };
+
+    // The One-Euro filter of a set of joints, stored as a structure of arrays so that four joints are filtered by each SIMD operation.
+    // The position filter matches OneEuroFilter. Orientations are blended with a normalized lerp and their speed is measured on the chord
+    // between quaternions, which match the slerp of OneEuroFilter closely for the small per-frame rotations of tracked joints.
+    class JointsOneEuroFilter {
+    public:
+        explicit JointsOneEuroFilter(size_t jointCount,
+                                     const OneEuroParameters& positionParameters = DefaultPositionOneEuroParameters,
+                                     const OneEuroParameters& orientationParameters = DefaultOrientationOneEuroParameters);
+
+        // Filters the poses of the joints in place. Joints without a valid pose are left unchanged and restart their filter.
+        void Filter(XrTime time, XrHandJointLocationEXT* joints, size_t jointCount);
+        void Reset();
+
+        size_t JointCount() const {
+            return m_jointCount;
+        }
+
+    private:
+        static constexpr size_t LaneCount = 4;
+
+        // The state of four joints, one per lane.
+        struct Block {
+            DirectX::XMVECTOR PositionX, PositionY, PositionZ;
+            DirectX::XMVECTOR OrientationX, OrientationY, OrientationZ, OrientationW;
+            DirectX::XMVECTOR PositionSpeed, OrientationSpeed;
+            DirectX::XMVECTOR Initialized; // Lane mask
+        };
+
+        OneEuroParameters m_positionParameters;
+        OneEuroParameters m_orientationParameters;
+        size_t m_jointCount;
+        std::vector<Block> m_blocks;
+        XrTime m_lastTime{0};
+    };
+} // namespace xr::math
+
+#pragma region Implementation
+
+namespace xr::math {
+    namespace detail {
+        // The smoothing factor of an exponential filter with the given cutoff frequency, for a sample taken after the given time.
+        inline float OneEuroAlpha(float cutoff, float seconds) {
+            const float r = DirectX::XM_2PI * cutoff * seconds;
+            return r / (r + 1);
+        }
+
+        inline DirectX::XMVECTOR XM_CALLCONV OneEuroAlpha(DirectX::FXMVECTOR cutoff, float seconds) {
+            const DirectX::XMVECTOR r = DirectX::XMVectorScale(cutoff, DirectX::XM_2PI * seconds);
+            return DirectX::XMVectorDivide(r, DirectX::XMVectorAdd(r, DirectX::g_XMOne));
+        }
+
+        // The rotation in the base space that turns orientation "from" into orientation "to", as a rotation vector.
+        inline DirectX::XMVECTOR XM_CALLCONV RotationVectorBetween(DirectX::FXMVECTOR from, DirectX::FXMVECTOR to) {
+            DirectX::XMVECTOR delta = DirectX::XMQuaternionMultiply(DirectX::XMQuaternionConjugate(from), to);
+            if (DirectX::XMVectorGetW(delta) < 0) {
+                delta = DirectX::XMVectorNegate(delta); // Take the shortest path
+            }
+
+            const float sinHalfAngle = DirectX::XMVectorGetX(DirectX::XMVector3Length(delta));
+            if (sinHalfAngle < 1e-6f) {
+                return DirectX::XMVectorScale(delta, 2); // sin(x) ~= x for tiny angles
+            }
+            const float angle = 2 * std::atan2(sinHalfAngle, DirectX::XMVectorGetW(delta));
+            return DirectX::XMVectorScale(delta, angle / sinHalfAngle);
+        }
+
+        // The quaternion of a rotation vector.
+        inline DirectX::XMVECTOR XM_CALLCONV RotationFromVector(DirectX::FXMVECTOR rotationVector) {
+            const float angle = DirectX::XMVectorGetX(DirectX::XMVector3Length(rotationVector));
+            if (angle < 1e-6f) {
+                return DirectX::XMQuaternionIdentity();
+            }
+            return DirectX::XMQuaternionRotationNormal(DirectX::XMVectorScale(rotationVector, 1 / angle), angle);
+        }
+
+        // The squared lengths of four 3D vectors and the dot products of four pairs of 4D vectors, stored one component per register.
+        inline DirectX::XMVECTOR XM_CALLCONV LengthSquared3(DirectX::FXMVECTOR x, DirectX::FXMVECTOR y, DirectX::FXMVECTOR z) {
+            return DirectX::XMVectorMultiplyAdd(x, x, DirectX::XMVectorMultiplyAdd(y, y, DirectX::XMVectorMultiply(z, z)));
+        }
+
+        inline DirectX::XMVECTOR XM_CALLCONV Dot4(DirectX::FXMVECTOR ax,
+                                                  DirectX::FXMVECTOR ay,
+                                                  DirectX::FXMVECTOR az,
+                                                  DirectX::GXMVECTOR aw,
+                                                  DirectX::HXMVECTOR bx,
+                                                  DirectX::HXMVECTOR by,
+                                                  DirectX::CXMVECTOR bz,
+                                                  DirectX::CXMVECTOR bw) {
+            using namespace DirectX;
+            return XMVectorMultiplyAdd(ax, bx, XMVectorMultiplyAdd(ay, by, XMVectorMultiplyAdd(az, bz, XMVectorMultiply(aw, bw))));
+        }
+
+        inline float XM_CALLCONV AngleBetween(DirectX::FXMVECTOR a, DirectX::FXMVECTOR b) {
+            const float dot = std::min(1.0f, std::abs(DirectX::XMVectorGetX(DirectX::XMQuaternionDot(a, b))));
+            return 2 * std::acos(dot);
+        }
+    } // namespace detail
+
+    inline float ToSeconds(XrDuration duration) {
+        return static_cast<float>(static_cast<double>(duration) * 1e-9);
+    }
+
+    namespace Pose {
+        inline XrPosef Extrapolate(const XrPosef& pose,
+                                   const XrVector3f& linearVelocity,
+                                   const XrVector3f& angularVelocity,
+                                   float seconds) {
+            return Extrapolate(pose, linearVelocity, angularVelocity, XrVector3f{0, 0, 0}, XrVector3f{0, 0, 0}, seconds);
+        }
+
+        inline XrPosef Extrapolate(const XrPosef& pose,
+                                   const XrVector3f& linearVelocity,
+                                   const XrVector3f& angularVelocity,
+                                   const XrVector3f& linearAcceleration,
+                                   const XrVector3f& angularAcceleration,
+                                   float seconds) {
+            using namespace DirectX;
+            const float halfSecondsSquared = 0.5f * seconds * seconds;
+
+            // p' = p + v t + a t^2 / 2
+            XMVECTOR position = LoadXrVector3(pose.position);
+            position = XMVectorMultiplyAdd(LoadXrVector3(linearVelocity), XMVectorReplicate(seconds), position);
+            position = XMVectorMultiplyAdd(LoadXrVector3(linearAcceleration), XMVectorReplicate(halfSecondsSquared), position);
+
+            // The angular velocity is in the base space, so the rotation is applied after the current orientation.
+            XMVECTOR rotation = XMVectorScale(LoadXrVector3(angularVelocity), seconds);
+            rotation = XMVectorMultiplyAdd(LoadXrVector3(angularAcceleration), XMVectorReplicate(halfSecondsSquared), rotation);
+            const XMVECTOR orientation =
+                XMQuaternionNormalize(XMQuaternionMultiply(LoadXrQuaternion(pose.orientation), detail::RotationFromVector(rotation)));
+
+            XrPosef result;
+            StoreXrQuaternion(&result.orientation, orientation);
+            StoreXrVector3(&result.position, position);
+            return result;
+        }
+
+        inline XrPosef Extrapolate(const XrPosef& pose, const XrSpaceVelocity& velocity, XrDuration duration) {
+            const XrVector3f zero{0, 0, 0};
+            const bool linearValid = (velocity.velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) != 0;
+            const bool angularValid = (velocity.velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) != 0;
+            return Extrapolate(pose,
+                               linearValid ? velocity.linearVelocity : zero,
+                               angularValid ? velocity.angularVelocity : zero,
+                               ToSeconds(duration));
+        }
+    } // namespace Pose
+
+    inline void PosePredictor::AddSample(XrTime time, const XrPosef& pose, const XrSpaceVelocity* velocity) {
+        using namespace DirectX;
+
+        Sample sample{time, pose, {0, 0, 0}, {0, 0, 0}};
+        const bool hasPrevious = m_lastSample.has_value() && time > m_lastSample->Time;
+        const float seconds = hasPrevious ? ToSeconds(time - m_lastSample->Time) : 0;
+
+        if (velocity != nullptr && (velocity->velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT)) {
+            sample.LinearVelocity = velocity->linearVelocity;
+        } else if (hasPrevious) {
+            sample.LinearVelocity = (pose.position - m_lastSample->Pose.position) / seconds;
+        }
+
+        if (velocity != nullptr && (velocity->velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT)) {
+            sample.AngularVelocity = velocity->angularVelocity;
+        } else if (hasPrevious) {
+            const XMVECTOR rotation =
+                detail::RotationVectorBetween(LoadXrQuaternion(m_lastSample->Pose.orientation), LoadXrQuaternion(pose.orientation));
+            StoreXrVector3(&sample.AngularVelocity, XMVectorScale(rotation, 1 / seconds));
+        }
+
+        if (hasPrevious) {
+            m_linearAcceleration = (sample.LinearVelocity - m_lastSample->LinearVelocity) / seconds;
+            m_angularAcceleration = (sample.AngularVelocity - m_lastSample->AngularVelocity) / seconds;
+        } else {
+            m_linearAcceleration = m_angularAcceleration = {0, 0, 0};
+        }
+
+        m_lastSample = sample;
+    }
+
+    inline std::optional<XrPosef> PosePredictor::Predict(XrTime time, ExtrapolationModel model) const {
+        if (!m_lastSample.has_value()) {
+            return std::nullopt;
+        }
+
+        const float seconds = ToSeconds(time - m_lastSample->Time);
+        if (model == ExtrapolationModel::ConstantAcceleration) {
+            return Pose::Extrapolate(m_lastSample->Pose,
+                                     m_lastSample->LinearVelocity,
+                                     m_lastSample->AngularVelocity,
+                                     m_linearAcceleration,
+                                     m_angularAcceleration,
+                                     seconds);
+        }
+        return Pose::Extrapolate(m_lastSample->Pose, m_lastSample->LinearVelocity, m_lastSample->AngularVelocity, seconds);
+    }
+
+    inline void PosePredictor::Reset() {
+        m_lastSample.reset();
+        m_linearAcceleration = m_angularAcceleration = {0, 0, 0};
+    }
+
+    inline OneEuroFilter::OneEuroFilter(const OneEuroParameters& positionParameters, const OneEuroParameters& orientationParameters)
+        : m_positionParameters(positionParameters)
+        , m_orientationParameters(orientationParameters) {
+    }
+
+    inline XrPosef OneEuroFilter::Filter(XrTime time, const XrPosef& pose) {
+        using namespace DirectX;
+
+        if (m_lastTime == 0 || time <= m_lastTime) {
+            m_lastTime = time;
+            m_filteredPose = pose;
+            m_positionSpeed = m_orientationSpeed = 0;
+            return pose;
+        }
+
+        const float seconds = ToSeconds(time - m_lastTime);
+        m_lastTime = time;
+
+        const XMVECTOR filteredPosition = LoadXrVector3(m_filteredPose.position);
+        const XMVECTOR position = LoadXrVector3(pose.position);
+        const float positionSpeed = XMVectorGetX(XMVector3Length(XMVectorSubtract(position, filteredPosition))) / seconds;
+        m_positionSpeed += detail::OneEuroAlpha(m_positionParameters.DerivativeCutoff, seconds) * (positionSpeed - m_positionSpeed);
+        const float positionCutoff = m_positionParameters.MinCutoff + m_positionParameters.Beta * m_positionSpeed;
+        StoreXrVector3(&m_filteredPose.position,
+                       XMVectorLerp(filteredPosition, position, detail::OneEuroAlpha(positionCutoff, seconds)));
+
+        const XMVECTOR filteredOrientation = LoadXrQuaternion(m_filteredPose.orientation);
+        const XMVECTOR orientation = LoadXrQuaternion(pose.orientation);
+        const float orientationSpeed = detail::AngleBetween(filteredOrientation, orientation) / seconds;
+        m_orientationSpeed +=
+            detail::OneEuroAlpha(m_orientationParameters.DerivativeCutoff, seconds) * (orientationSpeed - m_orientationSpeed);
+        const float orientationCutoff = m_orientationParameters.MinCutoff + m_orientationParameters.Beta * m_orientationSpeed;
+        StoreXrQuaternion(&m_filteredPose.orientation,
+                          XMQuaternionSlerp(filteredOrientation, orientation, detail::OneEuroAlpha(orientationCutoff, seconds)));
+
+        return m_filteredPose;
+    }
+
+    inline void OneEuroFilter::Reset() {
+        m_lastTime = 0;
+    }
+
+    inline DoubleExponentialFilter::DoubleExponentialFilter(float smoothing)
+        : m_smoothing(std::clamp(smoothing, 0.01f, 0.99f)) {
+    }
+
+    inline XrPosef DoubleExponentialFilter::Filter(XrTime time, const XrPosef& pose) {
+        if (m_lastTime == 0 || time <= m_lastTime) {
+            m_lastTime = time;
+            m_sampleInterval = 0;
+            m_single = m_double = pose;
+            return pose;
+        }
+
+        // Average the interval so that the prediction horizon doesn't jump with the frame time.
+        const XrDuration interval = time - m_lastTime;
+        m_sampleInterval = m_sampleInterval == 0 ? interval : (m_sampleInterval * 7 + interval) / 8;
+        m_lastTime = time;
+
+        m_single = Pose::Slerp(m_single, pose, m_smoothing);
+        m_double = Pose::Slerp(m_double, m_single, m_smoothing);
+        return Forecast(0);
+    }
+
+    inline std::optional<XrPosef> DoubleExponentialFilter::Predict(XrTime time) const {
+        if (m_lastTime == 0) {
+            return std::nullopt;
+        }
+        if (m_sampleInterval == 0) {
+            return m_single;
+        }
+        return Forecast(static_cast<float>(time - m_lastTime) / static_cast<float>(m_sampleInterval));
+    }
+
+    inline void DoubleExponentialFilter::Reset() {
+        m_lastTime = 0;
+    }
+
+    inline XrPosef DoubleExponentialFilter::Forecast(float samplesAhead) const {
+        // The forecast (2 + c) * single - (1 + c) * double, with c = a * t / (1 - a), is the interpolation from double to single
+        // by (2 + c), which extends to orientations as a slerp beyond its end point.
+        const float weight = 2 + m_smoothing * samplesAhead / (1 - m_smoothing);
+        return Pose::Slerp(m_double, m_single, weight);
+    }
+
+    inline JointsOneEuroFilter::JointsOneEuroFilter(size_t jointCount,
+                                                    const OneEuroParameters& positionParameters,
+                                                    const OneEuroParameters& orientationParameters)
+        : m_positionParameters(positionParameters)
+        , m_orientationParameters(orientationParameters)
+        , m_jointCount(jointCount)
+        , m_blocks((jointCount + LaneCount - 1) / LaneCount) {
+        Reset();
+    }
+
+    inline void JointsOneEuroFilter::Reset() {
+        for (Block& block : m_blocks) {
+            block.Initialized = DirectX::XMVectorFalseInt();
+        }
+        m_lastTime = 0;
+    }
+
+    inline void JointsOneEuroFilter::Filter(XrTime time, XrHandJointLocationEXT* joints, size_t jointCount) {
+        using namespace DirectX;
+        assert(jointCount == m_jointCount);
+
+        const bool continuous = m_lastTime != 0 && time > m_lastTime;
+        const float seconds = continuous ? ToSeconds(time - m_lastTime) : 0;
+        m_lastTime = time;
+
+        const XMVECTOR positionSpeedAlpha = XMVectorReplicate(detail::OneEuroAlpha(m_positionParameters.DerivativeCutoff, seconds));
+        const XMVECTOR orientationSpeedAlpha = XMVectorReplicate(detail::OneEuroAlpha(m_orientationParameters.DerivativeCutoff, seconds));
+        const XMVECTOR inverseSeconds = XMVectorReplicate(continuous ? 1 / seconds : 0);
+        const XMVECTOR positionMinCutoff = XMVectorReplicate(m_positionParameters.MinCutoff);
+        const XMVECTOR positionBeta = XMVectorReplicate(m_positionParameters.Beta);
+        const XMVECTOR orientationMinCutoff = XMVectorReplicate(m_orientationParameters.MinCutoff);
+        const XMVECTOR orientationBeta = XMVectorReplicate(m_orientationParameters.Beta);
+
+        for (size_t blockIndex = 0; blockIndex < m_blocks.size(); blockIndex++) {
+            Block& block = m_blocks[blockIndex];
+            const size_t first = blockIndex * LaneCount;
+            const size_t laneCount = std::min(LaneCount, jointCount - first);
+
+            // Transpose the poses of four joints into one register per component. Unused lanes hold an invalid identity pose.
+            alignas(16) float px[LaneCount] = {}, py[LaneCount] = {}, pz[LaneCount] = {};
+            alignas(16) float qx[LaneCount] = {}, qy[LaneCount] = {}, qz[LaneCount] = {}, qw[LaneCount] = {1, 1, 1, 1};
+            alignas(16) uint32_t valid[LaneCount] = {};
+            for (size_t lane = 0; lane < laneCount; lane++) {
+                const XrHandJointLocationEXT& joint = joints[first + lane];
+                px[lane] = joint.pose.position.x;
+                py[lane] = joint.pose.position.y;
+                pz[lane] = joint.pose.position.z;
+                qx[lane] = joint.pose.orientation.x;
+                qy[lane] = joint.pose.orientation.y;
+                qz[lane] = joint.pose.orientation.z;
+                qw[lane] = joint.pose.orientation.w;
+                valid[lane] = Pose::IsPoseValid(joint) ? 0xFFFFFFFF : 0;
+            }
+
+            const XMVECTOR positionX = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(px));
+            const XMVECTOR positionY = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(py));
+            const XMVECTOR positionZ = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(pz));
+            XMVECTOR orientationX = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(qx));
+            XMVECTOR orientationY = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(qy));
+            XMVECTOR orientationZ = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(qz));
+            XMVECTOR orientationW = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(qw));
+            const XMVECTOR validMask = XMLoadInt4A(valid);
+            const XMVECTOR filterMask = continuous ? XMVectorAndInt(validMask, block.Initialized) : XMVectorFalseInt();
+
+            // Positions
+            const XMVECTOR dx = XMVectorSubtract(positionX, block.PositionX);
+            const XMVECTOR dy = XMVectorSubtract(positionY, block.PositionY);
+            const XMVECTOR dz = XMVectorSubtract(positionZ, block.PositionZ);
+            const XMVECTOR positionRawSpeed = XMVectorMultiply(XMVectorSqrt(detail::LengthSquared3(dx, dy, dz)), inverseSeconds);
+            const XMVECTOR positionSpeed =
+                XMVectorMultiplyAdd(positionSpeedAlpha, XMVectorSubtract(positionRawSpeed, block.PositionSpeed), block.PositionSpeed);
+            const XMVECTOR positionAlpha =
+                detail::OneEuroAlpha(XMVectorMultiplyAdd(positionBeta, positionSpeed, positionMinCutoff), seconds);
+
+            block.PositionX = XMVectorSelect(positionX, XMVectorMultiplyAdd(positionAlpha, dx, block.PositionX), filterMask);
+            block.PositionY = XMVectorSelect(positionY, XMVectorMultiplyAdd(positionAlpha, dy, block.PositionY), filterMask);
+            block.PositionZ = XMVectorSelect(positionZ, XMVectorMultiplyAdd(positionAlpha, dz, block.PositionZ), filterMask);
+            block.PositionSpeed = XMVectorSelect(g_XMZero, positionSpeed, filterMask);
+
+            // Orientations, flipped into the hemisphere of the filtered orientation so the blend takes the shortest path.
+            const XMVECTOR dot = detail::Dot4(orientationX,
+                                              orientationY,
+                                              orientationZ,
+                                              orientationW,
+                                              block.OrientationX,
+                                              block.OrientationY,
+                                              block.OrientationZ,
+                                              block.OrientationW);
+            const XMVECTOR flip = XMVectorLess(dot, g_XMZero);
+            orientationX = XMVectorSelect(orientationX, XMVectorNegate(orientationX), flip);
+            orientationY = XMVectorSelect(orientationY, XMVectorNegate(orientationY), flip);
+            orientationZ = XMVectorSelect(orientationZ, XMVectorNegate(orientationZ), flip);
+            orientationW = XMVectorSelect(orientationW, XMVectorNegate(orientationW), flip);
+
+            const XMVECTOR qdx = XMVectorSubtract(orientationX, block.OrientationX);
+            const XMVECTOR qdy = XMVectorSubtract(orientationY, block.OrientationY);
+            const XMVECTOR qdz = XMVectorSubtract(orientationZ, block.OrientationZ);
+            const XMVECTOR qdw = XMVectorSubtract(orientationW, block.OrientationW);
+            // For unit quaternions the chord is 2 sin(angle / 4), so the rotation angle is close to twice the chord.
+            const XMVECTOR chord = XMVectorSqrt(detail::Dot4(qdx, qdy, qdz, qdw, qdx, qdy, qdz, qdw));
+            const XMVECTOR orientationRawSpeed = XMVectorMultiply(XMVectorAdd(chord, chord), inverseSeconds);
+            const XMVECTOR orientationSpeed = XMVectorMultiplyAdd(
+                orientationSpeedAlpha, XMVectorSubtract(orientationRawSpeed, block.OrientationSpeed), block.OrientationSpeed);
+            const XMVECTOR orientationAlpha =
+                detail::OneEuroAlpha(XMVectorMultiplyAdd(orientationBeta, orientationSpeed, orientationMinCutoff), seconds);
+
+            XMVECTOR blendedX = XMVectorMultiplyAdd(orientationAlpha, qdx, block.OrientationX);
+            XMVECTOR blendedY = XMVectorMultiplyAdd(orientationAlpha, qdy, block.OrientationY);
+            XMVECTOR blendedZ = XMVectorMultiplyAdd(orientationAlpha, qdz, block.OrientationZ);
+            XMVECTOR blendedW = XMVectorMultiplyAdd(orientationAlpha, qdw, block.OrientationW);
+            const XMVECTOR inverseLength =
+                XMVectorReciprocalSqrt(detail::Dot4(blendedX, blendedY, blendedZ, blendedW, blendedX, blendedY, blendedZ, blendedW));
+            blendedX = XMVectorMultiply(blendedX, inverseLength);
+            blendedY = XMVectorMultiply(blendedY, inverseLength);
+            blendedZ = XMVectorMultiply(blendedZ, inverseLength);
+            blendedW = XMVectorMultiply(blendedW, inverseLength);
+
+            block.OrientationX = XMVectorSelect(orientationX, blendedX, filterMask);
+            block.OrientationY = XMVectorSelect(orientationY, blendedY, filterMask);
+            block.OrientationZ = XMVectorSelect(orientationZ, blendedZ, filterMask);
+            block.OrientationW = XMVectorSelect(orientationW, blendedW, filterMask);
+            block.OrientationSpeed = XMVectorSelect(g_XMZero, orientationSpeed, filterMask);
+            block.Initialized = validMask;
+
+            // Write the filtered poses of the valid joints back.
+            XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(px), block.PositionX);
+            XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(py), block.PositionY);
+            XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(pz), block.PositionZ);
+            XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(qx), block.OrientationX);
+            XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(qy), block.OrientationY);
+            XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(qz), block.OrientationZ);
+            XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(qw), block.OrientationW);
+            for (size_t lane = 0; lane < laneCount; lane++) {
+                if (valid[lane] != 0) {
+                    XrHandJointLocationEXT& joint = joints[first + lane];
+                    joint.pose.position = {px[lane], py[lane], pz[lane]};
+                    joint.pose.orientation = {qx[lane], qy[lane], qz[lane], qw[lane]};
+                }
+            }
+        }
+    }
+} // namespace xr::math
+
+#pragma endregion
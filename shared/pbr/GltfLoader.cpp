@@ -2,27 +2,311 @@
 // Copyright (C) Microsoft Corporation.  All Rights Reserved
 // Licensed under the MIT License. See License.txt in the project root for license information.
 #include "pch.h"
+#include <iomanip>
+#include <optional>
+#include <set>
+#include <sstream>
 #define TINYGLTF_USE_RAPIDJSON
 #define TINYGLTF_USE_RAPIDJSON_CRTALLOCATOR
 #define TINYGLTF_NO_STB_IMAGE_WRITE
 #include <tiny_gltf.h>
 #include "..\Gltf\GltfHelper.h"
 #include "GltfLoader.h"
+#include "PbrImage.h"
+#include "PbrMipmaps.h"
+#include "PbrBlockCompression.h"
+#include "PbrTaskScheduler.h"
+#include "PbrTextureResidency.h"
 
 using namespace DirectX;
 
 namespace {
-    // Create a DirectX texture view from a tinygltf Image.
-    winrt::com_ptr<ID3D11ShaderResourceView> LoadImage(_In_ ID3D11Device* device, const tinygltf::Image& image, bool sRGB) {
-        // First convert the image to RGBA if it isn't already.
-        std::vector<uint8_t> tempBuffer;
-        const uint8_t* rgbaBuffer = GltfHelper::ReadImageAsRGBA(image, &tempBuffer);
-        if (rgbaBuffer == nullptr) {
-            return nullptr;
+    using Clock = std::chrono::high_resolution_clock;
+
+    std::chrono::microseconds ElapsedSince(Clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+    }
+
+    // Image loader callback for tinygltf which keeps the encoded image content, so the images can be decoded in parallel
+    // after parsing instead of one after the other during parsing.
+    bool StoreEncodedImage(tinygltf::Image* image,
+                           const int /*imageIndex*/,
+                           std::string* /*err*/,
+                           std::string* /*warn*/,
+                           int /*reqWidth*/,
+                           int /*reqHeight*/,
+                           const unsigned char* bytes,
+                           int size,
+                           void* /*userData*/) {
+        image->as_is = true;
+        image->image.assign(bytes, bytes + size);
+        return true;
+    }
+
+    // How the texels of a texture are used, which decides how they are filtered and compressed.
+    enum class TextureUsage {
+        Color,  // sRGB encoded colors, with alpha for the base color
+        Normal, // Tangent space normals. Compressed normal maps keep x and y, z is reconstructed in the shader.
+        Data,   // Linear values, such as metallic-roughness and occlusion
+    };
+
+    // Identifies a texture created from a glTF image. Item1 is a pointer to the image, Item2 is how its texels are used.
+    using TextureKey = std::tuple<const tinygltf::Image*, TextureUsage>;
+
+    // The textures of a material, with how their texels are used.
+    std::array<std::pair<const GltfHelper::Material::Texture*, TextureUsage>, 5> MaterialTextures(const GltfHelper::Material& material) {
+        return {std::make_pair(&material.BaseColorTexture, TextureUsage::Color),
+                std::make_pair(&material.MetallicRoughnessTexture, TextureUsage::Data),
+                std::make_pair(&material.EmissiveTexture, TextureUsage::Color),
+                std::make_pair(&material.NormalTexture, TextureUsage::Normal),
+                std::make_pair(&material.OcclusionTexture, TextureUsage::Data)};
+    }
+
+    // Whether the sampler minifies through mip levels. Textures without a sampler, or with an unspecified minification filter,
+    // use trilinear filtering.
+    bool UsesMipmaps(const tinygltf::Sampler* sampler) {
+        return sampler == nullptr ||
+               (sampler->minFilter != TINYGLTF_TEXTURE_FILTER_NEAREST && sampler->minFilter != TINYGLTF_TEXTURE_FILTER_LINEAR);
+    }
+
+    // Colors keep more detail through the sharper Kaiser filter. Normal and metallic-roughness maps use the box filter,
+    // because the ringing of the Kaiser filter shows as bumps in lighting.
+    Pbr::MipChainOptions MipChainOptionsFor(TextureUsage usage) {
+        Pbr::MipChainOptions options;
+        options.SRGB = usage == TextureUsage::Color;
+        options.Filter = usage == TextureUsage::Color ? Pbr::MipFilter::Kaiser : Pbr::MipFilter::Box;
+        return options;
+    }
+
+    // The pixels of a glTF image. Images still encoded are decoded on first use, on the thread asking for them, and the
+    // decode is shared with other loads of the same content. Images tinygltf already decoded are converted to RGBA.
+    class ImageSource {
+    public:
+        explicit ImageSource(const tinygltf::Image& image)
+            : m_image(image)
+            , m_key(Pbr::HashImage(image.image.data(), image.image.size())) {
+        }
+
+        // Identifies the content of the image, encoded or not.
+        const Pbr::ImageKey& Key() const {
+            return m_key;
+        }
+
+        // A copy of the encoded content, which outlives the glTF model, or null if tinygltf already decoded the image.
+        std::shared_ptr<const std::vector<uint8_t>> EncodedCopy() const {
+            return m_image.as_is ? std::make_shared<const std::vector<uint8_t>>(m_image.image) : nullptr;
+        }
+
+        // The decode of the encoded content, or null if the image wasn't encoded or nobody asked for its pixels yet.
+        const std::shared_ptr<Pbr::ImageDecode>& Decode() const {
+            return m_decode;
+        }
+
+        // Waits for the pixels. Returns null if tinygltf decoded the image into a layout that can't be read. Thread safe.
+        const Pbr::DecodedImage* Pixels() {
+            Start();
+            if (m_decode) {
+                return &m_decode->Get();
+            }
+            return m_converted.Rgba.empty() ? nullptr : &m_converted;
+        }
+
+        // Calls continuation once Pixels returns without waiting: on the thread finishing the decode, or right away if the
+        // image is decoded already or needs no decode. Thread safe.
+        void WhenPixelsReady(std::function<void()> continuation) {
+            Start();
+            if (m_decode) {
+                m_decode->Then(std::move(continuation));
+            } else {
+                continuation();
+            }
+        }
+
+    private:
+        // Starts decoding the encoded content, or converts the pixels tinygltf decoded, once.
+        void Start() {
+            std::call_once(m_started, [this] {
+                if (m_image.as_is) {
+                    m_decode = Pbr::ImageDecode::Start(m_key, m_image.image.data(), m_image.image.size());
+                    return;
+                }
+
+                std::vector<uint8_t> tempBuffer;
+                const uint8_t* rgbaBuffer = GltfHelper::ReadImageAsRGBA(m_image, &tempBuffer);
+                if (rgbaBuffer != nullptr) {
+                    m_converted.Width = m_image.width;
+                    m_converted.Height = m_image.height;
+                    m_converted.Rgba.assign(rgbaBuffer, rgbaBuffer + static_cast<size_t>(m_image.width) * m_image.height * 4);
+                }
+            });
+        }
+
+        const tinygltf::Image& m_image;
+        const Pbr::ImageKey m_key;
+        std::once_flag m_started;
+        std::shared_ptr<Pbr::ImageDecode> m_decode;
+        Pbr::DecodedImage m_converted;
+    };
+
+    // A texture prepared on a worker thread. Exactly one of the members is set, unless the image could not be read.
+    struct TextureData {
+        winrt::com_ptr<ID3D11ShaderResourceView> StoredView; // Loaded from the texture store
+        std::optional<Pbr::CompressedTexture> Compressed;
+        std::optional<Pbr::MipChain> Levels;
+        const Pbr::DecodedImage* Pixels{nullptr}; // A single uncompressed level, owned by the ImageSource
+        Pbr::StreamedLevelReader ReadLevels;      // Reads the levels of Compressed or Levels again, when they are streamed
+    };
+
+    // Transcode settings used while preparing a texture, taken from the Pbr resources at the start of the load.
+    struct TextureSettings {
+        TextureUsage Usage{TextureUsage::Color};
+        bool Mipmapped{false};
+        Pbr::TextureCompression Compression{Pbr::TextureCompression::None};
+        std::shared_ptr<Pbr::TextureStore> Store;
+        bool Streamed{false}; // The levels are streamed by the texture residency of the Pbr resources
+    };
+
+    // Normal maps only need x and y, which BC5 keeps at the best quality. Fast compression only pays for the alpha channel
+    // of colors which have partly transparent texels.
+    Pbr::BlockFormat BlockFormatFor(const TextureSettings& settings, const Pbr::DecodedImage& pixels) {
+        if (settings.Usage == TextureUsage::Normal) {
+            return Pbr::BlockFormat::BC5;
+        }
+        if (settings.Usage == TextureUsage::Data) {
+            return Pbr::BlockFormat::BC1;
+        }
+        if (settings.Compression == Pbr::TextureCompression::HighQuality) {
+            return Pbr::BlockFormat::BC7;
+        }
+
+        for (size_t i = 3; i < pixels.Rgba.size(); i += 4) {
+            if (pixels.Rgba[i] != 255) {
+                return Pbr::BlockFormat::BC3;
+            }
+        }
+        return Pbr::BlockFormat::BC1;
+    }
+
+    // The name of the texture in the texture store and the asset cache. It changes with anything that changes the stored
+    // texels, including the version of the encoders, so that a stored texture is never stale.
+    std::string TextureStoreKey(const Pbr::ImageKey& imageKey, const TextureSettings& settings) {
+        constexpr char EncoderVersion[] = "v1";
+        constexpr const char* UsageNames[] = {"color", "normal", "data"};
+        constexpr const char* CompressionNames[] = {"none", "fast", "hq"};
+
+        std::ostringstream key;
+        key << std::hex << std::setw(16) << std::setfill('0') << imageKey.Hash << std::dec << "-" << imageKey.Size << "-"
+            << UsageNames[static_cast<int>(settings.Usage)] << "-" << CompressionNames[static_cast<int>(settings.Compression)]
+            << (settings.Mipmapped ? "-mips-" : "-") << EncoderVersion;
+        return key.str();
+    }
+
+    // Builds the levels of the texture from the pixels of its image, and compresses them if compress is set.
+    void TranscodeTexture(const Pbr::DecodedImage& pixels, const TextureSettings& settings, bool compress, TextureData& texture) {
+        Pbr::MipChain levels;
+        if (settings.Mipmapped) {
+            levels = Pbr::GenerateMipChain(pixels.Rgba.data(), pixels.Width, pixels.Height, MipChainOptionsFor(settings.Usage));
+        } else {
+            levels.Levels = {Pbr::MipLevel{pixels.Width, pixels.Height, 0}};
+            levels.Data = pixels.Rgba;
+        }
+
+        if (!compress) {
+            texture.Levels = std::move(levels);
+            return;
+        }
+
+        texture.Compressed = Pbr::CompressMipChain(levels, BlockFormatFor(settings, pixels), settings.Usage == TextureUsage::Color);
+    }
+
+    // Streamed textures read their finer levels again when they stream in: from the texture store, or else by decoding and
+    // transcoding the image again, which is deterministic. Images tinygltf already decoded have no source smaller than their
+    // levels, so those are kept.
+    Pbr::StreamedLevelReader LevelReader(const ImageSource& source,
+                                         const TextureSettings& settings,
+                                         const std::string& storeKey,
+                                         bool compress,
+                                         const TextureData& texture) {
+        std::shared_ptr<Pbr::TextureStore> store = storeKey.empty() ? nullptr : settings.Store;
+        std::shared_ptr<const std::vector<uint8_t>> encoded = source.EncodedCopy();
+        std::shared_ptr<const std::vector<uint8_t>> kept;
+        if (!store && !encoded) {
+            kept = std::make_shared<const std::vector<uint8_t>>(texture.Compressed ? texture.Compressed->Data : texture.Levels->Data);
+        }
+
+        return [store = std::move(store), storeKey, encoded = std::move(encoded), kept = std::move(kept), settings, compress] {
+            if (store) {
+                std::vector<uint8_t> ddsFile = store->Read(storeKey);
+                if (!ddsFile.empty() || !encoded) {
+                    return Pbr::LoadDdsData(ddsFile);
+                }
+            }
+            if (encoded) {
+                TextureData transcoded;
+                TranscodeTexture(Pbr::DecodeImage(encoded->data(), encoded->size()), settings, compress, transcoded);
+                return transcoded.Compressed ? std::move(transcoded.Compressed->Data) : std::move(transcoded.Levels->Data);
+            }
+            return *kept;
+        };
+    }
+
+    // Builds the texture from the pixels of its image, which are decoded already: generates its mip chain and compresses it.
+    // Compressed textures are added to the store for the next load.
+    TextureData TranscodeImage(ImageSource& source, const TextureSettings& settings, const std::string& storeKey) {
+        TextureData texture;
+        const Pbr::DecodedImage* pixels = source.Pixels();
+        if (pixels == nullptr) {
+            return texture;
         }
 
-        const DXGI_FORMAT format = sRGB ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
-        return Pbr::Texture::CreateTexture(device, rgbaBuffer, image.width * image.height * 4, image.width, image.height, format);
+        // Textures whose size is not a whole number of blocks stay uncompressed.
+        const bool compress =
+            settings.Compression != Pbr::TextureCompression::None && Pbr::CanBlockCompress(pixels->Width, pixels->Height);
+        if (!compress && !settings.Mipmapped) {
+            texture.Pixels = pixels;
+            return texture;
+        }
+
+        TranscodeTexture(*pixels, settings, compress, texture);
+        if (texture.Compressed && !storeKey.empty()) {
+            settings.Store->Store(storeKey, Pbr::SaveDds(*texture.Compressed));
+        }
+        if (settings.Streamed && settings.Mipmapped) {
+            texture.ReadLevels = LevelReader(source, settings, storeKey, compress, texture);
+        }
+        return texture;
+    }
+
+    // Prepares the texture on the task scheduler: reads it from the texture store, or else transcodes its image in a
+    // continuation of the decode, so that no worker waits for another task. The future is ready once the texture is.
+    std::shared_future<TextureData> PrepareTexture(_In_ ID3D11Device* device, ImageSource& source, const TextureSettings& settings) {
+        auto prepared = std::make_shared<std::promise<TextureData>>();
+        std::shared_future<TextureData> result = prepared->get_future().share();
+        Pbr::Internal::Run([device, &source, settings, prepared] {
+            try {
+                const bool compress = settings.Compression != Pbr::TextureCompression::None;
+                std::string storeKey = compress && settings.Store ? TextureStoreKey(source.Key(), settings) : std::string();
+                if (!storeKey.empty()) {
+                    TextureData texture;
+                    texture.StoredView = settings.Store->Load(device, storeKey);
+                    if (texture.StoredView) {
+                        prepared->set_value(std::move(texture));
+                        return;
+                    }
+                }
+
+                source.WhenPixelsReady([&source, settings, storeKey = std::move(storeKey), prepared] {
+                    try {
+                        prepared->set_value(TranscodeImage(source, settings, storeKey));
+                    } catch (...) {
+                        prepared->set_exception(std::current_exception());
+                    }
+                });
+            } catch (...) {
+                prepared->set_exception(std::current_exception());
+            }
+        });
+        return result;
     }
 
     D3D11_FILTER ConvertFilter(int glMinFilter, int glMagFilter) {
@@ -61,10 +345,16 @@ namespace {
         return filter;
     }
 
-    // Create a DirectX sampler state from a tinygltf Sampler.
-    winrt::com_ptr<ID3D11SamplerState> CreateSampler(_In_ ID3D11Device* device,
-                                                     const tinygltf::Model& gltfModel,
-                                                     const tinygltf::Sampler& sampler) {
+    // Describe a DirectX sampler state for a tinygltf Sampler. Textures without a sampler are read with the default sampler,
+    // repeated.
+    D3D11_SAMPLER_DESC ConvertSampler(const tinygltf::Sampler* gltfSampler) {
+        if (gltfSampler == nullptr) {
+            CD3D11_SAMPLER_DESC samplerDesc(CD3D11_DEFAULT{});
+            samplerDesc.AddressU = samplerDesc.AddressV = samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+            return samplerDesc;
+        }
+
+        const tinygltf::Sampler& sampler = *gltfSampler;
         D3D11_SAMPLER_DESC samplerDesc{};
 
         samplerDesc.Filter = ConvertFilter(sampler.minFilter, sampler.magFilter);
@@ -80,11 +370,23 @@ namespace {
         samplerDesc.MaxAnisotropy = 1;
         samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
         samplerDesc.MinLOD = 0;
-        samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+        // Without a mipmapping minification filter, only the most detailed level is sampled, even if the texture has more.
+        samplerDesc.MaxLOD = UsesMipmaps(&sampler) ? D3D11_FLOAT32_MAX : 0;
+        return samplerDesc;
+    }
+
+    // Collects the materials used by the meshes of a node and its children.
+    void CollectNodeMaterials(const tinygltf::Model& gltfModel, int nodeId, std::set<int>& materialIndices) {
+        const tinygltf::Node& gltfNode = gltfModel.nodes.at(nodeId);
+        if (gltfNode.mesh != -1) {
+            for (const tinygltf::Primitive& gltfPrimitive : gltfModel.meshes.at(gltfNode.mesh).primitives) {
+                materialIndices.insert(gltfPrimitive.material);
+            }
+        }
 
-        winrt::com_ptr<ID3D11SamplerState> samplerState;
-        Pbr::Internal::ThrowIfFailed(device->CreateSamplerState(&samplerDesc, samplerState.put()));
-        return samplerState;
+        for (const int childNodeId : gltfNode.children) {
+            CollectNodeMaterials(gltfModel, childNodeId, materialIndices);
+        }
     }
 
     // Maps a glTF material to a PrimitiveBuilder. This optimization combines all primitives which use
@@ -152,87 +454,218 @@ namespace {
             LoadNode(transformIndex, gltfModel, childNodeId, primitiveBuilderMap, model);
         }
     }
-} // namespace
 
-namespace Gltf {
-    std::shared_ptr<Pbr::Model> FromGltfObject(const Pbr::Resources& pbrResources, const tinygltf::Model& gltfModel) {
-        // Start off with an empty Pbr Model.
-        auto model = std::make_shared<Pbr::Model>();
-
-        // Read and transform mesh/node data. Primitives with the same material are merged to reduce draw calls.
-        PrimitiveBuilderMap primitiveBuilderMap;
-        {
+    // A material slot showing a texture of the model, and the sampler reading it.
+    struct TextureBinding {
+        int MaterialIndex;
+        Pbr::ShaderSlots::PSMaterial Slot;
+        winrt::com_ptr<ID3D11SamplerState> Sampler;
+    };
+
+    // The stages of loading a glTF model and the state they share. FromGltfObject runs the stages one after the other. A
+    // queued load runs the CPU stages on the loading thread, then creates the primitives and textures from uploads which keep
+    // the load alive until they ran.
+    class ModelLoad {
+    public:
+        // The glTF model must outlive the load, unless the load owns it.
+        ModelLoad(const Pbr::Resources& pbrResources,
+                  const tinygltf::Model& gltfModel,
+                  std::shared_ptr<const tinygltf::Model> ownedGltfModel = nullptr)
+            : m_pbrResources(pbrResources)
+            , m_ownedGltfModel(std::move(ownedGltfModel))
+            , m_gltfModel(gltfModel)
+            , m_model(std::make_shared<Pbr::Model>()) {
             const int defaultSceneId = (gltfModel.defaultScene == -1) ? 0 : gltfModel.defaultScene;
-            const tinygltf::Scene& defaultScene = gltfModel.scenes.at(defaultSceneId);
+            m_defaultScene = &gltfModel.scenes.at(defaultSceneId);
+        }
+
+        // The texture jobs read the image sources and the glTF images, so they finish before those go away.
+        ~ModelLoad() {
+            for (const auto& textureJob : m_textureJobs) {
+                textureJob.second.wait();
+            }
+        }
+
+        ModelLoad(const ModelLoad&) = delete;
+        ModelLoad& operator=(const ModelLoad&) = delete;
+
+        const std::shared_ptr<Pbr::Model>& Model() const {
+            return m_model;
+        }
+
+        Gltf::LoadStatistics& Statistics() {
+            return m_statistics;
+        }
+
+        // Reads the materials used by the default scene and looks them up in the asset cache. Starts preparing the textures
+        // of the materials not found, unless the textures are cached, on worker threads: reading them from the texture store,
+        // or decoding their images, generating mip chains and compressing them. This work runs while the geometry is read.
+        void StartTextures() {
+            std::set<int> materialIndices;
+            for (const int rootNodeId : m_defaultScene->nodes) {
+                CollectNodeMaterials(m_gltfModel, rootNodeId, materialIndices);
+            }
+
+            std::map<TextureKey, bool> mipmappedTextures;
+            std::set<Pbr::ImageKey> imageKeys;
+            for (const int materialIndex : materialIndices) {
+                if (materialIndex == -1) {
+                    continue;
+                }
+
+                const GltfHelper::Material& material =
+                    m_materials.emplace(materialIndex, GltfHelper::ReadMaterial(m_gltfModel, m_gltfModel.materials.at(materialIndex)))
+                        .first->second;
+                for (const auto& [texture, usage] : MaterialTextures(material)) {
+                    const tinygltf::Image* image = texture->Image;
+                    if (image == nullptr) {
+                        continue;
+                    }
+
+                    // A texture gets mip levels if any sampler using it needs them.
+                    mipmappedTextures[std::make_tuple(image, usage)] |= UsesMipmaps(texture->Sampler);
+                    std::unique_ptr<ImageSource>& source = m_imageSources[image];
+                    if (!source) {
+                        source = std::make_unique<ImageSource>(*image);
+                        imageKeys.insert(source->Key());
+                    }
+                }
+            }
+
+            m_statistics.ImageCount = static_cast<uint32_t>(m_imageSources.size());
+            m_statistics.UniqueImageCount = static_cast<uint32_t>(imageKeys.size());
+
+            std::map<TextureKey, TextureSettings> textureSettings;
+            for (const auto& [textureKey, mipmapped] : mipmappedTextures) {
+                TextureSettings& settings = textureSettings[textureKey];
+                settings.Usage = std::get<1>(textureKey);
+                settings.Mipmapped = mipmapped;
+                settings.Compression = m_pbrResources.GetTextureCompression();
+                settings.Store = m_pbrResources.GetTextureStore();
+                settings.Streamed = m_pbrResources.GetTextureResidency() != nullptr;
+                m_textureCacheKeys.emplace(textureKey, TextureStoreKey(m_imageSources.at(std::get<0>(textureKey))->Key(), settings));
+            }
+
+            // Cached materials are complete, so their textures are only needed by the materials not found.
+            Pbr::AssetCache& assetCache = m_pbrResources.GetAssetCache();
+            std::set<TextureKey> neededTextures;
+            for (const auto& [materialIndex, material] : m_materials) {
+                std::string materialCacheKey = MaterialCacheKey(materialIndex, material);
+                if (std::shared_ptr<Pbr::Material> cachedMaterial = assetCache.FindMaterial(materialCacheKey)) {
+                    m_pbrMaterials.emplace(materialIndex, std::move(cachedMaterial));
+                    m_statistics.CachedMaterialCount++;
+                    continue;
+                }
+
+                m_materialCacheKeys.emplace(materialIndex, std::move(materialCacheKey));
+                for (const auto& [texture, usage] : MaterialTextures(material)) {
+                    if (texture->Image != nullptr) {
+                        neededTextures.insert(std::make_tuple(texture->Image, usage));
+                    }
+                }
+            }
+
+            // Non-power-of-two textures are kept at their size. Feature level 10 and above samples them with wrapping and
+            // mipmapping, which is what glTF would need the resize for.
+            ID3D11Device* const device = m_pbrResources.GetDevice().get();
+            const std::shared_ptr<Pbr::TextureResidency> residency = m_pbrResources.GetTextureResidency();
+            for (const TextureKey& textureKey : neededTextures) {
+                if (residency) {
+                    if (std::shared_ptr<Pbr::StreamedTexture> streamedTexture = residency->FindTexture(m_textureCacheKeys.at(textureKey))) {
+                        m_streamedTextures.emplace(textureKey, std::move(streamedTexture));
+                        m_statistics.CachedTextureCount++;
+                        continue;
+                    }
+                }
+                if (std::shared_ptr<const Pbr::CachedTexture> cachedTexture = assetCache.FindTexture(m_textureCacheKeys.at(textureKey))) {
+                    m_cachedTextures.emplace(textureKey, std::move(cachedTexture));
+                    m_statistics.CachedTextureCount++;
+                    continue;
+                }
+
+                ImageSource& source = *m_imageSources.at(std::get<0>(textureKey));
+                m_textureJobs.emplace(textureKey, PrepareTexture(device, source, textureSettings.at(textureKey)));
+            }
+        }
+
+        // Reads and transforms the mesh and node data into the model nodes and primitive builders. Primitives with the same
+        // material are merged to reduce draw calls.
+        void ReadGeometry() {
+            const Clock::time_point geometryStart = Clock::now();
 
             // Process the root scene nodes. The children will be processed recursively.
-            for (const int rootNodeId : defaultScene.nodes) {
-                LoadNode(Pbr::RootNodeIndex, gltfModel, rootNodeId, primitiveBuilderMap, *model);
+            for (const int rootNodeId : m_defaultScene->nodes) {
+                LoadNode(Pbr::RootNodeIndex, m_gltfModel, rootNodeId, m_primitiveBuilders, *m_model);
             }
+
+            // Streamed textures choose their levels by the extents of the primitives showing them.
+            if (m_pbrResources.GetTextureResidency()) {
+                for (const auto& [materialIndex, primitiveBuilder] : m_primitiveBuilders) {
+                    m_primitiveExtents.emplace(materialIndex, Pbr::ComputePrimitiveExtent(primitiveBuilder, *m_model));
+                }
+            }
+
+            m_statistics.Geometry = ElapsedSince(geometryStart);
         }
 
-        // Load the materials referenced by the primitives
-        std::map<int, std::shared_ptr<Pbr::Material>> materialMap;
-        {
-            // Create D3D cache for reuse of texture views and samplers when possible.
-            using ImageKey = std::tuple<const tinygltf::Image*, bool>; // Item1 is a pointer to the image, Item2 is sRGB.
-            std::map<ImageKey, winrt::com_ptr<ID3D11ShaderResourceView>> imageMap;
-            std::map<const tinygltf::Sampler*, winrt::com_ptr<ID3D11SamplerState>> samplerMap;
-
-            // primitiveBuilderMap is grouped by material. Loop through the referenced materials and load their resources. This will only
-            // load materials which are used by the active scene.
-            for (const auto& primitiveBuilderPair : primitiveBuilderMap) {
-                std::shared_ptr<Pbr::Material> pbrMaterial;
+        // Creates the materials referenced by the primitives which were not found in the asset cache. Textured slots show the
+        // default color of the slot until CreateTexture binds the texture. Materials are added to the asset cache once they
+        // have all their textures.
+        void CreateMaterials() {
+            Pbr::AssetCache& assetCache = m_pbrResources.GetAssetCache();
 
+            // The primitive builders are grouped by material. Only the materials used by the active scene are created.
+            for (const auto& primitiveBuilderPair : m_primitiveBuilders) {
                 const int materialIndex = primitiveBuilderPair.first;
+                if (m_pbrMaterials.count(materialIndex) > 0) {
+                    continue;
+                }
+
+                std::shared_ptr<Pbr::Material> pbrMaterial;
                 if (materialIndex == -1) // No material was referenced. Make up a material for it.
                 {
                     // Default material is a grey material, 50% roughness, non-metallic.
-                    pbrMaterial = Pbr::Material::CreateFlat(pbrResources, {0.5f, 0.5f, 0.5f, 0.5f}, 0.5f);
+                    pbrMaterial = Pbr::Material::CreateFlat(m_pbrResources, {0.5f, 0.5f, 0.5f, 0.5f}, 0.5f);
                 } else {
-                    const tinygltf::Material& gltfMaterial = gltfModel.materials.at(materialIndex);
+                    const tinygltf::Material& gltfMaterial = m_gltfModel.materials.at(materialIndex);
 
-                    const GltfHelper::Material material = GltfHelper::ReadMaterial(gltfModel, gltfMaterial);
-                    pbrMaterial = std::make_shared<Pbr::Material>(pbrResources);
+                    const GltfHelper::Material& material = m_materials.at(materialIndex);
+                    pbrMaterial = std::make_shared<Pbr::Material>(m_pbrResources);
 
-                    // Read a tinygltf texture and sampler into the Pbr Material.
+                    // Bind the cached texture, or the default color of the slot and record where the texture goes once created.
                     auto loadTexture = [&](Pbr::ShaderSlots::PSMaterial slot,
                                            const GltfHelper::Material::Texture& texture,
-                                           bool sRGB,
+                                           TextureUsage usage,
                                            Pbr::RGBAColor defaultRGBA) {
-                        // Find or load the image referenced by the texture.
-                        const ImageKey imageKey = std::make_tuple(texture.Image, sRGB);
-                        winrt::com_ptr<ID3D11ShaderResourceView> textureView = imageMap[imageKey];
-                        if (!textureView) // If not cached, load the image and store it in the texture cache.
-                        {
-                            // TODO: Generate mipmaps if sampler's minification filter (minFilter) uses mipmapping.
-                            // TODO: If texture is not power-of-two and (sampler has wrapping=repeat/mirrored_repeat OR minFilter uses
-                            // mipmapping), resize to power-of-two.
-                            textureView = texture.Image != nullptr ? LoadImage(pbrResources.GetDevice().get(), *texture.Image, sRGB)
-                                                                   : pbrResources.CreateSolidColorTexture(defaultRGBA);
-                            imageMap[imageKey] = textureView;
+                        const winrt::com_ptr<ID3D11SamplerState> samplerState =
+                            assetCache.FindOrCreateSampler(m_pbrResources.GetDevice().get(), ConvertSampler(texture.Sampler));
+
+                        const TextureKey textureKey = std::make_tuple(texture.Image, usage);
+                        const auto cachedTexture = m_cachedTextures.find(textureKey);
+                        if (cachedTexture != m_cachedTextures.end()) {
+                            pbrMaterial->SetTexture(slot, cachedTexture->second, samplerState.get());
+                            return;
                         }
-
-                        // Find or create the sampler referenced by the texture.
-                        winrt::com_ptr<ID3D11SamplerState> samplerState = samplerMap[texture.Sampler];
-                        if (!samplerState) // If not cached, create the sampler and store it in the sampler cache.
-                        {
-                            samplerState = texture.Sampler != nullptr
-                                               ? CreateSampler(pbrResources.GetDevice().get(), gltfModel, *texture.Sampler)
-                                               : Pbr::Texture::CreateSampler(pbrResources.GetDevice().get(), D3D11_TEXTURE_ADDRESS_WRAP);
-                            samplerMap[texture.Sampler] = samplerState;
+                        const auto streamedTexture = m_streamedTextures.find(textureKey);
+                        if (streamedTexture != m_streamedTextures.end()) {
+                            pbrMaterial->SetTexture(slot, streamedTexture->second, samplerState.get());
+                            return;
                         }
 
-                        pbrMaterial->SetTexture(slot, textureView.get(), samplerState.get());
+                        pbrMaterial->SetTexture(slot, m_pbrResources.CreateSolidColorTexture(defaultRGBA).get(), samplerState.get());
+                        if (m_textureJobs.count(textureKey) > 0) {
+                            m_textureBindings[textureKey].push_back(TextureBinding{materialIndex, slot, samplerState});
+                            m_pendingTextureCounts[materialIndex]++;
+                        }
                     };
 
                     pbrMaterial->Name = gltfMaterial.name;
 
-                    loadTexture(Pbr::ShaderSlots::BaseColor, material.BaseColorTexture, true /* sRGB */, Pbr::RGBA::White);
-                    loadTexture(Pbr::ShaderSlots::MetallicRoughness, material.MetallicRoughnessTexture, false /* sRGB */, Pbr::RGBA::White);
-                    loadTexture(Pbr::ShaderSlots::Emissive, material.EmissiveTexture, true /* sRGB */, Pbr::RGBA::White);
-                    loadTexture(Pbr::ShaderSlots::Normal, material.NormalTexture, false /* sRGB */, Pbr::RGBA::FlatNormal);
-                    loadTexture(Pbr::ShaderSlots::Occlusion, material.OcclusionTexture, false /* sRGB */, Pbr::RGBA::White);
+                    loadTexture(Pbr::ShaderSlots::BaseColor, material.BaseColorTexture, TextureUsage::Color, Pbr::RGBA::White);
+                    loadTexture(Pbr::ShaderSlots::MetallicRoughness, material.MetallicRoughnessTexture, TextureUsage::Data, Pbr::RGBA::White);
+                    loadTexture(Pbr::ShaderSlots::Emissive, material.EmissiveTexture, TextureUsage::Color, Pbr::RGBA::White);
+                    loadTexture(Pbr::ShaderSlots::Normal, material.NormalTexture, TextureUsage::Normal, Pbr::RGBA::FlatNormal);
+                    loadTexture(Pbr::ShaderSlots::Occlusion, material.OcclusionTexture, TextureUsage::Data, Pbr::RGBA::White);
 
                     pbrMaterial->SetDoubleSided(material.DoubleSided);
                     pbrMaterial->SetAlphaBlended(material.AlphaMode == GltfHelper::AlphaMode::Blend);
@@ -248,33 +681,305 @@ namespace Gltf {
                         material.AlphaMode == GltfHelper::AlphaMode::Mask ? material.AlphaCutoff : std::numeric_limits<float>::lowest();
                 }
 
-                materialMap.insert(std::make_pair(materialIndex, std::move(pbrMaterial)));
+                m_pbrMaterials.insert(std::make_pair(materialIndex, std::move(pbrMaterial)));
+                if (m_pendingTextureCounts[materialIndex] == 0) {
+                    CacheMaterial(materialIndex);
+                }
             }
         }
 
-        // Convert the primitive builders into primitives with their respective material and add it into the Pbr Model.
-        for (const auto& primitiveBuilderPair : primitiveBuilderMap) {
-            const Pbr::PrimitiveBuilder& primitiveBuilder = primitiveBuilderPair.second;
-            const std::shared_ptr<Pbr::Material>& material = materialMap.find(primitiveBuilderPair.first)->second;
-            model->AddPrimitive(Pbr::Primitive(pbrResources, primitiveBuilder, material));
+        // The textures being prepared, identified by their keys.
+        std::vector<TextureKey> TextureKeys() const {
+            std::vector<TextureKey> textureKeys;
+            for (const auto& textureJob : m_textureJobs) {
+                textureKeys.push_back(textureJob.first);
+            }
+            return textureKeys;
         }
 
-        return model;
-    }
+        bool IsTextureReady(const TextureKey& textureKey) const {
+            return m_textureJobs.at(textureKey).wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
 
-    std::shared_ptr<Pbr::Model> FromGltfBinary(const Pbr::Resources& pbrResources,
-                                               _In_reads_bytes_(bufferBytes) const uint8_t* buffer,
-                                               uint32_t bufferBytes) {
-        // Parse the GLB buffer data into a tinygltf model object.
-        tinygltf::Model gltfModel;
+        // The bytes CreateTexture sends to the GPU. The texture must be ready. Stored textures are already on the GPU.
+        size_t TextureSize(const TextureKey& textureKey) const {
+            const TextureData& textureData = m_textureJobs.at(textureKey).get();
+            if (textureData.Compressed) {
+                return textureData.Compressed->Data.size();
+            }
+            if (textureData.Levels) {
+                return textureData.Levels->Data.size();
+            }
+            return textureData.Pixels != nullptr ? textureData.Pixels->Rgba.size() : 0;
+        }
+
+        // Creates the texture from its prepared data, waiting for it, and binds it to the material slots showing it. The
+        // prepared data is released.
+        void CreateTexture(const TextureKey& textureKey) {
+            const auto job = m_textureJobs.find(textureKey);
+            const Clock::time_point waitStart = Clock::now();
+            const TextureData& textureData = job->second.get();
+            m_statistics.ImageWait += ElapsedSince(waitStart);
+
+            ID3D11Device* const device = m_pbrResources.GetDevice().get();
+            const DXGI_FORMAT format =
+                std::get<1>(textureKey) == TextureUsage::Color ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+            const std::shared_ptr<Pbr::TextureResidency> residency = m_pbrResources.GetTextureResidency();
+            const std::string& textureCacheKey = m_textureCacheKeys.at(textureKey);
+            winrt::com_ptr<ID3D11ShaderResourceView> textureView;
+            std::shared_ptr<Pbr::StreamedTexture> streamedTexture;
+            if (textureData.StoredView) {
+                textureView = textureData.StoredView;
+                m_statistics.StoredTextureCount++;
+            } else if (textureData.Compressed) {
+                if (residency && textureData.ReadLevels && textureData.Compressed->Levels.size() > 1) {
+                    streamedTexture = residency->CreateTexture(device, *textureData.Compressed, textureCacheKey, textureData.ReadLevels);
+                } else {
+                    textureView = Pbr::Texture::CreateTexture(device, *textureData.Compressed);
+                }
+                m_statistics.CompressedTextureCount++;
+            } else if (textureData.Levels) {
+                if (residency && textureData.ReadLevels && textureData.Levels->Levels.size() > 1) {
+                    streamedTexture =
+                        residency->CreateTexture(device, *textureData.Levels, format, textureCacheKey, textureData.ReadLevels);
+                } else {
+                    textureView = Pbr::Texture::CreateTexture(device, *textureData.Levels, format);
+                }
+            } else if (textureData.Pixels != nullptr) {
+                const Pbr::DecodedImage& pixels = *textureData.Pixels;
+                const uint32_t size = static_cast<uint32_t>(pixels.Rgba.size());
+                textureView = Pbr::Texture::CreateTexture(device, pixels.Rgba.data(), size, pixels.Width, pixels.Height, format);
+            }
+
+            // Images which could not be read keep showing the default color. A texture cached by another load in the meantime
+            // is used instead of this one. Streamed textures are found through the residency rather than the asset cache.
+            std::shared_ptr<const Pbr::CachedTexture> cachedTexture;
+            if (textureView) {
+                cachedTexture = m_pbrResources.GetAssetCache().AddTexture(textureCacheKey, std::move(textureView));
+            }
+            if (streamedTexture) {
+                m_statistics.StreamedTextureCount++;
+            }
+
+            for (const TextureBinding& binding : m_textureBindings[textureKey]) {
+                if (streamedTexture) {
+                    m_pbrMaterials.at(binding.MaterialIndex)->SetTexture(binding.Slot, streamedTexture, binding.Sampler.get());
+                } else if (cachedTexture) {
+                    m_pbrMaterials.at(binding.MaterialIndex)->SetTexture(binding.Slot, cachedTexture, binding.Sampler.get());
+                }
+                if (--m_pendingTextureCounts.at(binding.MaterialIndex) == 0) {
+                    CacheMaterial(binding.MaterialIndex);
+                }
+            }
+
+            m_textureBindings.erase(textureKey);
+            m_textureJobs.erase(job);
+        }
+
+        // The materials of the primitive builders, which identify them.
+        std::vector<int> PrimitiveMaterials() const {
+            std::vector<int> materialIndices;
+            for (const auto& primitiveBuilderPair : m_primitiveBuilders) {
+                materialIndices.push_back(primitiveBuilderPair.first);
+            }
+            return materialIndices;
+        }
+
+        // The bytes CreatePrimitive sends to the GPU.
+        size_t PrimitiveSize(int materialIndex) const {
+            const Pbr::PrimitiveBuilder& primitiveBuilder = m_primitiveBuilders.at(materialIndex);
+            return primitiveBuilder.Vertices.size() * sizeof(Pbr::Vertex) + primitiveBuilder.Indices.size() * sizeof(uint32_t);
+        }
+
+        // Converts the primitive builder into a primitive with its material, adds it into the model and releases the builder.
+        void CreatePrimitive(int materialIndex) {
+            const auto primitiveBuilder = m_primitiveBuilders.find(materialIndex);
+            const std::shared_ptr<Pbr::Material>& material = m_pbrMaterials.at(materialIndex);
+            Pbr::Primitive primitive(m_pbrResources, primitiveBuilder->second, material);
+            const auto extent = m_primitiveExtents.find(materialIndex);
+            if (extent != m_primitiveExtents.end()) {
+                primitive.SetExtent(extent->second);
+            }
+            m_model->AddPrimitive(std::move(primitive));
+            m_primitiveBuilders.erase(primitiveBuilder);
+        }
+
+        // Adds up the durations of the image decodes. Decodes shared with another load count for each of them, and identical
+        // content within this load counts once. Images whose textures were all read from the texture store were not decoded.
+        void CollectImageStatistics() {
+            std::set<Pbr::ImageKey> countedKeys;
+            for (const auto& [image, source] : m_imageSources) {
+                const std::shared_ptr<Pbr::ImageDecode>& decode = source->Decode();
+                if (decode && countedKeys.insert(decode->Key()).second) {
+                    const std::chrono::microseconds decodeDuration = decode->Get().DecodeDuration;
+                    m_statistics.ImageDecodeSum += decodeDuration;
+                    m_statistics.ImageDecodeLongest = std::max(m_statistics.ImageDecodeLongest, decodeDuration);
+                }
+            }
+        }
+
+    private:
+        // Identifies the material by its parameters, and its textures and samplers by their keys. Materials of different
+        // models with equal keys are rendered identically.
+        std::string MaterialCacheKey(int materialIndex, const GltfHelper::Material& material) const {
+            std::ostringstream key;
+            key << m_gltfModel.materials.at(materialIndex).name << "|" << std::hexfloat << material.BaseColorFactor.x << ","
+                << material.BaseColorFactor.y << "," << material.BaseColorFactor.z << "," << material.BaseColorFactor.w << ","
+                << material.MetallicFactor << "," << material.RoughnessFactor << "," << material.EmissiveFactor.x << ","
+                << material.EmissiveFactor.y << "," << material.EmissiveFactor.z << "," << material.NormalScale << ","
+                << material.OcclusionStrength << "," << static_cast<int>(material.AlphaMode) << "," << material.AlphaCutoff << ","
+                << material.DoubleSided;
+
+            for (const auto& [texture, usage] : MaterialTextures(material)) {
+                key << "|";
+                if (texture->Image != nullptr) {
+                    key << m_textureCacheKeys.at(std::make_tuple(texture->Image, usage));
+                }
+                if (texture->Sampler != nullptr) {
+                    key << ":" << texture->Sampler->minFilter << "," << texture->Sampler->magFilter << "," << texture->Sampler->wrapS
+                        << "," << texture->Sampler->wrapT;
+                }
+            }
+            return key.str();
+        }
+
+        // Adds the material, which has all its textures, to the asset cache. Another load may have added an identical one
+        // meanwhile, which is left cached while this load keeps its own.
+        void CacheMaterial(int materialIndex) {
+            const auto materialCacheKey = m_materialCacheKeys.find(materialIndex);
+            if (materialCacheKey != m_materialCacheKeys.end()) {
+                m_pbrResources.GetAssetCache().AddMaterial(materialCacheKey->second, m_pbrMaterials.at(materialIndex));
+            }
+        }
+
+        const Pbr::Resources& m_pbrResources;
+
+        // Declared in this order so the image sources are destroyed before the glTF images they reference.
+        const std::shared_ptr<const tinygltf::Model> m_ownedGltfModel;
+        const tinygltf::Model& m_gltfModel;
+        const tinygltf::Scene* m_defaultScene{nullptr};
+        std::map<const tinygltf::Image*, std::unique_ptr<ImageSource>> m_imageSources;
+        std::map<TextureKey, std::shared_future<TextureData>> m_textureJobs;
+
+        const std::shared_ptr<Pbr::Model> m_model;
+        Gltf::LoadStatistics m_statistics;
+        std::map<int, GltfHelper::Material> m_materials;
+        PrimitiveBuilderMap m_primitiveBuilders;
+        std::map<int, Pbr::Primitive::Extent> m_primitiveExtents;
+        std::map<int, std::shared_ptr<Pbr::Material>> m_pbrMaterials;
+        std::map<TextureKey, std::vector<TextureBinding>> m_textureBindings;
+
+        // Asset cache keys and hits. Materials without a key are made up for primitives without a material, or were found in
+        // the cache.
+        std::map<TextureKey, std::string> m_textureCacheKeys;
+        std::map<TextureKey, std::shared_ptr<const Pbr::CachedTexture>> m_cachedTextures;
+        std::map<TextureKey, std::shared_ptr<Pbr::StreamedTexture>> m_streamedTextures;
+        std::map<int, std::string> m_materialCacheKeys;
+        std::map<int, uint32_t> m_pendingTextureCounts;
+    };
+
+    // Parses GLB file content into a tinygltf model. The images are kept encoded, to be decoded in parallel by the load.
+    void ParseGltfBinary(_In_reads_bytes_(bufferBytes) const uint8_t* buffer, uint32_t bufferBytes, tinygltf::Model& gltfModel) {
         std::string errorMessage;
         tinygltf::TinyGLTF loader;
+        loader.SetImageLoader(&StoreEncodedImage, nullptr);
         if (!loader.LoadBinaryFromMemory(&gltfModel, &errorMessage, nullptr /*warn*/, buffer, bufferBytes, ".")) {
             const auto msg =
                 std::string("\r\nFailed to load gltf model (") + std::to_string(bufferBytes) + " bytes). Error: " + errorMessage;
             throw std::exception(msg.c_str());
         }
+    }
+} // namespace
+
+namespace Gltf {
+    std::shared_ptr<Pbr::Model>
+    FromGltfObject(const Pbr::Resources& pbrResources, const tinygltf::Model& gltfModel, _Out_opt_ LoadStatistics* statistics) {
+        const Clock::time_point loadStart = Clock::now();
+
+        ModelLoad load(pbrResources, gltfModel);
+        load.StartTextures();
+        load.ReadGeometry();
+
+        // Materials include waiting for their textures.
+        {
+            const Clock::time_point materialsStart = Clock::now();
+
+            load.CreateMaterials();
+            for (const TextureKey& textureKey : load.TextureKeys()) {
+                load.CreateTexture(textureKey);
+            }
+
+            load.Statistics().Materials = ElapsedSince(materialsStart);
+        }
+
+        {
+            const Clock::time_point primitivesStart = Clock::now();
+
+            for (const int materialIndex : load.PrimitiveMaterials()) {
+                load.CreatePrimitive(materialIndex);
+            }
+
+            load.Statistics().Primitives = ElapsedSince(primitivesStart);
+        }
+
+        if (statistics != nullptr) {
+            load.CollectImageStatistics();
+            load.Statistics().Total = ElapsedSince(loadStart);
+            *statistics = load.Statistics();
+        }
+
+        return load.Model();
+    }
+
+    std::shared_ptr<Pbr::Model> FromGltfBinary(const Pbr::Resources& pbrResources,
+                                               _In_reads_bytes_(bufferBytes) const uint8_t* buffer,
+                                               uint32_t bufferBytes,
+                                               _Out_opt_ LoadStatistics* statistics) {
+        const Clock::time_point parseStart = Clock::now();
+
+        tinygltf::Model gltfModel;
+        ParseGltfBinary(buffer, bufferBytes, gltfModel);
+
+        const std::chrono::microseconds parseDuration = ElapsedSince(parseStart);
+        std::shared_ptr<Pbr::Model> model = FromGltfObject(pbrResources, gltfModel, statistics);
+        if (statistics != nullptr) {
+            statistics->Parse = parseDuration;
+            statistics->Total += parseDuration;
+        }
+
+        return model;
+    }
+
+    std::shared_ptr<Pbr::Model> FromGltfBinary(const Pbr::Resources& pbrResources,
+                                               _In_reads_bytes_(bufferBytes) const uint8_t* buffer,
+                                               uint32_t bufferBytes,
+                                               Pbr::UploadQueue& uploadQueue,
+                                               const std::shared_ptr<Pbr::UploadBatch>& uploadBatch) {
+        auto gltfModel = std::make_shared<tinygltf::Model>();
+        ParseGltfBinary(buffer, bufferBytes, *gltfModel);
+
+        auto load = std::make_shared<ModelLoad>(pbrResources, *gltfModel, gltfModel);
+        load->StartTextures();
+        load->ReadGeometry();
+        load->CreateMaterials();
+
+        for (const int materialIndex : load->PrimitiveMaterials()) {
+            Pbr::Upload upload;
+            upload.Stage = Pbr::UploadStage::Geometry;
+            upload.Size = [load, materialIndex] { return load->PrimitiveSize(materialIndex); };
+            upload.Run = [load, materialIndex] { load->CreatePrimitive(materialIndex); };
+            uploadQueue.Enqueue(uploadBatch, std::move(upload));
+        }
+
+        for (const TextureKey& textureKey : load->TextureKeys()) {
+            Pbr::Upload upload;
+            upload.Stage = Pbr::UploadStage::Textures;
+            upload.IsReady = [load, textureKey] { return load->IsTextureReady(textureKey); };
+            upload.Size = [load, textureKey] { return load->TextureSize(textureKey); };
+            upload.Run = [load, textureKey] { load->CreateTexture(textureKey); };
+            uploadQueue.Enqueue(uploadBatch, std::move(upload));
+        }
 
-        return FromGltfObject(pbrResources, gltfModel);
+        return load->Model();
     }
 } // namespace Gltf
@@ -7,28 +7,71 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include "PbrResources.h"
 #include "PbrModel.h"
+#include "PbrUploadQueue.h"
 
 namespace tinygltf { class Model; }
 
 namespace Gltf
 {
+    // Durations of the stages of a model load. Images are decoded on worker threads while the geometry is read, so the
+    // stages overlap and don't add up to the total.
+    struct LoadStatistics
+    {
+        std::chrono::microseconds Parse{0};      // Parsing the GLB container and glTF JSON (FromGltfBinary only)
+        std::chrono::microseconds Geometry{0};   // Reading the nodes and primitives into primitive builders
+        std::chrono::microseconds ImageWait{0};  // Waiting for texture decoding, mip generation and compression after the geometry
+        std::chrono::microseconds Materials{0};  // Creating materials, textures and samplers, including ImageWait
+        std::chrono::microseconds Primitives{0}; // Creating vertex and index buffers
+        std::chrono::microseconds Total{0};
+
+        std::chrono::microseconds ImageDecodeSum{0};     // Sum of the decode durations of all images decoded for this load
+        std::chrono::microseconds ImageDecodeLongest{0}; // Decode duration of the slowest image
+
+        uint32_t ImageCount{0};       // Images referenced by the materials of the default scene
+        uint32_t UniqueImageCount{0}; // Images with distinct content among them
+
+        uint32_t CompressedTextureCount{0}; // Textures block compressed during this load
+        uint32_t StoredTextureCount{0};     // Textures read from the texture store, without decoding their images
+        uint32_t CachedTextureCount{0};     // Textures found in the asset cache or the texture residency of the Pbr resources
+        uint32_t StreamedTextureCount{0};   // Textures created with their mip levels streamed by the texture residency
+        uint32_t CachedMaterialCount{0};    // Materials found in the asset cache, whose textures were not needed
+    };
+
     // Creates a Pbr Model from tinygltf model.
+    // Images that were loaded as-is (still encoded) are decoded in parallel while the geometry is read. Textures sampled with a
+    // mipmapping filter get a full mip chain. Textures are block compressed as set by Pbr::Resources::SetTextureCompression.
     std::shared_ptr<Pbr::Model> FromGltfObject(
         const Pbr::Resources& pbrResources,
-        const tinygltf::Model& gltfModel);
+        const tinygltf::Model& gltfModel,
+        _Out_opt_ LoadStatistics* statistics = nullptr);
 
 
     // Creates a Pbr Model from glTF 2.0 GLB file content.
     std::shared_ptr<Pbr::Model> FromGltfBinary(
         const Pbr::Resources& pbrResources,
         _In_reads_bytes_(bufferBytes) const uint8_t* buffer,
-        uint32_t bufferBytes);
+        uint32_t bufferBytes,
+        _Out_opt_ LoadStatistics* statistics = nullptr);
+
+    // Creates a Pbr Model from glTF 2.0 GLB file content in two phases. This call reads the content on the CPU and returns
+    // the model with its nodes and materials, but without primitives. The primitives, then the textures, are created by
+    // uploads added to the batch, which appear in the model as the upload queue runs them. Until its texture is created,
+    // a material slot shows the default color of the slot.
+    std::shared_ptr<Pbr::Model> FromGltfBinary(
+        const Pbr::Resources& pbrResources,
+        _In_reads_bytes_(bufferBytes) const uint8_t* buffer,
+        uint32_t bufferBytes,
+        Pbr::UploadQueue& uploadQueue,
+        const std::shared_ptr<Pbr::UploadBatch>& uploadBatch);
 
     template<typename Container>
-    std::shared_ptr<Pbr::Model> FromGltfBinary(const Pbr::Resources& pbrResources, const Container& buffer) {
-        return FromGltfBinary(pbrResources, buffer.data(), static_cast<uint32_t>(buffer.size()));
+    std::shared_ptr<Pbr::Model> FromGltfBinary(const Pbr::Resources& pbrResources,
+                                               const Container& buffer,
+                                               _Out_opt_ LoadStatistics* statistics = nullptr) {
+        return FromGltfBinary(pbrResources, buffer.data(), static_cast<uint32_t>(buffer.size()), statistics);
     }
 }
@@ -0,0 +1,190 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#include "pch.h"
+#include <algorithm>
+#include "PbrCommon.h"
+#include "PbrMaterial.h"
+#include "PbrAssetCache.h"
+
+namespace {
+    // The GPU memory of a 2D texture, counting whole blocks for block compressed formats.
+    size_t TextureBytes(_In_ ID3D11ShaderResourceView* view) {
+        winrt::com_ptr<ID3D11Resource> resource;
+        view->GetResource(resource.put());
+        const winrt::com_ptr<ID3D11Texture2D> texture = resource.try_as<ID3D11Texture2D>();
+        if (!texture) {
+            return 0;
+        }
+
+        D3D11_TEXTURE2D_DESC desc;
+        texture->GetDesc(&desc);
+
+        uint32_t blockSize = 1;
+        size_t blockBytes = 4;
+        switch (desc.Format) {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+            blockSize = 4;
+            blockBytes = 8;
+            break;
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            blockSize = 4;
+            blockBytes = 16;
+            break;
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            blockBytes = 8;
+            break;
+        default:
+            break;
+        }
+
+        size_t bytes = 0;
+        for (uint32_t level = 0; level < desc.MipLevels; level++) {
+            const uint32_t width = std::max(desc.Width >> level, 1u);
+            const uint32_t height = std::max(desc.Height >> level, 1u);
+            bytes += static_cast<size_t>((width + blockSize - 1) / blockSize) * ((height + blockSize - 1) / blockSize) * blockBytes;
+        }
+        return bytes * desc.ArraySize;
+    }
+} // namespace
+
+namespace Pbr {
+    std::shared_ptr<const CachedTexture> AssetCache::FindTexture(const std::string& key) {
+        std::lock_guard lock(m_mutex);
+        const auto it = m_textures.find(key);
+        if (it == m_textures.end()) {
+            m_statistics.TextureMisses++;
+            return nullptr;
+        }
+
+        it->second.LastUse = ++m_useCount;
+        m_statistics.TextureHits++;
+        m_statistics.BytesSaved += it->second.Bytes;
+        return it->second.Texture;
+    }
+
+    std::shared_ptr<const CachedTexture> AssetCache::AddTexture(const std::string& key, winrt::com_ptr<ID3D11ShaderResourceView> texture) {
+        const size_t bytes = TextureBytes(texture.get());
+        TextureEntry entry{std::make_shared<const CachedTexture>(CachedTexture{std::move(texture)}), bytes, 0};
+
+        std::lock_guard lock(m_mutex);
+        const auto [it, inserted] = m_textures.emplace(key, std::move(entry));
+        it->second.LastUse = ++m_useCount;
+        if (inserted) {
+            m_statistics.TextureBytes += bytes;
+        }
+
+        // The texture is copied before trimming, so it counts as used and isn't evicted.
+        std::shared_ptr<const CachedTexture> cachedTexture = it->second.Texture;
+        TrimWithLock();
+        return cachedTexture;
+    }
+
+    winrt::com_ptr<ID3D11SamplerState> AssetCache::FindOrCreateSampler(_In_ ID3D11Device* device, const D3D11_SAMPLER_DESC& desc) {
+        {
+            std::lock_guard lock(m_mutex);
+            const auto it = m_samplers.find(desc);
+            if (it != m_samplers.end()) {
+                m_statistics.SamplerHits++;
+                return it->second;
+            }
+            m_statistics.SamplerMisses++;
+        }
+
+        winrt::com_ptr<ID3D11SamplerState> sampler;
+        Internal::ThrowIfFailed(device->CreateSamplerState(&desc, sampler.put()));
+
+        std::lock_guard lock(m_mutex);
+        // If another thread created the sampler in the meantime, its sampler is returned.
+        return m_samplers.emplace(desc, std::move(sampler)).first->second;
+    }
+
+    std::shared_ptr<Material> AssetCache::FindMaterial(const std::string& key) {
+        std::lock_guard lock(m_mutex);
+        const auto it = m_materials.find(key);
+        std::shared_ptr<Material> material = it != m_materials.end() ? it->second.lock() : nullptr;
+        if (!material) {
+            m_statistics.MaterialMisses++;
+            return nullptr;
+        }
+
+        m_statistics.MaterialHits++;
+        return material;
+    }
+
+    std::shared_ptr<Material> AssetCache::AddMaterial(const std::string& key, std::shared_ptr<Material> material) {
+        std::lock_guard lock(m_mutex);
+        std::weak_ptr<Material>& entry = m_materials[key];
+        if (std::shared_ptr<Material> cachedMaterial = entry.lock()) {
+            return cachedMaterial;
+        }
+
+        material->m_shared = true;
+        entry = material;
+        return material;
+    }
+
+    void AssetCache::SetTextureCapacity(size_t bytes) {
+        std::lock_guard lock(m_mutex);
+        m_textureCapacity = bytes;
+        TrimWithLock();
+    }
+
+    void AssetCache::Trim() {
+        std::lock_guard lock(m_mutex);
+        TrimWithLock();
+    }
+
+    void AssetCache::TrimWithLock() {
+        for (auto it = m_materials.begin(); it != m_materials.end();) {
+            it = it->second.expired() ? m_materials.erase(it) : std::next(it);
+        }
+
+        size_t unusedBytes = 0;
+        for (const auto& [key, entry] : m_textures) {
+            unusedBytes += entry.IsUnused() ? entry.Bytes : 0;
+        }
+
+        while (unusedBytes > m_textureCapacity) {
+            auto leastRecentlyUsed = m_textures.end();
+            for (auto it = m_textures.begin(); it != m_textures.end(); ++it) {
+                if ((leastRecentlyUsed == m_textures.end() || it->second.LastUse < leastRecentlyUsed->second.LastUse) &&
+                    it->second.IsUnused()) {
+                    leastRecentlyUsed = it;
+                }
+            }
+
+            unusedBytes -= leastRecentlyUsed->second.Bytes;
+            m_statistics.TextureBytes -= leastRecentlyUsed->second.Bytes;
+            m_textures.erase(leastRecentlyUsed);
+            m_statistics.Evictions++;
+        }
+    }
+
+    void AssetCache::Clear() {
+        std::lock_guard lock(m_mutex);
+        m_statistics.Evictions += static_cast<uint32_t>(m_textures.size() + m_samplers.size() + m_materials.size());
+        m_statistics.TextureBytes = 0;
+        m_textures.clear();
+        m_samplers.clear();
+        m_materials.clear();
+    }
+
+    AssetCacheStatistics AssetCache::Statistics() const {
+        std::lock_guard lock(m_mutex);
+        AssetCacheStatistics statistics = m_statistics;
+        statistics.TextureCount = static_cast<uint32_t>(m_textures.size());
+        for (const auto& [key, entry] : m_textures) {
+            statistics.UnusedTextureBytes += entry.IsUnused() ? entry.Bytes : 0;
+        }
+        for (const auto& [key, material] : m_materials) {
+            statistics.MaterialCount += material.expired() ? 0 : 1;
+        }
+        return statistics;
+    }
+} // namespace Pbr
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// A cache of the textures, samplers and materials shared by the models loaded with the same Pbr resources.
+//
+
+#pragma once
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <winrt/base.h>
+#include <d3d11.h>
+
+namespace Pbr {
+    struct Material;
+
+    // A texture of the asset cache. The cache counts the materials using the texture by the references to it, so materials
+    // hold it rather than only its view, see Material::SetTexture.
+    struct CachedTexture {
+        winrt::com_ptr<ID3D11ShaderResourceView> View;
+    };
+
+    struct AssetCacheStatistics {
+        uint32_t TextureHits{0};
+        uint32_t TextureMisses{0};
+        uint32_t SamplerHits{0};
+        uint32_t SamplerMisses{0};
+        uint32_t MaterialHits{0};
+        uint32_t MaterialMisses{0};
+        size_t BytesSaved{0}; // GPU memory of the textures found in the cache, which were not created again
+        uint32_t Evictions{0};
+
+        uint32_t TextureCount{0};
+        size_t TextureBytes{0};       // GPU memory of the cached textures
+        size_t UnusedTextureBytes{0}; // GPU memory of the cached textures no model uses, which the cache alone keeps alive
+        uint32_t MaterialCount{0};
+    };
+
+    // Textures are keyed by their content and everything that changes their texels, such as the sRGB flag, mip levels and
+    // compression. Materials are keyed by their parameters and the keys of their textures and samplers, and are shared
+    // as they are: a cached material must not be edited, see Material::IsShared. Thread safe, so concurrent loads share
+    // what they create.
+    //
+    // Materials are held weakly, so they and their textures are released with the last model using them. Textures no material
+    // holds any more are kept for later loads up to the capacity, and evicted least recently used first by Trim, which
+    // engine::Scene calls when it removes objects.
+    class AssetCache {
+    public:
+        // Returns the cached texture, or null if there is none for the key.
+        std::shared_ptr<const CachedTexture> FindTexture(const std::string& key);
+
+        // Caches the texture, and returns it. If another load cached a texture for the key first, that texture is returned
+        // instead. Least recently used textures are evicted when the cached textures exceed the capacity.
+        std::shared_ptr<const CachedTexture> AddTexture(const std::string& key, winrt::com_ptr<ID3D11ShaderResourceView> texture);
+
+        // Returns the cached sampler with the description, creating it if needed.
+        winrt::com_ptr<ID3D11SamplerState> FindOrCreateSampler(_In_ ID3D11Device* device, const D3D11_SAMPLER_DESC& desc);
+
+        // Returns the cached material, or null if there is none for the key.
+        std::shared_ptr<Material> FindMaterial(const std::string& key);
+
+        // Caches the material and marks it shared, and returns it. The material must be complete, with all its textures. If
+        // another load cached a material for the key first, that material is returned instead.
+        std::shared_ptr<Material> AddMaterial(const std::string& key, std::shared_ptr<Material> material);
+
+        // The GPU memory of the textures no model uses that the cache keeps for later loads. 0 keeps none of them, so the
+        // cache only shares what is in use. Textures in use don't count, since evicting them wouldn't release them.
+        void SetTextureCapacity(size_t bytes);
+
+        // Forgets the materials no model uses any more, and evicts the least recently used textures no model uses above the
+        // capacity.
+        void Trim();
+
+        // Evicts everything, for example when the device is released.
+        void Clear();
+
+        AssetCacheStatistics Statistics() const;
+
+    private:
+        struct TextureEntry {
+            std::shared_ptr<const CachedTexture> Texture;
+            size_t Bytes{0};
+            uint64_t LastUse{0};
+
+            // Whether the cache holds the only reference to the texture, so that no material uses it.
+            bool IsUnused() const {
+                return Texture.use_count() == 1;
+            }
+        };
+
+        struct SamplerDescLess {
+            bool operator()(const D3D11_SAMPLER_DESC& a, const D3D11_SAMPLER_DESC& b) const {
+                return std::memcmp(&a, &b, sizeof(D3D11_SAMPLER_DESC)) < 0;
+            }
+        };
+
+        void TrimWithLock();
+
+        mutable std::mutex m_mutex;
+        std::map<std::string, TextureEntry> m_textures;
+        std::map<D3D11_SAMPLER_DESC, winrt::com_ptr<ID3D11SamplerState>, SamplerDescLess> m_samplers;
+        std::map<std::string, std::weak_ptr<Material>> m_materials;
+        size_t m_textureCapacity{32 * 1024 * 1024};
+        uint64_t m_useCount{0};
+        AssetCacheStatistics m_statistics;
+    };
+} // namespace Pbr
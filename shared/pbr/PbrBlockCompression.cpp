@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#include "pch.h"
+#include <cstring>
+#include "PbrBlockCompression.h"
+
+namespace {
+    constexpr uint32_t DdsMagic = 0x20534444;                                  // "DDS "
+    constexpr uint32_t DdsFourCCDX10 = '0' << 24 | '1' << 16 | 'X' << 8 | 'D'; // "DX10"
+
+    // The magic number, the 124 byte DDS_HEADER and the 20 byte DDS_HEADER_DXT10, as little endian 32 bit words.
+    constexpr size_t DdsHeaderWords = 1 + 31 + 5;
+} // namespace
+
+namespace Pbr {
+    DXGI_FORMAT ToDxgiFormat(BlockFormat format, bool sRGB) {
+        switch (format) {
+        case BlockFormat::BC1:
+            return sRGB ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+        case BlockFormat::BC3:
+            return sRGB ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+        case BlockFormat::BC5:
+            return DXGI_FORMAT_BC5_UNORM;
+        case BlockFormat::BC7:
+            return sRGB ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+        }
+        throw std::exception("Unknown block format");
+    }
+
+    std::vector<uint8_t> SaveDds(const CompressedTexture& texture) {
+        constexpr uint32_t HeaderFlags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000; // Caps, height, width, pixel format, mips, size
+        constexpr uint32_t PixelFormatFourCC = 0x4;
+        constexpr uint32_t CapsTexture = 0x1000;
+        constexpr uint32_t CapsMipmap = 0x400000 | 0x8; // Mipmap and complex
+        constexpr uint32_t ResourceDimensionTexture2D = 3;
+
+        const uint32_t levelCount = static_cast<uint32_t>(texture.Levels.size());
+
+        uint32_t header[DdsHeaderWords]{};
+        header[0] = DdsMagic;
+        header[1] = 124;
+        header[2] = HeaderFlags;
+        header[3] = texture.Levels[0].Height;
+        header[4] = texture.Levels[0].Width;
+        header[5] = texture.RowPitch(0) * ((texture.Levels[0].Height + 3) / 4);
+        header[7] = levelCount;
+        header[19] = 32; // DDS_PIXELFORMAT size
+        header[20] = PixelFormatFourCC;
+        header[21] = DdsFourCCDX10;
+        header[27] = CapsTexture | (levelCount > 1 ? CapsMipmap : 0);
+        header[32] = ToDxgiFormat(texture.Format, texture.SRGB);
+        header[33] = ResourceDimensionTexture2D;
+        header[35] = 1; // Array size
+
+        std::vector<uint8_t> file(sizeof(header) + texture.Data.size());
+        memcpy(file.data(), header, sizeof(header));
+        memcpy(file.data() + sizeof(header), texture.Data.data(), texture.Data.size());
+        return file;
+    }
+
+    std::vector<uint8_t> LoadDdsData(const std::vector<uint8_t>& ddsFile) {
+        uint32_t header[DdsHeaderWords];
+        if (ddsFile.size() < sizeof(header)) {
+            throw std::runtime_error("The DDS file is too short");
+        }
+
+        memcpy(header, ddsFile.data(), sizeof(header));
+        if (header[0] != DdsMagic || header[1] != 124 || header[21] != DdsFourCCDX10) {
+            throw std::runtime_error("The DDS file wasn't written by SaveDds");
+        }
+        return std::vector<uint8_t>(ddsFile.begin() + sizeof(header), ddsFile.end());
+    }
+} // namespace Pbr
@@ -0,0 +1,42 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// The Direct3D formats of the block compressed textures of PbrBlockEncoding.h, and the DDS container to store them.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <winrt/base.h>
+#include <d3d11.h>
+#include "PbrBlockEncoding.h"
+
+namespace Pbr {
+    DXGI_FORMAT ToDxgiFormat(BlockFormat format, bool sRGB);
+
+    // Serializes the texture as a DDS file, with the DX10 header extension for the DXGI format.
+    std::vector<uint8_t> SaveDds(const CompressedTexture& texture);
+
+    // The texels of all levels of a DDS file written by SaveDds, laid out as CompressedTexture::Data. Throws if the file
+    // isn't one.
+    std::vector<uint8_t> LoadDdsData(const std::vector<uint8_t>& ddsFile);
+
+    // Storage for transcoded textures, such as a folder on disk. Keys are derived from the image content and the transcode
+    // settings, so an entry never goes stale. Implementations must be safe to call from several threads.
+    class TextureStore {
+    public:
+        virtual ~TextureStore() = default;
+
+        // Creates the texture stored under the key, or returns null if there is none.
+        virtual winrt::com_ptr<ID3D11ShaderResourceView> Load(_In_ ID3D11Device* device, const std::string& key) = 0;
+
+        // Stores the DDS file content under the key.
+        virtual void Store(const std::string& key, const std::vector<uint8_t>& ddsFile) = 0;
+
+        // Returns the DDS file content stored under the key, or an empty vector if there is none. Streamed textures read
+        // their levels again this way, see StreamedLevelReader.
+        virtual std::vector<uint8_t> Read(const std::string& key) = 0;
+    };
+} // namespace Pbr
@@ -0,0 +1,448 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// Doesn't use the precompiled header, which includes Windows headers, so that it builds on any platform.
+//
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <DirectXMath.h>
+#include "PbrTaskScheduler.h"
+#include "PbrBlockEncoding.h"
+
+using namespace DirectX;
+
+namespace {
+    constexpr uint32_t TexelsPerBlock = 16;
+
+    // Interpolation weights of the 4 bit indices of BC7, in 64ths.
+    constexpr uint32_t Bc7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    // Writes bit fields in the order of the BC block layouts, starting at the least significant bit of the first byte.
+    class BitWriter {
+    public:
+        explicit BitWriter(uint8_t* block, uint32_t byteCount)
+            : m_block(block) {
+            memset(block, 0, byteCount);
+        }
+
+        void Write(uint32_t value, uint32_t bitCount) {
+            for (uint32_t i = 0; i < bitCount; i++, m_position++) {
+                m_block[m_position / 8] |= static_cast<uint8_t>(((value >> i) & 1) << (m_position % 8));
+            }
+        }
+
+    private:
+        uint8_t* m_block;
+        uint32_t m_position{0};
+    };
+
+    XMVECTOR LoadTexel(const std::array<uint8_t, 64>& rgba, uint32_t texel) {
+        return XMVectorSet(rgba[texel * 4 + 0], rgba[texel * 4 + 1], rgba[texel * 4 + 2], rgba[texel * 4 + 3]);
+    }
+
+    float SquaredDistance(FXMVECTOR a, FXMVECTOR b) {
+        return XMVectorGetX(XMVector4LengthSq(XMVectorSubtract(a, b)));
+    }
+
+    // Finds the line through the texels along their largest variance, by power iteration on their covariance. Only the channels
+    // selected by the mask take part. Returns the endpoints of the segment of the line covered by the texels.
+    std::pair<XMVECTOR, XMVECTOR> FitLine(const XMVECTOR (&texels)[TexelsPerBlock], FXMVECTOR channelMask) {
+        XMVECTOR mean = XMVectorZero();
+        XMVECTOR minimum = XMVectorReplicate(255);
+        XMVECTOR maximum = XMVectorZero();
+        for (const XMVECTOR& texel : texels) {
+            mean = XMVectorAdd(mean, texel);
+            minimum = XMVectorMin(minimum, texel);
+            maximum = XMVectorMax(maximum, texel);
+        }
+        mean = XMVectorAndInt(XMVectorScale(mean, 1.0f / TexelsPerBlock), channelMask);
+
+        float covariance[4][4]{};
+        for (const XMVECTOR& texel : texels) {
+            XMFLOAT4 d;
+            XMStoreFloat4(&d, XMVectorAndInt(XMVectorSubtract(texel, mean), channelMask));
+            const float delta[4] = {d.x, d.y, d.z, d.w};
+            for (int i = 0; i < 4; i++) {
+                for (int j = 0; j < 4; j++) {
+                    covariance[i][j] += delta[i] * delta[j];
+                }
+            }
+        }
+
+        // Starting from the diagonal of the bounding box converges in a few iterations for typical blocks.
+        XMVECTOR axis = XMVectorAndInt(XMVectorSubtract(maximum, minimum), channelMask);
+        for (int iteration = 0; iteration < 8; iteration++) {
+            XMFLOAT4 v;
+            XMStoreFloat4(&v, axis);
+            const float in[4] = {v.x, v.y, v.z, v.w};
+            float out[4]{};
+            for (int i = 0; i < 4; i++) {
+                for (int j = 0; j < 4; j++) {
+                    out[i] += covariance[i][j] * in[j];
+                }
+            }
+
+            const XMVECTOR next = XMVectorSet(out[0], out[1], out[2], out[3]);
+            const float length = XMVectorGetX(XMVector4Length(next));
+            if (length < 1e-6f) {
+                break; // All texels are equal, or the axis has no variance left.
+            }
+            axis = XMVectorScale(next, 1 / length);
+        }
+
+        float minProjection = 0;
+        float maxProjection = 0;
+        for (const XMVECTOR& texel : texels) {
+            const float projection = XMVectorGetX(XMVector4Dot(XMVectorAndInt(XMVectorSubtract(texel, mean), channelMask), axis));
+            minProjection = std::min(minProjection, projection);
+            maxProjection = std::max(maxProjection, projection);
+        }
+
+        const XMVECTOR limit = XMVectorReplicate(255);
+        return {XMVectorClamp(XMVectorMultiplyAdd(axis, XMVectorReplicate(minProjection), mean), XMVectorZero(), limit),
+                XMVectorClamp(XMVectorMultiplyAdd(axis, XMVectorReplicate(maxProjection), mean), XMVectorZero(), limit)};
+    }
+
+    // Solves for the two endpoints minimizing the squared error of the texels, given the weight of the first endpoint per texel.
+    bool SolveEndpoints(const XMVECTOR (&texels)[TexelsPerBlock],
+                        const float (&weights)[TexelsPerBlock],
+                        XMVECTOR& first,
+                        XMVECTOR& second) {
+        float aa = 0, ab = 0, bb = 0;
+        XMVECTOR ax = XMVectorZero();
+        XMVECTOR bx = XMVectorZero();
+        for (uint32_t i = 0; i < TexelsPerBlock; i++) {
+            const float a = weights[i];
+            const float b = 1 - a;
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            ax = XMVectorMultiplyAdd(texels[i], XMVectorReplicate(a), ax);
+            bx = XMVectorMultiplyAdd(texels[i], XMVectorReplicate(b), bx);
+        }
+
+        const float determinant = aa * bb - ab * ab;
+        if (std::abs(determinant) < 1e-6f) {
+            return false;
+        }
+
+        const XMVECTOR limit = XMVectorReplicate(255);
+        first = XMVectorClamp(XMVectorScale(XMVectorSubtract(XMVectorScale(ax, bb), XMVectorScale(bx, ab)), 1 / determinant),
+                              XMVectorZero(),
+                              limit);
+        second = XMVectorClamp(XMVectorScale(XMVectorSubtract(XMVectorScale(bx, aa), XMVectorScale(ax, ab)), 1 / determinant),
+                               XMVectorZero(),
+                               limit);
+        return true;
+    }
+
+    uint16_t To565(FXMVECTOR color) {
+        XMFLOAT4 c;
+        XMStoreFloat4(&c, XMVectorRound(XMVectorMultiply(color, XMVectorSet(31.0f / 255, 63.0f / 255, 31.0f / 255, 0))));
+        return static_cast<uint16_t>((static_cast<uint32_t>(c.x) << 11) | (static_cast<uint32_t>(c.y) << 5) |
+                                     static_cast<uint32_t>(c.z));
+    }
+
+    XMVECTOR From565(uint16_t color) {
+        const uint32_t r = (color >> 11) & 31;
+        const uint32_t g = (color >> 5) & 63;
+        const uint32_t b = color & 31;
+        return XMVectorSet(static_cast<float>((r << 3) | (r >> 2)),
+                           static_cast<float>((g << 2) | (g >> 4)),
+                           static_cast<float>((b << 3) | (b >> 2)),
+                           0);
+    }
+
+    // Encodes the RGB of the texels as a BC1 color block in four color mode, which is also the color part of BC3.
+    void EncodeColorBlock(const std::array<uint8_t, 64>& rgba, _Out_writes_bytes_(8) uint8_t* block) {
+        const XMVECTOR rgbMask = XMVectorSelectControl(1, 1, 1, 0);
+
+        XMVECTOR texels[TexelsPerBlock];
+        for (uint32_t i = 0; i < TexelsPerBlock; i++) {
+            texels[i] = XMVectorAndInt(LoadTexel(rgba, i), rgbMask);
+        }
+
+        auto [low, high] = FitLine(texels, rgbMask);
+        uint16_t color0 = To565(high);
+        uint16_t color1 = To565(low);
+
+        // Palette entry i is weighted by paletteWeights[i] towards color0.
+        constexpr float paletteWeights[4] = {1, 0, 2.0f / 3, 1.0f / 3};
+        uint32_t indices[TexelsPerBlock]{};
+        float bestError = std::numeric_limits<float>::max();
+        uint16_t bestColor0 = color0;
+        uint16_t bestColor1 = color1;
+        uint32_t bestIndices[TexelsPerBlock]{};
+
+        // Choose the indices for the endpoints, then refit the endpoints to the indices, and keep whichever is best.
+        for (int iteration = 0; iteration < 2; iteration++) {
+            const XMVECTOR c0 = From565(color0);
+            const XMVECTOR c1 = From565(color1);
+            XMVECTOR palette[4];
+            for (int i = 0; i < 4; i++) {
+                palette[i] = XMVectorLerp(c1, c0, paletteWeights[i]);
+            }
+
+            float error = 0;
+            for (uint32_t t = 0; t < TexelsPerBlock; t++) {
+                float bestTexelError = std::numeric_limits<float>::max();
+                for (uint32_t i = 0; i < 4; i++) {
+                    const float texelError = SquaredDistance(texels[t], palette[i]);
+                    if (texelError < bestTexelError) {
+                        bestTexelError = texelError;
+                        indices[t] = i;
+                    }
+                }
+                error += bestTexelError;
+            }
+
+            if (error < bestError) {
+                bestError = error;
+                bestColor0 = color0;
+                bestColor1 = color1;
+                std::copy(std::begin(indices), std::end(indices), std::begin(bestIndices));
+            }
+
+            float weights[TexelsPerBlock];
+            for (uint32_t t = 0; t < TexelsPerBlock; t++) {
+                weights[t] = paletteWeights[indices[t]];
+            }
+            XMVECTOR refined0, refined1;
+            if (!SolveEndpoints(texels, weights, refined0, refined1)) {
+                break;
+            }
+            color0 = To565(refined0);
+            color1 = To565(refined1);
+        }
+
+        // Four color mode requires color0 > color1. Swapping the endpoints swaps the roles of the indices 0 and 1, and 2 and 3.
+        if (bestColor0 < bestColor1) {
+            std::swap(bestColor0, bestColor1);
+            for (uint32_t& index : bestIndices) {
+                index ^= 1;
+            }
+        } else if (bestColor0 == bestColor1) {
+            std::fill(std::begin(bestIndices), std::end(bestIndices), 0);
+        }
+
+        BitWriter writer(block, 8);
+        writer.Write(bestColor0, 16);
+        writer.Write(bestColor1, 16);
+        for (const uint32_t index : bestIndices) {
+            writer.Write(index, 2);
+        }
+    }
+
+    // Encodes one channel of the texels as a BC4 block, which is the alpha part of BC3 and each half of BC5.
+    void EncodeChannelBlock(const std::array<uint8_t, 64>& rgba, uint32_t channel, _Out_writes_bytes_(8) uint8_t* block) {
+        uint8_t minimum = 255;
+        uint8_t maximum = 0;
+        for (uint32_t t = 0; t < TexelsPerBlock; t++) {
+            minimum = std::min(minimum, rgba[t * 4 + channel]);
+            maximum = std::max(maximum, rgba[t * 4 + channel]);
+        }
+
+        BitWriter writer(block, 8);
+        writer.Write(maximum, 8);
+        writer.Write(minimum, 8);
+        if (maximum == minimum) {
+            writer.Write(0, 48); // Every index selects the first endpoint.
+            return;
+        }
+
+        // With endpoint0 > endpoint1, index 0 and 1 select the endpoints and 2 to 7 the six values between them.
+        for (uint32_t t = 0; t < TexelsPerBlock; t++) {
+            const float position = static_cast<float>(rgba[t * 4 + channel] - minimum) / (maximum - minimum); // 0 at minimum
+            const uint32_t step = static_cast<uint32_t>(std::lround(position * 7)); // 7 at maximum
+            const uint32_t index = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+            writer.Write(index, 3);
+        }
+    }
+
+    // Quantizes an endpoint to 7 bits per channel and the shared p-bit, which is the least significant bit of all channels.
+    void QuantizeBc7Endpoint(FXMVECTOR endpoint, uint32_t (&quantized)[4], uint32_t& pBit, XMVECTOR& reconstructed) {
+        float bestError = std::numeric_limits<float>::max();
+        for (uint32_t p = 0; p < 2; p++) {
+            XMFLOAT4 q;
+            const XMVECTOR pValue = XMVectorReplicate(static_cast<float>(p));
+            XMStoreFloat4(&q,
+                          XMVectorClamp(XMVectorRound(XMVectorScale(XMVectorSubtract(endpoint, pValue), 0.5f)),
+                                        XMVectorZero(),
+                                        XMVectorReplicate(127)));
+            const XMVECTOR value = XMVectorAdd(XMVectorScale(XMLoadFloat4(&q), 2), pValue);
+            const float error = SquaredDistance(value, endpoint);
+            if (error < bestError) {
+                bestError = error;
+                quantized[0] = static_cast<uint32_t>(q.x);
+                quantized[1] = static_cast<uint32_t>(q.y);
+                quantized[2] = static_cast<uint32_t>(q.z);
+                quantized[3] = static_cast<uint32_t>(q.w);
+                pBit = p;
+                reconstructed = value;
+            }
+        }
+    }
+
+    // Encodes the texels as a BC7 mode 6 block: one subset, RGBA endpoints with 7 bits and a p-bit each, and 4 bit indices.
+    void EncodeBc7Block(const std::array<uint8_t, 64>& rgba, _Out_writes_bytes_(16) uint8_t* block) {
+        XMVECTOR texels[TexelsPerBlock];
+        for (uint32_t i = 0; i < TexelsPerBlock; i++) {
+            texels[i] = LoadTexel(rgba, i);
+        }
+
+        auto [endpoint0, endpoint1] = FitLine(texels, XMVectorTrueInt());
+
+        uint32_t bestQuantized[2][4]{};
+        uint32_t bestPBits[2]{};
+        uint32_t bestIndices[TexelsPerBlock]{};
+        float bestError = std::numeric_limits<float>::max();
+
+        for (int iteration = 0; iteration < 2; iteration++) {
+            uint32_t quantized[2][4];
+            uint32_t pBits[2];
+            XMVECTOR reconstructed[2];
+            QuantizeBc7Endpoint(endpoint0, quantized[0], pBits[0], reconstructed[0]);
+            QuantizeBc7Endpoint(endpoint1, quantized[1], pBits[1], reconstructed[1]);
+
+            // The decoder interpolates the integer endpoints as ((64 - w) * e0 + w * e1 + 32) >> 6.
+            XMVECTOR palette[16];
+            for (uint32_t i = 0; i < 16; i++) {
+                const XMVECTOR weighted = XMVectorLerp(
+                    XMVectorScale(reconstructed[0], 64), XMVectorScale(reconstructed[1], 64), Bc7Weights4[i] / 64.0f);
+                palette[i] = XMVectorFloor(XMVectorScale(XMVectorAdd(weighted, XMVectorReplicate(32)), 1.0f / 64));
+            }
+
+            uint32_t indices[TexelsPerBlock];
+            float error = 0;
+            for (uint32_t t = 0; t < TexelsPerBlock; t++) {
+                float bestTexelError = std::numeric_limits<float>::max();
+                for (uint32_t i = 0; i < 16; i++) {
+                    const float texelError = SquaredDistance(texels[t], palette[i]);
+                    if (texelError < bestTexelError) {
+                        bestTexelError = texelError;
+                        indices[t] = i;
+                    }
+                }
+                error += bestTexelError;
+            }
+
+            if (error < bestError) {
+                bestError = error;
+                memcpy(bestQuantized, quantized, sizeof(quantized));
+                memcpy(bestPBits, pBits, sizeof(pBits));
+                memcpy(bestIndices, indices, sizeof(indices));
+            }
+
+            float weights[TexelsPerBlock];
+            for (uint32_t t = 0; t < TexelsPerBlock; t++) {
+                weights[t] = 1 - Bc7Weights4[indices[t]] / 64.0f;
+            }
+            if (!SolveEndpoints(texels, weights, endpoint0, endpoint1)) {
+                break;
+            }
+        }
+
+        // The most significant bit of the first index is implied to be zero. Swapping the endpoints mirrors the indices.
+        if (bestIndices[0] >= 8) {
+            std::swap(bestQuantized[0], bestQuantized[1]);
+            std::swap(bestPBits[0], bestPBits[1]);
+            for (uint32_t& index : bestIndices) {
+                index = 15 - index;
+            }
+        }
+
+        BitWriter writer(block, 16);
+        writer.Write(1 << 6, 7); // Mode 6
+        for (uint32_t channel = 0; channel < 4; channel++) {
+            writer.Write(bestQuantized[0][channel], 7);
+            writer.Write(bestQuantized[1][channel], 7);
+        }
+        writer.Write(bestPBits[0], 1);
+        writer.Write(bestPBits[1], 1);
+        writer.Write(bestIndices[0], 3);
+        for (uint32_t t = 1; t < TexelsPerBlock; t++) {
+            writer.Write(bestIndices[t], 4);
+        }
+    }
+} // namespace
+
+namespace Pbr {
+    uint32_t BlockBytes(BlockFormat format) {
+        return format == BlockFormat::BC1 ? 8 : 16;
+    }
+
+    bool CanBlockCompress(uint32_t width, uint32_t height) {
+        return width % 4 == 0 && height % 4 == 0;
+    }
+
+    void EncodeBlock(BlockFormat format, const std::array<uint8_t, 64>& rgba, _Out_writes_bytes_(16) uint8_t* block) {
+        switch (format) {
+        case BlockFormat::BC1:
+            EncodeColorBlock(rgba, block);
+            break;
+        case BlockFormat::BC3:
+            EncodeChannelBlock(rgba, 3, block);
+            EncodeColorBlock(rgba, block + 8);
+            break;
+        case BlockFormat::BC5:
+            EncodeChannelBlock(rgba, 0, block);
+            EncodeChannelBlock(rgba, 1, block + 8);
+            break;
+        case BlockFormat::BC7:
+            EncodeBc7Block(rgba, block);
+            break;
+        }
+    }
+
+    CompressedTexture CompressMipChain(const MipChain& mipChain, BlockFormat format, bool sRGB) {
+        if (mipChain.Levels.empty() || !CanBlockCompress(mipChain.Levels[0].Width, mipChain.Levels[0].Height)) {
+            throw std::invalid_argument("The texture size is not a multiple of the block size.");
+        }
+
+        CompressedTexture texture;
+        texture.Format = format;
+        texture.SRGB = sRGB;
+        texture.Levels = mipChain.Levels;
+
+        size_t dataSize = 0;
+        for (size_t level = 0; level < texture.Levels.size(); level++) {
+            texture.Levels[level].Offset = dataSize;
+            dataSize += static_cast<size_t>(texture.RowPitch(level)) * ((texture.Levels[level].Height + 3) / 4);
+        }
+        texture.Data.resize(dataSize);
+
+        for (size_t level = 0; level < texture.Levels.size(); level++) {
+            const uint32_t width = texture.Levels[level].Width;
+            const uint32_t height = texture.Levels[level].Height;
+            const uint8_t* source = mipChain.LevelData(level);
+            uint8_t* destination = texture.Data.data() + texture.Levels[level].Offset;
+            const uint32_t blocksX = (width + 3) / 4;
+            const uint32_t blocksY = (height + 3) / 4;
+
+            Internal::ParallelForBands(blocksY, blocksX * TexelsPerBlock, [&](uint32_t beginRow, uint32_t endRow) {
+                std::array<uint8_t, 64> rgba;
+                for (uint32_t blockY = beginRow; blockY < endRow; blockY++) {
+                    for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+                        // Levels smaller than a block repeat their edge texels.
+                        for (uint32_t y = 0; y < 4; y++) {
+                            for (uint32_t x = 0; x < 4; x++) {
+                                const uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                                const uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+                                memcpy(&rgba[(y * 4 + x) * 4], source + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+                            }
+                        }
+
+                        const size_t blockIndex = static_cast<size_t>(blockY) * blocksX + blockX;
+                        EncodeBlock(format, rgba, destination + blockIndex * BlockBytes(format));
+                    }
+                }
+            });
+        }
+
+        return texture;
+    }
+} // namespace Pbr
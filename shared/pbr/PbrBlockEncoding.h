@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// CPU encoders for the BC1, BC3, BC5 and BC7 block compressed texture formats. Only the standard library and DirectXMath are
+// used, so the encoders build on any platform. PbrBlockCompression.h adds the Direct3D formats and the DDS container.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "PbrMipmaps.h"
+
+namespace Pbr {
+    enum class BlockFormat {
+        BC1, // RGB, 4 bits per texel
+        BC3, // RGBA with interpolated alpha, 8 bits per texel
+        BC5, // Two channels (RG), 8 bits per texel. Used for normal maps, whose z is reconstructed in the shader.
+        BC7, // RGBA, 8 bits per texel. The encoder uses mode 6, a single pair of RGBA endpoints with 16 interpolation steps.
+    };
+
+    // How textures loaded from glTF are compressed.
+    enum class TextureCompression {
+        None,        // RGBA, 32 bits per texel
+        Fast,        // BC1 for opaque colors and data maps, BC3 for colors with alpha, BC5 for normal maps
+        HighQuality, // BC7 for colors, BC1 for data maps, BC5 for normal maps
+    };
+
+    // The size of a 4x4 block of texels in bytes.
+    uint32_t BlockBytes(BlockFormat format);
+
+    // Compressed levels of a texture, most detailed level first. Level sizes are in texels and the rows of blocks are tightly packed.
+    struct CompressedTexture {
+        BlockFormat Format{BlockFormat::BC1};
+        bool SRGB{false};
+        std::vector<MipLevel> Levels;
+        std::vector<uint8_t> Data;
+
+        const uint8_t* LevelData(size_t level) const {
+            return Data.data() + Levels[level].Offset;
+        }
+        uint32_t RowPitch(size_t level) const {
+            return (Levels[level].Width + 3) / 4 * BlockBytes(Format);
+        }
+    };
+
+    // Block compression requires the most detailed level to be a whole number of blocks.
+    bool CanBlockCompress(uint32_t width, uint32_t height);
+
+    // Encodes one block of 4x4 RGBA texels, given in rows, into BlockBytes(format) bytes.
+    void EncodeBlock(BlockFormat format, const std::array<uint8_t, 64>& rgba, _Out_writes_bytes_(16) uint8_t* block);
+
+    // Encodes all levels of the mip chain. Large levels are encoded in bands on several threads.
+    CompressedTexture CompressMipChain(const MipChain& mipChain, BlockFormat format, bool sRGB);
+} // namespace Pbr
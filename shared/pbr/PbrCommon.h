@@ -9,85 +9,26 @@
 
 #include <vector>
 #include <array>
+#include <algorithm>
 #include <winrt/base.h>
 #include <d3d11.h>
 #include <d3d11_2.h>
 #include <DirectXMath.h>
 #include <DirectXColors.h>
+#include "PbrTypes.h"
+#include "PbrTaskScheduler.h"
 
 namespace Pbr {
+    struct MipChain;
+    struct CompressedTexture;
+    struct CubeMapData;
+    struct BrdfLutData;
+
     namespace Internal {
         void ThrowIfFailed(HRESULT hr);
-    }
-
-    using NodeIndex_t = uint16_t; // This type must align with the type used in the Pbr shaders.
-
-    // Indicates an invalid node index (similar to std::variant_npos)
-    inline constexpr Pbr::NodeIndex_t NodeIndex_npos = static_cast<Pbr::NodeIndex_t>(-1);
-    constexpr Pbr::NodeIndex_t RootNodeIndex = 0;
-
-    // These colors are in linear color space unless otherwise specified.
-    using RGBAColor = DirectX::XMFLOAT4;
-    using RGBColor = DirectX::XMFLOAT3;
-
-    // DirectX::Colors are in sRGB color space.
-    RGBAColor XM_CALLCONV FromSRGB(DirectX::XMVECTOR color);
-    RGBColor XM_CALLCONV RGBFromSRGB(DirectX::XMVECTOR color);
-
-    namespace RGBA {
-        constexpr RGBAColor White{1, 1, 1, 1};
-        constexpr RGBAColor Black{0, 0, 0, 1};
-        constexpr RGBAColor FlatNormal{0.5f, 0.5f, 1, 1};
-        constexpr RGBAColor Transparent{0, 0, 0, 0};
-    } // namespace RGBA
-
-    namespace RGB {
-        constexpr RGBColor White{1, 1, 1};
-        constexpr RGBColor Black{0, 0, 0};
-    } // namespace RGB
-
-    // Vertex structure used by the PBR shaders.
-    struct Vertex {
-        DirectX::XMFLOAT3 Position;
-        DirectX::XMFLOAT3 Normal;
-        DirectX::XMFLOAT4 Tangent;
-        DirectX::XMFLOAT4 Color0;
-        DirectX::XMFLOAT2 TexCoord0;
-        NodeIndex_t ModelTransformIndex; // Index into the node transforms
-
-        static const D3D11_INPUT_ELEMENT_DESC s_vertexDesc[6];
-    };
-
-    struct PrimitiveBuilder {
-        std::vector<Pbr::Vertex> Vertices;
-        std::vector<uint32_t> Indices;
-
-        PrimitiveBuilder& AddAxis(float axisLength = 1.0f,
-                                  float axisThickness = 0.1f,
-                                  Pbr::NodeIndex_t transformIndex = Pbr::RootNodeIndex);
-        PrimitiveBuilder& AddSphere(float diameter,
-                                    uint32_t tessellation,
-                                    Pbr::NodeIndex_t transformIndex = Pbr::RootNodeIndex,
-                                    RGBAColor vertexColor = RGBA::White);
-        PrimitiveBuilder& AddCube(float sideLength,
-                                  Pbr::NodeIndex_t transformIndex = Pbr::RootNodeIndex,
-                                  RGBAColor vertexColor = RGBA::White);
-        PrimitiveBuilder& AddCube(DirectX::XMFLOAT3 sideLengths,
-                                  Pbr::NodeIndex_t transformIndex = Pbr::RootNodeIndex,
-                                  RGBAColor vertexColor = RGBA::White);
-        PrimitiveBuilder& AddCube(DirectX::XMFLOAT3 sideLengths,
-                                  DirectX::CXMVECTOR translation,
-                                  Pbr::NodeIndex_t transformIndex = Pbr::RootNodeIndex,
-                                  RGBAColor vertexColor = RGBA::White);
-        PrimitiveBuilder& AddQuad(DirectX::XMFLOAT2 sideLengths,
-                                  DirectX::XMFLOAT2 textureCoord = {1, 1},
-                                  Pbr::NodeIndex_t transformIndex = Pbr::RootNodeIndex,
-                                  RGBAColor vertexColor = RGBA::White);
-    };
+    } // namespace Internal
 
     namespace Texture {
-        std::array<uint8_t, 4> LoadRGBAUI4(RGBAColor color);
-
         winrt::com_ptr<ID3D11ShaderResourceView> LoadTextureImage(_In_ ID3D11Device* device,
                                                                   _In_reads_bytes_(fileSize) const uint8_t* fileData,
                                                                   uint32_t fileSize);
@@ -100,6 +41,12 @@ namespace Pbr {
                                                                int width,
                                                                int height,
                                                                DXGI_FORMAT format);
+        // Creates a texture with all levels of the mip chain, uploaded at once.
+        winrt::com_ptr<ID3D11ShaderResourceView> CreateTexture(_In_ ID3D11Device* device, const MipChain& mipChain, DXGI_FORMAT format);
+        winrt::com_ptr<ID3D11ShaderResourceView> CreateTexture(_In_ ID3D11Device* device, const CompressedTexture& texture);
+        // Create the textures of prefiltered environments and of the BRDF lookup table, see PbrEnvironment.h.
+        winrt::com_ptr<ID3D11ShaderResourceView> CreateCubeTexture(_In_ ID3D11Device* device, const CubeMapData& cubeMap);
+        winrt::com_ptr<ID3D11ShaderResourceView> CreateBrdfLutTexture(_In_ ID3D11Device* device, const BrdfLutData& brdfLut);
         winrt::com_ptr<ID3D11SamplerState> CreateSampler(_In_ ID3D11Device* device,
                                                          D3D11_TEXTURE_ADDRESS_MODE addressMode = D3D11_TEXTURE_ADDRESS_CLAMP);
     } // namespace Texture
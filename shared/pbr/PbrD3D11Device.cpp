@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#include "pch.h"
+#include "PbrCommon.h"
+#include "PbrD3D11Device.h"
+#include "PbrMaterial.h"
+#include "PbrMipmaps.h"
+#include "PbrModel.h"
+
+using namespace DirectX;
+
+namespace Pbr {
+    namespace {
+        D3D11_TEXTURE_ADDRESS_MODE AddressModeToD3D11(TextureAddressMode addressMode) {
+            switch (addressMode) {
+            case TextureAddressMode::Wrap:
+                return D3D11_TEXTURE_ADDRESS_WRAP;
+            case TextureAddressMode::Mirror:
+                return D3D11_TEXTURE_ADDRESS_MIRROR;
+            default:
+                return D3D11_TEXTURE_ADDRESS_CLAMP;
+            }
+        }
+
+        struct D3D11Texture final : DeviceTexture {
+            explicit D3D11Texture(winrt::com_ptr<ID3D11ShaderResourceView> textureView)
+                : TextureView(std::move(textureView)) {
+            }
+            const winrt::com_ptr<ID3D11ShaderResourceView> TextureView;
+        };
+
+        struct D3D11Sampler final : DeviceSampler {
+            explicit D3D11Sampler(winrt::com_ptr<ID3D11SamplerState> sampler)
+                : Sampler(std::move(sampler)) {
+            }
+            const winrt::com_ptr<ID3D11SamplerState> Sampler;
+        };
+
+        struct D3D11Material final : DeviceMaterial {
+            D3D11Material(std::shared_ptr<Pbr::Material> material, winrt::com_ptr<ID3D11SamplerState> defaultSampler)
+                : Material(std::move(material))
+                , DefaultSampler(std::move(defaultSampler)) {
+            }
+
+            MaterialParameters& Parameters() override {
+                return Material->Parameters();
+            }
+
+            void SetTexture(ShaderSlots::PSMaterial slot,
+                            std::shared_ptr<DeviceTexture> texture,
+                            std::shared_ptr<DeviceSampler> sampler) override {
+                Material->SetTexture(slot,
+                                     texture ? static_cast<const D3D11Texture&>(*texture).TextureView.get() : nullptr,
+                                     sampler ? static_cast<const D3D11Sampler&>(*sampler).Sampler.get() : DefaultSampler.get());
+            }
+
+            void SetDoubleSided(bool doubleSided) override {
+                Material->SetDoubleSided(doubleSided);
+            }
+
+            void SetAlphaBlended(bool alphaBlended) override {
+                Material->SetAlphaBlended(alphaBlended);
+            }
+
+            const std::shared_ptr<Pbr::Material> Material;
+            const winrt::com_ptr<ID3D11SamplerState> DefaultSampler;
+        };
+
+        struct D3D11Model final : DeviceModel {
+            explicit D3D11Model(const Resources& pbrResources)
+                : PbrResources(pbrResources) {
+            }
+
+            NodeIndex_t XM_CALLCONV AddNode(FXMMATRIX transform, NodeIndex_t parentIndex, std::string name) override {
+                return Model.AddNode(transform, parentIndex, std::move(name));
+            }
+
+            void AddPrimitive(const PrimitiveBuilder& primitiveBuilder, std::shared_ptr<DeviceMaterial> material) override {
+                Model.AddPrimitive(Primitive(PbrResources, primitiveBuilder, static_cast<const D3D11Material&>(*material).Material));
+            }
+
+            uint32_t GetNodeCount() const override {
+                return Model.GetNodeCount();
+            }
+
+            Node& GetNode(NodeIndex_t nodeIndex) override {
+                return Model.GetNode(nodeIndex);
+            }
+
+            uint32_t GetPrimitiveCount() const override {
+                return Model.GetPrimitiveCount();
+            }
+
+            const Resources& PbrResources;
+            Pbr::Model Model;
+        };
+
+        class D3D11Device final : public Device {
+        public:
+            D3D11Device(Resources& pbrResources, _In_ ID3D11DeviceContext* context)
+                : m_pbrResources(pbrResources)
+                , m_defaultSampler(Texture::CreateSampler(pbrResources.GetDevice().get())) {
+                m_context.copy_from(context);
+            }
+
+            std::shared_ptr<DeviceTexture> CreateTexture(const uint8_t* rgba, uint32_t width, uint32_t height, bool sRGB) override {
+                MipChainOptions options;
+                options.SRGB = sRGB;
+                const MipChain mipChain = GenerateMipChain(rgba, width, height, options);
+                const DXGI_FORMAT format = sRGB ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+                return std::make_shared<D3D11Texture>(Texture::CreateTexture(m_pbrResources.GetDevice().get(), mipChain, format));
+            }
+
+            std::shared_ptr<DeviceTexture> CreateSolidColorTexture(RGBAColor color) override {
+                return std::make_shared<D3D11Texture>(m_pbrResources.CreateSolidColorTexture(color));
+            }
+
+            std::shared_ptr<DeviceSampler> CreateSampler(TextureAddressMode addressMode) override {
+                return std::make_shared<D3D11Sampler>(
+                    Texture::CreateSampler(m_pbrResources.GetDevice().get(), AddressModeToD3D11(addressMode)));
+            }
+
+            std::shared_ptr<DeviceMaterial>
+            CreateFlatMaterial(RGBAColor baseColorFactor, float roughnessFactor, float metallicFactor, RGBColor emissiveFactor) override {
+                return std::make_shared<D3D11Material>(
+                    Material::CreateFlat(m_pbrResources, baseColorFactor, roughnessFactor, metallicFactor, emissiveFactor),
+                    m_defaultSampler);
+            }
+
+            std::shared_ptr<DeviceModel> CreateModel() override {
+                return std::make_shared<D3D11Model>(m_pbrResources);
+            }
+
+            void SetLight(XMFLOAT3 direction, RGBColor diffuseColor) override {
+                m_pbrResources.SetLight(direction, diffuseColor);
+            }
+
+            void XM_CALLCONV SetViewProjection(FXMMATRIX view, CXMMATRIX projection) override {
+                m_pbrResources.SetViewProjection(view, projection);
+            }
+
+            void SetFrontFaceWindingOrder(FrontFaceWindingOrder windingOrder) override {
+                m_pbrResources.SetFrontFaceWindingOrder(windingOrder);
+            }
+
+            void SetDepthFuncReversed(bool reverseZ) override {
+                m_pbrResources.SetDepthFuncReversed(reverseZ);
+            }
+
+            void XM_CALLCONV Render(const DeviceModel& model, FXMMATRIX modelToWorld) override {
+                m_pbrResources.Bind(m_context.get());
+                m_pbrResources.SetModelToWorld(modelToWorld, m_context.get());
+                static_cast<const D3D11Model&>(model).Model.Render(m_pbrResources, m_context.get());
+            }
+
+        private:
+            Resources& m_pbrResources;
+            winrt::com_ptr<ID3D11DeviceContext> m_context;
+            const winrt::com_ptr<ID3D11SamplerState> m_defaultSampler;
+        };
+    } // namespace
+
+    std::unique_ptr<Device> CreateD3D11Device(Resources& pbrResources, _In_ ID3D11DeviceContext* context) {
+        return std::make_unique<D3D11Device>(pbrResources, context);
+    }
+} // namespace Pbr
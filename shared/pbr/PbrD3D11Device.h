@@ -0,0 +1,15 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#pragma once
+
+#include <memory>
+#include <d3d11.h>
+#include "PbrDevice.h"
+#include "PbrResources.h"
+
+namespace Pbr {
+    // Creates a Pbr::Device rendering with the Direct3D 11 renderer: its materials and models are Pbr::Material and Pbr::Model,
+    // created with the resources and drawn with the context. The resources must outlive the device.
+    std::unique_ptr<Device> CreateD3D11Device(Resources& pbrResources, _In_ ID3D11DeviceContext* context);
+} // namespace Pbr
@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// The interface both renderers of the Pbr library implement: Direct3D 11, see Pbr::CreateD3D11Device, and OpenGL ES 3, see
+// Pbr::Gles::CreateDevice. Code that creates its textures, materials and models through a Device renders them with either
+// graphics API. The features only one renderer has, such as the material atlases, streamed textures and single pass views
+// of Direct3D 11, are reached through the types of that renderer. Only needs the standard library and DirectXMath.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <DirectXMath.h>
+#include "PbrTypes.h"
+
+namespace Pbr {
+    // How texture coordinates outside [0, 1] are read.
+    enum class TextureAddressMode : uint32_t {
+        Clamp,
+        Wrap,
+        Mirror,
+    };
+
+    // The textures, samplers, materials and models of a Device hold objects of its graphics API. They must only be given
+    // to the device that created them, and must be released on the thread owning its context.
+    class DeviceTexture {
+    public:
+        virtual ~DeviceTexture() = default;
+    };
+
+    class DeviceSampler {
+    public:
+        virtual ~DeviceSampler() = default;
+    };
+
+    // The metallic roughness parameters and textures of the primitives of models.
+    class DeviceMaterial {
+    public:
+        virtual ~DeviceMaterial() = default;
+
+        virtual MaterialParameters& Parameters() = 0;
+
+        // Set the texture of a slot, and the sampler it is read with. Without a sampler, the default sampler is used.
+        virtual void SetTexture(ShaderSlots::PSMaterial slot,
+                                std::shared_ptr<DeviceTexture> texture,
+                                std::shared_ptr<DeviceSampler> sampler) = 0;
+
+        virtual void SetDoubleSided(bool doubleSided) = 0;
+        virtual void SetAlphaBlended(bool alphaBlended) = 0;
+    };
+
+    // A model is a collection of primitives (which reference a material) and transforms referenced by the primitives' vertices.
+    class DeviceModel {
+    public:
+        virtual ~DeviceModel() = default;
+
+        // Add a node to the model, whose root node is created with it.
+        virtual NodeIndex_t XM_CALLCONV AddNode(DirectX::FXMMATRIX transform, NodeIndex_t parentIndex, std::string name) = 0;
+
+        // Add a primitive with the geometry of the builder.
+        virtual void AddPrimitive(const PrimitiveBuilder& primitiveBuilder, std::shared_ptr<DeviceMaterial> material) = 0;
+
+        virtual uint32_t GetNodeCount() const = 0;
+        virtual Node& GetNode(NodeIndex_t nodeIndex) = 0;
+        virtual uint32_t GetPrimitiveCount() const = 0;
+    };
+
+    // Creates the resources of models and renders them. Every call must be made on the thread owning the context of the
+    // graphics API.
+    class Device {
+    public:
+        virtual ~Device() = default;
+
+        // Creates a 2D texture from rows of RGBA pixels, the first row at texture coordinate 0, with its full mip chain.
+        virtual std::shared_ptr<DeviceTexture> CreateTexture(const uint8_t* rgba, uint32_t width, uint32_t height, bool sRGB) = 0;
+
+        // Many 1x1 pixel colored textures are used in the PBR system. This is used to create textures backed by a cache to
+        // reduce the number of textures created.
+        virtual std::shared_ptr<DeviceTexture> CreateSolidColorTexture(RGBAColor color) = 0;
+
+        virtual std::shared_ptr<DeviceSampler> CreateSampler(TextureAddressMode addressMode) = 0;
+
+        // Create a flat (no texture) material.
+        virtual std::shared_ptr<DeviceMaterial>
+        CreateFlatMaterial(RGBAColor baseColorFactor, float roughnessFactor, float metallicFactor, RGBColor emissiveFactor) = 0;
+
+        // Create an empty model with a root node.
+        virtual std::shared_ptr<DeviceModel> CreateModel() = 0;
+
+        // Set the directional light.
+        virtual void SetLight(DirectX::XMFLOAT3 direction, RGBColor diffuseColor) = 0;
+
+        // Set the current view and projection matrices, in the conventions of DirectXMath.
+        virtual void XM_CALLCONV SetViewProjection(DirectX::FXMMATRIX view, DirectX::CXMMATRIX projection) = 0;
+
+        virtual void SetFrontFaceWindingOrder(FrontFaceWindingOrder windingOrder) = 0;
+        virtual void SetDepthFuncReversed(bool reverseZ) = 0;
+
+        // Render a model into the bound render target, with the light and view projection set last.
+        virtual void XM_CALLCONV Render(const DeviceModel& model, DirectX::FXMMATRIX modelToWorld) = 0;
+    };
+} // namespace Pbr
@@ -0,0 +1,569 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+// Doesn't use the precompiled header, which includes Windows headers, so that it builds on any platform.
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <DirectXMath/SHMath/DirectXSH.h>
+// Implementation is in the Gltf library so this isn't needed: #define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "PbrEnvironment.h"
+#include "PbrMipmaps.h"
+#include "PbrTaskScheduler.h"
+
+using namespace DirectX;
+
+namespace {
+    constexpr uint32_t FaceCount = 6;
+    constexpr size_t SHOrder = 3;
+
+    // One level of a cube map in linear floating point, with the faces in the D3D order.
+    struct RadianceCube {
+        uint32_t Size{0};
+        std::vector<XMFLOAT4> Texels;
+
+        const XMFLOAT4* Face(uint32_t face) const {
+            return Texels.data() + static_cast<size_t>(face) * Size * Size;
+        }
+    };
+
+    // The direction through the center of a cube map texel, for the face orientations of D3D.
+    XMVECTOR CubeTexelDirection(uint32_t face, uint32_t size, uint32_t x, uint32_t y) {
+        const float u = 2 * (x + 0.5f) / size - 1;
+        const float v = 2 * (y + 0.5f) / size - 1;
+        switch (face) {
+        case 0: return XMVector3Normalize(XMVectorSet(1, -v, -u, 0));
+        case 1: return XMVector3Normalize(XMVectorSet(-1, -v, u, 0));
+        case 2: return XMVector3Normalize(XMVectorSet(u, 1, v, 0));
+        case 3: return XMVector3Normalize(XMVectorSet(u, -1, -v, 0));
+        case 4: return XMVector3Normalize(XMVectorSet(u, -v, 1, 0));
+        default: return XMVector3Normalize(XMVectorSet(-u, -v, -1, 0));
+        }
+    }
+
+    // The solid angle covered by a cube map texel.
+    float CubeTexelSolidAngle(uint32_t size, uint32_t x, uint32_t y) {
+        const float u = 2 * (x + 0.5f) / size - 1;
+        const float v = 2 * (y + 0.5f) / size - 1;
+        const float texelArea = (2.0f / size) * (2.0f / size);
+        return texelArea / std::pow(1 + u * u + v * v, 1.5f);
+    }
+
+    // Finds the cube map face a direction points at, and the position on the face in [0, 1], inverting CubeTexelDirection.
+    uint32_t CubeFaceCoordinates(FXMVECTOR direction, float& s, float& t) {
+        XMFLOAT3 d;
+        XMStoreFloat3(&d, direction);
+        const float ax = std::abs(d.x), ay = std::abs(d.y), az = std::abs(d.z);
+
+        uint32_t face;
+        float u, v;
+        if (ax >= ay && ax >= az) {
+            face = d.x >= 0 ? 0 : 1;
+            u = (d.x >= 0 ? -d.z : d.z) / ax;
+            v = -d.y / ax;
+        } else if (ay >= az) {
+            face = d.y >= 0 ? 2 : 3;
+            u = d.x / ay;
+            v = (d.y >= 0 ? d.z : -d.z) / ay;
+        } else {
+            face = d.z >= 0 ? 4 : 5;
+            u = (d.z >= 0 ? d.x : -d.x) / az;
+            v = -d.y / az;
+        }
+
+        s = u * 0.5f + 0.5f;
+        t = v * 0.5f + 0.5f;
+        return face;
+    }
+
+    // Bilinear filtering of an image at a position in texels. Rows are clamped; columns wrap around when wrapX is set, as
+    // the longitude of equirectangular images does.
+    XMVECTOR SampleBilinear(const XMFLOAT4* texels, uint32_t width, uint32_t height, float x, float y, bool wrapX) {
+        x -= 0.5f;
+        y -= 0.5f;
+        const float floorX = std::floor(x);
+        const float floorY = std::floor(y);
+        const float fractionX = x - floorX;
+        const float fractionY = y - floorY;
+
+        auto column = [&](int32_t column) {
+            if (wrapX) {
+                column %= static_cast<int32_t>(width);
+                return static_cast<uint32_t>(column < 0 ? column + static_cast<int32_t>(width) : column);
+            }
+            return static_cast<uint32_t>(std::clamp(column, 0, static_cast<int32_t>(width) - 1));
+        };
+        auto row = [&](int32_t row) { return static_cast<uint32_t>(std::clamp(row, 0, static_cast<int32_t>(height) - 1)); };
+
+        const uint32_t x0 = column(static_cast<int32_t>(floorX));
+        const uint32_t x1 = column(static_cast<int32_t>(floorX) + 1);
+        const XMFLOAT4* row0 = texels + static_cast<size_t>(row(static_cast<int32_t>(floorY))) * width;
+        const XMFLOAT4* row1 = texels + static_cast<size_t>(row(static_cast<int32_t>(floorY) + 1)) * width;
+
+        const XMVECTOR top = XMVectorLerp(XMLoadFloat4(&row0[x0]), XMLoadFloat4(&row0[x1]), fractionX);
+        const XMVECTOR bottom = XMVectorLerp(XMLoadFloat4(&row1[x0]), XMLoadFloat4(&row1[x1]), fractionX);
+        return XMVectorLerp(top, bottom, fractionY);
+    }
+
+    XMVECTOR SampleCube(const RadianceCube& cube, FXMVECTOR direction) {
+        float s, t;
+        const uint32_t face = CubeFaceCoordinates(direction, s, t);
+        return SampleBilinear(cube.Face(face), cube.Size, cube.Size, s * cube.Size, t * cube.Size, false);
+    }
+
+    // Samples between the two levels of the chain closest to the level of detail.
+    XMVECTOR SampleCubeLevel(const std::vector<RadianceCube>& levels, FXMVECTOR direction, float lod) {
+        lod = std::clamp(lod, 0.0f, static_cast<float>(levels.size() - 1));
+        const uint32_t level = static_cast<uint32_t>(lod);
+        const float fraction = lod - level;
+        const XMVECTOR detailed = SampleCube(levels[level], direction);
+        return fraction > 0 ? XMVectorLerp(detailed, SampleCube(levels[level + 1], direction), fraction) : detailed;
+    }
+
+    XMVECTOR SampleEnvironment(const Pbr::EnvironmentImage& environment, FXMVECTOR direction) {
+        if (environment.Layout == Pbr::EnvironmentLayout::Cube) {
+            float s, t;
+            const uint32_t face = CubeFaceCoordinates(direction, s, t);
+            const XMFLOAT4* faceTexels = environment.Texels.data() + static_cast<size_t>(face) * environment.Width * environment.Height;
+            return SampleBilinear(faceTexels, environment.Width, environment.Height, s * environment.Width, t * environment.Height, false);
+        }
+
+        // Longitude starts at -Z and turns towards +X, latitude goes from +Y at the top row to -Y at the bottom row.
+        XMFLOAT3 d;
+        XMStoreFloat3(&d, direction);
+        const float longitude = std::atan2(d.x, -d.z);
+        const float latitude = std::acos(std::clamp(d.y, -1.0f, 1.0f));
+        const float s = 0.5f + longitude / XM_2PI;
+        const float t = latitude / XM_PI;
+        const float x = s * environment.Width;
+        const float y = t * environment.Height;
+        return SampleBilinear(environment.Texels.data(), environment.Width, environment.Height, x, y, true);
+    }
+
+    // Resamples the environment into a cube map, with 2x2 samples per texel to soften the aliasing of larger sources.
+    RadianceCube ResampleToCube(const Pbr::EnvironmentImage& environment, uint32_t size) {
+        RadianceCube cube;
+        cube.Size = size;
+        cube.Texels.resize(static_cast<size_t>(FaceCount) * size * size);
+        Pbr::Internal::ParallelForBands(FaceCount * size, size * 4, [&](uint32_t beginRow, uint32_t endRow) {
+            for (uint32_t row = beginRow; row < endRow; row++) {
+                const uint32_t face = row / size;
+                const uint32_t y = row % size;
+                for (uint32_t x = 0; x < size; x++) {
+                    XMVECTOR sum = XMVectorZero();
+                    for (uint32_t sample = 0; sample < 4; sample++) {
+                        const XMVECTOR direction =
+                            CubeTexelDirection(face, size * 2, x * 2 + (sample & 1), y * 2 + (sample >> 1));
+                        sum = XMVectorAdd(sum, SampleEnvironment(environment, direction));
+                    }
+                    XMStoreFloat4(&cube.Texels[static_cast<size_t>(row) * size + x], XMVectorScale(sum, 0.25f));
+                }
+            }
+        });
+        return cube;
+    }
+
+    // Averages 2x2 texels of each face into the next smaller level. Odd sizes clamp the last row and column.
+    RadianceCube Downsample(const RadianceCube& source) {
+        RadianceCube cube;
+        cube.Size = std::max(source.Size / 2, 1u);
+        cube.Texels.resize(static_cast<size_t>(FaceCount) * cube.Size * cube.Size);
+        for (uint32_t face = 0; face < FaceCount; face++) {
+            const XMFLOAT4* sourceFace = source.Face(face);
+            XMFLOAT4* destinationFace = cube.Texels.data() + static_cast<size_t>(face) * cube.Size * cube.Size;
+            for (uint32_t y = 0; y < cube.Size; y++) {
+                const XMFLOAT4* row0 = sourceFace + static_cast<size_t>(std::min(y * 2, source.Size - 1)) * source.Size;
+                const XMFLOAT4* row1 = sourceFace + static_cast<size_t>(std::min(y * 2 + 1, source.Size - 1)) * source.Size;
+                for (uint32_t x = 0; x < cube.Size; x++) {
+                    const uint32_t x0 = std::min(x * 2, source.Size - 1);
+                    const uint32_t x1 = std::min(x * 2 + 1, source.Size - 1);
+                    const XMVECTOR sum = XMVectorAdd(XMVectorAdd(XMLoadFloat4(&row0[x0]), XMLoadFloat4(&row0[x1])),
+                                                     XMVectorAdd(XMLoadFloat4(&row1[x0]), XMLoadFloat4(&row1[x1])));
+                    XMStoreFloat4(&destinationFace[static_cast<size_t>(y) * cube.Size + x], XMVectorScale(sum, 0.25f));
+                }
+            }
+        }
+        return cube;
+    }
+
+    // The low-discrepancy Hammersley point set, which covers the hemisphere more evenly than random samples.
+    XMFLOAT2 Hammersley(uint32_t index, uint32_t count) {
+        uint32_t bits = index;
+        bits = (bits << 16) | (bits >> 16);
+        bits = ((bits & 0x55555555u) << 1) | ((bits & 0xAAAAAAAAu) >> 1);
+        bits = ((bits & 0x33333333u) << 2) | ((bits & 0xCCCCCCCCu) >> 2);
+        bits = ((bits & 0x0F0F0F0Fu) << 4) | ((bits & 0xF0F0F0F0u) >> 4);
+        bits = ((bits & 0x00FF00FFu) << 8) | ((bits & 0xFF00FF00u) >> 8);
+        return {static_cast<float>(index) / count, bits * 2.3283064365386963e-10f};
+    }
+
+    // A half vector distributed by the GGX normal distribution around +Z.
+    XMVECTOR ImportanceSampleGgx(XMFLOAT2 xi, float alpha) {
+        const float phi = XM_2PI * xi.x;
+        const float cosTheta = std::sqrt((1 - xi.y) / (1 + (alpha * alpha - 1) * xi.y));
+        const float sinTheta = std::sqrt(1 - cosTheta * cosTheta);
+        return XMVectorSet(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta, 0);
+    }
+
+    // A light direction of the specular prefilter, relative to the normal along +Z.
+    struct SpecularSample {
+        XMFLOAT4A Direction;
+        float Weight; // NdotL
+        float Lod;    // Source level whose texels cover the solid angle of the sample
+    };
+
+    // Under the split-sum approximation the view and reflection directions equal the normal, so the samples are the same for
+    // every texel once rotated around its normal. Each sample reads the level of the source whose texels match the solid
+    // angle it stands for, which removes most of the noise of few samples on a detailed source.
+    std::vector<SpecularSample> SpecularSamples(float perceptualRoughness, uint32_t sampleCount, uint32_t sourceSize) {
+        const float alpha = perceptualRoughness * perceptualRoughness;
+        const float texelSolidAngle = 4 * XM_PI / (FaceCount * static_cast<float>(sourceSize) * sourceSize);
+
+        std::vector<SpecularSample> samples;
+        for (uint32_t i = 0; i < sampleCount; i++) {
+            const XMVECTOR h = ImportanceSampleGgx(Hammersley(i, sampleCount), alpha);
+            const float nDotH = XMVectorGetZ(h);
+            const XMVECTOR l = XMVectorSubtract(XMVectorScale(h, 2 * nDotH), XMVectorSet(0, 0, 1, 0));
+            const float nDotL = XMVectorGetZ(l);
+            if (nDotL <= 0) {
+                continue;
+            }
+
+            // With V = N, the pdf of the light direction is D(h) * NdotH / (4 * VdotH) = D(h) / 4.
+            const float alphaSquared = alpha * alpha;
+            const float denominator = nDotH * nDotH * (alphaSquared - 1) + 1;
+            const float distribution = alphaSquared / (XM_PI * denominator * denominator);
+            const float sampleSolidAngle = 1 / (sampleCount * distribution / 4 + 0.0001f);
+
+            SpecularSample sample;
+            XMStoreFloat4A(&sample.Direction, l);
+            sample.Weight = nDotL;
+            sample.Lod = std::max(0.5f * std::log2(sampleSolidAngle / texelSolidAngle) + 1, 0.0f);
+            samples.push_back(sample);
+        }
+        return samples;
+    }
+
+    void StoreHalf(FXMVECTOR color, PackedVector::XMHALF4* texel) {
+        PackedVector::XMStoreHalf4(texel, XMVectorSelect(g_XMOne, color, g_XMSelect1110));
+    }
+
+    // Filters one level of the specular map from the levels of the source radiance.
+    void PrefilterSpecularLevel(const std::vector<RadianceCube>& source,
+                                const std::vector<SpecularSample>& samples,
+                                Pbr::CubeMapData& specular,
+                                uint32_t level) {
+        const uint32_t size = specular.LevelSize(level);
+        Pbr::Internal::ParallelForBands(FaceCount * size, size * samples.size(), [&](uint32_t beginRow, uint32_t endRow) {
+            for (uint32_t row = beginRow; row < endRow; row++) {
+                const uint32_t face = row / size;
+                const uint32_t y = row % size;
+                PackedVector::XMHALF4* destination = specular.Texels.data() + specular.Offset(face, level) + static_cast<size_t>(y) * size;
+                for (uint32_t x = 0; x < size; x++) {
+                    const XMVECTOR normal = CubeTexelDirection(face, size, x, y);
+                    const XMVECTOR up = std::abs(XMVectorGetZ(normal)) < 0.999f ? g_XMIdentityR2 : g_XMIdentityR0;
+                    const XMVECTOR tangent = XMVector3Normalize(XMVector3Cross(up, normal));
+                    const XMVECTOR bitangent = XMVector3Cross(normal, tangent);
+
+                    XMVECTOR sum = XMVectorZero();
+                    float weightSum = 0;
+                    for (const SpecularSample& sample : samples) {
+                        const XMVECTOR local = XMLoadFloat4A(&sample.Direction);
+                        XMVECTOR direction = XMVectorMultiply(XMVectorSplatX(local), tangent);
+                        direction = XMVectorMultiplyAdd(XMVectorSplatY(local), bitangent, direction);
+                        direction = XMVectorMultiplyAdd(XMVectorSplatZ(local), normal, direction);
+                        sum = XMVectorMultiplyAdd(SampleCubeLevel(source, direction, sample.Lod), XMVectorReplicate(sample.Weight), sum);
+                        weightSum += sample.Weight;
+                    }
+
+                    StoreHalf(weightSum > 0 ? XMVectorScale(sum, 1 / weightSum) : sum, &destination[x]);
+                }
+            }
+        });
+    }
+
+    // Projects the radiance onto spherical harmonics, and convolves it with the clamped cosine lobe of a Lambertian surface.
+    // The convolution scales band l by A(l) / pi, which are 1, 2/3 and 1/4 for the first three bands.
+    std::array<std::array<float, 9>, 3> ProjectDiffuseSH(const RadianceCube& radiance) {
+        std::array<std::array<float, 9>, 3> sh{};
+        float solidAngleSum = 0;
+        std::mutex sumMutex;
+
+        const uint32_t size = radiance.Size;
+        Pbr::Internal::ParallelForBands(FaceCount * size, size * 16, [&](uint32_t beginRow, uint32_t endRow) {
+            std::array<std::array<float, 9>, 3> bandSH{};
+            float bandSolidAngle = 0;
+            for (uint32_t row = beginRow; row < endRow; row++) {
+                const uint32_t face = row / size;
+                const uint32_t y = row % size;
+                for (uint32_t x = 0; x < size; x++) {
+                    float basis[SHOrder * SHOrder];
+                    XMSHEvalDirection(basis, SHOrder, CubeTexelDirection(face, size, x, y));
+
+                    const float solidAngle = CubeTexelSolidAngle(size, x, y);
+                    const XMFLOAT4& texel = radiance.Texels[static_cast<size_t>(row) * size + x];
+                    const float color[3] = {texel.x * solidAngle, texel.y * solidAngle, texel.z * solidAngle};
+                    for (size_t channel = 0; channel < 3; channel++) {
+                        for (size_t i = 0; i < SHOrder * SHOrder; i++) {
+                            bandSH[channel][i] += basis[i] * color[channel];
+                        }
+                    }
+                    bandSolidAngle += solidAngle;
+                }
+            }
+
+            std::lock_guard lock(sumMutex);
+            for (size_t channel = 0; channel < 3; channel++) {
+                XMSHAdd(sh[channel].data(), SHOrder, sh[channel].data(), bandSH[channel].data());
+            }
+            solidAngleSum += bandSolidAngle;
+        });
+
+        // The texel solid angles are approximate, normalize them to cover the sphere exactly.
+        const float normalization = 4 * XM_PI / solidAngleSum;
+        constexpr float BandScales[SHOrder * SHOrder] = {1, 2 / 3.0f, 2 / 3.0f, 2 / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f};
+        for (std::array<float, 9>& channel : sh) {
+            for (size_t i = 0; i < channel.size(); i++) {
+                channel[i] *= normalization * BandScales[i];
+            }
+        }
+        return sh;
+    }
+
+    Pbr::CubeMapData EvaluateDiffuse(const std::array<std::array<float, 9>, 3>& sh, uint32_t size) {
+        Pbr::CubeMapData diffuse;
+        diffuse.Size = size;
+        diffuse.LevelCount = 1;
+        diffuse.Texels.resize(static_cast<size_t>(FaceCount) * size * size);
+        for (uint32_t face = 0; face < FaceCount; face++) {
+            for (uint32_t y = 0; y < size; y++) {
+                for (uint32_t x = 0; x < size; x++) {
+                    float basis[SHOrder * SHOrder];
+                    XMSHEvalDirection(basis, SHOrder, CubeTexelDirection(face, size, x, y));
+                    const XMVECTOR color = XMVectorSet(XMSHDot(SHOrder, basis, sh[0].data()),
+                                                       XMSHDot(SHOrder, basis, sh[1].data()),
+                                                       XMSHDot(SHOrder, basis, sh[2].data()),
+                                                       0);
+
+                    // Order 3 harmonics ring below zero opposite of bright lights.
+                    const size_t texel = diffuse.Offset(face, 0) + static_cast<size_t>(y) * size + x;
+                    StoreHalf(XMVectorMax(color, XMVectorZero()), &diffuse.Texels[texel]);
+                }
+            }
+        }
+        return diffuse;
+    }
+
+    // Smith's geometry term with the k = alpha / 2 remapping for image-based lighting.
+    float GeometrySmith(float nDotV, float nDotL, float alpha) {
+        const float k = alpha / 2;
+        return (nDotV / (nDotV * (1 - k) + k)) * (nDotL / (nDotL * (1 - k) + k));
+    }
+} // namespace
+
+namespace Pbr {
+    EnvironmentImage DecodeEnvironmentImage(_In_reads_bytes_(size) const uint8_t* data, size_t size, EnvironmentLayout layout) {
+        auto freeImageData = [](float* ptr) { ::free(ptr); };
+        using stbi_unique_ptr = std::unique_ptr<float, decltype(freeImageData)>;
+
+        int w, h, c;
+        stbi_unique_ptr rgbaData(stbi_loadf_from_memory(data, static_cast<int>(size), &w, &h, &c, 4), freeImageData);
+        if (!rgbaData) {
+            throw std::runtime_error("Failed to decode environment image data.");
+        }
+        if (layout == EnvironmentLayout::Cube && h != w * static_cast<int>(FaceCount)) {
+            throw std::invalid_argument("A cube environment image must be six times as high as it is wide.");
+        }
+
+        // The faces stacked in the image are already one after the other in memory.
+        EnvironmentImage image;
+        image.Layout = layout;
+        image.Width = static_cast<uint32_t>(w);
+        image.Height = static_cast<uint32_t>(layout == EnvironmentLayout::Cube ? w : h);
+        image.Texels.resize(static_cast<size_t>(w) * h);
+        memcpy(image.Texels.data(), rgbaData.get(), image.Texels.size() * sizeof(XMFLOAT4));
+        return image;
+    }
+
+    size_t CubeMapData::Offset(uint32_t face, uint32_t level) const {
+        size_t faceTexels = 0;
+        size_t levelOffset = 0;
+        for (uint32_t i = 0; i < LevelCount; i++) {
+            if (i == level) {
+                levelOffset = faceTexels;
+            }
+            faceTexels += static_cast<size_t>(LevelSize(i)) * LevelSize(i);
+        }
+        return face * faceTexels + levelOffset;
+    }
+
+    PrefilteredEnvironment PrefilterEnvironment(const EnvironmentImage& environment, const PrefilterOptions& options) {
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        const size_t expectedTexels =
+            static_cast<size_t>(environment.Width) * environment.Height * (environment.Layout == EnvironmentLayout::Cube ? FaceCount : 1);
+        if (environment.Width == 0 || environment.Height == 0 || environment.Texels.size() != expectedTexels) {
+            throw std::invalid_argument("The environment image is empty or its size doesn't match its texels.");
+        }
+        if (options.SpecularSize == 0 || options.SpecularLevelCount == 0 || options.SpecularSampleCount == 0 ||
+            options.DiffuseSize == 0) {
+            throw std::invalid_argument("The prefilter options must not be zero.");
+        }
+
+        // The levels of the source radiance, read by the specular filter according to the footprint of each sample.
+        std::vector<RadianceCube> source;
+        source.push_back(ResampleToCube(environment, options.SpecularSize));
+        while (source.back().Size > 1) {
+            source.push_back(Downsample(source.back()));
+        }
+
+        PrefilteredEnvironment result;
+
+        // Irradiance varies slowly, so a 32x32 level carries all the detail order 3 harmonics can hold.
+        const auto diffuseSource = std::find_if(source.begin(), source.end(), [](const RadianceCube& level) { return level.Size <= 32; });
+        result.DiffuseSH = ProjectDiffuseSH(*diffuseSource);
+        result.Diffuse = EvaluateDiffuse(result.DiffuseSH, options.DiffuseSize);
+
+        CubeMapData& specular = result.Specular;
+        specular.Size = options.SpecularSize;
+        specular.LevelCount = std::min(options.SpecularLevelCount, MipLevelCount(options.SpecularSize, options.SpecularSize));
+        specular.Texels.resize(specular.Offset(FaceCount, 0));
+
+        // The shader reads level perceptualRoughness * levelCount, so level i holds perceptual roughness i / levelCount.
+        // Level 0 is a mirror and copies the source.
+        for (uint32_t face = 0; face < FaceCount; face++) {
+            const XMFLOAT4* sourceFace = source[0].Face(face);
+            PackedVector::XMHALF4* destination = specular.Texels.data() + specular.Offset(face, 0);
+            for (size_t i = 0; i < static_cast<size_t>(specular.Size) * specular.Size; i++) {
+                StoreHalf(XMLoadFloat4(&sourceFace[i]), &destination[i]);
+            }
+        }
+
+        for (uint32_t level = 1; level < specular.LevelCount; level++) {
+            const float perceptualRoughness = static_cast<float>(level) / specular.LevelCount;
+            const std::vector<SpecularSample> samples = SpecularSamples(perceptualRoughness, options.SpecularSampleCount, source[0].Size);
+            PrefilterSpecularLevel(source, samples, specular, level);
+        }
+
+        result.Duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+        return result;
+    }
+
+    BrdfLutData ComputeBrdfLut(uint32_t size, uint32_t sampleCount) {
+        BrdfLutData lut;
+        lut.Size = size;
+        lut.Texels.resize(static_cast<size_t>(size) * size);
+
+        Internal::ParallelForBands(size, static_cast<size_t>(size) * sampleCount / 64, [&](uint32_t beginRow, uint32_t endRow) {
+            for (uint32_t y = beginRow; y < endRow; y++) {
+                const float perceptualRoughness = 1 - (y + 0.5f) / size;
+                const float alpha = perceptualRoughness * perceptualRoughness;
+                for (uint32_t x = 0; x < size; x++) {
+                    const float nDotV = (x + 0.5f) / size;
+                    const XMVECTOR v = XMVectorSet(std::sqrt(1 - nDotV * nDotV), 0, nDotV, 0);
+
+                    float scale = 0;
+                    float bias = 0;
+                    for (uint32_t i = 0; i < sampleCount; i++) {
+                        const XMVECTOR h = ImportanceSampleGgx(Hammersley(i, sampleCount), alpha);
+                        const float vDotH = XMVectorGetX(XMVector3Dot(v, h));
+                        const XMVECTOR l = XMVectorSubtract(XMVectorScale(h, 2 * vDotH), v);
+                        const float nDotL = XMVectorGetZ(l);
+                        if (nDotL <= 0) {
+                            continue;
+                        }
+
+                        const float nDotH = XMVectorGetZ(h);
+                        const float visibility = GeometrySmith(nDotV, nDotL, alpha) * vDotH / (nDotH * nDotV);
+                        const float fresnel = std::pow(1 - vDotH, 5.0f);
+                        scale += (1 - fresnel) * visibility;
+                        bias += fresnel * visibility;
+                    }
+
+                    PackedVector::XMStoreHalf2(&lut.Texels[static_cast<size_t>(y) * size + x],
+                                               XMVectorSet(scale / sampleCount, bias / sampleCount, 0, 0));
+                }
+            }
+        });
+
+        return lut;
+    }
+
+    EnvironmentCache::EnvironmentResult
+    EnvironmentCache::Prefilter(_In_reads_bytes_(size) const uint8_t* imageFile,
+                                size_t size,
+                                EnvironmentLayout layout,
+                                const PrefilterOptions& options) {
+        const EnvironmentKey key{HashImage(imageFile, size),
+                                 layout,
+                                 options.SpecularSize,
+                                 options.SpecularLevelCount,
+                                 options.SpecularSampleCount,
+                                 options.DiffuseSize};
+
+        std::lock_guard lock(m_mutex);
+        EnvironmentResult& result = m_environments[key];
+        if (!result.valid()) {
+            // The worker filters its own copy of the file, so the caller's buffer may go away before it finishes.
+            std::vector<uint8_t> content(imageFile, imageFile + size);
+            result = Internal::Async([content = std::move(content), layout, options] {
+                         const EnvironmentImage environment = DecodeEnvironmentImage(content.data(), content.size(), layout);
+                         return std::shared_ptr<const PrefilteredEnvironment>(
+                             std::make_shared<PrefilteredEnvironment>(PrefilterEnvironment(environment, options)));
+                     }).share();
+        }
+        return result;
+    }
+
+    EnvironmentCache::EnvironmentResult EnvironmentCache::Prefilter(std::string name,
+                                                                    std::function<std::vector<uint8_t>()> readFile,
+                                                                    EnvironmentLayout layout,
+                                                                    const PrefilterOptions& options) {
+        NamedEnvironmentKey key{std::move(name),
+                                layout,
+                                options.SpecularSize,
+                                options.SpecularLevelCount,
+                                options.SpecularSampleCount,
+                                options.DiffuseSize};
+
+        std::lock_guard lock(m_mutex);
+        EnvironmentResult& result = m_namedEnvironments[std::move(key)];
+        if (!result.valid()) {
+            result = Internal::Async([readFile = std::move(readFile), layout, options] {
+                         const std::vector<uint8_t> content = readFile();
+                         const EnvironmentImage environment = DecodeEnvironmentImage(content.data(), content.size(), layout);
+                         return std::shared_ptr<const PrefilteredEnvironment>(
+                             std::make_shared<PrefilteredEnvironment>(PrefilterEnvironment(environment, options)));
+                     }).share();
+        }
+        return result;
+    }
+
+    EnvironmentCache::BrdfLutResult EnvironmentCache::BrdfLut(const PrefilterOptions& options) {
+        std::lock_guard lock(m_mutex);
+        BrdfLutResult& result = m_brdfLuts[std::make_tuple(options.BrdfLutSize, options.BrdfSampleCount)];
+        if (!result.valid()) {
+            result = Internal::Async([size = options.BrdfLutSize, sampleCount = options.BrdfSampleCount] {
+                         return std::shared_ptr<const BrdfLutData>(std::make_shared<BrdfLutData>(ComputeBrdfLut(size, sampleCount)));
+                     }).share();
+        }
+        return result;
+    }
+
+    void EnvironmentCache::Clear() {
+        auto isReady = [](const auto& entry) { return entry.second.wait_for(std::chrono::seconds(0)) == std::future_status::ready; };
+
+        auto eraseReady = [&](auto& results) {
+            for (auto it = results.begin(); it != results.end();) {
+                it = isReady(*it) ? results.erase(it) : std::next(it);
+            }
+        };
+
+        std::lock_guard lock(m_mutex);
+        eraseReady(m_environments);
+        eraseReady(m_namedEnvironments);
+        eraseReady(m_brdfLuts);
+    }
+} // namespace Pbr
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// CPU prefiltering of HDR environments into the image-based lighting (IBL) maps used by the PBR shader. Only the standard
+// library and DirectXMath are used, so this builds on every platform. Pbr::Texture::CreateCubeTexture and
+// CreateBrdfLutTexture in PbrCommon.h create the textures of the results.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <DirectXMath.h>
+#include <DirectXPackedVector.h>
+#include "PbrImage.h"
+
+namespace Pbr {
+    enum class EnvironmentLayout {
+        Equirectangular, // A single image covering all directions, with longitude along x and latitude along y, +Y up.
+        Cube,            // Six square faces one after the other, in the +X, -X, +Y, -Y, +Z, -Z order of D3D cube maps.
+    };
+
+    // Radiance of an environment in linear RGB, with rows tightly packed. Alpha is ignored.
+    struct EnvironmentImage {
+        EnvironmentLayout Layout{EnvironmentLayout::Equirectangular};
+        uint32_t Width{0};  // Width of the image, or of one face
+        uint32_t Height{0}; // Height of the image, or of one face
+        std::vector<DirectX::XMFLOAT4> Texels;
+    };
+
+    // Decodes Radiance HDR (.hdr) file content as an environment of the layout. The six faces of a cube are stacked
+    // vertically in the file, so its image is one face wide and six faces high. 8 bit images are accepted too, and
+    // converted to linear. Throws if the content could not be decoded, or doesn't fit the layout.
+    EnvironmentImage DecodeEnvironmentImage(_In_reads_bytes_(size) const uint8_t* data, size_t size, EnvironmentLayout layout);
+
+    struct PrefilterOptions {
+        uint32_t SpecularSize{256};        // Face size of the most detailed specular level, which is a plain mirror reflection
+        uint32_t SpecularLevelCount{6};    // The shader reads level i for perceptual roughness i / SpecularLevelCount
+        uint32_t SpecularSampleCount{128}; // GGX importance samples per specular texel
+        uint32_t DiffuseSize{32};          // Face size of the diffuse map
+        uint32_t BrdfLutSize{128};
+        uint32_t BrdfSampleCount{512};
+    };
+
+    // The levels of the six faces of a cube map in DXGI_FORMAT_R16G16B16A16_FLOAT. Faces follow each other in the D3D
+    // subresource order, and each face holds its levels from the most detailed one.
+    struct CubeMapData {
+        uint32_t Size{0};
+        uint32_t LevelCount{0};
+        std::vector<DirectX::PackedVector::XMHALF4> Texels;
+
+        uint32_t LevelSize(uint32_t level) const {
+            return std::max(Size >> level, 1u);
+        }
+        size_t Offset(uint32_t face, uint32_t level) const;
+    };
+
+    struct PrefilteredEnvironment {
+        // Irradiance divided by pi, as order 3 spherical harmonics per color channel in the DirectXSH layout. This is the
+        // diffuse light of a white Lambertian surface facing a direction.
+        std::array<std::array<float, 9>, 3> DiffuseSH{};
+        CubeMapData Diffuse; // DiffuseSH evaluated for each texel
+        CubeMapData Specular;
+        std::chrono::microseconds Duration{0};
+    };
+
+    // The split-sum BRDF lookup table in DXGI_FORMAT_R16G16_FLOAT: the scale and bias of the reflectance at normal incidence,
+    // for NdotV along x and 1 - perceptual roughness along y.
+    struct BrdfLutData {
+        uint32_t Size{0};
+        std::vector<DirectX::PackedVector::XMHALF2> Texels;
+    };
+
+    // Filters the environment for the shader on several threads. Both layouts may be of any size; the environment is
+    // resampled to the requested sizes.
+    PrefilteredEnvironment PrefilterEnvironment(const EnvironmentImage& environment, const PrefilterOptions& options = {});
+
+    // Integrates the split-sum BRDF on several threads. It doesn't depend on the environment.
+    BrdfLutData ComputeBrdfLut(uint32_t size, uint32_t sampleCount);
+
+    // Prefiltered environments keyed by the content of their image files and the options, so an environment is filtered
+    // once however often the app switches back to it. Filtering runs on worker threads. The app polls the results and
+    // passes them to Resources::SetEnvironmentMap once ready, which only costs the texture upload on the render thread.
+    class EnvironmentCache {
+    public:
+        using EnvironmentResult = std::shared_future<std::shared_ptr<const PrefilteredEnvironment>>;
+        using BrdfLutResult = std::shared_future<std::shared_ptr<const BrdfLutData>>;
+
+        // Starts decoding and filtering a copy of the image file, or returns the result for identical content and layout.
+        EnvironmentResult Prefilter(_In_reads_bytes_(size) const uint8_t* imageFile,
+                                    size_t size,
+                                    EnvironmentLayout layout,
+                                    const PrefilterOptions& options = {});
+
+        // Starts reading the image file with readFile, then decoding and filtering it, all on a worker thread, so that a
+        // multi-megabyte file never stalls the caller. The content is only known on the worker, so results are shared by
+        // name and layout instead: the name must identify the content, such as the path of the file.
+        EnvironmentResult Prefilter(std::string name,
+                                    std::function<std::vector<uint8_t>()> readFile,
+                                    EnvironmentLayout layout,
+                                    const PrefilterOptions& options = {});
+
+        BrdfLutResult BrdfLut(const PrefilterOptions& options = {});
+
+        // Forgets the finished results, whose data is released once the app doesn't hold them either. Filtering still running
+        // is kept, so that clearing never waits for it.
+        void Clear();
+
+    private:
+        using EnvironmentKey = std::tuple<ImageKey, EnvironmentLayout, uint32_t, uint32_t, uint32_t, uint32_t>;
+        using NamedEnvironmentKey = std::tuple<std::string, EnvironmentLayout, uint32_t, uint32_t, uint32_t, uint32_t>;
+
+        std::mutex m_mutex;
+        std::map<EnvironmentKey, EnvironmentResult> m_environments;
+        std::map<NamedEnvironmentKey, EnvironmentResult> m_namedEnvironments;
+        std::map<std::tuple<uint32_t, uint32_t>, BrdfLutResult> m_brdfLuts;
+    };
+} // namespace Pbr
@@ -0,0 +1,954 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// Doesn't use the precompiled header, which pulls in Direct3D and C++/WinRT.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include "PbrGles.h"
+
+using namespace DirectX;
+
+namespace {
+    // The shaders are ports of PbrVertexShader.hlsl and PbrPixelShader.hlsl. The matrices are uploaded transposed as for
+    // Direct3D, so that the std140 column-major layout reads the same matrices as HLSL, and mul(a, B) becomes a * B.
+    constexpr char VertexShaderSource[] = R"(#version 300 es
+layout(std140) uniform SceneBuffer {
+    mat4 ViewProjection;
+    vec4 EyePosition;
+    vec3 LightDirection;
+    vec3 LightColor;
+    int NumSpecularMipLevels;
+};
+
+layout(std140) uniform ModelBuffer {
+    mat4 ModelToWorld;
+};
+
+// The transforms of the nodes, one per 4 texels, 256 per row. Must match NodesPerTransformsRow.
+uniform highp sampler2D Transforms;
+
+layout(location = 0) in vec4 Position;
+layout(location = 1) in vec3 Normal;
+layout(location = 2) in vec4 Tangent;
+layout(location = 3) in vec4 Color0;
+layout(location = 4) in vec2 TexCoord0;
+layout(location = 5) in uint ModelTransformIndex;
+
+out vec3 PositionWorld;
+out mat3 TBN;
+out vec2 TexCoord;
+out vec4 Color;
+
+void main() {
+    ivec2 texel = ivec2(int(ModelTransformIndex % 256u) * 4, int(ModelTransformIndex / 256u));
+    mat4 nodeTransform = mat4(texelFetch(Transforms, texel, 0),
+                              texelFetch(Transforms, texel + ivec2(1, 0), 0),
+                              texelFetch(Transforms, texel + ivec2(2, 0), 0),
+                              texelFetch(Transforms, texel + ivec2(3, 0), 0));
+
+    mat4 modelTransform = nodeTransform * ModelToWorld;
+    vec4 transformedPosWorld = Position * modelTransform;
+    gl_Position = transformedPosWorld * ViewProjection;
+    PositionWorld = transformedPosWorld.xyz / transformedPosWorld.w;
+
+    vec3 normalW = normalize((vec4(Normal, 0.0) * modelTransform).xyz);
+    vec3 tangentW = normalize((vec4(Tangent.xyz, 0.0) * modelTransform).xyz);
+    vec3 bitangentW = cross(normalW, tangentW) * Tangent.w;
+    TBN = mat3(tangentW, bitangentW, normalW);
+
+    TexCoord = TexCoord0;
+    Color = Color0;
+}
+)";
+
+    constexpr char FragmentShaderSource[] = R"(#version 300 es
+precision highp float;
+
+layout(std140) uniform SceneBuffer {
+    mat4 ViewProjection;
+    vec4 EyePosition;
+    vec3 LightDirection;
+    vec3 LightColor;
+    int NumSpecularMipLevels;
+};
+
+// Must match Pbr::MaterialParameters.
+layout(std140) uniform MaterialBuffer {
+    vec4 BaseColorFactor;
+    float MetallicFactor;
+    float RoughnessFactor;
+    vec3 EmissiveFactor;
+    float EmissivePadding;
+    float NormalScale;
+    float OcclusionStrength;
+    float AlphaCutoff;
+};
+
+uniform sampler2D BaseColorTexture;
+uniform sampler2D MetallicRoughnessTexture; // Green(y)=Roughness, Blue(z)=Metallic
+uniform sampler2D NormalTexture;
+uniform sampler2D OcclusionTexture;         // Red(x) channel
+uniform sampler2D EmissiveTexture;
+uniform sampler2D BRDFTexture;
+uniform samplerCube SpecularTexture;
+uniform samplerCube DiffuseTexture;
+
+in vec3 PositionWorld;
+in mat3 TBN;
+in vec2 TexCoord;
+in vec4 Color;
+
+out vec4 FragColor;
+
+const vec3 f0 = vec3(0.04, 0.04, 0.04);
+const float MinRoughness = 0.04;
+const float PI = 3.141592653589793;
+
+vec3 getIBLContribution(float perceptualRoughness, float NdotV, vec3 diffuseColor, vec3 specularColor, vec3 n, vec3 reflection) {
+    float lod = perceptualRoughness * float(NumSpecularMipLevels);
+
+    vec3 brdf = texture(BRDFTexture, vec2(NdotV, 1.0 - perceptualRoughness)).rgb;
+
+    vec3 diffuseLight = texture(DiffuseTexture, n).rgb;
+    vec3 specularLight = textureLod(SpecularTexture, reflection, lod).rgb;
+
+    vec3 diffuse = diffuseLight * diffuseColor;
+    vec3 specular = specularLight * (specularColor * brdf.x + brdf.y);
+
+    return diffuse + specular;
+}
+
+vec3 diffuse(vec3 diffuseColor) {
+    return diffuseColor / PI;
+}
+
+vec3 specularReflection(vec3 reflectance0, vec3 reflectance90, float VdotH) {
+    return reflectance0 + (reflectance90 - reflectance0) * pow(clamp(1.0 - VdotH, 0.0, 1.0), 5.0);
+}
+
+float geometricOcclusion(float NdotL, float NdotV, float alphaRoughness) {
+    float alphaSq = alphaRoughness * alphaRoughness;
+    float attenuationL = 2.0 * NdotL / (NdotL + sqrt(alphaSq + (1.0 - alphaSq) * (NdotL * NdotL)));
+    float attenuationV = 2.0 * NdotV / (NdotV + sqrt(alphaSq + (1.0 - alphaSq) * (NdotV * NdotV)));
+    return attenuationL * attenuationV;
+}
+
+float microfacetDistribution(float NdotH, float alphaRoughness) {
+    float roughnessSq = alphaRoughness * alphaRoughness;
+    float f = (NdotH * roughnessSq - NdotH) * NdotH + 1.0;
+    return roughnessSq / (PI * f * f);
+}
+
+void main() {
+    vec3 mrSample = texture(MetallicRoughnessTexture, TexCoord).rgb;
+    vec4 baseColor = texture(BaseColorTexture, TexCoord) * Color * BaseColorFactor;
+
+    // Discard if below alpha cutoff.
+    if (baseColor.a < AlphaCutoff) {
+        discard;
+    }
+
+    float metallic = clamp(mrSample.b * MetallicFactor, 0.0, 1.0);
+    float perceptualRoughness = clamp(mrSample.g * RoughnessFactor, MinRoughness, 1.0);
+    float alphaRoughness = perceptualRoughness * perceptualRoughness;
+
+    vec3 diffuseColor = (baseColor.rgb * (vec3(1.0, 1.0, 1.0) - f0)) * (1.0 - metallic);
+    vec3 specularColor = mix(f0, baseColor.rgb, metallic);
+
+    float reflectance = max(max(specularColor.r, specularColor.g), specularColor.b);
+    float reflectance90 = clamp(reflectance * 25.0, 0.0, 1.0);
+    vec3 specularEnvironmentR0 = specularColor.rgb;
+    vec3 specularEnvironmentR90 = vec3(1.0, 1.0, 1.0) * reflectance90;
+
+    // Only x and y are read, and z is reconstructed from them, so two-channel normal maps work too.
+    vec2 nxy = 2.0 * texture(NormalTexture, TexCoord).xy - 1.0;
+    vec3 n = vec3(nxy, sqrt(clamp(1.0 - dot(nxy, nxy), 0.0, 1.0)));
+    n = normalize(TBN * (n * vec3(NormalScale, NormalScale, 1.0)));
+
+    vec3 v = normalize(EyePosition.xyz - PositionWorld);
+    vec3 l = normalize(LightDirection);
+    vec3 h = normalize(l + v);
+    vec3 reflection = -normalize(reflect(v, n));
+
+    float NdotL = clamp(dot(n, l), 0.001, 1.0);
+    float NdotV = abs(dot(n, v)) + 0.001;
+    float NdotH = clamp(dot(n, h), 0.0, 1.0);
+    float VdotH = clamp(dot(v, h), 0.0, 1.0);
+
+    vec3 F = specularReflection(specularEnvironmentR0, specularEnvironmentR90, VdotH);
+    float G = geometricOcclusion(NdotL, NdotV, alphaRoughness);
+    float D = microfacetDistribution(NdotH, alphaRoughness);
+
+    vec3 diffuseContrib = (1.0 - F) * diffuse(diffuseColor);
+    vec3 specContrib = F * G * D / (4.0 * NdotL * NdotV);
+    vec3 color = NdotL * LightColor * (diffuseContrib + specContrib);
+
+    color += getIBLContribution(perceptualRoughness, NdotV, diffuseColor, specularColor, n, reflection);
+
+    float ao = texture(OcclusionTexture, TexCoord).r;
+    color = mix(color, color * ao, OcclusionStrength);
+
+    color += texture(EmissiveTexture, TexCoord).rgb * EmissiveFactor;
+
+    FragColor = vec4(color, baseColor.a);
+}
+)";
+
+    // The sampler uniforms, in the order of their texture units.
+    constexpr const char* SamplerUniformNames[] = {"BaseColorTexture",
+                                                   "MetallicRoughnessTexture",
+                                                   "NormalTexture",
+                                                   "OcclusionTexture",
+                                                   "EmissiveTexture",
+                                                   "BRDFTexture",
+                                                   "SpecularTexture",
+                                                   "DiffuseTexture"};
+    static_assert(std::size(SamplerUniformNames) == Pbr::ShaderSlots::DiffuseTexture + 1);
+
+    // Texture units are shared by the vertex and pixel shaders, so the node transforms take the unit after the IBL textures.
+    constexpr GLuint TransformsTextureUnit = Pbr::ShaderSlots::DiffuseTexture + 1;
+
+    // The transforms texture is 1024 texels wide, the smallest maximum size of OpenGL ES 3.0 being 2048.
+    constexpr uint32_t NodesPerTransformsRow = 256;
+    constexpr uint32_t TexelsPerTransform = 4;
+
+    // Must match SceneBuffer in the shaders, with the std140 layout.
+    struct SceneUniforms {
+        DirectX::XMFLOAT4X4 ViewProjection;
+        DirectX::XMFLOAT4 EyePosition;
+        alignas(16) DirectX::XMFLOAT3 LightDirection{};
+        alignas(16) DirectX::XMFLOAT3 LightDiffuseColor{};
+        int32_t NumSpecularMipLevels{1};
+    };
+    static_assert(offsetof(SceneUniforms, NumSpecularMipLevels) == 108 && sizeof(SceneUniforms) == 112,
+                  "SceneUniforms must match the std140 layout of SceneBuffer");
+
+    struct ModelUniforms {
+        DirectX::XMFLOAT4X4 ModelToWorld;
+    };
+
+    Pbr::Gles::Object CreateBuffer(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+        GLuint name = 0;
+        glGenBuffers(1, &name);
+        Pbr::Gles::Object buffer(Pbr::Gles::Object::Type::Buffer, name);
+        // The copy target is bound, so that creating an index buffer doesn't change the vertex array that is bound.
+        glBindBuffer(target, name);
+        glBufferData(target, size, data, usage);
+        glBindBuffer(target, 0);
+        return buffer;
+    }
+
+    void UpdateBuffer(const Pbr::Gles::Object& buffer, GLsizeiptr size, const void* data) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.Get());
+        glBufferSubData(GL_COPY_WRITE_BUFFER, 0, size, data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    GLuint CompileShader(GLenum type, const char* source) {
+        const GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+
+        GLint compiled = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+        if (compiled == GL_FALSE) {
+            GLint logLength = 0;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+            std::string log(std::max(logLength, 1), '\0');
+            glGetShaderInfoLog(shader, logLength, nullptr, log.data());
+            glDeleteShader(shader);
+            throw std::runtime_error("Shader compilation failed: " + log);
+        }
+        return shader;
+    }
+
+    Pbr::Gles::Object CompileProgram(const char* vertexShaderSource, const char* fragmentShaderSource) {
+        const GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexShaderSource);
+        GLuint fragmentShader = 0;
+        try {
+            fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentShaderSource);
+        } catch (...) {
+            glDeleteShader(vertexShader);
+            throw;
+        }
+
+        Pbr::Gles::Object program(Pbr::Gles::Object::Type::Program, glCreateProgram());
+        glAttachShader(program.Get(), vertexShader);
+        glAttachShader(program.Get(), fragmentShader);
+        glLinkProgram(program.Get());
+
+        // The program keeps the shaders alive while it needs them.
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program.Get(), GL_LINK_STATUS, &linked);
+        if (linked == GL_FALSE) {
+            GLint logLength = 0;
+            glGetProgramiv(program.Get(), GL_INFO_LOG_LENGTH, &logLength);
+            std::string log(std::max(logLength, 1), '\0');
+            glGetProgramInfoLog(program.Get(), logLength, nullptr, log.data());
+            throw std::runtime_error("Program link failed: " + log);
+        }
+        return program;
+    }
+
+    void BindUniformBlock(GLuint program, const char* name, GLuint binding) {
+        const GLuint blockIndex = glGetUniformBlockIndex(program, name);
+        if (blockIndex != GL_INVALID_INDEX) {
+            glUniformBlockBinding(program, blockIndex, binding);
+        }
+    }
+
+    void BindTexture(GLuint unit, GLenum target, const Pbr::Gles::TexturePtr& texture, const Pbr::Gles::SamplerPtr& sampler) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, texture ? texture->Get() : 0);
+        glBindSampler(unit, sampler ? sampler->Get() : 0);
+    }
+
+    uint32_t MipLevelCount(uint32_t width, uint32_t height) {
+        uint32_t levels = 1;
+        for (uint32_t size = std::max(width, height); size > 1; size /= 2) {
+            levels++;
+        }
+        return levels;
+    }
+} // namespace
+
+namespace Pbr::Gles {
+    Object::Object(Type type, GLuint name)
+        : m_type(type)
+        , m_name(name) {
+    }
+
+    Object::Object(Object&& other) noexcept
+        : m_type(other.m_type)
+        , m_name(std::exchange(other.m_name, 0)) {
+    }
+
+    Object& Object::operator=(Object&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            m_type = other.m_type;
+            m_name = std::exchange(other.m_name, 0);
+        }
+        return *this;
+    }
+
+    Object::~Object() {
+        Reset();
+    }
+
+    void Object::Reset() {
+        if (m_name == 0) {
+            return;
+        }
+
+        switch (m_type) {
+        case Type::Buffer:
+            glDeleteBuffers(1, &m_name);
+            break;
+        case Type::Texture:
+            glDeleteTextures(1, &m_name);
+            break;
+        case Type::Sampler:
+            glDeleteSamplers(1, &m_name);
+            break;
+        case Type::VertexArray:
+            glDeleteVertexArrays(1, &m_name);
+            break;
+        case Type::Program:
+            glDeleteProgram(m_name);
+            break;
+        }
+        m_name = 0;
+    }
+
+    namespace Texture {
+        TexturePtr CreateTexture(const uint8_t* rgba, uint32_t width, uint32_t height, GLenum internalFormat, bool generateMips) {
+            GLuint name = 0;
+            glGenTextures(1, &name);
+            auto texture = std::make_shared<Object>(Object::Type::Texture, name);
+
+            const uint32_t levels = generateMips ? MipLevelCount(width, height) : 1;
+            glBindTexture(GL_TEXTURE_2D, name);
+            glTexStorage2D(GL_TEXTURE_2D, levels, internalFormat, width, height);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+            if (levels > 1) {
+                glGenerateMipmap(GL_TEXTURE_2D);
+            }
+            glBindTexture(GL_TEXTURE_2D, 0);
+            return texture;
+        }
+
+        TexturePtr CreateFlatCubeTexture(RGBAColor color, GLenum internalFormat) {
+            const std::array<uint8_t, 4> rgba = Pbr::Texture::LoadRGBAUI4(color);
+
+            GLuint name = 0;
+            glGenTextures(1, &name);
+            auto texture = std::make_shared<Object>(Object::Type::Texture, name);
+
+            glBindTexture(GL_TEXTURE_CUBE_MAP, name);
+            glTexStorage2D(GL_TEXTURE_CUBE_MAP, 1, internalFormat, 1, 1);
+            for (GLenum face = 0; face < 6; face++) {
+                glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+            }
+            glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+            return texture;
+        }
+
+        SamplerPtr CreateSampler(GLenum wrapMode) {
+            GLuint name = 0;
+            glGenSamplers(1, &name);
+            auto sampler = std::make_shared<Object>(Object::Type::Sampler, name);
+
+            // Trilinear, as the default sampler of Direct3D 11.
+            glSamplerParameteri(name, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glSamplerParameteri(name, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glSamplerParameteri(name, GL_TEXTURE_WRAP_S, wrapMode);
+            glSamplerParameteri(name, GL_TEXTURE_WRAP_T, wrapMode);
+            glSamplerParameteri(name, GL_TEXTURE_WRAP_R, wrapMode);
+            return sampler;
+        }
+    } // namespace Texture
+
+    struct Resources::Impl {
+        Object Program;
+        Object SceneBuffer;
+        Object ModelBuffer;
+
+        TexturePtr BrdfLut;
+        TexturePtr SpecularEnvironmentMap;
+        TexturePtr DiffuseEnvironmentMap;
+        SamplerPtr BrdfSampler;
+        SamplerPtr EnvironmentMapSampler;
+        SamplerPtr DefaultSampler;
+        mutable std::map<uint32_t, TexturePtr> SolidColorTextureCache;
+
+        SceneUniforms Scene;
+        FrontFaceWindingOrder WindingOrder{FrontFaceWindingOrder::ClockWise};
+        bool ReverseZ{false};
+    };
+
+    Resources::Resources()
+        : m_impl(std::make_unique<Impl>()) {
+        m_impl->Program = CompileProgram(VertexShaderSource, FragmentShaderSource);
+        const GLuint program = m_impl->Program.Get();
+
+        BindUniformBlock(program, "SceneBuffer", ShaderSlots::ConstantBuffers::Scene);
+        BindUniformBlock(program, "ModelBuffer", ShaderSlots::ConstantBuffers::Model);
+        BindUniformBlock(program, "MaterialBuffer", ShaderSlots::ConstantBuffers::Material);
+
+        glUseProgram(program);
+        for (GLint unit = 0; unit < static_cast<GLint>(std::size(SamplerUniformNames)); unit++) {
+            glUniform1i(glGetUniformLocation(program, SamplerUniformNames[unit]), unit);
+        }
+        glUniform1i(glGetUniformLocation(program, "Transforms"), TransformsTextureUnit);
+        glUseProgram(0);
+
+        m_impl->SceneBuffer = CreateBuffer(GL_COPY_WRITE_BUFFER, sizeof(SceneUniforms), nullptr, GL_DYNAMIC_DRAW);
+        m_impl->ModelBuffer = CreateBuffer(GL_COPY_WRITE_BUFFER, sizeof(ModelUniforms), nullptr, GL_DYNAMIC_DRAW);
+
+        m_impl->BrdfSampler = Texture::CreateSampler(GL_CLAMP_TO_EDGE);
+        m_impl->EnvironmentMapSampler = Texture::CreateSampler(GL_CLAMP_TO_EDGE);
+        m_impl->DefaultSampler = Texture::CreateSampler(GL_CLAMP_TO_EDGE);
+
+        XMStoreFloat4x4(&m_impl->Scene.ViewProjection, XMMatrixIdentity());
+        m_impl->Scene.EyePosition = {0, 0, 0, 1};
+    }
+
+    Resources::Resources(Resources&& resources) noexcept = default;
+
+    Resources::~Resources() = default;
+
+    void Resources::SetBrdfLut(TexturePtr brdfLut) {
+        m_impl->BrdfLut = std::move(brdfLut);
+    }
+
+    void Resources::SetLight(DirectX::XMFLOAT3 direction, RGBColor diffuseColor) {
+        m_impl->Scene.LightDirection = direction;
+        m_impl->Scene.LightDiffuseColor = diffuseColor;
+    }
+
+    void Resources::SetEnvironmentMap(TexturePtr specularEnvironmentMap,
+                                      TexturePtr diffuseEnvironmentMap,
+                                      uint32_t specularMipLevels) {
+        m_impl->SpecularEnvironmentMap = std::move(specularEnvironmentMap);
+        m_impl->DiffuseEnvironmentMap = std::move(diffuseEnvironmentMap);
+        m_impl->Scene.NumSpecularMipLevels = static_cast<int32_t>(specularMipLevels);
+    }
+
+    void XM_CALLCONV Resources::SetViewProjection(DirectX::FXMMATRIX view, DirectX::CXMMATRIX projection) {
+        XMStoreFloat4x4(&m_impl->Scene.ViewProjection, XMMatrixTranspose(XMMatrixMultiply(view, projection)));
+        XMStoreFloat4(&m_impl->Scene.EyePosition, XMMatrixInverse(nullptr, view).r[3]);
+    }
+
+    TexturePtr Resources::CreateSolidColorTexture(RGBAColor color) const {
+        const std::array<uint8_t, 4> rgba = Pbr::Texture::LoadRGBAUI4(color);
+        const uint32_t colorKey = *reinterpret_cast<const uint32_t*>(rgba.data());
+
+        auto textureIt = m_impl->SolidColorTextureCache.find(colorKey);
+        if (textureIt != m_impl->SolidColorTextureCache.end()) {
+            return textureIt->second;
+        }
+
+        TexturePtr texture = Texture::CreateTexture(rgba.data(), 1, 1, GL_RGBA8, false);
+        return m_impl->SolidColorTextureCache.emplace(colorKey, std::move(texture)).first->second;
+    }
+
+    const SamplerPtr& Resources::DefaultSampler() const {
+        return m_impl->DefaultSampler;
+    }
+
+    void Resources::Bind() const {
+        glUseProgram(m_impl->Program.Get());
+
+        UpdateBuffer(m_impl->SceneBuffer, sizeof(SceneUniforms), &m_impl->Scene);
+        glBindBufferBase(GL_UNIFORM_BUFFER, ShaderSlots::ConstantBuffers::Scene, m_impl->SceneBuffer.Get());
+        glBindBufferBase(GL_UNIFORM_BUFFER, ShaderSlots::ConstantBuffers::Model, m_impl->ModelBuffer.Get());
+
+        BindTexture(ShaderSlots::Brdf, GL_TEXTURE_2D, m_impl->BrdfLut, m_impl->BrdfSampler);
+        BindTexture(ShaderSlots::SpecularTexture, GL_TEXTURE_CUBE_MAP, m_impl->SpecularEnvironmentMap, m_impl->EnvironmentMapSampler);
+        BindTexture(ShaderSlots::DiffuseTexture, GL_TEXTURE_CUBE_MAP, m_impl->DiffuseEnvironmentMap, m_impl->EnvironmentMapSampler);
+
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(m_impl->ReverseZ ? GL_GREATER : GL_LESS);
+        glFrontFace(m_impl->WindingOrder == FrontFaceWindingOrder::ClockWise ? GL_CW : GL_CCW);
+        glCullFace(GL_BACK);
+    }
+
+    void XM_CALLCONV Resources::SetModelToWorld(DirectX::FXMMATRIX modelToWorld) const {
+        ModelUniforms model;
+        XMStoreFloat4x4(&model.ModelToWorld, XMMatrixTranspose(modelToWorld));
+        UpdateBuffer(m_impl->ModelBuffer, sizeof(model), &model);
+    }
+
+    void Resources::SetFrontFaceWindingOrder(FrontFaceWindingOrder windingOrder) {
+        m_impl->WindingOrder = windingOrder;
+    }
+
+    FrontFaceWindingOrder Resources::GetFrontFaceWindingOrder() const {
+        return m_impl->WindingOrder;
+    }
+
+    void Resources::SetDepthFuncReversed(bool reverseZ) {
+        m_impl->ReverseZ = reverseZ;
+    }
+
+    bool Resources::GetDepthFuncReversed() const {
+        return m_impl->ReverseZ;
+    }
+
+    void Resources::SetRenderState(bool alphaBlended, bool doubleSided) const {
+        if (alphaBlended) {
+            glEnable(GL_BLEND);
+            glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+        } else {
+            glDisable(GL_BLEND);
+        }
+        // Blended materials are drawn without writing depth, as in the Direct3D renderer.
+        glDepthMask(alphaBlended ? GL_FALSE : GL_TRUE);
+
+        if (doubleSided) {
+            glDisable(GL_CULL_FACE);
+        } else {
+            glEnable(GL_CULL_FACE);
+        }
+    }
+
+    Material::Material()
+        : m_uniformBuffer(CreateBuffer(GL_COPY_WRITE_BUFFER, sizeof(MaterialParameters), nullptr, GL_DYNAMIC_DRAW)) {
+    }
+
+    std::shared_ptr<Material> Material::Clone() const {
+        auto clone = std::make_shared<Material>();
+        clone->Name = Name;
+        clone->Hidden = Hidden;
+        clone->m_parameters = m_parameters;
+        clone->m_alphaBlended = m_alphaBlended;
+        clone->m_doubleSided = m_doubleSided;
+        clone->m_textures = m_textures;
+        clone->m_samplers = m_samplers;
+        return clone;
+    }
+
+    std::shared_ptr<Material> Material::CreateFlat(const Resources& pbrResources,
+                                                   RGBAColor baseColorFactor,
+                                                   float roughnessFactor /* = 1.0f */,
+                                                   float metallicFactor /* = 0.0f */,
+                                                   RGBColor emissiveFactor /* = XMFLOAT3(0, 0, 0) */) {
+        auto material = std::make_shared<Material>();
+
+        if (baseColorFactor.w < 1.0f) { // Alpha channel
+            material->SetAlphaBlended(true);
+        }
+
+        MaterialParameters& parameters = material->Parameters();
+        parameters.BaseColorFactor = baseColorFactor;
+        parameters.EmissiveFactor = emissiveFactor;
+        parameters.MetallicFactor = metallicFactor;
+        parameters.RoughnessFactor = roughnessFactor;
+
+        const SamplerPtr& defaultSampler = pbrResources.DefaultSampler();
+        material->SetTexture(ShaderSlots::BaseColor, pbrResources.CreateSolidColorTexture(RGBA::White), defaultSampler);
+        material->SetTexture(ShaderSlots::MetallicRoughness, pbrResources.CreateSolidColorTexture(RGBA::White), defaultSampler);
+        // No occlusion.
+        material->SetTexture(ShaderSlots::Occlusion, pbrResources.CreateSolidColorTexture(RGBA::White), defaultSampler);
+        // Flat normal.
+        material->SetTexture(ShaderSlots::Normal, pbrResources.CreateSolidColorTexture(RGBA::FlatNormal), defaultSampler);
+        material->SetTexture(ShaderSlots::Emissive, pbrResources.CreateSolidColorTexture(RGBA::White), defaultSampler);
+
+        return material;
+    }
+
+    void Material::SetTexture(ShaderSlots::PSMaterial slot, TexturePtr texture, SamplerPtr sampler) {
+        m_textures[slot] = std::move(texture);
+        m_samplers[slot] = std::move(sampler);
+    }
+
+    void Material::SetDoubleSided(bool doubleSided) {
+        m_doubleSided = doubleSided;
+    }
+
+    void Material::SetAlphaBlended(bool alphaBlended) {
+        m_alphaBlended = alphaBlended;
+    }
+
+    void Material::Bind(const Resources& pbrResources) const {
+        if (m_parametersChanged) {
+            UpdateBuffer(m_uniformBuffer, sizeof(m_parameters), &m_parameters);
+            m_parametersChanged = false;
+        }
+        glBindBufferBase(GL_UNIFORM_BUFFER, ShaderSlots::ConstantBuffers::Material, m_uniformBuffer.Get());
+
+        pbrResources.SetRenderState(m_alphaBlended, m_doubleSided);
+
+        for (GLuint slot = 0; slot < TextureCount; slot++) {
+            BindTexture(slot, GL_TEXTURE_2D, m_textures[slot], m_samplers[slot] ? m_samplers[slot] : pbrResources.DefaultSampler());
+        }
+    }
+
+    MaterialParameters& Material::Parameters() {
+        m_parametersChanged = true;
+        return m_parameters;
+    }
+
+    const MaterialParameters& Material::Parameters() const {
+        return m_parameters;
+    }
+
+    namespace {
+        std::shared_ptr<Object> CreateVertexArray(const Object& vertexBuffer, const Object& indexBuffer) {
+            GLuint name = 0;
+            glGenVertexArrays(1, &name);
+            auto vertexArray = std::make_shared<Object>(Object::Type::VertexArray, name);
+
+            glBindVertexArray(name);
+            glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer.Get());
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer.Get());
+
+            // The locations of the attributes in the vertex shader.
+            constexpr GLsizei stride = sizeof(Vertex);
+            const auto offset = [](size_t memberOffset) { return reinterpret_cast<const void*>(memberOffset); };
+            for (GLuint location = 0; location <= 5; location++) {
+                glEnableVertexAttribArray(location);
+            }
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, offset(offsetof(Vertex, Position)));
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, offset(offsetof(Vertex, Normal)));
+            glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, offset(offsetof(Vertex, Tangent)));
+            glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, offset(offsetof(Vertex, Color0)));
+            glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, stride, offset(offsetof(Vertex, TexCoord0)));
+            static_assert(sizeof(NodeIndex_t) == sizeof(GLushort));
+            glVertexAttribIPointer(5, 1, GL_UNSIGNED_SHORT, stride, offset(offsetof(Vertex, ModelTransformIndex)));
+
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            return vertexArray;
+        }
+    } // namespace
+
+    Primitive::Primitive(const PrimitiveBuilder& primitiveBuilder, std::shared_ptr<Material> material)
+        : m_indexCount(static_cast<uint32_t>(primitiveBuilder.Indices.size()))
+        , m_vertexBuffer(std::make_shared<Object>(CreateBuffer(GL_COPY_WRITE_BUFFER,
+                                                               primitiveBuilder.Vertices.size() * sizeof(Vertex),
+                                                               primitiveBuilder.Vertices.data(),
+                                                               GL_STATIC_DRAW)))
+        , m_indexBuffer(std::make_shared<Object>(CreateBuffer(GL_COPY_WRITE_BUFFER,
+                                                              primitiveBuilder.Indices.size() * sizeof(uint32_t),
+                                                              primitiveBuilder.Indices.data(),
+                                                              GL_STATIC_DRAW)))
+        , m_vertexArray(CreateVertexArray(*m_vertexBuffer, *m_indexBuffer))
+        , m_material(std::move(material)) {
+    }
+
+    Primitive::Primitive(uint32_t vertexCapacity, uint32_t indexCapacity, std::shared_ptr<Material> material)
+        : m_vertexCapacity(vertexCapacity)
+        , m_indexCapacity(indexCapacity)
+        , m_vertexBuffer(std::make_shared<Object>(
+              CreateBuffer(GL_COPY_WRITE_BUFFER, vertexCapacity * sizeof(Vertex), nullptr, GL_STREAM_DRAW)))
+        , m_indexBuffer(std::make_shared<Object>(
+              CreateBuffer(GL_COPY_WRITE_BUFFER, indexCapacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW)))
+        , m_vertexArray(CreateVertexArray(*m_vertexBuffer, *m_indexBuffer))
+        , m_material(std::move(material)) {
+    }
+
+    void Primitive::UpdateVertices(const Vertex* vertices, uint32_t vertexCount) {
+        if (vertexCount > m_vertexCapacity) {
+            throw std::out_of_range("Vertex count exceeds the capacity of the streaming primitive");
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_vertexBuffer->Get());
+        glBufferData(GL_COPY_WRITE_BUFFER, m_vertexCapacity * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, 0, vertexCount * sizeof(Vertex), vertices);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    void Primitive::UpdateIndices(const uint32_t* indices, uint32_t indexCount) {
+        if (indexCount > m_indexCapacity) {
+            throw std::out_of_range("Index count exceeds the capacity of the streaming primitive");
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_indexBuffer->Get());
+        glBufferData(GL_COPY_WRITE_BUFFER, m_indexCapacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, 0, indexCount * sizeof(uint32_t), indices);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        m_indexCount = indexCount;
+    }
+
+    void Primitive::Render() const {
+        glBindVertexArray(m_vertexArray->Get());
+        glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, nullptr);
+    }
+
+    Model::Model(bool createRootNode /*= true*/) {
+        if (createRootNode) {
+            AddNode(XMMatrixIdentity(), NodeIndex_npos, "root");
+        }
+    }
+
+    NodeIndex_t XM_CALLCONV Model::AddNode(FXMMATRIX transform, NodeIndex_t parentIndex, std::string name) {
+        const auto newNodeIndex = static_cast<NodeIndex_t>(m_nodes.size());
+        if (newNodeIndex != RootNodeIndex && parentIndex == NodeIndex_npos) {
+            throw std::invalid_argument("Only the first node can be the root");
+        }
+
+        m_nodes.emplace_back(transform, std::move(name), newNodeIndex, parentIndex);
+        return m_nodes.back().Index;
+    }
+
+    void Model::AddPrimitive(Primitive primitive) {
+        m_primitives.push_back(std::move(primitive));
+    }
+
+    void Model::Clear() {
+        m_primitives.clear();
+        m_nodes.clear();
+    }
+
+    void Model::Render(const Resources& pbrResources) const {
+        if (m_nodes.empty()) {
+            return;
+        }
+
+        glActiveTexture(GL_TEXTURE0 + TransformsTextureUnit);
+        UpdateTransforms();
+        glBindTexture(GL_TEXTURE_2D, m_transformsTexture.Get());
+        glBindSampler(TransformsTextureUnit, 0);
+
+        for (const Primitive& primitive : m_primitives) {
+            if (primitive.GetMaterial()->Hidden) {
+                continue;
+            }
+
+            primitive.GetMaterial()->Bind(pbrResources);
+            primitive.Render();
+        }
+        glBindVertexArray(0);
+    }
+
+    void Model::UpdateTransforms() const {
+        if (!m_modelTransforms.Update(m_nodes)) {
+            return;
+        }
+
+        const uint32_t nodeCount = static_cast<uint32_t>(m_nodes.size());
+        const uint32_t rows = (nodeCount + NodesPerTransformsRow - 1) / NodesPerTransformsRow;
+        const GLsizei width = NodesPerTransformsRow * TexelsPerTransform;
+
+        // The texture grows by whole rows as nodes are added, and is reused while they only move.
+        if (rows > m_transformsTextureRows) {
+            GLuint name = 0;
+            glGenTextures(1, &name);
+            m_transformsTexture = Object(Object::Type::Texture, name);
+            m_transformsTextureRows = rows;
+
+            glBindTexture(GL_TEXTURE_2D, name);
+            glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA32F, width, rows);
+            // Float textures can't be filtered in OpenGL ES 3.0, and texelFetch needs a complete texture.
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        } else {
+            glBindTexture(GL_TEXTURE_2D, m_transformsTexture.Get());
+        }
+
+        // The transforms of a row are consecutive, so the full rows are uploaded at once, then the rest of the last row.
+        const float* transforms = &m_modelTransforms.Transforms().front()._11;
+        const uint32_t fullRows = nodeCount / NodesPerTransformsRow;
+        if (fullRows > 0) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, fullRows, GL_RGBA, GL_FLOAT, transforms);
+        }
+        const uint32_t remainingNodes = nodeCount % NodesPerTransformsRow;
+        if (remainingNodes > 0) {
+            glTexSubImage2D(GL_TEXTURE_2D,
+                            0,
+                            0,
+                            fullRows,
+                            remainingNodes * TexelsPerTransform,
+                            1,
+                            GL_RGBA,
+                            GL_FLOAT,
+                            transforms + static_cast<size_t>(fullRows) * NodesPerTransformsRow * 16);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    namespace {
+        GLenum AddressModeToGl(TextureAddressMode addressMode) {
+            switch (addressMode) {
+            case TextureAddressMode::Wrap:
+                return GL_REPEAT;
+            case TextureAddressMode::Mirror:
+                return GL_MIRRORED_REPEAT;
+            default:
+                return GL_CLAMP_TO_EDGE;
+            }
+        }
+
+        struct DeviceTexture final : Pbr::DeviceTexture {
+            explicit DeviceTexture(TexturePtr texture)
+                : Texture(std::move(texture)) {
+            }
+            const TexturePtr Texture;
+        };
+
+        struct DeviceSampler final : Pbr::DeviceSampler {
+            explicit DeviceSampler(SamplerPtr sampler)
+                : Sampler(std::move(sampler)) {
+            }
+            const SamplerPtr Sampler;
+        };
+
+        struct DeviceMaterial final : Pbr::DeviceMaterial {
+            explicit DeviceMaterial(std::shared_ptr<Gles::Material> material)
+                : Material(std::move(material)) {
+            }
+
+            MaterialParameters& Parameters() override {
+                return Material->Parameters();
+            }
+
+            void SetTexture(ShaderSlots::PSMaterial slot,
+                            std::shared_ptr<Pbr::DeviceTexture> texture,
+                            std::shared_ptr<Pbr::DeviceSampler> sampler) override {
+                Material->SetTexture(slot,
+                                     texture ? static_cast<const DeviceTexture&>(*texture).Texture : nullptr,
+                                     sampler ? static_cast<const DeviceSampler&>(*sampler).Sampler : nullptr);
+            }
+
+            void SetDoubleSided(bool doubleSided) override {
+                Material->SetDoubleSided(doubleSided);
+            }
+
+            void SetAlphaBlended(bool alphaBlended) override {
+                Material->SetAlphaBlended(alphaBlended);
+            }
+
+            const std::shared_ptr<Gles::Material> Material;
+        };
+
+        struct DeviceModel final : Pbr::DeviceModel {
+            NodeIndex_t XM_CALLCONV AddNode(FXMMATRIX transform, NodeIndex_t parentIndex, std::string name) override {
+                return Model.AddNode(transform, parentIndex, std::move(name));
+            }
+
+            void AddPrimitive(const PrimitiveBuilder& primitiveBuilder, std::shared_ptr<Pbr::DeviceMaterial> material) override {
+                Model.AddPrimitive(Primitive(primitiveBuilder, static_cast<const DeviceMaterial&>(*material).Material));
+            }
+
+            uint32_t GetNodeCount() const override {
+                return Model.GetNodeCount();
+            }
+
+            Node& GetNode(NodeIndex_t nodeIndex) override {
+                return Model.GetNode(nodeIndex);
+            }
+
+            uint32_t GetPrimitiveCount() const override {
+                return Model.GetPrimitiveCount();
+            }
+
+            Gles::Model Model;
+        };
+
+        class Device final : public Pbr::Device {
+        public:
+            std::shared_ptr<Pbr::DeviceTexture> CreateTexture(const uint8_t* rgba, uint32_t width, uint32_t height, bool sRGB) override {
+                return std::make_shared<DeviceTexture>(Texture::CreateTexture(rgba, width, height, sRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8));
+            }
+
+            std::shared_ptr<Pbr::DeviceTexture> CreateSolidColorTexture(RGBAColor color) override {
+                return std::make_shared<DeviceTexture>(m_resources.CreateSolidColorTexture(color));
+            }
+
+            std::shared_ptr<Pbr::DeviceSampler> CreateSampler(TextureAddressMode addressMode) override {
+                return std::make_shared<DeviceSampler>(Texture::CreateSampler(AddressModeToGl(addressMode)));
+            }
+
+            std::shared_ptr<Pbr::DeviceMaterial>
+            CreateFlatMaterial(RGBAColor baseColorFactor, float roughnessFactor, float metallicFactor, RGBColor emissiveFactor) override {
+                return std::make_shared<DeviceMaterial>(
+                    Material::CreateFlat(m_resources, baseColorFactor, roughnessFactor, metallicFactor, emissiveFactor));
+            }
+
+            std::shared_ptr<Pbr::DeviceModel> CreateModel() override {
+                return std::make_shared<DeviceModel>();
+            }
+
+            void SetLight(XMFLOAT3 direction, RGBColor diffuseColor) override {
+                m_resources.SetLight(direction, diffuseColor);
+            }
+
+            void XM_CALLCONV SetViewProjection(FXMMATRIX view, CXMMATRIX projection) override {
+                m_resources.SetViewProjection(view, projection);
+            }
+
+            void SetFrontFaceWindingOrder(FrontFaceWindingOrder windingOrder) override {
+                m_resources.SetFrontFaceWindingOrder(windingOrder);
+            }
+
+            void SetDepthFuncReversed(bool reverseZ) override {
+                m_resources.SetDepthFuncReversed(reverseZ);
+            }
+
+            void XM_CALLCONV Render(const Pbr::DeviceModel& model, FXMMATRIX modelToWorld) override {
+                m_resources.Bind();
+                m_resources.SetModelToWorld(modelToWorld);
+                static_cast<const DeviceModel&>(model).Model.Render(m_resources);
+            }
+
+        private:
+            Resources m_resources;
+        };
+    } // namespace
+
+    std::unique_ptr<Pbr::Device> CreateDevice() {
+        return std::make_unique<Device>();
+    }
+} // namespace Pbr::Gles
@@ -0,0 +1,258 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// An OpenGL ES 3.0 renderer of Pbr models, next to the Direct3D 11 renderer of PbrResources.h, PbrMaterial.h, PbrPrimitive.h
+// and PbrModel.h. Both implement Pbr::Device, see CreateDevice, so code written against PbrDevice.h renders with either. It
+// shares their vertices, material parameters, node hierarchy and shading: the HLSL shaders are ported to GLSL ES 3.00, and
+// the structured buffer of node transforms is replaced by a float texture, since OpenGL ES 3.0 has no shader storage buffers.
+// It only needs the standard library, DirectXMath and the OpenGL ES 3 headers, so it builds with ANGLE on Windows as well as
+// with any OpenGL ES driver on other platforms.
+//
+// Not ported: rendering several views in one pass, the highlight shading, the wireframe fill mode (which OpenGL ES lacks),
+// material atlases and streamed textures. Every call must be made on the thread the GL context is current on.
+//
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <GLES3/gl3.h>
+#include "PbrDevice.h"
+#include "PbrTypes.h"
+
+namespace Pbr::Gles {
+    // Owns the name of an OpenGL object, and deletes it when destroyed. The context that created it must be current then.
+    class Object {
+    public:
+        enum class Type { Buffer, Texture, Sampler, VertexArray, Program };
+
+        Object() = default;
+        Object(Type type, GLuint name);
+        Object(Object&& other) noexcept;
+        Object& operator=(Object&& other) noexcept;
+        ~Object();
+
+        Object(const Object&) = delete;
+        Object& operator=(const Object&) = delete;
+
+        GLuint Get() const {
+            return m_name;
+        }
+
+    private:
+        void Reset();
+
+        Type m_type{Type::Buffer};
+        GLuint m_name{0};
+    };
+
+    // Textures and samplers are shared by the materials using them.
+    using TexturePtr = std::shared_ptr<const Object>;
+    using SamplerPtr = std::shared_ptr<const Object>;
+
+    namespace Texture {
+        // Creates a 2D texture from rows of RGBA pixels, the first row at texture coordinate 0 as in Direct3D. The mip chain is
+        // generated unless only one level is asked for.
+        TexturePtr CreateTexture(const uint8_t* rgba, uint32_t width, uint32_t height, GLenum internalFormat = GL_RGBA8,
+                                 bool generateMips = true);
+        TexturePtr CreateFlatCubeTexture(RGBAColor color, GLenum internalFormat = GL_RGBA8);
+        SamplerPtr CreateSampler(GLenum wrapMode = GL_CLAMP_TO_EDGE);
+    } // namespace Texture
+
+    // Global PBR resources required for rendering a scene: the shader program, the scene and model uniforms, and the image
+    // based lighting textures.
+    struct Resources final {
+        // Compiles the shaders in the current context. Throws if they don't compile or link.
+        Resources();
+        Resources(Resources&&) noexcept;
+        ~Resources();
+
+        // Sets the Bidirectional Reflectance Distribution Function Lookup Table texture, required by the shader to compute surface
+        // reflectance from the IBL.
+        void SetBrdfLut(TexturePtr brdfLut);
+
+        // Set the directional light.
+        void SetLight(DirectX::XMFLOAT3 direction, RGBColor diffuseColor);
+
+        // Set the specular and diffuse image-based lighting (IBL) maps. OpenGL ES 3.0 can't query the number of levels of a
+        // texture, so it is passed along.
+        void SetEnvironmentMap(TexturePtr specularEnvironmentMap, TexturePtr diffuseEnvironmentMap, uint32_t specularMipLevels);
+
+        // Set the current view and projection matrices, in the conventions of DirectXMath.
+        void XM_CALLCONV SetViewProjection(DirectX::FXMMATRIX view, DirectX::CXMMATRIX projection);
+
+        // Many 1x1 pixel colored textures are used in the PBR system. This is used to create textures backed by a cache to
+        // reduce the number of textures created.
+        TexturePtr CreateSolidColorTexture(RGBAColor color) const;
+
+        // The sampler materials use when none is given.
+        const SamplerPtr& DefaultSampler() const;
+
+        // Bind the program, the uniforms and the IBL textures, and set the render state shared by all the models.
+        void Bind() const;
+
+        // Set and update the model to world transform.
+        void XM_CALLCONV SetModelToWorld(DirectX::FXMMATRIX modelToWorld) const;
+
+        // Set or get the front face winding order. Direct3D's default of clockwise is kept, so that the same models and
+        // projections render the same.
+        void SetFrontFaceWindingOrder(FrontFaceWindingOrder windingOrder);
+        FrontFaceWindingOrder GetFrontFaceWindingOrder() const;
+
+        // Set or get whether the depth buffer is reversed, with the near plane at 1.
+        void SetDepthFuncReversed(bool reverseZ);
+        bool GetDepthFuncReversed() const;
+
+    private:
+        friend struct Material;
+        void SetRenderState(bool alphaBlended, bool doubleSided) const;
+
+        struct Impl;
+        std::unique_ptr<Impl> m_impl;
+    };
+
+    // A Material contains the metallic roughness parameters and textures.
+    // Primitives specify which Material to use when being rendered.
+    struct Material final {
+        Material();
+
+        // Create a clone of this material, with its own uniform buffer.
+        std::shared_ptr<Material> Clone() const;
+
+        // Create a flat (no texture) material.
+        static std::shared_ptr<Material> CreateFlat(const Resources& pbrResources,
+                                                    RGBAColor baseColorFactor,
+                                                    float roughnessFactor = 1.0f,
+                                                    float metallicFactor = 0.0f,
+                                                    RGBColor emissiveFactor = RGB::Black);
+
+        // Set the texture of a slot, and the sampler it is read with. Without a sampler, the default sampler is used.
+        void SetTexture(ShaderSlots::PSMaterial slot, TexturePtr texture, SamplerPtr sampler = nullptr);
+
+        void SetDoubleSided(bool doubleSided);
+        void SetAlphaBlended(bool alphaBlended);
+
+        bool IsDoubleSided() const {
+            return m_doubleSided;
+        }
+        bool IsAlphaBlended() const {
+            return m_alphaBlended;
+        }
+
+        // Bind this material to the current context.
+        void Bind(const Resources& pbrResources) const;
+
+        MaterialParameters& Parameters();
+        const MaterialParameters& Parameters() const;
+
+        std::string Name;
+        bool Hidden{false};
+
+    private:
+        mutable bool m_parametersChanged{true};
+        MaterialParameters m_parameters;
+
+        bool m_alphaBlended{false};
+        bool m_doubleSided{false};
+
+        static constexpr size_t TextureCount = ShaderSlots::LastMaterialSlot + 1;
+        std::array<TexturePtr, TextureCount> m_textures;
+        std::array<SamplerPtr, TextureCount> m_samplers;
+        Object m_uniformBuffer;
+    };
+
+    // A primitive holds a vertex array with its vertex and index buffers, and a pointer to a PBR material.
+    struct Primitive final {
+        using Collection = std::vector<Primitive>;
+
+        Primitive(const PrimitiveBuilder& primitiveBuilder, std::shared_ptr<Material> material);
+
+        // Creates a primitive with empty buffers for geometry that changes every frame, streamed with UpdateVertices and
+        // UpdateIndices.
+        Primitive(uint32_t vertexCapacity, uint32_t indexCapacity, std::shared_ptr<Material> material);
+
+        // Uploads the vertices of a streaming primitive. The count must not exceed the vertex capacity. The buffer is orphaned
+        // first, so that the driver gives it new storage instead of waiting for the draws of the previous frame.
+        void UpdateVertices(const Vertex* vertices, uint32_t vertexCount);
+
+        // Uploads the indices of a streaming primitive. Only needed when the topology changes.
+        void UpdateIndices(const uint32_t* indices, uint32_t indexCount);
+
+        std::shared_ptr<Material>& GetMaterial() {
+            return m_material;
+        }
+        const std::shared_ptr<Material>& GetMaterial() const {
+            return m_material;
+        }
+
+    private:
+        friend struct Model;
+        void Render() const;
+
+        uint32_t m_indexCount{0};
+        uint32_t m_vertexCapacity{0};
+        uint32_t m_indexCapacity{0};
+        std::shared_ptr<Object> m_vertexBuffer;
+        std::shared_ptr<Object> m_indexBuffer;
+        std::shared_ptr<Object> m_vertexArray;
+        std::shared_ptr<Material> m_material;
+    };
+
+    // A model is a collection of primitives (which reference a material) and transforms referenced by the primitives' vertices.
+    struct Model final {
+        std::string Name;
+
+        // Create a model, with a root node unless asked not to.
+        explicit Model(bool createRootNode = true);
+
+        // Add a node to the model.
+        NodeIndex_t XM_CALLCONV AddNode(DirectX::FXMMATRIX transform, NodeIndex_t parentIndex, std::string name = "");
+
+        // Add a primitive to the model.
+        void AddPrimitive(Primitive primitive);
+
+        // Render the model, after Resources::Bind and Resources::SetModelToWorld.
+        void Render(const Resources& pbrResources) const;
+
+        // Remove all primitives and nodes.
+        void Clear();
+
+        uint32_t GetNodeCount() const {
+            return static_cast<uint32_t>(m_nodes.size());
+        }
+        Node& GetNode(NodeIndex_t nodeIndex) {
+            return m_nodes[nodeIndex];
+        }
+        const Node& GetNode(NodeIndex_t nodeIndex) const {
+            return m_nodes[nodeIndex];
+        }
+
+        uint32_t GetPrimitiveCount() const {
+            return static_cast<uint32_t>(m_primitives.size());
+        }
+        Primitive& GetPrimitive(uint32_t index) {
+            return m_primitives[index];
+        }
+        const Primitive& GetPrimitive(uint32_t index) const {
+            return m_primitives[index];
+        }
+
+    private:
+        // Updates the texture of node transforms the vertex shader reads, if a node changed.
+        void UpdateTransforms() const;
+
+        Primitive::Collection m_primitives;
+        Node::Collection m_nodes;
+
+        mutable NodeTransforms m_modelTransforms;
+        mutable Object m_transformsTexture;
+        mutable uint32_t m_transformsTextureRows{0};
+    };
+
+    // Creates a Pbr::Device rendering with these types. Compiles the shaders in the current context, see Resources.
+    std::unique_ptr<Pbr::Device> CreateDevice();
+} // namespace Pbr::Gles
@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+// Doesn't use the precompiled header, which includes Windows headers, so that it builds on any platform.
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+// Implementation is in the Gltf library so this isn't needed: #define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "PbrImage.h"
+#include "PbrTaskScheduler.h"
+
+namespace {
+    constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+
+    uint64_t RotateLeft(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    uint64_t Avalanche(uint64_t hash) {
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    // Decodes that are running, or finished and still held by a loader. Entries are removed once nobody holds them, so the
+    // decoded pixels are released as soon as their textures are created.
+    std::mutex g_decodesMutex;
+    std::map<Pbr::ImageKey, std::weak_ptr<Pbr::ImageDecode>> g_decodes;
+} // namespace
+
+namespace Pbr {
+    ImageKey HashImage(_In_reads_bytes_(size) const uint8_t* data, size_t size) {
+        // Four independent lanes over 32 byte blocks keep the multiplies pipelined, so hashing costs little next to decoding.
+        uint64_t lanes[4] = {Prime1 + Prime2, Prime2, 0, 0 - Prime1};
+        size_t offset = 0;
+        for (; offset + 32 <= size; offset += 32) {
+            for (int i = 0; i < 4; i++) {
+                uint64_t word;
+                memcpy(&word, data + offset + i * 8, sizeof(word));
+                lanes[i] = RotateLeft(lanes[i] + word * Prime2, 31) * Prime1;
+            }
+        }
+
+        uint64_t hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) + RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+        for (; offset < size; offset++) {
+            hash = RotateLeft(hash ^ (data[offset] * Prime1), 11) * Prime2;
+        }
+
+        return ImageKey{Avalanche(hash ^ size), size};
+    }
+
+    DecodedImage DecodeImage(_In_reads_bytes_(size) const uint8_t* data, size_t size) {
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        auto freeImageData = [](unsigned char* ptr) { ::free(ptr); };
+        using stbi_unique_ptr = std::unique_ptr<unsigned char, decltype(freeImageData)>;
+
+        constexpr uint32_t DesiredComponentCount = 4;
+
+        int w, h, c;
+        // If c == 3, a component will be padded with 1.0f
+        stbi_unique_ptr rgbaData(stbi_load_from_memory(data, static_cast<int>(size), &w, &h, &c, DesiredComponentCount), freeImageData);
+        if (!rgbaData) {
+            throw std::runtime_error("Failed to decode image data.");
+        }
+
+        DecodedImage image;
+        image.Width = static_cast<uint32_t>(w);
+        image.Height = static_cast<uint32_t>(h);
+        image.Rgba.assign(rgbaData.get(), rgbaData.get() + static_cast<size_t>(w) * h * DesiredComponentCount);
+        image.DecodeDuration =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start);
+        return image;
+    }
+
+    std::shared_ptr<ImageDecode> ImageDecode::Start(const ImageKey& key, _In_reads_bytes_(size) const uint8_t* data, size_t size) {
+        std::lock_guard lock(g_decodesMutex);
+
+        std::weak_ptr<ImageDecode>& entry = g_decodes[key];
+        if (std::shared_ptr<ImageDecode> decode = entry.lock()) {
+            return decode;
+        }
+
+        // The worker decodes its own copy of the content, so the caller's buffers may go away before the decode finishes.
+        auto decode = std::make_shared<ImageDecode>(key);
+        Internal::Run([decode, content = std::vector<uint8_t>(data, data + size)] {
+            try {
+                decode->Finish(std::make_shared<DecodedImage>(DecodeImage(content.data(), content.size())), nullptr);
+            } catch (...) {
+                decode->Finish(nullptr, std::current_exception());
+            }
+        });
+        entry = decode;
+
+        // Drop the entries of decodes nobody holds anymore.
+        for (auto it = g_decodes.begin(); it != g_decodes.end();) {
+            it = it->second.expired() ? g_decodes.erase(it) : std::next(it);
+        }
+
+        return decode;
+    }
+
+    ImageDecode::ImageDecode(const ImageKey& key)
+        : m_key(key)
+        , m_result(m_promise.get_future().share()) {
+    }
+
+    void ImageDecode::Then(std::function<void()> continuation) {
+        {
+            std::lock_guard lock(m_mutex);
+            if (!m_finished) {
+                m_continuations.push_back(std::move(continuation));
+                return;
+            }
+        }
+        continuation();
+    }
+
+    void ImageDecode::Finish(std::shared_ptr<const DecodedImage> image, std::exception_ptr error) {
+        if (error) {
+            m_promise.set_exception(error);
+        } else {
+            m_promise.set_value(std::move(image));
+        }
+
+        // Continuations added from now on run right away, since Get no longer waits.
+        std::vector<std::function<void()>> continuations;
+        {
+            std::lock_guard lock(m_mutex);
+            m_finished = true;
+            continuations.swap(m_continuations);
+        }
+        for (const std::function<void()>& continuation : continuations) {
+            continuation();
+        }
+    }
+} // namespace Pbr
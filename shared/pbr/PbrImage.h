@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// Decoding of encoded images (PNG, JPEG, ...) into RGBA pixels on worker threads.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Pbr {
+    // Identifies encoded image content. Images with equal keys are treated as identical.
+    struct ImageKey {
+        uint64_t Hash{0};
+        uint64_t Size{0};
+
+        bool operator==(const ImageKey& other) const {
+            return Hash == other.Hash && Size == other.Size;
+        }
+        bool operator!=(const ImageKey& other) const {
+            return !(*this == other);
+        }
+        bool operator<(const ImageKey& other) const {
+            return Hash < other.Hash || (Hash == other.Hash && Size < other.Size);
+        }
+    };
+
+    // Computes the key of the encoded image content.
+    ImageKey HashImage(_In_reads_bytes_(size) const uint8_t* data, size_t size);
+
+    // Image pixels with 4 bytes per pixel in RGBA order.
+    struct DecodedImage {
+        uint32_t Width{0};
+        uint32_t Height{0};
+        std::vector<uint8_t> Rgba;
+        std::chrono::microseconds DecodeDuration{0};
+    };
+
+    // A decode running or finished on the task scheduler, see Pbr::SetTaskScheduler. It is shared by every request for the same
+    // content while any of them still holds it, so a model loaded twice at the same time, or an image referenced by several
+    // models, is decoded once.
+    class ImageDecode {
+    public:
+        // Starts decoding a copy of the encoded content, or joins the decode of identical content that is still held elsewhere.
+        static std::shared_ptr<ImageDecode> Start(const ImageKey& key, _In_reads_bytes_(size) const uint8_t* data, size_t size);
+
+        const ImageKey& Key() const {
+            return m_key;
+        }
+
+        bool IsReady() const {
+            return m_result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+        // Waits for the decode to finish. Throws if the content could not be decoded.
+        const DecodedImage& Get() const {
+            return *m_result.get();
+        }
+
+        // Calls continuation once the decode finished, so that Get returns without waiting: right away on the calling thread
+        // if it finished already, or else on the thread finishing it. Work on the pixels follows the decode this way without
+        // a worker blocking on it. The continuation must not throw.
+        void Then(std::function<void()> continuation);
+
+        explicit ImageDecode(const ImageKey& key);
+
+    private:
+        void Finish(std::shared_ptr<const DecodedImage> image, std::exception_ptr error);
+
+        ImageKey m_key;
+        std::promise<std::shared_ptr<const DecodedImage>> m_promise;
+        std::shared_future<std::shared_ptr<const DecodedImage>> m_result;
+        std::mutex m_mutex;
+        bool m_finished{false};
+        std::vector<std::function<void()>> m_continuations;
+    };
+
+    // Decodes the encoded image into RGBA pixels on the calling thread. Throws if the content could not be decoded.
+    DecodedImage DecodeImage(_In_reads_bytes_(size) const uint8_t* data, size_t size);
+} // namespace Pbr
@@ -5,21 +5,32 @@
 #include "PbrCommon.h"
 #include "PbrResources.h"
 #include "PbrMaterial.h"
+#include "PbrTextureResidency.h"
 
 using namespace DirectX;
 
 namespace Pbr {
-    Material::Material(Pbr::Resources const& pbrResources) {
+    Material::Material(Pbr::Resources const& pbrResources)
+        : Material(pbrResources.GetDevice().get()) {
+    }
+
+    Material::Material(_In_ ID3D11Device* device) {
         const CD3D11_BUFFER_DESC constantBufferDesc(sizeof(ConstantBufferData), D3D11_BIND_CONSTANT_BUFFER);
-        Internal::ThrowIfFailed(pbrResources.GetDevice()->CreateBuffer(&constantBufferDesc, nullptr, m_constantBuffer.put()));
+        Internal::ThrowIfFailed(device->CreateBuffer(&constantBufferDesc, nullptr, m_constantBuffer.put()));
     }
 
     std::shared_ptr<Material> Material::Clone(Pbr::Resources const& pbrResources) const {
-        auto clone = std::make_shared<Material>(pbrResources);
+        return Clone(pbrResources.GetDevice().get());
+    }
+
+    std::shared_ptr<Material> Material::Clone(_In_ ID3D11Device* device) const {
+        auto clone = std::make_shared<Material>(device);
         clone->Name = Name;
         clone->Hidden = Hidden;
         clone->m_parameters = m_parameters;
         clone->m_textures = m_textures;
+        clone->m_streamedTextures = m_streamedTextures;
+        clone->m_cachedTextures = m_cachedTextures;
         clone->m_samplers = m_samplers;
         clone->m_alphaBlended = m_alphaBlended;
         clone->m_doubleSided = m_doubleSided;
@@ -60,12 +71,39 @@ namespace Pbr {
                               _In_ ID3D11ShaderResourceView* textureView,
                               _In_opt_ ID3D11SamplerState* sampler) {
         m_textures[slot].copy_from(textureView);
+        m_streamedTextures[slot] = nullptr;
+        m_cachedTextures[slot] = nullptr;
+        m_textureRevision++;
 
         if (sampler) {
             m_samplers[slot].copy_from(sampler);
         }
     }
 
+    void Material::SetTexture(ShaderSlots::PSMaterial slot,
+                              std::shared_ptr<const CachedTexture> texture,
+                              _In_opt_ ID3D11SamplerState* sampler) {
+        SetTexture(slot, texture ? texture->View.get() : nullptr, sampler);
+        m_cachedTextures[slot] = std::move(texture);
+    }
+
+    void Material::SetTexture(ShaderSlots::PSMaterial slot,
+                              std::shared_ptr<StreamedTexture> texture,
+                              _In_opt_ ID3D11SamplerState* sampler) {
+        m_textures[slot] = nullptr;
+        m_streamedTextures[slot] = std::move(texture);
+        m_cachedTextures[slot] = nullptr;
+        m_textureRevision++;
+
+        if (sampler) {
+            m_samplers[slot].copy_from(sampler);
+        }
+    }
+
+    ID3D11ShaderResourceView* Material::GetTexture(ShaderSlots::PSMaterial slot) const {
+        return m_streamedTextures[slot] ? m_streamedTextures[slot]->CurrentView() : m_textures[slot].get();
+    }
+
     void Material::SetDoubleSided(bool doubleSided) {
         m_doubleSided = doubleSided;
     }
@@ -95,7 +133,9 @@ namespace Pbr {
         static_assert(Pbr::ShaderSlots::BaseColor == 0, "BaseColor must be the first slot");
 
         std::array<ID3D11ShaderResourceView*, TextureCount> textures;
-        std::transform(m_textures.begin(), m_textures.end(), textures.begin(), [](const auto& texture) { return texture.get(); });
+        for (size_t slot = 0; slot < TextureCount; slot++) {
+            textures[slot] = m_streamedTextures[slot] ? m_streamedTextures[slot]->CurrentView() : m_textures[slot].get();
+        }
         context->PSSetShaderResources(Pbr::ShaderSlots::BaseColor, (UINT)textures.size(), textures.data());
 
         std::array<ID3D11SamplerState*, TextureCount> samplers;
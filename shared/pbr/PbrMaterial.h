@@ -15,34 +15,21 @@
 #include "PbrResources.h"
 
 namespace Pbr {
+    class StreamedTexture;
+
     // A Material contains the metallic roughness parameters and textures.
     // Primitives specify which Material to use when being rendered.
     struct Material final {
-#pragma warning(push)
-#pragma warning(disable:4324)
         // Coefficients used by the shader. Each texture is sampled and multiplied by these coefficients.
-        struct ConstantBufferData {
-            // packoffset(c0)
-            alignas(16) RGBAColor BaseColorFactor{1, 1, 1, 1};
-            // packoffset(c1.x and c1.y)
-            alignas(16) float MetallicFactor{1};
-            float RoughnessFactor{1};
-            // packoffset(c2)
-            alignas(16) RGBColor EmissiveFactor{1, 1, 1};
-            // packoffset(c3.x, c3.y and c3.z)
-            alignas(16) float NormalScale{1};
-            float OcclusionStrength{1};
-            float AlphaCutoff{0};
-        };
-#pragma warning(pop)
-
-        static_assert((sizeof(ConstantBufferData) % 16) == 0, "Constant Buffer must be divisible by 16 bytes");
+        using ConstantBufferData = MaterialParameters;
 
         // Create a uninitialized material. Textures and shader coefficients must be set.
         Material(Pbr::Resources const& pbrResources);
+        explicit Material(_In_ ID3D11Device* device);
 
-        // Create a clone of this material.
+        // Create a clone of this material. The clone is not shared, even if this material is.
         std::shared_ptr<Material> Clone(Pbr::Resources const& pbrResources) const;
+        std::shared_ptr<Material> Clone(_In_ ID3D11Device* device) const;
 
         // Create a flat (no texture) material.
         static std::shared_ptr<Material> CreateFlat(const Resources& pbrResources,
@@ -56,20 +43,58 @@ namespace Pbr {
                         _In_ ID3D11ShaderResourceView* textureView,
                         _In_opt_ ID3D11SamplerState* sampler = nullptr);
 
+        // Set a texture of the asset cache. The material holds it, so that the cache counts it as used as long as the material.
+        void SetTexture(ShaderSlots::PSMaterial slot,
+                        std::shared_ptr<const CachedTexture> texture,
+                        _In_opt_ ID3D11SamplerState* sampler = nullptr);
+
+        // Set a texture whose levels are streamed. The material shows the levels resident when it is bound.
+        void SetTexture(ShaderSlots::PSMaterial slot,
+                        std::shared_ptr<StreamedTexture> texture,
+                        _In_opt_ ID3D11SamplerState* sampler = nullptr);
+
         void SetDoubleSided(bool doubleSided);
         void SetWireframe(bool wireframeMode);
         void SetAlphaBlended(bool alphaBlended);
 
+        ID3D11ShaderResourceView* GetTexture(ShaderSlots::PSMaterial slot) const;
+        const std::shared_ptr<StreamedTexture>& GetStreamedTexture(ShaderSlots::PSMaterial slot) const {
+            return m_streamedTextures[slot];
+        }
+        ID3D11SamplerState* GetSampler(ShaderSlots::PSMaterial slot) const {
+            return m_samplers[slot].get();
+        }
+        bool IsDoubleSided() const {
+            return m_doubleSided;
+        }
+        bool IsAlphaBlended() const {
+            return m_alphaBlended;
+        }
+
+        // Changes each time a texture or sampler is set, so that users of the textures can tell when they were replaced.
+        uint32_t TextureRevision() const {
+            return m_textureRevision;
+        }
+
         // Bind this material to current context.
         void Bind(_In_ ID3D11DeviceContext* context, const Resources& pbrResources) const;
 
         ConstantBufferData& Parameters();
         const ConstantBufferData& Parameters() const;
 
+        // Whether the material is shared by the models using it through the asset cache of the Pbr resources. A shared
+        // material must not be edited; use Primitive::GetMaterialForEdit, which replaces it with an unshared copy first.
+        bool IsShared() const {
+            return m_shared;
+        }
+
         std::string Name;
         bool Hidden{false};
 
     private:
+        friend class AssetCache;
+        bool m_shared{false};
+
         mutable bool m_parametersChanged{true};
         ConstantBufferData m_parameters;
 
@@ -79,7 +104,10 @@ namespace Pbr {
 
         static constexpr size_t TextureCount = ShaderSlots::LastMaterialSlot + 1;
         std::array<winrt::com_ptr<ID3D11ShaderResourceView>, TextureCount> m_textures;
+        std::array<std::shared_ptr<StreamedTexture>, TextureCount> m_streamedTextures; // Replace the textures of their slots
+        std::array<std::shared_ptr<const CachedTexture>, TextureCount> m_cachedTextures; // Hold the textures of their slots
         std::array<winrt::com_ptr<ID3D11SamplerState>, TextureCount> m_samplers;
+        uint32_t m_textureRevision{0};
         winrt::com_ptr<ID3D11Buffer> m_constantBuffer;
     };
 } // namespace Pbr
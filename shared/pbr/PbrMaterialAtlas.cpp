@@ -0,0 +1,271 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#include "pch.h"
+#include <algorithm>
+#include <cstring>
+#include "PbrCommon.h"
+#include "PbrPrimitive.h"
+#include "PbrMaterialAtlas.h"
+
+namespace {
+    struct DrawBufferData {
+        uint32_t MaterialIndex;
+        uint32_t Padding[3];
+    };
+    static_assert((sizeof(DrawBufferData) % 16) == 0, "Constant Buffer must be divisible by 16 bytes");
+
+    // Describes the texture of a material slot for packing, or returns false if it can't be a layer of a texture array.
+    bool DescribeTexture(_In_opt_ ID3D11ShaderResourceView* view, Pbr::AtlasTexture& texture, winrt::com_ptr<ID3D11Resource>& resource) {
+        if (!view) {
+            return false;
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc;
+        view->GetDesc(&viewDesc);
+        if (viewDesc.ViewDimension != D3D11_SRV_DIMENSION_TEXTURE2D || viewDesc.Texture2D.MostDetailedMip != 0) {
+            return false;
+        }
+
+        view->GetResource(resource.put());
+        const winrt::com_ptr<ID3D11Texture2D> texture2D = resource.try_as<ID3D11Texture2D>();
+        if (!texture2D) {
+            return false;
+        }
+
+        D3D11_TEXTURE2D_DESC desc;
+        texture2D->GetDesc(&desc);
+        // The array is viewed with the format of the textures, so views reinterpreting a typeless texture are kept out.
+        if (desc.ArraySize != 1 || desc.SampleDesc.Count != 1 || desc.Format != viewDesc.Format ||
+            (viewDesc.Texture2D.MipLevels != static_cast<UINT>(-1) && viewDesc.Texture2D.MipLevels != desc.MipLevels)) {
+            return false;
+        }
+
+        texture.Id = reinterpret_cast<uintptr_t>(view);
+        texture.Shape = {desc.Width, desc.Height, desc.MipLevels, static_cast<uint32_t>(desc.Format)};
+        return true;
+    }
+} // namespace
+
+namespace Pbr {
+    MaterialAtlas::MaterialAtlas(const Resources& pbrResources,
+                                 _In_ ID3D11DeviceContext* context,
+                                 std::vector<std::shared_ptr<Material>> materials)
+        : m_materials(std::move(materials)) {
+        std::map<uintptr_t, winrt::com_ptr<ID3D11Resource>> sources;
+
+        m_inputs.resize(m_materials.size());
+        m_textureRevisions.resize(m_materials.size());
+        for (uint32_t materialIndex = 0; materialIndex < m_materials.size(); materialIndex++) {
+            const Material& material = *m_materials[materialIndex];
+            m_materialIndices.emplace(&material, materialIndex);
+            m_textureRevisions[materialIndex] = material.TextureRevision();
+
+            AtlasMaterialInput& input = m_inputs[materialIndex];
+            input.AlphaBlended = material.IsAlphaBlended();
+            input.DoubleSided = material.IsDoubleSided();
+            for (uint32_t slot = 0; slot < MaterialSlotCount; slot++) {
+                const auto materialSlot = static_cast<ShaderSlots::PSMaterial>(slot);
+                input.Samplers[slot] = reinterpret_cast<uintptr_t>(material.GetSampler(materialSlot));
+
+                // The levels of streamed textures change, so they are kept out of the arrays.
+                winrt::com_ptr<ID3D11Resource> resource;
+                if (material.GetStreamedTexture(materialSlot) ||
+                    !DescribeTexture(material.GetTexture(materialSlot), input.Textures[slot], resource)) {
+                    input.Packable = false;
+                    break;
+                }
+                sources.emplace(input.Textures[slot].Id, std::move(resource));
+            }
+        }
+
+        m_plan = PlanMaterialAtlas(m_inputs, D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION);
+        if (PackedMaterialCount() == 0) {
+            return;
+        }
+
+        const winrt::com_ptr<ID3D11Device> device = pbrResources.GetDevice();
+        for (const AtlasArray& array : m_plan.Arrays) {
+            const CD3D11_TEXTURE2D_DESC desc(static_cast<DXGI_FORMAT>(array.Shape.Format),
+                                             array.Shape.Width,
+                                             array.Shape.Height,
+                                             static_cast<UINT>(array.Layers.size()),
+                                             array.Shape.MipLevels,
+                                             D3D11_BIND_SHADER_RESOURCE);
+            winrt::com_ptr<ID3D11Texture2D> texture;
+            Internal::ThrowIfFailed(device->CreateTexture2D(&desc, nullptr, texture.put()));
+
+            for (uint32_t layer = 0; layer < array.Layers.size(); layer++) {
+                ID3D11Resource* source = sources.at(array.Layers[layer]).get();
+                for (uint32_t mip = 0; mip < array.Shape.MipLevels; mip++) {
+                    context->CopySubresourceRegion(texture.get(),
+                                                   D3D11CalcSubresource(mip, layer, array.Shape.MipLevels),
+                                                   0,
+                                                   0,
+                                                   0,
+                                                   source,
+                                                   D3D11CalcSubresource(mip, 0, array.Shape.MipLevels),
+                                                   nullptr);
+                }
+            }
+
+            const CD3D11_SHADER_RESOURCE_VIEW_DESC viewDesc(texture.get(), D3D11_SRV_DIMENSION_TEXTURE2DARRAY);
+            Internal::ThrowIfFailed(device->CreateShaderResourceView(texture.get(), &viewDesc, m_arrays.emplace_back().put()));
+        }
+
+        // The groups use the samplers of their materials, which are equal by construction.
+        m_groupSamplers.resize(m_plan.Groups.size() * MaterialSlotCount);
+        for (uint32_t materialIndex = 0; materialIndex < m_materials.size(); materialIndex++) {
+            const uint32_t group = m_plan.Materials[materialIndex].Group;
+            if (group == AtlasNone) {
+                continue;
+            }
+
+            for (uint32_t slot = 0; slot < MaterialSlotCount; slot++) {
+                const auto materialSlot = static_cast<ShaderSlots::PSMaterial>(slot);
+                m_groupSamplers[group * MaterialSlotCount + slot].copy_from(m_materials[materialIndex]->GetSampler(materialSlot));
+            }
+        }
+
+        const auto materialCount = static_cast<UINT>(m_materials.size());
+        D3D11_BUFFER_DESC desc{};
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        desc.StructureByteStride = sizeof(AtlasMaterialData);
+        desc.ByteWidth = materialCount * desc.StructureByteStride;
+        Internal::ThrowIfFailed(device->CreateBuffer(&desc, nullptr, m_parametersBuffer.put()));
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        srvDesc.Buffer.NumElements = materialCount;
+        Internal::ThrowIfFailed(device->CreateShaderResourceView(m_parametersBuffer.get(), &srvDesc, m_parametersView.put()));
+
+        const CD3D11_BUFFER_DESC drawBufferDesc(sizeof(DrawBufferData), D3D11_BIND_CONSTANT_BUFFER);
+        Internal::ThrowIfFailed(device->CreateBuffer(&drawBufferDesc, nullptr, m_drawBuffer.put()));
+    }
+
+    uint32_t MaterialAtlas::PackedMaterialCount() const {
+        return static_cast<uint32_t>(std::count_if(m_plan.Materials.begin(), m_plan.Materials.end(), [](const auto& placement) {
+            return placement.Group != AtlasNone;
+        }));
+    }
+
+    bool MaterialAtlas::Matches(uint32_t materialIndex) const {
+        // The revision changes with every texture or sampler set, so the textures that were packed don't need to be kept alive
+        // to tell them from new textures at the same address.
+        const AtlasMaterialInput& input = m_inputs[materialIndex];
+        const Material& material = *m_materials[materialIndex];
+        return m_plan.Materials[materialIndex].Group != AtlasNone && material.TextureRevision() == m_textureRevisions[materialIndex] &&
+               material.IsAlphaBlended() == input.AlphaBlended && material.IsDoubleSided() == input.DoubleSided;
+    }
+
+    void MaterialAtlas::UpdateParameters(_In_ ID3D11DeviceContext* context) const {
+        // Materials are edited through their parameters, so the buffer is only uploaded when one of them changed.
+        bool changed = m_parameters.size() != m_materials.size();
+        m_parameters.resize(m_materials.size());
+        for (size_t materialIndex = 0; materialIndex < m_materials.size(); materialIndex++) {
+            const Material::ConstantBufferData& source = m_materials[materialIndex]->Parameters();
+            AtlasMaterialData data{};
+            data.BaseColorFactor = source.BaseColorFactor;
+            data.EmissiveFactor = source.EmissiveFactor;
+            data.MetallicFactor = source.MetallicFactor;
+            data.RoughnessFactor = source.RoughnessFactor;
+            data.NormalScale = source.NormalScale;
+            data.OcclusionStrength = source.OcclusionStrength;
+            data.AlphaCutoff = source.AlphaCutoff;
+            data.Layers = m_plan.Materials[materialIndex].Layers;
+
+            if (std::memcmp(&data, &m_parameters[materialIndex], sizeof(AtlasMaterialData)) != 0) {
+                m_parameters[materialIndex] = data;
+                changed = true;
+            }
+        }
+
+        if (changed) {
+            context->UpdateSubresource(m_parametersBuffer.get(), 0, nullptr, m_parameters.data(), 0, 0);
+        }
+    }
+
+    void MaterialAtlas::BindGroup(const Resources& pbrResources, _In_ ID3D11DeviceContext* context, uint32_t group) const {
+        const AtlasGroup& atlasGroup = m_plan.Groups[group];
+        pbrResources.SetBlendState(context, atlasGroup.AlphaBlended);
+        pbrResources.SetDepthStencilState(context, atlasGroup.AlphaBlended);
+        pbrResources.SetRasterizerState(context, atlasGroup.DoubleSided, pbrResources.GetFillMode() == FillMode::Wireframe);
+
+        std::array<ID3D11ShaderResourceView*, MaterialSlotCount> textures;
+        std::transform(atlasGroup.Arrays.begin(), atlasGroup.Arrays.end(), textures.begin(), [&](uint32_t array) {
+            return m_arrays[array].get();
+        });
+        context->PSSetShaderResources(ShaderSlots::BaseColor, (UINT)textures.size(), textures.data());
+
+        std::array<ID3D11SamplerState*, MaterialSlotCount> samplers;
+        for (uint32_t slot = 0; slot < MaterialSlotCount; slot++) {
+            samplers[slot] = m_groupSamplers[group * MaterialSlotCount + slot].get();
+        }
+        context->PSSetSamplers(ShaderSlots::BaseColor, (UINT)samplers.size(), samplers.data());
+    }
+
+    void MaterialAtlas::Render(const Resources& pbrResources,
+                               _In_ ID3D11DeviceContext* context,
+                               const std::vector<Primitive>& primitives) const {
+        m_drawMaterials.resize(primitives.size());
+        for (size_t draw = 0; draw < primitives.size(); draw++) {
+            const auto it = m_materialIndices.find(primitives[draw].GetMaterial().get());
+            m_drawMaterials[draw] = it != m_materialIndices.end() && Matches(it->second) ? it->second : AtlasNone;
+        }
+        OrderAtlasDraws(m_plan, m_drawMaterials, m_drawOrder);
+
+        if (m_parametersBuffer) {
+            UpdateParameters(context);
+
+            ID3D11ShaderResourceView* shaderResources[] = {m_parametersView.get()};
+            context->PSSetShaderResources(ShaderSlots::AtlasMaterials, _countof(shaderResources), shaderResources);
+            ID3D11Buffer* constantBuffers[] = {m_drawBuffer.get()};
+            context->PSSetConstantBuffers(ShaderSlots::ConstantBuffers::AtlasDraw, _countof(constantBuffers), constantBuffers);
+        }
+
+        const bool wireframe = pbrResources.GetFillMode() == FillMode::Wireframe;
+        bool atlasShader = false;
+        uint32_t boundGroup = AtlasNone;
+        for (const uint32_t draw : m_drawOrder) {
+            const Primitive& primitive = primitives[draw];
+            if (primitive.GetMaterial()->Hidden) {
+                continue;
+            }
+
+            const uint32_t materialIndex = m_drawMaterials[draw];
+            if (materialIndex == AtlasNone) {
+                if (atlasShader) {
+                    pbrResources.SetMaterialAtlasShader(context, false);
+                    atlasShader = false;
+                }
+
+                // Material::Bind replaces the textures, samplers and states of the group.
+                boundGroup = AtlasNone;
+                primitive.GetMaterial()->SetWireframe(wireframe);
+                primitive.GetMaterial()->Bind(context, pbrResources);
+            } else {
+                if (!atlasShader) {
+                    pbrResources.SetMaterialAtlasShader(context, true);
+                    atlasShader = true;
+                }
+
+                const uint32_t group = m_plan.Materials[materialIndex].Group;
+                if (group != boundGroup) {
+                    BindGroup(pbrResources, context, group);
+                    boundGroup = group;
+                }
+
+                const DrawBufferData drawData{materialIndex, {}};
+                context->UpdateSubresource(m_drawBuffer.get(), 0, nullptr, &drawData, 0, 0);
+            }
+
+            primitive.Render(context, pbrResources.GetViewInstanceCount());
+        }
+
+        if (atlasShader) {
+            pbrResources.SetMaterialAtlasShader(context, false);
+        }
+    }
+} // namespace Pbr
@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// Material atlases, which pack the textures of many materials into texture arrays so that the materials can be drawn
+// with a few state changes. The packing is planned on the CPU without a device, see PbrMaterialAtlasPlan.h, and then built
+// with GPU copies.
+//
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <memory>
+#include <vector>
+#include <winrt/base.h>
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include "PbrMaterialAtlasPlan.h"
+#include "PbrResources.h"
+
+namespace Pbr {
+    struct Material;
+    struct Primitive;
+
+    // The parameters of a material in the atlas, as read by the atlas variant of the pixel shader.
+    struct AtlasMaterialData {
+        DirectX::XMFLOAT4 BaseColorFactor;
+        DirectX::XMFLOAT3 EmissiveFactor;
+        float MetallicFactor;
+        float RoughnessFactor;
+        float NormalScale;
+        float OcclusionStrength;
+        float AlphaCutoff;
+        std::array<uint32_t, MaterialSlotCount> Layers;
+        uint32_t Padding[3];
+    };
+    static_assert(sizeof(AtlasMaterialData) % 16 == 0, "Keep AtlasMaterialData aligned to 16 bytes");
+
+    // The textures of materials packed into texture arrays on the GPU, and their parameters in a structured buffer. Draws of
+    // a group only update the index of their material. Materials whose textures or samplers change after the atlas was
+    // built, and materials kept out of it, are drawn on their own as before.
+    class MaterialAtlas {
+    public:
+        // Packs the textures of the materials with GPU copies on the context.
+        MaterialAtlas(const Resources& pbrResources, _In_ ID3D11DeviceContext* context, std::vector<std::shared_ptr<Material>> materials);
+
+        // Draws the primitives, with the atlas where possible. Requires the regular shading mode.
+        void Render(const Resources& pbrResources, _In_ ID3D11DeviceContext* context, const std::vector<Primitive>& primitives) const;
+
+        uint32_t GroupCount() const {
+            return static_cast<uint32_t>(m_plan.Groups.size());
+        }
+        uint32_t PackedMaterialCount() const;
+
+    private:
+        // Whether the material still has the textures, samplers and render states it was packed with.
+        bool Matches(uint32_t materialIndex) const;
+        void UpdateParameters(_In_ ID3D11DeviceContext* context) const;
+        void BindGroup(const Resources& pbrResources, _In_ ID3D11DeviceContext* context, uint32_t group) const;
+
+        std::vector<std::shared_ptr<Material>> m_materials;
+        std::map<const Material*, uint32_t> m_materialIndices;
+        std::vector<AtlasMaterialInput> m_inputs;
+        std::vector<uint32_t> m_textureRevisions; // Material::TextureRevision of each material when it was packed
+        AtlasPlan m_plan;
+
+        std::vector<winrt::com_ptr<ID3D11ShaderResourceView>> m_arrays;
+        std::vector<winrt::com_ptr<ID3D11SamplerState>> m_groupSamplers; // MaterialSlotCount per group
+        winrt::com_ptr<ID3D11Buffer> m_parametersBuffer;
+        winrt::com_ptr<ID3D11ShaderResourceView> m_parametersView;
+        winrt::com_ptr<ID3D11Buffer> m_drawBuffer;
+
+        // Reused every frame to avoid allocations.
+        mutable std::vector<AtlasMaterialData> m_parameters;
+        mutable std::vector<uint32_t> m_drawMaterials;
+        mutable std::vector<uint32_t> m_drawOrder;
+    };
+} // namespace Pbr
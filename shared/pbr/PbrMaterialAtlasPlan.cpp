@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+// Doesn't use the precompiled header, which includes Windows headers, so that it builds on any platform.
+#include <algorithm>
+#include <map>
+#include <utility>
+#include "PbrMaterialAtlasPlan.h"
+
+namespace {
+    struct GroupKey {
+        std::array<uint32_t, Pbr::MaterialSlotCount> Arrays;
+        std::array<uintptr_t, Pbr::MaterialSlotCount> Samplers;
+        bool AlphaBlended;
+        bool DoubleSided;
+
+        bool operator<(const GroupKey& other) const {
+            return std::tie(Arrays, Samplers, AlphaBlended, DoubleSided) <
+                   std::tie(other.Arrays, other.Samplers, other.AlphaBlended, other.DoubleSided);
+        }
+    };
+} // namespace
+
+namespace Pbr {
+    AtlasPlan PlanMaterialAtlas(const std::vector<AtlasMaterialInput>& materials, uint32_t maxLayers) {
+        AtlasPlan plan;
+        plan.Materials.resize(materials.size());
+
+        // The array of each slot and shape that is still being filled, and where each texture was placed.
+        std::map<std::pair<uint32_t, AtlasTextureShape>, uint32_t> openArrays;
+        std::map<std::pair<uint32_t, uintptr_t>, std::pair<uint32_t, uint32_t>> placements;
+        std::map<GroupKey, uint32_t> groups;
+
+        for (size_t materialIndex = 0; materialIndex < materials.size(); materialIndex++) {
+            const AtlasMaterialInput& material = materials[materialIndex];
+            if (!material.Packable) {
+                continue;
+            }
+
+            AtlasMaterialPlacement& placement = plan.Materials[materialIndex];
+            GroupKey groupKey{{}, material.Samplers, material.AlphaBlended, material.DoubleSided};
+            for (uint32_t slot = 0; slot < MaterialSlotCount; slot++) {
+                const AtlasTexture& texture = material.Textures[slot];
+
+                auto placed = placements.find({slot, texture.Id});
+                if (placed == placements.end()) {
+                    auto open = openArrays.find({slot, texture.Shape});
+                    if (open == openArrays.end() || plan.Arrays[open->second].Layers.size() >= maxLayers) {
+                        plan.Arrays.push_back(AtlasArray{slot, texture.Shape, {}});
+                        open = openArrays.insert_or_assign({slot, texture.Shape}, static_cast<uint32_t>(plan.Arrays.size() - 1)).first;
+                    }
+
+                    AtlasArray& array = plan.Arrays[open->second];
+                    array.Layers.push_back(texture.Id);
+                    placed = placements.emplace(std::make_pair(slot, texture.Id),
+                                                std::make_pair(open->second, static_cast<uint32_t>(array.Layers.size() - 1)))
+                                 .first;
+                }
+
+                groupKey.Arrays[slot] = placed->second.first;
+                placement.Layers[slot] = placed->second.second;
+            }
+
+            const auto [group, inserted] = groups.emplace(groupKey, static_cast<uint32_t>(plan.Groups.size()));
+            if (inserted) {
+                plan.Groups.push_back(AtlasGroup{groupKey.Arrays, groupKey.Samplers, groupKey.AlphaBlended, groupKey.DoubleSided});
+            }
+            placement.Group = group->second;
+        }
+
+        return plan;
+    }
+
+    void OrderAtlasDraws(const AtlasPlan& plan, const std::vector<uint32_t>& drawMaterials, std::vector<uint32_t>& order) {
+        const auto groupOf = [&](uint32_t draw) {
+            const uint32_t material = drawMaterials[draw];
+            return material == AtlasNone ? AtlasNone : plan.Materials[material].Group;
+        };
+        const auto isGroupedOpaque = [&](uint32_t draw) {
+            const uint32_t group = groupOf(draw);
+            return group != AtlasNone && !plan.Groups[group].AlphaBlended;
+        };
+
+        // Sorting by group and then by draw keeps the original order within groups, like a stable sort would, without the
+        // buffer std::stable_sort allocates. Called every frame, order keeps its capacity.
+        order.clear();
+        for (uint32_t draw = 0; draw < drawMaterials.size(); draw++) {
+            if (isGroupedOpaque(draw)) {
+                order.push_back(draw);
+            }
+        }
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return std::make_pair(groupOf(a), a) < std::make_pair(groupOf(b), b);
+        });
+
+        for (uint32_t draw = 0; draw < drawMaterials.size(); draw++) {
+            if (!isGroupedOpaque(draw)) {
+                order.push_back(draw);
+            }
+        }
+    }
+} // namespace Pbr
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// The CPU side of material atlases (see PbrMaterialAtlas.h): which textures go into which layers of which texture arrays,
+// which materials can be drawn together, and in which order the draws go. Textures and samplers are only known by ids, so
+// this doesn't need a device and builds on any platform.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "PbrTypes.h"
+
+namespace Pbr {
+    constexpr uint32_t MaterialSlotCount = ShaderSlots::LastMaterialSlot + 1;
+    constexpr uint32_t AtlasNone = ~0u;
+
+    // The shape of a texture. Textures of a slot with the same shape can be layers of one texture array.
+    struct AtlasTextureShape {
+        uint32_t Width{0};
+        uint32_t Height{0};
+        uint32_t MipLevels{0};
+        uint32_t Format{0}; // DXGI_FORMAT
+
+        bool operator<(const AtlasTextureShape& other) const {
+            return std::tie(Width, Height, MipLevels, Format) < std::tie(other.Width, other.Height, other.MipLevels, other.Format);
+        }
+    };
+
+    // A texture of a material slot. Textures with equal ids are the same texture, and share a layer.
+    struct AtlasTexture {
+        uintptr_t Id{0};
+        AtlasTextureShape Shape;
+    };
+
+    // A material to pack. Materials which can't be packed, for example because a texture isn't a plain 2D texture, are kept
+    // out of the atlas.
+    struct AtlasMaterialInput {
+        bool Packable{true};
+        std::array<AtlasTexture, MaterialSlotCount> Textures;
+        std::array<uintptr_t, MaterialSlotCount> Samplers{}; // Ids of the samplers
+        bool AlphaBlended{false};
+        bool DoubleSided{false};
+    };
+
+    // A texture array of a slot, with the ids of the textures in its layers.
+    struct AtlasArray {
+        uint32_t Slot{0};
+        AtlasTextureShape Shape;
+        std::vector<uintptr_t> Layers;
+    };
+
+    // Materials of a group are drawn with the same texture arrays, samplers and render states. They only differ in their
+    // layers and parameters.
+    struct AtlasGroup {
+        std::array<uint32_t, MaterialSlotCount> Arrays{};
+        std::array<uintptr_t, MaterialSlotCount> Samplers{};
+        bool AlphaBlended{false};
+        bool DoubleSided{false};
+    };
+
+    struct AtlasMaterialPlacement {
+        uint32_t Group{AtlasNone}; // AtlasNone if the material is kept out of the atlas
+        std::array<uint32_t, MaterialSlotCount> Layers{};
+    };
+
+    struct AtlasPlan {
+        std::vector<AtlasArray> Arrays;
+        std::vector<AtlasGroup> Groups;
+        std::vector<AtlasMaterialPlacement> Materials; // In the order of the input materials
+    };
+
+    // Assigns the textures of the materials to layers of texture arrays, with at most maxLayers layers per array, and groups
+    // the materials that can be drawn without changing bindings.
+    AtlasPlan PlanMaterialAtlas(const std::vector<AtlasMaterialInput>& materials, uint32_t maxLayers);
+
+    // Orders draws, given by the index of their material in the plan or AtlasNone, so that draws of the same group follow
+    // each other. Opaque draws of the atlas come first, ordered by group. The other draws, alpha blended ones and those out
+    // of the atlas, follow in their original order, since the order of blended draws changes the image. Writes the indices
+    // of the draws into order.
+    void OrderAtlasDraws(const AtlasPlan& plan, const std::vector<uint32_t>& drawMaterials, std::vector<uint32_t>& order);
+} // namespace Pbr
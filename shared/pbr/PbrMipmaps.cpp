@@ -0,0 +1,240 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+// Doesn't use the precompiled header, which includes Windows headers, so that it builds on any platform.
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <DirectXPackedVector.h>
+#include "PbrMipmaps.h"
+#include "PbrTaskScheduler.h"
+
+using namespace DirectX;
+
+namespace {
+    constexpr float KaiserRadius = 3;
+    constexpr float KaiserAlpha = 4;
+
+    // Linear RGBA texels in floating point, so intermediate levels don't accumulate quantization errors.
+    using FloatImage = std::vector<XMFLOAT4A>;
+
+    // The source texels contributing to one destination texel.
+    struct FilterTaps {
+        uint32_t First{0};
+        std::vector<float> Weights;
+    };
+
+    // Zeroth order modified Bessel function of the first kind, for the Kaiser window.
+    float BesselI0(float x) {
+        float sum = 1;
+        float term = 1;
+        const float halfX = x * 0.5f;
+        for (int k = 1; k < 16; k++) {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+        }
+        return sum;
+    }
+
+    float KaiserSinc(float x) {
+        if (std::abs(x) >= KaiserRadius) {
+            return 0;
+        }
+
+        const float sinc = x == 0 ? 1 : std::sin(XM_PI * x) / (XM_PI * x);
+        const float r = x / KaiserRadius;
+        return sinc * BesselI0(KaiserAlpha * std::sqrt(1 - r * r)) / BesselI0(KaiserAlpha);
+    }
+
+    // Computes the weights of the source texels for each destination texel along one axis. Texels outside the image are clamped
+    // to the edge, and the weights of each destination texel are normalized to add up to one.
+    std::vector<FilterTaps> ComputeFilterTaps(uint32_t sourceSize, uint32_t destinationSize, Pbr::MipFilter filter) {
+        const float scale = static_cast<float>(sourceSize) / destinationSize;
+        const float filterScale = std::max(scale, 1.0f);
+        const float support = filter == Pbr::MipFilter::Kaiser ? KaiserRadius * filterScale : 0.5f * filterScale;
+
+        std::vector<FilterTaps> taps(destinationSize);
+        for (uint32_t d = 0; d < destinationSize; d++) {
+            const float center = (d + 0.5f) * scale;
+            const int first = static_cast<int>(std::floor(center - support));
+            const int last = static_cast<int>(std::ceil(center + support));
+
+            const int clampedFirst = std::max(first, 0);
+            const int clampedLast = std::min(last, static_cast<int>(sourceSize) - 1);
+            taps[d].First = static_cast<uint32_t>(clampedFirst);
+            taps[d].Weights.assign(clampedLast - clampedFirst + 1, 0.0f);
+
+            float weightSum = 0;
+            for (int s = first; s <= last; s++) {
+                float weight;
+                if (filter == Pbr::MipFilter::Kaiser) {
+                    weight = KaiserSinc((s + 0.5f - center) / filterScale);
+                } else {
+                    // The part of the source texel covered by the footprint of the destination texel.
+                    weight = std::max(0.0f, std::min<float>(s + 1, center + support) - std::max<float>(s, center - support));
+                }
+
+                const int clamped = std::clamp(s, clampedFirst, clampedLast);
+                taps[d].Weights[clamped - clampedFirst] += weight;
+                weightSum += weight;
+            }
+
+            for (float& weight : taps[d].Weights) {
+                weight /= weightSum;
+            }
+        }
+
+        return taps;
+    }
+
+    // Resamples the image with a separable filter, first along rows and then along columns.
+    FloatImage Resample(const FloatImage& source,
+                        uint32_t sourceWidth,
+                        uint32_t sourceHeight,
+                        uint32_t destinationWidth,
+                        uint32_t destinationHeight,
+                        Pbr::MipFilter filter) {
+        const std::vector<FilterTaps> horizontalTaps = ComputeFilterTaps(sourceWidth, destinationWidth, filter);
+        const std::vector<FilterTaps> verticalTaps = ComputeFilterTaps(sourceHeight, destinationHeight, filter);
+
+        FloatImage horizontal(static_cast<size_t>(destinationWidth) * sourceHeight);
+        Pbr::Internal::ParallelForBands(sourceHeight, destinationWidth, [&](uint32_t beginRow, uint32_t endRow) {
+            for (uint32_t y = beginRow; y < endRow; y++) {
+                const XMFLOAT4A* sourceRow = source.data() + static_cast<size_t>(y) * sourceWidth;
+                XMFLOAT4A* destinationRow = horizontal.data() + static_cast<size_t>(y) * destinationWidth;
+                for (uint32_t x = 0; x < destinationWidth; x++) {
+                    const FilterTaps& taps = horizontalTaps[x];
+                    XMVECTOR sum = XMVectorZero();
+                    for (size_t i = 0; i < taps.Weights.size(); i++) {
+                        sum = XMVectorMultiplyAdd(XMLoadFloat4A(&sourceRow[taps.First + i]), XMVectorReplicate(taps.Weights[i]), sum);
+                    }
+                    XMStoreFloat4A(&destinationRow[x], sum);
+                }
+            }
+        });
+
+        // Each destination row is a weighted sum of whole intermediate rows, which walks memory in order.
+        FloatImage destination(static_cast<size_t>(destinationWidth) * destinationHeight);
+        Pbr::Internal::ParallelForBands(destinationHeight, destinationWidth, [&](uint32_t beginRow, uint32_t endRow) {
+            for (uint32_t y = beginRow; y < endRow; y++) {
+                const FilterTaps& taps = verticalTaps[y];
+                XMFLOAT4A* destinationRow = destination.data() + static_cast<size_t>(y) * destinationWidth;
+                for (size_t i = 0; i < taps.Weights.size(); i++) {
+                    const XMFLOAT4A* sourceRow = horizontal.data() + static_cast<size_t>(taps.First + i) * destinationWidth;
+                    const XMVECTOR weight = XMVectorReplicate(taps.Weights[i]);
+                    for (uint32_t x = 0; x < destinationWidth; x++) {
+                        const XMVECTOR sum = i == 0 ? XMVectorZero() : XMLoadFloat4A(&destinationRow[x]);
+                        XMStoreFloat4A(&destinationRow[x], XMVectorMultiplyAdd(XMLoadFloat4A(&sourceRow[x]), weight, sum));
+                    }
+                }
+            }
+        });
+
+        return destination;
+    }
+
+    FloatImage ToFloatImage(const uint8_t* rgba, uint32_t width, uint32_t height, bool sRGB) {
+        // Decoding through a table is exact for 8 bit inputs and much cheaper than evaluating the sRGB curve per texel.
+        std::array<float, 256> toLinear;
+        for (uint32_t i = 0; i < 256; i++) {
+            const float value = i / 255.0f;
+            toLinear[i] = sRGB ? (value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f)) : value;
+        }
+
+        FloatImage image(static_cast<size_t>(width) * height);
+        for (size_t i = 0; i < image.size(); i++) {
+            const uint8_t* texel = rgba + i * 4;
+            image[i] = XMFLOAT4A(toLinear[texel[0]], toLinear[texel[1]], toLinear[texel[2]], texel[3] / 255.0f);
+        }
+        return image;
+    }
+
+    void StoreLevel(const FloatImage& image, bool sRGB, uint8_t* rgba) {
+        for (size_t i = 0; i < image.size(); i++) {
+            XMVECTOR texel = XMVectorSaturate(XMLoadFloat4A(&image[i]));
+            if (sRGB) {
+                texel = XMColorRGBToSRGB(texel); // Leaves alpha unchanged.
+            }
+
+            // Round to the nearest value, the normalized store would truncate.
+            PackedVector::XMUBYTE4 packed;
+            PackedVector::XMStoreUByte4(&packed, XMVectorRound(XMVectorScale(texel, 255)));
+            memcpy(rgba + i * 4, &packed, 4);
+        }
+    }
+
+    uint32_t NextPowerOfTwo(uint32_t value) {
+        uint32_t powerOfTwo = 1;
+        while (powerOfTwo < value) {
+            powerOfTwo <<= 1;
+        }
+        return powerOfTwo;
+    }
+} // namespace
+
+namespace Pbr {
+    uint32_t MipLevelCount(uint32_t width, uint32_t height) {
+        uint32_t levelCount = 1;
+        for (uint32_t size = std::max(width, height); size > 1; size >>= 1) {
+            levelCount++;
+        }
+        return levelCount;
+    }
+
+    MipChain GenerateMipChain(_In_reads_bytes_(width* height * 4) const uint8_t* rgba,
+                              uint32_t width,
+                              uint32_t height,
+                              const MipChainOptions& options) {
+        if (width == 0 || height == 0) {
+            throw std::invalid_argument("Cannot generate the mip chain of an empty image.");
+        }
+
+        FloatImage level = ToFloatImage(rgba, width, height, options.SRGB);
+        bool resized = false;
+        if (options.ResizeToPowerOfTwo) {
+            const uint32_t resizedWidth = NextPowerOfTwo(width);
+            const uint32_t resizedHeight = NextPowerOfTwo(height);
+            if (resizedWidth != width || resizedHeight != height) {
+                level = Resample(level, width, height, resizedWidth, resizedHeight, options.Filter);
+                width = resizedWidth;
+                height = resizedHeight;
+                resized = true;
+            }
+        }
+
+        const uint32_t fullLevelCount = MipLevelCount(width, height);
+        const uint32_t levelCount = options.MaxLevelCount == 0 ? fullLevelCount : std::min(options.MaxLevelCount, fullLevelCount);
+
+        MipChain chain;
+        chain.Levels.resize(levelCount);
+        size_t dataSize = 0;
+        for (uint32_t i = 0; i < levelCount; i++) {
+            chain.Levels[i].Width = std::max(width >> i, 1u);
+            chain.Levels[i].Height = std::max(height >> i, 1u);
+            chain.Levels[i].Offset = dataSize;
+            dataSize += static_cast<size_t>(chain.Levels[i].Width) * chain.Levels[i].Height * 4;
+        }
+        chain.Data.resize(dataSize);
+
+        // The most detailed level keeps the source texels unless it was resized.
+        if (resized) {
+            StoreLevel(level, options.SRGB, chain.Data.data());
+        } else {
+            memcpy(chain.Data.data(), rgba, static_cast<size_t>(width) * height * 4);
+        }
+
+        // Each level is filtered from the previous one in floating point. Odd sizes are handled by the filter footprints,
+        // which cover fractional source texels.
+        for (uint32_t i = 1; i < levelCount; i++) {
+            const MipLevel& previous = chain.Levels[i - 1];
+            const MipLevel& current = chain.Levels[i];
+            level = Resample(level, previous.Width, previous.Height, current.Width, current.Height, options.Filter);
+            StoreLevel(level, options.SRGB, chain.Data.data() + current.Offset);
+        }
+
+        return chain;
+    }
+} // namespace Pbr
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// CPU generation of texture mip chains.
+//
+
+#pragma once
+
+#include <vector>
+
+namespace Pbr {
+    enum class MipFilter {
+        Box,    // Averages the source texels covered by each destination texel. Fast, slightly blurry.
+        Kaiser, // Kaiser-windowed sinc over three destination texels. Keeps more detail, at about four times the cost.
+    };
+
+    struct MipChainOptions {
+        // The texels are sRGB encoded. They are filtered in linear space and encoded again, so that minified colors keep
+        // their brightness. Use false for data such as normal and metallic-roughness maps. Alpha is always linear.
+        bool SRGB{false};
+        MipFilter Filter{MipFilter::Box};
+
+        // Resample the image to the next larger power of two in each dimension before building the chain, so every level
+        // is exactly half the size of the previous one.
+        bool ResizeToPowerOfTwo{false};
+
+        // The number of levels to generate, or 0 for the full chain down to 1x1.
+        uint32_t MaxLevelCount{0};
+    };
+
+    struct MipLevel {
+        uint32_t Width{0};
+        uint32_t Height{0};
+        size_t Offset{0}; // Byte offset of the level in MipChain::Data
+    };
+
+    // The RGBA texels of all levels of a texture, most detailed level first, with rows tightly packed.
+    struct MipChain {
+        std::vector<MipLevel> Levels;
+        std::vector<uint8_t> Data;
+
+        const uint8_t* LevelData(size_t level) const {
+            return Data.data() + Levels[level].Offset;
+        }
+        uint32_t RowPitch(size_t level) const {
+            return Levels[level].Width * 4;
+        }
+    };
+
+    // The number of levels of a full mip chain for the given size.
+    uint32_t MipLevelCount(uint32_t width, uint32_t height);
+
+    // Builds the mip chain of an RGBA image. Large levels are filtered in bands on several threads.
+    MipChain GenerateMipChain(_In_reads_bytes_(width* height * 4) const uint8_t* rgba,
+                              uint32_t width,
+                              uint32_t height,
+                              const MipChainOptions& options);
+} // namespace Pbr
@@ -2,6 +2,7 @@
 // Copyright (C) Microsoft Corporation.  All Rights Reserved
 // Licensed under the MIT License. See License.txt in the project root for license information.
 #include "pch.h"
+#include <algorithm>
 #include "PbrCommon.h"
 #include "PbrModel.h"
 
@@ -31,13 +32,20 @@ namespace Pbr
         ID3D11ShaderResourceView* vsShaderResources[] = { m_modelTransformsResourceView.get() };
         context->VSSetShaderResources(Pbr::ShaderSlots::Transforms, _countof(vsShaderResources), vsShaderResources);
 
+        // The atlas variant of the pixel shader only replaces the regular one.
+        if (m_materialAtlas && pbrResources.GetShadingMode() == ShadingMode::Regular)
+        {
+            m_materialAtlas->Render(pbrResources, context, m_primitives);
+            return;
+        }
+
         for (const Pbr::Primitive& primitive : m_primitives)
         {
             if (primitive.GetMaterial()->Hidden) continue;
 
             primitive.GetMaterial()->SetWireframe(pbrResources.GetFillMode() == FillMode::Wireframe);
             primitive.GetMaterial()->Bind(context, pbrResources);
-            primitive.Render(context);
+            primitive.Render(context, pbrResources.GetViewInstanceCount());
         }
 
         // Expect the caller to reset other state, but the geometry shader is cleared specially.
@@ -60,6 +68,21 @@ namespace Pbr
     void Model::Clear()
     {
         m_primitives.clear();
+        m_materialAtlas = nullptr;
+    }
+
+    void Model::BuildMaterialAtlas(Pbr::Resources const& pbrResources, _In_ ID3D11DeviceContext* context)
+    {
+        std::vector<std::shared_ptr<Material>> materials;
+        for (const Primitive& primitive : m_primitives)
+        {
+            if (std::find(materials.begin(), materials.end(), primitive.GetMaterial()) == materials.end())
+            {
+                materials.push_back(primitive.GetMaterial());
+            }
+        }
+
+        m_materialAtlas = std::make_shared<MaterialAtlas>(pbrResources, context, std::move(materials));
     }
 
     std::shared_ptr<Model> Model::Clone(Pbr::Resources const& pbrResources) const
@@ -107,50 +130,34 @@ namespace Pbr
 
     void Model::UpdateTransforms(Pbr::Resources const& pbrResources, _In_ ID3D11DeviceContext* context) const
     {
-        const uint32_t newTotalModifyCount = std::accumulate(
-            m_nodes.begin(),
-            m_nodes.end(),
-            0,
-            [](uint32_t sumChangeCount, const Node& node) { return sumChangeCount + node.m_modifyCount; });
-
-        // If none of the node transforms have changed, no need to recompute/update the model transform structured buffer.
-        if (newTotalModifyCount != TotalModifyCount || m_modelTransformsStructuredBuffer == nullptr)
-        {
-            if (m_modelTransformsStructuredBuffer == nullptr) // The structured buffer is reset when a Node is added.
-            {
-                m_modelTransforms.resize(m_nodes.size());
-
-                // Create/recreate the structured buffer and SRV which holds the node transforms.
-                // Use Usage=D3D11_USAGE_DYNAMIC and CPUAccessFlags=D3D11_CPU_ACCESS_WRITE with Map/Unmap instead?
-                D3D11_BUFFER_DESC desc{};
-                desc.Usage = D3D11_USAGE_DEFAULT;
-                desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-                desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
-                desc.StructureByteStride = sizeof(decltype(m_modelTransforms)::value_type);
-                desc.ByteWidth = (UINT)(m_modelTransforms.size() * desc.StructureByteStride);
-                m_modelTransformsStructuredBuffer = nullptr;
-                Internal::ThrowIfFailed(pbrResources.GetDevice()->CreateBuffer(&desc, nullptr, m_modelTransformsStructuredBuffer.put()));
-
-                D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-                srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
-                srvDesc.Buffer.NumElements = (UINT)m_modelTransforms.size();
-                srvDesc.Buffer.ElementWidth = (UINT)m_modelTransforms.size();
-                m_modelTransformsResourceView = nullptr;
-                Internal::ThrowIfFailed(pbrResources.GetDevice()->CreateShaderResourceView(m_modelTransformsStructuredBuffer.get(), &srvDesc, m_modelTransformsResourceView.put()));
-            }
+        // If none of the node transforms have changed, no need to update the model transform structured buffer.
+        bool upload = m_modelTransforms.Update(m_nodes);
 
-            // Nodes are guaranteed to come after their parents, so each node transform can be multiplied by its parent transform in a single pass.
-            assert(m_nodes.size() == m_modelTransforms.size());
-            for (const auto& node : m_nodes)
-            {
-                assert(node.ParentNodeIndex == RootParentNodeIndex || node.ParentNodeIndex < node.Index);
-                const XMMATRIX parentTransform = (node.ParentNodeIndex == RootParentNodeIndex) ? XMMatrixIdentity() : XMLoadFloat4x4(&m_modelTransforms[node.ParentNodeIndex]);
-                XMStoreFloat4x4(&m_modelTransforms[node.Index], XMMatrixMultiply(parentTransform, XMMatrixTranspose(node.GetTransform())));
-            }
+        if (m_modelTransformsStructuredBuffer == nullptr) // The structured buffer is reset when a Node is added.
+        {
+            // Create/recreate the structured buffer and SRV which holds the node transforms.
+            // Use Usage=D3D11_USAGE_DYNAMIC and CPUAccessFlags=D3D11_CPU_ACCESS_WRITE with Map/Unmap instead?
+            D3D11_BUFFER_DESC desc{};
+            desc.Usage = D3D11_USAGE_DEFAULT;
+            desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+            desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+            desc.StructureByteStride = sizeof(XMFLOAT4X4);
+            desc.ByteWidth = (UINT)(m_nodes.size() * desc.StructureByteStride);
+            Internal::ThrowIfFailed(pbrResources.GetDevice()->CreateBuffer(&desc, nullptr, m_modelTransformsStructuredBuffer.put()));
+
+            D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+            srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+            srvDesc.Buffer.NumElements = (UINT)m_nodes.size();
+            srvDesc.Buffer.ElementWidth = (UINT)m_nodes.size();
+            m_modelTransformsResourceView = nullptr;
+            Internal::ThrowIfFailed(pbrResources.GetDevice()->CreateShaderResourceView(m_modelTransformsStructuredBuffer.get(), &srvDesc, m_modelTransformsResourceView.put()));
+            upload = true;
+        }
 
-            // Update node transform structured buffer.
-            context->UpdateSubresource(m_modelTransformsStructuredBuffer.get(), 0, nullptr, this->m_modelTransforms.data(), 0, 0);
-            TotalModifyCount = newTotalModifyCount;
+        // Update node transform structured buffer.
+        if (upload)
+        {
+            context->UpdateSubresource(m_modelTransformsStructuredBuffer.get(), 0, nullptr, m_modelTransforms.Transforms().data(), 0, 0);
         }
     }
 }
@@ -13,40 +13,9 @@
 #include "PbrCommon.h"
 #include "PbrResources.h"
 #include "PbrPrimitive.h"
+#include "PbrMaterialAtlas.h"
 
 namespace Pbr {
-    // Node for creating a hierarchy of transforms. These transforms are referenced by vertices in the model's primitives.
-    struct Node {
-        using Collection = std::vector<Node>;
-
-        Node(DirectX::CXMMATRIX localTransform, std::string name, NodeIndex_t index, NodeIndex_t parentNodeIndex)
-            : Name(std::move(name))
-            , Index(index)
-            , ParentNodeIndex(parentNodeIndex) {
-            SetTransform(localTransform);
-        }
-
-        // Set the local transform for this node.
-        void XM_CALLCONV SetTransform(DirectX::FXMMATRIX transform) {
-            DirectX::XMStoreFloat4x4(&m_localTransform, transform);
-            InterlockedIncrement(&m_modifyCount);
-        }
-
-        // Get the local transform for this node.
-        DirectX::XMMATRIX XM_CALLCONV GetTransform() const {
-            return DirectX::XMLoadFloat4x4(&m_localTransform);
-        }
-
-        const std::string Name;
-        const NodeIndex_t Index;
-        const NodeIndex_t ParentNodeIndex;
-
-    private:
-        friend struct Model;
-        uint32_t m_modifyCount{0};
-        DirectX::XMFLOAT4X4 m_localTransform;
-    };
-
     // A model is a collection of primitives (which reference a material) and transforms referenced by the primitives' vertices.
     struct Model final {
         std::string Name;
@@ -66,6 +35,14 @@ namespace Pbr {
         // Remove all primitives.
         void Clear();
 
+        // Pack the textures of the materials of the primitives into texture arrays, so that the model is drawn with fewer
+        // binding changes. Must be called on the thread owning the context, once the model is fully loaded. Primitives added
+        // or materials changed later are drawn as before.
+        void BuildMaterialAtlas(Pbr::Resources const& pbrResources, _In_ ID3D11DeviceContext* context);
+        const MaterialAtlas* GetMaterialAtlas() const {
+            return m_materialAtlas.get();
+        }
+
         // Create a clone of this model.
         std::shared_ptr<Model> Clone(Pbr::Resources const& pbrResources) const;
 
@@ -108,11 +85,12 @@ namespace Pbr {
         // node's transform applied.
         Node::Collection m_nodes;
 
-        // Temporary buffer holds the world transforms, computed from the node's local transforms.
-        mutable std::vector<DirectX::XMFLOAT4X4> m_modelTransforms;
+        // The transforms relative to the root, computed from the node's local transforms.
+        mutable NodeTransforms m_modelTransforms;
         mutable winrt::com_ptr<ID3D11Buffer> m_modelTransformsStructuredBuffer;
         mutable winrt::com_ptr<ID3D11ShaderResourceView> m_modelTransformsResourceView;
 
-        mutable uint32_t TotalModifyCount{0};
+        // Optional, see BuildMaterialAtlas. Not cloned, since clones have their own materials.
+        std::shared_ptr<MaterialAtlas> m_materialAtlas;
     };
 } // namespace Pbr
@@ -56,6 +56,25 @@ namespace {
         Pbr::Internal::ThrowIfFailed(device->CreateBuffer(&desc, &initData, indexBuffer.put()));
         return indexBuffer;
     }
+
+    winrt::com_ptr<ID3D11Buffer> CreateDynamicBuffer(_In_ ID3D11Device* device, UINT byteWidth, UINT bindFlags) {
+        D3D11_BUFFER_DESC desc{};
+        desc.Usage = D3D11_USAGE_DYNAMIC;
+        desc.ByteWidth = byteWidth;
+        desc.BindFlags = bindFlags;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+        winrt::com_ptr<ID3D11Buffer> buffer;
+        Pbr::Internal::ThrowIfFailed(device->CreateBuffer(&desc, nullptr, buffer.put()));
+        return buffer;
+    }
+
+    void WriteDiscard(_In_ ID3D11DeviceContext* context, _In_ ID3D11Buffer* buffer, const void* data, size_t byteSize) {
+        D3D11_MAPPED_SUBRESOURCE mapped{};
+        Pbr::Internal::ThrowIfFailed(context->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+        memcpy(mapped.pData, data, byteSize);
+        context->Unmap(buffer, 0);
+    }
 } // namespace
 
 namespace Pbr {
@@ -79,8 +98,39 @@ namespace Pbr {
                     std::move(material)) {
     }
 
+    Primitive::Primitive(Pbr::Resources const& pbrResources,
+                         UINT vertexCapacity,
+                         UINT indexCapacity,
+                         std::shared_ptr<Material> material,
+                         UINT vertexBufferCount)
+        : m_indexCount(0)
+        , m_material(std::move(material))
+        , m_vertexCapacity(vertexCapacity)
+        , m_indexCapacity(indexCapacity) {
+        assert(vertexCapacity > 0 && indexCapacity > 0 && vertexBufferCount > 0);
+
+        ID3D11Device* const device = pbrResources.GetDevice().get();
+        m_indexBuffer = CreateDynamicBuffer(device, (UINT)(indexCapacity * sizeof(uint32_t)), D3D11_BIND_INDEX_BUFFER);
+        m_vertexBufferRing.reserve(vertexBufferCount);
+        for (UINT i = 0; i < vertexBufferCount; i++) {
+            m_vertexBufferRing.push_back(CreateDynamicBuffer(device, GetPbrVertexByteSize(vertexCapacity), D3D11_BIND_VERTEX_BUFFER));
+        }
+        m_vertexBuffer = m_vertexBufferRing[0];
+    }
+
+    Material& Primitive::GetMaterialForEdit() {
+        if (m_material->IsShared()) {
+            winrt::com_ptr<ID3D11Device> device;
+            m_vertexBuffer->GetDevice(device.put());
+            m_material = m_material->Clone(device.get());
+        }
+        return *m_material;
+    }
+
     Primitive Primitive::Clone(Pbr::Resources const& pbrResources) const {
-        return Primitive(m_indexCount, m_indexBuffer, m_vertexBuffer, m_material->Clone(pbrResources));
+        Primitive clone(m_indexCount, m_indexBuffer, m_vertexBuffer, m_material->Clone(pbrResources));
+        clone.m_extent = m_extent;
+        return clone;
     }
 
     void Primitive::UpdateBuffers(_In_ ID3D11Device* device,
@@ -115,13 +165,33 @@ namespace Pbr {
         }
     }
 
-    void Primitive::Render(_In_ ID3D11DeviceContext* context) const {
+    void Primitive::UpdateVertices(_In_ ID3D11DeviceContext* context, const Pbr::Vertex* vertices, UINT vertexCount) {
+        assert(!m_vertexBufferRing.empty() && vertexCount <= m_vertexCapacity);
+
+        m_vertexRingIndex = (m_vertexRingIndex + 1) % (UINT)m_vertexBufferRing.size();
+        const winrt::com_ptr<ID3D11Buffer>& vertexBuffer = m_vertexBufferRing[m_vertexRingIndex];
+        WriteDiscard(context, vertexBuffer.get(), vertices, GetPbrVertexByteSize(vertexCount));
+        m_vertexBuffer = vertexBuffer;
+    }
+
+    void Primitive::UpdateIndices(_In_ ID3D11DeviceContext* context, const uint32_t* indices, UINT indexCount) {
+        assert(!m_vertexBufferRing.empty() && indexCount <= m_indexCapacity);
+
+        WriteDiscard(context, m_indexBuffer.get(), indices, indexCount * sizeof(uint32_t));
+        m_indexCount = indexCount;
+    }
+
+    void Primitive::Render(_In_ ID3D11DeviceContext* context, UINT viewInstanceCount) const {
+        if (m_indexCount == 0 || viewInstanceCount == 0) {
+            return; // A streaming primitive that hasn't received geometry yet, or no view to render.
+        }
+
         const UINT stride = sizeof(Pbr::Vertex);
         const UINT offset = 0;
         ID3D11Buffer* const vertexBuffers[] = {m_vertexBuffer.get()};
         context->IASetVertexBuffers(0, 1, vertexBuffers, &stride, &offset);
         context->IASetIndexBuffer(m_indexBuffer.get(), DXGI_FORMAT_R32_UINT, 0);
         context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        context->DrawIndexedInstanced(m_indexCount, 1, 0, 0, 0);
+        context->DrawIndexedInstanced(m_indexCount, viewInstanceCount, 0, 0, 0);
     }
 } // namespace Pbr
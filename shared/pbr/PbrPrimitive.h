@@ -3,6 +3,7 @@
 // Licensed under the MIT License. See License.txt in the project root for license information.
 #pragma once
 
+#include <optional>
 #include <vector>
 #include <winrt/base.h>
 #include <d3d11.h>
@@ -14,6 +15,13 @@ namespace Pbr {
     struct Primitive final {
         using Collection = std::vector<Primitive>;
 
+        // Where the primitive is in its model, and how densely its texture coordinates cover it, see ComputePrimitiveExtent.
+        struct Extent {
+            DirectX::XMFLOAT3 Center{0, 0, 0};
+            float Radius{0};
+            float UvDensity{0}; // Texture coordinate units per meter, 0 if unknown
+        };
+
         Primitive() = delete;
         Primitive(UINT indexCount,
                   winrt::com_ptr<ID3D11Buffer> indexBuffer,
@@ -24,8 +32,23 @@ namespace Pbr {
                   std::shared_ptr<Material> material,
                   bool updatableBuffers = false);
 
+        // Creates a primitive with empty dynamic buffers for geometry that changes every frame.
+        // Its geometry is streamed with UpdateVertices and UpdateIndices.
+        // The vertices cycle through a ring of write-discard buffers so an update never has to wait for the draw of a previous frame.
+        Primitive(Pbr::Resources const& pbrResources,
+                  UINT vertexCapacity,
+                  UINT indexCapacity,
+                  std::shared_ptr<Material> material,
+                  UINT vertexBufferCount = 3);
+
         void UpdateBuffers(_In_ ID3D11Device* device, _In_ ID3D11DeviceContext* context, const Pbr::PrimitiveBuilder& primitiveBuilder);
 
+        // Uploads the vertices of a streaming primitive to the next buffer of the ring. The count must not exceed the vertex capacity.
+        void UpdateVertices(_In_ ID3D11DeviceContext* context, const Pbr::Vertex* vertices, UINT vertexCount);
+
+        // Uploads the indices of a streaming primitive. Only needed when the topology changes, the indices persist across vertex updates.
+        void UpdateIndices(_In_ ID3D11DeviceContext* context, const uint32_t* indices, UINT indexCount);
+
         // Get the material for the primitive.
         std::shared_ptr<Material>& GetMaterial() {
             return m_material;
@@ -34,9 +57,23 @@ namespace Pbr {
             return m_material;
         }
 
+        // Get the material for the primitive to edit it. A shared material is replaced by a copy first, so that the edit
+        // doesn't change the other models using it.
+        Material& GetMaterialForEdit();
+
+        // The extent the streamed textures of the primitive are chosen by, see TextureResidency. Unknown unless set.
+        const std::optional<Extent>& GetExtent() const {
+            return m_extent;
+        }
+        void SetExtent(const Extent& extent) {
+            m_extent = extent;
+        }
+
     protected:
         friend struct Model;
-        void Render(_In_ ID3D11DeviceContext* context) const;
+        friend class MaterialAtlas;
+        // Draws the primitive once for each view instance, see Resources::SetViewProjections.
+        void Render(_In_ ID3D11DeviceContext* context, UINT viewInstanceCount = 1) const;
         Primitive Clone(Pbr::Resources const& pbrResources) const;
 
     private:
@@ -44,5 +81,12 @@ namespace Pbr {
         winrt::com_ptr<ID3D11Buffer> m_indexBuffer;
         winrt::com_ptr<ID3D11Buffer> m_vertexBuffer;
         std::shared_ptr<Material> m_material;
+        std::optional<Extent> m_extent;
+
+        // Only used by streaming primitives. m_vertexBuffer refers to the most recently written buffer of the ring.
+        std::vector<winrt::com_ptr<ID3D11Buffer>> m_vertexBufferRing;
+        UINT m_vertexRingIndex{0};
+        UINT m_vertexCapacity{0};
+        UINT m_indexCapacity{0};
     };
 } // namespace Pbr
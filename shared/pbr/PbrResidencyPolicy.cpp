@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+// Doesn't use the precompiled header, which includes Windows headers, so that it builds on any platform.
+#include <algorithm>
+#include <cmath>
+#include "PbrResidencyPolicy.h"
+
+using namespace DirectX;
+
+namespace {
+    // Closer than this, the distance to a primitive is taken to be this, so that a camera inside its bounds doesn't need
+    // levels finer than the most detailed one.
+    constexpr float MinDistance = 0.01f;
+
+    // Whether the sphere, in view space, is at least partly inside the field of view of the view.
+    bool IsInView(const Pbr::ResidencyView& view, FXMVECTOR center, float radius) {
+        // The inward normals of the four sides of the view frustum, which pass through the origin of the view space.
+        const XMVECTOR normals[] = {
+            XMVectorSet(std::cos(view.AngleLeft), 0, std::sin(view.AngleLeft), 0),
+            XMVectorSet(-std::cos(view.AngleRight), 0, -std::sin(view.AngleRight), 0),
+            XMVectorSet(0, -std::cos(view.AngleUp), -std::sin(view.AngleUp), 0),
+            XMVectorSet(0, std::cos(view.AngleDown), std::sin(view.AngleDown), 0),
+        };
+
+        return std::all_of(std::begin(normals), std::end(normals), [&](FXMVECTOR normal) {
+            return XMVectorGetX(XMVector3Dot(normal, center)) >= -radius;
+        });
+    }
+} // namespace
+
+namespace Pbr {
+    float EstimateRequiredMip(const ResidencyView& view,
+                              FXMVECTOR center,
+                              float radius,
+                              float uvDensity,
+                              uint32_t textureSize,
+                              float offscreenMipBias) {
+        if (uvDensity <= 0 || textureSize == 0 || view.Width == 0 || view.Height == 0) {
+            return 0;
+        }
+
+        const XMVECTOR viewCenter =
+            XMVector3InverseRotate(XMVectorSubtract(center, XMLoadFloat3(&view.Position)), XMLoadFloat4(&view.Orientation));
+        const float distance = std::max(XMVectorGetX(XMVector3Length(viewCenter)) - radius, MinDistance);
+
+        // The size of a pixel at the distance, along the axis with the smaller pixels.
+        const float pixelAngle = std::min((std::tan(view.AngleRight) - std::tan(view.AngleLeft)) / view.Width,
+                                          (std::tan(view.AngleUp) - std::tan(view.AngleDown)) / view.Height);
+        const float pixelSize = distance * pixelAngle;
+
+        // The texels of level m are 2^m / (textureSize * uvDensity) meters wide.
+        float mip = std::log2(pixelSize * textureSize * uvDensity);
+        if (!IsInView(view, viewCenter, radius)) {
+            mip += offscreenMipBias;
+        }
+        return mip;
+    }
+
+    ResidencyPolicy::ResidencyPolicy(const ResidencyOptions& options)
+        : m_options(options) {
+    }
+
+    uint32_t ResidencyPolicy::AddTexture(std::vector<size_t> levelBytes, uint32_t tailMip) {
+        const uint32_t id = m_nextId++;
+        Texture& texture = m_textures[id];
+        texture.LevelBytes = std::move(levelBytes);
+        texture.TailMip = std::min(tailMip, static_cast<uint32_t>(texture.LevelBytes.size() - 1));
+        texture.ResidentMip = texture.TargetMip = texture.NeededMip = texture.TailMip;
+        return id;
+    }
+
+    void ResidencyPolicy::RemoveTexture(uint32_t id) {
+        m_textures.erase(id);
+    }
+
+    void ResidencyPolicy::Request(uint32_t id, float mip) {
+        Texture& texture = m_textures.at(id);
+        texture.RequestedMip = std::min(texture.RequestedMip, mip);
+    }
+
+    size_t ResidencyPolicy::Bytes(const Texture& texture, uint32_t mip) {
+        size_t bytes = 0;
+        for (size_t level = mip; level < texture.LevelBytes.size(); level++) {
+            bytes += texture.LevelBytes[level];
+        }
+        return bytes;
+    }
+
+    void ResidencyPolicy::Plan() {
+        // The cost of dropping the finest target level of a texture: the bytes it frees, less for every level the texture
+        // already lost. A texture keeping levels it doesn't need loses them first.
+        const auto dropPriority = [](const Texture& texture) {
+            const int lostLevels = static_cast<int>(texture.TargetMip) - static_cast<int>(texture.NeededMip);
+            return static_cast<double>(texture.LevelBytes[texture.TargetMip]) * std::pow(4.0, -lostLevels);
+        };
+
+        size_t targetBytes = 0;
+        m_dropQueue.clear();
+        for (auto& [id, texture] : m_textures) {
+            const float neededMip = std::clamp(std::floor(texture.RequestedMip), 0.0f, static_cast<float>(texture.TailMip));
+            texture.NeededMip = static_cast<uint32_t>(neededMip);
+            texture.RequestedMip = std::numeric_limits<float>::infinity();
+
+            texture.TargetMip = texture.NeededMip;
+            if (texture.ResidentMip < texture.NeededMip && texture.NeededMip <= texture.ResidentMip + m_options.Hysteresis) {
+                texture.TargetMip = texture.ResidentMip;
+            }
+
+            targetBytes += Bytes(texture, texture.TargetMip);
+            if (texture.TargetMip < texture.TailMip) {
+                m_dropQueue.emplace_back(dropPriority(texture), id);
+            }
+        }
+
+        std::make_heap(m_dropQueue.begin(), m_dropQueue.end());
+        while (targetBytes > m_options.BudgetBytes && !m_dropQueue.empty()) {
+            std::pop_heap(m_dropQueue.begin(), m_dropQueue.end());
+            const uint32_t id = m_dropQueue.back().second;
+            m_dropQueue.pop_back();
+
+            Texture& texture = m_textures.at(id);
+            targetBytes -= texture.LevelBytes[texture.TargetMip];
+            texture.TargetMip++;
+            if (texture.TargetMip < texture.TailMip) {
+                m_dropQueue.emplace_back(dropPriority(texture), id);
+                std::push_heap(m_dropQueue.begin(), m_dropQueue.end());
+            }
+        }
+    }
+
+    uint32_t ResidencyPolicy::TargetMip(uint32_t id) const {
+        return m_textures.at(id).TargetMip;
+    }
+
+    uint32_t ResidencyPolicy::ResidentMip(uint32_t id) const {
+        return m_textures.at(id).ResidentMip;
+    }
+
+    void ResidencyPolicy::SetResidentMip(uint32_t id, uint32_t mip) {
+        m_textures.at(id).ResidentMip = mip;
+    }
+
+    ResidencyStatistics ResidencyPolicy::Statistics() const {
+        ResidencyStatistics statistics;
+        statistics.TextureCount = static_cast<uint32_t>(m_textures.size());
+        statistics.BudgetBytes = m_options.BudgetBytes;
+        for (const auto& [id, texture] : m_textures) {
+            statistics.ResidentBytes += Bytes(texture, texture.ResidentMip);
+            statistics.TargetBytes += Bytes(texture, texture.TargetMip);
+            if (texture.TargetMip > texture.NeededMip) {
+                statistics.DegradedCount++;
+            }
+        }
+        return statistics;
+    }
+} // namespace Pbr
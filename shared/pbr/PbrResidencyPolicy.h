@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// The policy choosing the resident mip levels of streamed textures (see PbrTextureResidency.h), within a memory budget.
+// Textures are only known by the bytes of their levels, so this doesn't need a device and can be driven by synthetic
+// views. Only needs the standard library and DirectXMath, so it builds on any platform.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+#include <DirectXMath.h>
+
+namespace Pbr {
+    // A view the textures are seen from, in world space. The angles are those of an XrFovf, in radians.
+    struct ResidencyView {
+        DirectX::XMFLOAT3 Position{0, 0, 0};
+        DirectX::XMFLOAT4 Orientation{0, 0, 0, 1}; // Looking down -z, with y up
+        float AngleLeft{0};
+        float AngleRight{0};
+        float AngleUp{0};
+        float AngleDown{0};
+        uint32_t Width{0}; // Of the viewport, in pixels
+        uint32_t Height{0};
+    };
+
+    struct ResidencyOptions {
+        // The GPU memory all streamed textures together may use.
+        size_t BudgetBytes{256 * 1024 * 1024};
+
+        // Levels of at most this many texels in width and height are always resident, and are shown while finer levels
+        // stream in.
+        uint32_t TailTexels{64};
+
+        // The levels dropped from the need of textures outside every view, so that they are still sharp enough when the
+        // user turns towards them.
+        float OffscreenMipBias{2};
+
+        // A texture keeps up to this many levels finer than it needs, while within the budget, so that textures seen
+        // at a distance close to a level boundary are not streamed in and out every few frames.
+        uint32_t Hysteresis{1};
+    };
+
+    // The mip level a texture needs when a primitive with the extent, in world space, is seen from the view: the level
+    // whose texels are the size of a pixel. Negative if the most detailed level is magnified. A primitive with unknown UV
+    // density needs level 0.
+    float EstimateRequiredMip(const ResidencyView& view,
+                              DirectX::FXMVECTOR center,
+                              float radius,
+                              float uvDensity,
+                              uint32_t textureSize,
+                              float offscreenMipBias);
+
+    struct ResidencyStatistics {
+        uint32_t TextureCount{0};
+        uint32_t DegradedCount{0}; // Textures whose target level is coarser than they need, to fit the budget
+        uint32_t PendingCount{0};  // Textures whose levels are streaming in or out
+        uint32_t FailedCount{0};   // Level changes which could not create the texture, kept at their levels
+        size_t ResidentBytes{0};
+        size_t TargetBytes{0};
+        size_t BudgetBytes{0};
+    };
+
+    // Chooses the resident levels of textures. Each frame, the levels the textures need are requested, then Plan chooses
+    // the target levels: those needed, coarsened within the budget. Levels are dropped first from the textures where a
+    // level frees the most memory, and least from textures which already lost levels.
+    class ResidencyPolicy {
+    public:
+        explicit ResidencyPolicy(const ResidencyOptions& options = {});
+
+        // Adds a texture with the bytes of each level, most detailed first, whose levels from tailMip on are always
+        // resident. Only the tail is resident at first. Returns its id.
+        uint32_t AddTexture(std::vector<size_t> levelBytes, uint32_t tailMip);
+        void RemoveTexture(uint32_t id);
+
+        // Requests the level the texture needs this frame. The most detailed request of the frame counts.
+        void Request(uint32_t id, float mip);
+
+        // Chooses the target level of every texture from the requests of the frame, and clears them. Textures without a
+        // request fall back to their tail.
+        void Plan();
+
+        uint32_t TargetMip(uint32_t id) const;
+        uint32_t ResidentMip(uint32_t id) const;
+        void SetResidentMip(uint32_t id, uint32_t mip);
+
+        const ResidencyOptions& Options() const {
+            return m_options;
+        }
+        ResidencyStatistics Statistics() const;
+
+    private:
+        struct Texture {
+            std::vector<size_t> LevelBytes;
+            uint32_t TailMip{0};
+            uint32_t ResidentMip{0};
+            uint32_t TargetMip{0};
+            uint32_t NeededMip{0}; // Of the last plan
+            float RequestedMip{std::numeric_limits<float>::infinity()}; // Until a request of the frame
+        };
+
+        static size_t Bytes(const Texture& texture, uint32_t mip);
+
+        ResidencyOptions m_options;
+        std::map<uint32_t, Texture> m_textures;
+        uint32_t m_nextId{0};
+
+        // Reused by every plan to avoid allocations.
+        std::vector<std::pair<double, uint32_t>> m_dropQueue;
+    };
+} // namespace Pbr
@@ -7,16 +7,28 @@
 #include "PbrMaterial.h"
 
 #include <PbrPixelShader.h>
+#include <PbrPixelShaderAtlas.h>
 #include <PbrVertexShader.h>
 #include <HighlightPixelShader.h>
 #include <HighlightVertexShader.h>
+#include <PbrVertexShaderVprt.h>
+#include <HighlightVertexShaderVprt.h>
 
 using namespace DirectX;
 
 namespace {
+    const D3D11_INPUT_ELEMENT_DESC VertexDesc[] = {
+        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"TANGENT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        {"TRANSFORMINDEX", 0, DXGI_FORMAT_R16_UINT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0},
+    };
+
     struct SceneConstantBuffer {
-        alignas(16) DirectX::XMFLOAT4X4 ViewProjection;
-        alignas(16) DirectX::XMFLOAT4 EyePosition;
+        alignas(16) DirectX::XMFLOAT4X4 ViewProjection[Pbr::Resources::MaxViewCount];
+        alignas(16) DirectX::XMFLOAT4 EyePosition[Pbr::Resources::MaxViewCount];
         alignas(16) DirectX::XMFLOAT3 LightDirection{};
         alignas(16) DirectX::XMFLOAT3 LightDiffuseColor{};
         alignas(16) int NumSpecularMipLevels{1};
@@ -26,14 +38,15 @@ namespace {
 
     struct ModelConstantBuffer {
         alignas(16) DirectX::XMFLOAT4X4 ModelToWorld;
+        alignas(16) uint32_t ViewIndexOffset{0};
     };
 } // namespace
 
 namespace Pbr {
     struct Resources::Impl {
         void Initialize(_In_ ID3D11Device* device) {
-            Internal::ThrowIfFailed(device->CreateInputLayout(Pbr::Vertex::s_vertexDesc,
-                                                              ARRAYSIZE(Pbr::Vertex::s_vertexDesc),
+            Internal::ThrowIfFailed(device->CreateInputLayout(VertexDesc,
+                                                              ARRAYSIZE(VertexDesc),
                                                               g_PbrVertexShader,
                                                               sizeof(g_PbrVertexShader),
                                                               Resources.InputLayout.put()));
@@ -41,6 +54,8 @@ namespace Pbr {
             // Set up pixel shader.
             Internal::ThrowIfFailed(
                 device->CreatePixelShader(g_PbrPixelShader, sizeof(g_PbrPixelShader), nullptr, Resources.PbrPixelShader.put()));
+            Internal::ThrowIfFailed(device->CreatePixelShader(
+                g_PbrPixelShaderAtlas, sizeof(g_PbrPixelShaderAtlas), nullptr, Resources.PbrPixelShaderAtlas.put()));
             Internal::ThrowIfFailed(device->CreatePixelShader(
                 g_HighlightPixelShader, sizeof(g_HighlightPixelShader), nullptr, Resources.HighlightPixelShader.put()));
 
@@ -49,6 +64,16 @@ namespace Pbr {
             Internal::ThrowIfFailed(device->CreateVertexShader(
                 g_HighlightVertexShader, sizeof(g_HighlightVertexShader), nullptr, Resources.HighlightVertexShader.put()));
 
+            // The vertex shaders for single pass rendering write SV_RenderTargetArrayIndex, which not every device supports.
+            D3D11_FEATURE_DATA_D3D11_OPTIONS3 options{};
+            if (SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS3, &options, sizeof(options))) &&
+                options.VPAndRTArrayIndexFromAnyShaderFeedingRasterizer) {
+                Internal::ThrowIfFailed(device->CreateVertexShader(
+                    g_PbrVertexShaderVprt, sizeof(g_PbrVertexShaderVprt), nullptr, Resources.PbrVertexShaderVprt.put()));
+                Internal::ThrowIfFailed(device->CreateVertexShader(
+                    g_HighlightVertexShaderVprt, sizeof(g_HighlightVertexShaderVprt), nullptr, Resources.HighlightVertexShaderVprt.put()));
+            }
+
             // Set up the constant buffers.
             static_assert((sizeof(SceneConstantBuffer) % 16) == 0, "Constant Buffer must be divisible by 16 bytes");
             const CD3D11_BUFFER_DESC pbrConstantBufferDesc(sizeof(SceneConstantBuffer), D3D11_BIND_CONSTANT_BUFFER);
@@ -109,8 +134,11 @@ namespace Pbr {
             winrt::com_ptr<ID3D11InputLayout> InputLayout;
             winrt::com_ptr<ID3D11VertexShader> PbrVertexShader;
             winrt::com_ptr<ID3D11PixelShader> PbrPixelShader;
+            winrt::com_ptr<ID3D11PixelShader> PbrPixelShaderAtlas;
             winrt::com_ptr<ID3D11VertexShader> HighlightVertexShader;
             winrt::com_ptr<ID3D11PixelShader> HighlightPixelShader;
+            winrt::com_ptr<ID3D11VertexShader> PbrVertexShaderVprt;       // Null if the device doesn't support VPRT
+            winrt::com_ptr<ID3D11VertexShader> HighlightVertexShaderVprt; // Null if the device doesn't support VPRT
             winrt::com_ptr<ID3D11Buffer> SceneConstantBuffer;
             winrt::com_ptr<ID3D11Buffer> ModelConstantBuffer;
             winrt::com_ptr<ID3D11ShaderResourceView> BrdfLut;
@@ -127,6 +155,8 @@ namespace Pbr {
         DeviceResources Resources;
         SceneConstantBuffer SceneBuffer;
         ModelConstantBuffer ModelBuffer;
+        uint32_t ViewCount{1};
+        uint32_t ViewInstanceCount{1};
 
         Duration HighlightAnimationTimeStart;
         DirectX::XMFLOAT3 HighlightPulseLocation;
@@ -135,6 +165,10 @@ namespace Pbr {
         FillMode Fill = FillMode::Solid;
         FrontFaceWindingOrder WindingOrder = FrontFaceWindingOrder::ClockWise;
         bool ReverseZ = false;
+        TextureCompression Compression = TextureCompression::None;
+        std::shared_ptr<TextureStore> CompressedTextureStore;
+        AssetCache Assets;
+        std::shared_ptr<TextureResidency> Residency;
         mutable std::mutex m_cacheMutex;
     };
 
@@ -157,6 +191,7 @@ namespace Pbr {
 
     void Resources::ReleaseDeviceDependentResources() {
         m_impl->Resources = {};
+        m_impl->Assets.Clear();
     }
 
     winrt::com_ptr<ID3D11Device> Resources::GetDevice() const {
@@ -187,8 +222,54 @@ namespace Pbr {
     }
 
     void XM_CALLCONV Resources::SetViewProjection(DirectX::FXMMATRIX view, DirectX::CXMMATRIX projection) {
-        XMStoreFloat4x4(&m_impl->SceneBuffer.ViewProjection, XMMatrixTranspose(XMMatrixMultiply(view, projection)));
-        XMStoreFloat4(&m_impl->SceneBuffer.EyePosition, XMMatrixInverse(nullptr, view).r[3]);
+        XMStoreFloat4x4(&m_impl->SceneBuffer.ViewProjection[0], XMMatrixTranspose(XMMatrixMultiply(view, projection)));
+        XMStoreFloat4(&m_impl->SceneBuffer.EyePosition[0], XMMatrixInverse(nullptr, view).r[3]);
+        m_impl->ViewCount = 1;
+        SetViewMask(1);
+    }
+
+    void Resources::SetViewProjections(_In_reads_(viewCount) const DirectX::XMMATRIX* views,
+                                       _In_reads_(viewCount) const DirectX::XMMATRIX* projections,
+                                       uint32_t viewCount) {
+        if (viewCount == 0 || viewCount > MaxViewCount) {
+            throw std::out_of_range("Unsupported number of views");
+        }
+        if (viewCount > 1 && !SupportsSinglePassViews()) {
+            throw std::logic_error("The device doesn't support rendering several views in a single pass");
+        }
+
+        for (uint32_t i = 0; i < viewCount; i++) {
+            XMStoreFloat4x4(&m_impl->SceneBuffer.ViewProjection[i], XMMatrixTranspose(XMMatrixMultiply(views[i], projections[i])));
+            XMStoreFloat4(&m_impl->SceneBuffer.EyePosition[i], XMMatrixInverse(nullptr, views[i]).r[3]);
+        }
+        m_impl->ViewCount = viewCount;
+        SetViewMask((1u << viewCount) - 1);
+    }
+
+    bool Resources::SupportsSinglePassViews() const {
+        return m_impl->Resources.PbrVertexShaderVprt != nullptr;
+    }
+
+    void Resources::SetViewMask(uint32_t viewMask) {
+        viewMask &= (1u << m_impl->ViewCount) - 1;
+
+        uint32_t viewIndexOffset = 0;
+        while (viewIndexOffset < m_impl->ViewCount && (viewMask & (1u << viewIndexOffset)) == 0) {
+            viewIndexOffset++;
+        }
+        uint32_t viewInstanceCount = 0;
+        while (viewIndexOffset + viewInstanceCount < m_impl->ViewCount &&
+               (viewMask & (1u << (viewIndexOffset + viewInstanceCount))) != 0) {
+            viewInstanceCount++;
+        }
+        assert(viewMask == (((1u << viewInstanceCount) - 1) << viewIndexOffset)); // The views must be consecutive.
+
+        m_impl->ModelBuffer.ViewIndexOffset = viewInstanceCount > 0 ? viewIndexOffset : 0;
+        m_impl->ViewInstanceCount = viewInstanceCount;
+    }
+
+    uint32_t Resources::GetViewInstanceCount() const {
+        return m_impl->ViewInstanceCount;
     }
 
     void Resources::SetEnvironmentMap(_In_ ID3D11ShaderResourceView* specularEnvironmentMap,
@@ -229,15 +310,46 @@ namespace Pbr {
         return m_impl->Resources.SolidColorTextureCache.emplace(colorKey, texture).first->second;
     }
 
+    void Resources::SetTextureCompression(TextureCompression compression, std::shared_ptr<TextureStore> store) {
+        m_impl->Compression = compression;
+        m_impl->CompressedTextureStore = std::move(store);
+    }
+
+    TextureCompression Resources::GetTextureCompression() const {
+        return m_impl->Compression;
+    }
+
+    std::shared_ptr<TextureStore> Resources::GetTextureStore() const {
+        return m_impl->CompressedTextureStore;
+    }
+
+    AssetCache& Resources::GetAssetCache() const {
+        return m_impl->Assets;
+    }
+
+    void Resources::SetTextureResidency(std::shared_ptr<TextureResidency> residency) {
+        m_impl->Residency = std::move(residency);
+    }
+
+    std::shared_ptr<TextureResidency> Resources::GetTextureResidency() const {
+        return m_impl->Residency;
+    }
+
     void Resources::Bind(_In_ ID3D11DeviceContext* context) const {
         context->UpdateSubresource(m_impl->Resources.SceneConstantBuffer.get(), 0, nullptr, &m_impl->SceneBuffer, 0, 0);
 
+        // Rendering several views in a single pass needs the vertex shaders that select the render target array slice.
+        const bool singlePass = m_impl->ViewCount > 1;
+        const auto& resources = m_impl->Resources;
         if (m_impl->Shading == ShadingMode::Highlight) {
-            context->VSSetShader(m_impl->Resources.HighlightVertexShader.get(), nullptr, 0);
-            context->PSSetShader(m_impl->Resources.HighlightPixelShader.get(), nullptr, 0);
+            ID3D11VertexShader* const vertexShader =
+                singlePass ? resources.HighlightVertexShaderVprt.get() : resources.HighlightVertexShader.get();
+            context->VSSetShader(vertexShader, nullptr, 0);
+            context->PSSetShader(resources.HighlightPixelShader.get(), nullptr, 0);
         } else {
-            context->VSSetShader(m_impl->Resources.PbrVertexShader.get(), nullptr, 0);
-            context->PSSetShader(m_impl->Resources.PbrPixelShader.get(), nullptr, 0);
+            ID3D11VertexShader* const vertexShader = singlePass ? resources.PbrVertexShaderVprt.get() : resources.PbrVertexShader.get();
+            context->VSSetShader(vertexShader, nullptr, 0);
+            context->PSSetShader(resources.PbrPixelShader.get(), nullptr, 0);
         }
 
         ID3D11Buffer* vsBuffers[] = {m_impl->Resources.SceneConstantBuffer.get(), m_impl->Resources.ModelConstantBuffer.get()};
@@ -295,6 +407,11 @@ namespace Pbr {
                                 .get());
     }
 
+    void Resources::SetMaterialAtlasShader(_In_ ID3D11DeviceContext* context, bool atlas) const {
+        const auto& resources = m_impl->Resources;
+        context->PSSetShader(atlas ? resources.PbrPixelShaderAtlas.get() : resources.PbrPixelShader.get(), nullptr, 0);
+    }
+
     void Resources::SetDepthStencilState(_In_ ID3D11DeviceContext* context, bool disableDepthWrite) const {
         context->OMSetDepthStencilState(m_impl->Resources.DepthStencilStates[m_impl->ReverseZ ? 1 : 0][disableDepthWrite ? 1 : 0].get(), 1);
     }
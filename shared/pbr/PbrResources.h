@@ -11,56 +11,17 @@
 #include <d3d11_2.h>
 #include <DirectXMath.h>
 #include "PbrCommon.h"
+#include "PbrBlockCompression.h"
+#include "PbrAssetCache.h"
 
 namespace Pbr {
-    namespace ShaderSlots {
-        enum VSResourceViews {
-            Transforms = 0,
-        };
-
-        enum PSMaterial { // For both samplers and textures.
-            BaseColor = 0,
-            MetallicRoughness,
-            Normal,
-            Occlusion,
-            Emissive,
-            LastMaterialSlot = Emissive
-        };
-
-        enum Pbr { // For both samplers and textures.
-            Brdf = LastMaterialSlot + 1
-        };
-
-        enum EnvironmentMap { // For both samplers and textures.
-            SpecularTexture = Brdf + 1,
-            DiffuseTexture = SpecularTexture + 1,
-            EnvironmentMapSampler = Brdf + 1
-        };
-
-        enum ConstantBuffers {
-            Scene,    // Used by VS and PS
-            Model,    // PS only
-            Material, // PS only
-        };
-    } // namespace ShaderSlots
-
-    enum class ShadingMode : uint32_t {
-        Regular,
-        Highlight,
-    };
-
-    enum class FillMode : uint32_t {
-        Solid,
-        Wireframe,
-    };
-
-    enum class FrontFaceWindingOrder : uint32_t {
-        ClockWise,
-        CounterClockWise,
-    };
+    class TextureResidency;
 
     // Global PBR resources required for rendering a scene.
     struct Resources final {
+        // The most views that can be rendered in a single pass. Must match MAX_VIEW_COUNT in Shared.hlsl.
+        static constexpr uint32_t MaxViewCount = 2;
+
         explicit Resources(_In_ ID3D11Device* d3dDevice);
         Resources(Resources&&);
 
@@ -95,10 +56,43 @@ namespace Pbr {
         // Set the current view and projection matrices.
         void XM_CALLCONV SetViewProjection(DirectX::FXMMATRIX view, DirectX::CXMMATRIX projection);
 
+        // Set the view and projection matrices of several views to render in a single pass. Every draw is instanced once per view
+        // and the vertex shader sends each instance to the render target array slice of its view, so the render target must be a
+        // texture array with a slice per view. Requires SupportsSinglePassViews.
+        void SetViewProjections(_In_reads_(viewCount) const DirectX::XMMATRIX* views,
+                                _In_reads_(viewCount) const DirectX::XMMATRIX* projections,
+                                uint32_t viewCount);
+
+        // Whether the device can select the render target array slice in the vertex shader, as needed by SetViewProjections.
+        bool SupportsSinglePassViews() const;
+
+        // Restrict the following draws to the views in the mask, where bit i stands for view i of the current view projections.
+        // The views in the mask must be consecutive. Takes effect with the next SetModelToWorld. Reset by setting view projections.
+        void SetViewMask(uint32_t viewMask);
+
+        // The number of instances each draw renders, one per view in the view mask.
+        uint32_t GetViewInstanceCount() const;
+
         // Many 1x1 pixel colored textures are used in the PBR system. This is used to create textures backed by a cache to reduce the
         // number of textures created.
         winrt::com_ptr<ID3D11ShaderResourceView> CreateSolidColorTexture(RGBAColor color) const;
 
+        // Set how the textures of glTF models loaded with these resources are compressed. When a store is given, compressed
+        // textures are kept in it and loaded from it on later loads of the same images, so each image is only encoded once.
+        void SetTextureCompression(TextureCompression compression, std::shared_ptr<TextureStore> store = nullptr);
+        TextureCompression GetTextureCompression() const;
+        std::shared_ptr<TextureStore> GetTextureStore() const;
+
+        // The textures, samplers and materials shared by the glTF models loaded with these resources, so that loading the
+        // same content again, or other content with the same images, doesn't create them again. Cleared with the device
+        // dependent resources.
+        AssetCache& GetAssetCache() const;
+
+        // Set the residency streaming the mip levels of the textures of glTF models loaded with these resources, or null to
+        // create their textures with all levels.
+        void SetTextureResidency(std::shared_ptr<TextureResidency> residency);
+        std::shared_ptr<TextureResidency> GetTextureResidency() const;
+
         // Bind the the PBR resources to the current context.
         void Bind(_In_ ID3D11DeviceContext* context) const;
 
@@ -120,7 +114,11 @@ namespace Pbr {
         void SetRasterizerState(_In_ ID3D11DeviceContext* context, bool doubleSided, bool wireframe) const;
         void SetDepthStencilState(_In_ ID3D11DeviceContext* context, bool disableDepthWrite) const;
 
+        // Switch between the regular pixel shader and its material atlas variant.
+        void SetMaterialAtlasShader(_In_ ID3D11DeviceContext* context, bool atlas) const;
+
         friend struct Material;
+        friend class MaterialAtlas;
 
         struct Impl;
         std::unique_ptr<Impl> m_impl;
@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// Where the Pbr library runs its CPU work: decoding images, filtering environment maps and computing mip chains.
+// The library doesn't own threads. An app that has a thread pool installs it with SetTaskScheduler, and without one a thread is
+// started for each job, as std::async does. Only the standard library is used, so this builds on every platform.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Pbr {
+    class TaskScheduler {
+    public:
+        virtual ~TaskScheduler() = default;
+
+        // Runs task on a worker thread without waiting for it. A task must not block on the result of another task given to
+        // Run, since that one may be queued behind it.
+        virtual void Run(std::function<void()> task) = 0;
+
+        // Calls body(i) for each i in [0, count) and returns once all calls returned, rethrowing the first exception of a call.
+        // The calling thread takes part, so this may be called from a task of the scheduler itself.
+        virtual void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& body) = 0;
+
+        // The number of worker threads, not counting the threads calling ParallelFor.
+        virtual uint32_t ThreadCount() const = 0;
+    };
+
+    namespace Internal {
+        struct TaskSchedulerSlot {
+            std::mutex Mutex;
+            std::shared_ptr<TaskScheduler> Scheduler;
+        };
+
+        inline TaskSchedulerSlot& GetTaskSchedulerSlot() {
+            static TaskSchedulerSlot slot;
+            return slot;
+        }
+    } // namespace Internal
+
+    // Installs the scheduler the work started from now on runs on, or null to start a thread for each job again.
+    // Work already started keeps the scheduler it was started on alive until it finishes.
+    inline void SetTaskScheduler(std::shared_ptr<TaskScheduler> scheduler) {
+        Internal::TaskSchedulerSlot& slot = Internal::GetTaskSchedulerSlot();
+        std::lock_guard lock(slot.Mutex);
+        slot.Scheduler = std::move(scheduler);
+    }
+
+    inline std::shared_ptr<TaskScheduler> GetTaskScheduler() {
+        Internal::TaskSchedulerSlot& slot = Internal::GetTaskSchedulerSlot();
+        std::lock_guard lock(slot.Mutex);
+        return slot.Scheduler;
+    }
+
+    namespace Internal {
+        // Runs function on the task scheduler, or on a new thread without one, and returns a future for its result.
+        template <typename Function>
+        std::future<std::invoke_result_t<std::decay_t<Function>&>> Async(Function&& function) {
+            using Result = std::invoke_result_t<std::decay_t<Function>&>;
+            const std::shared_ptr<TaskScheduler> scheduler = GetTaskScheduler();
+            if (!scheduler) {
+                return std::async(std::launch::async, std::forward<Function>(function));
+            }
+
+            auto promise = std::make_shared<std::promise<Result>>();
+            std::future<Result> result = promise->get_future();
+            scheduler->Run([promise, function = std::forward<Function>(function)]() mutable {
+                try {
+                    if constexpr (std::is_void_v<Result>) {
+                        function();
+                        promise->set_value();
+                    } else {
+                        promise->set_value(function());
+                    }
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+            return result;
+        }
+
+        // Runs function on the task scheduler, or on a new thread without one, without anything to wait for it. For work that
+        // reports its own result, such as through a promise, or that continues in other work when it finishes.
+        template <typename Function>
+        void Run(Function&& function) {
+            if (const std::shared_ptr<TaskScheduler> scheduler = GetTaskScheduler()) {
+                scheduler->Run(std::forward<Function>(function));
+            } else {
+                std::thread(std::forward<Function>(function)).detach();
+            }
+        }
+
+        // Calls function(begin, end) for bands of [0, count). The bands run on the task scheduler, or on new threads without
+        // one, when the items together cover enough texels. Below that, the cost of handing out the bands would dominate.
+        template <typename Function>
+        void ParallelForBands(uint32_t count, size_t texelsPerItem, Function&& function) {
+            constexpr size_t ParallelTexelThreshold = 64 * 1024;
+            const std::shared_ptr<TaskScheduler> scheduler = GetTaskScheduler();
+            const uint32_t threadCount = scheduler ? scheduler->ThreadCount() + 1 : std::max(1u, std::thread::hardware_concurrency());
+            if (count * texelsPerItem < ParallelTexelThreshold || threadCount == 1 || count < 2) {
+                function(0u, count);
+                return;
+            }
+
+            const uint32_t bandCount = std::min(count, threadCount);
+            if (scheduler) {
+                scheduler->ParallelFor(bandCount, [&](uint32_t band) {
+                    function(count * band / bandCount, count * (band + 1) / bandCount);
+                });
+                return;
+            }
+
+            std::vector<std::future<void>> bands;
+            bands.reserve(bandCount - 1);
+            for (uint32_t band = 1; band < bandCount; band++) {
+                bands.push_back(std::async(std::launch::async, [&, band] {
+                    function(count * band / bandCount, count * (band + 1) / bandCount);
+                }));
+            }
+
+            function(0u, count / bandCount);
+            for (std::future<void>& band : bands) {
+                band.get(); // Rethrows exceptions of the workers.
+            }
+        }
+    } // namespace Internal
+} // namespace Pbr
@@ -0,0 +1,342 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+#include "pch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "PbrCommon.h"
+#include "PbrModel.h"
+#include "PbrTaskScheduler.h"
+#include "PbrTextureResidency.h"
+
+using namespace DirectX;
+
+namespace {
+    // The largest scale of the transform along any axis.
+    float MaxScale(FXMMATRIX transform) {
+        return std::max({XMVectorGetX(XMVector3Length(transform.r[0])),
+                         XMVectorGetX(XMVector3Length(transform.r[1])),
+                         XMVectorGetX(XMVector3Length(transform.r[2]))});
+    }
+} // namespace
+
+namespace Pbr {
+    Primitive::Extent ComputePrimitiveExtent(const PrimitiveBuilder& primitiveBuilder, const Model& model) {
+        // Nodes come after their parents, so their transforms to the model root are built in a single pass.
+        std::vector<XMFLOAT4X4> nodeToRoot(model.GetNodeCount());
+        for (NodeIndex_t nodeIndex = 0; nodeIndex < model.GetNodeCount(); nodeIndex++) {
+            const Node& node = model.GetNode(nodeIndex);
+            const XMMATRIX parentToRoot =
+                nodeIndex == RootNodeIndex ? XMMatrixIdentity() : XMLoadFloat4x4(&nodeToRoot[node.ParentNodeIndex]);
+            XMStoreFloat4x4(&nodeToRoot[nodeIndex], XMMatrixMultiply(node.GetTransform(), parentToRoot));
+        }
+
+        std::vector<XMFLOAT3> positions(primitiveBuilder.Vertices.size());
+        XMVECTOR minimum = XMVectorReplicate(std::numeric_limits<float>::max());
+        XMVECTOR maximum = XMVectorReplicate(std::numeric_limits<float>::lowest());
+        for (size_t i = 0; i < primitiveBuilder.Vertices.size(); i++) {
+            const Vertex& vertex = primitiveBuilder.Vertices[i];
+            const XMVECTOR position =
+                XMVector3TransformCoord(XMLoadFloat3(&vertex.Position), XMLoadFloat4x4(&nodeToRoot.at(vertex.ModelTransformIndex)));
+            XMStoreFloat3(&positions[i], position);
+            minimum = XMVectorMin(minimum, position);
+            maximum = XMVectorMax(maximum, position);
+        }
+
+        Primitive::Extent extent;
+        if (positions.empty()) {
+            return extent;
+        }
+
+        const XMVECTOR center = XMVectorScale(XMVectorAdd(minimum, maximum), 0.5f);
+        XMStoreFloat3(&extent.Center, center);
+        for (const XMFLOAT3& position : positions) {
+            extent.Radius = std::max(extent.Radius, XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat3(&position), center))));
+        }
+
+        // The density is the square root of the ratio of the texture coordinate area to the surface area.
+        double surfaceArea = 0;
+        double uvArea = 0;
+        for (size_t i = 0; i + 2 < primitiveBuilder.Indices.size(); i += 3) {
+            const uint32_t a = primitiveBuilder.Indices[i];
+            const uint32_t b = primitiveBuilder.Indices[i + 1];
+            const uint32_t c = primitiveBuilder.Indices[i + 2];
+
+            const XMVECTOR pa = XMLoadFloat3(&positions[a]);
+            surfaceArea += 0.5 * XMVectorGetX(XMVector3Length(
+                                     XMVector3Cross(XMVectorSubtract(XMLoadFloat3(&positions[b]), pa),
+                                                    XMVectorSubtract(XMLoadFloat3(&positions[c]), pa))));
+
+            const XMFLOAT2& ta = primitiveBuilder.Vertices[a].TexCoord0;
+            const XMFLOAT2& tb = primitiveBuilder.Vertices[b].TexCoord0;
+            const XMFLOAT2& tc = primitiveBuilder.Vertices[c].TexCoord0;
+            uvArea += 0.5 * std::abs((tb.x - ta.x) * (tc.y - ta.y) - (tc.x - ta.x) * (tb.y - ta.y));
+        }
+
+        if (surfaceArea > 0 && uvArea > 0) {
+            extent.UvDensity = static_cast<float>(std::sqrt(uvArea / surfaceArea));
+        }
+        return extent;
+    }
+
+    TextureResidency::TextureResidency(const ResidencyOptions& options)
+        : m_policy(options) {
+    }
+
+    TextureResidency::~TextureResidency() {
+        // The queued uploads reference this residency, so they are dropped rather than run.
+        if (m_uploadBatch) {
+            m_uploadBatch->Cancel();
+        }
+    }
+
+    std::shared_ptr<StreamedTexture> TextureResidency::CreateTexture(_In_ ID3D11Device* device,
+                                                                     const MipChain& mipChain,
+                                                                     DXGI_FORMAT format,
+                                                                     const std::string& key,
+                                                                     StreamedLevelReader readLevels) {
+        auto texture = std::make_shared<StreamedTexture>();
+        texture->m_key = key;
+        texture->m_format = format;
+        texture->m_levels = mipChain.Levels;
+        texture->m_readLevels = std::move(readLevels);
+        for (size_t level = 0; level < mipChain.Levels.size(); level++) {
+            texture->m_rowPitches.push_back(mipChain.RowPitch(level));
+            texture->m_rowCounts.push_back(mipChain.Levels[level].Height);
+        }
+        return AddTexture(device, std::move(texture), mipChain.Data, false);
+    }
+
+    std::shared_ptr<StreamedTexture> TextureResidency::CreateTexture(_In_ ID3D11Device* device,
+                                                                     const CompressedTexture& compressedTexture,
+                                                                     const std::string& key,
+                                                                     StreamedLevelReader readLevels) {
+        auto texture = std::make_shared<StreamedTexture>();
+        texture->m_key = key;
+        texture->m_format = ToDxgiFormat(compressedTexture.Format, compressedTexture.SRGB);
+        texture->m_levels = compressedTexture.Levels;
+        texture->m_readLevels = std::move(readLevels);
+        for (size_t level = 0; level < compressedTexture.Levels.size(); level++) {
+            texture->m_rowPitches.push_back(compressedTexture.RowPitch(level));
+            texture->m_rowCounts.push_back((compressedTexture.Levels[level].Height + 3) / 4);
+        }
+        return AddTexture(device, std::move(texture), compressedTexture.Data, true);
+    }
+
+    std::shared_ptr<StreamedTexture> TextureResidency::AddTexture(_In_ ID3D11Device* device,
+                                                                  std::shared_ptr<StreamedTexture> texture,
+                                                                  const std::vector<uint8_t>& data,
+                                                                  bool blockCompressed) {
+        // The tail starts at the first level within the tail size. The most detailed level of a block compressed texture
+        // must be a whole number of blocks, so its tail starts no later than the first level that isn't.
+        std::vector<size_t> levelBytes;
+        uint32_t tailMip = static_cast<uint32_t>(texture->m_levels.size() - 1);
+        bool tailFound = false;
+        for (uint32_t level = 0; level < texture->m_levels.size(); level++) {
+            const MipLevel& mipLevel = texture->m_levels[level];
+            levelBytes.push_back(static_cast<size_t>(texture->m_rowPitches[level]) * texture->m_rowCounts[level]);
+
+            const bool wholeBlocks = mipLevel.Width % 4 == 0 && mipLevel.Height % 4 == 0;
+            if (!tailFound && blockCompressed && !wholeBlocks) {
+                tailMip = level > 0 ? level - 1 : 0;
+                tailFound = true;
+            }
+            if (!tailFound && std::max(mipLevel.Width, mipLevel.Height) <= m_policy.Options().TailTexels) {
+                tailMip = level;
+                tailFound = true;
+            }
+        }
+
+        // Only the tail stays in system memory, the finer levels are read again when they stream in.
+        texture->m_tailMip = tailMip;
+        texture->m_tailData.assign(data.begin() + texture->m_levels[tailMip].Offset, data.end());
+        texture->m_view = CreateView(device, *texture, tailMip, data);
+
+        std::lock_guard lock(m_mutex);
+        const auto [it, inserted] = m_textures.try_emplace(texture->m_key);
+        TextureEntry& entry = it->second;
+        if (!inserted) {
+            if (std::shared_ptr<StreamedTexture> existingTexture = entry.Texture.lock()) {
+                // Another load created the texture in the meantime.
+                return existingTexture;
+            }
+            m_policy.RemoveTexture(entry.PolicyId);
+        }
+
+        texture->m_policyId = m_policy.AddTexture(std::move(levelBytes), tailMip);
+        entry = TextureEntry{texture, texture->m_policyId};
+        return texture;
+    }
+
+    std::shared_ptr<StreamedTexture> TextureResidency::FindTexture(const std::string& key) const {
+        std::lock_guard lock(m_mutex);
+        const auto it = m_textures.find(key);
+        return it != m_textures.end() ? it->second.Texture.lock() : nullptr;
+    }
+
+    winrt::com_ptr<ID3D11ShaderResourceView> TextureResidency::CreateView(_In_ ID3D11Device* device,
+                                                                          const StreamedTexture& texture,
+                                                                          uint32_t mip,
+                                                                          const std::vector<uint8_t>& levels) const {
+        D3D11_TEXTURE2D_DESC desc{};
+        desc.Width = texture.m_levels[mip].Width;
+        desc.Height = texture.m_levels[mip].Height;
+        desc.MipLevels = static_cast<UINT>(texture.m_levels.size() - mip);
+        desc.ArraySize = 1;
+        desc.Format = texture.m_format;
+        desc.SampleDesc.Count = 1;
+        desc.Usage = D3D11_USAGE_IMMUTABLE;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+        const size_t tailOffset = texture.m_levels[texture.m_tailMip].Offset;
+        if (mip < texture.m_tailMip && levels.size() < tailOffset) {
+            throw std::runtime_error("The levels read for a streamed texture are too short");
+        }
+
+        std::vector<D3D11_SUBRESOURCE_DATA> initData(desc.MipLevels);
+        for (uint32_t level = mip; level < texture.m_levels.size(); level++) {
+            D3D11_SUBRESOURCE_DATA& data = initData[level - mip];
+            const size_t offset = texture.m_levels[level].Offset;
+            data.pSysMem = level < texture.m_tailMip ? levels.data() + offset : texture.m_tailData.data() + (offset - tailOffset);
+            data.SysMemPitch = texture.m_rowPitches[level];
+            data.SysMemSlicePitch = texture.m_rowPitches[level] * texture.m_rowCounts[level];
+        }
+
+        winrt::com_ptr<ID3D11Texture2D> texture2D;
+        Internal::ThrowIfFailed(device->CreateTexture2D(&desc, initData.data(), texture2D.put()));
+
+        const CD3D11_SHADER_RESOURCE_VIEW_DESC srvDesc(D3D11_SRV_DIMENSION_TEXTURE2D, desc.Format, 0, desc.MipLevels);
+        winrt::com_ptr<ID3D11ShaderResourceView> textureView;
+        Internal::ThrowIfFailed(device->CreateShaderResourceView(texture2D.get(), &srvDesc, textureView.put()));
+        return textureView;
+    }
+
+    void TextureResidency::AddView(const ResidencyView& view) {
+        std::lock_guard lock(m_mutex);
+        m_views.push_back(view);
+    }
+
+    void XM_CALLCONV TextureResidency::ReportModel(const Model& model, FXMMATRIX modelToWorld) {
+        const float scale = MaxScale(modelToWorld);
+
+        std::lock_guard lock(m_mutex);
+        for (uint32_t primitiveIndex = 0; primitiveIndex < model.GetPrimitiveCount(); primitiveIndex++) {
+            const Primitive& primitive = model.GetPrimitive(primitiveIndex);
+            const Material& material = *primitive.GetMaterial();
+            if (material.Hidden) {
+                continue;
+            }
+
+            const Primitive::Extent extent = primitive.GetExtent().value_or(Primitive::Extent{});
+            const XMVECTOR center = XMVector3TransformCoord(XMLoadFloat3(&extent.Center), modelToWorld);
+            for (uint32_t slot = 0; slot <= ShaderSlots::LastMaterialSlot; slot++) {
+                const StreamedTexture* texture = material.GetStreamedTexture(static_cast<ShaderSlots::PSMaterial>(slot)).get();
+                if (texture == nullptr) {
+                    continue;
+                }
+
+                // Without an extent, the density is unknown and the most detailed level is needed.
+                const uint32_t textureSize = std::max(texture->m_levels.front().Width, texture->m_levels.front().Height);
+                for (const ResidencyView& view : m_views) {
+                    const float mip = EstimateRequiredMip(
+                        view, center, extent.Radius * scale, extent.UvDensity / scale, textureSize, m_policy.Options().OffscreenMipBias);
+                    m_policy.Request(texture->m_policyId, mip);
+                }
+            }
+        }
+    }
+
+    void TextureResidency::Update(UploadQueue& uploadQueue) {
+        std::lock_guard lock(m_mutex);
+        m_views.clear();
+
+        for (auto it = m_textures.begin(); it != m_textures.end();) {
+            if (it->second.Texture.expired()) {
+                // No material shows the texture any more. Uploads still queued for it keep it alive until they ran.
+                m_policy.RemoveTexture(it->second.PolicyId);
+                it = m_textures.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        m_policy.Plan();
+
+        if (!m_uploadBatch) {
+            // Streaming levels waits for the models being loaded.
+            m_uploadBatch = uploadQueue.CreateBatch(UploadPriority::Low);
+        }
+
+        for (const auto& [key, entry] : m_textures) {
+            const std::shared_ptr<StreamedTexture> texture = entry.Texture.lock();
+            if (!texture) {
+                continue;
+            }
+
+            const uint32_t targetMip = m_policy.TargetMip(texture->m_policyId);
+            if (texture->m_streaming || targetMip == m_policy.ResidentMip(texture->m_policyId)) {
+                continue;
+            }
+
+            texture->m_streaming = true;
+            m_pendingCount++;
+
+            Upload upload;
+            upload.Stage = UploadStage::Textures;
+            upload.Size = [texture, targetMip] {
+                size_t bytes = 0;
+                for (size_t level = targetMip; level < texture->m_levels.size(); level++) {
+                    bytes += static_cast<size_t>(texture->m_rowPitches[level]) * texture->m_rowCounts[level];
+                }
+                return bytes;
+            };
+
+            // The levels finer than the tail are read on a worker thread, and the upload waits for them. Levels streaming out
+            // are read again too, since a texture can't be created from the levels of another one without a copy on the GPU.
+            std::shared_future<std::vector<uint8_t>> levels;
+            if (targetMip < texture->m_tailMip) {
+                levels = Internal::Async(texture->m_readLevels).share();
+                upload.IsReady = [levels] { return levels.wait_for(std::chrono::seconds(0)) == std::future_status::ready; };
+            }
+            upload.Run = [this, texture, targetMip, levels] { StreamLevels(texture, targetMip, levels); };
+            uploadQueue.Enqueue(m_uploadBatch, std::move(upload));
+        }
+    }
+
+    void TextureResidency::StreamLevels(const std::shared_ptr<StreamedTexture>& texture,
+                                        uint32_t mip,
+                                        const std::shared_future<std::vector<uint8_t>>& levels) {
+        // The texture is created again with the new levels, since a Direct3D 11 texture can't change its levels. Failures,
+        // such as levels that can't be read or running out of memory, keep the resident levels rather than cancelling the
+        // streaming of other textures.
+        winrt::com_ptr<ID3D11ShaderResourceView> view;
+        try {
+            winrt::com_ptr<ID3D11Device> device;
+            texture->m_view->GetDevice(device.put());
+            static const std::vector<uint8_t> noLevels;
+            view = CreateView(device.get(), *texture, mip, levels.valid() ? levels.get() : noLevels);
+        } catch (...) {
+        }
+
+        std::lock_guard lock(m_mutex);
+        texture->m_streaming = false;
+        m_pendingCount--;
+        if (!view) {
+            m_failedCount++;
+            return;
+        }
+
+        texture->m_view = std::move(view);
+        m_policy.SetResidentMip(texture->m_policyId, mip);
+    }
+
+    ResidencyStatistics TextureResidency::Statistics() const {
+        std::lock_guard lock(m_mutex);
+        ResidencyStatistics statistics = m_policy.Statistics();
+        statistics.PendingCount = m_pendingCount;
+        statistics.FailedCount = m_failedCount;
+        return statistics;
+    }
+} // namespace Pbr
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// Streaming of texture mip levels, so that textures only keep the levels their size on screen needs, within a memory
+// budget. The levels are chosen by the ResidencyPolicy of PbrResidencyPolicy.h.
+//
+
+#pragma once
+
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <winrt/base.h>
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include "PbrBlockCompression.h"
+#include "PbrMipmaps.h"
+#include "PbrPrimitive.h"
+#include "PbrResidencyPolicy.h"
+#include "PbrUploadQueue.h"
+
+namespace Pbr {
+    struct Model;
+
+    // Computes where the primitive is in the model, and how densely its texture coordinates cover it, from the vertices
+    // transformed by their nodes at their current transforms.
+    Primitive::Extent ComputePrimitiveExtent(const PrimitiveBuilder& primitiveBuilder, const Model& model);
+
+    // Reads the texels of all levels of a streamed texture again, laid out as when the texture was created. Called on a
+    // worker thread when levels stream in, so that only the levels always resident stay in system memory. Throws if the
+    // levels can't be read.
+    using StreamedLevelReader = std::function<std::vector<uint8_t>()>;
+
+    // A texture whose levels are streamed by a TextureResidency, shown by materials, see Material::SetTexture. The
+    // materials showing it keep it alive. Only its tail is kept in system memory, the finer levels are read again when
+    // they stream in.
+    class StreamedTexture {
+    public:
+        // The view of the resident levels. Changes when levels are streamed in and out, on the thread processing the
+        // upload queue, which must be the thread rendering.
+        ID3D11ShaderResourceView* CurrentView() const {
+            return m_view.get();
+        }
+
+    private:
+        friend class TextureResidency;
+
+        std::string m_key;
+        DXGI_FORMAT m_format{DXGI_FORMAT_UNKNOWN};
+        std::vector<MipLevel> m_levels;
+        std::vector<uint32_t> m_rowPitches;
+        std::vector<uint32_t> m_rowCounts; // Rows of texels, or of blocks for compressed formats
+        uint32_t m_tailMip{0};
+        std::vector<uint8_t> m_tailData; // The levels from the tail on
+        StreamedLevelReader m_readLevels;
+        uint32_t m_policyId{0};
+        bool m_streaming{false};
+        winrt::com_ptr<ID3D11ShaderResourceView> m_view;
+    };
+
+    // Streams the levels of textures within a memory budget. Each frame, the views are added and the models rendered are
+    // reported while rendering, then Update plans the levels and queues the uploads which stream them in and out.
+    // Textures are created and found from any thread; the other calls are made on the thread rendering.
+    class TextureResidency {
+    public:
+        explicit TextureResidency(const ResidencyOptions& options = {});
+        ~TextureResidency();
+
+        // Creates a streamed texture from all its levels, with only its tail resident. Can be found by the key until the
+        // materials showing it release it. The finer levels are read with readLevels when they stream in.
+        std::shared_ptr<StreamedTexture> CreateTexture(_In_ ID3D11Device* device,
+                                                       const MipChain& mipChain,
+                                                       DXGI_FORMAT format,
+                                                       const std::string& key,
+                                                       StreamedLevelReader readLevels);
+        std::shared_ptr<StreamedTexture> CreateTexture(_In_ ID3D11Device* device,
+                                                       const CompressedTexture& texture,
+                                                       const std::string& key,
+                                                       StreamedLevelReader readLevels);
+
+        // Returns the streamed texture with the key, or null if there is none.
+        std::shared_ptr<StreamedTexture> FindTexture(const std::string& key) const;
+
+        // Adds a view the models are rendered to this frame.
+        void AddView(const ResidencyView& view);
+
+        // Requests the levels the streamed textures of the model need in the views added so far. Primitives without an
+        // extent need the most detailed levels.
+        void XM_CALLCONV ReportModel(const Model& model, DirectX::FXMMATRIX modelToWorld);
+
+        // Plans the levels from the reports of the frame, then queues the uploads which change them. Levels streaming in
+        // are shown once their upload ran, until then the coarser resident levels are.
+        void Update(UploadQueue& uploadQueue);
+
+        ResidencyStatistics Statistics() const;
+
+    private:
+        struct TextureEntry {
+            std::weak_ptr<StreamedTexture> Texture;
+            uint32_t PolicyId{0};
+        };
+
+        std::shared_ptr<StreamedTexture> AddTexture(_In_ ID3D11Device* device,
+                                                    std::shared_ptr<StreamedTexture> texture,
+                                                    const std::vector<uint8_t>& data,
+                                                    bool blockCompressed);
+
+        // Creates the texture of the levels from mip on. The levels before the tail are taken from levels, which holds all
+        // levels as read by the StreamedLevelReader, and the others from the tail data.
+        winrt::com_ptr<ID3D11ShaderResourceView>
+        CreateView(_In_ ID3D11Device* device, const StreamedTexture& texture, uint32_t mip, const std::vector<uint8_t>& levels) const;
+        void StreamLevels(const std::shared_ptr<StreamedTexture>& texture,
+                          uint32_t mip,
+                          const std::shared_future<std::vector<uint8_t>>& levels);
+
+        mutable std::mutex m_mutex;
+        ResidencyPolicy m_policy;
+        std::map<std::string, TextureEntry> m_textures;
+        std::vector<ResidencyView> m_views;
+        std::shared_ptr<UploadBatch> m_uploadBatch;
+        uint32_t m_pendingCount{0};
+        uint32_t m_failedCount{0};
+    };
+} // namespace Pbr
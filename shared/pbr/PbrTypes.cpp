@@ -0,0 +1,252 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// Doesn't use the precompiled header, which includes Windows headers, so that it builds on any platform.
+//
+#include <cassert>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <DirectXColors.h>
+#include "PbrTypes.h"
+
+using namespace DirectX;
+
+namespace Pbr {
+    RGBAColor XM_CALLCONV FromSRGB(DirectX::XMVECTOR color) {
+        RGBAColor linearColor{};
+        DirectX::XMStoreFloat4(&linearColor, DirectX::XMColorSRGBToRGB(color));
+        return linearColor;
+    }
+
+    RGBColor XM_CALLCONV RGBFromSRGB(DirectX::XMVECTOR color) {
+        RGBColor linearColor{};
+        DirectX::XMStoreFloat3(&linearColor, DirectX::XMColorSRGBToRGB(color));
+        return linearColor;
+    }
+
+    PrimitiveBuilder& PrimitiveBuilder::AddAxis(float axisLength, float axisThickness, Pbr::NodeIndex_t transformIndex) {
+        AddCube(axisThickness + 0.01f, transformIndex, Pbr::FromSRGB(Colors::Gray));
+        AddCube({axisLength, axisThickness, axisThickness}, XMVECTORF32{axisLength / 2, 0, 0}, transformIndex, Pbr::FromSRGB(Colors::Red));
+        AddCube({axisThickness, axisLength, axisThickness}, XMVECTORF32{0, axisLength / 2, 0}, transformIndex, Pbr::FromSRGB(Colors::Green));
+        AddCube({axisThickness, axisThickness, axisLength}, XMVECTORF32{0, 0, axisLength / 2}, transformIndex, Pbr::FromSRGB(Colors::Blue));
+
+        return *this;
+    }
+
+    // Based on code from DirectXTK
+    PrimitiveBuilder&
+    PrimitiveBuilder::AddSphere(float diameter, uint32_t tessellation, Pbr::NodeIndex_t transformIndex, RGBAColor vertexColor) {
+        if (tessellation < 3) {
+            throw std::out_of_range("tesselation parameter out of range");
+        }
+
+        const uint32_t verticalSegments = tessellation;
+        const uint32_t horizontalSegments = tessellation * 2;
+
+        const float radius = diameter / 2;
+
+        const uint32_t startVertexIndex = (uint32_t)Vertices.size();
+
+        // Create rings of vertices at progressively higher latitudes.
+        for (uint32_t i = 0; i <= verticalSegments; i++) {
+            const float v = 1 - (float)i / verticalSegments;
+
+            const float latitude = (i * XM_PI / verticalSegments) - XM_PIDIV2;
+            float dy, dxz;
+            XMScalarSinCos(&dy, &dxz, latitude);
+
+            // Create a single ring of vertices at this latitude.
+            for (uint32_t j = 0; j <= horizontalSegments; j++) {
+                const float longitude = j * XM_2PI / horizontalSegments;
+                float dx, dz;
+                XMScalarSinCos(&dx, &dz, longitude);
+                dx *= dxz;
+                dz *= dxz;
+
+                // Compute tangent at 90 degrees along longitude.
+                float tdx, tdz;
+                XMScalarSinCos(&tdx, &tdz, longitude + XM_PI);
+                tdx *= dxz;
+                tdz *= dxz;
+
+                const XMVECTOR normal = XMVectorSet(dx, dy, dz, 0);
+                const XMVECTOR tangent = XMVectorSet(tdx, 0, tdz, 0);
+
+                const float u = (float)j / horizontalSegments;
+                const XMVECTOR textureCoordinate = XMVectorSet(u, v, 0, 0);
+
+                Pbr::Vertex vert;
+                XMStoreFloat3(&vert.Position, XMVectorScale(normal, radius));
+                XMStoreFloat3(&vert.Normal, normal);
+                XMStoreFloat4(&vert.Tangent, tangent);
+                XMStoreFloat2(&vert.TexCoord0, textureCoordinate);
+
+                vert.Color0 = vertexColor;
+                vert.ModelTransformIndex = transformIndex;
+                Vertices.push_back(vert);
+            }
+        }
+
+        // Fill the index buffer with triangles joining each pair of latitude rings.
+        const uint32_t stride = horizontalSegments + 1;
+        for (uint32_t i = 0; i < verticalSegments; i++) {
+            for (uint32_t j = 0; j <= horizontalSegments; j++) {
+                uint32_t nextI = i + 1;
+                uint32_t nextJ = (j + 1) % stride;
+
+                Indices.push_back(startVertexIndex + (i * stride + j));
+                Indices.push_back(startVertexIndex + (nextI * stride + j));
+                Indices.push_back(startVertexIndex + (i * stride + nextJ));
+
+                Indices.push_back(startVertexIndex + (i * stride + nextJ));
+                Indices.push_back(startVertexIndex + (nextI * stride + j));
+                Indices.push_back(startVertexIndex + (nextI * stride + nextJ));
+            }
+        }
+
+        return *this;
+    }
+
+    // Based on code from DirectXTK
+    PrimitiveBuilder&
+    PrimitiveBuilder::AddCube(XMFLOAT3 sideLengths, CXMVECTOR translation, Pbr::NodeIndex_t transformIndex, RGBAColor vertexColor) {
+        // A box has six faces, each one pointing in a different direction.
+        const int FaceCount = 6;
+
+        static const XMVECTORF32 faceNormals[FaceCount] = {
+            {{{0, 0, 1, 0}}},
+            {{{0, 0, -1, 0}}},
+            {{{1, 0, 0, 0}}},
+            {{{-1, 0, 0, 0}}},
+            {{{0, 1, 0, 0}}},
+            {{{0, -1, 0, 0}}},
+        };
+
+        static const XMVECTORF32 textureCoordinates[4] = {
+            {{{1, 0, 0, 0}}},
+            {{{1, 1, 0, 0}}},
+            {{{0, 1, 0, 0}}},
+            {{{0, 0, 0, 0}}},
+        };
+
+        // Create each face in turn.
+        const XMVECTORF32 sideLengthHalfVector = {{{sideLengths.x / 2, sideLengths.y / 2, sideLengths.z / 2}}};
+
+        for (int i = 0; i < FaceCount; i++) {
+            XMVECTOR normal = faceNormals[i];
+
+            // Get two vectors perpendicular both to the face normal and to each other.
+            XMVECTOR basis = (i >= 4) ? g_XMIdentityR2 : g_XMIdentityR1;
+
+            XMVECTOR side1 = XMVector3Cross(normal, basis);
+            XMVECTOR side2 = XMVector3Cross(normal, side1);
+
+            // Six indices (two triangles) per face.
+            size_t vbase = Vertices.size();
+            Indices.push_back((uint32_t)vbase + 0);
+            Indices.push_back((uint32_t)vbase + 1);
+            Indices.push_back((uint32_t)vbase + 2);
+
+            Indices.push_back((uint32_t)vbase + 0);
+            Indices.push_back((uint32_t)vbase + 2);
+            Indices.push_back((uint32_t)vbase + 3);
+
+            const XMVECTOR positions[4] = {XMVectorMultiply(XMVectorSubtract(XMVectorSubtract(normal, side1), side2), sideLengthHalfVector),
+                                           XMVectorMultiply(XMVectorAdd(XMVectorSubtract(normal, side1), side2), sideLengthHalfVector),
+                                           XMVectorMultiply(XMVectorAdd(XMVectorAdd(normal, side1), side2), sideLengthHalfVector),
+                                           XMVectorMultiply(XMVectorSubtract(XMVectorAdd(normal, side1), side2), sideLengthHalfVector)};
+
+            for (int j = 0; j < 4; j++) {
+                Pbr::Vertex vert;
+                XMStoreFloat3(&vert.Position, XMVectorAdd(positions[j], translation));
+                XMStoreFloat3(&vert.Normal, normal);
+                XMStoreFloat4(&vert.Tangent, side1); // TODO arbitrarily picked side 1
+                XMStoreFloat2(&vert.TexCoord0, textureCoordinates[j]);
+                vert.Color0 = vertexColor;
+                vert.ModelTransformIndex = transformIndex;
+                Vertices.push_back(vert);
+            }
+        }
+
+        return *this;
+    }
+
+    PrimitiveBuilder& PrimitiveBuilder::AddCube(XMFLOAT3 sideLengths, Pbr::NodeIndex_t transformIndex, RGBAColor vertexColor) {
+        return AddCube(sideLengths, g_XMZero, transformIndex, vertexColor);
+    }
+
+    PrimitiveBuilder& PrimitiveBuilder::AddCube(float sideLength, Pbr::NodeIndex_t transformIndex, RGBAColor vertexColor) {
+        return AddCube(XMFLOAT3{sideLength, sideLength, sideLength}, transformIndex, vertexColor);
+    }
+
+    PrimitiveBuilder& PrimitiveBuilder::AddQuad(XMFLOAT2 sideLengths,
+                                                XMFLOAT2 textureCoord,
+                                                Pbr::NodeIndex_t transformIndex,
+                                                RGBAColor vertexColor) {
+        const XMFLOAT2 halfSideLength = {sideLengths.x / 2, sideLengths.y / 2};
+        const XMFLOAT3 vertices[4] = {{-halfSideLength.x, -halfSideLength.y, 0}, // LB
+                                      {-halfSideLength.x, halfSideLength.y, 0},  // LT
+                                      {halfSideLength.x, halfSideLength.y, 0},   // RT
+                                      {halfSideLength.x, -halfSideLength.y, 0}}; // RB
+        const XMFLOAT2 uvs[4] = {
+            {0, textureCoord.y},
+            {0, 0},
+            {textureCoord.x, 0},
+            {textureCoord.x, textureCoord.y},
+        };
+
+        // Two triangles.
+        auto vbase = static_cast<uint32_t>(Vertices.size());
+        Indices.push_back(vbase + 0);
+        Indices.push_back(vbase + 1);
+        Indices.push_back(vbase + 2);
+        Indices.push_back(vbase + 0);
+        Indices.push_back(vbase + 2);
+        Indices.push_back(vbase + 3);
+
+        Pbr::Vertex vert;
+        vert.Normal = {0, 0, 1};
+        vert.Tangent = {1, 0, 0, 0};
+        vert.Color0 = vertexColor;
+        vert.ModelTransformIndex = transformIndex;
+        for (size_t j = 0; j < std::size(vertices); j++) {
+            vert.Position = vertices[j];
+            vert.TexCoord0 = uvs[j];
+            Vertices.push_back(vert);
+        }
+        return *this;
+    }
+
+    namespace Texture {
+        std::array<uint8_t, 4> LoadRGBAUI4(RGBAColor color) {
+            XMFLOAT4 colorf;
+            XMStoreFloat4(&colorf, XMVectorScale(XMLoadFloat4(&color), 255));
+            return std::array<uint8_t, 4>{(uint8_t)colorf.x, (uint8_t)colorf.y, (uint8_t)colorf.z, (uint8_t)colorf.w};
+        }
+    } // namespace Texture
+
+    bool NodeTransforms::Update(const Node::Collection& nodes) {
+        const uint32_t totalModifyCount = std::accumulate(
+            nodes.begin(), nodes.end(), 0u, [](uint32_t sumChangeCount, const Node& node) { return sumChangeCount + node.m_modifyCount; });
+
+        // If none of the node transforms have changed, no need to recompute the model transforms.
+        if (totalModifyCount == m_totalModifyCount && nodes.size() == m_transforms.size()) {
+            return false;
+        }
+
+        // Nodes are guaranteed to come after their parents, so each node transform can be multiplied by its parent transform in a
+        // single pass.
+        m_transforms.resize(nodes.size());
+        for (const Node& node : nodes) {
+            assert(node.ParentNodeIndex == NodeIndex_npos || node.ParentNodeIndex < node.Index);
+            const XMMATRIX parentTransform =
+                (node.ParentNodeIndex == NodeIndex_npos) ? XMMatrixIdentity() : XMLoadFloat4x4(&m_transforms[node.ParentNodeIndex]);
+            XMStoreFloat4x4(&m_transforms[node.Index], XMMatrixMultiply(parentTransform, XMMatrixTranspose(node.GetTransform())));
+        }
+
+        m_totalModifyCount = totalModifyCount;
+        return true;
+    }
+} // namespace Pbr
@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// Data types of the Pbr rendering library which don't depend on a graphics API, shared by its Direct3D 11 renderer and
+// its OpenGL ES renderer (see PbrGles.h). Only needs the standard library and DirectXMath, so it builds on any platform.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <DirectXMath.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Pbr {
+    // The slots of the shader resources, which are registers in the HLSL shaders and texture units and uniform block
+    // bindings in the GLSL shaders.
+    namespace ShaderSlots {
+        enum VSResourceViews {
+            Transforms = 0,
+        };
+
+        enum PSMaterial { // For both samplers and textures.
+            BaseColor = 0,
+            MetallicRoughness,
+            Normal,
+            Occlusion,
+            Emissive,
+            LastMaterialSlot = Emissive
+        };
+
+        enum Pbr { // For both samplers and textures.
+            Brdf = LastMaterialSlot + 1
+        };
+
+        enum EnvironmentMap { // For both samplers and textures.
+            SpecularTexture = Brdf + 1,
+            DiffuseTexture = SpecularTexture + 1,
+            EnvironmentMapSampler = Brdf + 1
+        };
+
+        enum Atlas { // Textures only, read by the material atlas variant of the pixel shader.
+            AtlasMaterials = DiffuseTexture + 1
+        };
+
+        enum ConstantBuffers {
+            Scene,    // Used by VS and PS
+            Model,    // PS only
+            Material, // PS only
+            AtlasDraw, // PS only, read by the material atlas variant of the pixel shader
+        };
+    } // namespace ShaderSlots
+
+    enum class ShadingMode : uint32_t {
+        Regular,
+        Highlight,
+    };
+
+    enum class FillMode : uint32_t {
+        Solid,
+        Wireframe,
+    };
+
+    enum class FrontFaceWindingOrder : uint32_t {
+        ClockWise,
+        CounterClockWise,
+    };
+
+    using NodeIndex_t = uint16_t; // This type must align with the type used in the Pbr shaders.
+
+    // Indicates an invalid node index (similar to std::variant_npos)
+    inline constexpr Pbr::NodeIndex_t NodeIndex_npos = static_cast<Pbr::NodeIndex_t>(-1);
+    constexpr Pbr::NodeIndex_t RootNodeIndex = 0;
+
+    // These colors are in linear color space unless otherwise specified.
+    using RGBAColor = DirectX::XMFLOAT4;
+    using RGBColor = DirectX::XMFLOAT3;
+
+    // DirectX::Colors are in sRGB color space.
+    RGBAColor XM_CALLCONV FromSRGB(DirectX::XMVECTOR color);
+    RGBColor XM_CALLCONV RGBFromSRGB(DirectX::XMVECTOR color);
+
+    namespace RGBA {
+        constexpr RGBAColor White{1, 1, 1, 1};
+        constexpr RGBAColor Black{0, 0, 0, 1};
+        constexpr RGBAColor FlatNormal{0.5f, 0.5f, 1, 1};
+        constexpr RGBAColor Transparent{0, 0, 0, 0};
+    } // namespace RGBA
+
+    namespace RGB {
+        constexpr RGBColor White{1, 1, 1};
+        constexpr RGBColor Black{0, 0, 0};
+    } // namespace RGB
+
+    namespace Texture {
+        std::array<uint8_t, 4> LoadRGBAUI4(RGBAColor color);
+    } // namespace Texture
+
+    // Vertex structure used by the PBR shaders.
+    struct Vertex {
+        DirectX::XMFLOAT3 Position;
+        DirectX::XMFLOAT3 Normal;
+        DirectX::XMFLOAT4 Tangent;
+        DirectX::XMFLOAT4 Color0;
+        DirectX::XMFLOAT2 TexCoord0;
+        NodeIndex_t ModelTransformIndex; // Index into the node transforms
+    };
+
+    struct PrimitiveBuilder {
+        std::vector<Pbr::Vertex> Vertices;
+        std::vector<uint32_t> Indices;
+
+        PrimitiveBuilder& AddAxis(float axisLength = 1.0f,
+                                  float axisThickness = 0.1f,
+                                  Pbr::NodeIndex_t transformIndex = Pbr::RootNodeIndex);
+        PrimitiveBuilder& AddSphere(float diameter,
+                                    uint32_t tessellation,
+                                    Pbr::NodeIndex_t transformIndex = Pbr::RootNodeIndex,
+                                    RGBAColor vertexColor = RGBA::White);
+        PrimitiveBuilder& AddCube(float sideLength,
+                                  Pbr::NodeIndex_t transformIndex = Pbr::RootNodeIndex,
+                                  RGBAColor vertexColor = RGBA::White);
+        PrimitiveBuilder& AddCube(DirectX::XMFLOAT3 sideLengths,
+                                  Pbr::NodeIndex_t transformIndex = Pbr::RootNodeIndex,
+                                  RGBAColor vertexColor = RGBA::White);
+        PrimitiveBuilder& AddCube(DirectX::XMFLOAT3 sideLengths,
+                                  DirectX::CXMVECTOR translation,
+                                  Pbr::NodeIndex_t transformIndex = Pbr::RootNodeIndex,
+                                  RGBAColor vertexColor = RGBA::White);
+        PrimitiveBuilder& AddQuad(DirectX::XMFLOAT2 sideLengths,
+                                  DirectX::XMFLOAT2 textureCoord = {1, 1},
+                                  Pbr::NodeIndex_t transformIndex = Pbr::RootNodeIndex,
+                                  RGBAColor vertexColor = RGBA::White);
+    };
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4324)
+#endif
+    // Coefficients used by the shaders. Each texture is sampled and multiplied by these coefficients. The layout matches
+    // both the HLSL constant buffer and the std140 GLSL uniform block.
+    struct MaterialParameters {
+        // packoffset(c0)
+        alignas(16) RGBAColor BaseColorFactor{1, 1, 1, 1};
+        // packoffset(c1.x and c1.y)
+        alignas(16) float MetallicFactor{1};
+        float RoughnessFactor{1};
+        // packoffset(c2)
+        alignas(16) RGBColor EmissiveFactor{1, 1, 1};
+        // packoffset(c3.x, c3.y and c3.z)
+        alignas(16) float NormalScale{1};
+        float OcclusionStrength{1};
+        float AlphaCutoff{0};
+    };
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+    static_assert((sizeof(MaterialParameters) % 16) == 0, "Constant Buffer must be divisible by 16 bytes");
+
+    // Node for creating a hierarchy of transforms. These transforms are referenced by vertices in the model's primitives.
+    struct Node {
+        using Collection = std::vector<Node>;
+
+        Node(DirectX::CXMMATRIX localTransform, std::string name, NodeIndex_t index, NodeIndex_t parentNodeIndex)
+            : Name(std::move(name))
+            , Index(index)
+            , ParentNodeIndex(parentNodeIndex) {
+            SetTransform(localTransform);
+        }
+
+        // Set the local transform for this node.
+        void XM_CALLCONV SetTransform(DirectX::FXMMATRIX transform) {
+            DirectX::XMStoreFloat4x4(&m_localTransform, transform);
+#ifdef _MSC_VER
+            _InterlockedIncrement(reinterpret_cast<volatile long*>(&m_modifyCount));
+#else
+            __atomic_add_fetch(&m_modifyCount, 1, __ATOMIC_SEQ_CST);
+#endif
+        }
+
+        // Get the local transform for this node.
+        DirectX::XMMATRIX XM_CALLCONV GetTransform() const {
+            return DirectX::XMLoadFloat4x4(&m_localTransform);
+        }
+
+        const std::string Name;
+        const NodeIndex_t Index;
+        const NodeIndex_t ParentNodeIndex;
+
+    private:
+        friend class NodeTransforms;
+        uint32_t m_modifyCount{0};
+        DirectX::XMFLOAT4X4 m_localTransform;
+    };
+
+    // The transforms of the nodes of a model relative to its root, which the vertex shaders read by the node index of each
+    // vertex. They are stored transposed, the layout both the HLSL and GLSL shaders read.
+    class NodeTransforms {
+    public:
+        // Computes the transforms again if a node was added or changed since the last update. Returns true if they did.
+        bool Update(const Node::Collection& nodes);
+
+        const std::vector<DirectX::XMFLOAT4X4>& Transforms() const {
+            return m_transforms;
+        }
+
+    private:
+        std::vector<DirectX::XMFLOAT4X4> m_transforms;
+        uint32_t m_totalModifyCount{0};
+    };
+} // namespace Pbr
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+// Doesn't use the precompiled header, which includes Windows headers, so that it builds on any platform.
+#include <optional>
+#include "PbrUploadQueue.h"
+
+namespace Pbr {
+    void UploadQueue::Enqueue(const std::shared_ptr<UploadBatch>& batch, Upload upload) {
+        batch->m_pendingCount++;
+
+        std::lock_guard lock(m_mutex);
+        const EntryKey key{-static_cast<int>(batch->Priority()), static_cast<int>(upload.Stage), m_nextSequence++};
+        m_entries.emplace(key, Entry{batch, std::move(upload)});
+    }
+
+    UploadStatistics UploadQueue::Process(const UploadBudget& budget) {
+        using Clock = std::chrono::high_resolution_clock;
+        const Clock::time_point start = Clock::now();
+
+        UploadStatistics statistics;
+
+        // The scan resumes after the entry taken last, so entries waiting for their data are asked once per call rather than
+        // once per upload. Only Process erases entries, so the position stays valid while the lock is released to run an
+        // upload. Entries enqueued before the position meanwhile wait for the next call.
+        std::unique_lock lock(m_mutex);
+        auto it = m_entries.begin();
+        lock.unlock();
+
+        for (;;) {
+            std::optional<Entry> entry;
+            lock.lock();
+            while (it != m_entries.end()) {
+                if (it->second.Work.IsReady && !it->second.Work.IsReady()) {
+                    ++it;
+                    continue;
+                }
+
+                if (it->second.Batch->IsCancelled()) {
+                    // Dropped here rather than on Cancel, so the data of the upload is released off the worker threads.
+                    it->second.Batch->m_pendingCount--;
+                    it = m_entries.erase(it);
+                    continue;
+                }
+
+                const size_t size = it->second.Work.Size ? it->second.Work.Size() : 0;
+                if (statistics.UploadCount > 0 && statistics.Bytes + size > budget.Bytes) {
+                    break;
+                }
+
+                statistics.Bytes += size;
+                entry = std::move(it->second);
+                it = m_entries.erase(it);
+                break;
+            }
+            lock.unlock();
+
+            if (!entry) {
+                break;
+            }
+
+            try {
+                entry->Work.Run();
+            } catch (...) {
+                {
+                    std::lock_guard errorLock(entry->Batch->m_errorMutex);
+                    entry->Batch->m_error = std::current_exception();
+                }
+                entry->Batch->Cancel();
+            }
+
+            entry->Batch->m_pendingCount--;
+            statistics.UploadCount++;
+            if (Clock::now() - start >= budget.Duration) {
+                break;
+            }
+        }
+
+        statistics.Duration = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+
+        lock.lock();
+        statistics.PendingCount = static_cast<uint32_t>(m_entries.size());
+        m_lastStatistics = statistics;
+        return statistics;
+    }
+
+    UploadStatistics UploadQueue::LastStatistics() const {
+        std::lock_guard lock(m_mutex);
+        return m_lastStatistics;
+    }
+} // namespace Pbr
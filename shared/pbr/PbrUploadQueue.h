@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// A queue spreading the creation of GPU resources over frames, within a per-frame budget.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace Pbr {
+    enum class UploadPriority {
+        Low,
+        Normal,
+        High, // For content the user is waiting for, such as controller models
+    };
+
+    // Uploads of the same priority run by stage, so the geometry of every queued model appears before any of their textures.
+    enum class UploadStage {
+        Geometry,
+        Textures,
+    };
+
+    // A piece of work creating GPU resources, run by the upload queue on the thread that calls UploadQueue::Process.
+    struct Upload {
+        UploadStage Stage{UploadStage::Geometry};
+
+        // Whether the data to upload is ready, for data prepared on worker threads. Uploads are skipped until their data is
+        // ready. Null if the data is always ready.
+        std::function<bool()> IsReady;
+
+        // The bytes sent to the GPU, once the data is ready. Counted against the byte budget.
+        std::function<size_t()> Size;
+
+        std::function<void()> Run;
+    };
+
+    // Uploads enqueued together, such as the resources of one model, which share a priority and are cancelled together.
+    class UploadBatch {
+    public:
+        explicit UploadBatch(UploadPriority priority)
+            : m_priority(priority) {
+        }
+
+        UploadPriority Priority() const {
+            return m_priority;
+        }
+
+        // Drops the uploads of the batch that didn't run yet. Uploads waiting for their data are dropped once it is ready, so
+        // cancelling never waits for the worker threads preparing it.
+        void Cancel() {
+            m_cancelled = true;
+        }
+
+        bool IsCancelled() const {
+            return m_cancelled;
+        }
+
+        // Whether every upload enqueued so far ran, or was dropped after a cancel or failure.
+        bool IsComplete() const {
+            return m_pendingCount == 0;
+        }
+
+        // The exception thrown by the upload that failed, which cancels the rest of the batch. Null if none failed.
+        std::exception_ptr Error() const {
+            std::lock_guard lock(m_errorMutex);
+            return m_error;
+        }
+
+    private:
+        friend class UploadQueue;
+
+        const UploadPriority m_priority;
+        std::atomic<bool> m_cancelled{false};
+        std::atomic<uint32_t> m_pendingCount{0};
+        mutable std::mutex m_errorMutex;
+        std::exception_ptr m_error;
+    };
+
+    struct UploadBudget {
+        size_t Bytes{16 * 1024 * 1024};
+        std::chrono::microseconds Duration{2000};
+    };
+
+    // The uploads done by one call to UploadQueue::Process.
+    struct UploadStatistics {
+        size_t Bytes{0};
+        std::chrono::microseconds Duration{0};
+        uint32_t UploadCount{0};
+        uint32_t PendingCount{0}; // Uploads left in the queue, including those waiting for their data
+    };
+
+    // Uploads are enqueued from any thread, and run by Process once per frame on the thread that renders. Higher priorities
+    // run first, then earlier stages, then the order they were enqueued in.
+    class UploadQueue {
+    public:
+        UploadQueue() = default;
+        UploadQueue(const UploadQueue&) = delete;
+        UploadQueue& operator=(const UploadQueue&) = delete;
+
+        std::shared_ptr<UploadBatch> CreateBatch(UploadPriority priority = UploadPriority::Normal) const {
+            return std::make_shared<UploadBatch>(priority);
+        }
+
+        void Enqueue(const std::shared_ptr<UploadBatch>& batch, Upload upload);
+
+        // Runs uploads until the budget is spent. At least one upload runs if any is ready, so uploads larger than the budget
+        // still make progress. Exceptions thrown by uploads are kept by their batch.
+        UploadStatistics Process(const UploadBudget& budget);
+
+        // The statistics of the most recent call to Process.
+        UploadStatistics LastStatistics() const;
+
+    private:
+        struct Entry {
+            std::shared_ptr<UploadBatch> Batch;
+            Upload Work;
+        };
+
+        // Ordered by descending priority, stage and sequence number.
+        using EntryKey = std::tuple<int, int, uint64_t>;
+
+        mutable std::mutex m_mutex;
+        std::map<EntryKey, Entry> m_entries;
+        uint64_t m_nextSequence{0};
+        UploadStatistics m_lastStatistics;
+    };
+} // namespace Pbr
@@ -9,4 +9,8 @@ struct PSInputFlat
     float4 PositionProj : SV_POSITION;
     float3 PositionWorld: POSITION1;
     nointerpolation float3 NormalWorld : Normal;
+#ifdef USE_VPRT
+    // Written by the vertex shader variant for single pass rendering. The pixel shader doesn't read it, so it is declared last.
+    uint RTIndex        : SV_RenderTargetArrayIndex;
+#endif
 };
\ No newline at end of file
@@ -10,6 +10,7 @@ StructuredBuffer<float4x4> Transforms : register(t0);
 cbuffer ModelConstantBuffer : register(b1)
 {
     float4x4 ModelToWorld  : packoffset(c0);
+    uint ViewIndexOffset   : packoffset(c4.x); // The view rendered by instance 0 of the draw
 };
 
 struct VSInputFlat
@@ -20,6 +21,7 @@ struct VSInputFlat
     float4      Color0              : COLOR0;
     float2      TexCoord0           : TEXCOORD0;
     min16uint   ModelTransformIndex : TRANSFORMINDEX;
+    uint        InstanceId          : SV_InstanceID;
 };
 
 #define VSOutputFlat PSInputFlat
@@ -29,9 +31,14 @@ VSOutputFlat main(VSInputFlat input)
 
     const float4x4 modelTransform = mul(Transforms[input.ModelTransformIndex], ModelToWorld);
     const float4 transformedPosWorld = mul(input.Position, modelTransform);
-    output.PositionProj = mul(transformedPosWorld, ViewProjection);
+    // Each instance of a draw renders one view.
+    const uint viewIndex = input.InstanceId + ViewIndexOffset;
+    output.PositionProj = mul(transformedPosWorld, ViewProjection[viewIndex]);
     output.PositionWorld = transformedPosWorld.xyz / transformedPosWorld.w;
     output.NormalWorld = mul(input.Normal, (float3x3)modelTransform).xyz;
+#ifdef USE_VPRT
+    output.RTIndex = viewIndex;
+#endif
 
     return output;
 }
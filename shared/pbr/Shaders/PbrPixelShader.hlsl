@@ -18,6 +18,39 @@
 
 #include "PbrShared.hlsl"
 
+#ifdef USE_MATERIAL_ATLAS
+// The material atlas variant reads the textures of the material from layers of texture arrays, and its parameters from a
+// structured buffer, indexed by the draw. Must match AtlasMaterialData in PbrMaterialAtlas.h.
+struct AtlasMaterial
+{
+    float4 BaseColorFactor;
+    float3 EmissiveFactor;
+    float MetallicFactor;
+    float RoughnessFactor;
+    float NormalScale;
+    float OcclusionStrength;
+    float AlphaCutoff;
+    uint Layers[5];
+    uint3 Padding;
+};
+
+cbuffer AtlasDrawConstantBuffer : register(b3)
+{
+    uint MaterialIndex;
+};
+
+StructuredBuffer<AtlasMaterial> AtlasMaterials : register(t8);
+
+Texture2DArray<float4> BaseColorTexture         : register(t0);
+Texture2DArray<float3> MetallicRoughnessTexture : register(t1); // Green(y)=Roughness, Blue(z)=Metallic
+Texture2DArray<float3> NormalTexture            : register(t2);
+Texture2DArray<float3> OcclusionTexture         : register(t3); // Red(x) channel
+Texture2DArray<float3> EmissiveTexture          : register(t4);
+
+#define MATERIAL_PARAMETER(name) AtlasMaterials[MaterialIndex].name
+#define SAMPLE_MATERIAL(materialTexture, textureSampler, uv, slot) \
+    materialTexture.Sample(textureSampler, float3(uv, AtlasMaterials[MaterialIndex].Layers[slot]))
+#else
 cbuffer MaterialConstantBuffer : register(b2)
 {
     float4 BaseColorFactor  : packoffset(c0);
@@ -35,6 +68,11 @@ Texture2D<float3> MetallicRoughnessTexture  : register(t1); // Green(y)=Roughnes
 Texture2D<float3> NormalTexture             : register(t2);
 Texture2D<float3> OcclusionTexture          : register(t3); // Red(x) channel
 Texture2D<float3> EmissiveTexture           : register(t4);
+
+#define MATERIAL_PARAMETER(name) name
+#define SAMPLE_MATERIAL(materialTexture, textureSampler, uv, slot) materialTexture.Sample(textureSampler, uv)
+#endif
+
 Texture2D<float3> BRDFTexture               : register(t5);
 TextureCube<float3> SpecularTexture         : register(t6);
 TextureCube<float3> DiffuseTexture          : register(t7);
@@ -94,14 +132,15 @@ float4 main(PSInputPbr input) : SV_TARGET
 {
     // Roughness is stored in the 'g' channel, metallic is stored in the 'b' channel.
     // This layout intentionally reserves the 'r' channel for (optional) occlusion map data
-    const float3 mrSample = MetallicRoughnessTexture.Sample(MetallicRoughnessSampler, input.TexCoord0);
-    const float4 baseColor = BaseColorTexture.Sample(BaseColorSampler, input.TexCoord0) * input.Color0 * BaseColorFactor;
+    const float3 mrSample = SAMPLE_MATERIAL(MetallicRoughnessTexture, MetallicRoughnessSampler, input.TexCoord0, 1);
+    const float4 baseColor =
+        SAMPLE_MATERIAL(BaseColorTexture, BaseColorSampler, input.TexCoord0, 0) * input.Color0 * MATERIAL_PARAMETER(BaseColorFactor);
 
     // Discard if below alpha cutoff.
-    clip(baseColor.a - AlphaCutoff);
+    clip(baseColor.a - MATERIAL_PARAMETER(AlphaCutoff));
 
-    const float metallic = saturate(mrSample.b * MetallicFactor);
-    const float perceptualRoughness = clamp(mrSample.g * RoughnessFactor, MinRoughness, 1.0);
+    const float metallic = saturate(mrSample.b * MATERIAL_PARAMETER(MetallicFactor));
+    const float perceptualRoughness = clamp(mrSample.g * MATERIAL_PARAMETER(RoughnessFactor), MinRoughness, 1.0);
 
     // Roughness is authored as perceptual roughness; as is convention,
     // convert to material roughness by squaring the perceptual roughness [2].
@@ -120,10 +159,13 @@ float4 main(PSInputPbr input) : SV_TARGET
     const float3 specularEnvironmentR90 = float3(1.0, 1.0, 1.0) * reflectance90;
 
     // normal at surface point
-    float3 n = 2.0 * NormalTexture.Sample(NormalSampler, input.TexCoord0) - 1.0;
-    n = normalize(mul(n * float3(NormalScale, NormalScale, 1.0), input.TBN));
+    // Only x and y are read, and z is reconstructed from them, so two-channel (BC5) normal maps work too.
+    const float2 nxy = 2.0 * SAMPLE_MATERIAL(NormalTexture, NormalSampler, input.TexCoord0, 2).xy - 1.0;
+    float3 n = float3(nxy, sqrt(saturate(1.0 - dot(nxy, nxy))));
+    const float normalScale = MATERIAL_PARAMETER(NormalScale);
+    n = normalize(mul(n * float3(normalScale, normalScale, 1.0), input.TBN));
 
-    const float3 v = normalize(EyePosition - input.PositionWorld);   // Vector from surface point to camera
+    const float3 v = normalize(EyePosition[input.ViewIndex].xyz - input.PositionWorld);   // Vector from surface point to camera
     const float3 l = normalize(LightDirection);                           // Vector from surface point to light
     const float3 h = normalize(l + v);                                    // Half vector between both l and v
     const float3 reflection = -normalize(reflect(v, n));
@@ -148,10 +190,10 @@ float4 main(PSInputPbr input) : SV_TARGET
     color += getIBLContribution(perceptualRoughness, NdotV, diffuseColor, specularColor, n, reflection);
 
     // Apply optional PBR terms for additional (optional) shading
-    const float ao = OcclusionTexture.Sample(OcclusionSampler, input.TexCoord0).r;
-    color = lerp(color, color * ao, OcclusionStrength);
+    const float ao = SAMPLE_MATERIAL(OcclusionTexture, OcclusionSampler, input.TexCoord0, 3).r;
+    color = lerp(color, color * ao, MATERIAL_PARAMETER(OcclusionStrength));
 
-    const float3 emissive = EmissiveTexture.Sample(EmissiveSampler, input.TexCoord0) * EmissiveFactor;
+    const float3 emissive = SAMPLE_MATERIAL(EmissiveTexture, EmissiveSampler, input.TexCoord0, 4) * MATERIAL_PARAMETER(EmissiveFactor);
     color += emissive;
 
     return float4(color, baseColor.a);
@@ -0,0 +1,9 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// The Pbr pixel shader for materials packed into a material atlas, see Pbr::MaterialAtlas.
+//
+
+#define USE_MATERIAL_ATLAS
+#include "PbrPixelShader.hlsl"
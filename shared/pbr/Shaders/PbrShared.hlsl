@@ -11,4 +11,9 @@ struct PSInputPbr
     float3x3 TBN        : TANGENT;
     float2 TexCoord0    : TEXCOORD0;
     float4 Color0       : COLOR0;
+    nointerpolation uint ViewIndex : VIEWINDEX;
+#ifdef USE_VPRT
+    // Written by the vertex shader variant for single pass rendering. The pixel shader doesn't read it, so it is declared last.
+    uint RTIndex        : SV_RenderTargetArrayIndex;
+#endif
 };
\ No newline at end of file
@@ -23,6 +23,7 @@ StructuredBuffer<float4x4> Transforms : register(t0);
 cbuffer ModelConstantBuffer : register(b1)
 {
     float4x4 ModelToWorld  : packoffset(c0);
+    uint ViewIndexOffset   : packoffset(c4.x); // The view rendered by instance 0 of the draw
 
 };
 
@@ -34,6 +35,7 @@ struct VSInputPbr
     float4      Color0              : COLOR0;
     float2      TexCoord0           : TEXCOORD0;
     min16uint   ModelTransformIndex : TRANSFORMINDEX;
+    uint        InstanceId          : SV_InstanceID;
 };
 
 #define VSOutputPbr PSInputPbr
@@ -43,7 +45,9 @@ VSOutputPbr main(VSInputPbr input)
 
     const float4x4 modelTransform = mul(Transforms[input.ModelTransformIndex], ModelToWorld);
     const float4 transformedPosWorld = mul(input.Position, modelTransform);
-    output.PositionProj = mul(transformedPosWorld, ViewProjection);
+    // Each instance of a draw renders one view.
+    const uint viewIndex = input.InstanceId + ViewIndexOffset;
+    output.PositionProj = mul(transformedPosWorld, ViewProjection[viewIndex]);
     output.PositionWorld = transformedPosWorld.xyz / transformedPosWorld.w;
 
     const float3 normalW = normalize(mul(float4(input.Normal, 0.0), modelTransform).xyz);
@@ -53,6 +57,10 @@ VSOutputPbr main(VSInputPbr input)
 
     output.TexCoord0 = input.TexCoord0;
     output.Color0 = input.Color0;
+    output.ViewIndex = viewIndex;
+#ifdef USE_VPRT
+    output.RTIndex = viewIndex;
+#endif
 
     return output;
 }
@@ -0,0 +1,10 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) Microsoft Corporation.  All Rights Reserved
+// Licensed under the MIT License. See License.txt in the project root for license information.
+//
+// The Pbr vertex shader for rendering all views in a single pass, which selects the render target array slice of each
+// instance. Requires the VPAndRTArrayIndexFromAnyShaderFeedingRasterizer feature.
+//
+
+#define USE_VPRT
+#include "PbrVertexShader.hlsl"
@@ -0,0 +1,72 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+// Replaces the global operator new and delete to count the heap allocations made by every thread of the process while an
+// AllocationCounter is alive. Include it in exactly one source file of a test executable.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace test {
+    inline std::atomic<bool> g_countAllocations{false};
+    inline std::atomic<size_t> g_allocationCount{0};
+
+    inline void* CountedAllocate(size_t size) {
+        if (g_countAllocations.load(std::memory_order_relaxed)) {
+            g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+            return ptr;
+        }
+        throw std::bad_alloc();
+    }
+
+    // Counts the allocations made while it is alive.
+    class AllocationCounter {
+    public:
+        AllocationCounter() {
+            g_allocationCount = 0;
+            g_countAllocations = true;
+        }
+        ~AllocationCounter() {
+            g_countAllocations = false;
+        }
+        size_t Count() const {
+            return g_allocationCount.load();
+        }
+    };
+} // namespace test
+
+void* operator new(size_t size) {
+    return test::CountedAllocate(size);
+}
+void* operator new[](size_t size) {
+    return test::CountedAllocate(size);
+}
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
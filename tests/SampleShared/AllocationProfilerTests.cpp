@@ -0,0 +1,137 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <atomic>
+#include <cstring>
+#include <SampleShared/AllocationProfiler.h>
+#include <SampleShared/AllocationProfilerHooks.h>
+#include "TestFramework.h"
+
+#if defined(__linux__)
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Written through a volatile pointer, so that the compiler can't elide the allocations.
+    int* volatile g_sink = nullptr;
+
+    void AllocateInts(int count) {
+        for (int i = 0; i < count; i++) {
+            g_sink = new int(i);
+            delete g_sink;
+        }
+    }
+
+    sample::allocation::Stats LastFrameOf(const char* scopeName) {
+        sample::allocation::ScopeStats stats[64];
+        const size_t count = sample::allocation::GetScopeStats(stats, 64);
+        for (size_t i = 0; i < count; i++) {
+            if (std::strcmp(stats[i].Name, scopeName) == 0) {
+                return stats[i].LastFrame;
+            }
+        }
+        return {};
+    }
+
+    std::atomic<int> g_violationCount{0};
+    void CountViolation(const char*, size_t) {
+        g_violationCount++;
+    }
+} // namespace
+
+TEST_CASE(HooksAreInstalled) {
+    CHECK(sample::allocation::IsInstalled());
+}
+
+TEST_CASE(AllocationsAreAttributedToTheInnermostScope) {
+    sample::allocation::BeginFrame();
+    {
+        sample::allocation::Scope outer("Test::Outer");
+        AllocateInts(1);
+        {
+            sample::allocation::Scope inner("Test::Inner");
+            AllocateInts(2);
+        }
+        AllocateInts(3);
+    }
+    sample::allocation::BeginFrame();
+
+    const sample::allocation::Stats outer = LastFrameOf("Test::Outer");
+    CHECK(outer.AllocationCount == 4);
+    CHECK(outer.AllocatedBytes == 4 * sizeof(int));
+    CHECK(outer.FreeCount == 4);
+    CHECK(LastFrameOf("Test::Inner").AllocationCount == 2);
+
+    sample::allocation::BeginFrame(); // A frame without allocations.
+    CHECK(LastFrameOf("Test::Outer").AllocationCount == 0);
+}
+
+TEST_CASE(StrictSteadyStateReportsAllocationsAfterWarmup) {
+    g_violationCount = 0;
+    sample::allocation::EnableStrictSteadyState(2, &CountViolation);
+    for (int frame = 0; frame < 2; frame++) {
+        sample::allocation::BeginFrame();
+        sample::allocation::Scope scope("Test::Warmup");
+        AllocateInts(1);
+    }
+    CHECK(g_violationCount == 0);
+
+    sample::allocation::BeginFrame();
+    {
+        AllocateInts(1); // Outside of any scope, so not part of the frame loop.
+        sample::allocation::Scope scope("Test::SteadyState");
+        {
+            sample::allocation::AllowAllocationsScope allowAllocations;
+            AllocateInts(1);
+        }
+        CHECK(g_violationCount == 0);
+        AllocateInts(2);
+    }
+    CHECK(g_violationCount == 2);
+
+    // Tracing the statistics allocates, but is allowed to.
+    {
+        sample::allocation::Scope scope("Test::SteadyState");
+        sample::allocation::TraceLastFrame();
+    }
+    CHECK(g_violationCount == 2);
+
+    sample::allocation::DisableStrictSteadyState();
+    {
+        sample::allocation::Scope scope("Test::SteadyState");
+        AllocateInts(1);
+    }
+    CHECK(g_violationCount == 2);
+}
+
+#if defined(__linux__)
+// Without a handler, a steady-state allocation stops the process, in release builds too.
+TEST_CASE(StrictSteadyStateFailsWithoutHandler) {
+    const pid_t child = fork();
+    REQUIRE(child >= 0);
+    if (child == 0) {
+        sample::allocation::EnableStrictSteadyState(0);
+        sample::allocation::BeginFrame();
+        sample::allocation::Scope scope("Test::Fails");
+        AllocateInts(1);
+        _exit(0);
+    }
+    int status = 0;
+    REQUIRE(waitpid(child, &status, 0) == child);
+    CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT);
+}
+#endif
@@ -0,0 +1,144 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <cstdint>
+#include <FrameArena.h>
+#include "AllocationCounter.h"
+#include "TestFramework.h"
+
+namespace {
+    struct LayerInfo {
+        uint32_t Type;
+        const void* Next;
+        float Values[6];
+    };
+
+    // The per-view configuration layers of XrApp::RenderFrame: containers that are themselves built from the arena.
+    struct ViewConfigLayers {
+        explicit ViewConfigLayers(sample::FrameArena& arena)
+            : Quads(arena)
+            , Headers(arena) {
+        }
+        sample::FrameVector<LayerInfo> Quads;
+        sample::FrameVector<const LayerInfo*> Headers;
+    };
+
+    // Builds the containers of one frame, with a varying number of items like the visible quads of a scene.
+    size_t BuildFrame(sample::FrameArena& arena, uint32_t frameIndex) {
+        arena.Reset();
+
+        sample::FrameVector<LayerInfo> secondaryInfos(arena);
+        secondaryInfos.reserve(2);
+        secondaryInfos.push_back(LayerInfo{1, nullptr, {}});
+
+        sample::FrameVector<ViewConfigLayers> layersForAllViewConfigs(arena);
+        layersForAllViewConfigs.reserve(1 + secondaryInfos.size());
+        for (size_t i = 0; i < 1 + secondaryInfos.size(); i++) {
+            layersForAllViewConfigs.emplace_back(arena);
+        }
+
+        size_t itemCount = 0;
+        for (ViewConfigLayers& layers : layersForAllViewConfigs) {
+            const uint32_t quadCount = 4 + frameIndex % 13; // Not reserved, so the vectors grow.
+            for (uint32_t quad = 0; quad < quadCount; quad++) {
+                layers.Quads.push_back(LayerInfo{quad, nullptr, {}});
+            }
+            for (const LayerInfo& quad : layers.Quads) {
+                layers.Headers.push_back(&quad);
+            }
+            itemCount += layers.Headers.size();
+        }
+        return itemCount;
+    }
+} // namespace
+
+TEST_CASE(AllocationsAreAligned) {
+    sample::FrameArena arena(256);
+    for (size_t alignment : {1, 2, 4, 8, 16, 32, 64, 128}) {
+        arena.Allocate(3, 1);
+        void* ptr = arena.Allocate(24, alignment);
+        CHECK(reinterpret_cast<uintptr_t>(ptr) % alignment == 0);
+    }
+}
+
+TEST_CASE(OnlyTheLastAllocationIsGivenBack) {
+    sample::FrameArena arena(1024);
+    void* first = arena.Allocate(64, 16);
+    void* second = arena.Allocate(64, 16);
+    arena.Deallocate(second, 64);
+    CHECK(arena.Allocate(64, 16) == second);
+
+    // The first allocation is not at the top, so it is only reclaimed by Reset.
+    arena.Deallocate(first, 64);
+    CHECK(arena.Allocate(64, 16) != first);
+    arena.Reset();
+    CHECK(arena.Allocate(64, 16) == first);
+}
+
+// A growing vector allocates its new buffer before it frees the old one, so the old buffers are not reused.
+TEST_CASE(GrowingVectorDoesNotReuseOldBuffers) {
+    sample::FrameArena arena(64 * 1024);
+    sample::FrameVector<uint64_t> values(arena);
+    std::vector<const uint64_t*> buffers;
+    for (uint64_t i = 0; i < 1000; i++) {
+        if (values.size() == values.capacity()) {
+            values.push_back(i);
+            buffers.push_back(values.data());
+        } else {
+            values.push_back(i);
+        }
+    }
+    for (size_t i = 1; i < buffers.size(); i++) {
+        CHECK(buffers[i] > buffers[i - 1]);
+    }
+}
+
+TEST_CASE(ResetGrowsToTheWorkingSet) {
+    sample::FrameArena arena(128);
+    for (int frame = 0; frame < 3; frame++) {
+        arena.Reset();
+        for (int i = 0; i < 100; i++) {
+            arena.Allocate(100);
+        }
+    }
+    const uint32_t growthCount = arena.GrowthCount();
+    CHECK(growthCount > 0);
+    CHECK(arena.Capacity() >= 100 * 100);
+
+    for (int frame = 0; frame < 10; frame++) {
+        arena.Reset();
+        for (int i = 0; i < 100; i++) {
+            arena.Allocate(100);
+        }
+    }
+    CHECK(arena.GrowthCount() == growthCount);
+}
+
+// The frame loop must not touch the heap once the arena has grown to its working set. The tests are built in release, so this
+// also checks the optimized containers.
+TEST_CASE(SteadyStateFrameDoesNotAllocate) {
+    sample::FrameArena arena(256);
+    size_t itemCount = 0;
+    for (uint32_t frame = 0; frame < 16; frame++) {
+        itemCount += BuildFrame(arena, frame);
+    }
+
+    test::AllocationCounter counter;
+    for (uint32_t frame = 0; frame < 1000; frame++) {
+        itemCount += BuildFrame(arena, frame);
+    }
+    CHECK(counter.Count() == 0);
+    CHECK(itemCount > 0);
+}
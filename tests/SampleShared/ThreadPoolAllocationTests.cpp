@@ -0,0 +1,102 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <array>
+#include <ThreadPool.h>
+#include "AllocationCounter.h"
+#include "TestFramework.h"
+
+// Checks that the thread pool recycles its task nodes and stores small task captures inline once it has warmed up.
+
+namespace {
+    // A typical task: a few pointers and indices, well under UniqueFunction::InlineSize.
+    struct CountingTask {
+        std::atomic<size_t>* Counter;
+        size_t Index;
+        void operator()() const {
+            Counter->fetch_add(Index % 2 + 1, std::memory_order_relaxed);
+        }
+    };
+
+    void WaitForCount(const std::atomic<size_t>& count, size_t expected) {
+        while (count.load(std::memory_order_acquire) < expected) {
+            std::this_thread::yield();
+        }
+    }
+
+    // One round of the kinds of submission a frame makes: external Submit and SubmitBatch, Submit from within a worker,
+    // a task group and a parallel loop.
+    void SubmitRound(sample::ThreadPool& pool) {
+        constexpr size_t TaskCount = 200;
+        std::atomic<size_t> counter{0};
+        size_t expected = 0;
+        for (size_t i = 0; i < TaskCount; i++) {
+            pool.Submit(CountingTask{&counter, i});
+            expected += i % 2 + 1;
+        }
+
+        std::array<CountingTask, 64> batch;
+        for (size_t i = 0; i < batch.size(); i++) {
+            batch[i] = CountingTask{&counter, i};
+            expected += i % 2 + 1;
+        }
+        pool.SubmitBatch(batch.begin(), batch.end());
+
+        pool.Submit([&pool, &counter] {
+            for (size_t i = 0; i < TaskCount; i++) {
+                pool.Submit(CountingTask{&counter, i});
+            }
+        });
+        for (size_t i = 0; i < TaskCount; i++) {
+            expected += i % 2 + 1;
+        }
+        WaitForCount(counter, expected);
+
+        sample::ThreadPool::TaskGroup group(pool);
+        for (size_t i = 0; i < TaskCount; i++) {
+            group.Run(CountingTask{&counter, i});
+        }
+        group.Wait();
+
+        pool.ParallelFor(0, 10000, [&counter](size_t i) { counter.fetch_add(i & 1, std::memory_order_relaxed); });
+    }
+} // namespace
+
+TEST_CASE(SteadyStateSubmissionDoesNotAllocate) {
+    sample::ThreadPool pool(4);
+    pool.ReserveTasks(1024); // More than a round ever has in flight.
+    for (int warmup = 0; warmup < 10; warmup++) {
+        SubmitRound(pool);
+    }
+
+    test::AllocationCounter counter;
+    for (int round = 0; round < 50; round++) {
+        SubmitRound(pool);
+    }
+    CHECK(counter.Count() == 0);
+}
+
+// Captures larger than the inline budget fall back to the heap, which the counter must see.
+TEST_CASE(LargeCapturesAreCounted) {
+    sample::ThreadPool pool(2);
+    SubmitRound(pool);
+
+    std::array<char, 256> large{};
+    std::atomic<size_t> done{0};
+    test::AllocationCounter counter;
+    pool.Submit([large, &done] { done += large.size(); });
+    WaitForCount(done, large.size());
+    CHECK(counter.Count() > 0);
+}
@@ -0,0 +1,171 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <ThreadPool.h>
+
+// Compares the work-stealing ThreadPool against a pool of threads sharing one locked queue of std::function, which is how the
+// pool worked before, on fine-grained tasks where the scheduling overhead dominates.
+// Usage: ThreadPoolBenchmark [--quick]
+
+namespace {
+    class LockedQueuePool {
+    public:
+        explicit LockedQueuePool(size_t threadCount) {
+            for (size_t i = 0; i < threadCount; i++) {
+                m_threads.emplace_back([this] { WorkerLoop(); });
+            }
+        }
+
+        ~LockedQueuePool() {
+            {
+                std::lock_guard guard(m_mutex);
+                m_stopped = true;
+            }
+            m_condition.notify_all();
+            for (std::thread& thread : m_threads) {
+                thread.join();
+            }
+        }
+
+        void Submit(std::function<void()> task) {
+            {
+                std::lock_guard guard(m_mutex);
+                m_tasks.push_back(std::move(task));
+            }
+            m_condition.notify_one();
+        }
+
+    private:
+        void WorkerLoop() {
+            for (;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lk(m_mutex);
+                    m_condition.wait(lk, [&] { return m_stopped || !m_tasks.empty(); });
+                    if (m_tasks.empty()) {
+                        return;
+                    }
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<std::function<void()>> m_tasks;
+        bool m_stopped{false};
+        std::vector<std::thread> m_threads;
+    };
+
+    // A few hundred nanoseconds of work, so that the cost of scheduling dominates.
+    uint64_t SmallWork(uint64_t seed) {
+        for (int i = 0; i < 64; i++) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        }
+        return seed;
+    }
+
+    template <typename F>
+    double MeasureMilliseconds(F&& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void WaitForCount(const std::atomic<size_t>& count, size_t expected) {
+        while (count.load(std::memory_order_acquire) != expected) {
+            std::this_thread::yield();
+        }
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    const bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    const size_t taskCount = quick ? 20000 : 1000000;
+    const size_t threadCount = std::max<size_t>(2, std::thread::hardware_concurrency());
+    bool correct = true;
+
+    std::atomic<uint64_t> sink{0};
+    std::atomic<size_t> completed{0};
+
+    const double lockedMs = MeasureMilliseconds([&] {
+        LockedQueuePool pool(threadCount);
+        for (size_t i = 0; i < taskCount; i++) {
+            pool.Submit([&sink, &completed, i] {
+                sink.fetch_add(SmallWork(i), std::memory_order_relaxed);
+                completed.fetch_add(1, std::memory_order_release);
+            });
+        }
+        WaitForCount(completed, taskCount);
+    });
+    correct &= completed == taskCount;
+
+    completed = 0;
+    const double submitMs = MeasureMilliseconds([&] {
+        sample::ThreadPool pool(threadCount);
+        for (size_t i = 0; i < taskCount; i++) {
+            pool.Submit([&sink, &completed, i] {
+                sink.fetch_add(SmallWork(i), std::memory_order_relaxed);
+                completed.fetch_add(1, std::memory_order_release);
+            });
+        }
+        WaitForCount(completed, taskCount);
+    });
+    correct &= completed == taskCount;
+
+    // Tasks spawned from within the pool go to the workers' own deques instead of the shared queue.
+    completed = 0;
+    const double nestedMs = MeasureMilliseconds([&] {
+        sample::ThreadPool pool(threadCount);
+        sample::ThreadPool::TaskGroup group(pool);
+        const size_t producers = threadCount * 4;
+        for (size_t p = 0; p < producers; p++) {
+            group.Run([&, p] {
+                for (size_t i = p; i < taskCount; i += producers) {
+                    group.Run([&sink, &completed, i] {
+                        sink.fetch_add(SmallWork(i), std::memory_order_relaxed);
+                        completed.fetch_add(1, std::memory_order_release);
+                    });
+                }
+            });
+        }
+        group.Wait();
+    });
+    correct &= completed == taskCount;
+
+    completed = 0;
+    const double parallelForMs = MeasureMilliseconds([&] {
+        sample::ThreadPool pool(threadCount);
+        pool.ParallelFor(0, taskCount, [&](size_t i) {
+            sink.fetch_add(SmallWork(i), std::memory_order_relaxed);
+            completed.fetch_add(1, std::memory_order_relaxed);
+        });
+    });
+    correct &= completed == taskCount;
+
+    std::printf("%zu tasks on %zu threads\n", taskCount, threadCount);
+    std::printf("  locked std::function queue     %9.2f ms\n", lockedMs);
+    std::printf("  ThreadPool::Submit             %9.2f ms (%.2fx)\n", submitMs, lockedMs / submitMs);
+    std::printf("  ThreadPool::TaskGroup (nested) %9.2f ms (%.2fx)\n", nestedMs, lockedMs / nestedMs);
+    std::printf("  ThreadPool::ParallelFor        %9.2f ms (%.2fx)\n", parallelForMs, lockedMs / parallelForMs);
+    std::printf("(checksum %llu)\n", static_cast<unsigned long long>(sink.load()));
+    return correct ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <chrono>
+#include <numeric>
+#include <stdexcept>
+#include <ThreadPool.h>
+#include "TestFramework.h"
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+using namespace std::chrono_literals;
+
+namespace {
+    // Blocks the only worker of a pool until released, so that the test controls which thread runs the queued tasks.
+    class BlockedWorker {
+    public:
+        explicit BlockedWorker(sample::ThreadPool& pool) {
+            pool.Submit([this] {
+                m_started = true;
+                while (!m_released) {
+                    std::this_thread::yield();
+                }
+            });
+            while (!m_started) {
+                std::this_thread::yield();
+            }
+        }
+
+        void Release() {
+            m_released = true;
+        }
+
+    private:
+        std::atomic<bool> m_started{false};
+        std::atomic<bool> m_released{false};
+    };
+
+#if defined(__linux__)
+    std::chrono::nanoseconds ThreadCpuTime() {
+        timespec time{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+    }
+#endif
+} // namespace
+
+TEST_CASE(SubmitRunsEveryTask) {
+    std::atomic<int> count{0};
+    {
+        sample::ThreadPool pool(4);
+        for (int i = 0; i < 10000; i++) {
+            CHECK(pool.Submit([&count] { count++; }));
+        }
+        pool.StopAndWait();
+        CHECK(!pool.Submit([] {}));
+    }
+    CHECK(count == 10000);
+}
+
+TEST_CASE(SubmitBatchRunsEveryTask) {
+    std::atomic<int> count{0};
+    sample::ThreadPool pool(3);
+    std::vector<std::function<void()>> tasks(1000, [&count] { count++; });
+    CHECK(pool.SubmitBatch(tasks.begin(), tasks.end()));
+    pool.StopAndWait();
+    CHECK(count == 1000);
+}
+
+TEST_CASE(FutureReturnsValueAndException) {
+    sample::ThreadPool pool(2);
+    auto value = pool.Async([] { return 21; }).Then([](int x) { return x * 2; });
+    CHECK(value.Get() == 42);
+    CHECK(!value.Valid());
+
+    auto failed = pool.Async([]() -> int { throw std::runtime_error("task"); }).Then([](int x) { return x + 1; });
+    CHECK_THROWS(failed.Get());
+}
+
+TEST_CASE(TaskGroupRethrowsFirstException) {
+    sample::ThreadPool pool(4);
+    sample::ThreadPool::TaskGroup group(pool);
+    std::atomic<int> count{0};
+    for (int i = 0; i < 100; i++) {
+        group.Run([&count, i] {
+            count++;
+            if (i == 50) {
+                throw std::runtime_error("group");
+            }
+        });
+    }
+    CHECK_THROWS(group.Wait());
+    CHECK(count == 100);
+    group.Wait(); // The exception is only rethrown once.
+}
+
+TEST_CASE(ParallelForAndReduceCoverTheRange) {
+    sample::ThreadPool pool(4);
+    std::vector<int> values(100000, 0);
+    pool.ParallelFor(0, values.size(), [&](size_t i) { values[i] = static_cast<int>(i % 7); });
+    const int64_t expected = std::accumulate(values.begin(), values.end(), int64_t{0});
+    const int64_t sum = pool.ParallelReduce(
+        0, values.size(), int64_t{0}, [&](size_t i) { return int64_t{values[i]}; }, [](int64_t a, int64_t b) { return a + b; }, 100);
+    CHECK(sum == expected);
+}
+
+// A thread waiting for a group helps by running queued tasks, which may be unrelated tasks given to Submit. Their exceptions
+// must not escape the wait, nor the destructor of the group where they would terminate the process.
+TEST_CASE(SubmittedExceptionDoesNotEscapeHelpingWaiter) {
+    sample::ThreadPool pool(1);
+    BlockedWorker worker(pool);
+
+    CHECK(pool.Submit([] { throw std::runtime_error("submitted"); }));
+    {
+        sample::ThreadPool::TaskGroup group(pool);
+        group.Run([&worker] { worker.Release(); });
+        group.Wait();
+    }
+    std::exception_ptr exception = pool.TakeUnhandledException();
+    CHECK(exception != nullptr);
+    CHECK(pool.TakeUnhandledException() == nullptr);
+
+    BlockedWorker blockedAgain(pool);
+    CHECK(pool.Submit([] { throw std::logic_error("submitted"); }));
+    {
+        sample::ThreadPool::TaskGroup group(pool);
+        group.Run([&blockedAgain] { blockedAgain.Release(); });
+    } // The destructor waits too.
+    CHECK(pool.TakeUnhandledException() != nullptr);
+}
+
+TEST_CASE(WorkerSurvivesThrowingTask) {
+    sample::ThreadPool pool(1);
+    CHECK(pool.Submit([] { throw std::runtime_error("submitted"); }));
+    CHECK(pool.Async([] { return 7; }).Get() == 7);
+    CHECK(pool.TakeUnhandledException() != nullptr);
+}
+
+// An exception nobody took is rethrown once the pool stopped, rather than dropped. Left in the pool, it would terminate the
+// process in the destructor.
+TEST_CASE(StopAndWaitRethrowsUntakenException) {
+    sample::ThreadPool pool(2);
+    CHECK(pool.Submit([] { throw std::runtime_error("submitted"); }));
+    CHECK_THROWS(pool.StopAndWait());
+    CHECK(pool.TakeUnhandledException() == nullptr);
+
+    sample::ThreadPool quiet(1);
+    CHECK(quiet.Submit([] {}));
+    quiet.StopAndWait();
+}
+
+// Many short waits, so that a waiter regularly parks right as the last task of its group completes. A lost wake up hangs here.
+TEST_CASE(WaitersAreWokenWhenTheirWorkCompletes) {
+    sample::ThreadPool pool(2);
+    for (int iteration = 0; iteration < 2000; iteration++) {
+        std::atomic<int> count{0};
+        sample::ThreadPool::TaskGroup group(pool);
+        for (int i = 0; i < 3; i++) {
+            group.Run([&count, iteration] {
+                if (iteration % 100 == 0) {
+                    std::this_thread::sleep_for(1ms);
+                }
+                count++;
+            });
+        }
+        group.Wait();
+        CHECK(count == 3);
+    }
+}
+
+#if defined(__linux__)
+// A thread outside of the pool waiting for a long task parks instead of spinning for the whole wait.
+TEST_CASE(WaiterParksInsteadOfSpinning) {
+    sample::ThreadPool pool(1);
+    auto future = pool.Async([] {
+        std::this_thread::sleep_for(300ms);
+        return 1;
+    });
+
+    const auto cpuBefore = ThreadCpuTime();
+    CHECK(future.Get() == 1);
+    const auto cpuUsed = ThreadCpuTime() - cpuBefore;
+    CHECK(cpuUsed < 100ms);
+}
+#endif
@@ -0,0 +1,94 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+// A minimal test harness for the portable parts of the shared libraries.
+// TEST_CASE registers a function that TestMain.cpp runs. CHECK records a failure and continues, REQUIRE stops the test case.
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+namespace test {
+    struct TestCase {
+        const char* Name;
+        void (*Function)();
+    };
+
+    inline std::vector<TestCase>& Registry() {
+        static std::vector<TestCase> registry;
+        return registry;
+    }
+
+    inline int& FailureCount() {
+        static int failures = 0;
+        return failures;
+    }
+
+    struct Registrar {
+        Registrar(const char* name, void (*function)()) {
+            Registry().push_back({name, function});
+        }
+    };
+
+    // Thrown by REQUIRE to abandon the current test case.
+    struct RequireFailed {};
+
+    inline void ReportFailure(const char* file, int line, const char* expression) {
+        std::fprintf(stderr, "%s(%d): check failed: %s\n", file, line, expression);
+        FailureCount()++;
+    }
+
+    inline bool Near(double a, double b, double tolerance) {
+        return std::fabs(a - b) <= tolerance;
+    }
+} // namespace test
+
+#define TEST_CASE(name)                                        \
+    static void name();                                        \
+    static const test::Registrar name##Registrar(#name, name); \
+    static void name()
+
+#define CHECK(expression)                                         \
+    do {                                                          \
+        if (!(expression)) {                                      \
+            test::ReportFailure(__FILE__, __LINE__, #expression); \
+        }                                                         \
+    } while (false)
+
+#define REQUIRE(expression)                                       \
+    do {                                                          \
+        if (!(expression)) {                                      \
+            test::ReportFailure(__FILE__, __LINE__, #expression); \
+            throw test::RequireFailed{};                          \
+        }                                                         \
+    } while (false)
+
+#define CHECK_NEAR(a, b, tolerance) CHECK(test::Near((a), (b), (tolerance)))
+
+#define CHECK_THROWS(expression)                                            \
+    do {                                                                    \
+        bool threw = false;                                                 \
+        try {                                                               \
+            (void)(expression);                                             \
+        } catch (...) {                                                     \
+            threw = true;                                                   \
+        }                                                                   \
+        if (!threw) {                                                       \
+            test::ReportFailure(__FILE__, __LINE__, #expression " throws"); \
+        }                                                                   \
+    } while (false)
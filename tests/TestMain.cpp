@@ -0,0 +1,45 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include "TestFramework.h"
+
+// Runs the registered test cases, or only those whose name contains the first argument.
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    for (const test::TestCase& testCase : test::Registry()) {
+        if (filter != nullptr && std::strstr(testCase.Name, filter) == nullptr) {
+            continue;
+        }
+        const int failuresBefore = test::FailureCount();
+        try {
+            testCase.Function();
+        } catch (const test::RequireFailed&) {
+        } catch (const std::exception& ex) {
+            std::fprintf(stderr, "%s: unexpected exception: %s\n", testCase.Name, ex.what());
+            test::FailureCount()++;
+        } catch (...) {
+            std::fprintf(stderr, "%s: unexpected exception\n", testCase.Name);
+            test::FailureCount()++;
+        }
+        std::printf("%s %s\n", test::FailureCount() == failuresBefore ? "[ PASS ]" : "[ FAIL ]", testCase.Name);
+        run++;
+    }
+    std::printf("%d test cases, %d failures\n", run, test::FailureCount());
+    return test::FailureCount() == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <cstdint>
+#include <random>
+#include <XrSceneLib/ResolutionController.h>
+#include "TestFramework.h"
+
+namespace {
+    constexpr XrDuration DisplayPeriod = 11'111'111; // 90 Hz
+
+    // A synthetic GPU whose frame cost follows the pixel count, which grows with the square of the scale.
+    struct SyntheticGpu {
+        float FullResolutionUtilization; // The utilization of a frame rendered at scale 1.
+        float Noise{0};                  // Relative amplitude of the frame to frame variation.
+        std::mt19937 Random{1234};
+
+        XrDuration FrameDuration(float scale) {
+            std::uniform_real_distribution<float> noise(-Noise, Noise);
+            const float utilization = FullResolutionUtilization * scale * scale * (1 + noise(Random));
+            return static_cast<XrDuration>(utilization * DisplayPeriod);
+        }
+    };
+
+    // Runs the controller in a closed loop against the synthetic GPU, and returns the number of scale changes.
+    uint32_t RunTrace(engine::ResolutionController& controller, SyntheticGpu& gpu, uint32_t frameCount) {
+        uint32_t changes = 0;
+        for (uint32_t frame = 0; frame < frameCount; frame++) {
+            const float previousScale = controller.Scale();
+            if (controller.Update(gpu.FrameDuration(previousScale), DisplayPeriod) != previousScale) {
+                changes++;
+            }
+        }
+        return changes;
+    }
+} // namespace
+
+TEST_CASE(ResolutionController_KeepsFullResolutionWithinBudget) {
+    engine::ResolutionController controller;
+    SyntheticGpu gpu{0.5f};
+    CHECK(RunTrace(controller, gpu, 600) == 0);
+    CHECK(controller.Scale() == 1.0f);
+    CHECK_NEAR(controller.LastReport().Utilization, 0.5f, 0.01f);
+}
+
+TEST_CASE(ResolutionController_LowersScaleUnderLoadAndSettles) {
+    const engine::ResolutionControllerSettings settings;
+    engine::ResolutionController controller(settings);
+    SyntheticGpu gpu{1.5f, 0.05f};
+
+    // The first overloaded frame already lowers the scale, rather than waiting for the smoothing to catch up.
+    controller.Update(static_cast<XrDuration>(1.5f * DisplayPeriod), DisplayPeriod);
+    CHECK(controller.Scale() < 1.0f);
+
+    RunTrace(controller, gpu, 300);
+    const float settledScale = controller.Scale();
+    CHECK(settledScale >= settings.MinScale);
+    CHECK(settledScale < 0.8f);
+
+    // Once settled, the noisy trace stays between the thresholds and the scale no longer oscillates.
+    CHECK(RunTrace(controller, gpu, 900) == 0);
+    CHECK(controller.Scale() == settledScale);
+    CHECK(controller.LastReport().Utilization < settings.DecreaseThreshold);
+    CHECK(controller.LastReport().Utilization > settings.IncreaseThreshold);
+}
+
+TEST_CASE(ResolutionController_RecoversGraduallyAfterTheLoadDrops) {
+    const engine::ResolutionControllerSettings settings;
+    engine::ResolutionController controller(settings);
+    SyntheticGpu gpu{1.6f};
+    RunTrace(controller, gpu, 300);
+    const float loadedScale = controller.Scale();
+    REQUIRE(loadedScale < 0.8f);
+
+    // The scene gets cheaper: no increase before IncreaseDelayFrames, then steps of at most MaxIncreaseStep.
+    gpu.FullResolutionUtilization = 0.4f;
+    float previousScale = loadedScale;
+    uint32_t framesSinceChange = 0;
+    uint32_t increases = 0;
+    for (uint32_t frame = 0; frame < 900; frame++) {
+        const float scale = controller.Update(gpu.FrameDuration(previousScale), DisplayPeriod);
+        framesSinceChange++;
+        if (scale != previousScale) {
+            CHECK(scale > previousScale);
+            CHECK(scale - previousScale <= settings.MaxIncreaseStep + 1e-6f);
+            CHECK(framesSinceChange >= settings.IncreaseDelayFrames);
+            framesSinceChange = 0;
+            increases++;
+        }
+        previousScale = scale;
+    }
+    CHECK(increases >= 2);
+    CHECK(controller.Scale() == settings.MaxScale);
+}
+
+TEST_CASE(ResolutionController_ClampsToMinScale) {
+    engine::ResolutionControllerSettings settings;
+    settings.MinScale = 0.6f;
+    engine::ResolutionController controller(settings);
+    SyntheticGpu gpu{4.0f};
+    RunTrace(controller, gpu, 300);
+    CHECK(controller.Scale() == 0.6f);
+}
+
+TEST_CASE(ResolutionController_IgnoresFramesWithoutTiming) {
+    engine::ResolutionController controller;
+    SyntheticGpu gpu{1.5f};
+    RunTrace(controller, gpu, 60);
+    const float scale = controller.Scale();
+    REQUIRE(scale < 1.0f);
+
+    // Frames of an unfocused session have no display period, and the GPU timer may not have a result yet.
+    CHECK(controller.Update(DisplayPeriod, 0) == scale);
+    CHECK(controller.Update(0, DisplayPeriod) == scale);
+    CHECK(controller.LastReport().FrameIndex == 62);
+
+    controller.Reset();
+    CHECK(controller.Scale() == 1.0f);
+    CHECK(controller.LastReport().FrameIndex == 0);
+}
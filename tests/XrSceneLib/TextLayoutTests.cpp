@@ -0,0 +1,204 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <memory>
+#include <vector>
+#include <XrSceneLib/TextLayout.h>
+#include "TestFramework.h"
+
+namespace {
+    constexpr uint32_t GlyphWidth = 6;
+    constexpr uint32_t GlyphHeight = 8;
+    constexpr float Advance = 8;
+    constexpr float SpaceAdvance = 4;
+    constexpr float LineHeight = 12;
+
+    // A monospaced font whose glyphs are boxes filled with the low byte of their code point, except for spaces, which
+    // have no pixels, and '?', which the font has no glyph for.
+    struct SyntheticRasterizer : engine::GlyphRasterizer {
+        uint32_t RasterizeCount{0};
+
+        engine::FontMetrics Metrics() const override {
+            return {8, 2, 2};
+        }
+
+        bool Rasterize(char32_t codePoint, engine::GlyphMetrics& metrics, std::vector<uint8_t>& coverage) override {
+            RasterizeCount++;
+            if (codePoint == U'?') {
+                return false;
+            }
+            if (codePoint == U' ' || codePoint == U'\t') {
+                metrics = {SpaceAdvance, 0, 0, 0, 0};
+                return true;
+            }
+
+            metrics = {Advance, 1, -static_cast<int32_t>(GlyphHeight), GlyphWidth, GlyphHeight};
+            coverage.assign(GlyphWidth * GlyphHeight, static_cast<uint8_t>(codePoint & 0xFF));
+            return true;
+        }
+    };
+
+    struct Fixture {
+        std::shared_ptr<SyntheticRasterizer> Rasterizer = std::make_shared<SyntheticRasterizer>();
+        engine::GlyphAtlas Atlas;
+        engine::FontId Font;
+        std::vector<engine::GlyphQuad> Quads;
+
+        explicit Fixture(uint32_t atlasSize = 256)
+            : Atlas(atlasSize, atlasSize)
+            , Font(Atlas.AddFont(Rasterizer)) {
+        }
+
+        bool Layout(std::wstring_view text, const engine::TextLayoutOptions& options = {}) {
+            return engine::LayoutText(text, Font, options, Atlas, Quads);
+        }
+    };
+
+    bool Overlap(const engine::AtlasRect& a, const engine::AtlasRect& b) {
+        return a.Left < b.Right && b.Left < a.Right && a.Top < b.Bottom && b.Top < a.Bottom;
+    }
+} // namespace
+
+TEST_CASE(GlyphsAreRasterizedOnceAndCopiedIntoTheAtlas) {
+    Fixture fixture;
+    const engine::AtlasGlyph* a = fixture.Atlas.FindOrAddGlyph(fixture.Font, U'A');
+    REQUIRE(a != nullptr);
+    CHECK(fixture.Atlas.FindOrAddGlyph(fixture.Font, U'A') == a);
+    CHECK(fixture.Rasterizer->RasterizeCount == 1);
+
+    CHECK(a->Rect.Right - a->Rect.Left == GlyphWidth);
+    CHECK(a->Rect.Bottom - a->Rect.Top == GlyphHeight);
+    const std::vector<uint8_t>& pixels = fixture.Atlas.Pixels();
+    for (uint32_t y = a->Rect.Top; y < a->Rect.Bottom; y++) {
+        for (uint32_t x = a->Rect.Left; x < a->Rect.Right; x++) {
+            CHECK(pixels[static_cast<size_t>(y) * fixture.Atlas.Width() + x] == 'A');
+        }
+    }
+
+    // The padding around the glyph stays empty.
+    CHECK(pixels[static_cast<size_t>(a->Rect.Top) * fixture.Atlas.Width() + a->Rect.Left - 1] == 0);
+    CHECK(pixels[static_cast<size_t>(a->Rect.Bottom) * fixture.Atlas.Width() + a->Rect.Left] == 0);
+}
+
+TEST_CASE(GlyphsAndTheSolidBlockDoNotOverlap) {
+    Fixture fixture;
+    std::vector<engine::AtlasRect> rects{fixture.Atlas.SolidRect()};
+    for (char32_t codePoint = U'A'; codePoint <= U'Z'; codePoint++) {
+        const engine::AtlasGlyph* glyph = fixture.Atlas.FindOrAddGlyph(fixture.Font, codePoint);
+        REQUIRE(glyph != nullptr);
+        for (const engine::AtlasRect& rect : rects) {
+            CHECK(!Overlap(glyph->Rect, rect));
+        }
+        rects.push_back(glyph->Rect);
+    }
+
+    const engine::AtlasRect& solid = fixture.Atlas.SolidRect();
+    CHECK(!solid.IsEmpty());
+    CHECK(fixture.Atlas.Pixels()[static_cast<size_t>(solid.Top) * fixture.Atlas.Width() + solid.Left] == 255);
+}
+
+TEST_CASE(OnlyTheChangedRegionIsDirty) {
+    Fixture fixture;
+    CHECK(fixture.Atlas.TakeDirtyRect().has_value());
+    CHECK(!fixture.Atlas.TakeDirtyRect().has_value());
+
+    const engine::AtlasGlyph* glyph = fixture.Atlas.FindOrAddGlyph(fixture.Font, U'A');
+    const std::optional<engine::AtlasRect> dirty = fixture.Atlas.TakeDirtyRect();
+    REQUIRE(dirty.has_value());
+    CHECK(dirty->Left == glyph->Rect.Left && dirty->Top == glyph->Rect.Top);
+    CHECK(dirty->Right == glyph->Rect.Right && dirty->Bottom == glyph->Rect.Bottom);
+
+    // Glyphs already in the atlas and glyphs without pixels change nothing.
+    fixture.Atlas.FindOrAddGlyph(fixture.Font, U'A');
+    fixture.Atlas.FindOrAddGlyph(fixture.Font, U' ');
+    CHECK(!fixture.Atlas.TakeDirtyRect().has_value());
+}
+
+TEST_CASE(AFullAtlasFailsUntilItIsCleared) {
+    // Room for the row of the solid block and two rows of four padded glyphs.
+    Fixture fixture(32);
+    const uint32_t generation = fixture.Atlas.Generation();
+    CHECK(!fixture.Layout(L"ABCDEFGHIJ"));
+    CHECK(fixture.Quads.size() == 8);
+
+    fixture.Atlas.Clear();
+    CHECK(fixture.Atlas.Generation() == generation + 1);
+    CHECK(fixture.Layout(L"IJ"));
+    CHECK(fixture.Quads.size() == 2);
+}
+
+TEST_CASE(GlyphsArePlacedOnTheBaselineOfEachLine) {
+    Fixture fixture;
+    CHECK(fixture.Layout(L"AB\r\nC"));
+    REQUIRE(fixture.Quads.size() == 3);
+
+    // The first baseline is one ascent below the top, and the pen moves by the advance.
+    CHECK(fixture.Quads[0].Left == 1 && fixture.Quads[0].Top == 0);
+    CHECK(fixture.Quads[1].Left == 1 + Advance && fixture.Quads[1].Top == 0);
+    CHECK(fixture.Quads[2].Left == 1 && fixture.Quads[2].Top == LineHeight);
+    CHECK(fixture.Quads[2].Bottom - fixture.Quads[2].Top == GlyphHeight);
+}
+
+TEST_CASE(MissingGlyphsAndSpacesGetNoQuads) {
+    Fixture fixture;
+    CHECK(fixture.Layout(L"A ?B"));
+    REQUIRE(fixture.Quads.size() == 2);
+    CHECK(fixture.Quads[1].Left == 1 + Advance + SpaceAdvance);
+}
+
+TEST_CASE(SurrogatePairsAreOneGlyph) {
+    Fixture fixture;
+    CHECK(fixture.Layout(std::wstring_view(L"\xD83D\xDE00", 2)));
+    if constexpr (sizeof(wchar_t) == 2) {
+        CHECK(fixture.Quads.size() == 1);
+        CHECK(fixture.Rasterizer->RasterizeCount == 1);
+    }
+    CHECK(fixture.Atlas.FindOrAddGlyph(fixture.Font, U'\U0001F600') != nullptr);
+}
+
+TEST_CASE(LinesWrapAtSpaces) {
+    Fixture fixture;
+    engine::TextLayoutOptions options;
+    options.Width = 4 * Advance;
+    CHECK(fixture.Layout(L"AB CD EFGHIJ", options));
+    REQUIRE(fixture.Quads.size() == 10);
+
+    // "AB CD" doesn't fit, so CD starts the second line, and the word longer than the box gets a line of its own.
+    CHECK(fixture.Quads[1].Top == 0);
+    CHECK(fixture.Quads[2].Left == 1 && fixture.Quads[2].Top == LineHeight);
+    CHECK(fixture.Quads[4].Left == 1 && fixture.Quads[4].Top == 2 * LineHeight);
+    CHECK(fixture.Quads[9].Top == 2 * LineHeight);
+}
+
+TEST_CASE(LinesAreAlignedInTheBox) {
+    Fixture fixture;
+    engine::TextLayoutOptions options;
+    options.Width = 100;
+    options.Height = 100;
+
+    options.HorizontalAlignment = engine::TextAlignment::Trailing;
+    options.VerticalAlignment = engine::ParagraphAlignment::Far;
+    CHECK(fixture.Layout(L"AB", options));
+    CHECK(fixture.Quads[1].Left == 100 - 2 * Advance + Advance + 1);
+    CHECK(fixture.Quads[0].Top == 100 - LineHeight);
+
+    // Trailing spaces don't count towards the width of a line.
+    options.HorizontalAlignment = engine::TextAlignment::Center;
+    options.VerticalAlignment = engine::ParagraphAlignment::Center;
+    CHECK(fixture.Layout(L"AB  \nA", options));
+    CHECK(fixture.Quads[0].Left == (100 - 2 * Advance) / 2 + 1);
+    CHECK(fixture.Quads[2].Left == (100 - Advance) / 2 + 1);
+    CHECK(fixture.Quads[0].Top == (100 - 2 * LineHeight) / 2);
+}
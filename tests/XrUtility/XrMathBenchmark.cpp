@@ -0,0 +1,116 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <XrMath.h>
+
+// Compares the array versions of the pose functions with a loop over the scalar ones, per pose, for the number of hand joints
+// of both hands and for larger batches.
+// Usage: XrMathBenchmark [--quick]
+
+namespace {
+    std::vector<XrPosef> MakePoses(size_t count) {
+        std::vector<XrPosef> poses(count);
+        for (size_t i = 0; i < count; i++) {
+            const float angle = 0.01f * static_cast<float>(i);
+            poses[i].orientation = xr::math::Quaternion::RotationAxisAngle({0.6f, 0.0f, 0.8f}, angle);
+            poses[i].position = {angle, -angle, 1.0f};
+        }
+        return poses;
+    }
+
+    // Returns the nanoseconds per pose of running f over count poses, repeated to roughly the same total work for each count.
+    template <typename F>
+    double NanosecondsPerPose(size_t count, size_t totalPoses, F&& f) {
+        const size_t repeats = std::max<size_t>(1, totalPoses / count);
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < repeats; r++) {
+            f();
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(repeats * count);
+    }
+
+    float g_checksum = 0;
+    void Consume(const XrPosef* poses, size_t count) {
+        for (size_t i = 0; i < count; i += 7) {
+            g_checksum += poses[i].position.x + poses[i].orientation.w;
+        }
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    const bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    const size_t totalPoses = quick ? 100000 : 20000000;
+
+    std::printf("%-10s %6s %12s %12s %8s\n", "function", "poses", "scalar ns", "batched ns", "speedup");
+    for (size_t count : {size_t{52}, size_t{256}, size_t{4096}}) {
+        const std::vector<XrPosef> a = MakePoses(count);
+        const std::vector<XrPosef> b = MakePoses(count + 3);
+        std::vector<XrPosef> result(count);
+
+        const auto report = [&](const char* name, double scalar, double batched) {
+            Consume(result.data(), count);
+            std::printf("%-10s %6zu %12.2f %12.2f %7.2fx\n", name, count, scalar, batched, scalar / batched);
+        };
+
+        report("Multiply",
+               NanosecondsPerPose(count,
+                                  totalPoses,
+                                  [&] {
+                                      for (size_t i = 0; i < count; i++) {
+                                          result[i] = xr::math::Pose::Multiply(a[i], b[i]);
+                                      }
+                                  }),
+               NanosecondsPerPose(count, totalPoses, [&] { xr::math::Pose::Multiply(a.data(), b.data(), result.data(), count); }));
+
+        report("Invert",
+               NanosecondsPerPose(count,
+                                  totalPoses,
+                                  [&] {
+                                      for (size_t i = 0; i < count; i++) {
+                                          result[i] = xr::math::Pose::Invert(a[i]);
+                                      }
+                                  }),
+               NanosecondsPerPose(count, totalPoses, [&] { xr::math::Pose::Invert(a.data(), result.data(), count); }));
+
+        report("Slerp",
+               NanosecondsPerPose(count,
+                                  totalPoses,
+                                  [&] {
+                                      for (size_t i = 0; i < count; i++) {
+                                          result[i] = xr::math::Pose::Slerp(a[i], b[i], 0.3f);
+                                      }
+                                  }),
+               NanosecondsPerPose(count, totalPoses, [&] { xr::math::Pose::Slerp(a.data(), b.data(), 0.3f, result.data(), count); }));
+
+        std::vector<DirectX::XMFLOAT4X4> matrices(count);
+        report("ToMatrices",
+               NanosecondsPerPose(count,
+                                  totalPoses,
+                                  [&] {
+                                      for (size_t i = 0; i < count; i++) {
+                                          DirectX::XMStoreFloat4x4(&matrices[i], xr::math::LoadXrPose(a[i]));
+                                      }
+                                  }),
+               NanosecondsPerPose(count, totalPoses, [&] { xr::math::Pose::ToMatrices(a.data(), matrices.data(), count); }));
+        g_checksum += matrices[count / 2].m[3][0];
+    }
+    std::printf("(checksum %f)\n", g_checksum);
+    return 0;
+}
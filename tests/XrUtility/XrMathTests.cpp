@@ -0,0 +1,161 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <cstring>
+#include <random>
+#include <vector>
+#include <XrMath.h>
+#include "TestFramework.h"
+
+// Checks the array versions of the pose functions against the scalar ones, for counts that exercise both the four-wide SIMD
+// path and the scalar remainder.
+
+namespace {
+    constexpr float Tolerance = 1e-5f;
+
+    std::vector<XrPosef> RandomPoses(size_t count, uint32_t seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::vector<XrPosef> poses(count);
+        for (XrPosef& pose : poses) {
+            const XrVector3f axis{unit(random), unit(random), unit(random) + 1.5f};
+            pose.orientation = xr::math::Quaternion::RotationAxisAngle(xr::math::Normalize(axis), unit(random) * 3.1f);
+            pose.position = {unit(random) * 5, unit(random) * 5, unit(random) * 5};
+        }
+        return poses;
+    }
+
+    bool Near(const XrPosef& a, const XrPosef& b) {
+        // q and -q are the same rotation.
+        const float dot = a.orientation.x * b.orientation.x + a.orientation.y * b.orientation.y + a.orientation.z * b.orientation.z +
+                          a.orientation.w * b.orientation.w;
+        return std::fabs(std::fabs(dot) - 1.0f) <= Tolerance && test::Near(a.position.x, b.position.x, Tolerance * 10) &&
+               test::Near(a.position.y, b.position.y, Tolerance * 10) && test::Near(a.position.z, b.position.z, Tolerance * 10);
+    }
+
+    bool Near(const XrVector3f& a, const XrVector3f& b) {
+        return test::Near(a.x, b.x, Tolerance * 10) && test::Near(a.y, b.y, Tolerance * 10) && test::Near(a.z, b.z, Tolerance * 10);
+    }
+
+    template <typename Batched, typename Scalar>
+    void CheckAgainstScalar(Batched&& batched, Scalar&& scalar) {
+        for (size_t count = 0; count < 70; count++) {
+            const std::vector<XrPosef> a = RandomPoses(count, static_cast<uint32_t>(count));
+            const std::vector<XrPosef> b = RandomPoses(count, static_cast<uint32_t>(count + 1000));
+            std::vector<XrPosef> result(count);
+            batched(a.data(), b.data(), result.data(), count);
+            for (size_t i = 0; i < count; i++) {
+                CHECK(Near(result[i], scalar(a[i], b[i])));
+            }
+
+            // In place, into the first input.
+            std::vector<XrPosef> inPlace = a;
+            batched(inPlace.data(), b.data(), inPlace.data(), count);
+            for (size_t i = 0; i < count; i++) {
+                CHECK(Near(inPlace[i], result[i]));
+            }
+        }
+    }
+} // namespace
+
+TEST_CASE(MultiplyMatchesScalar) {
+    CheckAgainstScalar([](const XrPosef* a, const XrPosef* b, XrPosef* r, size_t n) { xr::math::Pose::Multiply(a, b, r, n); },
+                       [](const XrPosef& a, const XrPosef& b) { return xr::math::Pose::Multiply(a, b); });
+}
+
+TEST_CASE(MultiplyBySharedPoseMatchesScalar) {
+    const XrPosef shared = RandomPoses(1, 77)[0];
+    CheckAgainstScalar([&](const XrPosef* a, const XrPosef*, XrPosef* r, size_t n) { xr::math::Pose::Multiply(a, shared, r, n); },
+                       [&](const XrPosef& a, const XrPosef&) { return xr::math::Pose::Multiply(a, shared); });
+
+    // The shared pose may be an element of the result.
+    std::vector<XrPosef> poses = RandomPoses(9, 5);
+    const std::vector<XrPosef> original = poses;
+    xr::math::Pose::Multiply(poses.data(), poses[8], poses.data(), poses.size());
+    for (size_t i = 0; i < poses.size(); i++) {
+        CHECK(Near(poses[i], xr::math::Pose::Multiply(original[i], original[8])));
+    }
+}
+
+TEST_CASE(InvertMatchesScalar) {
+    CheckAgainstScalar([](const XrPosef* a, const XrPosef*, XrPosef* r, size_t n) { xr::math::Pose::Invert(a, r, n); },
+                       [](const XrPosef& a, const XrPosef&) { return xr::math::Pose::Invert(a); });
+}
+
+TEST_CASE(SlerpMatchesScalar) {
+    for (float alpha : {0.0f, 0.25f, 0.5f, 1.0f}) {
+        CheckAgainstScalar([=](const XrPosef* a, const XrPosef* b, XrPosef* r, size_t n) { xr::math::Pose::Slerp(a, b, alpha, r, n); },
+                           [=](const XrPosef& a, const XrPosef& b) { return xr::math::Pose::Slerp(a, b, alpha); });
+    }
+}
+
+// Slerp must take the short way around when the quaternions of a pair are in opposite hemispheres.
+TEST_CASE(SlerpHandlesSignFlippedQuaternions) {
+    std::vector<XrPosef> a = RandomPoses(8, 11);
+    std::vector<XrPosef> b = RandomPoses(8, 12);
+    for (size_t i = 0; i < b.size(); i += 2) {
+        XrQuaternionf& q = b[i].orientation;
+        q = {-q.x, -q.y, -q.z, -q.w};
+    }
+    std::vector<XrPosef> result(a.size());
+    xr::math::Pose::Slerp(a.data(), b.data(), 0.3f, result.data(), a.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        CHECK(Near(result[i], xr::math::Pose::Slerp(a[i], b[i], 0.3f)));
+    }
+}
+
+TEST_CASE(TransformPointsMatchesScalar) {
+    const XrPosef pose = RandomPoses(1, 3)[0];
+    const DirectX::XMMATRIX matrix = xr::math::LoadXrPose(pose);
+    for (size_t count = 0; count < 23; count++) {
+        std::vector<XrVector3f> points(count);
+        for (size_t i = 0; i < count; i++) {
+            points[i] = {float(i), float(i) * -0.5f, 2.0f - float(i)};
+        }
+        std::vector<XrVector3f> result(count);
+        xr::math::Pose::TransformPoints(pose, points.data(), result.data(), count);
+        for (size_t i = 0; i < count; i++) {
+            XrVector3f expected;
+            xr::math::StoreXrVector3(&expected, DirectX::XMVector3Transform(xr::math::LoadXrVector3(points[i]), matrix));
+            CHECK(Near(result[i], expected));
+        }
+    }
+}
+
+TEST_CASE(ToMatricesMatchesLoadXrPose) {
+    for (size_t count = 0; count < 23; count++) {
+        const std::vector<XrPosef> poses = RandomPoses(count, 40 + static_cast<uint32_t>(count));
+        std::vector<DirectX::XMFLOAT4X4> matrices(count);
+        xr::math::Pose::ToMatrices(poses.data(), matrices.data(), count);
+        for (size_t i = 0; i < count; i++) {
+            DirectX::XMFLOAT4X4 expected;
+            DirectX::XMStoreFloat4x4(&expected, xr::math::LoadXrPose(poses[i]));
+            for (int row = 0; row < 4; row++) {
+                for (int column = 0; column < 4; column++) {
+                    CHECK_NEAR(matrices[i].m[row][column], expected.m[row][column], Tolerance);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(LoadAndStoreRoundTrip) {
+    const std::vector<XrPosef> poses = RandomPoses(4, 9);
+    std::vector<XrPosef> stored(4);
+    xr::math::StoreXrPoses(stored.data(), xr::math::LoadXrPoses(poses.data()));
+    for (size_t i = 0; i < 4; i++) {
+        CHECK(std::memcmp(&stored[i], &poses[i], sizeof(XrPosef)) == 0);
+    }
+}
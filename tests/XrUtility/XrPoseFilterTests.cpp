@@ -0,0 +1,310 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <XrPoseFilter.h>
+#include "TestFramework.h"
+
+// Checks the predictors and filters of tracked poses against closed-form results, and the SIMD joint filter against the
+// scalar One-Euro filter it approximates.
+
+using namespace DirectX;
+
+namespace {
+    constexpr XrDuration FrameDuration = 11'111'111; // 90 Hz
+    constexpr XrTime StartTime = 1'000'000'000;
+    constexpr float Tolerance = 1e-5f;
+
+    XrPosef MakePose(const XrVector3f& position, const XrQuaternionf& orientation = {0, 0, 0, 1}) {
+        XrPosef pose;
+        pose.position = position;
+        pose.orientation = orientation;
+        return pose;
+    }
+
+    XrQuaternionf AboutZ(float angle) {
+        return xr::math::Quaternion::RotationAxisAngle({0, 0, 1}, angle);
+    }
+
+    bool Near(const XrVector3f& a, const XrVector3f& b, float tolerance = Tolerance) {
+        return test::Near(a.x, b.x, tolerance) && test::Near(a.y, b.y, tolerance) && test::Near(a.z, b.z, tolerance);
+    }
+
+    // The angle of the rotation between two orientations, where q and -q are the same rotation.
+    float AngleBetween(const XrQuaternionf& a, const XrQuaternionf& b) {
+        const float dot = std::abs(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w);
+        return 2 * std::acos(std::min(1.0f, dot));
+    }
+
+    XrVector3f Rotate(const XrQuaternionf& orientation, const XrVector3f& vector) {
+        XrVector3f result;
+        xr::math::StoreXrVector3(&result, XMVector3Rotate(xr::math::LoadXrVector3(vector), xr::math::LoadXrQuaternion(orientation)));
+        return result;
+    }
+
+    // The smoothing factor of an exponential filter, written as in the One-Euro paper.
+    float Alpha(float cutoff, float seconds) {
+        const float tau = 1 / (2 * XM_PI * cutoff);
+        return 1 / (1 + tau / seconds);
+    }
+} // namespace
+
+TEST_CASE(ExtrapolateMatchesConstantVelocity) {
+    // Rotated 0.3 rad about x, then turning about the z axis of the base space at pi rad/s for a quarter second.
+    const XrPosef pose = MakePose({1, 2, 3}, xr::math::Quaternion::RotationAxisAngle({1, 0, 0}, 0.3f));
+    const XrPosef moved = xr::math::Pose::Extrapolate(pose, {1, -2, 0.5f}, {0, 0, XM_PI}, 0.25f);
+    CHECK(Near(moved.position, {1.25f, 1.5f, 3.125f}));
+
+    // The local y axis is turned by 0.3 rad about x, then by pi / 4 about the z axis of the base space.
+    const float c = std::cos(0.3f);
+    const float s = std::sin(0.3f);
+    const float h = std::sqrt(0.5f);
+    CHECK(Near(Rotate(moved.orientation, {0, 1, 0}), {-h * c, h * c, s}));
+
+    // Negative times extrapolate backwards.
+    const XrPosef back = xr::math::Pose::Extrapolate(moved, {1, -2, 0.5f}, {0, 0, XM_PI}, -0.25f);
+    CHECK(Near(back.position, pose.position));
+    CHECK(AngleBetween(back.orientation, pose.orientation) < 1e-3f);
+}
+
+TEST_CASE(ExtrapolateMatchesConstantAcceleration) {
+    // From rest: p = a t^2 / 2 and angle = alpha t^2 / 2.
+    const XrPosef pose = MakePose({0, 1, 0});
+    const XrPosef moved = xr::math::Pose::Extrapolate(pose, {0, 0, 0}, {0, 0, 0}, {2, 0, -4}, {0, 0, 2}, 0.5f);
+    CHECK(Near(moved.position, {0.25f, 1, -0.5f}));
+    CHECK(test::Near(AngleBetween(moved.orientation, pose.orientation), 0.25f, Tolerance));
+    CHECK(Near(Rotate(moved.orientation, {1, 0, 0}), {std::cos(0.25f), std::sin(0.25f), 0}));
+
+    // With a velocity too: p = v t + a t^2 / 2.
+    const XrPosef both = xr::math::Pose::Extrapolate(pose, {1, 0, 0}, {0, 0, 0}, {2, 0, 0}, {0, 0, 0}, 2);
+    CHECK(Near(both.position, {6, 1, 0}));
+}
+
+TEST_CASE(ExtrapolateIgnoresInvalidVelocities) {
+    const XrPosef pose = MakePose({0, 0, 0}, AboutZ(0.5f));
+    XrSpaceVelocity velocity{XR_TYPE_SPACE_VELOCITY};
+    velocity.linearVelocity = {2, 0, 0};
+    velocity.angularVelocity = {0, 0, 1};
+
+    velocity.velocityFlags = XR_SPACE_VELOCITY_LINEAR_VALID_BIT;
+    XrPosef moved = xr::math::Pose::Extrapolate(pose, velocity, 500'000'000);
+    CHECK(Near(moved.position, {1, 0, 0}));
+    CHECK(AngleBetween(moved.orientation, pose.orientation) < 1e-3f);
+
+    velocity.velocityFlags = XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
+    moved = xr::math::Pose::Extrapolate(pose, velocity, 500'000'000);
+    CHECK(Near(moved.position, {0, 0, 0}));
+    CHECK(AngleBetween(moved.orientation, AboutZ(1.0f)) < 1e-3f);
+}
+
+TEST_CASE(PosePredictorFollowsConstantVelocity) {
+    xr::math::PosePredictor predictor;
+    CHECK(!predictor.Predict(StartTime).has_value());
+
+    // Moving at 0.5 m/s along x and turning at 1 rad/s about z, without velocities from the runtime.
+    for (int frame = 0; frame < 4; frame++) {
+        const float seconds = frame * xr::math::ToSeconds(FrameDuration);
+        predictor.AddSample(StartTime + frame * FrameDuration, MakePose({0.5f * seconds, 0, 0}, AboutZ(seconds)));
+    }
+
+    const float lastSeconds = 3 * xr::math::ToSeconds(FrameDuration);
+    const XrPosef predicted = predictor.Predict(StartTime + 3 * FrameDuration + 50'000'000).value();
+    CHECK(Near(predicted.position, {0.5f * (lastSeconds + 0.05f), 0, 0}));
+    CHECK(AngleBetween(predicted.orientation, AboutZ(lastSeconds + 0.05f)) < 1e-3f);
+
+    predictor.Reset();
+    CHECK(!predictor.Predict(StartTime).has_value());
+}
+
+// Velocities are backward differences, so they lag the true velocity of an accelerating pose by half a frame, and the
+// acceleration estimated from two of them is exact.
+TEST_CASE(PosePredictorUsesFiniteDifferences) {
+    constexpr float Acceleration = 4;
+    const float dt = xr::math::ToSeconds(FrameDuration);
+    xr::math::PosePredictor predictor;
+    for (int frame = 0; frame < 5; frame++) {
+        const float t = frame * dt;
+        predictor.AddSample(StartTime + frame * FrameDuration, MakePose({0, 0.5f * Acceleration * t * t, 0}));
+    }
+
+    const float t = 4 * dt;
+    const float ahead = 0.04f;
+    const XrTime predictionTime = StartTime + 4 * FrameDuration + 40'000'000;
+    const float lastPosition = 0.5f * Acceleration * t * t;
+    const float velocity = Acceleration * (t - dt / 2);
+
+    const XrPosef constantVelocity = predictor.Predict(predictionTime).value();
+    CHECK(test::Near(constantVelocity.position.y, lastPosition + velocity * ahead, Tolerance));
+
+    const XrPosef constantAcceleration = predictor.Predict(predictionTime, xr::math::ExtrapolationModel::ConstantAcceleration).value();
+    CHECK(test::Near(constantAcceleration.position.y, lastPosition + velocity * ahead + 0.5f * Acceleration * ahead * ahead, Tolerance));
+    const float truth = 0.5f * Acceleration * (t + ahead) * (t + ahead);
+    CHECK(std::abs(constantAcceleration.position.y - truth) < std::abs(constantVelocity.position.y - truth));
+
+    // A velocity reported by the runtime replaces the estimate.
+    XrSpaceVelocity reported{XR_TYPE_SPACE_VELOCITY};
+    reported.velocityFlags = XR_SPACE_VELOCITY_LINEAR_VALID_BIT;
+    reported.linearVelocity = {1, 0, 0};
+    predictor.AddSample(StartTime + 5 * FrameDuration, MakePose({0, 0, 0}), &reported);
+    CHECK(Near(predictor.Predict(StartTime + 5 * FrameDuration + 100'000'000).value().position, {0.1f, 0, 0}));
+}
+
+TEST_CASE(OneEuroFilterStepResponse) {
+    const xr::math::OneEuroParameters parameters{1.0f, 5.0f, 1.0f};
+    xr::math::OneEuroFilter filter(parameters, parameters);
+    const float dt = xr::math::ToSeconds(FrameDuration);
+
+    // The first sample and samples that don't move forward in time pass through.
+    CHECK(Near(filter.Filter(StartTime, MakePose({0, 0, 0})).position, {0, 0, 0}));
+    CHECK(Near(filter.Filter(StartTime, MakePose({1, 0, 0})).position, {1, 0, 0}));
+    filter.Reset();
+    filter.Filter(StartTime, MakePose({0, 0, 0}));
+
+    // The first step of 10 cm raises the speed estimate and with it the cutoff.
+    const float speed = Alpha(parameters.DerivativeCutoff, dt) * 0.1f / dt;
+    const float expected = 0.1f * Alpha(parameters.MinCutoff + parameters.Beta * speed, dt);
+    float previous = filter.Filter(StartTime + FrameDuration, MakePose({0.1f, 0, 0}, AboutZ(0.2f))).position.x;
+    CHECK(test::Near(previous, expected, 1e-5));
+
+    // It then approaches the target without overshooting, in position and orientation.
+    XrPosef filtered{};
+    for (int frame = 2; frame < 90; frame++) {
+        filtered = filter.Filter(StartTime + frame * FrameDuration, MakePose({0.1f, 0, 0}, AboutZ(0.2f)));
+        CHECK(filtered.position.x >= previous);
+        CHECK(filtered.position.x <= 0.1f);
+        previous = filtered.position.x;
+    }
+    CHECK(test::Near(filtered.position.x, 0.1f, 1e-3));
+    CHECK(AngleBetween(filtered.orientation, AboutZ(0.2f)) < 2e-3f);
+}
+
+// Without beta the filter is an exponential smoothing, whose lag behind a ramp settles at (1 - a) v dt / a. The adaptive
+// cutoff of the One-Euro filter cuts that lag down.
+TEST_CASE(OneEuroFilterRampResponse) {
+    constexpr float Velocity = 0.5f;
+    const float dt = xr::math::ToSeconds(FrameDuration);
+    const auto settledLag = [&](float beta) {
+        xr::math::OneEuroFilter filter({1.0f, beta, 1.0f});
+        float lag = 0;
+        for (int frame = 0; frame <= 270; frame++) {
+            const float position = Velocity * frame * dt;
+            lag = position - filter.Filter(StartTime + frame * FrameDuration, MakePose({position, 0, 0})).position.x;
+        }
+        return lag;
+    };
+
+    const float alpha = Alpha(1.0f, dt);
+    CHECK(test::Near(settledLag(0), (1 - alpha) * Velocity * dt / alpha, 1e-4));
+    CHECK(settledLag(5) < settledLag(0) / 2);
+}
+
+TEST_CASE(DoubleExponentialFilterStepResponse) {
+    xr::math::DoubleExponentialFilter filter(0.5f);
+    CHECK(!filter.Predict(StartTime).has_value());
+    filter.Filter(StartTime, MakePose({0, 0, 0}));
+
+    // The first smoothed step is a (2 - a) times the step, as single = a and double = a^2.
+    XrPosef filtered = filter.Filter(StartTime + FrameDuration, MakePose({1, 0, 0}));
+    CHECK(test::Near(filtered.position.x, 0.75f, Tolerance));
+    for (int frame = 2; frame < 30; frame++) {
+        filtered = filter.Filter(StartTime + frame * FrameDuration, MakePose({1, 0, 0}));
+    }
+    CHECK(test::Near(filtered.position.x, 1.0f, 1e-4));
+}
+
+// Brown's filter follows a ramp without lag once settled, and predicts along it, for positions and orientations alike.
+TEST_CASE(DoubleExponentialFilterRampResponse) {
+    constexpr float Velocity = 0.5f;
+    constexpr float AngularVelocity = 1.0f;
+    const float dt = xr::math::ToSeconds(FrameDuration);
+    xr::math::DoubleExponentialFilter filter(0.5f);
+    XrPosef filtered{};
+    constexpr int FrameCount = 60;
+    for (int frame = 0; frame < FrameCount; frame++) {
+        const float t = frame * dt;
+        filtered = filter.Filter(StartTime + frame * FrameDuration, MakePose({Velocity * t, 0, 0}, AboutZ(AngularVelocity * t)));
+    }
+
+    const float t = (FrameCount - 1) * dt;
+    CHECK(test::Near(filtered.position.x, Velocity * t, 1e-4));
+    CHECK(AngleBetween(filtered.orientation, AboutZ(AngularVelocity * t)) < 1e-3f);
+
+    const XrPosef predicted = filter.Predict(StartTime + (FrameCount - 1 + 3) * FrameDuration).value();
+    CHECK(test::Near(predicted.position.x, Velocity * (t + 3 * dt), 1e-4));
+    CHECK(AngleBetween(predicted.orientation, AboutZ(AngularVelocity * (t + 3 * dt))) < 1e-3f);
+}
+
+// The joints of one or both hands move smoothly with jitter, and some of them lose tracking for a while. The SIMD filter
+// must stay within 3e-8 m and 5e-3 rad of a scalar filter per joint, which restarts whenever its joint is invalid.
+TEST_CASE(JointsOneEuroFilterMatchesScalarFilter) {
+    for (const size_t jointCount : {size_t{26}, size_t{52}, size_t{27}}) {
+        std::mt19937 random(static_cast<uint32_t>(jointCount));
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        xr::math::JointsOneEuroFilter jointsFilter(jointCount);
+        std::vector<xr::math::OneEuroFilter> scalarFilters(jointCount);
+        CHECK(jointsFilter.JointCount() == jointCount);
+
+        std::vector<XrVector3f> offsets(jointCount);
+        for (XrVector3f& offset : offsets) {
+            offset = {unit(random) * 0.1f, unit(random) * 0.1f, unit(random) * 0.1f};
+        }
+
+        float worstPosition = 0;
+        float worstOrientation = 0;
+        std::vector<XrHandJointLocationEXT> joints(jointCount);
+        for (int frame = 0; frame < 180; frame++) {
+            const float t = frame * xr::math::ToSeconds(FrameDuration);
+            for (size_t i = 0; i < jointCount; i++) {
+                // Joints 5 and the last one lose tracking for a while, joint 2 blinks.
+                const bool lost = (i == 5 && frame >= 40 && frame < 60) || (i == jointCount - 1 && frame >= 100 && frame < 103) ||
+                                  (i == 2 && frame % 7 == 3);
+                const float wave = std::sin(3 * t + i);
+                joints[i].locationFlags =
+                    lost ? 0 : XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+                joints[i].pose.position = {offsets[i].x + 0.05f * wave + 0.001f * unit(random),
+                                           offsets[i].y + 0.02f * t + 0.001f * unit(random),
+                                           offsets[i].z + 0.001f * unit(random)};
+                joints[i].pose.orientation = xr::math::Quaternion::RotationAxisAngle(
+                    xr::math::Normalize(XrVector3f{1, 0.5f, static_cast<float>(i % 3)}), 0.4f * wave + 0.01f * unit(random));
+                joints[i].radius = 0.01f;
+            }
+
+            std::vector<XrHandJointLocationEXT> filteredJoints = joints;
+            jointsFilter.Filter(StartTime + frame * FrameDuration, filteredJoints.data(), jointCount);
+            for (size_t i = 0; i < jointCount; i++) {
+                if (!xr::math::Pose::IsPoseValid(joints[i])) {
+                    scalarFilters[i].Reset();
+                    CHECK(Near(filteredJoints[i].pose.position, joints[i].pose.position, 0));
+                    continue;
+                }
+
+                const XrPosef expected = scalarFilters[i].Filter(StartTime + frame * FrameDuration, joints[i].pose);
+                const XrVector3f& position = filteredJoints[i].pose.position;
+                worstPosition = std::max({worstPosition,
+                                          std::abs(position.x - expected.position.x),
+                                          std::abs(position.y - expected.position.y),
+                                          std::abs(position.z - expected.position.z)});
+                worstOrientation = std::max(worstOrientation, AngleBetween(filteredJoints[i].pose.orientation, expected.orientation));
+            }
+        }
+
+        CHECK(worstPosition <= 3e-8f);
+        CHECK(worstOrientation <= 5e-3f);
+    }
+}
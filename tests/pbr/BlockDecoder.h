@@ -0,0 +1,191 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+// Reference decoders of the block formats written by Pbr::EncodeBlock, following the BC format descriptions of the Direct3D
+// documentation. Only BC7 mode 6 is decoded, the only mode the encoder writes.
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <pbr/PbrBlockEncoding.h>
+
+namespace test {
+    // Reads the bit fields of a block, starting at the least significant bit of the first byte.
+    class BitReader {
+    public:
+        explicit BitReader(const uint8_t* block)
+            : m_block(block) {
+        }
+
+        uint32_t Read(uint32_t bitCount) {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < bitCount; i++, m_position++) {
+                value |= ((m_block[m_position / 8] >> (m_position % 8)) & 1u) << i;
+            }
+            return value;
+        }
+
+    private:
+        const uint8_t* m_block;
+        uint32_t m_position{0};
+    };
+
+    inline std::array<uint32_t, 3> Expand565(uint32_t color) {
+        const uint32_t r = (color >> 11) & 31;
+        const uint32_t g = (color >> 5) & 63;
+        const uint32_t b = color & 31;
+        return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+    }
+
+    // Decodes the RGB of a BC1 block. alwaysFourColors is set for the color half of BC3, which has no three color mode.
+    inline void DecodeColorBlock(const uint8_t* block, bool alwaysFourColors, std::array<uint8_t, 64>& rgba) {
+        BitReader reader(block);
+        const uint32_t color0 = reader.Read(16);
+        const uint32_t color1 = reader.Read(16);
+        const std::array<uint32_t, 3> c0 = Expand565(color0);
+        const std::array<uint32_t, 3> c1 = Expand565(color1);
+
+        uint32_t palette[4][4];
+        for (uint32_t channel = 0; channel < 3; channel++) {
+            palette[0][channel] = c0[channel];
+            palette[1][channel] = c1[channel];
+            if (alwaysFourColors || color0 > color1) {
+                palette[2][channel] = (2 * c0[channel] + c1[channel] + 1) / 3;
+                palette[3][channel] = (c0[channel] + 2 * c1[channel] + 1) / 3;
+            } else {
+                palette[2][channel] = (c0[channel] + c1[channel]) / 2;
+                palette[3][channel] = 0;
+            }
+        }
+        for (uint32_t i = 0; i < 4; i++) {
+            palette[i][3] = (!alwaysFourColors && color0 <= color1 && i == 3) ? 0 : 255;
+        }
+
+        for (uint32_t t = 0; t < 16; t++) {
+            const uint32_t index = reader.Read(2);
+            for (uint32_t channel = 0; channel < 4; channel++) {
+                rgba[t * 4 + channel] = static_cast<uint8_t>(palette[index][channel]);
+            }
+        }
+    }
+
+    // Decodes a BC4 block into one channel of the texels.
+    inline void DecodeChannelBlock(const uint8_t* block, uint32_t channel, std::array<uint8_t, 64>& rgba) {
+        BitReader reader(block);
+        const uint32_t e0 = reader.Read(8);
+        const uint32_t e1 = reader.Read(8);
+
+        uint32_t values[8] = {e0, e1};
+        if (e0 > e1) {
+            for (uint32_t i = 1; i < 7; i++) {
+                values[i + 1] = ((7 - i) * e0 + i * e1 + 3) / 7;
+            }
+        } else {
+            for (uint32_t i = 1; i < 5; i++) {
+                values[i + 1] = ((5 - i) * e0 + i * e1 + 2) / 5;
+            }
+            values[6] = 0;
+            values[7] = 255;
+        }
+
+        for (uint32_t t = 0; t < 16; t++) {
+            rgba[t * 4 + channel] = static_cast<uint8_t>(values[reader.Read(3)]);
+        }
+    }
+
+    // Decodes a BC7 mode 6 block: one subset, RGBA endpoints with 7 bits and a p-bit each, and 4 bit indices.
+    inline void DecodeBc7Block(const uint8_t* block, std::array<uint8_t, 64>& rgba) {
+        constexpr uint32_t Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        BitReader reader(block);
+        if (reader.Read(7) != (1u << 6)) {
+            throw std::runtime_error("Only BC7 mode 6 is decoded");
+        }
+
+        uint32_t endpoints[2][4];
+        for (uint32_t channel = 0; channel < 4; channel++) {
+            endpoints[0][channel] = reader.Read(7) << 1;
+            endpoints[1][channel] = reader.Read(7) << 1;
+        }
+        for (uint32_t e = 0; e < 2; e++) {
+            const uint32_t pBit = reader.Read(1);
+            for (uint32_t channel = 0; channel < 4; channel++) {
+                endpoints[e][channel] |= pBit;
+            }
+        }
+
+        for (uint32_t t = 0; t < 16; t++) {
+            const uint32_t weight = Weights4[reader.Read(t == 0 ? 3 : 4)];
+            for (uint32_t channel = 0; channel < 4; channel++) {
+                const uint32_t weighted = (64 - weight) * endpoints[0][channel] + weight * endpoints[1][channel];
+                rgba[t * 4 + channel] = static_cast<uint8_t>((weighted + 32) >> 6);
+            }
+        }
+    }
+
+    // Decodes one block into 4x4 RGBA texels in rows. Channels a format doesn't store are 0, and alpha is 255.
+    inline std::array<uint8_t, 64> DecodeBlock(Pbr::BlockFormat format, const uint8_t* block) {
+        std::array<uint8_t, 64> rgba{};
+        switch (format) {
+        case Pbr::BlockFormat::BC1:
+            DecodeColorBlock(block, false, rgba);
+            break;
+        case Pbr::BlockFormat::BC3:
+            DecodeColorBlock(block + 8, true, rgba);
+            DecodeChannelBlock(block, 3, rgba);
+            break;
+        case Pbr::BlockFormat::BC5:
+            DecodeChannelBlock(block, 0, rgba);
+            DecodeChannelBlock(block + 8, 1, rgba);
+            for (uint32_t t = 0; t < 16; t++) {
+                rgba[t * 4 + 3] = 255;
+            }
+            break;
+        case Pbr::BlockFormat::BC7:
+            DecodeBc7Block(block, rgba);
+            break;
+        }
+        return rgba;
+    }
+
+    // Decodes a level of a compressed texture into tightly packed RGBA rows.
+    inline std::vector<uint8_t> DecodeLevel(const Pbr::CompressedTexture& texture, size_t level) {
+        const uint32_t width = texture.Levels[level].Width;
+        const uint32_t height = texture.Levels[level].Height;
+        const uint32_t blocksX = (width + 3) / 4;
+        const uint32_t blocksY = (height + 3) / 4;
+        const uint32_t blockBytes = Pbr::BlockBytes(texture.Format);
+
+        std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+        for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+            for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+                const uint8_t* block = texture.LevelData(level) + (static_cast<size_t>(blockY) * blocksX + blockX) * blockBytes;
+                const std::array<uint8_t, 64> texels = DecodeBlock(texture.Format, block);
+                for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; y++) {
+                    for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; x++) {
+                        const size_t offset = (static_cast<size_t>(blockY * 4 + y) * width + blockX * 4 + x) * 4;
+                        for (uint32_t channel = 0; channel < 4; channel++) {
+                            rgba[offset + channel] = texels[(y * 4 + x) * 4 + channel];
+                        }
+                    }
+                }
+            }
+        }
+        return rgba;
+    }
+} // namespace test
@@ -0,0 +1,111 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#pragma once
+
+// A headless OpenGL ES 3.0 context for the tests and benchmarks of the GLES renderer. It renders into a framebuffer object
+// without any window, on the surfaceless platform of Mesa, so with LIBGL_ALWAYS_SOFTWARE=1 it runs on llvmpipe anywhere.
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES3/gl3.h>
+
+namespace test {
+    class GlesContext {
+    public:
+        GlesContext(uint32_t width, uint32_t height)
+            : m_width(width)
+            , m_height(height) {
+            const auto getPlatformDisplay =
+                reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+            m_display = getPlatformDisplay != nullptr ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+                                                      : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+            if (m_display == EGL_NO_DISPLAY || !eglInitialize(m_display, nullptr, nullptr)) {
+                throw std::runtime_error("No EGL display");
+            }
+
+            const EGLint configAttributes[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT, EGL_NONE};
+            EGLConfig config = nullptr;
+            EGLint configCount = 0;
+            if (!eglBindAPI(EGL_OPENGL_ES_API) || !eglChooseConfig(m_display, configAttributes, &config, 1, &configCount) ||
+                configCount == 0) {
+                throw std::runtime_error("No OpenGL ES 3 config");
+            }
+
+            const EGLint contextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 0, EGL_NONE};
+            m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, contextAttributes);
+            if (m_context == EGL_NO_CONTEXT || !eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context)) {
+                throw std::runtime_error("Failed to make a surfaceless OpenGL ES 3 context current");
+            }
+
+            glGenRenderbuffers(static_cast<GLsizei>(m_renderbuffers.size()), m_renderbuffers.data());
+            glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffers[0]);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+            glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffers[1]);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+            glGenFramebuffers(1, &m_framebuffer);
+            glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_renderbuffers[0]);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_renderbuffers[1]);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                throw std::runtime_error("Incomplete framebuffer");
+            }
+            glViewport(0, 0, width, height);
+        }
+
+        ~GlesContext() {
+            glDeleteFramebuffers(1, &m_framebuffer);
+            glDeleteRenderbuffers(static_cast<GLsizei>(m_renderbuffers.size()), m_renderbuffers.data());
+            eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroyContext(m_display, m_context);
+            eglTerminate(m_display);
+        }
+
+        GlesContext(const GlesContext&) = delete;
+        GlesContext& operator=(const GlesContext&) = delete;
+
+        std::string Renderer() const {
+            return reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+        }
+
+        void Clear(float depth = 1) {
+            glDepthMask(GL_TRUE);
+            glClearColor(0, 0, 0, 0);
+            glClearDepthf(depth);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
+
+        // Reads the RGBA pixel at x and y, counted from the top left as in Direct3D.
+        std::array<uint8_t, 4> Pixel(uint32_t x, uint32_t y) const {
+            std::array<uint8_t, 4> pixel{};
+            glReadPixels(x, m_height - 1 - y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel.data());
+            return pixel;
+        }
+
+    private:
+        const uint32_t m_width;
+        const uint32_t m_height;
+        EGLDisplay m_display{EGL_NO_DISPLAY};
+        EGLContext m_context{EGL_NO_CONTEXT};
+        std::array<GLuint, 2> m_renderbuffers{};
+        GLuint m_framebuffer{0};
+    };
+} // namespace test
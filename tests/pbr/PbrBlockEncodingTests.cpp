@@ -0,0 +1,208 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <cmath>
+#include <cstdlib>
+#include <pbr/PbrBlockEncoding.h>
+#include "BlockDecoder.h"
+#include "TestFramework.h"
+
+namespace {
+    constexpr uint32_t ImageSize = 64;
+
+    // Reference images, generated so they are the same on every run: a smooth gradient, a photo-like image of overlapping
+    // waves with grain, hard edges with an alpha ramp, and a tangent-space normal map of a bumpy surface.
+    enum class ReferenceImage { Gradient, Photo, Edges, NormalMap };
+
+    uint8_t ToByte(float value) {
+        return static_cast<uint8_t>(std::lround(std::fmin(std::fmax(value, 0.0f), 255.0f)));
+    }
+
+    std::vector<uint8_t> CreateReferenceImage(ReferenceImage image) {
+        std::vector<uint8_t> rgba(ImageSize * ImageSize * 4);
+        uint32_t random = 12345;
+        for (uint32_t y = 0; y < ImageSize; y++) {
+            for (uint32_t x = 0; x < ImageSize; x++) {
+                uint8_t* texel = &rgba[(y * ImageSize + x) * 4];
+                const float u = x / float(ImageSize - 1);
+                const float v = y / float(ImageSize - 1);
+                switch (image) {
+                case ReferenceImage::Gradient:
+                    texel[0] = ToByte(u * 255);
+                    texel[1] = ToByte(v * 255);
+                    texel[2] = ToByte((1 - u) * v * 255);
+                    texel[3] = 255;
+                    break;
+                case ReferenceImage::Photo: {
+                    random = random * 1664525 + 1013904223;
+                    const float grain = static_cast<float>(random >> 24) / 255.0f * 12 - 6;
+                    const float wave = std::sin(u * 9.0f) * std::cos(v * 7.0f);
+                    texel[0] = ToByte(128 + 90 * wave + grain);
+                    texel[1] = ToByte(110 + 70 * std::sin((u + v) * 5.0f) + grain);
+                    texel[2] = ToByte(90 + 60 * std::cos(u * 13.0f - v * 3.0f) + grain);
+                    texel[3] = 255;
+                    break;
+                }
+                case ReferenceImage::Edges: {
+                    const bool dark = ((x / 8) + (y / 8)) % 2 == 0;
+                    texel[0] = dark ? 30 : 230;
+                    texel[1] = dark ? 60 : 200;
+                    texel[2] = dark ? 150 : 20;
+                    texel[3] = ToByte(u * 255);
+                    break;
+                }
+                case ReferenceImage::NormalMap: {
+                    const float dx = 0.6f * std::cos(u * 12.0f) * std::cos(v * 9.0f);
+                    const float dy = -0.5f * std::sin(u * 12.0f) * std::sin(v * 9.0f);
+                    const float length = std::sqrt(dx * dx + dy * dy + 1);
+                    texel[0] = ToByte((dx / length * 0.5f + 0.5f) * 255);
+                    texel[1] = ToByte((dy / length * 0.5f + 0.5f) * 255);
+                    texel[2] = ToByte((1 / length * 0.5f + 0.5f) * 255);
+                    texel[3] = 255;
+                    break;
+                }
+                }
+            }
+        }
+        return rgba;
+    }
+
+    Pbr::MipChain SingleLevel(const std::vector<uint8_t>& rgba, uint32_t width, uint32_t height) {
+        Pbr::MipChain chain;
+        chain.Levels.push_back({width, height, 0});
+        chain.Data = rgba;
+        return chain;
+    }
+
+    // The peak signal to noise ratio of the decoded image in dB, over the channels of the mask (bit 0 for red to bit 3 for alpha).
+    double Psnr(const std::vector<uint8_t>& reference, const std::vector<uint8_t>& decoded, uint32_t channelMask) {
+        double squaredError = 0;
+        size_t count = 0;
+        for (size_t i = 0; i < reference.size(); i++) {
+            if (channelMask & (1u << (i % 4))) {
+                const double difference = double(reference[i]) - double(decoded[i]);
+                squaredError += difference * difference;
+                count++;
+            }
+        }
+        const double meanSquaredError = squaredError / count;
+        return meanSquaredError == 0 ? 100.0 : 10 * std::log10(255.0 * 255.0 / meanSquaredError);
+    }
+
+    constexpr uint32_t Rgb = 0b0111;
+    constexpr uint32_t Alpha = 0b1000;
+    constexpr uint32_t Rg = 0b0011;
+
+    double EncodeAndMeasure(ReferenceImage image, Pbr::BlockFormat format, uint32_t channelMask) {
+        const std::vector<uint8_t> reference = CreateReferenceImage(image);
+        const Pbr::CompressedTexture texture = Pbr::CompressMipChain(SingleLevel(reference, ImageSize, ImageSize), format, false);
+        return Psnr(reference, test::DecodeLevel(texture, 0), channelMask);
+    }
+} // namespace
+
+TEST_CASE(PbrBlockEncoding_SolidBlocksDecodeToTheirColor) {
+    for (const uint8_t value : {0, 1, 37, 128, 200, 254, 255}) {
+        std::array<uint8_t, 64> rgba;
+        for (uint32_t t = 0; t < 16; t++) {
+            rgba[t * 4 + 0] = value;
+            rgba[t * 4 + 1] = static_cast<uint8_t>(255 - value);
+            rgba[t * 4 + 2] = static_cast<uint8_t>(value / 2);
+            rgba[t * 4 + 3] = static_cast<uint8_t>(value | 1);
+        }
+
+        // BC4 channels are exact and BC7 is off by at most one. BC1 colors are limited by the 5:6:5 endpoints.
+        struct Case {
+            Pbr::BlockFormat Format;
+            int ColorTolerance;
+            uint32_t ChannelCount;
+        };
+        for (const Case& c : {Case{Pbr::BlockFormat::BC1, 4, 3},
+                              Case{Pbr::BlockFormat::BC3, 4, 4},
+                              Case{Pbr::BlockFormat::BC5, 0, 2},
+                              Case{Pbr::BlockFormat::BC7, 1, 4}}) {
+            const Pbr::BlockFormat format = c.Format;
+            uint8_t block[16];
+            Pbr::EncodeBlock(format, rgba, block);
+            const std::array<uint8_t, 64> decoded = test::DecodeBlock(format, block);
+            for (uint32_t t = 0; t < 16; t++) {
+                for (uint32_t channel = 0; channel < c.ChannelCount; channel++) {
+                    const int error = std::abs(int(decoded[t * 4 + channel]) - int(rgba[t * 4 + channel]));
+                    const bool bc4Channel = format == Pbr::BlockFormat::BC3 && channel == 3; // BC3 alpha is a BC4 channel.
+                    CHECK(error <= (bc4Channel ? 0 : c.ColorTolerance));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(PbrBlockEncoding_ReferenceImagesKeepTheirQuality) {
+    // The thresholds are a couple of dB below what the encoder reaches, so a regression of the endpoint fit fails them.
+    CHECK(EncodeAndMeasure(ReferenceImage::Gradient, Pbr::BlockFormat::BC1, Rgb) > 36);
+    CHECK(EncodeAndMeasure(ReferenceImage::Gradient, Pbr::BlockFormat::BC7, Rgb) > 38);
+    CHECK(EncodeAndMeasure(ReferenceImage::Photo, Pbr::BlockFormat::BC1, Rgb) > 32);
+    CHECK(EncodeAndMeasure(ReferenceImage::Photo, Pbr::BlockFormat::BC7, Rgb) > 33);
+
+    // The edges fall on block boundaries, so every block is flat in color and only the endpoint precision is lost.
+    CHECK(EncodeAndMeasure(ReferenceImage::Edges, Pbr::BlockFormat::BC1, Rgb) > 39);
+    CHECK(EncodeAndMeasure(ReferenceImage::Edges, Pbr::BlockFormat::BC3, Rgb) > 39);
+    CHECK(EncodeAndMeasure(ReferenceImage::Edges, Pbr::BlockFormat::BC3, Alpha) > 48);
+    CHECK(EncodeAndMeasure(ReferenceImage::Edges, Pbr::BlockFormat::BC7, Rgb) > 60);
+    CHECK(EncodeAndMeasure(ReferenceImage::Edges, Pbr::BlockFormat::BC7, Alpha) > 50);
+
+    CHECK(EncodeAndMeasure(ReferenceImage::NormalMap, Pbr::BlockFormat::BC5, Rg) > 44);
+    CHECK(EncodeAndMeasure(ReferenceImage::NormalMap, Pbr::BlockFormat::BC1, Rg) > 32);
+}
+
+TEST_CASE(PbrBlockEncoding_HighQualityFormatsBeatTheFastOnes) {
+    // TextureCompression::HighQuality picks BC7 over BC1 for colors, and both settings pick BC5 over BC1 for normal maps.
+    for (const ReferenceImage image : {ReferenceImage::Gradient, ReferenceImage::Photo, ReferenceImage::Edges}) {
+        CHECK(EncodeAndMeasure(image, Pbr::BlockFormat::BC7, Rgb) > EncodeAndMeasure(image, Pbr::BlockFormat::BC1, Rgb) + 1);
+    }
+    CHECK(EncodeAndMeasure(ReferenceImage::NormalMap, Pbr::BlockFormat::BC5, Rg) >
+          EncodeAndMeasure(ReferenceImage::NormalMap, Pbr::BlockFormat::BC1, Rg) + 6);
+}
+
+TEST_CASE(PbrBlockEncoding_CompressesEveryLevelOfTheChain) {
+    // An 8x8 chain down to 1x1, each level a flat color so the decoded levels can be compared exactly.
+    Pbr::MipChain chain;
+    for (uint32_t size = 8; size >= 1; size /= 2) {
+        chain.Levels.push_back({size, size, chain.Data.size()});
+        for (uint32_t t = 0; t < size * size; t++) {
+            chain.Data.insert(chain.Data.end(), {static_cast<uint8_t>(size * 30), 90, static_cast<uint8_t>(255 - size * 20), 255});
+        }
+    }
+
+    const Pbr::CompressedTexture texture = Pbr::CompressMipChain(chain, Pbr::BlockFormat::BC7, true);
+    CHECK(texture.SRGB);
+    REQUIRE(texture.Levels.size() == 4);
+
+    // Levels smaller than a block still take a whole block.
+    const size_t expectedSizes[] = {4 * 16, 16, 16, 16};
+    size_t offset = 0;
+    for (size_t level = 0; level < texture.Levels.size(); level++) {
+        CHECK(texture.Levels[level].Offset == offset);
+        offset += expectedSizes[level];
+
+        const std::vector<uint8_t> decoded = test::DecodeLevel(texture, level);
+        REQUIRE(decoded.size() == static_cast<size_t>(texture.Levels[level].Width) * texture.Levels[level].Height * 4);
+        for (size_t i = 0; i < decoded.size(); i++) {
+            CHECK(std::abs(int(decoded[i]) - int(chain.LevelData(level)[i])) <= 1);
+        }
+    }
+    CHECK(texture.Data.size() == offset);
+
+    chain.Levels[0].Width = 6;
+    CHECK_THROWS(Pbr::CompressMipChain(chain, Pbr::BlockFormat::BC1, false));
+}
@@ -0,0 +1,279 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <DirectXMath/SHMath/DirectXSH.h>
+// The samples link stb_image from the Gltf library, which the tests don't build.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include <pbr/PbrEnvironment.h>
+#include "TestFramework.h"
+
+using namespace DirectX;
+
+namespace {
+    using Radiance = std::function<XMFLOAT3(const XMFLOAT3& direction)>;
+
+    // Small sizes keep the tests fast. Irradiance only needs the 16x16 source level the diffuse harmonics are projected from.
+    Pbr::PrefilterOptions TestOptions() {
+        Pbr::PrefilterOptions options;
+        options.SpecularSize = 16;
+        options.SpecularLevelCount = 3;
+        options.SpecularSampleCount = 16;
+        options.DiffuseSize = 8;
+        return options;
+    }
+
+    XMFLOAT3 Normalized(float x, float y, float z) {
+        const float length = std::sqrt(x * x + y * y + z * z);
+        return {x / length, y / length, z / length};
+    }
+
+    // The direction through a texel of each layout, written from the layout definitions rather than shared with the
+    // implementation: D3D cube faces, and equirectangular longitude from -Z towards +X with +Y on the top row.
+    XMFLOAT3 CubeDirection(uint32_t face, uint32_t size, uint32_t x, uint32_t y) {
+        const float u = 2 * (x + 0.5f) / size - 1;
+        const float v = 2 * (y + 0.5f) / size - 1;
+        switch (face) {
+        case 0: return Normalized(1, -v, -u);
+        case 1: return Normalized(-1, -v, u);
+        case 2: return Normalized(u, 1, v);
+        case 3: return Normalized(u, -1, -v);
+        case 4: return Normalized(u, -v, 1);
+        default: return Normalized(-u, -v, -1);
+        }
+    }
+
+    XMFLOAT3 EquirectangularDirection(uint32_t width, uint32_t height, uint32_t x, uint32_t y) {
+        const float longitude = ((x + 0.5f) / width - 0.5f) * XM_2PI;
+        const float latitude = (y + 0.5f) / height * XM_PI;
+        return {std::sin(latitude) * std::sin(longitude), std::cos(latitude), -std::sin(latitude) * std::cos(longitude)};
+    }
+
+    Pbr::EnvironmentImage CreateEnvironment(Pbr::EnvironmentLayout layout, const Radiance& radiance) {
+        Pbr::EnvironmentImage image;
+        image.Layout = layout;
+        auto store = [&](const XMFLOAT3& direction) {
+            const XMFLOAT3 color = radiance(direction);
+            image.Texels.push_back({color.x, color.y, color.z, 1});
+        };
+
+        if (layout == Pbr::EnvironmentLayout::Cube) {
+            image.Width = image.Height = 32;
+            for (uint32_t face = 0; face < 6; face++) {
+                for (uint32_t y = 0; y < image.Height; y++) {
+                    for (uint32_t x = 0; x < image.Width; x++) {
+                        store(CubeDirection(face, image.Width, x, y));
+                    }
+                }
+            }
+        } else {
+            image.Width = 128;
+            image.Height = 64;
+            for (uint32_t y = 0; y < image.Height; y++) {
+                for (uint32_t x = 0; x < image.Width; x++) {
+                    store(EquirectangularDirection(image.Width, image.Height, x, y));
+                }
+            }
+        }
+        return image;
+    }
+
+    XMFLOAT3 EvaluateDiffuseSH(const Pbr::PrefilteredEnvironment& environment, const XMFLOAT3& normal) {
+        float basis[9];
+        XMSHEvalDirection(basis, 3, XMLoadFloat3(&normal));
+        return {XMSHDot(3, basis, environment.DiffuseSH[0].data()),
+                XMSHDot(3, basis, environment.DiffuseSH[1].data()),
+                XMSHDot(3, basis, environment.DiffuseSH[2].data())};
+    }
+
+    // The 26 directions towards the faces, edges and corners of a cube cover the sphere evenly enough.
+    std::vector<XMFLOAT3> TestNormals() {
+        std::vector<XMFLOAT3> normals;
+        for (int x = -1; x <= 1; x++) {
+            for (int y = -1; y <= 1; y++) {
+                for (int z = -1; z <= 1; z++) {
+                    if (x != 0 || y != 0 || z != 0) {
+                        normals.push_back(Normalized(float(x), float(y), float(z)));
+                    }
+                }
+            }
+        }
+        return normals;
+    }
+
+    // Checks the irradiance divided by pi of both layouts, against the expected value for every test normal.
+    void CheckIrradiance(const Radiance& radiance, const Radiance& expected, float tolerance) {
+        for (Pbr::EnvironmentLayout layout : {Pbr::EnvironmentLayout::Equirectangular, Pbr::EnvironmentLayout::Cube}) {
+            const Pbr::PrefilteredEnvironment environment = Pbr::PrefilterEnvironment(CreateEnvironment(layout, radiance), TestOptions());
+            for (const XMFLOAT3& normal : TestNormals()) {
+                const XMFLOAT3 irradiance = EvaluateDiffuseSH(environment, normal);
+                const XMFLOAT3 reference = expected(normal);
+                CHECK_NEAR(irradiance.x, reference.x, tolerance);
+                CHECK_NEAR(irradiance.y, reference.y, tolerance);
+                CHECK_NEAR(irradiance.z, reference.z, tolerance);
+            }
+        }
+    }
+
+    // Encodes an uncompressed Radiance HDR file, which stb_image reads back exactly for values with few significant bits.
+    std::vector<uint8_t> EncodeHdr(uint32_t width, uint32_t height, const std::function<XMFLOAT3(uint32_t, uint32_t)>& texel) {
+        const std::string header =
+            "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y " + std::to_string(height) + " +X " + std::to_string(width) + "\n";
+        std::vector<uint8_t> file(header.begin(), header.end());
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                const XMFLOAT3 color = texel(x, y);
+                const float maxComponent = std::fmax(color.x, std::fmax(color.y, color.z));
+                if (maxComponent <= 0) {
+                    file.insert(file.end(), {0, 0, 0, 0});
+                    continue;
+                }
+
+                int exponent;
+                const float scale = std::frexp(maxComponent, &exponent) * 256 / maxComponent;
+                file.push_back(static_cast<uint8_t>(color.x * scale));
+                file.push_back(static_cast<uint8_t>(color.y * scale));
+                file.push_back(static_cast<uint8_t>(color.z * scale));
+                file.push_back(static_cast<uint8_t>(exponent + 128));
+            }
+        }
+        return file;
+    }
+
+    XMFLOAT3 SkyAndGround(const XMFLOAT3& direction) {
+        const float sky = direction.y > 0 ? 1.0f : 0.0f;
+        return {sky, sky, sky};
+    }
+} // namespace
+
+// Irradiance of a uniform radiance L is pi * L, so the diffuse map holds L for every normal.
+TEST_CASE(ConstantEnvironmentHasUniformIrradiance) {
+    const Radiance constant = [](const XMFLOAT3&) { return XMFLOAT3{0.5f, 1.0f, 2.0f}; };
+    CheckIrradiance(constant, constant, 0.01f);
+
+    const Pbr::PrefilteredEnvironment environment =
+        Pbr::PrefilterEnvironment(CreateEnvironment(Pbr::EnvironmentLayout::Cube, constant), TestOptions());
+    REQUIRE(environment.Diffuse.Size == 8);
+    REQUIRE(environment.Diffuse.Texels.size() == 6 * 8 * 8);
+    for (const PackedVector::XMHALF4& texel : environment.Diffuse.Texels) {
+        CHECK_NEAR(PackedVector::XMConvertHalfToFloat(texel.x), 0.5, 0.01);
+        CHECK_NEAR(PackedVector::XMConvertHalfToFloat(texel.y), 1.0, 0.01);
+        CHECK_NEAR(PackedVector::XMConvertHalfToFloat(texel.z), 2.0, 0.02);
+    }
+}
+
+// Radiance linear in the direction is held exactly by the first two bands, which the cosine lobe scales by 1 and 2/3:
+// radiance 1 + dot(a, d) gives irradiance / pi of 1 + 2/3 dot(a, n).
+TEST_CASE(LinearEnvironmentMatchesAnalyticIrradiance) {
+    const XMFLOAT3 a{0.3f, 0.6f, -0.2f};
+    const Radiance linear = [&](const XMFLOAT3& d) {
+        const float value = 1 + a.x * d.x + a.y * d.y + a.z * d.z;
+        return XMFLOAT3{value, 0.5f * value, 0.25f * value};
+    };
+    const Radiance irradiance = [&](const XMFLOAT3& n) {
+        const float value = 1 + 2 / 3.0f * (a.x * n.x + a.y * n.y + a.z * n.z);
+        return XMFLOAT3{value, 0.5f * value, 0.25f * value};
+    };
+    CheckIrradiance(linear, irradiance, 0.01f);
+}
+
+// A bright sky over a black ground lights a surface tilted by theta from up with irradiance pi (1 + cos theta) / 2. The
+// step only has odd bands besides the constant, and the cosine lobe removes the odd bands above the first, so order 3
+// harmonics hold this exactly.
+TEST_CASE(SkyAndGroundMatchAnalyticIrradiance) {
+    CheckIrradiance(SkyAndGround,
+                    [](const XMFLOAT3& n) {
+                        const float value = (1 + n.y) / 2;
+                        return XMFLOAT3{value, value, value};
+                    },
+                    0.02f);
+}
+
+// The same split along x checks that the layouts are oriented as documented, and not mirrored.
+TEST_CASE(EastAndWestMatchAnalyticIrradiance) {
+    CheckIrradiance([](const XMFLOAT3& d) { return d.x > 0 ? XMFLOAT3{1, 0, 0} : XMFLOAT3{0, 0, 1}; },
+                    [](const XMFLOAT3& n) {
+                        return XMFLOAT3{(1 + n.x) / 2, 0, (1 - n.x) / 2};
+                    },
+                    0.02f);
+}
+
+TEST_CASE(CacheDecodesCubeImages) {
+    // Six 8x8 faces stacked vertically: the four side faces are split at the horizon, +Y is sky and -Y is ground.
+    constexpr uint32_t FaceSize = 8;
+    const std::vector<uint8_t> cubeFile = EncodeHdr(FaceSize, FaceSize * 6, [](uint32_t x, uint32_t y) {
+        return SkyAndGround(CubeDirection(y / FaceSize, FaceSize, x, y % FaceSize));
+    });
+
+    Pbr::EnvironmentCache cache;
+    const auto cube = cache.Prefilter(cubeFile.data(), cubeFile.size(), Pbr::EnvironmentLayout::Cube, TestOptions()).get();
+    for (const XMFLOAT3& normal : TestNormals()) {
+        CHECK_NEAR(EvaluateDiffuseSH(*cube, normal).x, (1 + normal.y) / 2, 0.03);
+    }
+
+    // Identical content and layout share the result, the other layout is filtered separately.
+    CHECK(cache.Prefilter(cubeFile.data(), cubeFile.size(), Pbr::EnvironmentLayout::Cube, TestOptions()).get() == cube);
+    const auto equirectangular =
+        cache.Prefilter(cubeFile.data(), cubeFile.size(), Pbr::EnvironmentLayout::Equirectangular, TestOptions()).get();
+    CHECK(equirectangular != cube);
+
+    const std::vector<uint8_t> notCube = EncodeHdr(16, 8, [](uint32_t, uint32_t) { return XMFLOAT3{1, 1, 1}; });
+    CHECK_THROWS(cache.Prefilter(notCube.data(), notCube.size(), Pbr::EnvironmentLayout::Cube, TestOptions()).get());
+    CHECK(cache.Prefilter(notCube.data(), notCube.size(), Pbr::EnvironmentLayout::Equirectangular, TestOptions()).get() != nullptr);
+}
+
+// The app passes the path of a file, which is read on the worker instead of the thread starting the filtering.
+TEST_CASE(CacheReadsNamedFilesOnWorkers) {
+    const std::vector<uint8_t> file = EncodeHdr(32, 16, [](uint32_t x, uint32_t y) {
+        return SkyAndGround(EquirectangularDirection(32, 16, x, y));
+    });
+
+    Pbr::EnvironmentCache cache;
+    std::thread::id readerThread;
+    uint32_t readCount = 0;
+    const auto readFile = [&] {
+        readerThread = std::this_thread::get_id();
+        readCount++;
+        return file;
+    };
+    const auto environment = cache.Prefilter("sky.hdr", readFile, Pbr::EnvironmentLayout::Equirectangular, TestOptions()).get();
+    CHECK(readerThread != std::this_thread::get_id());
+    for (const XMFLOAT3& normal : TestNormals()) {
+        CHECK_NEAR(EvaluateDiffuseSH(*environment, normal).x, (1 + normal.y) / 2, 0.03);
+    }
+
+    // The same name and layout share the result without reading the file again.
+    CHECK(cache.Prefilter("sky.hdr", readFile, Pbr::EnvironmentLayout::Equirectangular, TestOptions()).get() == environment);
+    CHECK(readCount == 1);
+
+    // Failing to read the file fails the result, as decoding does.
+    const auto failingRead = []() -> std::vector<uint8_t> { throw std::runtime_error("Missing file"); };
+    CHECK_THROWS(cache.Prefilter("missing.hdr", failingRead, Pbr::EnvironmentLayout::Equirectangular, TestOptions()).get());
+}
+
+TEST_CASE(PrefilterRejectsMismatchedImages) {
+    Pbr::EnvironmentImage image = CreateEnvironment(Pbr::EnvironmentLayout::Cube, SkyAndGround);
+    image.Texels.pop_back();
+    CHECK_THROWS(Pbr::PrefilterEnvironment(image, TestOptions()));
+
+    Pbr::PrefilterOptions options = TestOptions();
+    options.DiffuseSize = 0;
+    CHECK_THROWS(Pbr::PrefilterEnvironment(CreateEnvironment(Pbr::EnvironmentLayout::Cube, SkyAndGround), options));
+}
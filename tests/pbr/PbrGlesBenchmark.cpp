@@ -0,0 +1,118 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <pbr/PbrGles.h>
+#include "GlesContext.h"
+
+using namespace DirectX;
+
+// Measures the CPU time the GLES renderer takes to submit a frame of many small primitives, separately from the time the
+// driver takes to draw it, with the nodes still and with every node moving each frame. Run with LIBGL_ALWAYS_SOFTWARE=1
+// to profile on llvmpipe without a GPU.
+// Usage: PbrGlesBenchmark [--quick]
+
+namespace {
+    constexpr uint32_t Size = 256;
+
+    struct Result {
+        double SubmitMicroseconds;
+        double FrameMilliseconds;
+    };
+
+    // A grid of cubes, each on its own node, sharing materialCount materials.
+    Pbr::Gles::Model CreateGrid(const Pbr::Gles::Resources& resources, uint32_t primitiveCount, uint32_t materialCount) {
+        std::vector<std::shared_ptr<Pbr::Gles::Material>> materials;
+        for (uint32_t i = 0; i < materialCount; i++) {
+            const float shade = static_cast<float>(i + 1) / materialCount;
+            materials.push_back(Pbr::Gles::Material::CreateFlat(resources, {shade, 0.5f, 1 - shade, 1}));
+        }
+
+        Pbr::Gles::Model model;
+        const uint32_t columns = static_cast<uint32_t>(std::sqrt(static_cast<float>(primitiveCount))) + 1;
+        for (uint32_t i = 0; i < primitiveCount; i++) {
+            const XMMATRIX transform =
+                XMMatrixTranslation(static_cast<float>(i % columns) - columns / 2.0f, static_cast<float>(i / columns) - columns / 2.0f, 0);
+            const Pbr::NodeIndex_t node = model.AddNode(transform, Pbr::RootNodeIndex);
+            model.AddPrimitive(Pbr::Gles::Primitive(Pbr::PrimitiveBuilder().AddCube(0.5f, node), materials[i % materialCount]));
+        }
+        model.GetNode(Pbr::RootNodeIndex).SetTransform(XMMatrixTranslation(0, 0, -static_cast<float>(columns)));
+        return model;
+    }
+
+    Result Measure(test::GlesContext& context, Pbr::Gles::Resources& resources, Pbr::Gles::Model& model, uint32_t frames, bool moveNodes) {
+        std::chrono::duration<double, std::micro> submit{0};
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < frames; frame++) {
+            context.Clear();
+
+            const auto submitStart = std::chrono::steady_clock::now();
+            if (moveNodes) {
+                for (uint32_t node = 1; node < model.GetNodeCount(); node++) {
+                    Pbr::Node& gridNode = model.GetNode(static_cast<Pbr::NodeIndex_t>(node));
+                    gridNode.SetTransform(XMMatrixRotationZ(0.01f) * gridNode.GetTransform());
+                }
+            }
+            resources.Bind();
+            resources.SetModelToWorld(XMMatrixIdentity());
+            model.Render(resources);
+            submit += std::chrono::steady_clock::now() - submitStart;
+
+            glFinish();
+        }
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return {submit.count() / frames, elapsed.count() / frames};
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    const bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    const uint32_t frames = quick ? 3 : 200;
+
+    test::GlesContext context(Size, Size);
+    Pbr::Gles::Resources resources;
+    resources.SetViewProjection(XMMatrixLookToRH(g_XMZero, g_XMNegIdentityR2, g_XMIdentityR1),
+                                XMMatrixPerspectiveFovRH(XM_PIDIV2, 1, 0.1f, 1000));
+    resources.SetLight({0, 0.7071f, 0.7071f}, Pbr::RGB::White);
+    std::printf("renderer: %s\n", context.Renderer().c_str());
+
+    std::printf("%10s %10s %8s %12s %12s %12s\n", "primitives", "materials", "moving", "submit us", "ns/draw", "frame ms");
+    for (const uint32_t primitiveCount : {100u, 1000u, 4000u}) {
+        for (const uint32_t materialCount : {1u, 16u}) {
+            Pbr::Gles::Model model = CreateGrid(resources, primitiveCount, materialCount);
+            for (const bool moveNodes : {false, true}) {
+                Measure(context, resources, model, 1, moveNodes); // Warm up the driver
+                const Result result = Measure(context, resources, model, frames, moveNodes);
+                std::printf("%10u %10u %8s %12.1f %12.1f %12.2f\n",
+                            primitiveCount,
+                            materialCount,
+                            moveNodes ? "yes" : "no",
+                            result.SubmitMicroseconds,
+                            result.SubmitMicroseconds * 1000 / primitiveCount,
+                            result.FrameMilliseconds);
+            }
+        }
+    }
+
+    if (glGetError() != GL_NO_ERROR) {
+        std::fprintf(stderr, "OpenGL error\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,247 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <memory>
+#include <vector>
+#include <pbr/PbrGles.h>
+#include "GlesContext.h"
+#include "TestFramework.h"
+
+using namespace DirectX;
+
+namespace {
+    constexpr uint32_t Size = 64;
+    constexpr uint32_t Center = Size / 2;
+
+    // Renders into a headless context, viewed from the origin down -z with a 90 degree field of view.
+    struct Fixture {
+        test::GlesContext Context{Size, Size};
+        Pbr::Gles::Resources Resources;
+
+        explicit Fixture(bool reverseZ = false) {
+            Resources.SetDepthFuncReversed(reverseZ);
+            const XMMATRIX projection = reverseZ ? XMMatrixPerspectiveFovRH(XM_PIDIV2, 1, 100, 0.1f)
+                                                 : XMMatrixPerspectiveFovRH(XM_PIDIV2, 1, 0.1f, 100);
+            Resources.SetViewProjection(XMMatrixLookToRH(g_XMZero, g_XMNegIdentityR2, g_XMIdentityR1), projection);
+        }
+
+        // Materials that only emit their color, so that the pixels don't depend on the lighting.
+        std::shared_ptr<Pbr::Gles::Material> Emissive(Pbr::RGBColor color) const {
+            return Pbr::Gles::Material::CreateFlat(Resources, Pbr::RGBA::Black, 1, 0, color);
+        }
+
+        void Render(const std::vector<const Pbr::Gles::Model*>& models) {
+            Context.Clear(Resources.GetDepthFuncReversed() ? 0.0f : 1.0f);
+            Resources.Bind();
+            Resources.SetModelToWorld(XMMatrixIdentity());
+            for (const Pbr::Gles::Model* model : models) {
+                model->Render(Resources);
+            }
+        }
+    };
+
+    bool IsColor(const std::array<uint8_t, 4>& pixel, uint8_t r, uint8_t g, uint8_t b) {
+        const auto near = [](uint8_t actual, uint8_t expected) { return actual + 2 >= expected && actual <= expected + 2; };
+        return near(pixel[0], r) && near(pixel[1], g) && near(pixel[2], b) && pixel[3] == 255;
+    }
+
+    bool IsClear(const std::array<uint8_t, 4>& pixel) {
+        return pixel == std::array<uint8_t, 4>{0, 0, 0, 0};
+    }
+} // namespace
+
+TEST_CASE(AnEmissiveSphereCoversTheCenter) {
+    Fixture fixture;
+    Pbr::Gles::Model model;
+    model.AddPrimitive(Pbr::Gles::Primitive(Pbr::PrimitiveBuilder().AddSphere(1, 16), fixture.Emissive({1, 0, 0})));
+    model.GetNode(Pbr::RootNodeIndex).SetTransform(XMMatrixTranslation(0, 0, -2));
+
+    fixture.Render({&model});
+    CHECK(IsColor(fixture.Context.Pixel(Center, Center), 255, 0, 0));
+    CHECK(IsClear(fixture.Context.Pixel(0, 0)));
+    CHECK(IsClear(fixture.Context.Pixel(Size - 1, Size - 1)));
+    CHECK(glGetError() == GL_NO_ERROR);
+}
+
+// The node transforms take several rows of their texture, 256 nodes per row.
+TEST_CASE(NodeTransformsAreReadFromEveryRow) {
+    Fixture fixture;
+    Pbr::Gles::Model model;
+    for (Pbr::NodeIndex_t node = 1; node < 600; node++) {
+        model.AddNode(XMMatrixIdentity(), Pbr::RootNodeIndex);
+    }
+    const Pbr::NodeIndex_t lastNode = static_cast<Pbr::NodeIndex_t>(model.GetNodeCount() - 1);
+    model.AddPrimitive(Pbr::Gles::Primitive(Pbr::PrimitiveBuilder().AddCube(1, lastNode), fixture.Emissive({0, 1, 0})));
+
+    model.GetNode(lastNode).SetTransform(XMMatrixTranslation(0, 0, -3));
+    fixture.Render({&model});
+    CHECK(IsColor(fixture.Context.Pixel(Center, Center), 0, 255, 0));
+
+    // Moving the node moves the cube out of the view, and moving the root moves it back.
+    model.GetNode(lastNode).SetTransform(XMMatrixTranslation(10, 0, -3));
+    fixture.Render({&model});
+    CHECK(IsClear(fixture.Context.Pixel(Center, Center)));
+
+    model.GetNode(Pbr::RootNodeIndex).SetTransform(XMMatrixTranslation(-10, 0, 0));
+    fixture.Render({&model});
+    CHECK(IsColor(fixture.Context.Pixel(Center, Center), 0, 255, 0));
+    CHECK(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE(BackFacesAreCulledUnlessDoubleSided) {
+    Fixture fixture;
+    for (const bool doubleSided : {false, true}) {
+        std::shared_ptr<Pbr::Gles::Material> material = fixture.Emissive({0, 0, 1});
+        material->SetDoubleSided(doubleSided);
+        Pbr::Gles::Model model;
+        model.AddPrimitive(Pbr::Gles::Primitive(Pbr::PrimitiveBuilder().AddQuad({1, 1}), material));
+
+        // The quad is seen from one side, then turned around and seen from the other.
+        uint32_t drawnSides = 0;
+        for (const float yaw : {0.0f, XM_PI}) {
+            model.GetNode(Pbr::RootNodeIndex).SetTransform(XMMatrixRotationY(yaw) * XMMatrixTranslation(0, 0, -2));
+            fixture.Render({&model});
+            drawnSides += IsColor(fixture.Context.Pixel(Center, Center), 0, 0, 255) ? 1 : 0;
+        }
+        CHECK(drawnSides == (doubleSided ? 2u : 1u));
+    }
+    CHECK(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE(TheNearestPrimitiveWinsWithEitherDepthDirection) {
+    for (const bool reverseZ : {false, true}) {
+        Fixture fixture(reverseZ);
+        Pbr::Gles::Model nearModel;
+        nearModel.AddPrimitive(Pbr::Gles::Primitive(Pbr::PrimitiveBuilder().AddCube(0.5f), fixture.Emissive({0, 1, 0})));
+        nearModel.GetNode(Pbr::RootNodeIndex).SetTransform(XMMatrixTranslation(0, 0, -2));
+        Pbr::Gles::Model farModel;
+        farModel.AddPrimitive(Pbr::Gles::Primitive(Pbr::PrimitiveBuilder().AddCube(2), fixture.Emissive({1, 0, 0})));
+        farModel.GetNode(Pbr::RootNodeIndex).SetTransform(XMMatrixTranslation(0, 0, -5));
+
+        // The order of the draws doesn't matter.
+        fixture.Render({&nearModel, &farModel});
+        CHECK(IsColor(fixture.Context.Pixel(Center, Center), 0, 255, 0));
+        fixture.Render({&farModel, &nearModel});
+        CHECK(IsColor(fixture.Context.Pixel(Center, Center), 0, 255, 0));
+        CHECK(glGetError() == GL_NO_ERROR);
+    }
+}
+
+TEST_CASE(StreamingPrimitivesDrawTheirLatestVertices) {
+    Fixture fixture;
+    const Pbr::PrimitiveBuilder quad = Pbr::PrimitiveBuilder().AddQuad({1, 1});
+    const auto vertexCount = static_cast<uint32_t>(quad.Vertices.size());
+    const auto indexCount = static_cast<uint32_t>(quad.Indices.size());
+
+    std::shared_ptr<Pbr::Gles::Material> material = fixture.Emissive({1, 1, 0});
+    material->SetDoubleSided(true);
+    Pbr::Gles::Model model;
+    model.AddPrimitive(Pbr::Gles::Primitive(vertexCount, indexCount, material));
+    model.GetPrimitive(0).UpdateIndices(quad.Indices.data(), indexCount);
+
+    std::vector<Pbr::Vertex> vertices = quad.Vertices;
+    for (const float x : {0.0f, 10.0f, 0.0f}) {
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            vertices[i].Position = {quad.Vertices[i].Position.x + x, quad.Vertices[i].Position.y, quad.Vertices[i].Position.z - 2};
+        }
+        model.GetPrimitive(0).UpdateVertices(vertices.data(), vertexCount);
+
+        fixture.Render({&model});
+        CHECK(x == 0 ? IsColor(fixture.Context.Pixel(Center, Center), 255, 255, 0) : IsClear(fixture.Context.Pixel(Center, Center)));
+    }
+
+    CHECK_THROWS(model.GetPrimitive(0).UpdateVertices(vertices.data(), vertexCount + 1));
+    CHECK_THROWS(model.GetPrimitive(0).UpdateIndices(quad.Indices.data(), indexCount + 1));
+    CHECK(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE(HiddenMaterialsAreNotDrawn) {
+    Fixture fixture;
+    std::shared_ptr<Pbr::Gles::Material> material = fixture.Emissive({1, 0, 1});
+    Pbr::Gles::Model model;
+    model.AddPrimitive(Pbr::Gles::Primitive(Pbr::PrimitiveBuilder().AddCube(1), material));
+    model.GetNode(Pbr::RootNodeIndex).SetTransform(XMMatrixTranslation(0, 0, -3));
+
+    material->Hidden = true;
+    fixture.Render({&model});
+    CHECK(IsClear(fixture.Context.Pixel(Center, Center)));
+
+    material->Hidden = false;
+    fixture.Render({&model});
+    CHECK(IsColor(fixture.Context.Pixel(Center, Center), 255, 0, 255));
+    CHECK(glGetError() == GL_NO_ERROR);
+}
+
+// The OpenGL ES renderer draws the models built through the device interface it shares with the Direct3D 11 renderer.
+TEST_CASE(ModelsBuiltThroughTheDeviceAreDrawn) {
+    test::GlesContext context{Size, Size};
+    const std::unique_ptr<Pbr::Device> device = Pbr::Gles::CreateDevice();
+    device->SetViewProjection(XMMatrixLookToRH(g_XMZero, g_XMNegIdentityR2, g_XMIdentityR1),
+                              XMMatrixPerspectiveFovRH(XM_PIDIV2, 1, 0.1f, 100));
+
+    const std::shared_ptr<Pbr::DeviceModel> model = device->CreateModel();
+    const Pbr::NodeIndex_t node = model->AddNode(XMMatrixTranslation(0, 0, -3), Pbr::RootNodeIndex, "cube");
+    model->AddPrimitive(Pbr::PrimitiveBuilder().AddCube(1, node), device->CreateFlatMaterial(Pbr::RGBA::Black, 1, 0, {0, 1, 1}));
+    CHECK(model->GetNodeCount() == 2);
+    CHECK(model->GetPrimitiveCount() == 1);
+
+    context.Clear();
+    device->Render(*model, XMMatrixIdentity());
+    CHECK(IsColor(context.Pixel(Center, Center), 0, 255, 255));
+
+    // The model to world transform and the node transforms both move the model.
+    context.Clear();
+    device->Render(*model, XMMatrixTranslation(10, 0, 0));
+    CHECK(IsClear(context.Pixel(Center, Center)));
+
+    model->GetNode(node).SetTransform(XMMatrixTranslation(-10, 0, -3));
+    context.Clear();
+    device->Render(*model, XMMatrixTranslation(10, 0, 0));
+    CHECK(IsColor(context.Pixel(Center, Center), 0, 255, 255));
+    CHECK(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE(DeviceTexturesAreSampledByTheirMaterials) {
+    test::GlesContext context{Size, Size};
+    const std::unique_ptr<Pbr::Device> device = Pbr::Gles::CreateDevice();
+    device->SetViewProjection(XMMatrixLookToRH(g_XMZero, g_XMNegIdentityR2, g_XMIdentityR1),
+                              XMMatrixPerspectiveFovRH(XM_PIDIV2, 1, 0.1f, 100));
+
+    // The emissive texture scales the emissive factor. Full and empty channels read the same in sRGB and linear.
+    const std::vector<uint8_t> yellow(4 * 4 * 4, 255);
+    std::vector<uint8_t> magenta = yellow;
+    for (size_t texel = 0; texel < magenta.size(); texel += 4) {
+        magenta[texel + 1] = 0;
+    }
+    for (const bool sRGB : {false, true}) {
+        const std::shared_ptr<Pbr::DeviceMaterial> material = device->CreateFlatMaterial(Pbr::RGBA::Black, 1, 0, {1, 1, 0});
+        material->SetTexture(Pbr::ShaderSlots::Emissive, device->CreateTexture(magenta.data(), 4, 4, sRGB),
+                             device->CreateSampler(Pbr::TextureAddressMode::Wrap));
+        material->SetDoubleSided(true);
+        const std::shared_ptr<Pbr::DeviceModel> model = device->CreateModel();
+        model->AddPrimitive(Pbr::PrimitiveBuilder().AddQuad({1, 1}), material);
+
+        context.Clear();
+        device->Render(*model, XMMatrixTranslation(0, 0, -2));
+        CHECK(IsColor(context.Pixel(Center, Center), 255, 0, 0));
+
+        // Without a sampler, the default one reads the texture.
+        material->SetTexture(Pbr::ShaderSlots::Emissive, device->CreateTexture(yellow.data(), 4, 4, sRGB), nullptr);
+        context.Clear();
+        device->Render(*model, XMMatrixTranslation(0, 0, -2));
+        CHECK(IsColor(context.Pixel(Center, Center), 255, 255, 0));
+    }
+    CHECK(glGetError() == GL_NO_ERROR);
+}
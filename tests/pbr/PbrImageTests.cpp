@@ -0,0 +1,102 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <atomic>
+#include <future>
+#include <string>
+#include <vector>
+// The samples link stb_image from the Gltf library, which the tests don't build.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include <pbr/PbrImage.h>
+#include <pbr/PbrTaskScheduler.h>
+#include <SampleShared/PbrThreadPoolScheduler.h>
+#include "TestFramework.h"
+
+namespace {
+    // Installs a scheduler for the duration of a test.
+    struct ScopedScheduler {
+        explicit ScopedScheduler(std::shared_ptr<Pbr::TaskScheduler> scheduler) {
+            Pbr::SetTaskScheduler(std::move(scheduler));
+        }
+        ~ScopedScheduler() {
+            Pbr::SetTaskScheduler(nullptr);
+        }
+    };
+
+    // A binary PPM image of width x 1 pixels, which stb_image decodes, whose red channel holds the seed.
+    std::vector<uint8_t> EncodePpm(uint32_t width, uint8_t seed) {
+        const std::string header = "P6\n" + std::to_string(width) + " 1\n255\n";
+        std::vector<uint8_t> file(header.begin(), header.end());
+        for (uint32_t x = 0; x < width; x++) {
+            file.insert(file.end(), {seed, static_cast<uint8_t>(x), 0});
+        }
+        return file;
+    }
+
+    std::shared_ptr<Pbr::ImageDecode> StartDecode(const std::vector<uint8_t>& file) {
+        return Pbr::ImageDecode::Start(Pbr::HashImage(file.data(), file.size()), file.data(), file.size());
+    }
+} // namespace
+
+TEST_CASE(PbrImage_ContinuationsFollowTheDecode) {
+    for (const bool withScheduler : {false, true}) {
+        ScopedScheduler scoped(withScheduler ? std::make_shared<sample::PbrThreadPoolScheduler>(2) : nullptr);
+
+        const std::vector<uint8_t> file = EncodePpm(4, 7);
+        const std::shared_ptr<Pbr::ImageDecode> decode = StartDecode(file);
+        std::promise<uint32_t> readyWhenCalled;
+        decode->Then([&] { readyWhenCalled.set_value(decode->IsReady() ? decode->Get().Width : 0); });
+        CHECK(readyWhenCalled.get_future().get() == 4);
+        CHECK(decode->Get().Rgba[0] == 7);
+
+        // Identical content joins the decode, and a continuation of a finished decode runs right away.
+        CHECK(StartDecode(file) == decode);
+        bool calledRightAway = false;
+        decode->Then([&] { calledRightAway = true; });
+        CHECK(calledRightAway);
+    }
+}
+
+TEST_CASE(PbrImage_ContinuationsFollowFailedDecodes) {
+    const std::vector<uint8_t> file = {'n', 'o', 't', ' ', 'a', 'n', ' ', 'i', 'm', 'a', 'g', 'e'};
+    const std::shared_ptr<Pbr::ImageDecode> decode = StartDecode(file);
+    std::promise<void> called;
+    decode->Then([&] { called.set_value(); });
+    called.get_future().get();
+    CHECK(decode->IsReady());
+    CHECK_THROWS(decode->Get());
+}
+
+// Work on the pixels chained after the decodes never blocks a worker, so a single worker runs every decode and its
+// continuation, even when the continuations split their work into bands as the mip chains do.
+TEST_CASE(PbrImage_ChainedWorkDoesntBlockTheWorkers) {
+    ScopedScheduler scoped(std::make_shared<sample::PbrThreadPoolScheduler>(1));
+
+    constexpr int ImageCount = 8;
+    std::vector<std::shared_ptr<Pbr::ImageDecode>> decodes;
+    std::vector<std::promise<uint32_t>> results(ImageCount);
+    for (int i = 0; i < ImageCount; i++) {
+        decodes.push_back(StartDecode(EncodePpm(16, static_cast<uint8_t>(i))));
+        decodes.back()->Then([&decode = *decodes.back(), &result = results[i]] {
+            std::atomic<uint32_t> sum{0};
+            Pbr::Internal::ParallelForBands(decode.Get().Width, 64 * 1024, [&](uint32_t begin, uint32_t end) { sum += end - begin; });
+            result.set_value(sum + decode.Get().Rgba[0]);
+        });
+    }
+    for (int i = 0; i < ImageCount; i++) {
+        CHECK(results[i].get_future().get() == 16u + i);
+    }
+}
@@ -0,0 +1,141 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <vector>
+#include <pbr/PbrMaterialAtlasPlan.h>
+#include "TestFramework.h"
+
+namespace {
+    constexpr Pbr::AtlasTextureShape Shape256{256, 256, 9, 28}; // DXGI_FORMAT_R8G8B8A8_UNORM
+    constexpr Pbr::AtlasTextureShape Shape512{512, 512, 10, 28};
+    constexpr uint32_t UnlimitedLayers = 2048;
+
+    // A material whose slot i has the texture with id textureBase + i, and the same sampler in every slot.
+    Pbr::AtlasMaterialInput Material(uintptr_t textureBase, Pbr::AtlasTextureShape shape = Shape256) {
+        Pbr::AtlasMaterialInput material;
+        for (uint32_t slot = 0; slot < Pbr::MaterialSlotCount; slot++) {
+            material.Textures[slot] = {textureBase + slot, shape};
+            material.Samplers[slot] = 1;
+        }
+        return material;
+    }
+} // namespace
+
+TEST_CASE(MaterialsWithTheSameShapesShareArraysAndAGroup) {
+    const Pbr::AtlasPlan plan = Pbr::PlanMaterialAtlas({Material(100), Material(200), Material(300)}, UnlimitedLayers);
+
+    REQUIRE(plan.Arrays.size() == Pbr::MaterialSlotCount);
+    REQUIRE(plan.Groups.size() == 1);
+    for (uint32_t slot = 0; slot < Pbr::MaterialSlotCount; slot++) {
+        CHECK(plan.Arrays[slot].Slot == slot);
+        CHECK((plan.Arrays[slot].Layers == std::vector<uintptr_t>{100 + slot, 200 + slot, 300 + slot}));
+    }
+    for (uint32_t material = 0; material < 3; material++) {
+        CHECK(plan.Materials[material].Group == 0);
+        CHECK(plan.Materials[material].Layers[0] == material);
+    }
+}
+
+TEST_CASE(TexturesUsedByManyMaterialsTakeOneLayer) {
+    Pbr::AtlasMaterialInput shared = Material(200);
+    shared.Textures[Pbr::ShaderSlots::Normal] = {100 + Pbr::ShaderSlots::Normal, Shape256};
+
+    const Pbr::AtlasPlan plan = Pbr::PlanMaterialAtlas({Material(100), shared}, UnlimitedLayers);
+
+    CHECK(plan.Arrays[Pbr::ShaderSlots::Normal].Layers.size() == 1);
+    CHECK(plan.Arrays[Pbr::ShaderSlots::BaseColor].Layers.size() == 2);
+    CHECK(plan.Materials[1].Layers[Pbr::ShaderSlots::Normal] == 0);
+    CHECK(plan.Materials[1].Layers[Pbr::ShaderSlots::BaseColor] == 1);
+    CHECK(plan.Materials[0].Group == plan.Materials[1].Group);
+}
+
+TEST_CASE(TexturesOfOtherShapesGoIntoOtherArraysAndGroups) {
+    const Pbr::AtlasPlan plan = Pbr::PlanMaterialAtlas({Material(100), Material(200, Shape512), Material(300)}, UnlimitedLayers);
+
+    CHECK(plan.Arrays.size() == 2 * Pbr::MaterialSlotCount);
+    REQUIRE(plan.Groups.size() == 2);
+    CHECK(plan.Materials[0].Group == plan.Materials[2].Group);
+    CHECK(plan.Materials[1].Group != plan.Materials[0].Group);
+    CHECK(plan.Materials[1].Layers[0] == 0);
+    CHECK(plan.Materials[2].Layers[0] == 1);
+}
+
+TEST_CASE(FullArraysStartNewArraysAndGroups) {
+    const Pbr::AtlasPlan plan = Pbr::PlanMaterialAtlas({Material(100), Material(200), Material(300)}, 2);
+
+    CHECK(plan.Arrays.size() == 2 * Pbr::MaterialSlotCount);
+    for (const Pbr::AtlasArray& array : plan.Arrays) {
+        CHECK(array.Layers.size() <= 2);
+    }
+    CHECK(plan.Materials[0].Group == plan.Materials[1].Group);
+    CHECK(plan.Materials[2].Group != plan.Materials[0].Group);
+    CHECK(plan.Materials[2].Layers[0] == 0);
+}
+
+TEST_CASE(SamplersAndRenderStatesSplitGroups) {
+    Pbr::AtlasMaterialInput otherSampler = Material(200);
+    otherSampler.Samplers[Pbr::ShaderSlots::Emissive] = 2;
+    Pbr::AtlasMaterialInput blended = Material(300);
+    blended.AlphaBlended = true;
+    Pbr::AtlasMaterialInput doubleSided = Material(400);
+    doubleSided.DoubleSided = true;
+
+    const Pbr::AtlasPlan plan = Pbr::PlanMaterialAtlas({Material(100), otherSampler, blended, doubleSided}, UnlimitedLayers);
+
+    // The textures still share the arrays, only the bindings around them differ.
+    CHECK(plan.Arrays.size() == Pbr::MaterialSlotCount);
+    REQUIRE(plan.Groups.size() == 4);
+    CHECK(plan.Groups[plan.Materials[1].Group].Samplers[Pbr::ShaderSlots::Emissive] == 2);
+    CHECK(plan.Groups[plan.Materials[2].Group].AlphaBlended);
+    CHECK(plan.Groups[plan.Materials[3].Group].DoubleSided);
+}
+
+TEST_CASE(UnpackableMaterialsStayOutOfTheAtlas) {
+    Pbr::AtlasMaterialInput unpackable = Material(200);
+    unpackable.Packable = false;
+
+    const Pbr::AtlasPlan plan = Pbr::PlanMaterialAtlas({unpackable, Material(100)}, UnlimitedLayers);
+
+    CHECK(plan.Materials[0].Group == Pbr::AtlasNone);
+    CHECK(plan.Materials[1].Group == 0);
+    CHECK(plan.Arrays[0].Layers.size() == 1);
+}
+
+TEST_CASE(OpaqueDrawsAreGroupedAndTheOthersKeepTheirOrder) {
+    Pbr::AtlasMaterialInput blended = Material(300);
+    blended.AlphaBlended = true;
+    const Pbr::AtlasPlan plan = Pbr::PlanMaterialAtlas({Material(100), Material(200, Shape512), blended}, UnlimitedLayers);
+    REQUIRE(plan.Groups.size() == 3);
+
+    // Materials 0 and 1 are opaque in groups 0 and 1, material 2 is blended.
+    const std::vector<uint32_t> drawMaterials{1, 2, 0, Pbr::AtlasNone, 1, 0, 2, Pbr::AtlasNone};
+    std::vector<uint32_t> order;
+    Pbr::OrderAtlasDraws(plan, drawMaterials, order);
+
+    CHECK((order == std::vector<uint32_t>{2, 5, 0, 4, 1, 3, 6, 7}));
+}
+
+TEST_CASE(OrderingAgainReusesTheOrder) {
+    const Pbr::AtlasPlan plan = Pbr::PlanMaterialAtlas({Material(100), Material(200, Shape512)}, UnlimitedLayers);
+    const std::vector<uint32_t> drawMaterials{1, 0, 1, 0};
+
+    std::vector<uint32_t> order;
+    Pbr::OrderAtlasDraws(plan, drawMaterials, order);
+    const uint32_t* const data = order.data();
+    Pbr::OrderAtlasDraws(plan, drawMaterials, order);
+
+    CHECK(order.data() == data);
+    CHECK((order == std::vector<uint32_t>{1, 3, 0, 2}));
+}
@@ -0,0 +1,257 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+#include <pbr/PbrMipmaps.h>
+#include "TestFramework.h"
+
+namespace {
+    using Texel = std::function<uint8_t(uint32_t x, uint32_t y, uint32_t channel)>;
+
+    std::vector<uint8_t> CreateImage(uint32_t width, uint32_t height, const Texel& texel) {
+        std::vector<uint8_t> image(static_cast<size_t>(width) * height * 4);
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                for (uint32_t channel = 0; channel < 4; channel++) {
+                    image[(static_cast<size_t>(y) * width + x) * 4 + channel] = texel(x, y, channel);
+                }
+            }
+        }
+        return image;
+    }
+
+    uint8_t Channel(const Pbr::MipChain& chain, size_t level, uint32_t x, uint32_t y, uint32_t channel) {
+        return chain.LevelData(level)[static_cast<size_t>(y) * chain.RowPitch(level) + x * 4 + channel];
+    }
+
+    double SrgbToLinear(double value) {
+        return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+    }
+
+    double LinearToSrgb(double value) {
+        return value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1 / 2.4) - 0.055;
+    }
+
+    // The Kaiser-windowed sinc weights of the source texels for each destination texel along one axis, written independently
+    // of the library in double precision. Texels beyond the edges are clamped to it.
+    std::vector<std::vector<double>> KaiserWeights(uint32_t sourceSize, uint32_t destinationSize) {
+        constexpr double Radius = 3;
+        constexpr double Alpha = 4;
+        const double Pi = std::acos(-1.0);
+        const double scale = static_cast<double>(sourceSize) / destinationSize;
+
+        std::vector<std::vector<double>> weights(destinationSize, std::vector<double>(sourceSize, 0.0));
+        for (uint32_t d = 0; d < destinationSize; d++) {
+            const double center = (d + 0.5) * scale;
+            double sum = 0;
+            for (int s = static_cast<int>(std::floor(center - Radius * scale)); s <= static_cast<int>(std::ceil(center + Radius * scale));
+                 s++) {
+                const double x = (s + 0.5 - center) / scale;
+                if (std::abs(x) >= Radius) {
+                    continue;
+                }
+                const double sinc = x == 0 ? 1 : std::sin(Pi * x) / (Pi * x);
+                const double r = x / Radius;
+                const double weight = sinc * std::cyl_bessel_i(0.0, Alpha * std::sqrt(1 - r * r)) / std::cyl_bessel_i(0.0, Alpha);
+                weights[d][std::clamp(s, 0, static_cast<int>(sourceSize) - 1)] += weight;
+                sum += weight;
+            }
+            for (double& weight : weights[d]) {
+                weight /= sum;
+            }
+        }
+        return weights;
+    }
+} // namespace
+
+TEST_CASE(LevelCountsHalveTheLargerSide) {
+    CHECK(Pbr::MipLevelCount(1, 1) == 1);
+    CHECK(Pbr::MipLevelCount(2, 1) == 2);
+    CHECK(Pbr::MipLevelCount(256, 256) == 9);
+    CHECK(Pbr::MipLevelCount(5, 3) == 3);
+    CHECK(Pbr::MipLevelCount(1, 100) == 7);
+}
+
+TEST_CASE(BoxFilterAveragesLinearData) {
+    const std::vector<uint8_t> image = CreateImage(4, 4, [](uint32_t x, uint32_t y, uint32_t channel) {
+        return static_cast<uint8_t>((x * 40 + y * 20 + channel * 10) % 256);
+    });
+    const Pbr::MipChain chain = Pbr::GenerateMipChain(image.data(), 4, 4, {});
+    REQUIRE(chain.Levels.size() == 3);
+    CHECK(memcmp(chain.LevelData(0), image.data(), image.size()) == 0);
+
+    // Each texel of level 1 averages a 2x2 block, whose texels add 0, 40, 20 and 60 to the top left one.
+    for (uint32_t y = 0; y < 2; y++) {
+        for (uint32_t x = 0; x < 2; x++) {
+            for (uint32_t channel = 0; channel < 4; channel++) {
+                CHECK(Channel(chain, 1, x, y, channel) == x * 80 + y * 40 + channel * 10 + 30);
+            }
+        }
+    }
+    for (uint32_t channel = 0; channel < 4; channel++) {
+        CHECK(Channel(chain, 2, 0, 0, channel) == 90 + channel * 10);
+    }
+}
+
+// Averaging black and white sRGB texels gives the sRGB encoding of the linear average, which is brighter than the average
+// of the encoded values. Alpha is always averaged as it is.
+TEST_CASE(BoxFilterAveragesSrgbDataInLinearSpace) {
+    const std::vector<uint8_t> image = CreateImage(2, 2, [](uint32_t x, uint32_t y, uint32_t) {
+        return static_cast<uint8_t>(x == 0 && y == 0 ? 0 : 255);
+    });
+
+    Pbr::MipChainOptions options;
+    options.SRGB = true;
+    const Pbr::MipChain srgb = Pbr::GenerateMipChain(image.data(), 2, 2, options);
+    const Pbr::MipChain linear = Pbr::GenerateMipChain(image.data(), 2, 2, {});
+    REQUIRE(srgb.Levels.size() == 2);
+
+    const double expectedSrgb = LinearToSrgb(0.75) * 255;
+    for (uint32_t channel = 0; channel < 3; channel++) {
+        CHECK_NEAR(Channel(srgb, 1, 0, 0, channel), expectedSrgb, 1.0);
+        CHECK(Channel(linear, 1, 0, 0, channel) == 191);
+    }
+    CHECK(Channel(srgb, 1, 0, 0, 3) == 191);
+    CHECK(Channel(linear, 1, 0, 0, 3) == 191);
+}
+
+TEST_CASE(KaiserFilterMatchesReferenceLevels) {
+    constexpr uint32_t Width = 16;
+    constexpr uint32_t Height = 8;
+    // Smooth enough that the negative lobes of the filter don't clip at 0 or 255.
+    const auto value = [](uint32_t x, uint32_t y) { return 128 + 60 * std::sin(x * 0.7) + 40 * std::cos(y * 1.1); };
+    const std::vector<uint8_t> image = CreateImage(Width, Height, [&](uint32_t x, uint32_t y, uint32_t) {
+        return static_cast<uint8_t>(std::lround(value(x, y)));
+    });
+
+    Pbr::MipChainOptions options;
+    options.Filter = Pbr::MipFilter::Kaiser;
+    const Pbr::MipChain chain = Pbr::GenerateMipChain(image.data(), Width, Height, options);
+    REQUIRE(chain.Levels.size() == 5);
+
+    const std::vector<std::vector<double>> horizontal = KaiserWeights(Width, Width / 2);
+    const std::vector<std::vector<double>> vertical = KaiserWeights(Height, Height / 2);
+    for (uint32_t y = 0; y < Height / 2; y++) {
+        for (uint32_t x = 0; x < Width / 2; x++) {
+            double expected = 0;
+            for (uint32_t sy = 0; sy < Height; sy++) {
+                for (uint32_t sx = 0; sx < Width; sx++) {
+                    expected += vertical[y][sy] * horizontal[x][sx] * image[(sy * Width + sx) * 4];
+                }
+            }
+            for (uint32_t channel = 0; channel < 4; channel++) {
+                CHECK_NEAR(Channel(chain, 1, x, y, channel), expected, 1.0);
+            }
+        }
+    }
+}
+
+TEST_CASE(KaiserFilterKeepsConstantSrgbImages) {
+    const std::vector<uint8_t> image = CreateImage(12, 7, [](uint32_t, uint32_t, uint32_t channel) {
+        return static_cast<uint8_t>(channel == 3 ? 200 : 90);
+    });
+
+    Pbr::MipChainOptions options;
+    options.SRGB = true;
+    options.Filter = Pbr::MipFilter::Kaiser;
+    const Pbr::MipChain chain = Pbr::GenerateMipChain(image.data(), 12, 7, options);
+    REQUIRE(chain.Levels.size() == 4);
+    for (size_t level = 1; level < chain.Levels.size(); level++) {
+        for (uint32_t channel = 0; channel < 4; channel++) {
+            CHECK_NEAR(Channel(chain, level, 0, 0, channel), channel == 3 ? 200 : 90, 1.0);
+        }
+    }
+    CHECK_NEAR(SrgbToLinear(90 / 255.0), SrgbToLinear(Channel(chain, 3, 0, 0, 0) / 255.0), 0.005);
+}
+
+// Odd sizes round down, and the footprint of each destination texel covers fractional source texels.
+TEST_CASE(OddAndNonSquareSizes) {
+    const std::vector<uint8_t> image = CreateImage(5, 3, [](uint32_t x, uint32_t, uint32_t) { return static_cast<uint8_t>(x * 50); });
+    const Pbr::MipChain chain = Pbr::GenerateMipChain(image.data(), 5, 3, {});
+    REQUIRE(chain.Levels.size() == 3);
+    CHECK(chain.Levels[1].Width == 2);
+    CHECK(chain.Levels[1].Height == 1);
+    CHECK(chain.Levels[2].Width == 1);
+    CHECK(chain.Levels[2].Height == 1);
+
+    // The left texel covers [0, 2.5) of 0, 50 and half of 100, the right one [2.5, 5) of half of 100, 150 and 200.
+    CHECK(Channel(chain, 1, 0, 0, 0) == 40);
+    CHECK(Channel(chain, 1, 1, 0, 0) == 160);
+    CHECK(Channel(chain, 2, 0, 0, 0) == 100);
+
+    const Pbr::MipChain tall = Pbr::GenerateMipChain(CreateImage(2, 8, [](uint32_t, uint32_t, uint32_t) { return 7; }).data(), 2, 8, {});
+    REQUIRE(tall.Levels.size() == 4);
+    size_t offset = 0;
+    for (size_t level = 0; level < tall.Levels.size(); level++) {
+        CHECK(tall.Levels[level].Width == std::max(2u >> level, 1u));
+        CHECK(tall.Levels[level].Height == 8u >> level);
+        CHECK(tall.Levels[level].Offset == offset);
+        offset += static_cast<size_t>(tall.Levels[level].Width) * tall.Levels[level].Height * 4;
+    }
+    CHECK(tall.Data.size() == offset);
+}
+
+TEST_CASE(ResizeToPowerOfTwo) {
+    Pbr::MipChainOptions options;
+    options.ResizeToPowerOfTwo = true;
+    options.SRGB = true;
+
+    const std::vector<uint8_t> odd = CreateImage(3, 5, [](uint32_t, uint32_t, uint32_t) { return 100; });
+    const Pbr::MipChain resized = Pbr::GenerateMipChain(odd.data(), 3, 5, options);
+    REQUIRE(resized.Levels.size() == 4);
+    CHECK(resized.Levels[0].Width == 4);
+    CHECK(resized.Levels[0].Height == 8);
+    for (uint32_t channel = 0; channel < 4; channel++) {
+        CHECK_NEAR(Channel(resized, 0, 3, 7, channel), 100, 1.0);
+    }
+
+    // An image that is already a power of two keeps its exact texels, every sRGB value included.
+    const std::vector<uint8_t> image = CreateImage(16, 16, [](uint32_t x, uint32_t y, uint32_t channel) {
+        return static_cast<uint8_t>(y * 16 + x + channel);
+    });
+    const Pbr::MipChain unchanged = Pbr::GenerateMipChain(image.data(), 16, 16, options);
+    CHECK(unchanged.Levels[0].Width == 16);
+    CHECK(memcmp(unchanged.LevelData(0), image.data(), image.size()) == 0);
+
+    options.ResizeToPowerOfTwo = false;
+    CHECK(Pbr::GenerateMipChain(image.data(), 16, 16, options).Data == unchanged.Data);
+}
+
+TEST_CASE(MaxLevelCountLimitsTheChain) {
+    const std::vector<uint8_t> image = CreateImage(16, 16, [](uint32_t, uint32_t, uint32_t) { return 1; });
+
+    Pbr::MipChainOptions options;
+    CHECK(Pbr::GenerateMipChain(image.data(), 16, 16, options).Levels.size() == 5);
+
+    options.MaxLevelCount = 2;
+    const Pbr::MipChain limited = Pbr::GenerateMipChain(image.data(), 16, 16, options);
+    REQUIRE(limited.Levels.size() == 2);
+    CHECK(limited.Levels[1].Width == 8);
+    CHECK(limited.Data.size() == (16 * 16 + 8 * 8) * 4);
+
+    options.MaxLevelCount = 10;
+    CHECK(Pbr::GenerateMipChain(image.data(), 16, 16, options).Levels.size() == 5);
+}
+
+TEST_CASE(EmptyImagesAreRejected) {
+    const uint8_t texel[4] = {};
+    CHECK_THROWS(Pbr::GenerateMipChain(texel, 0, 1, {}));
+    CHECK_THROWS(Pbr::GenerateMipChain(texel, 1, 0, {}));
+}
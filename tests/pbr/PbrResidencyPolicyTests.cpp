@@ -0,0 +1,200 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <pbr/PbrResidencyPolicy.h>
+#include "TestFramework.h"
+
+using namespace DirectX;
+
+namespace {
+    constexpr uint32_t TextureSize = 1024;
+    constexpr uint32_t TailMip = 4; // 64x64
+    constexpr float Radius = 0.5f;
+    constexpr float UvDensity = 1; // One texture per meter
+
+    // A view at the origin looking down -z with a 90 degree field of view, turned by yaw radians around y.
+    Pbr::ResidencyView View(float yaw = 0) {
+        Pbr::ResidencyView view;
+        view.Orientation = {0, std::sin(yaw / 2), 0, std::cos(yaw / 2)};
+        view.AngleLeft = view.AngleDown = -XM_PIDIV4;
+        view.AngleRight = view.AngleUp = XM_PIDIV4;
+        view.Width = view.Height = 1000;
+        return view;
+    }
+
+    // The bytes of the levels of an RGBA texture of TextureSize texels.
+    std::vector<size_t> LevelBytes() {
+        std::vector<size_t> levelBytes;
+        for (uint32_t size = TextureSize; size > 0; size /= 2) {
+            levelBytes.push_back(static_cast<size_t>(size) * size * 4);
+        }
+        return levelBytes;
+    }
+
+    // The level needed for a primitive whose nearest point is distance meters in front of the view.
+    float RequiredMip(const Pbr::ResidencyView& view, float distance, float offscreenMipBias = 2) {
+        return Pbr::EstimateRequiredMip(view, XMVectorSet(0, 0, -(distance + Radius), 0), Radius, UvDensity, TextureSize, offscreenMipBias);
+    }
+
+    // Plans a frame of a camera path in which the levels stream in and out at once.
+    void PlanFrame(Pbr::ResidencyPolicy& policy) {
+        policy.Plan();
+        for (uint32_t id = 0; id < policy.Statistics().TextureCount; id++) {
+            policy.SetResidentMip(id, policy.TargetMip(id));
+        }
+    }
+} // namespace
+
+TEST_CASE(RequiredMipGrowsByALevelWhenTheDistanceDoubles) {
+    const Pbr::ResidencyView view = View();
+    CHECK_NEAR(RequiredMip(view, 4) - RequiredMip(view, 2), 1, 1e-4);
+    CHECK_NEAR(RequiredMip(view, 64) - RequiredMip(view, 2), 5, 1e-4);
+
+    // A pixel is 2 / 1000 of the distance wide, and a texel of level 0 is 1 / 1024 meters wide.
+    CHECK_NEAR(RequiredMip(view, 1), std::log2(2.0 / 1000 * 1024), 1e-4);
+    CHECK(RequiredMip(view, 0.1f) < 0);
+}
+
+TEST_CASE(PrimitivesOutsideTheViewNeedCoarserLevels) {
+    CHECK_NEAR(RequiredMip(View(XM_PI), 8) - RequiredMip(View(), 8), 2, 1e-4);
+    CHECK_NEAR(RequiredMip(View(XM_PI), 8, 3) - RequiredMip(View(), 8, 3), 3, 1e-4);
+
+    // Partly inside the field of view counts as inside.
+    CHECK_NEAR(RequiredMip(View(XM_PIDIV4 + 0.01f), 8), RequiredMip(View(), 8), 1e-4);
+}
+
+TEST_CASE(UnknownDensityNeedsTheMostDetailedLevel) {
+    CHECK(Pbr::EstimateRequiredMip(View(), XMVectorSet(0, 0, -100, 0), Radius, 0, TextureSize, 2) == 0);
+    Pbr::ResidencyView emptyView = View();
+    emptyView.Width = 0;
+    CHECK(Pbr::EstimateRequiredMip(emptyView, XMVectorSet(0, 0, -100, 0), Radius, UvDensity, TextureSize, 2) == 0);
+}
+
+TEST_CASE(ApproachingStreamsLevelsInWithoutGoingBack) {
+    Pbr::ResidencyPolicy policy;
+    const uint32_t id = policy.AddTexture(LevelBytes(), TailMip);
+    CHECK(policy.ResidentMip(id) == TailMip);
+
+    // The camera walks from 100 meters to half a meter in front of the primitive.
+    uint32_t previousMip = TailMip;
+    for (int frame = 0; frame <= 300; frame++) {
+        const float distance = 100 * std::pow(0.005f, frame / 300.0f);
+        policy.Request(id, RequiredMip(View(), distance));
+        PlanFrame(policy);
+
+        CHECK(policy.TargetMip(id) <= previousMip);
+        previousMip = policy.TargetMip(id);
+    }
+    CHECK(previousMip == 0);
+
+    // Walking away again drops the levels, up to the hysteresis.
+    for (int frame = 0; frame <= 300; frame++) {
+        const float distance = 0.5f * std::pow(200.0f, frame / 300.0f);
+        policy.Request(id, RequiredMip(View(), distance));
+        PlanFrame(policy);
+    }
+    CHECK(policy.TargetMip(id) == TailMip);
+}
+
+TEST_CASE(HysteresisKeepsALevelBoundaryFromStreaming) {
+    // At this distance the primitive needs exactly level 2, and the camera sways 3% around it.
+    const float boundaryDistance = 4 / (2.0f / 1000 * TextureSize);
+
+    for (const uint32_t hysteresis : {0u, 1u}) {
+        Pbr::ResidencyOptions options;
+        options.Hysteresis = hysteresis;
+        Pbr::ResidencyPolicy policy(options);
+        const uint32_t id = policy.AddTexture(LevelBytes(), TailMip);
+
+        uint32_t changes = 0;
+        uint32_t previousMip = policy.ResidentMip(id);
+        for (int frame = 0; frame < 100; frame++) {
+            const float sway = frame % 2 == 0 ? 0.97f : 1.03f;
+            policy.Request(id, RequiredMip(View(), boundaryDistance * sway));
+            PlanFrame(policy);
+
+            changes += policy.ResidentMip(id) != previousMip ? 1 : 0;
+            previousMip = policy.ResidentMip(id);
+        }
+
+        if (hysteresis == 0) {
+            CHECK(changes == 100);
+        } else {
+            CHECK(changes == 1);
+            CHECK(previousMip == 1);
+        }
+    }
+}
+
+TEST_CASE(TheBudgetCoarsensTheTexturesThatFreeTheMost) {
+    const std::vector<size_t> levelBytes = LevelBytes();
+    Pbr::ResidencyOptions options;
+    options.BudgetBytes = 2 * 1024 * 1024;
+    Pbr::ResidencyPolicy policy(options);
+    const uint32_t nearId = policy.AddTexture(levelBytes, TailMip);
+    const uint32_t farId = policy.AddTexture(levelBytes, TailMip);
+
+    // Two primitives on a path of the camera, one close by and one 16 times farther away.
+    for (int frame = 0; frame < 60; frame++) {
+        const float distance = 0.2f + frame * 0.005f;
+        policy.Request(nearId, RequiredMip(View(), distance));
+        policy.Request(farId, RequiredMip(View(), distance * 16));
+        PlanFrame(policy);
+
+        const Pbr::ResidencyStatistics statistics = policy.Statistics();
+        CHECK(statistics.TargetBytes <= options.BudgetBytes);
+        CHECK(statistics.ResidentBytes == statistics.TargetBytes);
+        CHECK(policy.TargetMip(nearId) < policy.TargetMip(farId));
+    }
+
+    // The near texture needs level 0, which alone is over the budget, and loses one level. The far one keeps what it needs.
+    CHECK(policy.TargetMip(nearId) == 1);
+    CHECK(policy.TargetMip(farId) <= static_cast<uint32_t>(std::floor(RequiredMip(View(), (0.2f + 59 * 0.005f) * 16))));
+    CHECK(policy.Statistics().DegradedCount == 1);
+}
+
+TEST_CASE(TurningAwayDropsLevelsByTheOffscreenBias) {
+    Pbr::ResidencyPolicy policy;
+    const uint32_t id = policy.AddTexture(LevelBytes(), TailMip);
+    constexpr float Distance = 1;
+    const uint32_t neededMip = static_cast<uint32_t>(std::floor(RequiredMip(View(), Distance)));
+
+    // The camera stands still and turns around over a second.
+    uint32_t mip = 0;
+    for (int frame = 0; frame <= 90; frame++) {
+        policy.Request(id, RequiredMip(View(XM_PI * frame / 90), Distance));
+        PlanFrame(policy);
+        mip = policy.TargetMip(id);
+        if (frame == 0) {
+            CHECK(mip == neededMip);
+        }
+    }
+
+    CHECK(mip == std::min(neededMip + 2, TailMip));
+}
+
+TEST_CASE(TexturesWithoutRequestsFallBackToTheirTail) {
+    Pbr::ResidencyPolicy policy;
+    const uint32_t id = policy.AddTexture(LevelBytes(), TailMip);
+    policy.Request(id, 0);
+    PlanFrame(policy);
+    CHECK(policy.TargetMip(id) == 0);
+
+    PlanFrame(policy);
+    CHECK(policy.TargetMip(id) == TailMip);
+}
@@ -0,0 +1,110 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <pbr/PbrTaskScheduler.h>
+#include <SampleShared/PbrThreadPoolScheduler.h>
+#include "TestFramework.h"
+
+namespace {
+    // Installs a scheduler for the duration of a test.
+    struct ScopedScheduler {
+        explicit ScopedScheduler(std::shared_ptr<Pbr::TaskScheduler> scheduler) {
+            Pbr::SetTaskScheduler(std::move(scheduler));
+        }
+        ~ScopedScheduler() {
+            Pbr::SetTaskScheduler(nullptr);
+        }
+    };
+
+    // Runs ParallelForBands over enough texels to be split, and checks every item is covered exactly once.
+    void CheckBandsCoverItems(uint32_t count) {
+        std::vector<std::atomic<uint32_t>> visits(count);
+        Pbr::Internal::ParallelForBands(count, 64 * 1024, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                visits[i]++;
+            }
+        });
+        for (uint32_t i = 0; i < count; i++) {
+            CHECK(visits[i] == 1);
+        }
+    }
+} // namespace
+
+TEST_CASE(PbrTaskScheduler_BandsCoverItemsWithoutScheduler) {
+    REQUIRE(Pbr::GetTaskScheduler() == nullptr);
+    CheckBandsCoverItems(1);
+    CheckBandsCoverItems(7);
+    CheckBandsCoverItems(1000);
+}
+
+TEST_CASE(PbrTaskScheduler_BandsRunOnThePool) {
+    ScopedScheduler scoped(std::make_shared<sample::PbrThreadPoolScheduler>(3));
+    CheckBandsCoverItems(1);
+    CheckBandsCoverItems(7);
+    CheckBandsCoverItems(1000);
+
+    // The bands run on the caller and the three workers only, however many levels are filtered.
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    for (int level = 0; level < 20; level++) {
+        Pbr::Internal::ParallelForBands(64, 64 * 1024, [&](uint32_t, uint32_t) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            std::lock_guard lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        });
+    }
+    CHECK(threads.size() <= 4);
+    CHECK(threads.count(std::this_thread::get_id()) == 1);
+}
+
+TEST_CASE(PbrTaskScheduler_NestedBandsDontStarveThePool) {
+    // Every worker is busy with a job that splits its own work into bands, which needs the calling workers to take part.
+    ScopedScheduler scoped(std::make_shared<sample::PbrThreadPoolScheduler>(2));
+    std::vector<std::future<uint32_t>> jobs;
+    for (int job = 0; job < 8; job++) {
+        jobs.push_back(Pbr::Internal::Async([] {
+            std::atomic<uint32_t> sum{0};
+            Pbr::Internal::ParallelForBands(100, 64 * 1024, [&](uint32_t begin, uint32_t end) { sum += end - begin; });
+            return sum.load();
+        }));
+    }
+    for (std::future<uint32_t>& job : jobs) {
+        CHECK(job.get() == 100);
+    }
+}
+
+TEST_CASE(PbrTaskScheduler_ExceptionsReachTheCaller) {
+    for (const bool withScheduler : {false, true}) {
+        ScopedScheduler scoped(withScheduler ? std::make_shared<sample::PbrThreadPoolScheduler>(2) : nullptr);
+
+        std::future<int> failed = Pbr::Internal::Async([]() -> int { throw std::runtime_error("Failed to decode"); });
+        CHECK_THROWS(failed.get());
+
+        std::future<void> succeeded = Pbr::Internal::Async([] {});
+        succeeded.get();
+
+        // The last band fails, whether it runs on a worker or, with a single band, on the caller.
+        CHECK_THROWS(Pbr::Internal::ParallelForBands(64, 64 * 1024, [](uint32_t, uint32_t end) {
+            if (end == 64) {
+                throw std::runtime_error("Failed to filter");
+            }
+        }));
+    }
+}
@@ -0,0 +1,106 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <pbr/PbrUploadQueue.h>
+#include <SampleShared/AllocationProfiler.h>
+#include <SampleShared/AllocationProfilerHooks.h>
+#include "TestFramework.h"
+
+// Checks that the uploads XrApp runs in the render frame, which create resources and allocate, don't fail strict steady-state
+// mode when an asset arrives after the warm-up frames.
+
+namespace {
+    constexpr Pbr::UploadBudget UnlimitedBudget{SIZE_MAX, std::chrono::hours(1)};
+    constexpr uint32_t WarmupFrames = 3;
+
+    std::atomic<int> g_violationCount{0};
+    void CountViolation(const char*, size_t) {
+        g_violationCount++;
+    }
+
+    // An upload creating a resource, as the uploads of the glTF loader do.
+    Pbr::Upload AllocatingUpload(std::vector<std::unique_ptr<int>>& resources) {
+        Pbr::Upload upload;
+        upload.Run = [&resources] { resources.push_back(std::make_unique<int>(1)); };
+        return upload;
+    }
+
+    // Runs the frames of the warm-up, which may allocate, and begins the first steady-state frame.
+    void WarmUp() {
+        g_violationCount = 0;
+        sample::allocation::EnableStrictSteadyState(WarmupFrames, &CountViolation);
+        for (uint32_t frame = 0; frame <= WarmupFrames; frame++) {
+            sample::allocation::BeginFrame();
+        }
+    }
+} // namespace
+
+TEST_CASE(UploadsArrivingInSteadyStateAreAllowedToAllocate) {
+    Pbr::UploadQueue queue;
+    std::vector<std::unique_ptr<int>> resources;
+    resources.reserve(16);
+    const std::shared_ptr<Pbr::UploadBatch> batch = queue.CreateBatch();
+    queue.Enqueue(batch, AllocatingUpload(resources));
+    queue.Enqueue(batch, AllocatingUpload(resources));
+
+    WarmUp();
+    {
+        sample::allocation::Scope scope("XrApp::RenderFrame");
+        sample::allocation::AllowAllocationsScope allowAllocations;
+        queue.Process(UnlimitedBudget);
+    }
+    CHECK(resources.size() == 2);
+    CHECK(batch->IsComplete());
+    CHECK(g_violationCount == 0);
+    sample::allocation::DisableStrictSteadyState();
+}
+
+TEST_CASE(UploadsOutsideTheAllowedScopeAreViolations) {
+    Pbr::UploadQueue queue;
+    std::vector<std::unique_ptr<int>> resources;
+    resources.reserve(16);
+    queue.Enqueue(queue.CreateBatch(), AllocatingUpload(resources));
+
+    WarmUp();
+    {
+        sample::allocation::Scope scope("XrApp::RenderFrame");
+        queue.Process(UnlimitedBudget);
+    }
+    CHECK(g_violationCount == 1);
+    sample::allocation::DisableStrictSteadyState();
+}
+
+// The allowed scope covers the whole call, so the queue itself must not allocate in the frames without uploads, or it would
+// hide steady-state allocations of its own.
+TEST_CASE(ProcessingWithoutReadyUploadsDoesNotAllocate) {
+    Pbr::UploadQueue queue;
+    std::vector<std::unique_ptr<int>> resources;
+    Pbr::Upload waiting = AllocatingUpload(resources);
+    waiting.IsReady = [] { return false; };
+    queue.Enqueue(queue.CreateBatch(), std::move(waiting));
+
+    WarmUp();
+    for (int frame = 0; frame < 10; frame++) {
+        sample::allocation::BeginFrame();
+        sample::allocation::Scope scope("XrApp::RenderFrame");
+        CHECK(queue.Process(UnlimitedBudget).PendingCount == 1);
+    }
+    CHECK(g_violationCount == 0);
+    CHECK(resources.empty());
+    sample::allocation::DisableStrictSteadyState();
+}
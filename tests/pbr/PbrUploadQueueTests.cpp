@@ -0,0 +1,131 @@
+//*********************************************************
+//    Copyright (c) Microsoft. All rights reserved.
+//
+//    Apache 2.0 License
+//
+//    You may obtain a copy of the License at
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+//    implied. See the License for the specific language governing
+//    permissions and limitations under the License.
+//
+//*********************************************************
+#include <stdexcept>
+#include <vector>
+#include <pbr/PbrUploadQueue.h>
+#include "TestFramework.h"
+
+namespace {
+    // A budget that never stops Process early.
+    constexpr Pbr::UploadBudget UnlimitedBudget{SIZE_MAX, std::chrono::hours(1)};
+
+    Pbr::Upload RecordingUpload(std::vector<int>& order, int id, Pbr::UploadStage stage = Pbr::UploadStage::Geometry) {
+        Pbr::Upload upload;
+        upload.Stage = stage;
+        upload.Run = [&order, id] { order.push_back(id); };
+        return upload;
+    }
+} // namespace
+
+TEST_CASE(UploadsRunByPriorityStageAndOrder) {
+    Pbr::UploadQueue queue;
+    const auto low = queue.CreateBatch(Pbr::UploadPriority::Low);
+    const auto normal = queue.CreateBatch(Pbr::UploadPriority::Normal);
+    const auto high = queue.CreateBatch(Pbr::UploadPriority::High);
+
+    std::vector<int> order;
+    queue.Enqueue(low, RecordingUpload(order, 5));
+    queue.Enqueue(normal, RecordingUpload(order, 4, Pbr::UploadStage::Textures));
+    queue.Enqueue(normal, RecordingUpload(order, 2));
+    queue.Enqueue(high, RecordingUpload(order, 1));
+    queue.Enqueue(normal, RecordingUpload(order, 3));
+
+    const Pbr::UploadStatistics statistics = queue.Process(UnlimitedBudget);
+    CHECK(statistics.UploadCount == 5);
+    CHECK(statistics.PendingCount == 0);
+    CHECK((order == std::vector<int>{1, 2, 3, 4, 5}));
+    CHECK(low->IsComplete() && normal->IsComplete() && high->IsComplete());
+}
+
+// Each entry waiting for its data is asked once per call, however many ready uploads follow it. Rescanning from the start
+// after each upload would ask the waiting entries once per upload.
+TEST_CASE(WaitingUploadsAreScannedOncePerProcess) {
+    constexpr uint32_t WaitingCount = 1000;
+    constexpr uint32_t ReadyCount = 100;
+
+    Pbr::UploadQueue queue;
+    const auto waiting = queue.CreateBatch(Pbr::UploadPriority::High);
+    const auto ready = queue.CreateBatch(Pbr::UploadPriority::Normal);
+
+    uint32_t readyChecks = 0;
+    bool dataReady = false;
+    for (uint32_t i = 0; i < WaitingCount; i++) {
+        Pbr::Upload upload;
+        upload.IsReady = [&] {
+            readyChecks++;
+            return dataReady;
+        };
+        upload.Run = [] {};
+        queue.Enqueue(waiting, std::move(upload));
+    }
+
+    std::vector<int> order;
+    for (uint32_t i = 0; i < ReadyCount; i++) {
+        queue.Enqueue(ready, RecordingUpload(order, static_cast<int>(i)));
+    }
+
+    Pbr::UploadStatistics statistics = queue.Process(UnlimitedBudget);
+    CHECK(statistics.UploadCount == ReadyCount);
+    CHECK(statistics.PendingCount == WaitingCount);
+    CHECK(readyChecks == WaitingCount);
+    CHECK(order.size() == ReadyCount);
+
+    dataReady = true;
+    statistics = queue.Process(UnlimitedBudget);
+    CHECK(statistics.UploadCount == WaitingCount);
+    CHECK(statistics.PendingCount == 0);
+    CHECK(waiting->IsComplete());
+}
+
+TEST_CASE(ByteBudgetLimitsUploadsButOneAlwaysRuns) {
+    Pbr::UploadQueue queue;
+    const auto batch = queue.CreateBatch();
+
+    std::vector<int> order;
+    for (int i = 0; i < 4; i++) {
+        Pbr::Upload upload = RecordingUpload(order, i);
+        upload.Size = [] { return size_t{1000}; };
+        queue.Enqueue(batch, std::move(upload));
+    }
+
+    CHECK(queue.Process({500, std::chrono::hours(1)}).UploadCount == 1);
+    CHECK(queue.Process({2000, std::chrono::hours(1)}).UploadCount == 2);
+    CHECK(queue.LastStatistics().Bytes == 2000);
+    CHECK(queue.Process(UnlimitedBudget).UploadCount == 1);
+    CHECK((order == std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST_CASE(CancelledAndFailedBatchesDropTheirUploads) {
+    Pbr::UploadQueue queue;
+    const auto cancelled = queue.CreateBatch();
+    const auto failing = queue.CreateBatch();
+
+    std::vector<int> order;
+    queue.Enqueue(cancelled, RecordingUpload(order, 1));
+    Pbr::Upload failure;
+    failure.Run = [] { throw std::runtime_error("upload failed"); };
+    queue.Enqueue(failing, std::move(failure));
+    queue.Enqueue(failing, RecordingUpload(order, 2));
+    cancelled->Cancel();
+
+    const Pbr::UploadStatistics statistics = queue.Process(UnlimitedBudget);
+    CHECK(statistics.UploadCount == 1);
+    CHECK(statistics.PendingCount == 0);
+    CHECK(order.empty());
+    CHECK(cancelled->IsComplete() && failing->IsComplete());
+    CHECK(failing->Error() != nullptr);
+    CHECK(cancelled->Error() == nullptr);
+}